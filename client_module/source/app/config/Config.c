@@ -284,6 +284,7 @@ void _Config_loadDefaults(Config* this)
    _Config_configMapRedefine(this, "tuneUseBufferedAppend",            "true");
    _Config_configMapRedefine(this, "tuneStatFsCacheSecs",              "10");
    _Config_configMapRedefine(this, "tuneCoherentBuffers",              "true");
+   _Config_configMapRedefine(this, "tuneUseInlineFileData",            "false");
 
    _Config_configMapRedefine(this, "sysMgmtdHost",                     "");
    _Config_configMapRedefine(this, "sysInodeIDStyle",                  INODEIDSTYLE_DEFAULT);
@@ -677,6 +678,9 @@ bool _Config_applyConfigMap(Config* this)
       if(!strcmp(keyStr, "tuneCoherentBuffers") )
          this->tuneCoherentBuffers = StringTk_strToBool(valueStr);
       else
+      if(!strcmp(keyStr, "tuneUseInlineFileData") )
+         this->tuneUseInlineFileData = StringTk_strToBool(valueStr);
+      else
       if(!strcmp(keyStr, "sysInodeIDStyle") )
       {
          SAFE_KFREE(this->sysInodeIDStyle);
@@ -142,6 +142,7 @@ static inline bool Config_getTuneUseGlobalAppendLocks(Config* this);
 static inline bool Config_getTuneUseBufferedAppend(Config* this);
 static inline unsigned Config_getTuneStatFsCacheSecs(Config* this);
 static inline bool Config_getTuneCoherentBuffers(Config* this);
+static inline bool Config_getTuneUseInlineFileData(Config* this);
 
 static inline char* Config_getSysMgmtdHost(Config* this);
 static inline char* Config_getSysInodeIDStyle(Config* this);
@@ -314,6 +315,7 @@ struct Config
    bool     tuneUseBufferedAppend; // false disables buffering of append writes
    unsigned       tuneStatFsCacheSecs; // 0 disables caching of free space info from servers
    bool           tuneCoherentBuffers; // try to keep buffer cache and page cache coherent
+   bool           tuneUseInlineFileData; // false means small files are always read from storage
 
    char*          sysMgmtdHost;
    char*          sysInodeIDStyle;
@@ -358,6 +360,11 @@ char* Config_getCfgFile(Config* this)
    return this->cfgFile;
 }
 
+bool Config_getTuneUseInlineFileData(Config* this)
+{
+   return this->tuneUseInlineFileData;
+}
+
 int Config_getLogLevel(Config* this)
 {
    return this->logLevel;
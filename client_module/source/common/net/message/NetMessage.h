@@ -65,6 +65,8 @@ static inline unsigned short NetMessage_getMsgType(NetMessage* this);
 static inline unsigned NetMessage_getMsgHeaderFeatureFlags(NetMessage* this);
 static inline bool NetMessage_isMsgHeaderFeatureFlagSet(NetMessage* this, unsigned flag);
 static inline void NetMessage_addMsgHeaderFeatureFlag(NetMessage* this, unsigned flag);
+static inline bool NetMessage_isMsgHeaderCompatFeatureFlagSet(NetMessage* this, uint8_t flag);
+static inline void NetMessage_addMsgHeaderCompatFeatureFlag(NetMessage* this, uint8_t flag);
 static inline unsigned NetMessage_getMsgLength(NetMessage* this);
 static inline void NetMessage_setMsgHeaderUserID(NetMessage* this, unsigned userID);
 static inline void NetMessage_setMsgHeaderTargetID(NetMessage* this, uint16_t userID);
@@ -222,6 +224,27 @@ void NetMessage_addMsgHeaderFeatureFlag(NetMessage* this, unsigned flag)
    this->msgHeader.msgFeatureFlags |= flag;
 }
 
+/**
+ * Test flag. (For convenience and readability.)
+ *
+ * @return true if given flag is set.
+ */
+bool NetMessage_isMsgHeaderCompatFeatureFlagSet(NetMessage* this, uint8_t flag)
+{
+   return (this->msgHeader.msgCompatFeatureFlags & flag) != 0;
+}
+
+/**
+ * Add another flag without clearing the previously set flags.
+ *
+ * Note: "compat" means these flags might not be understood and will then just be ignored by the
+ * receiver (e.g. if the receiver is an older fhgfs version).
+ */
+void NetMessage_addMsgHeaderCompatFeatureFlag(NetMessage* this, uint8_t flag)
+{
+   this->msgHeader.msgCompatFeatureFlags |= flag;
+}
+
 unsigned NetMessage_getMsgLength(NetMessage* this)
 {
    if(!this->msgHeader.msgLength)
@@ -24,4 +24,8 @@ void OpenFileMsg_serializePayload(NetMessage* this, SerializeCtx* ctx)
 
    if (this->msgHeader.msgFeatureFlags & OPENFILEMSG_FLAG_HAS_EVENT)
       FileEvent_serialize(ctx, thisCast->fileEvent);
+
+   // (must stay the last field, see OPENFILEMSG_COMPATFLAG_INLINE_DATA)
+   if (this->msgHeader.msgCompatFeatureFlags & OPENFILEMSG_COMPATFLAG_INLINE_DATA)
+      Serialization_serializeUInt(ctx, thisCast->maxInlineDataSize);
 }
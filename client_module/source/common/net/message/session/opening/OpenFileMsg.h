@@ -10,6 +10,10 @@
 #define OPENFILEMSG_FLAG_HAS_EVENT           2 /* contains file event logging information */
 #define OPENFILEMSG_FLAG_BYPASS_ACCESS_CHECK 4 /* bypass file access checks on metadata server */
 
+/* compat flags, ignored by servers that don't know them (with the data they announce at the end of
+   the msg) */
+#define OPENFILEMSG_COMPATFLAG_INLINE_DATA   1 /* client accepts file contents in the response */
+
 struct OpenFileMsg;
 typedef struct OpenFileMsg OpenFileMsg;
 
@@ -17,6 +21,7 @@ static inline void OpenFileMsg_init(OpenFileMsg* this);
 static inline void OpenFileMsg_initFromSession(OpenFileMsg* this,
    NumNodeID clientNumID, const EntryInfo* entryInfo, unsigned accessFlags,
    const struct FileEvent* fileEvent);
+static inline void OpenFileMsg_setMaxInlineDataSize(OpenFileMsg* this, unsigned maxSize);
 
 // virtual functions
 extern void OpenFileMsg_serializePayload(NetMessage* this, SerializeCtx* ctx);
@@ -31,6 +36,7 @@ struct OpenFileMsg
    const EntryInfo* entryInfoPtr; // not owned by this object
    unsigned accessFlags;
    const struct FileEvent* fileEvent;
+   unsigned maxInlineDataSize;
 };
 
 extern const struct NetMessageOps OpenFileMsg_Ops;
@@ -62,4 +68,16 @@ void OpenFileMsg_initFromSession(OpenFileMsg* this,
       this->netMessage.msgHeader.msgFeatureFlags |= OPENFILEMSG_FLAG_HAS_EVENT;
 }
 
+/**
+ * Request the file contents with the response if the file has a copy of them on the metadata
+ * server and is opened read-only.
+ *
+ * @param maxSize max size of file contents that fits into the response buffer
+ */
+void OpenFileMsg_setMaxInlineDataSize(OpenFileMsg* this, unsigned maxSize)
+{
+   this->maxInlineDataSize = maxSize;
+   NetMessage_addMsgHeaderCompatFeatureFlag(&this->netMessage, OPENFILEMSG_COMPATFLAG_INLINE_DATA);
+}
+
 #endif /*OPENFILEMSG_H_*/
@@ -5,7 +5,7 @@ const struct NetMessageOps OpenFileRespMsg_Ops = {
    .serializePayload    = _NetMessage_serializeDummy,
    .deserializePayload  = OpenFileRespMsg_deserializePayload,
    .processIncoming = NetMessage_processIncoming,
-   .getSupportedHeaderFeatureFlagsMask = NetMessage_getSupportedHeaderFeatureFlagsMask,
+   .getSupportedHeaderFeatureFlagsMask = OpenFileRespMsg_getSupportedHeaderFeatureFlagsMask,
 };
 
 bool OpenFileRespMsg_deserializePayload(NetMessage* this, DeserializeCtx* ctx)
@@ -33,5 +33,20 @@ bool OpenFileRespMsg_deserializePayload(NetMessage* this, DeserializeCtx* ctx)
    if (!Serialization_deserializeUInt(ctx, &thisCast->fileVersion))
       return false;
 
+   thisCast->inlineData = NULL;
+   thisCast->inlineDataLen = 0;
+
+   if(NetMessage_isMsgHeaderFeatureFlagSet(this, OPENFILERESPMSG_FLAG_INLINE_DATA) )
+   {
+      if(!Serialization_deserializeStrAlign4(ctx, &thisCast->inlineDataLen,
+            &thisCast->inlineData) )
+         return false;
+   }
+
    return true;
 }
+
+unsigned OpenFileRespMsg_getSupportedHeaderFeatureFlagsMask(NetMessage* this)
+{
+   return OPENFILERESPMSG_FLAG_INLINE_DATA;
+}
@@ -7,6 +7,9 @@
 #include <common/Common.h>
 
 
+#define OPENFILERESPMSG_FLAG_INLINE_DATA  1 /* msg includes the file contents */
+
+
 struct OpenFileRespMsg;
 typedef struct OpenFileRespMsg OpenFileRespMsg;
 
@@ -14,6 +17,7 @@ static inline void OpenFileRespMsg_init(OpenFileRespMsg* this);
 
 // virtual functions
 extern bool OpenFileRespMsg_deserializePayload(NetMessage* this, DeserializeCtx* ctx);
+extern unsigned OpenFileRespMsg_getSupportedHeaderFeatureFlagsMask(NetMessage* this);
 
 // inliners
 static inline StripePattern* OpenFileRespMsg_createPattern(OpenFileRespMsg* this);
@@ -35,6 +39,9 @@ struct OpenFileRespMsg
 
    uint32_t fileVersion;
 
+   unsigned inlineDataLen;
+   const char* inlineData; // NULL if the msg does not include the file contents
+
    // for serialization
    StripePattern* pattern; // not owned by this object!
 
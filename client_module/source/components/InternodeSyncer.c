@@ -952,6 +952,9 @@ void __InternodeSyncer_delayedClosePrepareRemoting(InternodeSyncer* this,
    outIOInfo->needsAppendLockCleanup = &closeEntry->needsAppendLockCleanup;
    outIOInfo->maxUsedTargetIndex = &closeEntry->maxUsedTargetIndex;
    outIOInfo->firstWriteDone = NULL;
+   outIOInfo->inlineData = NULL;
+   outIOInfo->inlineDataLen = 0;
+   outIOInfo->inlineDataVersion = 0;
    outIOInfo->userID = 0;
    outIOInfo->groupID = 0;
 #ifdef BEEGFS_NVFS
@@ -975,6 +978,9 @@ void __InternodeSyncer_delayedEntryUnlockPrepareRemoting(InternodeSyncer* this,
    outIOInfo->accessFlags = 0;
    outIOInfo->maxUsedTargetIndex = NULL;
    outIOInfo->firstWriteDone = NULL;
+   outIOInfo->inlineData = NULL;
+   outIOInfo->inlineDataLen = 0;
+   outIOInfo->inlineDataVersion = 0;
    outIOInfo->userID = 0;
    outIOInfo->groupID = 0;
 #ifdef BEEGFS_NVFS
@@ -998,6 +1004,9 @@ void __InternodeSyncer_delayedRangeUnlockPrepareRemoting(InternodeSyncer* this,
    outIOInfo->accessFlags = 0;
    outIOInfo->maxUsedTargetIndex = NULL;
    outIOInfo->firstWriteDone = NULL;
+   outIOInfo->inlineData = NULL;
+   outIOInfo->inlineDataLen = 0;
+   outIOInfo->inlineDataVersion = 0;
    outIOInfo->userID = 0;
    outIOInfo->groupID = 0;
 #ifdef BEEGFS_NVFS
@@ -99,6 +99,7 @@ void FhgfsInode_destroyUninit(FhgfsInode* fhgfsInode)
    for(i=0; i < BEEGFS_INODE_FILEHANDLES_NUM; i++)
    {
       BitStore_uninit(&fhgfsInode->fileHandles[i].firstWriteDone);
+      SAFE_KFREE(fhgfsInode->fileHandles[i].inlineData);
    }
 }
 
@@ -123,6 +124,7 @@ FhgfsOpsErr FhgfsInode_referenceHandle(FhgfsInode* this, struct dentry* dentry,
    FhgfsOpsErr retVal = FhgfsOpsErr_SUCCESS;
    FhgfsInodeFileHandle* desiredHandle;
    FhgfsInodeFileHandle* rwHandle = &this->fileHandles[FileHandleType_RW];
+   FhgfsInodeFileHandle* readHandle = &this->fileHandles[FileHandleType_READ];
 
    *outHandleType = __FhgfsInode_openFlagsToHandleType(openFlags);
    desiredHandle = &this->fileHandles[*outHandleType];
@@ -133,6 +135,9 @@ FhgfsOpsErr FhgfsInode_referenceHandle(FhgfsInode* this, struct dentry* dentry,
 
    Mutex_lock(&this->fileHandlesMutex); // L O C K
 
+   if(*outHandleType != FileHandleType_READ)
+      readHandle->inlineDataStale = true; // (usage of the copy is not synchronized with writes)
+
    if(desiredHandle->refCount)
    { // desired handle exists => return it
       retVal = __FhgfsInode_referenceTrunc(this, app, openFlags, dentry);
@@ -170,6 +175,9 @@ FhgfsOpsErr FhgfsInode_referenceHandle(FhgfsInode* this, struct dentry* dentry,
          entryInfo            = lookupInfo->entryInfoPtr;
          ioInfo.fileHandleID  = lookupInfo->fileHandleID;
          ioInfo.pattern       = lookupInfo->stripePattern;
+         ioInfo.inlineData    = NULL;
+         ioInfo.inlineDataLen = 0;
+         ioInfo.inlineDataVersion = 0;
          PathInfo_update(pathInfo, &lookupInfo->pathInfo);
 
          retVal = FhgfsOpsErr_SUCCESS;
@@ -233,6 +241,16 @@ FhgfsOpsErr FhgfsInode_referenceHandle(FhgfsInode* this, struct dentry* dentry,
          desiredHandle->fileHandleID = ioInfo.fileHandleID;
          this->pattern = ioInfo.pattern;
 
+         // (note: this is the only handle type that gets inline data)
+         desiredHandle->inlineData = (char*)ioInfo.inlineData;
+         desiredHandle->inlineDataLen = ioInfo.inlineDataLen;
+         desiredHandle->inlineDataVersion = ioInfo.inlineDataVersion;
+
+         /* a fresh copy reflects all writes that were closed before, but not those of writers
+            that still have the file open through this inode */
+         desiredHandle->inlineDataStale =
+            this->fileHandles[FileHandleType_WRITE].refCount || rwHandle->refCount;
+
          stripeCount = FhgfsInode_getStripeCount(this);
          BitStore_setSize(&desiredHandle->firstWriteDone, stripeCount);
          BitStore_clearBits(&desiredHandle->firstWriteDone);
@@ -312,6 +330,10 @@ FhgfsOpsErr FhgfsInode_releaseHandle(FhgfsInode* this, FileHandleType handleType
 
          // clean up
          kfree(handle->fileHandleID);
+         SAFE_KFREE(handle->inlineData);
+         handle->inlineDataLen = 0;
+         handle->inlineDataVersion = 0;
+         handle->inlineDataStale = false;
          handle->needsAppendLockCleanup = false;
          AtomicInt_set(&handle->maxUsedTargetIndex, -1);
          BitStore_setSize(&handle->firstWriteDone, 0); // free extra mem from very high stripe count
@@ -471,6 +493,10 @@ void __FhgfsInode_initOpenIOInfo(FhgfsInode* this, FhgfsInodeFileHandle* fileHan
    outIOInfo->maxUsedTargetIndex = &fileHandle->maxUsedTargetIndex;
    outIOInfo->firstWriteDone = NULL;
 
+   outIOInfo->inlineData = NULL;
+   outIOInfo->inlineDataLen = 0;
+   outIOInfo->inlineDataVersion = 0;
+
    outIOInfo->userID  = i_uid_read(&this->vfs_inode);
    outIOInfo->groupID = i_gid_read(&this->vfs_inode);
 #ifdef BEEGFS_NVFS
@@ -498,6 +524,13 @@ void FhgfsInode_getRefIOInfo(FhgfsInode* this, FileHandleType handleType,
    // remaining values, which are not assigned by initOpenIOInfo()...
 
    outIOInfo->firstWriteDone = &fileHandle->firstWriteDone;
+
+   if(fileHandle->inlineData && !fileHandle->inlineDataStale)
+   {
+      outIOInfo->inlineData = fileHandle->inlineData;
+      outIOInfo->inlineDataLen = fileHandle->inlineDataLen;
+      outIOInfo->inlineDataVersion = fileHandle->inlineDataVersion;
+   }
 }
 
 /**
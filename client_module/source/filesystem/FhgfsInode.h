@@ -223,6 +223,13 @@ struct FhgfsInodeFileHandle
 
    BitStore firstWriteDone; /* one bit per storage target in stripe pattern; bit is set when we send
                                data to this target. */
+
+   char* inlineData; /* copy of the file contents that the mds sent on open (NULL if none); only for
+                        read-only handles, freed when the handle is closed */
+   unsigned inlineDataLen;
+   uint32_t inlineDataVersion; // file version that the mds sent along with the copy
+   bool inlineDataStale; /* set when the file is opened for writing through this inode, because the
+                            copy does not reflect these writes */
 };
 
 /**
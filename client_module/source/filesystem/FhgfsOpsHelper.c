@@ -1158,6 +1158,7 @@ clean_up_open:
    if (ioInfo.firstWriteDone)
       BitStore_uninit(ioInfo.firstWriteDone);
 
+   SAFE_KFREE(ioInfo.inlineData); // (no file handle took it over, see RemotingIOInfo_freeVals())
    RemotingIOInfo_freeVals(&ioInfo);
 
    return retVal;
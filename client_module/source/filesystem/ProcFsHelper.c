@@ -77,6 +77,7 @@ int ProcFsHelper_readV2_config(struct seq_file* file, App* app)
    seq_printf(file, "tuneUseBufferedAppend = %d\n", (int)Config_getTuneUseBufferedAppend(cfg) );
    seq_printf(file, "tuneStatFsCacheSecs = %u\n", Config_getTuneStatFsCacheSecs(cfg) );
    seq_printf(file, "tuneCoherentBuffers = %u\n", Config_getTuneCoherentBuffers(cfg) );
+   seq_printf(file, "tuneUseInlineFileData = %d\n", (int)Config_getTuneUseInlineFileData(cfg) );
    seq_printf(file, "sysSELinuxEnabled = %d\n", (int)Config_getsysSELinuxEnabled(cfg) );
    seq_printf(file, "sysSELinuxRevalidate = %s\n",
       Config_checkSELinuxRevalidateModeTypeToStr(Config_getsysSELinuxRevalidate(cfg) ) );
@@ -96,6 +96,10 @@ struct Fhgfs_RWTypeStrEntry const __Fhgfs_RWTypeList[] =
 #define __FHGFSOPS_REMOTING_msgBufCacheName BEEGFS_MODULE_NAME_STR "-pageVecMsgBufs"
 #define __FHGFSOPS_REMOTING_msgBufPoolSize   8 // number of reserve (pre-allocated) msgBufs
 
+/* part of the msg buffer that is reserved for the other fields of an open response when the mds is
+   asked to send inline file contents with it */
+#define __FHGFSOPS_REMOTING_INLINE_DATA_RESERVE   4096
+
 const ssize_t __FHGFSOPS_REMOTING_MAX_XATTR_VALUE_SIZE = 60*1000;
 const ssize_t __FHGFSOPS_REMOTING_MAX_XATTR_NAME_SIZE = 245;
 
@@ -735,6 +739,8 @@ cleanup_request:
 /**
  * @param ioInfo in and out arg; in case of success: fileHandleID and pathInfo will be set
  *        pattern will be set if it is NULL; values have to be freed by the caller
+ *        inlineData will be set if the mds sent the file contents; it is owned by the caller as
+ *        well, but not freed by RemotingIOInfo_freeVals()
  */
 FhgfsOpsErr FhgfsOpsRemoting_openfile(const EntryInfo* entryInfo, RemotingIOInfo* ioInfo,
    uint32_t* outVersion, const struct FileEvent* event)
@@ -776,6 +782,16 @@ FhgfsOpsErr FhgfsOpsRemoting_openfile(const EntryInfo* entryInfo, RemotingIOInfo
    if(Config_getSysBypassFileAccessCheckOnMeta(cfg))
       NetMessage_addMsgHeaderFeatureFlag((NetMessage*)&requestMsg, OPENFILEMSG_FLAG_BYPASS_ACCESS_CHECK);
 
+   if(Config_getTuneUseInlineFileData(cfg) &&
+      (Config_getTuneFileCacheTypeNum(cfg) == FILECACHETYPE_Native) &&
+      ( (ioInfo->accessFlags & OPENFILE_ACCESS_MASK_RW) == OPENFILE_ACCESS_READ) &&
+      (Config_getTuneMsgBufSize(cfg) > __FHGFSOPS_REMOTING_INLINE_DATA_RESERVE) )
+   { /* read-only => small files can be sent along with the response (must fit into our msg buf).
+        (only in native mode, which tracks the file version that tells whether the copy is stale) */
+      OpenFileMsg_setMaxInlineDataSize(&requestMsg,
+         Config_getTuneMsgBufSize(cfg) - __FHGFSOPS_REMOTING_INLINE_DATA_RESERVE);
+   }
+
    RequestResponseArgs_prepare(&rrArgs, NULL, (NetMessage*)&requestMsg, NETMSGTYPE_OpenFileResp);
 
    // communicate
@@ -827,6 +843,18 @@ FhgfsOpsErr FhgfsOpsRemoting_openfile(const EntryInfo* entryInfo, RemotingIOInfo
       msgPathInfoPtr = OpenFileRespMsg_getPathInfo(openResp);
       PathInfo_update(ioInfo->pathInfo, msgPathInfoPtr);
 
+      if(openResp->inlineData && (retVal == FhgfsOpsErr_SUCCESS) )
+      { // mds sent the file contents => keep a copy (without it, we just read from the targets)
+         ioInfo->inlineData = kmalloc(openResp->inlineDataLen ? openResp->inlineDataLen : 1,
+            GFP_NOFS);
+         if(ioInfo->inlineData)
+         {
+            memcpy( (char*)ioInfo->inlineData, openResp->inlineData, openResp->inlineDataLen);
+            ioInfo->inlineDataLen = openResp->inlineDataLen;
+            ioInfo->inlineDataVersion = openResp->fileVersion;
+         }
+      }
+
       if (outVersion)
          *outVersion = openResp->fileVersion;
    }
@@ -1566,6 +1594,58 @@ out:
    return retVal;
 }
 
+/**
+ * Check whether the copy of the file contents that the mds sent on open still matches the file,
+ * i.e. whether the file still has the size and version that it had on open. Otherwise (e.g. if we
+ * noticed on a stat that another client appended to the file), reads go to the storage targets.
+ *
+ * Note: The file version is only tracked by the native cache mode, so the copy is only requested
+ * in that mode (see FhgfsOpsRemoting_openfile() ).
+ *
+ * @param fhgfsInode may be NULL, in which case the copy can't be checked and is not used
+ */
+static bool __FhgfsOpsRemoting_isInlineDataValid(RemotingIOInfo* ioInfo, FhgfsInode* fhgfsInode)
+{
+   bool versionMatches;
+
+   if(!ioInfo->inlineData || !fhgfsInode)
+      return false;
+
+   if(i_size_read(&fhgfsInode->vfs_inode) != ioInfo->inlineDataLen)
+      return false;
+
+   FhgfsInode_entryInfoReadLock(fhgfsInode); // L O C K EntryInfo
+   versionMatches = (fhgfsInode->fileVersion == ioInfo->inlineDataVersion);
+   FhgfsInode_entryInfoReadUnlock(fhgfsInode); // U N L O C K EntryInfo
+
+   return versionMatches;
+}
+
+/**
+ * Serve a read from the copy of the file contents that the mds sent on open.
+ *
+ * Note: Caller must check __FhgfsOpsRemoting_isInlineDataValid() first.
+ *
+ * @return number of read bytes (0 at EOF) or negative fhgfs error code
+ */
+static ssize_t __FhgfsOpsRemoting_readfileInline(struct iov_iter* iter, size_t toBeRead,
+   loff_t offset, RemotingIOInfo* ioInfo)
+{
+   size_t copySize;
+   size_t copyRes;
+
+   if(offset >= ioInfo->inlineDataLen)
+      return 0;
+
+   copySize = min_t(size_t, toBeRead, ioInfo->inlineDataLen - offset);
+   copyRes = copy_to_iter(ioInfo->inlineData + offset, copySize, iter);
+
+   if(copySize && !copyRes)
+      return -FhgfsOpsErr_ADDRESSFAULT;
+
+   return copyRes;
+}
+
 static void readfile_nextIter(CommKitContext* context, FileOpState* state)
 {
    struct FileOpVecState* vecState = container_of(state, struct FileOpVecState, base);
@@ -1593,6 +1673,9 @@ ssize_t FhgfsOpsRemoting_readfileVec(struct iov_iter* iter, size_t toBeRead, lof
 
    __FhgfsOpsRemoting_logDebugIOCall(__func__, iov_iter_count(iter), offset, ioInfo, NULL);
 
+   if(__FhgfsOpsRemoting_isInlineDataValid(ioInfo, fhgfsInode) )
+      return __FhgfsOpsRemoting_readfileInline(iter, toBeRead, offset, ioInfo);
+
 #ifdef BEEGFS_NVFS
    ioInfo->nvfs = RdmaInfo_acquireNVFS();
 #endif
@@ -39,6 +39,11 @@ struct RemotingIOInfo
       AtomicInt* maxUsedTargetIndex;
       BitStore* firstWriteDone;
 
+      const char* inlineData; /* copy of the file contents from the metadata server (NULL if none);
+         set by Remoting_openfile() for read-only opens, owned by the file handle */
+      unsigned inlineDataLen;
+      uint32_t inlineDataVersion; // file version at the time the copy was received
+
       unsigned userID;     // only used in storage server write message
       unsigned groupID;    // only used in storage server write message
 #ifdef BEEGFS_NVFS
@@ -73,6 +78,10 @@ void RemotingIOInfo_initOpen(App* app, unsigned accessFlags, AtomicInt* maxUsedT
    outIOInfo->maxUsedTargetIndex = maxUsedTargetIndex;
    outIOInfo->firstWriteDone = NULL;
 
+   outIOInfo->inlineData = NULL;
+   outIOInfo->inlineDataLen = 0;
+   outIOInfo->inlineDataVersion = 0;
+
    outIOInfo->userID = 0;
    outIOInfo->groupID = 0;
 #ifdef BEEGFS_NVFS
@@ -99,6 +108,10 @@ void RemotingIOInfo_initSpecialClose(App* app, const char* fileHandleID,
    outIOInfo->maxUsedTargetIndex = maxUsedTargetIndex;
    outIOInfo->firstWriteDone = NULL;
 
+   outIOInfo->inlineData = NULL;
+   outIOInfo->inlineDataLen = 0;
+   outIOInfo->inlineDataVersion = 0;
+
    outIOInfo->userID = 0;
    outIOInfo->groupID = 0;
 #ifdef BEEGFS_NVFS
@@ -110,6 +123,9 @@ void RemotingIOInfo_initSpecialClose(App* app, const char* fileHandleID,
  * Note: Be careful with this. This is only useful in very special cases (e.g. stateless file IO,
  * when you called Remoting_openfile() directly). You will typically rather use the
  * FhgfsInode_referenceHandle() & Co routines.
+ *
+ * Note: Does not free inlineData, which is usually lent by a file handle (see
+ * FhgfsInode_getRefIOInfo() ); callers of Remoting_openfile() free it themselves.
  */
 void RemotingIOInfo_freeVals(RemotingIOInfo* outIOInfo)
 {
@@ -0,0 +1,112 @@
+#include "LatencyHistogram.h"
+
+#include <cmath>
+
+#define LATENCYHISTOGRAM_SUBBUCKET_BITS   4
+#define LATENCYHISTOGRAM_SUBBUCKETS       (1u << LATENCYHISTOGRAM_SUBBUCKET_BITS)
+#define LATENCYHISTOGRAM_NUM_BUCKETS \
+   ( (64 - LATENCYHISTOGRAM_SUBBUCKET_BITS + 1) * LATENCYHISTOGRAM_SUBBUCKETS)
+
+
+LatencyHistogram::LatencyHistogram()
+   : buckets(LATENCYHISTOGRAM_NUM_BUCKETS, 0), numValues(0), maxValue(0)
+{
+}
+
+void LatencyHistogram::add(uint64_t latencyUS)
+{
+   buckets[getBucketIndex(latencyUS)]++;
+   numValues++;
+
+   if (latencyUS > maxValue)
+      maxValue = latencyUS;
+}
+
+/**
+ * Adds all values of another histogram, e.g. to combine the histograms of several threads.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+   for (unsigned i = 0; i < buckets.size(); i++)
+      buckets[i] += other.buckets[i];
+
+   numValues += other.numValues;
+   maxValue = BEEGFS_MAX(maxValue, other.maxValue);
+}
+
+void LatencyHistogram::clear()
+{
+   std::fill(buckets.begin(), buckets.end(), 0);
+   numValues = 0;
+   maxValue = 0;
+}
+
+/**
+ * @param percent e.g. 99.9
+ * @return the upper bound of the bucket that contains the requested percentile (but never more
+ *    than the highest recorded value), 0 if the histogram is empty
+ */
+uint64_t LatencyHistogram::getPercentile(double percent) const
+{
+   if (!numValues)
+      return 0;
+
+   // rank of the requested value, 1-based (the epsilon compensates rounding errors of percent,
+   // e.g. 99.9% of 1000 values must be rank 999)
+   uint64_t rank = std::ceil(numValues * percent / 100 - 1e-6);
+   rank = BEEGFS_MAX(rank, 1);
+   rank = BEEGFS_MIN(rank, numValues);
+
+   uint64_t numSeen = 0;
+
+   for (unsigned i = 0; i < buckets.size(); i++)
+   {
+      numSeen += buckets[i];
+
+      if (numSeen >= rank)
+         return BEEGFS_MIN(getBucketUpperBound(i), maxValue);
+   }
+
+   return maxValue;
+}
+
+LatencyStats LatencyHistogram::getStats() const
+{
+   LatencyStats stats;
+
+   stats.numOps = numValues;
+   stats.p50 = getPercentile(50);
+   stats.p99 = getPercentile(99);
+   stats.p999 = getPercentile(99.9);
+   stats.max = maxValue;
+
+   return stats;
+}
+
+/*
+ * values below LATENCYHISTOGRAM_SUBBUCKETS get a bucket of their own, larger values are
+ * grouped by their highest bit and the LATENCYHISTOGRAM_SUBBUCKET_BITS bits below it.
+ */
+unsigned LatencyHistogram::getBucketIndex(uint64_t value)
+{
+   if (value < LATENCYHISTOGRAM_SUBBUCKETS)
+      return value;
+
+   const unsigned highBit = 63 - __builtin_clzll(value);
+   const unsigned shift = highBit - LATENCYHISTOGRAM_SUBBUCKET_BITS;
+   const unsigned subBucket = (value >> shift) & (LATENCYHISTOGRAM_SUBBUCKETS - 1);
+
+   return (shift + 1) * LATENCYHISTOGRAM_SUBBUCKETS + subBucket;
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(unsigned index)
+{
+   if (index < LATENCYHISTOGRAM_SUBBUCKETS)
+      return index;
+
+   const unsigned shift = index / LATENCYHISTOGRAM_SUBBUCKETS - 1;
+   const uint64_t subBucket = index % LATENCYHISTOGRAM_SUBBUCKETS;
+   const uint64_t lowerBound = (LATENCYHISTOGRAM_SUBBUCKETS + subBucket) << shift;
+
+   return lowerBound + ( (uint64_t(1) << shift) - 1);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <common/toolkit/serialization/Serialization.h>
+#include <common/Common.h>
+
+
+/*
+ * latency percentiles of one kind of operation, all latencies in microseconds
+ */
+struct LatencyStats
+{
+   uint64_t numOps;
+   uint64_t p50;
+   uint64_t p99;
+   uint64_t p999;
+   uint64_t max;
+
+   template<typename This, typename Ctx>
+   static void serialize(This obj, Ctx& ctx)
+   {
+      ctx
+         % obj->numOps
+         % obj->p50
+         % obj->p99
+         % obj->p999
+         % obj->max;
+   }
+};
+
+
+/**
+ * Histogram of operation latencies (in microseconds) for the built-in benchmarks.
+ *
+ * Buckets are log-linear: each power of two is split into 16 linear buckets, so percentiles are
+ * exact below 16us and within ~6% above, with a constant memory footprint for the full uint64_t
+ * range.
+ *
+ * Not thread-safe.
+ */
+class LatencyHistogram
+{
+   public:
+      LatencyHistogram();
+
+      void add(uint64_t latencyUS);
+      void merge(const LatencyHistogram& other);
+      void clear();
+
+      uint64_t getPercentile(double percent) const;
+      LatencyStats getStats() const;
+
+   private:
+      std::vector<uint64_t> buckets;
+      uint64_t numValues;
+      uint64_t maxValue;
+
+      static unsigned getBucketIndex(uint64_t value);
+      static uint64_t getBucketUpperBound(unsigned index);
+
+   public:
+      // inliners
+
+      uint64_t getNumValues() const
+      {
+         return numValues;
+      }
+};
+
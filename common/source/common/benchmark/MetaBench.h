@@ -0,0 +1,54 @@
+#pragma once
+
+#include <common/benchmark/LatencyHistogram.h>
+#include <common/benchmark/StorageBench.h>
+#include <common/toolkit/serialization/Serialization.h>
+#include <common/Common.h>
+
+
+/*
+ * note: the metadata benchmark uses the actions (StorageBenchAction), states (StorageBenchStatus)
+ * and error codes (STORAGEBENCH_ERROR_...) of the storage benchmark
+ */
+
+#define METABENCH_MAX_THREADS    1024
+
+
+/*
+ * enum for the phases of the metadata benchmark, in the order in which they are executed
+ */
+enum MetaBenchOp
+{
+   MetaBenchOp_CREATE = 0,
+   MetaBenchOp_STAT = 1,
+   MetaBenchOp_OPENCLOSE = 2, // open and close of the same file count as one operation
+   MetaBenchOp_RENAME = 3,
+   MetaBenchOp_UNLINK = 4,
+   MetaBenchOp_NUMOPS = 5
+};
+
+/*
+ * results of one phase of the metadata benchmark over all threads
+ */
+struct MetaBenchOpResult
+{
+   int32_t op; // MetaBenchOp
+   uint64_t elapsedMS; // wall-clock time of the phase
+   uint64_t opsPerSec;
+   uint64_t numErrors;
+   LatencyStats latency; // over all operations, including failed ones
+
+   template<typename This, typename Ctx>
+   static void serialize(This obj, Ctx& ctx)
+   {
+      ctx
+         % obj->op
+         % obj->elapsedMS
+         % obj->opsPerSec
+         % obj->numErrors
+         % obj->latency;
+   }
+};
+
+typedef std::vector<MetaBenchOpResult> MetaBenchResultVec;
+
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/benchmark/LatencyHistogram.h>
+#include <common/toolkit/serialization/Serialization.h>
 #include <common/Common.h>
 
 
@@ -14,6 +16,7 @@
 #define STORAGEBENCH_ERROR_INIT_READ_DATA             11
 #define STORAGEBENCH_ERROR_INIT_CREATE_BENCH_FOLDER   12
 #define STORAGEBENCH_ERROR_INIT_TRANSFER_DATA         13
+#define STORAGEBENCH_ERROR_INIT_INVALID_MODE          14
 
 #define STORAGEBENCH_ERROR_RUNTIME_ERROR              20
 #define STORAGEBENCH_ERROR_RUNTIME_DELETE_FOLDER      21
@@ -30,6 +33,46 @@ typedef StorageBenchResultsMap::const_iterator StorageBenchResultsMapCIter;
 typedef StorageBenchResultsMap::value_type StorageBenchResultsMapVal;
 
 
+struct StorageBenchLatencyResult
+{
+   LatencyStats read;
+   LatencyStats write;
+
+   template<typename This, typename Ctx>
+   static void serialize(This obj, Ctx& ctx)
+   {
+      ctx
+         % obj->read
+         % obj->write;
+   }
+};
+
+// map for latency results; key: targetID, value: latencies of the target
+typedef std::map<uint16_t, StorageBenchLatencyResult> StorageBenchLatencyMap;
+
+
+/*
+ * access pattern of a benchmark run
+ */
+struct StorageBenchMode
+{
+   bool randomOffsets; // blocks at random (blocksize-aligned) offsets instead of sequential I/O
+   int32_t readPercent; // StorageBenchType_MIXED only: percentage of blocks which are read
+   int32_t queueDepth; // number of blocks in flight per thread
+
+   StorageBenchMode() : randomOffsets(false), readPercent(0), queueDepth(1) {}
+
+   template<typename This, typename Ctx>
+   static void serialize(This obj, Ctx& ctx)
+   {
+      ctx
+         % obj->randomOffsets
+         % obj->readPercent
+         % obj->queueDepth;
+   }
+};
+
+
 /*
  * enum for the action parameter of the storage benchmark
  */
@@ -49,7 +92,8 @@ enum StorageBenchType
 {
    StorageBenchType_READ = 0,
    StorageBenchType_WRITE = 1,
-   StorageBenchType_NONE = 2
+   StorageBenchType_NONE = 2,
+   StorageBenchType_MIXED = 3 // reads and writes on existing data, see StorageBenchMode
 };
 
 /*
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <common/app/AbstractApp.h>
+#include <common/components/worker/ObjectPool.h>
 #include <common/components/worker/Work.h>
 #include <common/net/message/NetMessage.h>
 #include <common/net/sock/Socket.h>
 #include <common/Common.h>
 
 
-class IncomingPreprocessedMsgWork : public Work
+class IncomingPreprocessedMsgWork : public Work, public PooledObject
 {
    public:
       /**
@@ -25,6 +26,20 @@ class IncomingPreprocessedMsgWork : public Work
 
       virtual void process(char* bufIn, unsigned bufInLen, char* bufOut, unsigned bufOutLen);
 
+      /**
+       * The payload of the message is received into bufIn (the header was already read by the
+       * stream listener). A message that doesn't fit still gets the full buffer, so that process()
+       * rejects it the usual way.
+       */
+      virtual size_t getBufInLen(size_t maxLen) const
+      {
+         const size_t payloadLen = msgHeader.msgLength > NETMSG_HEADER_LENGTH
+            ? msgHeader.msgLength - NETMSG_HEADER_LENGTH
+            : 0;
+
+         return std::min(payloadLen, maxLen);
+      }
+
       static void releaseSocket(AbstractApp* app, Socket** sock, NetMessage* msg);
       static void invalidateConnection(Socket* sock);
       static bool checkRDMASocketImmediateData(AbstractApp* app, Socket* sock);
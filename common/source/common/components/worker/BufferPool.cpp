@@ -0,0 +1,259 @@
+#include <common/system/System.h>
+#include "BufferPool.h"
+
+#include <mutex>
+#include <new>
+#include <sstream>
+
+#include <sched.h>
+#include <sys/mman.h>
+
+
+#define BUFFERPOOL_HUGEPAGE_SIZE (2*1024*1024)
+
+
+BufferPool::BufferPool(size_t minBufSize, size_t maxBufSize, bool useHugePages) :
+   minBufSize(std::max<size_t>(minBufSize, 1) ), maxBufSize(maxBufSize), useHugePages(useHugePages)
+{
+   // map CPUs to NUMA nodes once, so that borrowing only needs a sched_getcpu()
+
+   numNumaNodes = System::getNumNumaNodes();
+
+   for(unsigned node = 0; node < numNumaNodes; node++)
+   {
+      cpu_set_t cpuSet;
+
+      if(!System::getNumaCoresByNode(node, &cpuSet) )
+         continue;
+
+      for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+      {
+         if(!CPU_ISSET(cpu, &cpuSet) )
+            continue;
+
+         if(cpuToNumaNode.size() <= (size_t)cpu)
+            cpuToNumaNode.resize(cpu + 1, 0);
+
+         cpuToNumaNode[cpu] = node;
+      }
+   }
+
+   for(size_t bufSize = this->minBufSize; ; bufSize *= 2)
+   {
+      std::unique_ptr<SizeClass> sizeClass(new SizeClass() );
+
+      sizeClass->bufSize = std::min(bufSize, maxBufSize);
+      sizeClass->numAllocated = 0;
+      sizeClass->allocSize = 0;
+      sizeClass->numInUse = 0;
+      sizeClass->highWaterInUse = 0;
+      sizeClass->numAcquired = 0;
+      sizeClass->numMisses = 0;
+
+      sizeClasses.push_back(std::move(sizeClass) );
+
+      if(bufSize >= maxBufSize)
+         break;
+   }
+
+   for(size_t i = 0; i < numNumaNodes * sizeClasses.size(); i++)
+      freeLists.emplace_back(new FreeList() );
+}
+
+BufferPool::~BufferPool()
+{
+   // note: all leases must have been returned at this point
+
+   for(auto iter = freeLists.begin(); iter != freeLists.end(); iter++)
+   {
+      for(auto bufIter = (*iter)->buffers.begin(); bufIter != (*iter)->buffers.end(); bufIter++)
+         freeBuffer(*bufIter);
+   }
+}
+
+BufferPool::Lease BufferPool::acquire(size_t minSize)
+{
+   const unsigned sizeClassIdx = getSizeClass(minSize);
+   const unsigned numaNode = getCurrentNumaNode();
+
+   SizeClass& sizeClass = *sizeClasses[sizeClassIdx];
+   FreeList& freeList = getFreeList(numaNode, sizeClassIdx);
+
+   Buffer buffer;
+   bool haveBuffer = false;
+
+   {
+      const std::lock_guard<Mutex> lock(freeList.mutex);
+
+      if(!freeList.buffers.empty() )
+      {
+         buffer = freeList.buffers.back();
+         freeList.buffers.pop_back();
+         haveBuffer = true;
+      }
+   }
+
+   if(!haveBuffer)
+   {
+      buffer = allocBuffer(sizeClassIdx, numaNode);
+
+      sizeClass.numAllocated++;
+      sizeClass.allocSize += buffer.allocSize;
+      sizeClass.numMisses++;
+   }
+
+   sizeClass.numAcquired++;
+
+   const uint64_t numInUse = ++sizeClass.numInUse;
+   uint64_t highWater = sizeClass.highWaterInUse.load(std::memory_order_relaxed);
+
+   while(numInUse > highWater &&
+         !sizeClass.highWaterInUse.compare_exchange_weak(highWater, numInUse) )
+   { /* highWater was reloaded by compare_exchange, just try again */ }
+
+   return Lease(this, buffer);
+}
+
+void BufferPool::release(const Buffer& buffer)
+{
+   FreeList& freeList = getFreeList(buffer.numaNode, buffer.sizeClass);
+
+   {
+      const std::lock_guard<Mutex> lock(freeList.mutex);
+
+      freeList.buffers.push_back(buffer);
+   }
+
+   sizeClasses[buffer.sizeClass]->numInUse--;
+}
+
+/**
+ * @return index of the smallest size class that holds size bytes (or the largest class)
+ */
+unsigned BufferPool::getSizeClass(size_t size) const
+{
+   unsigned sizeClass = 0;
+
+   for(size_t classSize = minBufSize;
+       classSize < size && sizeClass + 1 < sizeClasses.size();
+       classSize *= 2)
+      sizeClass++;
+
+   return sizeClass;
+}
+
+unsigned BufferPool::getCurrentNumaNode() const
+{
+   const int cpu = sched_getcpu();
+
+   if(cpu < 0 || (size_t)cpu >= cpuToNumaNode.size() )
+      return 0;
+
+   return cpuToNumaNode[cpu];
+}
+
+BufferPool::FreeList& BufferPool::getFreeList(unsigned numaNode, unsigned sizeClass)
+{
+   return *freeLists[numaNode * sizeClasses.size() + sizeClass];
+}
+
+/**
+ * Note: The memory is not touched here, so its pages get allocated on the NUMA node of the thread
+ * that first writes to them (i.e. the borrower).
+ *
+ * @throw std::bad_alloc
+ */
+BufferPool::Buffer BufferPool::allocBuffer(unsigned sizeClass, unsigned numaNode)
+{
+   Buffer buffer = Buffer();
+
+   buffer.size = sizeClasses[sizeClass]->bufSize;
+   buffer.sizeClass = sizeClass;
+   buffer.numaNode = numaNode;
+
+   const bool huge = useHugePages && buffer.size >= BUFFERPOOL_HUGEPAGE_SIZE;
+
+   if(huge)
+   { // try explicit hugetlb pages first, they are not always configured
+      buffer.allocSize = (buffer.size + BUFFERPOOL_HUGEPAGE_SIZE - 1) &
+         ~(size_t)(BUFFERPOOL_HUGEPAGE_SIZE - 1);
+
+      void* mapping = mmap(NULL, buffer.allocSize, PROT_READ | PROT_WRITE,
+         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+      if(mapping != MAP_FAILED)
+      {
+         buffer.data = (char*)mapping;
+         buffer.isHugeTLB = true;
+         return buffer;
+      }
+   }
+
+   void* data = NULL;
+   const size_t alignment = huge ? BUFFERPOOL_HUGEPAGE_SIZE : sysconf(_SC_PAGESIZE);
+
+   if(posix_memalign(&data, alignment, buffer.size) )
+      throw std::bad_alloc();
+
+   if(huge) // fall back to transparent huge pages (only a hint)
+      madvise(data, buffer.size, MADV_HUGEPAGE);
+
+   buffer.data = (char*)data;
+   buffer.allocSize = buffer.size;
+
+   return buffer;
+}
+
+void BufferPool::freeBuffer(const Buffer& buffer)
+{
+   if(buffer.isHugeTLB)
+      munmap(buffer.data, buffer.allocSize);
+   else
+      free(buffer.data);
+}
+
+void BufferPool::getStats(std::vector<SizeClassStats>* outStats) const
+{
+   outStats->clear();
+
+   for(auto iter = sizeClasses.begin(); iter != sizeClasses.end(); iter++)
+   {
+      const SizeClass& sizeClass = **iter;
+
+      SizeClassStats stats;
+
+      stats.bufSize = sizeClass.bufSize;
+      stats.numAllocated = sizeClass.numAllocated;
+      stats.allocSize = sizeClass.allocSize;
+      stats.numInUse = sizeClass.numInUse;
+      stats.highWaterInUse = sizeClass.highWaterInUse;
+      stats.numAcquired = sizeClass.numAcquired;
+      stats.numMisses = sizeClass.numMisses;
+
+      outStats->push_back(stats);
+   }
+}
+
+std::string BufferPool::getStatsAsStr() const
+{
+   std::vector<SizeClassStats> stats;
+   std::ostringstream stream;
+   uint64_t totalBytes = 0;
+
+   getStats(&stats);
+
+   stream << "bufSize allocated allocSize inUse highWater acquired misses" << std::endl;
+
+   for(auto iter = stats.begin(); iter != stats.end(); iter++)
+   {
+      stream << iter->bufSize << " " << iter->numAllocated << " " << iter->allocSize << " " <<
+         iter->numInUse << " " << iter->highWaterInUse << " " << iter->numAcquired << " " <<
+         iter->numMisses << std::endl;
+
+      totalBytes += iter->allocSize;
+   }
+
+   stream << "total allocated bytes: " << totalBytes << std::endl;
+
+   return stream.str();
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <common/threading/Mutex.h>
+#include <common/Common.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Process-wide pool of I/O buffers, shared by workers instead of a fixed buffer pair per worker
+ * thread (see Worker::setBufferPool()). A worker borrows buffers only while it processes a work
+ * item, so idle workers don't hold any memory.
+ *
+ * Buffers are handed out in power-of-two size classes between minBufSize and maxBufSize (the
+ * largest class is exactly maxBufSize). Free buffers are kept in one list per NUMA node and size
+ * class. A thread borrows from the list of the node it is currently running on, and a buffer always
+ * goes back to the list of the node it was allocated on. Pages are first touched by the borrowing
+ * thread, so they end up on that node.
+ *
+ * Free buffers are never released to the system before the pool is destroyed, so the memory used
+ * by the pool is bounded by the peak number of concurrently borrowed buffers per class, which the
+ * statistics report as high-water mark.
+ */
+class BufferPool
+{
+   private:
+      struct Buffer
+      {
+         char* data;
+         size_t size; // usable size (class size)
+         size_t allocSize; // size of the mapping for hugetlb buffers
+         unsigned sizeClass;
+         unsigned numaNode;
+         bool isHugeTLB;
+      };
+
+   public:
+      /**
+       * A borrowed buffer, returned to the pool on destruction.
+       */
+      class Lease
+      {
+         friend class BufferPool;
+
+         public:
+            Lease() : pool(NULL), buffer() {}
+
+            ~Lease()
+            {
+               release();
+            }
+
+            Lease(Lease&& other) : pool(NULL), buffer()
+            {
+               *this = std::move(other);
+            }
+
+            Lease& operator=(Lease&& other)
+            {
+               release();
+               std::swap(pool, other.pool);
+               std::swap(buffer, other.buffer);
+               return *this;
+            }
+
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+
+            char* data() const { return buffer.data; }
+            size_t size() const { return buffer.size; }
+
+         private:
+            BufferPool* pool;
+            Buffer buffer;
+
+            Lease(BufferPool* pool, const Buffer& buffer) : pool(pool), buffer(buffer) {}
+
+            void release()
+            {
+               if(pool)
+                  pool->release(buffer);
+
+               pool = NULL;
+               buffer = Buffer();
+            }
+      };
+
+      struct SizeClassStats
+      {
+         size_t bufSize;
+         uint64_t numAllocated; // buffers that exist (borrowed or free)
+         uint64_t allocSize; // bytes allocated for those buffers, incl. huge page rounding
+         uint64_t numInUse;
+         uint64_t highWaterInUse;
+         uint64_t numAcquired; // total number of borrows
+         uint64_t numMisses; // borrows that had to allocate a new buffer
+      };
+
+      BufferPool(size_t minBufSize, size_t maxBufSize, bool useHugePages);
+      ~BufferPool();
+
+      BufferPool(const BufferPool&) = delete;
+      BufferPool& operator=(const BufferPool&) = delete;
+
+      /**
+       * @param minSize requested size; the returned buffer is at least
+       *    min(minSize, maxBufSize) bytes large.
+       * @throw std::bad_alloc if no memory is available
+       */
+      Lease acquire(size_t minSize);
+
+      void getStats(std::vector<SizeClassStats>* outStats) const;
+      std::string getStatsAsStr() const;
+
+   private:
+      struct FreeList
+      {
+         Mutex mutex;
+         std::vector<Buffer> buffers;
+      };
+
+      struct SizeClass
+      {
+         size_t bufSize;
+
+         std::atomic<uint64_t> numAllocated;
+         std::atomic<uint64_t> allocSize;
+         std::atomic<uint64_t> numInUse;
+         std::atomic<uint64_t> highWaterInUse;
+         std::atomic<uint64_t> numAcquired;
+         std::atomic<uint64_t> numMisses;
+      };
+
+      size_t minBufSize;
+      size_t maxBufSize;
+      bool useHugePages;
+
+      std::vector<int> cpuToNumaNode;
+      unsigned numNumaNodes;
+
+      std::vector<std::unique_ptr<SizeClass>> sizeClasses;
+      std::vector<std::unique_ptr<FreeList>> freeLists; // index: numaNode * numClasses + class
+
+      unsigned getSizeClass(size_t size) const;
+      unsigned getCurrentNumaNode() const;
+      FreeList& getFreeList(unsigned numaNode, unsigned sizeClass);
+
+      Buffer allocBuffer(unsigned sizeClass, unsigned numaNode);
+      void freeBuffer(const Buffer& buffer);
+      void release(const Buffer& buffer);
+};
+
@@ -0,0 +1,341 @@
+#include <common/threading/Mutex.h>
+#include "ObjectPool.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+
+namespace {
+
+struct FreeBlock
+{
+   FreeBlock* next;
+};
+
+/**
+ * The free lists of a single thread. Only the owner thread modifies a cache; the allocation
+ * counters are atomic only because getStats() reads them from other threads.
+ */
+struct ThreadCache
+{
+   FreeBlock* freeLists[ObjectPool::NUM_CLASSES] = {};
+   unsigned numFree[ObjectPool::NUM_CLASSES] = {};
+
+   std::atomic<uint64_t> numAllocs[ObjectPool::NUM_CLASSES] = {};
+
+   ThreadCache* prev = nullptr; // list of all thread caches
+   ThreadCache* next = nullptr;
+};
+
+struct Depot
+{
+   Mutex mutex;
+   std::vector<void*> blocks;
+};
+
+struct PoolState
+{
+   Depot depots[ObjectPool::NUM_CLASSES];
+
+   std::atomic<uint64_t> numSystemAllocs[ObjectPool::NUM_CLASSES] = {};
+   std::atomic<uint64_t> numSystemFrees[ObjectPool::NUM_CLASSES] = {};
+
+   Mutex cachesMutex;
+   ThreadCache* caches = nullptr;
+   uint64_t retiredNumAllocs[ObjectPool::NUM_CLASSES] = {}; // of exited threads, by cachesMutex
+};
+
+/**
+ * Never destroyed, because objects may still be released while static objects are destroyed.
+ */
+PoolState& poolState()
+{
+   static PoolState* state = new PoolState();
+
+   return *state;
+}
+
+size_t classSize(unsigned sizeClass)
+{
+   return (sizeClass + 1) * ObjectPool::CLASS_GRANULARITY;
+}
+
+void* systemAlloc(unsigned sizeClass)
+{
+   poolState().numSystemAllocs[sizeClass].fetch_add(1, std::memory_order_relaxed);
+
+   return ::operator new(classSize(sizeClass) );
+}
+
+void systemFree(void* block, unsigned sizeClass)
+{
+   poolState().numSystemFrees[sizeClass].fetch_add(1, std::memory_order_relaxed);
+
+   ::operator delete(block);
+}
+
+void pushBlock(ThreadCache* cache, unsigned sizeClass, void* block)
+{
+   FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+
+   freeBlock->next = cache->freeLists[sizeClass];
+   cache->freeLists[sizeClass] = freeBlock;
+   cache->numFree[sizeClass]++;
+}
+
+void* popBlock(ThreadCache* cache, unsigned sizeClass)
+{
+   FreeBlock* freeBlock = cache->freeLists[sizeClass];
+   if (!freeBlock)
+      return nullptr;
+
+   cache->freeLists[sizeClass] = freeBlock->next;
+   cache->numFree[sizeClass]--;
+
+   return freeBlock;
+}
+
+/**
+ * Move up to TRANSFER_BATCH_SIZE blocks from the depot to the thread cache.
+ */
+void refillFromDepot(ThreadCache* cache, unsigned sizeClass)
+{
+   Depot& depot = poolState().depots[sizeClass];
+   const std::lock_guard<Mutex> lock(depot.mutex);
+
+   for (unsigned i = 0; i < ObjectPool::TRANSFER_BATCH_SIZE && !depot.blocks.empty(); i++)
+   {
+      pushBlock(cache, sizeClass, depot.blocks.back() );
+      depot.blocks.pop_back();
+   }
+}
+
+/**
+ * Move up to numBlocks blocks from the thread cache to the depot, or to the system if the depot
+ * is full.
+ */
+void flushToDepot(ThreadCache* cache, unsigned sizeClass, unsigned numBlocks)
+{
+   Depot& depot = poolState().depots[sizeClass];
+   const std::lock_guard<Mutex> lock(depot.mutex);
+
+   for (unsigned i = 0; i < numBlocks; i++)
+   {
+      void* block = popBlock(cache, sizeClass);
+      if (!block)
+         break;
+
+      if (depot.blocks.size() < ObjectPool::DEPOT_SIZE)
+         depot.blocks.push_back(block);
+      else
+         systemFree(block, sizeClass);
+   }
+}
+
+/**
+ * Gives the free blocks of an exiting thread to the depot.
+ */
+struct ThreadCacheHolder
+{
+   ThreadCache* cache = nullptr;
+
+   ~ThreadCacheHolder();
+};
+
+// fast path pointer, thread_local without destructor doesn't need a guard on every access
+thread_local ThreadCache* threadCache = nullptr;
+thread_local bool threadCacheDestroyed = false;
+thread_local ThreadCacheHolder threadCacheHolder;
+
+ThreadCacheHolder::~ThreadCacheHolder()
+{
+   if (!cache)
+      return;
+
+   PoolState& state = poolState();
+
+   threadCache = nullptr;
+   threadCacheDestroyed = true;
+
+   for (unsigned sizeClass = 0; sizeClass < ObjectPool::NUM_CLASSES; sizeClass++)
+      flushToDepot(cache, sizeClass, cache->numFree[sizeClass]);
+
+   {
+      const std::lock_guard<Mutex> lock(state.cachesMutex);
+
+      for (unsigned sizeClass = 0; sizeClass < ObjectPool::NUM_CLASSES; sizeClass++)
+         state.retiredNumAllocs[sizeClass] += cache->numAllocs[sizeClass];
+
+      if (cache->prev)
+         cache->prev->next = cache->next;
+      else
+         state.caches = cache->next;
+
+      if (cache->next)
+         cache->next->prev = cache->prev;
+   }
+
+   delete cache;
+}
+
+/**
+ * @return nullptr if the thread is exiting and its cache was already destroyed.
+ */
+ThreadCache* getThreadCache()
+{
+   if (likely(threadCache) )
+      return threadCache;
+
+   if (threadCacheDestroyed)
+      return nullptr;
+
+   PoolState& state = poolState();
+   ThreadCache* cache = new ThreadCache();
+
+   {
+      const std::lock_guard<Mutex> lock(state.cachesMutex);
+
+      cache->next = state.caches;
+      if (state.caches)
+         state.caches->prev = cache;
+
+      state.caches = cache;
+   }
+
+   threadCacheHolder.cache = cache;
+   threadCache = cache;
+
+   return cache;
+}
+
+}
+
+
+/**
+ * @throw std::bad_alloc if no memory is available
+ */
+void* ObjectPool::allocate(size_t size)
+{
+   if (unlikely(!isPooledSize(size) ) )
+      return ::operator new(size);
+
+   const unsigned sizeClass = getSizeClass(size);
+   ThreadCache* cache = getThreadCache();
+
+   if (unlikely(!cache) )
+      return systemAlloc(sizeClass);
+
+   std::atomic<uint64_t>& numAllocs = cache->numAllocs[sizeClass];
+   numAllocs.store(numAllocs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+   if (!cache->freeLists[sizeClass])
+      refillFromDepot(cache, sizeClass);
+
+   void* block = popBlock(cache, sizeClass);
+   if (block)
+      return block;
+
+   return systemAlloc(sizeClass);
+}
+
+/**
+ * @param size the same size that was passed to allocate()
+ */
+void ObjectPool::release(void* ptr, size_t size)
+{
+   if (!ptr)
+      return;
+
+   if (unlikely(!isPooledSize(size) ) )
+   {
+      ::operator delete(ptr);
+      return;
+   }
+
+   const unsigned sizeClass = getSizeClass(size);
+   ThreadCache* cache = getThreadCache();
+
+   if (unlikely(!cache) )
+   {
+      systemFree(ptr, sizeClass);
+      return;
+   }
+
+   pushBlock(cache, sizeClass, ptr);
+
+   if (cache->numFree[sizeClass] > THREAD_CACHE_SIZE)
+      flushToDepot(cache, sizeClass, TRANSFER_BATCH_SIZE);
+}
+
+/**
+ * @param outStats one element per size class that was used at least once.
+ */
+void ObjectPool::getStats(std::vector<SizeClassStats>* outStats)
+{
+   PoolState& state = poolState();
+   uint64_t numAllocs[NUM_CLASSES];
+
+   outStats->clear();
+
+   {
+      const std::lock_guard<Mutex> lock(state.cachesMutex);
+
+      for (unsigned sizeClass = 0; sizeClass < NUM_CLASSES; sizeClass++)
+      {
+         numAllocs[sizeClass] = state.retiredNumAllocs[sizeClass];
+
+         for (ThreadCache* cache = state.caches; cache; cache = cache->next)
+            numAllocs[sizeClass] += cache->numAllocs[sizeClass].load(std::memory_order_relaxed);
+      }
+   }
+
+   for (unsigned sizeClass = 0; sizeClass < NUM_CLASSES; sizeClass++)
+   {
+      SizeClassStats stats;
+
+      stats.objectSize = classSize(sizeClass);
+      stats.numAllocs = numAllocs[sizeClass];
+      stats.numSystemAllocs = state.numSystemAllocs[sizeClass].load(std::memory_order_relaxed);
+      stats.numSystemFrees = state.numSystemFrees[sizeClass].load(std::memory_order_relaxed);
+
+      if (!stats.numAllocs && !stats.numSystemAllocs)
+         continue;
+
+      {
+         Depot& depot = state.depots[sizeClass];
+         const std::lock_guard<Mutex> lock(depot.mutex);
+
+         stats.numDepotFree = depot.blocks.size();
+      }
+
+      outStats->push_back(stats);
+   }
+}
+
+std::string ObjectPool::getStatsAsStr()
+{
+   std::vector<SizeClassStats> stats;
+   std::ostringstream stream;
+   uint64_t totalAllocs = 0;
+   uint64_t totalSystemAllocs = 0;
+
+   getStats(&stats);
+
+   stream << "objectSize allocs systemAllocs systemFrees depotFree" << std::endl;
+
+   for (auto iter = stats.begin(); iter != stats.end(); iter++)
+   {
+      stream << iter->objectSize << " " << iter->numAllocs << " " << iter->numSystemAllocs << " " <<
+         iter->numSystemFrees << " " << iter->numDepotFree << std::endl;
+
+      totalAllocs += iter->numAllocs;
+      totalSystemAllocs += iter->numSystemAllocs;
+   }
+
+   stream << "allocs served from pool: " << (totalAllocs - std::min(totalAllocs, totalSystemAllocs) )
+      << " of " << totalAllocs << std::endl;
+
+   return stream.str();
+}
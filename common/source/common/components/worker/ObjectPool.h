@@ -0,0 +1,88 @@
+#pragma once
+
+#include <common/Common.h>
+
+#include <string>
+#include <vector>
+
+
+/**
+ * Process-wide pool for the small objects that are created and destroyed for every request, i.e.
+ * work items and the message objects of the most frequent message types. Classes opt in by
+ * deriving from PooledObject.
+ *
+ * Memory blocks are kept in size classes of CLASS_GRANULARITY bytes. Every thread has
+ * its own free lists, so allocation and release usually neither lock nor touch shared cache lines.
+ * Blocks are moved between threads in batches through a shared depot per size class, because
+ * objects are often allocated by one thread and released by another (e.g. work items are created by
+ * a stream listener and deleted by a worker).
+ *
+ * Every block is a separate system allocation, so a block can always be given back to the system
+ * instead of the pool (e.g. while a thread exits, or if the depot is full).
+ */
+class ObjectPool
+{
+   public:
+      enum
+      {
+         CLASS_GRANULARITY = 64,
+         NUM_CLASSES = 32, // i.e. objects up to 2KiB are pooled
+         MAX_POOLED_SIZE = CLASS_GRANULARITY * NUM_CLASSES,
+
+         THREAD_CACHE_SIZE = 64, // max free blocks per class in a thread cache
+         TRANSFER_BATCH_SIZE = 32, // blocks moved between thread cache and depot at once
+         DEPOT_SIZE = 8192, // max free blocks per class in the depot
+      };
+
+      struct SizeClassStats
+      {
+         size_t objectSize;
+         uint64_t numAllocs; // total number of allocations
+         uint64_t numSystemAllocs; // allocations that were not served from a free list
+         uint64_t numSystemFrees; // releases that went to the system instead of a free list
+         uint64_t numDepotFree; // free blocks currently in the depot
+      };
+
+      static void* allocate(size_t size);
+      static void release(void* ptr, size_t size);
+
+      static void getStats(std::vector<SizeClassStats>* outStats);
+      static std::string getStatsAsStr();
+
+   private:
+      ObjectPool() {}
+
+   public:
+      // inliners
+
+      static bool isPooledSize(size_t size)
+      {
+         return size && size <= MAX_POOLED_SIZE;
+      }
+
+      static unsigned getSizeClass(size_t size)
+      {
+         return (size - 1) / CLASS_GRANULARITY;
+      }
+};
+
+/**
+ * Base class for classes whose objects are allocated from the ObjectPool.
+ *
+ * Note: Derived classes must have a virtual destructor if they are deleted through a base class
+ * pointer, so that the size of the most derived class is passed to operator delete.
+ */
+class PooledObject
+{
+   public:
+      static void* operator new(size_t size)
+      {
+         return ObjectPool::allocate(size);
+      }
+
+      static void operator delete(void* ptr, size_t size)
+      {
+         ObjectPool::release(ptr, size);
+      }
+};
+
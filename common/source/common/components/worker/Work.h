@@ -26,6 +26,18 @@ class Work
 
       virtual void process(char* bufIn, unsigned bufInLen, char* bufOut, unsigned bufOutLen) = 0;
 
+      /**
+       * Size of the input buffer that process() needs. Only used by workers that borrow their
+       * buffers from a BufferPool, to borrow a smaller buffer if possible.
+       *
+       * @param maxLen the size of the worker's full input buffer
+       * @return a value <= maxLen
+       */
+      virtual size_t getBufInLen(size_t maxLen) const
+      {
+         return maxLen;
+      }
+
    protected:
       HighResolutionStats stats;
 
@@ -9,6 +9,7 @@ Worker::Worker(const std::string& workerID, MultiWorkQueue* workQueue, QueueWork
       bufIn(NULL),
       bufOutLen(WORKER_BUFOUT_SIZE),
       bufOut(NULL),
+      bufPool(NULL),
       workQueue(workQueue),
       workType(workType),
       personalWorkQueue(new PersonalWorkQueue() )
@@ -65,7 +66,10 @@ void Worker::workLoop(QueueWorkType workType)
       HighResolutionStatsTk::resetStats(&stats); // prepare stats
 
       // process the work packet
-      work->process(bufIn, bufInLen, bufOut, bufOutLen);
+      if(bufPool)
+         processWithPooledBuffers(work);
+      else
+         work->process(bufIn, bufInLen, bufOut, bufOutLen);
 
       // update stats
       stats.incVals.workRequests = 1;
@@ -124,11 +128,32 @@ Work* Worker::waitForWorkByType(HighResolutionStats& newStats, PersonalWorkQueue
 }
 
 
+/**
+ * The buffers are only borrowed for the duration of process(), so the work must not keep
+ * references to them.
+ */
+void Worker::processWithPooledBuffers(Work* work)
+{
+   BufferPool::Lease leaseIn;
+   BufferPool::Lease leaseOut;
+
+   if(bufInLen)
+      leaseIn = bufPool->acquire(work->getBufInLen(bufInLen) );
+
+   if(bufOutLen)
+      leaseOut = bufPool->acquire(bufOutLen);
+
+   work->process(leaseIn.data(), leaseIn.size(), leaseOut.data(), leaseOut.size() );
+}
+
 /**
  * Note: For delayed buffer allocation during run(), because of NUMA-archs.
  */
 void Worker::initBuffers()
 {
+   if(bufPool)
+      return; // buffers are borrowed per work, see processWithPooledBuffers()
+
    if(this->bufInLen)
    {
       void* bufInVoid = NULL;
@@ -3,6 +3,7 @@
 #include <common/app/log/LogContext.h>
 #include <common/app/AbstractApp.h>
 #include <common/components/worker/queue/MultiWorkQueue.h>
+#include <common/components/worker/BufferPool.h>
 #include <common/components/worker/queue/PersonalWorkQueue.h>
 #include <common/components/ComponentInitException.h>
 #include <common/threading/PThread.h>
@@ -38,6 +39,8 @@ class Worker : public PThread
       size_t bufOutLen;
       char* bufOut;
 
+      BufferPool* bufPool; // if set, buffers are borrowed per work instead of bufIn/bufOut
+
       MultiWorkQueue* workQueue;
       QueueWorkType workType;
 
@@ -53,6 +56,7 @@ class Worker : public PThread
          QueueWorkType workType);
 
       void initBuffers();
+      void processWithPooledBuffers(Work* work);
 
       // inliners
       bool maySelfTerminateNow()
@@ -78,6 +82,17 @@ class Worker : public PThread
          this->bufOutLen = bufOutLen;
       }
 
+      /**
+       * Borrow buffers (of at most the sizes given to setBufLens() ) from the given pool for each
+       * work instead of allocating a fixed pair of buffers for this worker.
+       *
+       * Note: Do not use this after the run method of this component has been called!
+       */
+      void setBufferPool(BufferPool* bufPool)
+      {
+         this->bufPool = bufPool;
+      }
+
       MultiWorkQueue* getWorkQueue() const
       {
          return this->workQueue;
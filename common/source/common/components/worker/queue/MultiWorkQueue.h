@@ -72,7 +72,7 @@ class MultiWorkQueue : public StreamListenerWorkQueue
       AbstractWorkContainer* directWorkList;
       AbstractWorkContainer* indirectWorkList;
 
-      Mutex mutex;
+      Mutex mutex{"MultiWorkQueue::mutex"};
       Condition newDirectWorkCond; // direct workers wait only on this condition
       Condition newWorkCond; // for any type of work (indirect workers wait on this condition)
 
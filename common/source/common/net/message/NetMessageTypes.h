@@ -64,6 +64,8 @@
 #define NETMSGTYPE_RefreshStoragePools               1070
 #define NETMSGTYPE_RemoveStoragePool                 1071
 #define NETMSGTYPE_RemoveStoragePoolResp             1072
+#define NETMSGTYPE_MetaBenchControlMsg               1073
+#define NETMSGTYPE_MetaBenchControlMsgResp           1074
 
 // storage messages
 #define NETMSGTYPE_MkDir                           2001
@@ -14,6 +14,12 @@ class RequestStorageDataRespMsg: public NetMessageSerdes<RequestStorageDataRespM
          static const unsigned NODE_SUPPORTS_IPV6 = 1;
       };
 
+      // compat flags are ignored by older receivers, as is the data they announce at the end of
+      // the message
+      struct MsgCompatFlags {
+         static const uint8_t HAS_WRITEBACK_STATS = 1;
+      };
+
    private:
       std::string nodeID;
       std::string hostnameid;
@@ -59,6 +65,7 @@ class RequestStorageDataRespMsg: public NetMessageSerdes<RequestStorageDataRespM
          this->storageTargets = storageTargets;
 
          addMsgHeaderFeatureFlag(MsgFlags::NODE_SUPPORTS_IPV6);
+         addMsgHeaderCompatFeatureFlag(MsgCompatFlags::HAS_WRITEBACK_STATS);
       }
 
       RequestStorageDataRespMsg() :
@@ -90,8 +97,45 @@ class RequestStorageDataRespMsg: public NetMessageSerdes<RequestStorageDataRespM
             % obj->sessionCount
             % serdes::backedPtr(obj->statsList, obj->parsed.statsList)
             % serdes::backedPtr(obj->storageTargets, obj->parsed.storageTargets);
+
+         if (obj->isMsgHeaderCompatFeatureFlagSet(MsgCompatFlags::HAS_WRITEBACK_STATS) )
+            serializeWritebackStats(obj, ctx);
+      }
+
+   private:
+      /**
+       * The writeback stats of the storage targets, in the order of the target list.
+       */
+      static void serializeWritebackStats(const RequestStorageDataRespMsg* obj, Serializer& ser)
+      {
+         for (auto iter = obj->storageTargets->begin(); iter != obj->storageTargets->end(); iter++)
+         {
+            ser
+               % iter->getHasWritebackStats()
+               % iter->getWritebackStats();
+         }
+      }
+
+      static void serializeWritebackStats(RequestStorageDataRespMsg* obj, Deserializer& des)
+      {
+         for (auto iter = obj->parsed.storageTargets.begin();
+              iter != obj->parsed.storageTargets.end(); iter++)
+         {
+            bool hasWritebackStats;
+            StorageTargetInfo::WritebackStats writebackStats;
+
+            des
+               % hasWritebackStats
+               % writebackStats;
+
+            if (!des.good() )
+               return;
+
+            iter->setWritebackStats(hasWritebackStats, writebackStats);
+         }
       }
 
+   public:
       virtual unsigned getSupportedHeaderFeatureFlagsMask() const {
          return MsgFlags::NODE_SUPPORTS_IPV6;
       }
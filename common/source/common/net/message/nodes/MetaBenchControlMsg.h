@@ -0,0 +1,73 @@
+#pragma once
+
+#include <common/benchmark/MetaBench.h>
+#include <common/net/message/NetMessage.h>
+#include <common/toolkit/serialization/Serialization.h>
+#include <common/Common.h>
+
+
+class MetaBenchControlMsg: public NetMessageSerdes<MetaBenchControlMsg>
+{
+   public:
+      /*
+       * @param numThreads number of threads which work on the MetaStore concurrently
+       * @param numFiles number of files per thread
+       * @param sharedDir true to let all threads work in the same directory, otherwise each thread
+       *    gets a directory of its own
+       */
+      MetaBenchControlMsg(StorageBenchAction action, unsigned numThreads, unsigned numFiles,
+         bool sharedDir) : BaseType(NETMSGTYPE_MetaBenchControlMsg)
+      {
+         this->action = action;
+         this->numThreads = numThreads;
+         this->numFiles = numFiles;
+         this->sharedDir = sharedDir;
+      }
+
+      /**
+       * Constructor for deserialization only!
+       */
+      MetaBenchControlMsg() : BaseType(NETMSGTYPE_MetaBenchControlMsg)
+      {
+      }
+
+      template<typename This, typename Ctx>
+      static void serialize(This obj, Ctx& ctx)
+      {
+         ctx
+            % obj->action
+            % obj->numThreads
+            % obj->numFiles
+            % obj->sharedDir;
+      }
+
+   private:
+      int32_t action; // StorageBenchAction
+      uint32_t numThreads;
+      uint32_t numFiles;
+      bool sharedDir;
+
+   public:
+      //inliners
+
+      StorageBenchAction getAction() const
+      {
+         return (StorageBenchAction)action;
+      }
+
+      unsigned getNumThreads() const
+      {
+         return numThreads;
+      }
+
+      unsigned getNumFiles() const
+      {
+         return numFiles;
+      }
+
+      bool getSharedDir() const
+      {
+         return sharedDir;
+      }
+};
+
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <common/benchmark/MetaBench.h>
+#include <common/net/message/NetMessage.h>
+#include <common/toolkit/serialization/Serialization.h>
+
+
+class MetaBenchControlMsgResp: public NetMessageSerdes<MetaBenchControlMsgResp>
+{
+   public:
+      /*
+       * @param errorCode STORAGEBENCH_ERROR_...
+       * @param results one element per finished phase of the current or last run
+       */
+      MetaBenchControlMsgResp(StorageBenchStatus status, StorageBenchAction action, int errorCode,
+         const MetaBenchResultVec& results) : BaseType(NETMSGTYPE_MetaBenchControlMsgResp),
+         status(status), action(action), errorCode(errorCode), results(results)
+      {
+      }
+
+      /**
+       * Constructor for deserialization only
+       */
+      MetaBenchControlMsgResp() : BaseType(NETMSGTYPE_MetaBenchControlMsgResp)
+      {
+      }
+
+      template<typename This, typename Ctx>
+      static void serialize(This obj, Ctx& ctx)
+      {
+         ctx
+            % obj->status
+            % obj->action
+            % obj->errorCode
+            % obj->results;
+      }
+
+   private:
+      int32_t status;                // StorageBenchStatus
+      int32_t action;                // StorageBenchAction
+      int32_t errorCode;             // STORAGEBENCH_ERROR...
+      MetaBenchResultVec results;
+
+   public:
+      //inliners
+
+      StorageBenchStatus getStatus() const
+      {
+         return (StorageBenchStatus)status;
+      }
+
+      StorageBenchAction getAction() const
+      {
+         return (StorageBenchAction)action;
+      }
+
+      int getErrorCode() const
+      {
+         return errorCode;
+      }
+
+      const MetaBenchResultVec& getResults() const
+      {
+         return results;
+      }
+};
+
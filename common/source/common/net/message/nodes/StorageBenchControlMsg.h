@@ -6,6 +6,9 @@
 #include <common/toolkit/serialization/Serialization.h>
 
 
+#define STORAGEBENCHCONTROLMSG_FLAG_HAS_MODE    1 /* contains a StorageBenchMode */
+
+
 class StorageBenchControlMsg: public NetMessageSerdes<StorageBenchControlMsg>
 {
    public:
@@ -40,6 +43,23 @@ class StorageBenchControlMsg: public NetMessageSerdes<StorageBenchControlMsg>
             % obj->threads
             % obj->odirect
             % serdes::backedPtr(obj->targetIDs, obj->parsed.targetIDs);
+
+         if (obj->isMsgHeaderFeatureFlagSet(STORAGEBENCHCONTROLMSG_FLAG_HAS_MODE) )
+            ctx % obj->mode;
+      }
+
+      unsigned getSupportedHeaderFeatureFlagsMask() const
+      {
+         return STORAGEBENCHCONTROLMSG_FLAG_HAS_MODE;
+      }
+
+      /**
+       * Sets a non-default access pattern (random offsets, mixes, queue depth).
+       */
+      void setMode(const StorageBenchMode& mode)
+      {
+         this->mode = mode;
+         addMsgHeaderFeatureFlag(STORAGEBENCHCONTROLMSG_FLAG_HAS_MODE);
       }
 
    private:
@@ -50,6 +70,7 @@ class StorageBenchControlMsg: public NetMessageSerdes<StorageBenchControlMsg>
       int32_t threads;
       bool odirect;
       UInt16List* targetIDs;
+      StorageBenchMode mode; // default mode if STORAGEBENCHCONTROLMSG_FLAG_HAS_MODE is not set
 
       // deserialization info
       struct {
@@ -93,5 +114,10 @@ class StorageBenchControlMsg: public NetMessageSerdes<StorageBenchControlMsg>
       {
          return *targetIDs;
       }
+
+      const StorageBenchMode& getMode() const
+      {
+         return mode;
+      }
 };
 
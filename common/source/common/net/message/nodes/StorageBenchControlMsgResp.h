@@ -6,6 +6,9 @@
 #include <common/toolkit/ZipIterator.h>
 
 
+#define STORAGEBENCHCONTROLMSGRESP_FLAG_HAS_LATENCIES    1 /* contains latency results */
+
+
 class StorageBenchControlMsgResp: public NetMessageSerdes<StorageBenchControlMsgResp>
 {
    public:
@@ -45,6 +48,24 @@ class StorageBenchControlMsgResp: public NetMessageSerdes<StorageBenchControlMsg
             % obj->errorCode
             % obj->resultTargetIDs
             % obj->resultValues;
+
+         if (obj->isMsgHeaderFeatureFlagSet(STORAGEBENCHCONTROLMSGRESP_FLAG_HAS_LATENCIES) )
+            ctx % obj->latencyResults;
+      }
+
+      unsigned getSupportedHeaderFeatureFlagsMask() const
+      {
+         return STORAGEBENCHCONTROLMSGRESP_FLAG_HAS_LATENCIES;
+      }
+
+      /**
+       * Note: only for receivers which sent a StorageBenchControlMsg with a mode, older receivers
+       * don't know the flag.
+       */
+      void setLatencyResults(const StorageBenchLatencyMap& latencyResults)
+      {
+         this->latencyResults = latencyResults;
+         addMsgHeaderFeatureFlag(STORAGEBENCHCONTROLMSGRESP_FLAG_HAS_LATENCIES);
       }
 
    private:
@@ -54,6 +75,7 @@ class StorageBenchControlMsgResp: public NetMessageSerdes<StorageBenchControlMsg
       int32_t errorCode;             // STORAGEBENCH_ERROR...
       UInt16List resultTargetIDs;
       Int64List resultValues;
+      StorageBenchLatencyMap latencyResults;
 
    public:
       //inliners
@@ -86,5 +108,17 @@ class StorageBenchControlMsgResp: public NetMessageSerdes<StorageBenchControlMsg
             (*outResults)[*(valuesTargetIDIter()->second)] = *(valuesTargetIDIter()->first);
          }
       }
+
+      /**
+       * @return false if the response doesn't contain latency results
+       */
+      bool parseLatencyResults(StorageBenchLatencyMap* outResults)
+      {
+         if (!isMsgHeaderFeatureFlagSet(STORAGEBENCHCONTROLMSGRESP_FLAG_HAS_LATENCIES) )
+            return false;
+
+         *outResults = latencyResults;
+         return true;
+      }
 };
 
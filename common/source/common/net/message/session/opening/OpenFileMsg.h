@@ -11,6 +11,10 @@
 #define OPENFILEMSG_FLAG_HAS_EVENT           2 /* contains file event logging information */
 #define OPENFILEMSG_FLAG_BYPASS_ACCESS_CHECK 4 /* bypass file access checks on metadata server */
 
+/* compat flags, ignored by servers that don't know them (with the data they announce at the end of
+   the msg) */
+#define OPENFILEMSG_COMPATFLAG_INLINE_DATA   1 /* client accepts file contents in the response */
+
 class OpenFileMsg : public MirroredMessageBase<OpenFileMsg>
 {
    public:
@@ -24,6 +28,7 @@ class OpenFileMsg : public MirroredMessageBase<OpenFileMsg>
           : BaseType(NETMSGTYPE_OpenFile),
             clientNumID(clientNumID),
             accessFlags(accessFlags),
+            maxInlineDataSize(0),
             entryInfoPtr(entryInfo)
       { }
 
@@ -49,6 +54,10 @@ class OpenFileMsg : public MirroredMessageBase<OpenFileMsg>
 
          if (obj->isMsgHeaderFeatureFlagSet(OPENFILEMSG_FLAG_HAS_EVENT))
             ctx % obj->fileEvent;
+
+         // (must stay the last field, see OPENFILEMSG_COMPATFLAG_INLINE_DATA)
+         if (obj->isMsgHeaderCompatFeatureFlagSet(OPENFILEMSG_COMPATFLAG_INLINE_DATA))
+            ctx % obj->maxInlineDataSize;
       }
 
    private:
@@ -62,6 +71,8 @@ class OpenFileMsg : public MirroredMessageBase<OpenFileMsg>
 
       FileEvent fileEvent;
 
+      uint32_t maxInlineDataSize; // max size of file contents that the client accepts
+
       // serialization
       const EntryInfo* entryInfoPtr;
 
@@ -118,6 +129,17 @@ class OpenFileMsg : public MirroredMessageBase<OpenFileMsg>
          this->sessionFileID = sessionFileID;
       }
 
+      /**
+       * @return 0 if the client does not accept file contents in the response.
+       */
+      unsigned getMaxInlineDataSize() const
+      {
+         if (isMsgHeaderCompatFeatureFlagSet(OPENFILEMSG_COMPATFLAG_INLINE_DATA))
+            return maxInlineDataSize;
+         else
+            return 0;
+      }
+
       const FileEvent* getFileEvent() const
       {
          if (isMsgHeaderFeatureFlagSet(OPENFILEMSG_FLAG_HAS_EVENT))
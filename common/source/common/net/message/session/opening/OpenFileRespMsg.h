@@ -6,6 +6,9 @@
 #include <common/Common.h>
 
 
+#define OPENFILERESPMSG_FLAG_INLINE_DATA  1 /* msg includes the file contents */
+
+
 class OpenFileRespMsg : public NetMessageSerdes<OpenFileRespMsg>
 {
    public:
@@ -59,6 +62,14 @@ class OpenFileRespMsg : public NetMessageSerdes<OpenFileRespMsg>
             % obj->pathInfo
             % serdes::backedPtr(obj->pattern, obj->parsed.pattern)
             % obj->fileVersion;
+
+         if (obj->isMsgHeaderFeatureFlagSet(OPENFILERESPMSG_FLAG_INLINE_DATA) )
+            ctx % serdes::stringAlign4(obj->inlineData);
+      }
+
+      unsigned getSupportedHeaderFeatureFlagsMask() const override
+      {
+         return OPENFILERESPMSG_FLAG_INLINE_DATA;
       }
 
    private:
@@ -67,6 +78,7 @@ class OpenFileRespMsg : public NetMessageSerdes<OpenFileRespMsg>
       const char* fileHandleID;
       PathInfo pathInfo;
       uint32_t fileVersion;
+      std::string inlineData;
 
       // for serialization
       StripePattern* pattern; // not owned by this object!
@@ -96,5 +108,19 @@ class OpenFileRespMsg : public NetMessageSerdes<OpenFileRespMsg>
       {
          return &this->pathInfo;
       }
+
+      /**
+       * @param data the complete file contents, for clients that opened the file read-only
+       */
+      void setInlineData(std::string data)
+      {
+         this->inlineData = std::move(data);
+         addMsgHeaderFeatureFlag(OPENFILERESPMSG_FLAG_INLINE_DATA);
+      }
+
+      const std::string& getInlineData() const
+      {
+         return inlineData;
+      }
 };
 
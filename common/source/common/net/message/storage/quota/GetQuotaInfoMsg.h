@@ -8,6 +8,9 @@
 
 #define GETQUOTAINFOMSG_FEATURE_QUOTA_PER_TARGET         1
 
+#define GETQUOTAINFOMSG_FLAG_CHANGED_ONLY                1 /* only report changed usage, see
+                                                              GETQUOTAINFORESPMSG_FLAG_CHANGES_ONLY */
+
 
 class GetQuotaInfoMsg: public NetMessageSerdes<GetQuotaInfoMsg>
 {
@@ -158,5 +161,10 @@ class GetQuotaInfoMsg: public NetMessageSerdes<GetQuotaInfoMsg>
          this->targetNumID = 0;
          this->targetSelection = GETQUOTACONFIG_ALL_TARGETS_ONE_REQUEST;
       }
+
+      unsigned getSupportedHeaderFeatureFlagsMask() const
+      {
+         return GETQUOTAINFOMSG_FLAG_CHANGED_ONLY;
+      }
 };
 
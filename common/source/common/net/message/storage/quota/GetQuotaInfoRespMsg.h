@@ -10,6 +10,11 @@
 #define GETQUOTAINFORESPMSG_MAX_ID_COUNT              ( (unsigned) \
    ( (GETQUOTAINFORESPMSG_MAX_SIZE_FOR_QUOTA_DATA - sizeof(unsigned) ) / sizeof(QuotaData) ) )
 
+/* the quota data contains only the IDs whose usage changed since the previous response, IDs which
+   don't use anything anymore are contained with a usage of 0. Without this flag, the quota data
+   contains all requested IDs which use something. */
+#define GETQUOTAINFORESPMSG_FLAG_CHANGES_ONLY         1
+
 
 class GetQuotaInfoRespMsg: public NetMessageSerdes<GetQuotaInfoRespMsg>
 {
@@ -63,5 +68,10 @@ class GetQuotaInfoRespMsg: public NetMessageSerdes<GetQuotaInfoRespMsg>
       {
          return (QuotaInodeSupport)quotaInodeSupport;
       }
+
+      unsigned getSupportedHeaderFeatureFlagsMask() const
+      {
+         return GETQUOTAINFORESPMSG_FLAG_CHANGES_ONLY;
+      }
 };
 
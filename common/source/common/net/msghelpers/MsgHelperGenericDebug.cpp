@@ -1,5 +1,7 @@
 #include <common/app/AbstractApp.h>
 #include <common/system/System.h>
+#include <common/components/worker/ObjectPool.h>
+#include <common/threading/LockProfiler.h>
 #include <common/threading/PThread.h>
 #include <common/toolkit/ZipIterator.h>
 #include "MsgHelperGenericDebug.h"
@@ -120,6 +122,13 @@ std::string MsgHelperGenericDebug::processOpCfgFile(std::istringstream& commandS
    return loadTextFile(cfgFile);
 }
 
+std::string MsgHelperGenericDebug::processOpObjectPoolStats(std::istringstream& commandStream)
+{
+   // protocol: no arguments
+
+   return ObjectPool::getStatsAsStr();
+}
+
 /**
  * Print currently established (outgoing) connections of this node to other nodes, similar to
  * the output of the "fhgfs-net" tool.
@@ -137,6 +146,43 @@ std::string MsgHelperGenericDebug::processOpNetOut(std::istringstream& commandSt
    return responseStream.str();
 }
 
+/**
+ * Enable, disable or reset lock profiling, or print the most contended locks.
+ */
+std::string MsgHelperGenericDebug::processOpLockStats(std::istringstream& commandStream)
+{
+   // protocol: "enable", "disable", "reset" or the (optional) max number of locks to report
+
+   const unsigned defaultMaxLocks = 20;
+
+   std::string argStr;
+
+   std::getline(commandStream, argStr, ' ');
+
+   if (argStr == "enable")
+   {
+      LockProfiler::setEnabled(true);
+      return "Lock profiling enabled.";
+   }
+
+   if (argStr == "disable")
+   {
+      LockProfiler::setEnabled(false);
+      return "Lock profiling disabled.";
+   }
+
+   if (argStr == "reset")
+   {
+      LockProfiler::reset();
+      return "Lock profiling statistics reset.";
+   }
+
+   if (!argStr.empty() && !StringTk::isNumeric(argStr) )
+      return "Invalid argument. Use enable, disable, reset or the number of locks to report.";
+
+   return LockProfiler::getReport(argStr.empty() ? defaultMaxLocks : StringTk::strToUInt(argStr) );
+}
+
 /**
  * Opens a text file and reads it. Only the last part (see GENDBGMSG_TXTFILE_MAX_READ_LEN) is
  * returned if the file is too large.
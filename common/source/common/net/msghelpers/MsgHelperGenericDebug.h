@@ -20,6 +20,8 @@
 #define GENDBGMSG_OP_LISTSTORAGESTATES    "liststoragestates"
 #define GENDBGMSG_OP_LISTSTORAGEPOOLS     "liststoragepools"
 #define GENDBGMSG_OP_SETREJECTIONRATE     "setrejectionrate"
+#define GENDBGMSG_OP_LOCKSTATS            "lockstats"
+#define GENDBGMSG_OP_OBJECTPOOLSTATS      "objectpoolstats"
 
 
 class MsgHelperGenericDebug
@@ -33,6 +35,8 @@ class MsgHelperGenericDebug
       static std::string processOpCfgFile(std::istringstream& commandStream, std::string cfgFile);
       static std::string processOpGetLogLevel(std::istringstream& commandStream);
       static std::string processOpSetLogLevel(std::istringstream& commandStream);
+      static std::string processOpLockStats(std::istringstream& commandStream);
+      static std::string processOpObjectPoolStats(std::istringstream& commandStream);
       static std::string processOpNetOut(std::istringstream& commandStream,
          const NodeStoreServers* mgmtNodes, const NodeStoreServers* metaNodes,
          const NodeStoreServers* storageNodes);
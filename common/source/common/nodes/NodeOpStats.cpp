@@ -1,6 +1,70 @@
 #include "NodeOpStats.h"
 #include "common/Common.h"
 
+#include <algorithm>
+
+thread_local NodeOpStats::ThreadShard NodeOpStats::threadShard = {0, nullptr};
+std::atomic<uint64_t> NodeOpStats::nextStatsID(1); // 0 is the "no shard yet" value of threadShard
+
+/**
+ * @param numOpCounters OpCounterLastEnum of the counted operations, i.e. the number of operation
+ * counters including sum element.
+ */
+NodeOpStats::NodeOpStats(int numOpCounters) :
+   numOpCounters(numOpCounters), statsID(nextStatsID.fetch_add(1) )
+{
+}
+
+/**
+ * Get or create the shard of the calling thread. A thread with the ID of a thread that has exited
+ * takes over the shard of the latter, so the number of shards is bounded by the number of threads
+ * that exist at the same time.
+ */
+NodeOpStats::Shard* NodeOpStats::registerThreadShard()
+{
+   const std::lock_guard<Mutex> lock(shardsMutex);
+
+   std::unique_ptr<Shard>& shard = shards[std::this_thread::get_id()];
+   if (!shard)
+      shard.reset(new Shard(numOpCounters) );
+
+   threadShard.statsID = statsID;
+   threadShard.shard = shard.get();
+
+   return shard.get();
+}
+
+void NodeOpStats::Shard::applyPendingRemovals()
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   for (auto iter = pendingRemovals.begin(); iter != pendingRemovals.end(); iter++)
+      clientCounterMap.erase(*iter);
+
+   pendingRemovals.clear();
+   hasPendingRemovals.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * Erase the given node from the stats. The owner threads erase it from their shards on their next
+ * update, until then readers skip it.
+ *
+ * @param IP of a node
+ */
+void NodeOpStats::removeClientFromMap(uint128_t nodeIP)
+{
+   const std::lock_guard<Mutex> lock(shardsMutex);
+
+   for (auto iter = shards.begin(); iter != shards.end(); iter++)
+   {
+      Shard& shard = *iter->second;
+      const std::lock_guard<Mutex> shardLock(shard.mutex);
+
+      shard.pendingRemovals.push_back(nodeIP);
+      shard.hasPendingRemovals.store(true, std::memory_order_relaxed);
+   }
+}
+
 /**
  * @param cookieIP  - If several transfers are required to transfer the map to the client,
  *                    cookieIP is the last IP (in the vector) of the last transfer. We will then
@@ -10,39 +74,66 @@
  * @param vec       - The map is encoded as vector. Format is:
  *                    numOPs, IP1, opCounter1, opCounter2, ..., opCounterN,
  *                    IP2, opCounter1, opCounter2, ..., opCounterN, IP3, ...
+ *
+ * Note: The counters of all shards are summed up for the IPs after cookieIP on every call, so the
+ * counter values of a multi-vector transfer are not a consistent snapshot.
  */
 bool NodeOpStats::mapToUInt128Vec(uint128_t cookieIP, size_t bufLen, bool wantPerUserStats,
    Uint128Vector *outVec)
 {
-   SafeRWLock safeLock(&lock, SafeRWLock_READ); // L O C K
+   typedef std::map<uint128_t, std::vector<uint64_t>> SumMap; // key: IP/userID, val: counters
+
+   // NOTE: This is a bit tricky. For some reasons we also have to deal with cookieIP = 0
+   // and as it is an unsigned, we also cannot initialize with '-1'. Therefore fhgfs-ctl
+   // sends ~0 to notifify us that no cookie is set.
+   const bool haveCookie =
+      !(uint128::lower64(cookieIP) == ~0ULL && uint128::upper64(cookieIP) == ~0ULL);
 
-   NodeOpCounterMap* counterMap = wantPerUserStats ? &userCounterMap : &clientCounterMap;
-   NodeOpCounterMapIter mapIter;
+   // sum up the counters of all shards for the IPs after the given cookieIP (if any)
 
-   // position iter right after given cookieIP (if any)
+   SumMap sumMap;
 
-   if (uint128::lower64(cookieIP) == ~0ULL && uint128::upper64(cookieIP) == ~0ULL)
    {
-      // NOTE: This is a bit tricky. For some reasons we also have to deal with cookieIP = 0
-      // and as it is an unsigned, we also cannot initialize with '-1'. Therefore fhgfs-ctl
-      // sends ~0 to notifify us that no cookie is set.
-      mapIter = counterMap->begin();
-   }
-   else
-      mapIter = counterMap->upper_bound(cookieIP);
+      const std::lock_guard<Mutex> lock(shardsMutex);
+
+      for (auto shardIter = shards.begin(); shardIter != shards.end(); shardIter++)
+      {
+         Shard& shard = *shardIter->second;
+         const std::lock_guard<Mutex> shardLock(shard.mutex);
+
+         NodeOpCounterMap& counterMap =
+            wantPerUserStats ? shard.userCounterMap : shard.clientCounterMap;
+
+         for (auto iter = counterMap.begin(); iter != counterMap.end(); iter++)
+         {
+            if (haveCookie && iter->first <= cookieIP)
+               continue;
+
+            if (!wantPerUserStats && shard.hasPendingRemovals.load(std::memory_order_relaxed) &&
+                  std::find(shard.pendingRemovals.begin(), shard.pendingRemovals.end(),
+                     iter->first) != shard.pendingRemovals.end() )
+               continue;
 
-   if (mapIter == counterMap->end() )
-   { // reached end of map => nothing to return in outVec
-      safeLock.unlock(); // U N L O C K
-      return true;
+            std::vector<uint64_t>& sums = sumMap[iter->first];
+            sums.resize(numOpCounters);
+
+            for (int i = 0; i < numOpCounters; i++)
+               sums[i] += iter->second.getOpCounter(i);
+         }
+      }
    }
 
+   auto mapIter = sumMap.begin();
+
+   if (mapIter == sumMap.end() )
+      return true; // reached end of map => nothing to return in outVec
+
    // max number of IPs and their counters that fit into the vector
-   unsigned maxNumIPs = getMaxIPsPerVector(&mapIter->second, bufLen);
+   unsigned maxNumIPs = getMaxIPsPerVector(bufLen);
 
    // make the vector buffer sufficiently large
-   size_t numReserveIPs = BEEGFS_MIN(maxNumIPs, counterMap->size() );
-   reserveVector(&mapIter->second, numReserveIPs, outVec);
+   size_t numReserveIPs = BEEGFS_MIN(maxNumIPs, sumMap.size() );
+   reserveVector(numReserveIPs, outVec);
 
    // pre-allocate the header meta-elements in the vector with zeros
    for (int i=0; i < NODE_OPS_POS_FIRSTDATAELEMENT; i++)
@@ -53,7 +144,7 @@ bool NodeOpStats::mapToUInt128Vec(uint128_t cookieIP, size_t bufLen, bool wantPe
    // (error-prone) order
 
    // VERY FIRST ELEMENT IN THE VECTOR ARE THE NUMBER OF OPs
-   outVec->at(NODEOPS_POS_NUMOPS) = mapIter->second.getNumCounter();
+   outVec->at(NODEOPS_POS_NUMOPS) = numOpCounters;
 
    outVec->at(NODE_OPS_POS_MORE_DATA) = 0; // quasi-boolean ("0" means all stats fit into vector)
 
@@ -61,7 +152,7 @@ bool NodeOpStats::mapToUInt128Vec(uint128_t cookieIP, size_t bufLen, bool wantPe
 
    // iterate over all IPs in the map and add IP and op-counters to the vector
    unsigned numIPs = 0; // number of IPs we have stored in the vector
-   while ( (mapIter != counterMap->end() ) && (numIPs < maxNumIPs) )
+   while ( (mapIter != sumMap.end() ) && (numIPs < maxNumIPs) )
    {
       // NOTE: we use push_back here, so no absolute enum based positions. Therefore
       //       the layout of this vector component should not change!
@@ -70,17 +161,15 @@ bool NodeOpStats::mapToUInt128Vec(uint128_t cookieIP, size_t bufLen, bool wantPe
       outVec->push_back(mapIter->first) ;
 
       // push_back counters belonging to that IP
-      mapIter->second.addCountersToVec(outVec);
+      outVec->insert(outVec->end(), mapIter->second.begin(), mapIter->second.end() );
 
       mapIter++;
       numIPs++;
    }
 
-   if (mapIter != counterMap->end() )
+   if (mapIter != sumMap.end() )
       outVec->at(NODE_OPS_POS_MORE_DATA) = 1;
 
-   safeLock.unlock(); // L O C K
-
    return true;
 }
 
@@ -90,7 +179,7 @@ bool NodeOpStats::mapToUInt128Vec(uint128_t cookieIP, size_t bufLen, bool wantPe
  * This function returns the maximum number of IPs (including their OpCounter values)
  * fitting into a single request (i.e. the given bufLen).
  */
-int NodeOpStats::getMaxIPsPerVector(OpCounter *opCounter, size_t bufLen)
+int NodeOpStats::getMaxIPsPerVector(size_t bufLen)
 {
    // vector layout is: headerElem1..n, IP1, counterIP1_1..n, IP2, counterIP2_1..n, IP3, ...
 
@@ -101,8 +190,7 @@ int NodeOpStats::getMaxIPsPerVector(OpCounter *opCounter, size_t bufLen)
    // available for per-IP vectors without the space for header elements
    int numAvailableIPElems = numElems - STATS_VEC_RESERVED_ELEMENTS;
 
-   // number of opcounters of the given opCounter object for a single client IP vector
-   int numOpCounters = opCounter->getNumCounter();
+   // numOpCounters is the number of opcounters for a single client IP vector
 
    int maxNumIPs = numAvailableIPElems / (numOpCounters + OPCOUNTERVECTOR_POS_FIRSTCOUNTER);
 
@@ -113,9 +201,8 @@ int NodeOpStats::getMaxIPsPerVector(OpCounter *opCounter, size_t bufLen)
 /**
  * Pre-alloc internal vector buffers for given number of IPs
  */
-bool NodeOpStats::reserveVector(OpCounter *opCounter, size_t numIPs, Uint128Vector *outVec)
+bool NodeOpStats::reserveVector(size_t numIPs, Uint128Vector *outVec)
 {
-   int numOpCounters = opCounter->getNumCounter();
    int perIPElems = numOpCounters + OPCOUNTERVECTOR_POS_FIRSTCOUNTER;
 
    int totalNumElems = STATS_VEC_RESERVED_ELEMENTS + (perIPElems * numIPs);
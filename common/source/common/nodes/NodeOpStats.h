@@ -1,8 +1,15 @@
 #pragma once
 
 #include <common/nodes/OpCounter.h>
-#include <common/threading/SafeRWLock.h>
+#include <common/threading/Mutex.h>
 #include <common/nodes/Node.h>
+#include <common/toolkit/UInt128.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // layout version ofthe vector transfered to fhgfs-ctl
@@ -49,8 +56,8 @@ enum StatsMetaVecPos
    (NODE_OPS_POS_FIRSTDATAELEMENT + OPCOUNTERVECTOR_POS_FIRSTCOUNTER)
 
 
-typedef std::map<uint128_t, OpCounter> NodeOpCounterMap; // key: nodeIP/userID, val: op counters
-typedef NodeOpCounterMap::value_type NodeOpCounterMapVal;
+// key: nodeIP/userID, val: op counters
+typedef std::unordered_map<uint128_t, OpCounter, uint128::Hash> NodeOpCounterMap;
 typedef NodeOpCounterMap::iterator NodeOpCounterMapIter;
 
 /**
@@ -58,37 +65,106 @@ typedef NodeOpCounterMap::iterator NodeOpCounterMapIter;
  *
  * This is the common basis of "MetaNodeOpStats" and "StorageNodeOpStats", which provide the method
  * updateNodeOp() to update corresponding metadata and storage operation counters.
+ *
+ * The counters are sharded by thread: every thread that updates counters gets its own shard, in
+ * which it is the only writer. Updates thus neither take locks nor write to cache lines that are
+ * shared with other workers, even if all of them serve the same client. Readers sum up the
+ * counters of all shards.
  */
 class NodeOpStats
 {
    public:
+      NodeOpStats(int numOpCounters);
+
+      NodeOpStats(const NodeOpStats&) = delete;
+      NodeOpStats& operator=(const NodeOpStats&) = delete;
+
       bool mapToUInt128Vec(uint128_t cookieIP, size_t bufLen, bool wantPerUserStats,
          Uint128Vector *outVec);
-
-   private:
-      int getMaxIPsPerVector(OpCounter *opCounter, size_t bufLen);
-      bool reserveVector(OpCounter *opCounter, size_t numIPs, Uint128Vector *outVec);
+      void removeClientFromMap(uint128_t nodeIP);
 
    protected:
-      NodeOpCounterMap clientCounterMap; // maps IPs to corresponding operation counters
-      NodeOpCounterMap userCounterMap; // maps userIDs to corresponding operation counters
-
-      RWLock lock;
-
-   public:
-
       /**
-       * Erase the given node from the map
+       * The counters of a single thread.
        *
-       * @param IP of a node
+       * Only the owner thread modifies the maps. It takes the mutex only to insert or erase
+       * entries, readers (which never modify) take it to iterate.
        */
-      void removeClientFromMap(uint128_t nodeIP)
+      class Shard
+      {
+         friend class NodeOpStats;
+
+         public:
+            Shard(int numOpCounters) : numOpCounters(numOpCounters), hasPendingRemovals(false) {}
+
+         private:
+            const int numOpCounters;
+
+            Mutex mutex;
+            NodeOpCounterMap clientCounterMap; // maps IPs to corresponding operation counters
+            NodeOpCounterMap userCounterMap; // maps userIDs to corresponding operation counters
+
+            // clients removed by other threads, erased by the owner on its next update
+            std::vector<uint128_t> pendingRemovals; // protected by mutex
+            std::atomic<bool> hasPendingRemovals;
+
+            OpCounter& getCounter(NodeOpCounterMap& map, uint128_t key)
+            {
+               NodeOpCounterMapIter iter = map.find(key);
+               if (likely(iter != map.end() ) )
+                  return iter->second;
+
+               const std::lock_guard<Mutex> lock(mutex);
+
+               return map.emplace(key, numOpCounters).first->second;
+            }
+
+            void applyPendingRemovals();
+
+         public:
+            // inliners
+
+            OpCounter& getClientCounter(uint128_t nodeIP)
+            {
+               if (unlikely(hasPendingRemovals.load(std::memory_order_relaxed) ) )
+                  applyPendingRemovals();
+
+               return getCounter(clientCounterMap, nodeIP);
+            }
+
+            OpCounter& getUserCounter(unsigned userID)
+            {
+               return getCounter(userCounterMap, userID);
+            }
+      };
+
+      Shard* getThreadShard()
       {
-         SafeRWLock safeLock(&lock, SafeRWLock_WRITE);
-         clientCounterMap.erase(nodeIP); // erase by key
-         safeLock.unlock();
+         if (likely(threadShard.statsID == statsID) )
+            return threadShard.shard;
+
+         return registerThreadShard();
       }
 
-};
+   private:
+      struct ThreadShard
+      {
+         uint64_t statsID; // ID of the NodeOpStats that shard belongs to
+         Shard* shard;
+      };
 
+      // the shard of the NodeOpStats instance that the current thread used last
+      static thread_local ThreadShard threadShard;
+      static std::atomic<uint64_t> nextStatsID;
 
+      const int numOpCounters;
+      const uint64_t statsID; // unique per instance, unlike its address
+
+      Mutex shardsMutex;
+      std::map<std::thread::id, std::unique_ptr<Shard>> shards; // protected by shardsMutex
+
+      Shard* registerThreadShard();
+
+      int getMaxIPsPerVector(size_t bufLen);
+      bool reserveVector(size_t numIPs, Uint128Vector *outVec);
+};
@@ -2,17 +2,15 @@
 
 #include <common/toolkit/StringTk.h>
 #include <common/Common.h>
-#include <common/threading/Atomics.h>
 #include <common/nodes/Node.h>
 #include <common/app/log/LogContext.h>
 #include <common/nodes/OpCounterTypes.h>
 
-
-#define OPCOUNTER_SUM_ELEM_INDEX   0
+#include <atomic>
+#include <memory>
 
 
-typedef std::vector<AtomicUInt64> AtomicUInt64Vector;
-typedef AtomicUInt64Vector::iterator AtomicUInt64VectorIter;
+#define OPCOUNTER_SUM_ELEM_INDEX   0
 
 
 /**
@@ -26,29 +24,37 @@ typedef AtomicUInt64Vector::iterator AtomicUInt64VectorIter;
  *
  * Note: This class always uses the element at position 0(==OPCOUNTER_SUM_INDEX) as special element
  * that represents the sum of all individual other operations.
+ *
+ * Note: The counters must only be increased by a single thread (see NodeOpStats), which allows
+ * plain relaxed loads and stores instead of atomic read-modify-write operations. Other threads may
+ * read the counters concurrently.
  */
 class OpCounter
 {
    public:
-
-
-   protected:
       /**
        * @param numOps OpCounterLastEnum, i.e. the number of operation counters including sum
        * element.
        */
-      OpCounter(int numOps)
+      explicit OpCounter(int numOps) :
+         opCounters(new std::atomic<uint64_t>[numOps]), numCounter(numOps)
       {
-         this->numCounter = numOps;
-
-         opCounters.resize(this->numCounter);
+         for (int i = 0; i < numCounter; i++)
+            opCounters[i].store(0, std::memory_order_relaxed);
       }
 
 
    private:
-      AtomicUInt64Vector opCounters;
+      std::unique_ptr<std::atomic<uint64_t>[]> opCounters;
       int numCounter; // OpCounterLastEnum, so the number of operaration counters
 
+      void increase(int index, uint64_t value)
+      {
+         std::atomic<uint64_t>& counter = opCounters[index];
+
+         counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+      }
+
 
    public:
 
@@ -78,8 +84,8 @@ class OpCounter
          }
          #endif // BEEGFS_DEBUG
 
-         opCounters[opType].increase();
-         opCounters[OPCOUNTER_SUM_ELEM_INDEX].increase();
+         increase(opType, 1);
+         increase(OPCOUNTER_SUM_ELEM_INDEX, 1);
 
          return true;
       }
@@ -97,10 +103,10 @@ class OpCounter
             return; // something entirely wrong
 
          if(opType == StorageOpCounter_READOPS)
-            opCounters[StorageOpCounter_READBYTES].increase(numBytes);
+            increase(StorageOpCounter_READBYTES, numBytes);
          else
          if(opType == StorageOpCounter_WRITEOPS)
-            opCounters[StorageOpCounter_WRITEBYTES].increase(numBytes);
+            increase(StorageOpCounter_WRITEBYTES, numBytes);
          else
          { // invalid opType given (should never happen)
             LogContext log(__func__);
@@ -114,41 +120,16 @@ class OpCounter
       /**
        * Read current counter value.
        */
-      uint64_t getOpCounter(int operation)
+      uint64_t getOpCounter(int operation) const
       {
-         return opCounters[operation].read();
+         return opCounters[operation].load(std::memory_order_relaxed);
       }
 
       /**
        * Just return how many counters we have
        */
-      uint64_t getNumCounter()
+      uint64_t getNumCounter() const
       {
          return this->numCounter;
       }
-
-      /**
-       * Add our counters to an existing vector
-       */
-      void addCountersToVec(Uint128Vector *vec)
-      {
-         for(auto iter = opCounters.begin(); iter != opCounters.end(); iter++)
-         {
-            vec->push_back(static_cast<uint128_t>(iter->read()));
-         }
-      }
-};
-
-class MetaOpCounter : public OpCounter
-{
-   public:
-      MetaOpCounter() : OpCounter(MetaOpCounter_OpCounterLastEnum) {}
 };
-
-class StorageOpCounter : public OpCounter
-{
-   public:
-      StorageOpCounter() : OpCounter(StorageOpCounter_OpCounterLastEnum) {}
-};
-
-
@@ -3,6 +3,9 @@
 #include <common/toolkit/MinMaxStore.h>
 #include "TargetCapacityPools.h"
 
+#include <algorithm>
+#include <cmath>
+
 /**
  * @param lowSpace only used for getPoolTypeFromFreeSpace()
  * @param emergencySpace only used for getPoolTypeFromFreeSpace()
@@ -462,6 +465,40 @@ void TargetCapacityPools::chooseStorageTargetsRoundRobin(unsigned numTargets,
       chooseStorageNodesNoPrefRoundRobin(pools[CapacityPool_EMERGENCY], numTargets, outTargets);
 }
 
+/**
+ * Select storage targets randomly, but with a probability proportional to their weight (e.g. to
+ * prefer targets with less load). Capacity pools are used in the same order as by
+ * chooseStorageTargets().
+ *
+ * @param weights relative weights of the targets, targets without a weight get the mean weight of
+ *    the pool
+ */
+void TargetCapacityPools::chooseStorageTargetsWeighted(unsigned numTargets,
+   unsigned minNumRequiredTargets, const TargetWeightMap& weights, UInt16Vector* outTargets)
+{
+   RWLockGuard lock(rwlock, SafeRWLock_READ);
+
+   if (!pools[CapacityPool_NORMAL].empty())
+   {
+      chooseStorageNodesWeighted(pools[CapacityPool_NORMAL], numTargets, weights, outTargets);
+
+      if(outTargets->size() >= minNumRequiredTargets)
+         return;
+   }
+
+   if (!pools[CapacityPool_LOW].empty())
+   {
+      chooseStorageNodesWeighted(pools[CapacityPool_LOW], numTargets - outTargets->size(),
+                                 weights, outTargets);
+
+      if(outTargets->size() >= minNumRequiredTargets)
+         return;
+   }
+
+   chooseStorageNodesWeighted(pools[CapacityPool_EMERGENCY], numTargets - outTargets->size(),
+                              weights, outTargets);
+}
+
 /**
  * Select storage targets that are attached to different nodes (different failure domains).
  *
@@ -530,6 +567,66 @@ void TargetCapacityPools::chooseTargetsIntradomain(unsigned numTargets,
    }
 }
 
+/**
+ * Weighted random sampling without replacement (each target gets the key log(u)/weight for a
+ * uniform random u, the targets with the largest keys are chosen).
+ *
+ * Note: Unlocked (=> caller must hold read lock)
+ *
+ * @param outTargets might cotain less than numTargets if not enough targets are known
+ */
+void TargetCapacityPools::chooseStorageNodesWeighted(const UInt16Set& activeTargets,
+   unsigned numTargets, const TargetWeightMap& weights, UInt16Vector* outTargets)
+{
+   if(activeTargets.empty() || !numTargets)
+      return;
+
+   // targets without (valid) weight get the mean weight of the others
+   double weightSum = 0;
+   unsigned numWeights = 0;
+
+   for(UInt16SetCIter iter = activeTargets.begin(); iter != activeTargets.end(); iter++)
+   {
+      TargetWeightMapCIter weightIter = weights.find(*iter);
+
+      if( (weightIter != weights.end() ) && (weightIter->second > 0) )
+      {
+         weightSum += weightIter->second;
+         numWeights++;
+      }
+   }
+
+   const double defaultWeight = numWeights ? (weightSum / numWeights) : 1;
+   const int randRange = 1 << 30;
+
+   std::vector<std::pair<double, uint16_t> > keys;
+   keys.reserve(activeTargets.size() );
+
+   for(UInt16SetCIter iter = activeTargets.begin(); iter != activeTargets.end(); iter++)
+   {
+      TargetWeightMapCIter weightIter = weights.find(*iter);
+
+      const double weight = ( (weightIter != weights.end() ) && (weightIter->second > 0) )
+         ? weightIter->second
+         : defaultWeight;
+
+      const double u = (randGen.getNextInRange(0, randRange - 1) + 0.5) / randRange;
+
+      keys.push_back(std::make_pair(std::log(u) / weight, *iter) );
+   }
+
+   if(numTargets > keys.size() )
+      numTargets = keys.size();
+
+   std::partial_sort(keys.begin(), keys.begin() + numTargets, keys.end(),
+      std::greater<std::pair<double, uint16_t> >() );
+
+   outTargets->reserve(outTargets->size() + numTargets);
+
+   for(unsigned i = 0; i < numTargets; i++)
+      outTargets->push_back(keys[i].second);
+}
+
 /**
  * Note: Unlocked (=> caller must hold read lock)
  *
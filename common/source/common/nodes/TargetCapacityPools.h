@@ -23,6 +23,9 @@ typedef std::vector<GroupedTargets> GroupedTargetsVector; // CapacityPoolType is
 typedef GroupedTargetsVector::iterator GroupedTargetsVectorIter;
 typedef GroupedTargetsVector::const_iterator GroupedTargetsVectorConstIter;
 
+typedef std::map<uint16_t, double> TargetWeightMap; // keys: targetIDs, values: relative weights
+typedef TargetWeightMap::const_iterator TargetWeightMapCIter;
+
 /**
  * This class provides pools of targetIDs based on their free space.
  * There are two internal types of pools: The general pools with all targets of the corresponding
@@ -52,6 +55,8 @@ class TargetCapacityPools
          UInt16Vector* outTargets);
       void chooseTargetsIntradomain(unsigned numTargets, unsigned minNumRequiredTargets,
          UInt16Vector* outTargets);
+      void chooseStorageTargetsWeighted(unsigned numTargets, unsigned minNumRequiredTargets,
+         const TargetWeightMap& weights, UInt16Vector* outTargets);
 
       bool getPoolAssignment(uint16_t targetID, CapacityPoolType* outPoolType) const;
 
@@ -94,6 +99,8 @@ class TargetCapacityPools
          UInt16Vector& outTargets, NumNodeIDVector& outNodes);
       void chooseTargetsIntradomainNoPref(const GroupedTargets& groupedTargets, unsigned numTargets,
          UInt16Vector& outTargets, UInt16Vector& outGroups);
+      void chooseStorageNodesWeighted(const UInt16Set& activeTargets, unsigned numTargets,
+         const TargetWeightMap& weights, UInt16Vector* outTargets);
       void chooseStorageNodesWithPref(const UInt16Set& activeTargets, unsigned numTargets,
          const UInt16List* preferredTargets, bool allowNonPreferredTargets,
          UInt16Vector* outTargets, std::set<uint16_t>& chosenTargets);
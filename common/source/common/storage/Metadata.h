@@ -24,5 +24,8 @@
 
 #define META_BUDDYMIRROR_SUBDIR_NAME   "buddymir"
 
+#define META_DIRTYDIRS_SUBDIR_NAME     "dirtydirs" /* markers for dir inodes with unstored
+                                                      updates (tuneDirMetadataWriteBehindMS) */
+
 
 
@@ -34,3 +34,21 @@ FhgfsOpsErr StorageTargetInfo::statStoragePath(Node& node, uint16_t targetID, in
 
    return retVal;
 }
+
+/**
+ * @param decision a WritebackController::Decision of the storage server
+ */
+const char* StorageTargetInfo::WritebackStats::decisionToStr(uint8_t decision)
+{
+   switch (decision)
+   {
+      case 1:
+         return "grow";
+      case 2:
+         return "shrink";
+      case 3:
+         return "defer";
+      default:
+         return "none";
+   }
+}
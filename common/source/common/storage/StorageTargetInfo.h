@@ -9,6 +9,38 @@
 class StorageTargetInfo
 {
    public:
+      /**
+       * State of the adaptive writeback (WritebackController) of a storage target.
+       *
+       * Not part of the serialization of StorageTargetInfo, which is also sent to the management.
+       * Messages that carry it serialize it separately, see RequestStorageDataRespMsg.
+       */
+      struct WritebackStats
+      {
+         int64_t syncWindow;
+         int64_t startThreshold;
+         uint64_t numWrites;
+         uint64_t numStalls; // writes that were throttled by the page cache
+         uint64_t numSubmits;
+         uint64_t submittedBytes;
+         uint8_t lastDecision; // WritebackController::Decision
+
+         static const char* decisionToStr(uint8_t decision);
+
+         template<typename This, typename Ctx>
+         static void serialize(This obj, Ctx& ctx)
+         {
+            ctx
+               % obj->syncWindow
+               % obj->startThreshold
+               % obj->numWrites
+               % obj->numStalls
+               % obj->numSubmits
+               % obj->submittedBytes
+               % obj->lastDecision;
+         }
+      };
+
       StorageTargetInfo(uint16_t targetID, const std::string& pathStr, int64_t diskSpaceTotal,
             int64_t diskSpaceFree, int64_t inodesTotal, int64_t inodesFree,
             TargetConsistencyState consistencyState)
@@ -39,6 +71,9 @@ class StorageTargetInfo
       int64_t inodesFree;
       TargetConsistencyState consistencyState;
 
+      bool hasWritebackStats = false; // false if the target has no adaptive writeback
+      WritebackStats writebackStats = {};
+
    public:
       // getter/setter
       uint16_t getTargetID() const
@@ -76,6 +111,22 @@ class StorageTargetInfo
          return consistencyState;
       }
 
+      bool getHasWritebackStats() const
+      {
+         return hasWritebackStats;
+      }
+
+      const WritebackStats& getWritebackStats() const
+      {
+         return writebackStats;
+      }
+
+      void setWritebackStats(bool hasWritebackStats, const WritebackStats& writebackStats)
+      {
+         this->hasWritebackStats = hasWritebackStats;
+         this->writebackStats = writebackStats;
+      }
+
       // operators
       bool operator<(const StorageTargetInfo& other) const
        {
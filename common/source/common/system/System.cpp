@@ -11,6 +11,7 @@
 #include <sys/resource.h>
 #include <sys/sysmacros.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <pwd.h>
 #include <grp.h>
 #include <boost/format.hpp>
@@ -216,6 +217,88 @@ bool System::bindToNumaNode(int nodeNum)
    return true;
 }
 
+/**
+ * Walks up the sysfs device hierarchy from the given block device to the first parent that reports
+ * a NUMA node (typically the PCI device of an NVMe drive or HBA). Stacked devices (device-mapper,
+ * md) have no physical parent, so for them the underlying devices listed in "slaves" are checked.
+ *
+ * @param depth recursion depth for stacked devices, to stop on unexpected sysfs loops
+ */
+static int getNumaNodeBySysfsBlockDev(const std::string& sysfsDevPath, unsigned depth)
+{
+   const std::string sysfsDevicesRoot = "/sys/devices";
+
+   char* resolvedPath = realpath(sysfsDevPath.c_str(), NULL);
+   if(!resolvedPath)
+      return -1;
+
+   const std::string devPath(resolvedPath);
+   free(resolvedPath);
+
+   for(std::string currentPath = devPath;
+       currentPath.size() > sysfsDevicesRoot.size();
+       currentPath.erase(currentPath.rfind('/') ) )
+   {
+      std::ifstream numaNodeFile(currentPath + "/numa_node");
+      int numaNode;
+
+      if(numaNodeFile >> numaNode && numaNode >= 0)
+         return numaNode;
+   }
+
+   if(depth >= 4)
+      return -1;
+
+   // the slaves of a partition are listed at the whole disk, so check the parent dir as well
+   const std::string slavesPaths[] = {
+      devPath + "/slaves", devPath.substr(0, devPath.rfind('/') ) + "/slaves" };
+
+   for(const std::string& slavesPath : slavesPaths)
+   {
+      if(!StorageTk::pathExists(slavesPath) )
+         continue;
+
+      StringList slaves;
+
+      try
+      {
+         StorageTk::readCompleteDir(slavesPath.c_str(), &slaves);
+      }
+      catch(const InvalidConfigException&)
+      {
+         continue;
+      }
+
+      for(StringListIter iter = slaves.begin(); iter != slaves.end(); iter++)
+      {
+         int numaNode = getNumaNodeBySysfsBlockDev("/sys/class/block/" + *iter, depth + 1);
+         if(numaNode >= 0)
+            return numaNode;
+      }
+   }
+
+   return -1;
+}
+
+/**
+ * Returns the NUMA node to which the block device holding the given path is attached, as reported
+ * by sysfs.
+ *
+ * @return zero-based NUMA node or -1 if it cannot be determined (e.g. the path is not backed by a
+ * physical block device or the system has no NUMA information).
+ */
+int System::getNumaNodeByPath(const std::string& path)
+{
+   struct stat statBuf;
+
+   if(stat(path.c_str(), &statBuf) != 0)
+      return -1;
+
+   return getNumaNodeBySysfsBlockDev("/sys/dev/block/" +
+      StringTk::uintToStr(major(statBuf.st_dev) ) + ":" +
+      StringTk::uintToStr(minor(statBuf.st_dev) ), 0);
+}
+
 /**
  * @return linux thread ID (this is not the POSIX thread ID!)
  */
@@ -21,6 +21,7 @@ class System
       static int getNumNumaNodes();
       static int getNumaCoresByNode(int nodeNum, cpu_set_t* outCpuSet);
       static bool bindToNumaNode(int nodeNum);
+      static int getNumaNodeByPath(const std::string& path);
       static pid_t getTID();
       static bool incProcessFDLimit(uint64_t newLimit, uint64_t* outOldLimit);
       static void getMemoryInfo(uint64_t *memTotal, uint64_t *memFree, uint64_t *memCached,
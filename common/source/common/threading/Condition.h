@@ -60,8 +60,15 @@ class Condition
          struct timespec timeoutTimeSpec;
          timeout.getTimeSpec(&timeoutTimeSpec);
 
+         LockProfiler::Site* profilingSite = getProfilingSite(lockedMutex);
+         const uint64_t waitStart = profilingSite ? LockProfiler::now() : 0;
+
          int pthreadRes = pthread_cond_timedwait(&condition, lockedMutex->getMutex(),
             &timeoutTimeSpec);
+
+         if (profilingSite)
+            LockProfiler::recordCondWait(profilingSite, LockProfiler::now() - waitStart);
+
          if(!pthreadRes)
             return true;
          if(pthreadRes == ETIMEDOUT)
@@ -82,7 +89,25 @@ class Condition
 
       void wait(Mutex* lockedMutex)
       {
+         LockProfiler::Site* profilingSite = getProfilingSite(lockedMutex);
+         const uint64_t waitStart = profilingSite ? LockProfiler::now() : 0;
+
          pthread_cond_wait(&condition, lockedMutex->getMutex() );
+
+         if (profilingSite)
+            LockProfiler::recordCondWait(profilingSite, LockProfiler::now() - waitStart);
+      }
+
+   private:
+      /**
+       * @return the profiling site of the mutex if lock profiling is enabled, nullptr otherwise.
+       * waits are accounted to the mutex, so that lock and condition stats are seen together.
+       */
+      static LockProfiler::Site* getProfilingSite(Mutex* lockedMutex)
+      {
+         LockProfiler::Site* site = lockedMutex->getProfilingSite();
+
+         return unlikely(site) && LockProfiler::isEnabled() ? site : nullptr;
       }
 
 };
@@ -0,0 +1,191 @@
+#include "LockProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+std::atomic<bool> LockProfiler::enabled(false);
+std::atomic<LockProfiler::Site*> LockProfiler::sites(nullptr);
+
+namespace {
+
+// not a Mutex, that would be profiled itself
+std::mutex registerMutex;
+
+/**
+ * @return upper bound of the bucket (in us) that contains the given percentile of all samples.
+ */
+uint64_t histogramPercentileUS(const uint64_t (&histogram)[LockProfiler::WAIT_HISTOGRAM_SIZE],
+   uint64_t numSamples, unsigned percentile)
+{
+   const uint64_t threshold = (numSamples * percentile + 99) / 100;
+   uint64_t sum = 0;
+
+   for (unsigned i = 0; i < LockProfiler::WAIT_HISTOGRAM_SIZE; i++)
+   {
+      sum += histogram[i];
+      if (sum >= threshold)
+         return uint64_t(1) << i;
+   }
+
+   return uint64_t(1) << LockProfiler::WAIT_HISTOGRAM_SIZE;
+}
+
+}
+
+/**
+ * @param name must stay valid forever, usually a string literal like "ClassName::lockName".
+ * @return the site of the given name, created if it did not exist yet.
+ */
+LockProfiler::Site* LockProfiler::getSite(const char* name)
+{
+   const std::lock_guard<std::mutex> lock(registerMutex);
+
+   for (Site* site = sites.load(); site; site = site->next)
+      if (!strcmp(site->name, name) )
+         return site;
+
+   Site* site = new Site(name);
+
+   site->next = sites.load();
+   sites.store(site);
+
+   return site;
+}
+
+void LockProfiler::setEnabled(bool enabled)
+{
+   LockProfiler::enabled.store(enabled);
+}
+
+/**
+ * Zero the statistics of all sites. Acquisitions that happen concurrently may be partially lost.
+ */
+void LockProfiler::reset()
+{
+   for (Site* site = sites.load(); site; site = site->next)
+   {
+      site->numAcquired = 0;
+      site->numContended = 0;
+      site->waitNSTotal = 0;
+      site->waitNSMax = 0;
+
+      for (unsigned i = 0; i < WAIT_HISTOGRAM_SIZE; i++)
+         site->waitHistogram[i] = 0;
+
+      site->numCondWaits = 0;
+      site->condWaitNSTotal = 0;
+   }
+}
+
+void LockProfiler::recordAcquisition(Site* site, bool contended, uint64_t waitNS)
+{
+   site->numAcquired.fetch_add(1, std::memory_order_relaxed);
+
+   if (!contended)
+      return;
+
+   site->numContended.fetch_add(1, std::memory_order_relaxed);
+   site->waitNSTotal.fetch_add(waitNS, std::memory_order_relaxed);
+
+   uint64_t oldMax = site->waitNSMax.load(std::memory_order_relaxed);
+   while (waitNS > oldMax &&
+         !site->waitNSMax.compare_exchange_weak(oldMax, waitNS, std::memory_order_relaxed) )
+   { }
+
+   const uint64_t waitUS = waitNS / 1000;
+   const unsigned bucket = waitUS ? 64 - __builtin_clzll(waitUS) : 0; // first 2^i > waitUS
+
+   site->waitHistogram[std::min<unsigned>(bucket, WAIT_HISTOGRAM_SIZE - 1)].fetch_add(1,
+      std::memory_order_relaxed);
+}
+
+void LockProfiler::recordCondWait(Site* site, uint64_t waitNS)
+{
+   site->numCondWaits.fetch_add(1, std::memory_order_relaxed);
+   site->condWaitNSTotal.fetch_add(waitNS, std::memory_order_relaxed);
+}
+
+/**
+ * @param maxSites only the sites with the longest total wait times are reported; 0 for all.
+ */
+std::string LockProfiler::getReport(size_t maxSites)
+{
+   struct SiteStats
+   {
+      const char* name;
+      uint64_t numAcquired;
+      uint64_t numContended;
+      uint64_t waitNSTotal;
+      uint64_t waitNSMax;
+      uint64_t waitHistogram[WAIT_HISTOGRAM_SIZE];
+      uint64_t numCondWaits;
+      uint64_t condWaitNSTotal;
+   };
+
+   std::vector<SiteStats> stats;
+
+   for (Site* site = sites.load(); site; site = site->next)
+   {
+      SiteStats siteStats;
+
+      siteStats.name = site->name;
+      siteStats.numAcquired = site->numAcquired;
+      siteStats.numContended = site->numContended;
+      siteStats.waitNSTotal = site->waitNSTotal;
+      siteStats.waitNSMax = site->waitNSMax;
+
+      for (unsigned i = 0; i < WAIT_HISTOGRAM_SIZE; i++)
+         siteStats.waitHistogram[i] = site->waitHistogram[i];
+
+      siteStats.numCondWaits = site->numCondWaits;
+      siteStats.condWaitNSTotal = site->condWaitNSTotal;
+
+      stats.push_back(siteStats);
+   }
+
+   std::sort(stats.begin(), stats.end(),
+      [] (const SiteStats& a, const SiteStats& b) { return a.waitNSTotal > b.waitNSTotal; });
+
+   if (maxSites && stats.size() > maxSites)
+      stats.resize(maxSites);
+
+   std::ostringstream report;
+
+   report << "Lock profiling: " << (isEnabled() ? "enabled" : "disabled") << std::endl;
+   report << std::left << std::setw(40) << "lock" << std::right
+      << std::setw(14) << "acquired"
+      << std::setw(14) << "contended"
+      << std::setw(8) << "cont%"
+      << std::setw(12) << "wait(ms)"
+      << std::setw(10) << "avg(us)"
+      << std::setw(10) << "p50(us)"
+      << std::setw(10) << "p99(us)"
+      << std::setw(10) << "max(us)"
+      << std::setw(14) << "condwaits"
+      << std::setw(14) << "condwait(ms)" << std::endl;
+
+   for (auto it = stats.begin(); it != stats.end(); ++it)
+   {
+      const uint64_t contended = it->numContended;
+      const uint64_t p50 = contended ? histogramPercentileUS(it->waitHistogram, contended, 50) : 0;
+      const uint64_t p99 = contended ? histogramPercentileUS(it->waitHistogram, contended, 99) : 0;
+
+      report << std::left << std::setw(40) << it->name << std::right
+         << std::setw(14) << it->numAcquired
+         << std::setw(14) << contended
+         << std::setw(8) << (it->numAcquired ? contended * 100 / it->numAcquired : 0)
+         << std::setw(12) << it->waitNSTotal / 1000000
+         << std::setw(10) << (contended ? it->waitNSTotal / contended / 1000 : 0)
+         << std::setw(10) << p50
+         << std::setw(10) << p99
+         << std::setw(10) << it->waitNSMax / 1000
+         << std::setw(14) << it->numCondWaits
+         << std::setw(14) << it->condWaitNSTotal / 1000000 << std::endl;
+   }
+
+   return report.str();
+}
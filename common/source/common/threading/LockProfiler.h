@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <time.h>
+
+#include <stdint.h>
+
+/**
+ * Contention statistics for named locks.
+ *
+ * A Mutex or RWLock that is constructed with a name records its acquisitions in the site of that
+ * name; all locks with the same name share one site, e.g. the rwlocks of all instances of a class.
+ * Unnamed locks are never profiled.
+ *
+ * Profiling is disabled by default and switched on at runtime (see GenericDebugMsg "lockstats").
+ * When it is disabled, a named lock costs one additional predictable branch per acquisition.
+ * When it is enabled, every acquisition first tries to get the lock without blocking. Only if that
+ * fails, the acquisition is counted as contended and the time until the lock is granted is
+ * measured.
+ */
+class LockProfiler
+{
+   public:
+      enum { WAIT_HISTOGRAM_SIZE = 16 }; // bucket i: wait time < 2^i us, last bucket: the rest
+
+      class Site
+      {
+         friend class LockProfiler;
+
+         public:
+            const char* getName() const { return name; }
+
+         private:
+            Site(const char* name) : name(name), next(nullptr) {}
+
+            const char* const name;
+            Site* next; // registry list, sites are never freed
+
+            std::atomic<uint64_t> numAcquired{0};
+            std::atomic<uint64_t> numContended{0};
+            std::atomic<uint64_t> waitNSTotal{0};
+            std::atomic<uint64_t> waitNSMax{0};
+            std::atomic<uint64_t> waitHistogram[WAIT_HISTOGRAM_SIZE] = {};
+
+            std::atomic<uint64_t> numCondWaits{0};
+            std::atomic<uint64_t> condWaitNSTotal{0};
+      };
+
+      static Site* getSite(const char* name);
+
+      static void setEnabled(bool enabled);
+      static void reset();
+      static std::string getReport(size_t maxSites);
+
+      static void recordAcquisition(Site* site, bool contended, uint64_t waitNS);
+      static void recordCondWait(Site* site, uint64_t waitNS);
+
+   private:
+      LockProfiler() {}
+
+      static std::atomic<bool> enabled;
+      static std::atomic<Site*> sites;
+
+   public:
+      // inliners
+
+      static bool isEnabled()
+      {
+         return enabled.load(std::memory_order_relaxed);
+      }
+
+      static uint64_t now()
+      {
+         struct timespec ts;
+
+         clock_gettime(CLOCK_MONOTONIC, &ts);
+         return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+      }
+};
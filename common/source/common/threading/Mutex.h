@@ -1,5 +1,6 @@
 #pragma once
 
+#include "LockProfiler.h"
 #include "MutexException.h"
 #include <common/system/System.h>
 #include <common/Common.h>
@@ -9,7 +10,16 @@ class System;
 class Mutex
 {
    public:
-      Mutex()
+      Mutex() : profilingSite(nullptr)
+      {
+         pthread_mutex_init(&mutex, NULL);
+      }
+
+      /**
+       * @param profilingName name for the LockProfiler, must stay valid forever
+       */
+      explicit Mutex(const char* profilingName) :
+         profilingSite(LockProfiler::getSite(profilingName) )
       {
          pthread_mutex_init(&mutex, NULL);
       }
@@ -32,6 +42,12 @@ class Mutex
        */
       void lock()
       {
+         if (unlikely(profilingSite) && LockProfiler::isEnabled() )
+         {
+            lockProfiled();
+            return;
+         }
+
          int pthreadRes = pthread_mutex_lock(&mutex);
 
          if(unlikely(pthreadRes) )
@@ -57,9 +73,29 @@ class Mutex
 
    private:
       pthread_mutex_t mutex;
+      LockProfiler::Site* profilingSite;
+
+      void lockProfiled()
+      {
+         if (tryLock() )
+         {
+            LockProfiler::recordAcquisition(profilingSite, false, 0);
+            return;
+         }
+
+         const uint64_t waitStart = LockProfiler::now();
+
+         int pthreadRes = pthread_mutex_lock(&mutex);
+
+         if(unlikely(pthreadRes) )
+            throw MutexException(System::getErrString(pthreadRes));
+
+         LockProfiler::recordAcquisition(profilingSite, true, LockProfiler::now() - waitStart);
+      }
 
    public:
       // getters & setters
       pthread_mutex_t* getMutex() {return &mutex;}
+      LockProfiler::Site* getProfilingSite() const {return profilingSite;}
 };
 
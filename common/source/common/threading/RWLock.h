@@ -2,6 +2,7 @@
 
 #include <common/system/System.h>
 #include <common/threading/Atomics.h>
+#include <common/threading/LockProfiler.h>
 #include <common/app/log/LogContext.h>
 #include <common/Common.h>
 #include "RWLockException.h"
@@ -34,7 +35,7 @@ enum RWLockLockType
 class RWLock
 {
    public:
-      RWLock()
+      RWLock() : profilingSite(nullptr)
       {
          /* note: most impls of libc on Linux seem to prefer readers by default, which can lead
             to writer starvation. hence we need to set writer preference explicitly (but
@@ -62,6 +63,14 @@ class RWLock
          lockType = RWLockType_UNSET;
       }
 
+      /**
+       * @param profilingName name for the LockProfiler, must stay valid forever
+       */
+      explicit RWLock(const char* profilingName) : RWLock()
+      {
+         profilingSite = LockProfiler::getSite(profilingName);
+      }
+
       ~RWLock()
       {
          // may return
@@ -83,6 +92,20 @@ class RWLock
          const char* logContext = "RWLock::writeLock";
          int pthreadRes;
 
+         LockProfiler::Site* activeProfilingSite = getActiveProfilingSite();
+         uint64_t waitStart = 0;
+
+         if (activeProfilingSite)
+         {
+            if (tryWriteLock() )
+            {
+               LockProfiler::recordAcquisition(activeProfilingSite, false, 0);
+               return;
+            }
+
+            waitStart = LockProfiler::now();
+         }
+
          if(numQueuedReaders.read() )
          {
             if(numSkippedReaders.read() > RWLOCK_READERS_SKIP_LIMIT)
@@ -116,6 +139,10 @@ class RWLock
          }
 
          lockType = RWLockType_WRITE;
+
+         if (activeProfilingSite)
+            LockProfiler::recordAcquisition(activeProfilingSite, true,
+               LockProfiler::now() - waitStart);
       }
 
       /**
@@ -125,8 +152,12 @@ class RWLock
       {
          const char* logContext = "RWLock::readLock";
 
+         LockProfiler::Site* activeProfilingSite = getActiveProfilingSite();
+
          if(!tryReadLock() )
          {
+            const uint64_t waitStart = activeProfilingSite ? LockProfiler::now() : 0;
+
             // inform writers about waiting readers, so they can avoid starvation
             numQueuedReaders.increase();
 
@@ -143,7 +174,14 @@ class RWLock
             numSkippedReaders.setZero();
 
             lockType = RWLockType_READ;
+
+            if (activeProfilingSite)
+               LockProfiler::recordAcquisition(activeProfilingSite, true,
+                  LockProfiler::now() - waitStart);
          }
+         else
+         if (activeProfilingSite)
+            LockProfiler::recordAcquisition(activeProfilingSite, false, 0);
       }
 
       /**
@@ -220,6 +258,16 @@ class RWLock
 
       RWLockLockType lockType;
 
+      LockProfiler::Site* profilingSite;
+
+      /**
+       * @return the profiling site if this lock is named and profiling is enabled.
+       */
+      LockProfiler::Site* getActiveProfilingSite() const
+      {
+         return unlikely(profilingSite) && LockProfiler::isEnabled() ? profilingSite : nullptr;
+      }
+
    public:
       // getters & setters
       pthread_rwlock_t* getRWLock()
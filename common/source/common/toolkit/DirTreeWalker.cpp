@@ -0,0 +1,313 @@
+#include <common/app/log/Logger.h>
+#include <common/threading/PThread.h>
+#include <common/toolkit/FDHandle.h>
+#include <common/toolkit/StringTk.h>
+#include "DirTreeWalker.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define DIRTREEWALKER_DIRENTS_BUF_SIZE   (256*1024) // per thread; few syscalls for large dirs
+#define DIRTREEWALKER_IDLE_WAIT_MS       100
+
+
+namespace {
+
+/**
+ * Layout of the records returned by getdents64(), which glibc does not define for all versions
+ * that we support.
+ */
+struct LinuxDirent64
+{
+   uint64_t d_ino;
+   int64_t d_off;
+   unsigned short d_reclen;
+   unsigned char d_type;
+   char d_name[];
+};
+
+}
+
+
+class DirTreeWalker::WalkerThread : public PThread
+{
+   public:
+      WalkerThread(DirTreeWalker* walker, unsigned threadIndex) :
+         PThread(PThread::getCurrentThreadName() + "-Walk" + StringTk::uintToStr(threadIndex) ),
+         walker(walker), threadIndex(threadIndex)
+      {
+      }
+
+   private:
+      DirTreeWalker* walker;
+      unsigned threadIndex;
+
+      void run() override
+      {
+         try
+         {
+            walker->workLoop(threadIndex);
+         }
+         catch (const std::exception& e)
+         {
+            LOG(GENERAL, ERR, "Directory walk failed.", ("error", e.what()));
+            walker->abort();
+         }
+      }
+};
+
+
+/**
+ * @param numThreads number of threads (including the calling thread) that walk the tree
+ * @param statEntries true to stat every entry; false if the handler only needs to know whether an
+ * entry is a directory
+ */
+DirTreeWalker::DirTreeWalker(unsigned numThreads, bool statEntries) :
+   numThreads(std::max(numThreads, 1u) ), statEntries(statEntries), rootFD(-1)
+{
+}
+
+/**
+ * Walk the tree below rootPath (the root itself is not passed to the entry handler). The calling
+ * thread takes part in the walk, i.e. no extra thread is started for numThreads==1.
+ *
+ * @param errorHandler if not set, every error aborts the walk
+ * @return true if the whole tree was walked, false if the walk was aborted by a handler or an error
+ */
+bool DirTreeWalker::walk(const std::string& rootPath, EntryHandler entryHandler,
+   ErrorHandler errorHandler)
+{
+   this->entryHandler = std::move(entryHandler);
+   this->errorHandler = std::move(errorHandler);
+
+   isAborted.setZero();
+   numPendingDirs.setZero();
+   numIdleThreads.setZero();
+
+   FDHandle rootFDHandle(::open(rootPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) );
+   if (!rootFDHandle.valid() )
+   {
+      handleError("", errno);
+      return false;
+   }
+
+   rootFD = rootFDHandle.get();
+
+   queues.clear();
+   for (unsigned i = 0; i < numThreads; i++)
+      queues.emplace_back(new DirQueue() );
+
+   addDir(0, DirItem{"", 0});
+
+   std::vector<std::unique_ptr<WalkerThread>> threads;
+
+   auto joinThreads = [&threads] () {
+      for (auto& thread : threads)
+         thread->join();
+   };
+
+   try
+   {
+      for (unsigned i = 1; i < numThreads; i++)
+      {
+         std::unique_ptr<WalkerThread> thread(new WalkerThread(this, i) );
+
+         thread->start();
+         threads.push_back(std::move(thread) );
+      }
+
+      workLoop(0);
+   }
+   catch (...)
+   {
+      abort();
+      joinThreads();
+      throw;
+   }
+
+   joinThreads();
+
+   rootFD = -1;
+
+   return !getIsAborted();
+}
+
+void DirTreeWalker::workLoop(unsigned threadIndex)
+{
+   std::vector<char> buf(DIRTREEWALKER_DIRENTS_BUF_SIZE);
+
+   while (!getIsAborted() )
+   {
+      DirItem item;
+
+      if (getNextDir(threadIndex, item) )
+      {
+         readDir(threadIndex, item, buf);
+         finishDir();
+         continue;
+      }
+
+      // nothing to do for now => wait for other threads to add dirs or to finish the last ones
+
+      const std::lock_guard<Mutex> lock(idleMutex);
+
+      if (!numPendingDirs.read() || getIsAborted() )
+         break;
+
+      numIdleThreads.increase();
+      dirAddedCond.timedwait(&idleMutex, DIRTREEWALKER_IDLE_WAIT_MS);
+      numIdleThreads.decrease();
+   }
+}
+
+/**
+ * Take the most recently added dir from the own queue or steal the oldest dir of another thread.
+ */
+bool DirTreeWalker::getNextDir(unsigned threadIndex, DirItem& outItem)
+{
+   {
+      DirQueue& ownQueue = *queues[threadIndex];
+      const std::lock_guard<Mutex> lock(ownQueue.mutex);
+
+      if (!ownQueue.dirs.empty() )
+      {
+         outItem = std::move(ownQueue.dirs.back() );
+         ownQueue.dirs.pop_back();
+         return true;
+      }
+   }
+
+   for (unsigned i = 1; i < numThreads; i++)
+   {
+      DirQueue& victimQueue = *queues[(threadIndex + i) % numThreads];
+      const std::lock_guard<Mutex> lock(victimQueue.mutex);
+
+      if (!victimQueue.dirs.empty() )
+      {
+         outItem = std::move(victimQueue.dirs.front() );
+         victimQueue.dirs.pop_front();
+         return true;
+      }
+   }
+
+   return false;
+}
+
+void DirTreeWalker::readDir(unsigned threadIndex, const DirItem& item, std::vector<char>& buf)
+{
+   FDHandle dirFD(::openat(rootFD, item.path.empty() ? "." : item.path.c_str(),
+      O_RDONLY | O_DIRECTORY | O_CLOEXEC) );
+   if (!dirFD.valid() )
+   {
+      handleError(item.path, errno);
+      return;
+   }
+
+   while (!getIsAborted() )
+   {
+      const long readRes = ::syscall(SYS_getdents64, dirFD.get(), buf.data(), buf.size() );
+      if (readRes < 0)
+      {
+         handleError(item.path, errno);
+         return;
+      }
+
+      if (!readRes)
+         return; // end of dir
+
+      for (long pos = 0; pos < readRes && !getIsAborted(); )
+      {
+         const LinuxDirent64* dirent = (const LinuxDirent64*) &buf[pos];
+         pos += dirent->d_reclen;
+
+         if (!strcmp(dirent->d_name, ".") || !strcmp(dirent->d_name, "..") )
+            continue;
+
+         struct stat statBuf;
+         bool isDir = dirent->d_type == DT_DIR;
+
+         if (statEntries || dirent->d_type == DT_UNKNOWN)
+         {
+            if (::fstatat(dirFD.get(), dirent->d_name, &statBuf, 0) )
+            {
+               const int errCode = errno;
+               const std::string path = item.path.empty()
+                  ? std::string(dirent->d_name)
+                  : item.path + "/" + dirent->d_name;
+
+               if (!handleError(path, errCode) )
+                  return;
+
+               continue;
+            }
+
+            isDir = S_ISDIR(statBuf.st_mode);
+         }
+
+         const Entry entry = { item.path, dirent->d_name, item.depth, dirFD.get(), isDir,
+            statEntries ? &statBuf : NULL };
+
+         const Action action = entryHandler(entry);
+
+         if (action == Action_ABORT)
+         {
+            abort();
+            return;
+         }
+
+         if (isDir && action == Action_CONTINUE)
+            addDir(threadIndex, DirItem{entry.getPath(), item.depth + 1});
+      }
+   }
+}
+
+void DirTreeWalker::addDir(unsigned threadIndex, DirItem item)
+{
+   // (counted before it becomes visible, so that the walk can't be considered finished meanwhile)
+   numPendingDirs.increase();
+
+   {
+      DirQueue& ownQueue = *queues[threadIndex];
+      const std::lock_guard<Mutex> lock(ownQueue.mutex);
+
+      ownQueue.dirs.push_back(std::move(item) );
+   }
+
+   if (numIdleThreads.read() )
+   {
+      const std::lock_guard<Mutex> lock(idleMutex);
+      dirAddedCond.signal();
+   }
+}
+
+/**
+ * @return true if the walk shall continue
+ */
+bool DirTreeWalker::handleError(const std::string& path, int errCode)
+{
+   if (errorHandler && errorHandler(path, errCode) )
+      return true;
+
+   abort();
+   return false;
+}
+
+void DirTreeWalker::abort()
+{
+   isAborted.set(1);
+
+   const std::lock_guard<Mutex> lock(idleMutex);
+   dirAddedCond.broadcast();
+}
+
+void DirTreeWalker::finishDir()
+{
+   if (numPendingDirs.decrease() == 1)
+   { // that was the last one => wake up the idle threads to let them exit
+      const std::lock_guard<Mutex> lock(idleMutex);
+      dirAddedCond.broadcast();
+   }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <common/Common.h>
+#include <common/threading/Atomics.h>
+#include <common/threading/Condition.h>
+#include <common/threading/Mutex.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include <sys/stat.h>
+
+
+/**
+ * Walks a directory tree with a number of threads, e.g. for full scans of storage targets and
+ * metadata directories.
+ *
+ * Every thread has its own queue of directories that are still to be read. A thread reads the
+ * directories in its own queue depth-first and adds the subdirectories it finds to it; idle threads
+ * steal directories from the other end of the queues of the other threads, i.e. the largest
+ * remaining subtrees.
+ *
+ * Directories are read with large getdents64() buffers, and entries are stat'ed relative to the
+ * directory fd. If the caller only needs to know whether an entry is a directory, the stat call is
+ * skipped for file systems that fill in the dirent type.
+ *
+ * Note: The handlers are called concurrently from all threads of the walk.
+ */
+class DirTreeWalker
+{
+   public:
+      enum Action
+      {
+         Action_CONTINUE, // descend into the entry if it is a directory
+         Action_SKIP, // don't descend into the entry (same as CONTINUE for non-directories)
+         Action_ABORT, // stop the whole walk
+      };
+
+      struct Entry
+      {
+         const std::string& dirPath; // containing dir relative to the walk root ("" for the root)
+         const char* name;
+         unsigned depth; // depth of the containing dir, i.e. 0 for entries in the root dir
+         int dirFD; // fd of the containing dir, e.g. for further *at() calls
+         bool isDir;
+         const struct stat* statBuf; // NULL if the walker was told not to stat entries
+
+         std::string getPath() const
+         {
+            return dirPath.empty() ? std::string(name) : dirPath + "/" + name;
+         }
+      };
+
+      /**
+       * @return Action_... value
+       */
+      typedef std::function<Action (const Entry& entry)> EntryHandler;
+
+      /**
+       * @param path path relative to the walk root that could not be opened/read/stat'ed
+       * @param errCode errno of the failed operation
+       * @return true to continue the walk, false to abort it
+       */
+      typedef std::function<bool (const std::string& path, int errCode)> ErrorHandler;
+
+      DirTreeWalker(unsigned numThreads, bool statEntries);
+
+      bool walk(const std::string& rootPath, EntryHandler entryHandler,
+         ErrorHandler errorHandler = ErrorHandler() );
+
+   private:
+      class WalkerThread; // helper thread for the second and following threads of a walk
+
+      struct DirItem
+      {
+         std::string path; // relative to the walk root
+         unsigned depth;
+      };
+
+      struct DirQueue
+      {
+         Mutex mutex;
+         std::deque<DirItem> dirs;
+      };
+
+      unsigned numThreads;
+      bool statEntries;
+
+      int rootFD;
+      EntryHandler entryHandler;
+      ErrorHandler errorHandler;
+
+      std::vector<std::unique_ptr<DirQueue>> queues; // one per thread
+      AtomicSizeT numPendingDirs; // queued or currently being read
+      AtomicSizeT isAborted; // atomic quasi-bool
+
+      Mutex idleMutex;
+      Condition dirAddedCond; // signaled when a dir is added or the last pending dir is finished
+      AtomicSizeT numIdleThreads;
+
+      void workLoop(unsigned threadIndex);
+      bool getNextDir(unsigned threadIndex, DirItem& outItem);
+      void readDir(unsigned threadIndex, const DirItem& item, std::vector<char>& buf);
+      void addDir(unsigned threadIndex, DirItem item);
+      bool handleError(const std::string& path, int errCode);
+      void abort();
+      void finishDir();
+
+   public:
+      // inliners
+
+      bool getIsAborted() const
+      {
+         return isAborted.read() != 0;
+      }
+};
+
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <utility>
 #include <errno.h>
 #include <unistd.h>
 
@@ -31,6 +32,14 @@ class FDHandle
          m_fd = fd;
       }
 
+      /**
+       * Give up ownership of the fd without closing it.
+       */
+      int release()
+      {
+         return std::exchange(m_fd, -1);
+      }
+
       bool valid() const
       {
          return m_fd >= 0;
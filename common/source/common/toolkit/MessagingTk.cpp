@@ -307,7 +307,7 @@ FhgfsOpsErr MessagingTk::requestResponseTarget(RequestResponseTarget* rrTarget,
       return commRes;
 }
 
-std::vector<char> MessagingTk::recvMsgBuf(Socket& socket, int minTimeout)
+std::vector<char> MessagingTk::recvMsgBuf(Socket& socket, int minTimeout, int maxTimeout)
 try
 {
    AbstractApp* app = PThread::getCurrentThreadApp();
@@ -315,10 +315,13 @@ try
 
    DEBUG_ENV_VAR(unsigned, RECEIVE_TIMEOUT, connMsgLongTimeout, "BEEGFS_MESSAGING_RECV_TIMEOUT_MS");
 
-   const int recvTimeoutMS = minTimeout < 0
+   int recvTimeoutMS = minTimeout < 0
       ? -1
       : std::max<int>(minTimeout, RECEIVE_TIMEOUT);
 
+   if (maxTimeout > 0 && (recvTimeoutMS < 0 || recvTimeoutMS > maxTimeout) )
+      recvTimeoutMS = maxTimeout;
+
    std::vector<char> result(MSGBUF_DEFAULT_SIZE);
 
    // receive at least the message header
@@ -390,7 +393,8 @@ FhgfsOpsErr MessagingTk::requestResponseComm(RequestResponseArgs* rrArgs)
       }
 
       // receive response
-      auto respBuf = MessagingTk::recvMsgBuf(*sock, rrArgs->minTimeoutMS);
+      auto respBuf = MessagingTk::recvMsgBuf(*sock, rrArgs->minTimeoutMS,
+         rrArgs->maxTimeoutMS);
       if (respBuf.empty())
       { // error (e.g. message too big)
          LogContext(logContext).log(Log_WARNING,
@@ -27,7 +27,8 @@ class MessagingTk
       static FhgfsOpsErr requestResponseTarget(RequestResponseTarget* rrTarget,
          RequestResponseArgs* rrArgs);
 
-      static std::vector<char> recvMsgBuf(Socket& socket, int minTimeout = 0);
+      static std::vector<char> recvMsgBuf(Socket& socket, int minTimeout = 0,
+         int maxTimeout = 0);
       static std::vector<char> createMsgVec(NetMessage& msg);
 
    private:
@@ -138,7 +138,7 @@ struct RequestResponseArgs
    RequestResponseArgs(const Node* node, NetMessage* requestMsg, unsigned respMsgType,
          FhgfsOpsErr (*sendExtraData)(Socket*, void*) = NULL, void* extraDataContext = NULL)
       : node(node), requestMsg(requestMsg), respMsgType(respMsgType),
-        logFlags(0), minTimeoutMS(0), sendExtraData(sendExtraData),
+        logFlags(0), minTimeoutMS(0), maxTimeoutMS(0), sendExtraData(sendExtraData),
         extraDataContext(extraDataContext)
    {
       // see initializer list
@@ -155,6 +155,7 @@ struct RequestResponseArgs
    unsigned char logFlags; // REQUESTRESPONSEARGS_LOGFLAG_... combination to avoid double-logging
 
    int minTimeoutMS; // minimum communication timeout. negative values disable timeouts.
+   int maxTimeoutMS; // maximum communication timeout (e.g. for optional requests). 0 for none.
 
    // hook to send extra data after the message
    FhgfsOpsErr (*sendExtraData)(Socket*, void*);
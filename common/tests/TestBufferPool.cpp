@@ -0,0 +1,97 @@
+#include <common/components/worker/BufferPool.h>
+
+#include <gtest/gtest.h>
+
+TEST(BufferPool, sizeClasses)
+{
+   BufferPool pool(4096, 1024*1024, false);
+
+   BufferPool::Lease small = pool.acquire(1);
+   ASSERT_NE(small.data(), nullptr);
+   ASSERT_EQ(small.size(), 4096u);
+
+   BufferPool::Lease medium = pool.acquire(5000);
+   ASSERT_EQ(medium.size(), 8192u);
+
+   BufferPool::Lease exact = pool.acquire(64*1024);
+   ASSERT_EQ(exact.size(), 64u*1024);
+
+   // requests beyond the largest class are capped
+   BufferPool::Lease large = pool.acquire(16*1024*1024);
+   ASSERT_EQ(large.size(), 1024u*1024);
+
+   // memory must be usable
+   memset(large.data(), 0xab, large.size() );
+}
+
+TEST(BufferPool, nonPowerOfTwoMax)
+{
+   BufferPool pool(4096, 12345, false);
+
+   ASSERT_EQ(pool.acquire(10000).size(), 12345u);
+   ASSERT_EQ(pool.acquire(8000).size(), 8192u);
+}
+
+TEST(BufferPool, reuseAndStats)
+{
+   BufferPool pool(4096, 64*1024, false);
+   char* first;
+
+   {
+      BufferPool::Lease a = pool.acquire(4096);
+      BufferPool::Lease b = pool.acquire(4096);
+
+      first = a.data();
+      ASSERT_NE(a.data(), b.data() );
+   }
+
+   // both buffers went back to the free list, the next borrow must not allocate. the free list
+   // is LIFO, so the buffer that was returned last is handed out first.
+   BufferPool::Lease c = pool.acquire(100);
+   ASSERT_EQ(c.data(), first);
+
+   std::vector<BufferPool::SizeClassStats> stats;
+   pool.getStats(&stats);
+
+   ASSERT_EQ(stats.size(), 5u); // 4k, 8k, 16k, 32k, 64k
+   ASSERT_EQ(stats[0].bufSize, 4096u);
+   ASSERT_EQ(stats[0].numAllocated, 2u);
+   ASSERT_EQ(stats[0].allocSize, 2u * 4096);
+   ASSERT_EQ(stats[0].numInUse, 1u);
+   ASSERT_EQ(stats[0].highWaterInUse, 2u);
+   ASSERT_EQ(stats[0].numAcquired, 3u);
+   ASSERT_EQ(stats[0].numMisses, 2u);
+   ASSERT_EQ(stats[1].numAcquired, 0u);
+}
+
+TEST(BufferPool, leaseMove)
+{
+   BufferPool pool(4096, 4096, false);
+
+   BufferPool::Lease a = pool.acquire(4096);
+   char* data = a.data();
+
+   BufferPool::Lease b(std::move(a) );
+   ASSERT_EQ(a.data(), nullptr);
+   ASSERT_EQ(b.data(), data);
+
+   b = BufferPool::Lease();
+
+   std::vector<BufferPool::SizeClassStats> stats;
+   pool.getStats(&stats);
+   ASSERT_EQ(stats[0].numInUse, 0u);
+}
+
+TEST(BufferPool, zeroMinBufSize)
+{
+   BufferPool pool(0, 4, false);
+
+   std::vector<BufferPool::SizeClassStats> stats;
+   pool.getStats(&stats);
+
+   ASSERT_EQ(stats.size(), 3u); // 1, 2, 4
+   ASSERT_EQ(stats[0].bufSize, 1u);
+
+   ASSERT_EQ(pool.acquire(0).size(), 1u);
+   ASSERT_EQ(pool.acquire(3).size(), 4u);
+}
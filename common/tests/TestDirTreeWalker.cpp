@@ -0,0 +1,160 @@
+#include <common/toolkit/DirTreeWalker.h>
+#include <common/toolkit/StorageTk.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fcntl.h>
+#include <mutex>
+#include <set>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+class TestDirTreeWalker : public ::testing::Test {
+   protected:
+      std::string tmpDir;
+      std::set<std::string> expectedFiles;
+      std::set<std::string> expectedDirs;
+
+      void SetUp() override
+      {
+         tmpDir = "tmpXXXXXX";
+         tmpDir += '\0';
+         ASSERT_NE(mkdtemp(&tmpDir[0]), nullptr);
+         tmpDir.resize(tmpDir.size() - 1);
+
+         // a/0..9/0..19 with one file per leaf dir, and a few files in the root
+         for (int i = 0; i < 10; i++)
+         {
+            for (int j = 0; j < 20; j++)
+            {
+               const std::string dir = "a/" + std::to_string(i) + "/" + std::to_string(j);
+
+               ASSERT_TRUE(StorageTk::createPathOnDisk(Path(tmpDir + "/" + dir), false) );
+               createFile(dir + "/file");
+
+               expectedDirs.insert(dir);
+            }
+
+            expectedDirs.insert("a/" + std::to_string(i) );
+         }
+
+         expectedDirs.insert("a");
+
+         for (int i = 0; i < 5; i++)
+            createFile("rootfile" + std::to_string(i) );
+      }
+
+      void TearDown() override
+      {
+         StorageTk::removeDirRecursive(tmpDir);
+      }
+
+      void createFile(const std::string& path)
+      {
+         int fd = open( (tmpDir + "/" + path).c_str(), O_CREAT | O_WRONLY, 0644);
+         ASSERT_GE(fd, 0);
+         ASSERT_EQ(write(fd, "data", 4), 4);
+         close(fd);
+
+         expectedFiles.insert(path);
+      }
+};
+
+TEST_F(TestDirTreeWalker, walkAll)
+{
+   for (unsigned numThreads : {1u, 4u})
+   {
+      for (bool statEntries : {false, true})
+      {
+         Mutex mutex;
+         std::set<std::string> files;
+         std::set<std::string> dirs;
+         bool statMismatch = false;
+
+         DirTreeWalker walker(numThreads, statEntries);
+
+         bool walkRes = walker.walk(tmpDir, [&] (const DirTreeWalker::Entry& entry) {
+            const std::lock_guard<Mutex> lock(mutex);
+
+            if (statEntries != (entry.statBuf != NULL) )
+               statMismatch = true;
+            else
+            if (entry.statBuf && !entry.isDir && entry.statBuf->st_size != 4)
+               statMismatch = true;
+
+            (entry.isDir ? dirs : files).insert(entry.getPath() );
+            return DirTreeWalker::Action_CONTINUE;
+         });
+
+         ASSERT_TRUE(walkRes);
+         ASSERT_FALSE(statMismatch);
+         ASSERT_EQ(files, expectedFiles);
+         ASSERT_EQ(dirs, expectedDirs);
+      }
+   }
+}
+
+TEST_F(TestDirTreeWalker, skipAndDepth)
+{
+   Mutex mutex;
+   std::set<std::string> paths;
+   bool depthMismatch = false;
+
+   DirTreeWalker walker(4, false);
+
+   bool walkRes = walker.walk(tmpDir, [&] (const DirTreeWalker::Entry& entry) {
+      const std::lock_guard<Mutex> lock(mutex);
+
+      const std::string path = entry.getPath();
+
+      if (entry.depth != std::count(path.begin(), path.end(), '/') )
+         depthMismatch = true;
+
+      paths.insert(path);
+
+      // don't descend below a/<i>
+      return entry.depth < 1 ? DirTreeWalker::Action_CONTINUE : DirTreeWalker::Action_SKIP;
+   });
+
+   ASSERT_TRUE(walkRes);
+   ASSERT_FALSE(depthMismatch);
+   ASSERT_EQ(paths.size(), 5u + 1 + 10);
+   ASSERT_EQ(paths.count("a/0/0"), 0u);
+}
+
+TEST_F(TestDirTreeWalker, abort)
+{
+   std::atomic<unsigned> numEntries(0);
+
+   DirTreeWalker walker(4, false);
+
+   bool walkRes = walker.walk(tmpDir, [&] (const DirTreeWalker::Entry& entry) {
+      if (++numEntries == 20)
+         return DirTreeWalker::Action_ABORT;
+
+      return DirTreeWalker::Action_CONTINUE;
+   });
+
+   ASSERT_FALSE(walkRes);
+   ASSERT_LT(numEntries.load(), expectedFiles.size() + expectedDirs.size() );
+}
+
+TEST_F(TestDirTreeWalker, errors)
+{
+   DirTreeWalker walker(2, false);
+   std::string errorPath;
+   int errorCode = 0;
+
+   bool walkRes = walker.walk(tmpDir + "/nonexistent",
+      [] (const DirTreeWalker::Entry& entry) { return DirTreeWalker::Action_CONTINUE; },
+      [&] (const std::string& path, int errCode) {
+         errorPath = path;
+         errorCode = errCode;
+         return true;
+      });
+
+   ASSERT_FALSE(walkRes);
+   ASSERT_EQ(errorPath, "");
+   ASSERT_EQ(errorCode, ENOENT);
+}
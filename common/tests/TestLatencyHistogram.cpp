@@ -0,0 +1,101 @@
+#include <common/benchmark/LatencyHistogram.h>
+
+#include <gtest/gtest.h>
+
+TEST(LatencyHistogram, empty)
+{
+   LatencyHistogram histogram;
+
+   LatencyStats stats = histogram.getStats();
+   ASSERT_EQ(stats.numOps, 0u);
+   ASSERT_EQ(stats.p50, 0u);
+   ASSERT_EQ(stats.p999, 0u);
+   ASSERT_EQ(stats.max, 0u);
+}
+
+TEST(LatencyHistogram, smallValuesAreExact)
+{
+   LatencyHistogram histogram;
+
+   for (uint64_t i = 1; i <= 10; i++)
+      histogram.add(i);
+
+   ASSERT_EQ(histogram.getNumValues(), 10u);
+   ASSERT_EQ(histogram.getPercentile(50), 5u);
+   ASSERT_EQ(histogram.getPercentile(99), 10u);
+   ASSERT_EQ(histogram.getPercentile(0), 1u);
+}
+
+TEST(LatencyHistogram, relativeError)
+{
+   LatencyHistogram histogram;
+
+   // 1000 values: 1000us, 2000us, ..., 1000000us
+   for (uint64_t i = 1; i <= 1000; i++)
+      histogram.add(i * 1000);
+
+   const struct { double percent; uint64_t exact; } expected[] = {
+      { 50, 500000 }, { 99, 990000 }, { 99.9, 999000 } };
+
+   for (const auto& e : expected)
+   {
+      uint64_t value = histogram.getPercentile(e.percent);
+
+      // the upper bound of the bucket is reported, so the value is never below the exact one
+      ASSERT_GE(value, e.exact);
+      ASSERT_LE(value, e.exact + e.exact / 16);
+   }
+
+   ASSERT_EQ(histogram.getStats().max, 1000000u);
+}
+
+TEST(LatencyHistogram, tail)
+{
+   LatencyHistogram histogram;
+
+   for (int i = 0; i < 999; i++)
+      histogram.add(100);
+
+   histogram.add(50000);
+
+   LatencyStats stats = histogram.getStats();
+   ASSERT_EQ(stats.numOps, 1000u);
+   ASSERT_LE(stats.p50, 103u);
+   ASSERT_LE(stats.p99, 103u);
+   ASSERT_LE(stats.p999, 103u);
+   ASSERT_EQ(stats.max, 50000u);
+
+   histogram.add(50000);
+   ASSERT_EQ(histogram.getPercentile(99.9), 50000u);
+   ASSERT_EQ(histogram.getPercentile(100), 50000u);
+
+   histogram.add(UINT64_MAX);
+   ASSERT_EQ(histogram.getPercentile(100), UINT64_MAX);
+
+   histogram.clear();
+   ASSERT_EQ(histogram.getNumValues(), 0u);
+   ASSERT_EQ(histogram.getPercentile(50), 0u);
+}
+
+TEST(LatencyHistogram, merge)
+{
+   LatencyHistogram fast;
+   LatencyHistogram slow;
+
+   for (int i = 0; i < 90; i++)
+      fast.add(10);
+
+   for (int i = 0; i < 10; i++)
+      slow.add(1000);
+
+   fast.merge(slow);
+
+   LatencyStats stats = fast.getStats();
+   ASSERT_EQ(stats.numOps, 100u);
+   ASSERT_EQ(stats.p50, 10u);
+   ASSERT_GE(stats.p99, 1000u);
+   ASSERT_EQ(stats.max, 1000u);
+
+   // the merged histogram is unchanged
+   ASSERT_EQ(slow.getNumValues(), 10u);
+}
@@ -0,0 +1,155 @@
+#include <common/threading/Condition.h>
+#include <common/threading/LockProfiler.h>
+#include <common/threading/Mutex.h>
+#include <common/threading/RWLock.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+class LockProfilerTest : public ::testing::Test
+{
+   protected:
+      void SetUp() override
+      {
+         LockProfiler::reset();
+         LockProfiler::setEnabled(true);
+      }
+
+      void TearDown() override
+      {
+         LockProfiler::setEnabled(false);
+      }
+
+      static std::string reportLine(const std::string& report, const std::string& lockName)
+      {
+         const size_t start = report.find(lockName);
+         if (start == std::string::npos)
+            return "";
+
+         return report.substr(start, report.find('\n', start) - start);
+      }
+};
+
+TEST_F(LockProfilerTest, sitesAreSharedByName)
+{
+   ASSERT_EQ(LockProfiler::getSite("LockProfilerTest::shared"),
+         LockProfiler::getSite("LockProfilerTest::shared"));
+   ASSERT_NE(LockProfiler::getSite("LockProfilerTest::shared"),
+         LockProfiler::getSite("LockProfilerTest::other"));
+}
+
+TEST_F(LockProfilerTest, disabledRecordsNothing)
+{
+   Mutex mutex("LockProfilerTest::disabled");
+
+   LockProfiler::setEnabled(false);
+
+   mutex.lock();
+   mutex.unlock();
+
+   std::istringstream lineStream(reportLine(LockProfiler::getReport(0),
+         "LockProfilerTest::disabled"));
+   std::string name;
+   uint64_t acquired = 1;
+
+   lineStream >> name >> acquired;
+
+   ASSERT_EQ(name, "LockProfilerTest::disabled");
+   ASSERT_EQ(acquired, 0u);
+}
+
+TEST_F(LockProfilerTest, contendedMutex)
+{
+   Mutex mutex("LockProfilerTest::mutex");
+   std::atomic<bool> waiting(false);
+
+   mutex.lock();
+
+   std::thread waiter([&] () {
+      waiting = true;
+      mutex.lock();
+      mutex.unlock();
+   });
+
+   while (!waiting)
+      std::this_thread::yield();
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   mutex.unlock();
+   waiter.join();
+
+   const std::string report = LockProfiler::getReport(0);
+   const std::string line = reportLine(report, "LockProfilerTest::mutex");
+
+   // 2 acquisitions, 1 of them contended for at least 10ms
+   std::istringstream lineStream(line);
+   std::string name;
+   uint64_t acquired, contended, percent, waitMS;
+
+   lineStream >> name >> acquired >> contended >> percent >> waitMS;
+
+   ASSERT_EQ(acquired, 2u);
+   ASSERT_EQ(contended, 1u);
+   ASSERT_EQ(percent, 50u);
+   ASSERT_GE(waitMS, 10u);
+}
+
+TEST_F(LockProfilerTest, contendedRWLock)
+{
+   RWLock rwlock("LockProfilerTest::rwlock");
+   std::atomic<bool> waiting(false);
+
+   rwlock.writeLock();
+
+   std::thread reader([&] () {
+      waiting = true;
+      rwlock.readLock();
+      rwlock.unlock();
+   });
+
+   while (!waiting)
+      std::this_thread::yield();
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(20));
+   rwlock.unlock();
+   reader.join();
+
+   rwlock.readLock();
+   rwlock.unlock();
+
+   std::istringstream lineStream(reportLine(LockProfiler::getReport(0),
+         "LockProfilerTest::rwlock"));
+   std::string name;
+   uint64_t acquired, contended;
+
+   lineStream >> name >> acquired >> contended;
+
+   ASSERT_EQ(acquired, 3u);
+   ASSERT_EQ(contended, 1u);
+}
+
+TEST_F(LockProfilerTest, conditionWaits)
+{
+   Mutex mutex("LockProfilerTest::condMutex");
+   Condition cond;
+
+   mutex.lock();
+   cond.timedwait(&mutex, 10);
+   mutex.unlock();
+
+   std::istringstream lineStream(reportLine(LockProfiler::getReport(0),
+         "LockProfilerTest::condMutex"));
+   std::string column;
+   std::vector<std::string> columns;
+
+   while (lineStream >> column)
+      columns.push_back(column);
+
+   ASSERT_EQ(columns.size(), 11u); // name and 10 values
+   ASSERT_EQ(columns[1], "1"); // acquired
+   ASSERT_EQ(columns[9], "1"); // condwaits
+}
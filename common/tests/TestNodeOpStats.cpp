@@ -0,0 +1,153 @@
+#include <common/nodes/NodeOpStats.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+
+class TestOpStats : public NodeOpStats
+{
+   public:
+      TestOpStats() : NodeOpStats(MetaOpCounter_OpCounterLastEnum) {}
+
+      void updateNodeOp(uint128_t nodeIP, MetaOpCounterTypes opType, unsigned userID)
+      {
+         Shard* shard = getThreadShard();
+
+         shard->getClientCounter(nodeIP).increaseOpCounter(opType);
+         shard->getUserCounter(userID).increaseOpCounter(opType);
+      }
+};
+
+const uint128_t NO_COOKIE = uint128::make(~0ULL, ~0ULL);
+
+/**
+ * @return id => counters of all ids in the vector
+ */
+std::map<uint128_t, std::vector<uint64_t>> parseVec(const Uint128Vector& vec)
+{
+   std::map<uint128_t, std::vector<uint64_t>> result;
+
+   if (vec.empty() )
+      return result;
+
+   const size_t numOps = vec[NODEOPS_POS_NUMOPS];
+
+   for (size_t pos = NODE_OPS_POS_FIRSTDATAELEMENT; pos < vec.size(); pos += numOps + 1)
+      result[vec[pos]].assign(vec.begin() + pos + 1, vec.begin() + pos + 1 + numOps);
+
+   return result;
+}
+
+}
+
+TEST(NodeOpStats, sumsUpThreads)
+{
+   const unsigned numThreads = 4;
+   const unsigned numOpsPerThread = 1000;
+
+   TestOpStats stats;
+   std::vector<std::thread> threads;
+
+   for (unsigned i = 0; i < numThreads; i++)
+      threads.emplace_back([&stats, i] () {
+         for (unsigned op = 0; op < numOpsPerThread; op++)
+         {
+            stats.updateNodeOp(1, MetaOpCounter_STAT, 1000);
+            stats.updateNodeOp(2 + i, MetaOpCounter_OPEN, 2000 + i);
+         }
+      });
+
+   for (auto it = threads.begin(); it != threads.end(); ++it)
+      it->join();
+
+   Uint128Vector vec;
+   ASSERT_TRUE(stats.mapToUInt128Vec(NO_COOKIE, 64 * 1024, false, &vec) );
+   ASSERT_EQ(vec[NODEOPS_POS_NUMOPS], uint128_t(MetaOpCounter_OpCounterLastEnum) );
+   ASSERT_EQ(vec[NODE_OPS_POS_MORE_DATA], 0u);
+
+   auto clients = parseVec(vec);
+
+   ASSERT_EQ(clients.size(), 1 + numThreads);
+   ASSERT_EQ(clients[1][MetaOpCounter_STAT], numThreads * numOpsPerThread);
+   ASSERT_EQ(clients[1][MetaOpCounter_OPSUM], numThreads * numOpsPerThread);
+   ASSERT_EQ(clients[2][MetaOpCounter_OPEN], numOpsPerThread);
+
+   vec.clear();
+   ASSERT_TRUE(stats.mapToUInt128Vec(NO_COOKIE, 64 * 1024, true, &vec) );
+
+   auto users = parseVec(vec);
+
+   ASSERT_EQ(users.size(), 1 + numThreads);
+   ASSERT_EQ(users[1000][MetaOpCounter_OPSUM], numThreads * numOpsPerThread);
+   ASSERT_EQ(users[2000][MetaOpCounter_OPEN], numOpsPerThread);
+}
+
+TEST(NodeOpStats, cookie)
+{
+   TestOpStats stats;
+
+   for (uint128_t ip = 1; ip <= 100; ip++)
+      stats.updateNodeOp(ip, MetaOpCounter_STAT, 0);
+
+   // fits about 10 IPs per vector
+   const size_t bufLen =
+      (STATS_VEC_RESERVED_ELEMENTS + 10 * (MetaOpCounter_OpCounterLastEnum + 1) ) *
+      sizeof(uint128_t);
+
+   uint128_t cookie = NO_COOKIE;
+   std::map<uint128_t, std::vector<uint64_t>> clients;
+   unsigned numTransfers = 0;
+
+   while (true)
+   {
+      Uint128Vector vec;
+      ASSERT_TRUE(stats.mapToUInt128Vec(cookie, bufLen, false, &vec) );
+
+      auto part = parseVec(vec);
+      ASSERT_FALSE(part.empty() );
+
+      clients.insert(part.begin(), part.end() );
+      cookie = part.rbegin()->first;
+      numTransfers++;
+
+      if (!vec[NODE_OPS_POS_MORE_DATA])
+         break;
+   }
+
+   ASSERT_EQ(clients.size(), 100u);
+   ASSERT_EQ(numTransfers, 10u);
+   ASSERT_EQ(clients.begin()->first, 1u);
+   ASSERT_EQ(clients.rbegin()->first, 100u);
+}
+
+TEST(NodeOpStats, removeClient)
+{
+   TestOpStats stats;
+
+   std::thread([&stats] () {
+      stats.updateNodeOp(1, MetaOpCounter_STAT, 0);
+      stats.updateNodeOp(2, MetaOpCounter_STAT, 0);
+   }).join();
+
+   stats.updateNodeOp(1, MetaOpCounter_STAT, 0);
+   stats.removeClientFromMap(1);
+
+   Uint128Vector vec;
+   ASSERT_TRUE(stats.mapToUInt128Vec(NO_COOKIE, 64 * 1024, false, &vec) );
+
+   auto clients = parseVec(vec);
+   ASSERT_EQ(clients.size(), 1u);
+   ASSERT_EQ(clients.count(2), 1u);
+
+   // counting starts over when the client comes back
+   stats.updateNodeOp(1, MetaOpCounter_STAT, 0);
+
+   vec.clear();
+   ASSERT_TRUE(stats.mapToUInt128Vec(NO_COOKIE, 64 * 1024, false, &vec) );
+
+   clients = parseVec(vec);
+   ASSERT_EQ(clients.size(), 2u);
+   ASSERT_EQ(clients[1][MetaOpCounter_STAT], 1u);
+}
@@ -0,0 +1,130 @@
+#include <common/components/worker/ObjectPool.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// the pool is process-wide, so every test uses its own size classes and looks at differences
+
+template<size_t Size>
+struct TestObject : public PooledObject
+{
+   char data[Size];
+
+   virtual ~TestObject() {}
+};
+
+struct SmallBase : public PooledObject
+{
+   virtual ~SmallBase() {}
+};
+
+struct LargeDerived : public SmallBase
+{
+   char data[1500];
+};
+
+ObjectPool::SizeClassStats getClassStats(size_t size)
+{
+   std::vector<ObjectPool::SizeClassStats> stats;
+
+   ObjectPool::getStats(&stats);
+
+   for (auto iter = stats.begin(); iter != stats.end(); iter++)
+      if (iter->objectSize == (ObjectPool::getSizeClass(size) + 1) * ObjectPool::CLASS_GRANULARITY)
+         return *iter;
+
+   return ObjectPool::SizeClassStats();
+}
+
+}
+
+TEST(ObjectPool, reuse)
+{
+   typedef TestObject<200> Object;
+
+   const auto statsBefore = getClassStats(sizeof(Object) );
+
+   Object* first = new Object();
+   delete first;
+
+   Object* second = new Object();
+   ASSERT_EQ(first, second);
+   delete second;
+
+   const auto statsAfter = getClassStats(sizeof(Object) );
+
+   ASSERT_EQ(statsAfter.numAllocs - statsBefore.numAllocs, 2u);
+   ASSERT_LE(statsAfter.numSystemAllocs - statsBefore.numSystemAllocs, 1u);
+}
+
+TEST(ObjectPool, crossThread)
+{
+   typedef TestObject<600> Object;
+
+   const unsigned numObjects = 2000;
+   std::vector<Object*> objects;
+
+   auto allocAll = [&] () {
+      for (unsigned i = 0; i < numObjects; i++)
+         objects.push_back(new Object() );
+   };
+
+   auto freeAll = [&] () {
+      for (auto iter = objects.begin(); iter != objects.end(); iter++)
+         delete *iter;
+
+      objects.clear();
+   };
+
+   std::thread(allocAll).join();
+   std::thread(freeAll).join();
+
+   // the blocks released by the second thread must be reused by a third one
+   const auto statsBefore = getClassStats(sizeof(Object) );
+
+   std::thread(allocAll).join();
+
+   const auto statsAfter = getClassStats(sizeof(Object) );
+
+   ASSERT_EQ(statsAfter.numAllocs - statsBefore.numAllocs, numObjects);
+   ASSERT_EQ(statsAfter.numSystemAllocs, statsBefore.numSystemAllocs);
+
+   std::thread(freeAll).join();
+}
+
+TEST(ObjectPool, deleteThroughBase)
+{
+   std::vector<SmallBase*> objects;
+
+   for (unsigned i = 0; i < 100; i++)
+      objects.push_back(new LargeDerived() );
+
+   for (auto iter = objects.begin(); iter != objects.end(); iter++)
+      delete *iter;
+
+   // blocks must have been returned to the class of the derived type
+   for (unsigned i = 0; i < 100; i++)
+   {
+      LargeDerived* object = new LargeDerived();
+
+      memset(object->data, 0xab, sizeof(object->data) );
+      delete object;
+   }
+
+   ASSERT_GE(getClassStats(sizeof(LargeDerived) ).numAllocs, 200u);
+}
+
+TEST(ObjectPool, largeObjectsBypassPool)
+{
+   typedef TestObject<ObjectPool::MAX_POOLED_SIZE + 1> Object;
+
+   ASSERT_FALSE(ObjectPool::isPooledSize(sizeof(Object) ) );
+
+   Object* object = new Object();
+   memset(object->data, 0xab, sizeof(object->data) );
+   delete object;
+}
@@ -4,6 +4,7 @@
 #include <common/fsck/FsckDirInode.h>
 #include <common/fsck/FsckFileInode.h>
 #include <common/nodes/Node.h>
+#include <common/net/message/mon/RequestStorageDataRespMsg.h>
 #include <common/net/message/storage/attribs/SetXAttrMsg.h>
 #include <common/net/message/storage/creating/MkLocalDirMsg.h>
 #include <common/net/sock/NetworkInterfaceCard.h>
@@ -1138,3 +1139,65 @@ TEST(Serialization, stringCollections)
       testStringCollection<std::set>(expected);
    }
 }
+
+TEST(Serialization, storageDataWritebackStats)
+{
+   StorageTargetInfo::WritebackStats writebackStats = {};
+   writebackStats.syncWindow = 4 << 20;
+   writebackStats.startThreshold = 8 << 20;
+   writebackStats.numStalls = 3;
+   writebackStats.numSubmits = 5;
+   writebackStats.lastDecision = 2;
+
+   StorageTargetInfoList targets;
+   targets.push_back(StorageTargetInfo(1, "/t1", 100, 50, 10, 5, TargetConsistencyState_GOOD) );
+   targets.push_back(StorageTargetInfo(2, "/t2", 100, 50, 10, 5, TargetConsistencyState_GOOD) );
+   targets.front().setWritebackStats(true, writebackStats);
+
+   NicAddressList nicList;
+   HighResStatsList statsList;
+
+   const RequestStorageDataRespMsg sent("node", "host", NumNodeID(1), &nicList, 0, 0, 0, 0, 0,
+      &statsList, &targets);
+
+   Serializer sizer;
+   RequestStorageDataRespMsg::serialize(&sent, sizer);
+
+   std::vector<char> buf(sizer.size() );
+   Serializer ser(&buf[0], buf.size() );
+   RequestStorageDataRespMsg::serialize(&sent, ser);
+   ASSERT_TRUE(ser.good() );
+
+   {
+      RequestStorageDataRespMsg received;
+      received.setMsgHeaderCompatFeatureFlags(sent.getMsgHeaderCompatFeatureFlags() );
+
+      Deserializer des(&buf[0], buf.size() );
+      RequestStorageDataRespMsg::serialize(&received, des);
+      ASSERT_TRUE(des.good() );
+      ASSERT_EQ(des.size(), buf.size() );
+
+      const StorageTargetInfoList& receivedTargets = received.getStorageTargets();
+      ASSERT_EQ(receivedTargets.size(), 2u);
+      ASSERT_TRUE(receivedTargets.front().getHasWritebackStats() );
+      ASSERT_EQ(receivedTargets.front().getWritebackStats().syncWindow, 4 << 20);
+      ASSERT_EQ(receivedTargets.front().getWritebackStats().startThreshold, 8 << 20);
+      ASSERT_EQ(receivedTargets.front().getWritebackStats().numStalls, 3u);
+      ASSERT_EQ(receivedTargets.front().getWritebackStats().numSubmits, 5u);
+      ASSERT_EQ(receivedTargets.front().getWritebackStats().lastDecision, 2);
+      ASSERT_FALSE(receivedTargets.back().getHasWritebackStats() );
+   }
+
+   {
+      // receivers that don't know the compat flag ignore the stats at the end
+      RequestStorageDataRespMsg received;
+
+      Deserializer des(&buf[0], buf.size() );
+      RequestStorageDataRespMsg::serialize(&received, des);
+      ASSERT_TRUE(des.good() );
+      ASSERT_LT(des.size(), buf.size() );
+
+      ASSERT_EQ(received.getStorageTargets().size(), 2u);
+      ASSERT_FALSE(received.getStorageTargets().front().getHasWritebackStats() );
+   }
+}
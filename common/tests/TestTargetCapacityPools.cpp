@@ -1,5 +1,7 @@
 #include <common/nodes/TargetCapacityPools.h>
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 TEST(TargetCapacityPools, interdomainWithEmptyGroups)
@@ -16,3 +18,52 @@ TEST(TargetCapacityPools, interdomainWithEmptyGroups)
    EXPECT_EQ(chosen.size(), 1u);
    ASSERT_EQ(chosen[0], 1);
 }
+
+TEST(TargetCapacityPools, weightedHonorsCapacityPools)
+{
+   TargetCapacityPools pools(false, {0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0});
+
+   pools.addOrUpdate(1, NumNodeID(1), CapacityPool_NORMAL);
+   pools.addOrUpdate(2, NumNodeID(1), CapacityPool_NORMAL);
+   pools.addOrUpdate(3, NumNodeID(2), CapacityPool_LOW);
+
+   // low pool is only used if the normal pool doesn't have enough targets
+   for (int i = 0; i < 20; i++)
+   {
+      std::vector<uint16_t> chosen;
+      pools.chooseStorageTargetsWeighted(2, 2, {{1, 0.01}, {3, 100}}, &chosen);
+
+      ASSERT_EQ(chosen.size(), 2u);
+      ASSERT_TRUE(std::find(chosen.begin(), chosen.end(), 3) == chosen.end() );
+   }
+
+   std::vector<uint16_t> chosen;
+   pools.chooseStorageTargetsWeighted(4, 3, {}, &chosen);
+
+   ASSERT_EQ(chosen.size(), 3u);
+   std::sort(chosen.begin(), chosen.end() );
+   ASSERT_EQ(chosen, std::vector<uint16_t>({1, 2, 3}) );
+}
+
+TEST(TargetCapacityPools, weightedPrefersHeavyTargets)
+{
+   TargetCapacityPools pools(false, {0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0});
+
+   pools.addOrUpdate(1, NumNodeID(1), CapacityPool_NORMAL);
+   pools.addOrUpdate(2, NumNodeID(2), CapacityPool_NORMAL);
+
+   unsigned numFirst = 0;
+
+   for (int i = 0; i < 1000; i++)
+   {
+      std::vector<uint16_t> chosen;
+      pools.chooseStorageTargetsWeighted(1, 1, {{1, 9}, {2, 1}}, &chosen);
+
+      ASSERT_EQ(chosen.size(), 1u);
+      numFirst += chosen[0] == 1;
+   }
+
+   // expected: 900
+   ASSERT_GT(numFirst, 800u);
+   ASSERT_LT(numFirst, 980u);
+}
@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include <string>
+#include <string_view>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <vector>
@@ -55,6 +56,7 @@ enum class FileEventType : uint32_t
 
 
 std::string to_string(const FileEventType& fileEvent);
+const char* to_c_str(const FileEventType& fileEvent);
 
 struct packet
 {
@@ -81,6 +83,28 @@ enum class PacketReadErrorCode
 
 std::pair<PacketReadErrorCode, packet> read_packet_from_raw(void * data, size_t bytesRead);
 
+/**
+ * Same as packet, but the strings point into the buffer the packet was decoded from, so decoding
+ * doesn't allocate. Only valid as long as that buffer is.
+ */
+struct packet_view
+{
+    uint16_t formatVersion;
+    uint32_t eventFlags;
+    uint64_t linkCount;
+    FileEventType type;
+    std::string_view path;
+    std::string_view entryId;
+    std::string_view parentEntryId;
+    std::string_view targetPath;
+    std::string_view targetParentId;
+    uint32_t msgUserId;
+    int64_t timestamp;
+};
+
+PacketReadErrorCode read_packet_view_from_raw(const void* data, size_t bytesRead,
+   packet_view& outPacket);
+
 
 
 
@@ -97,10 +121,14 @@ public:
 
    std::pair<PacketReadErrorCode, packet> read();
    std::vector<char> readSerializedData();
+   // raw events, see receive_events(). Empty if the connection ended.
+   Read_Event_Batch readBatch(size_t maxEvents = MAX_EVENT_BATCH_SIZE);
 
    FileEventReceiver(FileEventReceiver const& other) = delete;
 
    FileEventReceiver(const std::string& socketPath);
+   // args: <socketPath> [options], see FileEventReceiverNewProtocolCreate()
+   FileEventReceiver(int argc, const char **argv);
    ~FileEventReceiver();
 };
 
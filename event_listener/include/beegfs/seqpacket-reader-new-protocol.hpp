@@ -26,4 +26,20 @@ struct Read_Event
 // after receive_event() succeeded and is invalidated by the next receive_event().
 Read_Event get_event(FileEventReceiverNewProtocol *r);
 
+
+enum { MAX_EVENT_BATCH_SIZE = 64 };
+
+struct Read_Event_Batch
+{
+   Read_Event const *events;
+   size_t count;
+};
+
+// Receives up to max_events events (at most MAX_EVENT_BATCH_SIZE, 0 means the
+// maximum). Blocks until at least one event is available and then returns all
+// further events that are already queued, without waiting for more.
+// Returns an empty batch when the connection ended. The events point to
+// buffers allocated internally and are invalidated by the next receive call.
+Read_Event_Batch receive_events(FileEventReceiverNewProtocol *r, size_t max_events);
+
 }
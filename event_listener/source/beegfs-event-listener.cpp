@@ -1,5 +1,10 @@
+#include <charconv>
+#include <cstring>
 #include <iostream>
-#include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <endian.h>
 #include <signal.h>
 
 #include "beegfs/beegfs_file_event_log.hpp"
@@ -12,107 +17,129 @@
 
 
 /**
- * @brief Trivial JSON writer
+ * @brief Trivial JSON writer. Appends to a caller-owned buffer, so formatting an event doesn't
+ * allocate once the buffer has grown to the size of the largest event.
  */
-class JsonObject {
+class JsonWriter {
 
    public:
 
-      template<typename T>
-      JsonObject& keyValue(const std::string& key, const T& value) {
-         if(!isFirstItem) {
-            stream << ", ";
+      explicit JsonWriter(std::string& out) : out(out) {}
 
-         } else {
-            isFirstItem = false;
-         }
+      JsonWriter& beginObject() {
+         separate();
+         out += "{ ";
+         isFirstItem = true;
+         return *this;
+      }
 
+      JsonWriter& beginObject(std::string_view key) {
+         separate();
          printValue(key);
-         stream << ": ";
-         printValue(value);
+         out += ": { ";
+         isFirstItem = true;
          return *this;
       }
 
-      operator std::string() const {
-         return str();
+      JsonWriter& endObject() {
+         out += " }";
+         isFirstItem = false;
+         return *this;
       }
 
-      std::string str() const
-      {
-         return "{ " + stream.str() + " }";
+      template<typename T>
+      JsonWriter& keyValue(std::string_view key, const T& value) {
+         separate();
+         printValue(key);
+         out += ": ";
+         printValue(value);
+         return *this;
       }
 
    protected:
 
-      std::stringstream stream;
-      bool isFirstItem=true;
+      std::string& out;
+      bool isFirstItem = true;
+
+      void separate() {
+         if(!isFirstItem)
+            out += ", ";
+
+         isFirstItem = false;
+      }
 
       template<typename T>
       void printValue(const T& value) {
-         stream << value;
-      }
+         static_assert(std::is_integral<T>::value, "unsupported JSON value type");
 
-      void printValue(const std::string& value) {
-         stream << "\"";
-         writeEscaped(stream, value);
-         stream << "\"";
+         char buf[24];
+         const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+         out.append(buf, res.ptr);
       }
 
-      void printValue(const char* value) {
-         printValue(std::string(value));
+      void printValue(std::string_view value) {
+         out += '"';
+         writeEscaped(value);
+         out += '"';
       }
 
-      void printValue(const JsonObject& json) {
-         stream << json.str();
+      void printValue(const char* value) {
+         printValue(std::string_view(value));
       }
 
-      void writeEscaped(std::ostream& stream, const std::string& s)
+      void writeEscaped(std::string_view s)
       {
          for(const auto& x: s)
          {
             switch (x) {
                case 0x08:
-                  stream << "\\b";
+                  out += "\\b";
                   break;
                case 0x0c:
-                  stream << "\\f";
+                  out += "\\f";
                   break;
                case '\n':
-                  stream << "\\n";
+                  out += "\\n";
                   break;
                case '\\':
-                  stream << "\\\\";
+                  out += "\\\\";
                   break;
                case '\t':
-                  stream << "\\t";
+                  out += "\\t";
                   break;
                case '\r':
-                  stream << "\\r";
+                  out += "\\r";
                   break;
                case '\"':
-                  stream << "\\\"";
+                  out += "\\\"";
                   break;
                case '/':
-                  stream << "\\/";
+                  out += "\\/";
                   break;
                default:
-                  stream << x;
+                  if ((unsigned char) x < 0x20) {
+                     static const char hexDigits[] = "0123456789abcdef";
+                     out += "\\u00";
+                     out += hexDigits[(unsigned char) x >> 4];
+                     out += hexDigits[(unsigned char) x & 0xf];
+                  } else {
+                     out += x;
+                  }
             }
          }
       }
 
 };
 
-std::ostream& operator<<(std::ostream& os, const BeeGFS::packet& p)
+static void writeJson(std::string& out, const BeeGFS::packet_view& p)
 {
-   JsonObject json;
-   json
-      .keyValue("FormatVersion",  p.formatVersion)
-      .keyValue("EventFlags",     p.eventFlags)
-      .keyValue("NumLinks",       p.linkCount)
-      .keyValue("Event",
-         JsonObject()
-            .keyValue("Type",           to_string(p.type))
+   JsonWriter(out)
+      .beginObject()
+         .keyValue("FormatVersion",  p.formatVersion)
+         .keyValue("EventFlags",     p.eventFlags)
+         .keyValue("NumLinks",       p.linkCount)
+         .beginObject("Event")
+            .keyValue("Type",           to_c_str(p.type))
             .keyValue("Path",           p.path)
             .keyValue("EntryId",        p.entryId)
             .keyValue("ParentEntryId",  p.parentEntryId)
@@ -120,11 +147,31 @@ std::ostream& operator<<(std::ostream& os, const BeeGFS::packet& p)
             .keyValue("TargetParentId", p.targetParentId)
             .keyValue("UserID",         p.msgUserId)
             .keyValue("Timestamp",      p.timestamp)
+         .endObject()
+      .endObject();
+
+   out += '\n';
+}
+
+/**
+ * Binary output record: 32 bit little endian length, followed by the event as it was received
+ * from the metadata server (starting with the 16 bit format version).
+ */
+static void writeBinary(std::string& out, const BeeGFS::Read_Event& event)
+{
+   const uint32_t len = htole32(event.size);
 
-         );
+   out.append((const char*) &len, sizeof(len));
+   out.append((const char*) event.buffer, event.size);
+}
 
-   os << json.str();
-   return os;
+static void writeOut(const std::string& out)
+{
+   if (fwrite(out.data(), 1, out.size(), stdout) != out.size() || fflush(stdout))
+   {
+      std::cerr << "Writing output failed" << std::endl;
+      exit(EXIT_FAILURE);
+   }
 }
 
 void shutdown(int)
@@ -141,7 +188,18 @@ int main(const int argc, const char** argv)
                   " <fileEventLogTarget: unix socket file path>\n"
                   "\n"
                   "Usage:\n"
-                  "  beegfs-event-listener <socket>\n\n"
+                  "  beegfs-event-listener <socket> [filter options]\n\n"
+                  "FILTER OPTIONS:\n"
+                  "  The metadata server only sends events that match all given filters.\n"
+                  "  -filter-type <type>    Event type number (e.g. 4 = CloseAfterWrite,\n"
+                  "                         12 = Rename). May be repeated.\n"
+                  "  -filter-path <prefix>  Path or rename target lies below <prefix>.\n"
+                  "                         May be repeated.\n"
+                  "  -filter-uid <uid>      Event triggered by user <uid>. May be repeated.\n\n"
+                  "OUTPUT OPTIONS:\n"
+                  "  -binary                Write the events as received instead of JSON. Each\n"
+                  "                         event is preceded by its size as 32 bit little endian\n"
+                  "                         number.\n\n"
                   "  The medatada server has to be pointed to the socket, so that it knows where to\n"
                   "  send the event log. Set\n"
                   "     sysFileEventLogTarget = unix://<path>\n"
@@ -160,35 +218,81 @@ int main(const int argc, const char** argv)
 
     signal(SIGINT,  shutdown);
 
-    BeeGFS::FileEventReceiver receiver(argv[1]);
+    // everything except our own options is passed on to the receiver
+    std::vector<const char*> receiverArgs;
+    bool binaryOutput = false;
 
-    std::cout << JsonObject().keyValue("EventListener",
-                           JsonObject().keyValue("Socket", argv[1])
-                                       .keyValue("FormatVersion", BEEGFS_EVENTLOG_FORMAT_VERSION)
-                                       ).str() << std::endl;
+    for (int i = 1; i < argc; i++)
+    {
+       if (!strcmp(argv[i], "-binary"))
+          binaryOutput = true;
+       else
+          receiverArgs.push_back(argv[i]);
+    }
 
-    while (true)
+    BeeGFS::FileEventReceiver receiver(receiverArgs.size(), receiverArgs.data());
+
+    // reused for all events, output is written once per batch
+    std::string out;
+    out.reserve(BeeGFS::MAX_EVENT_BATCH_SIZE * 1024);
+
+    if (!binaryOutput)
     {
-       using BeeGFS::FileEventReceiver;
+       JsonWriter(out)
+          .beginObject()
+             .beginObject("EventListener")
+                .keyValue("Socket", argv[1])
+                .keyValue("FormatVersion", BEEGFS_EVENTLOG_FORMAT_VERSION)
+             .endObject()
+          .endObject();
+
+       out += '\n';
+       writeOut(out);
+    }
 
-       const auto data = receiver.read();
+    while (true)
+    {
+       const auto batch = receiver.readBatch();
 
-       switch (data.first) {
-       case BeeGFS::PacketReadErrorCode::Success:
-          std::cout << data.second << std::endl;
-          break;
-       case BeeGFS::PacketReadErrorCode::VersionMismatch:
-          std::cerr << "Invalid Packet Version" << std::endl;
-          break;
-       case BeeGFS::PacketReadErrorCode::InvalidSize:
-          std::cerr << "Invalid Packet Size" << std::endl;
-          break;
-       case BeeGFS::PacketReadErrorCode::ReadFailed:
+       if (!batch.count)
+       {
           std::cerr << "Read Failed" << std::endl;
           break;
        }
+
+       out.clear();
+
+       for (size_t i = 0; i < batch.count; i++)
+       {
+          const BeeGFS::Read_Event& event = batch.events[i];
+
+          if (binaryOutput)
+          {
+             writeBinary(out, event);
+             continue;
+          }
+
+          BeeGFS::packet_view packet;
+
+          switch (BeeGFS::read_packet_view_from_raw(event.buffer, event.size, packet)) {
+          case BeeGFS::PacketReadErrorCode::Success:
+             writeJson(out, packet);
+             break;
+          case BeeGFS::PacketReadErrorCode::VersionMismatch:
+             std::cerr << "Invalid Packet Version" << std::endl;
+             break;
+          case BeeGFS::PacketReadErrorCode::InvalidSize:
+             std::cerr << "Invalid Packet Size" << std::endl;
+             break;
+          case BeeGFS::PacketReadErrorCode::ReadFailed:
+             std::cerr << "Read Failed" << std::endl;
+             break;
+          }
+       }
+
+       writeOut(out);
     }
 
-    std::cout << "Exit listener" << std::endl;
+    std::cerr << "Exit listener" << std::endl;
     return 0;
 }
@@ -73,6 +73,19 @@ inline std::string Reader::read<std::string>()
    return value;
 }
 
+template <>
+inline std::string_view Reader::read<std::string_view>()
+{
+   const auto len = read<uint32_t>();
+
+   if (position + len > end)
+      throw std::out_of_range("Read past buffer end");
+
+   const auto value = std::string_view(position, len);
+   position += len + 1;
+   return value;
+}
+
 template <typename T>
 inline Reader& operator>>(Reader& r, T& value)
 {
@@ -88,6 +101,11 @@ static inline Reader& operator>>(Reader& r, FileEventType& value)
 
 
 std::string to_string(const FileEventType& fileEvent)
+{
+   return to_c_str(fileEvent);
+}
+
+const char* to_c_str(const FileEventType& fileEvent)
 {
    switch (fileEvent)
    {
@@ -157,6 +175,37 @@ std::pair<PacketReadErrorCode, packet> read_packet_from_raw(void * data, size_t
    return { PacketReadErrorCode::Success, res };
 }
 
+PacketReadErrorCode read_packet_view_from_raw(const void* data, size_t bytesRead,
+   packet_view& outPacket)
+{
+   Reader reader(data, bytesRead);
+
+   try
+   {
+      reader >> outPacket.formatVersion;
+
+      if (outPacket.formatVersion != BEEGFS_EVENTLOG_FORMAT_VERSION)
+         return PacketReadErrorCode::VersionMismatch;
+
+      reader >> outPacket.eventFlags
+             >> outPacket.linkCount
+             >> outPacket.type
+             >> outPacket.entryId
+             >> outPacket.parentEntryId
+             >> outPacket.path
+             >> outPacket.targetPath
+             >> outPacket.targetParentId
+             >> outPacket.msgUserId
+             >> outPacket.timestamp;
+   }
+   catch (const std::out_of_range&)
+   {
+      return PacketReadErrorCode::InvalidSize;
+   }
+
+   return PacketReadErrorCode::Success;
+}
+
 static std::vector<char> read_serialized_data(int fd)
 {
    packet res;
@@ -211,6 +260,11 @@ std::pair<PacketReadErrorCode, packet> FileEventReceiver::read()
    return read_packet_from_raw(event.buffer, event.size);
 }
 
+Read_Event_Batch FileEventReceiver::readBatch(size_t maxEvents)
+{
+   return receive_events(receiver, maxEvents);
+}
+
 std::vector<char> FileEventReceiver::readSerializedData()
 {
    std::vector<char> out;
@@ -236,6 +290,13 @@ FileEventReceiver::FileEventReceiver(const std::string& socketPath)
       throw exception("Failed to init");
 }
 
+FileEventReceiver::FileEventReceiver(int argc, const char **argv)
+{
+   receiver = FileEventReceiverNewProtocolCreate(argc, argv);
+   if (! receiver)
+      throw exception("Failed to init");
+}
+
 FileEventReceiver::~FileEventReceiver()
 {
    if (receiver)
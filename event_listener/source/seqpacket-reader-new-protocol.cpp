@@ -11,10 +11,13 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 
 #include <optional>
+#include <string>
+#include <vector>
 
 
 #include <beegfs/seqpacket-reader-new-protocol.hpp>
@@ -125,6 +128,8 @@ enum class Packet_Type : uint8_t
    // This is the last message sent by the server.
    // Includes a ConnTerminateReason
    Send_Close,
+   // Client restricts the message stream to matching events.
+   Request_Message_Filter,
 };
 
 enum class ConnTerminateReason
@@ -158,6 +163,7 @@ static const char *packet_type_string(Packet_Type packetType)
       PTSTRING(Send_Message);
       PTSTRING(Request_Close);
       PTSTRING(Send_Close);
+      PTSTRING(Request_Message_Filter);
       default: return "(invalid packet type)";
    }
 }
@@ -179,6 +185,18 @@ struct FileEventReceiverOptions
 
    std::optional<uint64_t> startmsn;
    std::optional<uint64_t> nmsgs;
+
+   // Server-side event filter. Only sent if any of these is set.
+   uint32_t filter_type_mask = 0;
+   std::vector<std::string> filter_path_prefixes;
+   std::vector<uint32_t> filter_user_ids;
+
+   bool have_filter() const
+   {
+      return filter_type_mask != 0
+         || ! filter_path_prefixes.empty()
+         || ! filter_user_ids.empty();
+   }
 };
 
 
@@ -211,6 +229,7 @@ struct Conn_State
 
    bool requested_msn = false;
    bool requested_stream = false;
+   bool sent_filter = false;
 
    std::optional<uint64_t> startmsn;
 };
@@ -244,6 +263,11 @@ void write_u16(Packet_Buffer *packet, uint16_t value)
    write_data(packet, &value, sizeof value);
 }
 
+void write_u32(Packet_Buffer *packet, uint32_t value)
+{
+   write_data(packet, &value, sizeof value);
+}
+
 void write_u64(Packet_Buffer *packet, uint64_t value)
 {
    write_data(packet, &value, sizeof value);
@@ -285,7 +309,8 @@ static bool send_packet(Conn_State *conn, Packet_Buffer const *packet)
    return true;
 }
 
-static bool do_message(Conn_State *conn)
+// Sends the requests that are due in the current connection state.
+static bool send_requests(Conn_State *conn)
 {
    if (! conn->handshake_sent)
    {
@@ -300,6 +325,31 @@ static bool do_message(Conn_State *conn)
       conn->handshake_sent = true;
    }
 
+   if (conn->handshake_received && ! conn->sent_filter)
+   {
+      FileEventReceiverOptions const& options = conn->options;
+
+      if (options.have_filter())
+      {
+         Packet_Buffer packet;
+         write_header(&packet, Packet_Type::Request_Message_Filter);
+         write_u32(&packet, options.filter_type_mask);
+         write_u16(&packet, options.filter_path_prefixes.size());
+         for (std::string const& prefix : options.filter_path_prefixes)
+         {
+            write_u16(&packet, prefix.size());
+            write_data(&packet, prefix.data(), prefix.size());
+         }
+         write_u16(&packet, options.filter_user_ids.size());
+         for (uint32_t uid : options.filter_user_ids)
+            write_u32(&packet, uid);
+         if (! send_packet(conn, &packet))
+            return false;
+      }
+
+      conn->sent_filter = true;
+   }
+
    if (conn->handshake_received)
    {
       if (! conn->startmsn.has_value())
@@ -327,22 +377,15 @@ static bool do_message(Conn_State *conn)
       }
    }
 
-   ssize_t nr = read(conn->client_sock,
-         conn->receive_packet.data, sizeof conn->receive_packet.data);
-
-   if (nr < 0)
-   {
-      fatal_f("Error from read(): ", strerror(errno));
-   }
-
-   if (nr == 0)
-   {
-      msg_f("Conn %u was shut down", conn->conn_id);
-      return false;
-   }
+   return true;
+}
 
-   conn->receive_packet.size = nr;
-   char *buf = conn->receive_packet.data;
+// Handles a packet received from the server. *is_event is set if the packet
+// is an event message. Returns false if the connection can't go on, which
+// includes the case that the requested number of events was received.
+static bool process_packet(Conn_State *conn, char *buf, ssize_t nr, bool *is_event)
+{
+   *is_event = false;
 
    if (nr < 8 || memcmp(buf + 1, "events", 7) != 0)
    {
@@ -445,6 +488,13 @@ static bool do_message(Conn_State *conn)
    case Packet_Type::Send_Message:
    {
       //msg_f("Received message!");
+      if (nr < 18)
+      {
+         msg_f("Bad packet!");
+         return false;
+      }
+      // MSNs have gaps if the server filters events
+      conn->curmsn = *(uint64_t *) (buf + 8);
       break;
    }
    case Packet_Type::Send_Close:
@@ -498,6 +548,7 @@ static bool do_message(Conn_State *conn)
 
    conn->nmsgs++;
    conn->curmsn++;
+   *is_event = true;
 
    if (conn->options.nmsgs.has_value())
    {
@@ -508,6 +559,31 @@ static bool do_message(Conn_State *conn)
    return true;
 }
 
+static bool do_message(Conn_State *conn)
+{
+   if (! send_requests(conn))
+      return false;
+
+   ssize_t nr = read(conn->client_sock,
+         conn->receive_packet.data, sizeof conn->receive_packet.data);
+
+   if (nr < 0)
+   {
+      fatal_f("Error from read(): ", strerror(errno));
+   }
+
+   if (nr == 0)
+   {
+      msg_f("Conn %u was shut down", conn->conn_id);
+      return false;
+   }
+
+   conn->receive_packet.size = nr;
+
+   bool is_event;
+   return process_packet(conn, conn->receive_packet.data, nr, &is_event);
+}
+
 class Arg_Reader
 {
    int argc = 0;
@@ -528,6 +604,19 @@ public:
       assert(! eof());
       ++ index;
    }
+   bool parse_u32(uint32_t *value)
+   {
+      uint64_t v;
+      if (! parse_u64(&v))
+         return false;
+      if (v > UINT32_MAX)
+      {
+         msg_f("ERROR: Value out of range at command-line position %d", index - 1);
+         return false;
+      }
+      *value = (uint32_t) v;
+      return true;
+   }
    bool parse_u64(uint64_t *value)
    {
       if (eof())
@@ -589,6 +678,38 @@ static bool parse_options(int argc, const char **argv, FileEventReceiverOptions
             return false;
          options->nmsgs.emplace(value);
       }
+      else if (! strcmp(arg, "-filter-type"))
+      {
+         arg_reader.consume();
+         uint32_t value;
+         if (! arg_reader.parse_u32(&value))
+            return false;
+         if (value == 0 || value >= 32)
+         {
+            msg_f("Invalid event type: %" PRIu32, value);
+            return false;
+         }
+         options->filter_type_mask |= 1u << value;
+      }
+      else if (! strcmp(arg, "-filter-path"))
+      {
+         arg_reader.consume();
+         if (arg_reader.eof())
+         {
+            msg_f("ERROR: -filter-path requires a path prefix");
+            return false;
+         }
+         options->filter_path_prefixes.push_back(arg_reader.get());
+         arg_reader.consume();
+      }
+      else if (! strcmp(arg, "-filter-uid"))
+      {
+         arg_reader.consume();
+         uint32_t value;
+         if (! arg_reader.parse_u32(&value))
+            return false;
+         options->filter_user_ids.push_back(value);
+      }
       else
       {
          msg_f("Invalid arg: '%s'", arg);
@@ -599,12 +720,24 @@ static bool parse_options(int argc, const char **argv, FileEventReceiverOptions
 }
 
 
+// Buffers for receive_events(). All packets of a batch are received with a
+// single recvmmsg() call.
+struct Event_Batch
+{
+   Packet_Buffer packets[MAX_EVENT_BATCH_SIZE];
+   struct iovec iovs[MAX_EVENT_BATCH_SIZE];
+   struct mmsghdr msgs[MAX_EVENT_BATCH_SIZE];
+   Read_Event events[MAX_EVENT_BATCH_SIZE];
+   bool conn_ended = false;
+};
+
 struct FileEventReceiverNewProtocol
 {
    int server_sock = -1;
    int client_sock = -1;
    unsigned conn_id = 0;
    Conn_State conn;
+   Event_Batch batch;
 };
 
 
@@ -628,9 +761,8 @@ bool receive_event(FileEventReceiverNewProtocol *r)
    }
 }
 
-Read_Event get_event(FileEventReceiverNewProtocol *r)
+static Read_Event packet_event(Packet_Buffer *packet)
 {
-   Packet_Buffer *packet = &r->conn.receive_packet;
    Read_Event out;
    // 8 byte packet header (type Send_Message)
    // Send_Message packet:
@@ -642,6 +774,83 @@ Read_Event get_event(FileEventReceiverNewProtocol *r)
    return out;
 }
 
+Read_Event get_event(FileEventReceiverNewProtocol *r)
+{
+   return packet_event(&r->conn.receive_packet);
+}
+
+Read_Event_Batch receive_events(FileEventReceiverNewProtocol *r, size_t max_events)
+{
+   Conn_State *conn = &r->conn;
+   Event_Batch *batch = &r->batch;
+
+   if (max_events == 0 || max_events > MAX_EVENT_BATCH_SIZE)
+      max_events = MAX_EVENT_BATCH_SIZE;
+
+   size_t count = 0;
+
+   // control packets don't yield events, so keep going until there is at least one
+   while (count == 0 && ! batch->conn_ended)
+   {
+      if (! send_requests(conn))
+      {
+         batch->conn_ended = true;
+         break;
+      }
+
+      for (size_t i = 0; i < max_events; i++)
+      {
+         batch->iovs[i].iov_base = batch->packets[i].data;
+         batch->iovs[i].iov_len = sizeof batch->packets[i].data;
+         batch->msgs[i] = {};
+         batch->msgs[i].msg_hdr.msg_iov = &batch->iovs[i];
+         batch->msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      // blocks for the first packet only, then takes whatever else is queued
+      int nr_packets = recvmmsg(conn->client_sock, batch->msgs, max_events,
+            MSG_WAITFORONE, NULL);
+
+      if (nr_packets < 0)
+      {
+         if (errno == EINTR)
+            continue;
+
+         fatal_f("Error from recvmmsg(): %s", strerror(errno));
+      }
+
+      for (int i = 0; i < nr_packets; i++)
+      {
+         Packet_Buffer *packet = &batch->packets[i];
+         packet->size = batch->msgs[i].msg_len;
+
+         if (packet->size == 0)
+         {
+            msg_f("Conn %u was shut down", conn->conn_id);
+            batch->conn_ended = true;
+            break;
+         }
+
+         bool is_event;
+         bool conn_ok = process_packet(conn, packet->data, packet->size, &is_event);
+
+         if (is_event)
+            batch->events[count++] = packet_event(packet);
+
+         if (! conn_ok)
+         {
+            batch->conn_ended = true;
+            break;
+         }
+      }
+   }
+
+   Read_Event_Batch out;
+   out.events = batch->events;
+   out.count = count;
+   return out;
+}
+
 
 
 
@@ -724,7 +933,8 @@ FileEventReceiverNewProtocol *FileEventReceiverNewProtocolCreate(int argc, const
    if (! parse_options(argc, argv, &options))
    {
       //msg_f("Usage: ./seqpacket-reader <unix-socket-path> [-startmsn <MSN>] [-print]");
-      msg_f("Failed to parse options for FileEventReceiver. Syntax: <unix-socket-path> [-startmsn <MSN>]");
+      msg_f("Failed to parse options for FileEventReceiver. Syntax: <unix-socket-path> [-startmsn <MSN>]"
+            " [-filter-type <type>]... [-filter-path <prefix>]... [-filter-uid <uid>]...");
       return nullptr;
    }
 
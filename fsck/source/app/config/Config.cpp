@@ -72,6 +72,7 @@ void Config::loadDefaults(bool addDashes)
    configMapRedefine("connInterfacesFile", "", addDashes);
 
    configMapRedefine("tuneNumWorkers", "32", addDashes);
+   configMapRedefine("tuneNumCheckThreads", "0", addDashes);
    configMapRedefine("tunePreferredNodesFile", "", addDashes);
    configMapRedefine("tuneDbFragmentSize", "0", addDashes);
    configMapRedefine("tuneDentryCacheSize", "0", addDashes);
@@ -192,6 +193,8 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
          connInterfacesFile = iter->second;
       else if (testConfigMapKeyMatch(iter, "tuneNumWorkers", addDashes))
          tuneNumWorkers = StringTk::strToUInt(iter->second);
+      else if (testConfigMapKeyMatch(iter, "tuneNumCheckThreads", addDashes))
+         tuneNumCheckThreads = StringTk::strToUInt(iter->second);
       else if (testConfigMapKeyMatch(iter, "tunePreferredNodesFile", addDashes))
          tunePreferredNodesFile = iter->second;
       else if (testConfigMapKeyMatch(iter, "tuneDbFragmentSize", addDashes))
@@ -292,6 +295,12 @@ void Config::initImplicitVals()
    if (!tuneNumWorkers)
       tuneNumWorkers = BEEGFS_MAX(System::getNumOnlineCPUs() * 2, 4);
 
+   // tuneNumCheckThreads (checks run on the worker pool, so never use more than it has)
+   if (!tuneNumCheckThreads)
+      tuneNumCheckThreads = System::getNumOnlineCPUs();
+
+   tuneNumCheckThreads = BEEGFS_MIN(tuneNumCheckThreads, tuneNumWorkers);
+
    if (!tuneDbFragmentSize)
       tuneDbFragmentSize = uint64_t(sysconf(_SC_PHYS_PAGES) ) * sysconf(_SC_PAGESIZE) / 2;
 
@@ -68,6 +68,7 @@ class Config : public AbstractConfig
       std::string connInterfacesFile;
 
       unsigned    tuneNumWorkers;
+      unsigned    tuneNumCheckThreads;
       std::string tunePreferredNodesFile;
       size_t      tuneDbFragmentSize;
       size_t      tuneDentryCacheSize;
@@ -120,6 +121,11 @@ class Config : public AbstractConfig
          return tuneNumWorkers;
       }
 
+      unsigned getTuneNumCheckThreads() const
+      {
+         return tuneNumCheckThreads;
+      }
+
       size_t getTuneDbFragmentSize() const
       {
          return tuneDbFragmentSize;
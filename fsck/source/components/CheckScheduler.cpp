@@ -0,0 +1,157 @@
+#include "CheckScheduler.h"
+
+#include <common/components/worker/Work.h>
+
+#include <deque>
+#include <stdexcept>
+
+class CheckScheduler::CheckWork : public Work
+{
+   public:
+      CheckWork(CheckScheduler& scheduler, unsigned id)
+         : scheduler(scheduler), id(id)
+      {
+      }
+
+      void process(char* bufIn, unsigned bufInLen, char* bufOut, unsigned bufOutLen)
+      {
+         Node& node = scheduler.checks[id];
+
+         try
+         {
+            FsckTkEx::OutputCapture capture(node.output);
+            node.check();
+         }
+         catch (...)
+         {
+            node.error = std::current_exception();
+         }
+
+         scheduler.checkFinished(id);
+      }
+
+   private:
+      CheckScheduler& scheduler;
+      unsigned id;
+};
+
+CheckScheduler::CheckScheduler(MultiWorkQueue* workQueue, unsigned maxConcurrentChecks)
+   : workQueue(workQueue), maxConcurrentChecks(maxConcurrentChecks)
+{
+}
+
+unsigned CheckScheduler::add(Check check, const std::vector<unsigned>& dependencies)
+{
+   const unsigned id = checks.size();
+
+   Node node = { std::move(check), {}, 0, false, {}, {} };
+   checks.push_back(std::move(node) );
+
+   for (auto it = dependencies.begin(); it != dependencies.end(); ++it)
+   {
+      if (*it >= id)
+         throw std::logic_error("check depends on a check that was not added before it");
+
+      checks[*it].dependents.push_back(id);
+      checks[id].pendingDependencies++;
+   }
+
+   return id;
+}
+
+/*
+ * dependencies always point to checks added earlier, so the order of addition is a valid
+ * topological order of the graph.
+ */
+void CheckScheduler::runSequential()
+{
+   for (auto it = checks.begin(); it != checks.end(); ++it)
+      it->check();
+}
+
+void CheckScheduler::run()
+{
+   if (maxConcurrentChecks <= 1)
+   {
+      runSequential();
+      return;
+   }
+
+   std::deque<unsigned> ready;
+   unsigned running = 0;
+   unsigned nextOutput = 0;
+   std::exception_ptr error;
+
+   for (unsigned i = 0; i < checks.size(); i++)
+   {
+      if (checks[i].pendingDependencies == 0)
+         ready.push_back(i);
+   }
+
+   while (true)
+   {
+      while (!error && running < maxConcurrentChecks && !ready.empty() )
+      {
+         workQueue->addIndirectWork(new CheckWork(*this, ready.front() ) );
+         ready.pop_front();
+         running++;
+      }
+
+      if (running == 0)
+         break;
+
+      std::vector<unsigned> finished;
+
+      {
+         const std::lock_guard<Mutex> lock(mutex);
+
+         while (finishedChecks.empty() )
+            finishedCond.wait(&mutex);
+
+         finished.swap(finishedChecks);
+      }
+
+      for (auto it = finished.begin(); it != finished.end(); ++it)
+      {
+         Node& node = checks[*it];
+
+         running--;
+         node.done = true;
+
+         for (auto dep = node.dependents.begin(); dep != node.dependents.end(); ++dep)
+         {
+            if (--checks[*dep].pendingDependencies == 0)
+               ready.push_back(*dep);
+         }
+      }
+
+      // print everything that is complete up to the first check that is still outstanding
+      while (nextOutput < checks.size() && checks[nextOutput].done)
+      {
+         Node& node = checks[nextOutput];
+
+         FsckTkEx::replayOutput(node.output);
+         node.output.clear();
+
+         if (node.error && !error)
+            error = node.error;
+
+         nextOutput++;
+      }
+
+      // a failed check whose output is not due yet still stops the schedule
+      for (auto it = finished.begin(); it != finished.end() && !error; ++it)
+         error = checks[*it].error;
+   }
+
+   if (error)
+      std::rethrow_exception(error);
+}
+
+void CheckScheduler::checkFinished(unsigned id)
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   finishedChecks.push_back(id);
+   finishedCond.signal();
+}
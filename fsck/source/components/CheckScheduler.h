@@ -0,0 +1,67 @@
+#ifndef CHECKSCHEDULER_H_
+#define CHECKSCHEDULER_H_
+
+#include <common/components/worker/queue/MultiWorkQueue.h>
+#include <common/threading/Condition.h>
+#include <common/threading/Mutex.h>
+#include <toolkit/FsckTkEx.h>
+
+#include <exception>
+#include <functional>
+#include <vector>
+
+/*
+ * runs a set of database checks as a dependency graph. a check is started as soon as all checks it
+ * depends on have finished; independent checks run concurrently on the worker pool.
+ *
+ * the output of every check is captured while it runs and printed in the order in which the
+ * checks were added, so the result looks exactly like that of a sequential run. if a check throws,
+ * no further checks are started and the exception is rethrown from run() once all running checks
+ * have finished.
+ *
+ * with maxConcurrentChecks <= 1, all checks run in the calling thread in the order they were added
+ * and their output is not captured (repairs prompt the user, which must happen immediately).
+ */
+class CheckScheduler
+{
+   public:
+      typedef std::function<void()> Check;
+
+      CheckScheduler(MultiWorkQueue* workQueue, unsigned maxConcurrentChecks);
+
+      /*
+       * @param dependencies ids of checks that must have finished before this one is started.
+       *    a check may only depend on checks that were added before it.
+       * @return id of the new check
+       */
+      unsigned add(Check check, const std::vector<unsigned>& dependencies = {});
+
+      void run();
+
+   private:
+      class CheckWork;
+
+      struct Node
+      {
+         Check check;
+         std::vector<unsigned> dependents;
+         unsigned pendingDependencies;
+         bool done;
+
+         FsckTkEx::CapturedOutput output;
+         std::exception_ptr error;
+      };
+
+      MultiWorkQueue* workQueue;
+      unsigned maxConcurrentChecks;
+      std::vector<Node> checks;
+
+      Mutex mutex;
+      Condition finishedCond;
+      std::vector<unsigned> finishedChecks; // finished, but not yet seen by run()
+
+      void runSequential();
+      void checkFinished(unsigned id);
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+/*
+ * batch-at-a-time protocol for query sources
+ *
+ * in addition to step()/get(), every source provides
+ *
+ *    bool nextBatch(std::vector<ElementType>& batch);
+ *
+ * which replaces the contents of batch with the next run of rows. it returns false (and leaves
+ * batch empty) once the source is exhausted, a call that returns true always yields at least one
+ * row. rows of a batch (and everything they point to) stay valid until the next call to
+ * nextBatch() on the same source. a source must be consumed either with step()/get() or with
+ * nextBatch(), never both.
+ *
+ * operators that copy rows of an input into their own output must not refill that input while
+ * their output batch is non-empty, otherwise pointers held by the copied rows may be invalidated
+ * before the consumer sees them.
+ */
+namespace db {
+
+static const size_t BATCH_SIZE = 1024;
+
+/*
+ * cursor over the batches of a source. does not own the source to keep operators that hold both
+ * a row-mode and a batch-mode view of their input from copying it.
+ */
+template<typename Row>
+class BatchBuffer
+{
+   public:
+      BatchBuffer()
+         : pos(0), exhausted(false)
+      {
+      }
+
+      bool drained() const
+      {
+         return pos >= rows.size();
+      }
+
+      bool ended() const
+      {
+         return exhausted;
+      }
+
+      template<typename Source>
+      bool refill(Source& source)
+      {
+         pos = 0;
+
+         if (exhausted || !source.nextBatch(rows))
+         {
+            rows.clear();
+            exhausted = true;
+            return false;
+         }
+
+         return true;
+      }
+
+      Row& current()
+      {
+         return rows[pos];
+      }
+
+      void advance()
+      {
+         pos++;
+      }
+
+   private:
+      std::vector<Row> rows;
+      size_t pos;
+      bool exhausted;
+};
+
+/*
+ * rows produced by joins point to rows of the right-hand input, which are only valid until that
+ * input produces its next batch. operators that keep rows across batches of their input use
+ * RowDetach to copy everything reachable from such a row. the returned handle keeps the copies
+ * alive, it is empty for plain value rows.
+ */
+template<typename Row>
+struct RowDetach
+{
+   static boost::shared_ptr<void> detach(Row& row)
+   {
+      return boost::shared_ptr<void>();
+   }
+};
+
+template<typename First, typename Second>
+struct RowDetach<std::pair<First, Second> >
+{
+   static boost::shared_ptr<void> detach(std::pair<First, Second>& row)
+   {
+      boost::shared_ptr<void> keepFirst = RowDetach<First>::detach(row.first);
+      boost::shared_ptr<void> keepSecond = RowDetach<Second>::detach(row.second);
+
+      if (!keepFirst)
+         return keepSecond;
+
+      if (!keepSecond)
+         return keepFirst;
+
+      return boost::make_shared<std::pair<boost::shared_ptr<void>, boost::shared_ptr<void> > >(
+         keepFirst, keepSecond);
+   }
+};
+
+template<typename First, typename Second>
+struct RowDetach<std::pair<First, Second*> >
+{
+   static boost::shared_ptr<void> detach(std::pair<First, Second*>& row)
+   {
+      typedef std::pair<Second, std::pair<boost::shared_ptr<void>, boost::shared_ptr<void> > >
+         Holder;
+
+      boost::shared_ptr<void> keepFirst = RowDetach<First>::detach(row.first);
+
+      if (!row.second)
+         return keepFirst;
+
+      boost::shared_ptr<Holder> holder = boost::make_shared<Holder>();
+
+      holder->first = *row.second;
+      holder->second.first = RowDetach<Second>::detach(holder->first);
+      holder->second.second = keepFirst;
+
+      row.second = &holder->first;
+      return holder;
+   }
+};
+
+}
+
+#endif
@@ -1,23 +1,75 @@
 #ifndef CURSOR_H_
 #define CURSOR_H_
 
+#include <database/Batch.h>
+
+#include <vector>
+
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
+/*
+ * type-erased query cursor. the wrapped pipeline is always driven in batch mode, so only one
+ * virtual call is made per batch; step() and get() walk the current batch without indirection.
+ */
 template<typename Obj>
 class Cursor
 {
    public:
       typedef Obj ElementType;
 
+      // a cursor can be read by other operators, but it can't be repositioned, so it can't be the
+      // right side of a join (the operators that need it instantiate mark() and restore() only then)
+      struct MarkerType {};
+
    private:
       class SourceBase
       {
          public:
+            SourceBase()
+               : pos(0)
+            {
+            }
+
             virtual ~SourceBase() {}
 
-            virtual bool step() = 0;
-            virtual ElementType* get() = 0;
+            virtual bool fetch(std::vector<ElementType>& batch) = 0;
+
+            bool step()
+            {
+               if(pos + 1 < batch.size() )
+               {
+                  pos++;
+                  return true;
+               }
+
+               pos = 0;
+               return fetch(batch);
+            }
+
+            ElementType* get()
+            {
+               return &batch[pos];
+            }
+
+            bool nextBatch(std::vector<ElementType>& out)
+            {
+               if(pos + 1 < batch.size() )
+               {
+                  out.assign(batch.begin() + pos + 1, batch.end() );
+                  batch.clear();
+                  pos = 0;
+                  return true;
+               }
+
+               batch.clear();
+               pos = 0;
+               return fetch(out);
+            }
+
+         private:
+            std::vector<ElementType> batch;
+            size_t pos;
       };
 
       template<typename Inner>
@@ -29,14 +81,9 @@ class Cursor
             {
             }
 
-            bool step()
+            bool fetch(std::vector<ElementType>& batch)
             {
-               return inner.step();
-            }
-
-            ElementType* get()
-            {
-               return inner.get();
+               return inner.nextBatch(batch);
             }
 
          private:
@@ -60,6 +107,22 @@ class Cursor
          return source->get();
       }
 
+      bool nextBatch(std::vector<ElementType>& batch)
+      {
+         return source->nextBatch(batch);
+      }
+
+      MarkerType mark() const
+      {
+         static_assert(sizeof(Obj) == 0, "cursors can't be repositioned");
+         return MarkerType();
+      }
+
+      void restore(MarkerType mark)
+      {
+         static_assert(sizeof(Obj) == 0, "cursors can't be repositioned");
+      }
+
    private:
       boost::shared_ptr<SourceBase> source;
 };
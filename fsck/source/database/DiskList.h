@@ -3,6 +3,7 @@
 
 #include <common/threading/Mutex.h>
 #include <common/toolkit/serialization/Serialization.h>
+#include <database/Batch.h>
 
 #include <cerrno>
 #include <stdexcept>
@@ -68,6 +69,16 @@ class DiskListCursor
          return &item;
       }
 
+      bool nextBatch(std::vector<Data>& batch)
+      {
+         batch.clear();
+
+         while(batch.size() < db::BATCH_SIZE && step() )
+            batch.push_back(item);
+
+         return !batch.empty();
+      }
+
    private:
       int fd;
       size_t offset;
@@ -1,6 +1,10 @@
 #ifndef DISTINCT_H_
 #define DISTINCT_H_
 
+#include <database/Batch.h>
+
+#include <vector>
+
 #include <boost/type_traits/decay.hpp>
 #include <boost/utility/result_of.hpp>
 
@@ -42,6 +46,35 @@ class Distinct
          return this->source.get();
       }
 
+      bool nextBatch(std::vector<ElementType>& batch)
+      {
+         while(this->source.nextBatch(batch) )
+         {
+            size_t kept = 0;
+
+            for(size_t i = 0; i < batch.size(); i++)
+            {
+               if(this->hasKey && this->key == this->keyExtract(batch[i]) )
+                  continue;
+
+               this->hasKey = true;
+               this->key = this->keyExtract(batch[i]);
+
+               if(kept != i)
+                  batch[kept] = batch[i];
+
+               kept++;
+            }
+
+            batch.erase(batch.begin() + kept, batch.end() );
+
+            if(!batch.empty() )
+               return true;
+         }
+
+         return false;
+      }
+
       MarkerType mark() const
       {
          return this->source.mark();
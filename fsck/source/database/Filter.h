@@ -1,6 +1,10 @@
 #ifndef FILTER_H_
 #define FILTER_H_
 
+#include <database/Batch.h>
+
+#include <vector>
+
 template<typename Source, class Pred>
 class Filter
 {
@@ -30,6 +34,32 @@ class Filter
          return this->source.get();
       }
 
+      bool nextBatch(std::vector<ElementType>& batch)
+      {
+         while(this->source.nextBatch(batch) )
+         {
+            size_t kept = 0;
+
+            for(size_t i = 0; i < batch.size(); i++)
+            {
+               if(!this->pred(batch[i]) )
+                  continue;
+
+               if(kept != i)
+                  batch[kept] = batch[i];
+
+               kept++;
+            }
+
+            batch.erase(batch.begin() + kept, batch.end() );
+
+            if(!batch.empty() )
+               return true;
+         }
+
+         return false;
+      }
+
       MarkerType mark() const
       {
          return this->source.mark();
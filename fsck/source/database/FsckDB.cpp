@@ -22,7 +22,11 @@ FsckDB::FsckDB(const std::string& databasePath, size_t fragmentSize, size_t name
      usedTargetIDsTable(new FsckDBUsedTargetIDsTable(databasePath, fragmentSize, allowCreate) ),
      modificationEventsTable(new FsckDBModificationEventsTable(databasePath, fragmentSize,
          allowCreate) ),
-     malformedChunks(databasePath + "/malformedChunks")
+     malformedChunks(databasePath + "/malformedChunks"),
+     sharedDentries(databasePath + "/shared.dentries"),
+     sharedFileInodes(databasePath + "/shared.fileinodes"),
+     sharedDirInodes(databasePath + "/shared.dirinodes"),
+     sharedChunks(databasePath + "/shared.chunks")
 {
 }
 
@@ -38,3 +42,28 @@ void FsckDB::clear()
    this->modificationEventsTable->clear();
    this->malformedChunks.clear();
 }
+
+void FsckDB::addSharedTableConsumer(SharedTable table)
+{
+   switch (table)
+   {
+      case SharedTable_DENTRIES: sharedDentries.addConsumer(); break;
+      case SharedTable_FILEINODES: sharedFileInodes.addConsumer(); break;
+      case SharedTable_DIRINODES: sharedDirInodes.addConsumer(); break;
+      case SharedTable_CHUNKS: sharedChunks.addConsumer(); break;
+   }
+}
+
+/*
+ * the copy of the table is removed when its last consumer was released
+ */
+void FsckDB::releaseSharedTableConsumer(SharedTable table)
+{
+   switch (table)
+   {
+      case SharedTable_DENTRIES: sharedDentries.releaseConsumer(); break;
+      case SharedTable_FILEINODES: sharedFileInodes.releaseConsumer(); break;
+      case SharedTable_DIRINODES: sharedDirInodes.releaseConsumer(); break;
+      case SharedTable_CHUNKS: sharedChunks.releaseConsumer(); break;
+   }
+}
@@ -20,6 +20,7 @@
 #include <common/nodes/TargetMapper.h>
 #include <common/storage/striping/StripePattern.h>
 #include <common/storage/StorageDefinitions.h>
+#include <database/Chunk.h>
 #include <database/ContDir.h>
 #include <database/Cursor.h>
 #include <database/DirEntry.h>
@@ -28,6 +29,7 @@
 #include <database/EntryID.h>
 #include <database/FileInode.h>
 #include <database/Filter.h>
+#include <database/SharedSet.h>
 #include <database/VectorSource.h>
 #include <toolkit/FsckDefinitions.h>
 
@@ -82,6 +84,23 @@ class FsckDB
 
       void clear();
 
+      /*
+       * tables that several checks read in the same order, without the entries that were modified
+       * while the data was fetched. while a table has registered consumers, its rows are copied
+       * once and all checks read that copy, instead of merging the table and filtering out the
+       * modified entries again for every check. rows are ordered by the primary key of the table.
+       */
+      enum SharedTable
+      {
+         SharedTable_DENTRIES,
+         SharedTable_FILEINODES,
+         SharedTable_DIRINODES,
+         SharedTable_CHUNKS,
+      };
+
+      void addSharedTableConsumer(SharedTable table);
+      void releaseSharedTableConsumer(SharedTable table);
+
       // FsckDBChecks.cpp
       Cursor<checks::DuplicatedInode> findDuplicateInodeIDs();
       Cursor<std::list<FsckChunk> > findDuplicateChunks();
@@ -128,6 +147,17 @@ class FsckDB
       boost::scoped_ptr<FsckDBModificationEventsTable> modificationEventsTable;
       DiskList<FsckChunk> malformedChunks;
 
+      SharedSet<db::DirEntry> sharedDentries;
+      SharedSet<db::FileInode> sharedFileInodes;
+      SharedSet<db::DirInode> sharedDirInodes;
+      SharedSet<db::Chunk> sharedChunks;
+
+      // FsckDBChecks.cpp
+      Cursor<db::DirEntry> unmodifiedDentries();
+      Cursor<db::FileInode> unmodifiedFileInodes();
+      Cursor<db::DirInode> unmodifiedDirInodes();
+      Cursor<db::Chunk> unmodifiedChunks();
+
    public:
       FsckDBDentryTable* getDentryTable()
       {
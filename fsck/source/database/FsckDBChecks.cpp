@@ -178,6 +178,38 @@ static bool isNotDisposal(db::DirInode& inode)
    return !inode.id.isDisposalDir();
 }
 
+/*
+ * the tables without entries that were modified while fetching the data. each of them is read by
+ * several checks, so they are shared (see SharedTable) while checks run concurrently.
+ */
+Cursor<db::DirEntry> FsckDB::unmodifiedDentries()
+{
+   return sharedDentries.get(
+      this->dentryTable->get()
+      | ignoreByID(this->modificationEventsTable->get() ) );
+}
+
+Cursor<db::FileInode> FsckDB::unmodifiedFileInodes()
+{
+   return sharedFileInodes.get(
+      this->fileInodesTable->getInodes()
+      | ignoreByID(this->modificationEventsTable->get() ) );
+}
+
+Cursor<db::DirInode> FsckDB::unmodifiedDirInodes()
+{
+   return sharedDirInodes.get(
+      this->dirInodesTable->get()
+      | ignoreByID(this->modificationEventsTable->get() ) );
+}
+
+Cursor<db::Chunk> FsckDB::unmodifiedChunks()
+{
+   return sharedChunks.get(
+      this->chunksTable->get()
+      | ignoreByID(this->modificationEventsTable->get() ) );
+}
+
 namespace {
 struct DuplicateIDGroup
 {
@@ -263,12 +295,10 @@ Cursor<checks::DuplicatedInode> FsckDB::findDuplicateInodeIDs()
    return cursor(
       db::unionBy(
          id,
-         this->dirInodesTable->get()
+         this->unmodifiedDirInodes()
          | db::where(isNotDisposal)
-         | ignoreByID(this->modificationEventsTable->get())
          | db::select(ops::idAndTargetD),
-         this->fileInodesTable->getInodes()
-         | ignoreByID(this->modificationEventsTable->get())
+         this->unmodifiedFileInodes()
          | db::select(ops::idAndTargetF) )
       | db::groupBy(DuplicateIDGroup() )
       | db::where(ops::hasDuplicateID) );
@@ -348,8 +378,7 @@ Cursor<std::list<FsckChunk> > FsckDB::findDuplicateChunks()
    };
 
    return cursor(
-      this->chunksTable->get()
-      | ignoreByID(this->modificationEventsTable->get())
+      this->unmodifiedChunks()
       | db::groupBy(DuplicateChunkGroup())
       | db::where(ops::hasDuplicateChunks)
       | db::select(ops::second));
@@ -455,8 +484,7 @@ Cursor<db::DirEntry> FsckDB::findMismirroredDentries()
          objectID,
          db::leftJoinBy(
             objectID,
-            dentryTable->get()
-            | ignoreByID(modificationEventsTable->get())
+            unmodifiedDentries()
             | db::where(dentryIsNotDirectory),
             fileInodesTable->getInodes())
          | db::where(secondIsNotNull)
@@ -464,8 +492,7 @@ Cursor<db::DirEntry> FsckDB::findMismirroredDentries()
          | db::select(first),
          db::leftJoinBy(
             objectID,
-            dentryTable->get()
-            | ignoreByID(modificationEventsTable->get())
+            unmodifiedDentries()
             | db::where(dentryIsDirectory),
             dirInodesTable->get())
          | db::where(secondIsNotNull)
@@ -484,8 +511,7 @@ Cursor<db::FileInode> FsckDB::findMismirroredFiles()
    };
 
    return cursor(
-      fileInodesTable->getInodes()
-      | ignoreByID(modificationEventsTable->get())
+      unmodifiedFileInodes()
       | db::where(ops::mismirrored));
 }
 
@@ -502,8 +528,7 @@ Cursor<db::DirInode> FsckDB::findMismirroredDirectories()
    return cursor(
       db::leftJoinBy(
          objectID,
-         dirInodesTable->get()
-         | ignoreByID(modificationEventsTable->get()),
+         unmodifiedDirInodes(),
          contDirsTable->get())
       | db::where(secondIsNotNull)
       | db::where(ops::dirMismirrored)
@@ -521,16 +546,14 @@ Cursor<db::DirEntry> FsckDB::findDanglingDirEntries()
          objectID,
          db::leftJoinBy(
             objectID,
-            this->dentryTable->get()
-            | ignoreByID(this->modificationEventsTable->get() )
+            this->unmodifiedDentries()
             | db::where(dentryIsNotDirectory),
             this->fileInodesTable->getInodes() )
          | db::where(secondIsNull)
          | db::select(first),
          db::leftJoinBy(
             objectID,
-            this->dentryTable->get()
-            | ignoreByID(this->modificationEventsTable->get() )
+            this->unmodifiedDentries()
             | db::where(dentryIsDirectory),
             this->dirInodesTable->get() )
          | db::where(secondIsNull)
@@ -574,16 +597,14 @@ Cursor<std::pair<db::DirEntry, NumNodeID> > FsckDB::findDirEntriesWithWrongOwner
          firstObjectID,
          joinBy(
             objectID,
-            this->dentryTable->get()
-            | ignoreByID(this->modificationEventsTable->get() )
+            this->unmodifiedDentries()
             | db::where(dentryIsNotDirectory),
             this->fileInodesTable->getInodes() )
          | db::where(ops::fileInodeOwnerIncorrect)
          | db::select(ops::resultF),
          joinBy(
             objectID,
-            this->dentryTable->get()
-            | ignoreByID(this->modificationEventsTable->get() )
+            this->unmodifiedDentries()
             | db::where(dentryIsDirectory),
             this->dirInodesTable->get() )
          | db::where(ops::dirInodeOwnerIncorrect)
@@ -607,8 +628,7 @@ Cursor<FsckDirInode> FsckDB::findInodesWithWrongOwner()
    };
 
    return Cursor<FsckDirInode>(
-      this->dirInodesTable->get()
-      | ignoreByID(this->modificationEventsTable->get() )
+      this->unmodifiedDirInodes()
       | db::where(ops::inodeHasWrongOwner)
       | convertTo<FsckDirInode>() );
 }
@@ -652,8 +672,7 @@ Cursor<db::DirEntry> FsckDB::findDirEntriesWithBrokenByIDFile()
    return cursor(
       db::leftJoinBy(
          JoinDirEntriesWithBrokenByIDFile(),
-         this->dentryTable->get()
-         | ignoreByID(this->modificationEventsTable->get() ),
+         this->unmodifiedDentries(),
          this->fsIDsTable->get() )
       | db::where(ops::fsidFileMissing)
       | db::select(first) );
@@ -711,8 +730,7 @@ Cursor<FsckDirInode> FsckDB::findOrphanedDirInodes()
    return Cursor<FsckDirInode>(
       db::leftJoinBy(
          objectID,
-         this->dirInodesTable->get()
-         | ignoreByID(this->modificationEventsTable->get() ),
+         this->unmodifiedDirInodes(),
          this->dentryTable->get() )
       | db::where(ops::inodeHasNoDentry)
       | db::select(first)
@@ -735,8 +753,7 @@ Cursor<FsckFileInode> FsckDB::findOrphanedFileInodes()
    return Cursor<FsckFileInode>(
       db::leftJoinBy(
          objectID,
-         this->fileInodesTable->getInodes()
-         | ignoreByID(this->modificationEventsTable->get() ),
+         this->unmodifiedFileInodes(),
          this->dentryTable->get() )
       | db::where(secondIsNull)
       | db::select(first)
@@ -817,8 +834,7 @@ Cursor<FsckChunk> FsckDB::findOrphanedChunks()
    return Cursor<FsckChunk>(
       db::leftJoinBy(
          OrphanedChunksJoin(),
-         this->chunksTable->get()
-         | ignoreByID(this->modificationEventsTable->get() ),
+         this->unmodifiedChunks(),
          db::leftJoinBy(
             objectID,
             fileInodesTable->getInodes(),
@@ -837,8 +853,7 @@ Cursor<FsckDirInode> FsckDB::findInodesWithoutContDir()
    return Cursor<FsckDirInode>(
       db::leftJoinBy(
          objectID,
-         this->dirInodesTable->get()
-         | ignoreByID(this->modificationEventsTable->get() ),
+         this->unmodifiedDirInodes(),
          this->contDirsTable->get() )
       | db::where(secondIsNull)
       | db::select(first)
@@ -1129,8 +1144,7 @@ Cursor<std::pair<FsckFileInode, checks::OptionalInodeAttribs> > FsckDB::findWron
             JoinWithStripedInode(),
             db::leftJoinBy(
                objectID,
-               this->fileInodesTable->getInodes()
-               | ignoreByID(this->modificationEventsTable->get() ),
+               this->unmodifiedFileInodes(),
                this->fileInodesTable->getTargets() ),
             this->chunksTable->get() )
          | db::groupBy(FindWrongInodeFileAttribsGrouperChunks() )
@@ -1138,8 +1152,7 @@ Cursor<std::pair<FsckFileInode, checks::OptionalInodeAttribs> > FsckDB::findWron
          | db::select(ops::fileAttribs),
          db::leftJoinBy(
             objectID,
-            this->fileInodesTable->getInodes()
-            | ignoreByID(this->modificationEventsTable->get() ),
+            this->unmodifiedFileInodes(),
             this->dentryTable->get()
             | db::where(ops::dentryNotInDisposal) )
          | db::groupBy(FindWrongInodeFileAttribsGrouperDentry() )
@@ -1222,8 +1235,7 @@ Cursor<std::pair<FsckDirInode, checks::InodeAttribs> > FsckDB::findWrongInodeDir
    return cursor(
       db::leftJoinBy(
          JoinWrongInodeDirAttribs(),
-         this->dirInodesTable->get()
-         | ignoreByID(this->modificationEventsTable->get() )
+         this->unmodifiedDirInodes()
          | db::where(isNotDisposal),
          this->dentryTable->getByParent() )
       | db::groupBy(WrongDirInodeGrouper() )
@@ -1299,8 +1311,10 @@ Cursor<db::DirEntry> FsckDB::findFilesWithMissingStripeTargets(TargetMapper* tar
 
    {
       SetFragmentCursor<db::UsedTarget> c = this->usedTargetIDsTable->get();
-      while(c.step() )
-         usedTargets.push_back(*c.get() );
+      std::vector<db::UsedTarget> batch;
+
+      while(c.nextBatch(batch) )
+         usedTargets.insert(usedTargets.end(), batch.begin(), batch.end() );
    }
 
    for(FsckTargetIDListIter it = usedTargets.begin(); it != usedTargets.end(); ++it)
@@ -1359,8 +1373,7 @@ Cursor<std::pair<FsckChunk, FsckFileInode> > FsckDB::findChunksWithWrongPermissi
    return cursor(
       joinBy(
          objectID,
-         this->chunksTable->get()
-         | ignoreByID(this->modificationEventsTable->get() ),
+         this->unmodifiedChunks(),
          this->fileInodesTable->getInodes() )
       | db::where(ops::chunkHasWrongPermissions)
       | db::select(ops::result) );
@@ -1392,8 +1405,7 @@ Cursor<std::pair<FsckChunk, FsckFileInode> > FsckDB::findChunksInWrongPath()
    return cursor(
       joinBy(
          objectID,
-         this->chunksTable->get()
-         | ignoreByID(this->modificationEventsTable->get() ),
+         this->unmodifiedChunks(),
          this->fileInodesTable->getInodes() )
       | db::where(ops::chunkInWrongPath)
       | db::select(ops::result) );
@@ -1413,7 +1425,6 @@ Cursor<db::FileInode> FsckDB::findFilesWithMultipleHardlinks()
    };
 
    return cursor(
-      fileInodesTable->getInodes()
-      | ignoreByID(modificationEventsTable->get())
+      unmodifiedFileInodes()
       | db::where(ops::hasMultipleHardlinks));
 }
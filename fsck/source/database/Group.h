@@ -1,9 +1,12 @@
 #ifndef GROUP_H_
 #define GROUP_H_
 
+#include <database/Batch.h>
+
 #include <boost/utility/result_of.hpp>
 
 #include <utility>
+#include <vector>
 
 /*
  * requires Ops : struct {
@@ -34,7 +37,7 @@ class Group
 
    public:
       Group(Source source, Ops ops)
-         : source(source), ops(ops), sourceIsActive(false)
+         : source(source), ops(ops), sourceIsActive(false), inGroup(false)
       {
       }
 
@@ -52,6 +55,43 @@ class Group
          return &current;
       }
 
+      bool nextBatch(std::vector<ElementType>& batch)
+      {
+         batch.clear();
+         this->batchKeep.clear();
+
+         while(batch.size() < db::BATCH_SIZE)
+         {
+            if(this->input.drained() && !this->input.refill(this->source) )
+            {
+               if(this->inGroup)
+                  finishBatchGroup(batch);
+
+               break;
+            }
+
+            typename Source::ElementType& row = this->input.current();
+            KeyType key = this->ops.key(row);
+
+            if(this->inGroup && !(this->groupKey == key) )
+               finishBatchGroup(batch);
+
+            if(!this->inGroup)
+            {
+               // the group may span several input batches, so it must not point into them
+               this->current.first = this->ops.project(row);
+               this->currentKeep = db::RowDetach<ProjType>::detach(this->current.first);
+               this->groupKey = key;
+               this->inGroup = true;
+            }
+
+            this->ops.step(row);
+            this->input.advance();
+         }
+
+         return !batch.empty();
+      }
+
       MarkerType mark() const
       {
           return this->currentMark;
@@ -96,12 +136,30 @@ class Group
          this->current.second = this->ops.finish();
       }
 
+      void finishBatchGroup(std::vector<ElementType>& batch)
+      {
+         this->current.second = this->ops.finish();
+         batch.push_back(this->current);
+
+         if(this->currentKeep)
+            this->batchKeep.push_back(this->currentKeep);
+
+         this->currentKeep.reset();
+         this->inGroup = false;
+      }
+
    private:
       Source source;
       Ops ops;
       ElementType current;
       typename Source::MarkerType currentMark;
       bool sourceIsActive;
+
+      db::BatchBuffer<typename Source::ElementType> input;
+      bool inGroup;
+      KeyType groupKey;
+      boost::shared_ptr<void> currentKeep;
+      std::vector<boost::shared_ptr<void> > batchKeep;
 };
 
 
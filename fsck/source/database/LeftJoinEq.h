@@ -2,9 +2,12 @@
 #define LEFTJOINEQ_H_
 
 #include <common/Common.h>
+#include <database/Batch.h>
 
 #include <cstddef>
+#include <deque>
 #include <utility>
+#include <vector>
 
 #include <boost/type_traits/decay.hpp>
 #include <boost/utility/result_of.hpp>
@@ -14,6 +17,7 @@ class LeftJoinEq
 {
    private:
       enum State {
+         s_start,
          s_next_left,
          s_first_right,
          s_next_right,
@@ -42,17 +46,21 @@ class LeftJoinEq
 
    public:
       LeftJoinEq(Left left, Right right, KeyExtract keyExtract)
-         : left(left), right(right), keyExtract(keyExtract), state(s_next_left),
-           hasRightMark(false)
+         : left(left), right(right), keyExtract(keyExtract), state(s_start),
+           hasRightMark(false), hasGroupKey(false), groupBegin(0), groupEnd(0)
       {
-         if(!this->right.step() )
-            this->state = s_only_left;
       }
 
       bool step()
       {
          switch(this->state)
          {
+            // the right side is positioned lazily, a join consumed with nextBatch() must not
+            // have stepped its inputs
+            case s_start:
+               this->state = this->right.step() ? s_next_left : s_only_left;
+               return step();
+
             case s_only_left:
                if(!this->left.step() )
                   return false;
@@ -123,6 +131,45 @@ class LeftJoinEq
          return &current;
       }
 
+      /*
+       * in batch mode, the right-hand rows matching the current left key are copied into storage
+       * owned by the join instead of being re-read through mark()/restore(). rows of the output
+       * batch point into this storage.
+       */
+      bool nextBatch(std::vector<ElementType>& batch)
+      {
+         batch.clear();
+         releaseStoredRows();
+
+         while(batch.size() < db::BATCH_SIZE)
+         {
+            if(this->leftRows.drained() )
+            {
+               // left rows copied into the batch may point into the current left batch
+               if(!batch.empty() || !this->leftRows.refill(this->left) )
+                  break;
+            }
+
+            typename Left::ElementType& leftRow = this->leftRows.current();
+            const LeftKey key = this->keyExtract(leftRow);
+
+            if(!this->hasGroupKey || !(key == this->groupKey) )
+               loadRightGroup(key);
+
+            if(this->groupBegin == this->groupEnd)
+               batch.push_back(ElementType(leftRow, nullptr) );
+            else
+            {
+               for(size_t i = this->groupBegin; i < this->groupEnd; i++)
+                  batch.push_back(ElementType(leftRow, &this->storedRows[i].row) );
+            }
+
+            this->leftRows.advance();
+         }
+
+         return !batch.empty();
+      }
+
       MarkerType mark() const
       {
          MarkerType result = { this->left.mark(), this->right.mark(), this->state,
@@ -161,6 +208,47 @@ class LeftJoinEq
          return true;
       }
 
+      void loadRightGroup(const LeftKey& key)
+      {
+         this->groupBegin = this->groupEnd = this->storedRows.size();
+         this->groupKey = key;
+         this->hasGroupKey = true;
+
+         while(!this->rightRows.drained() || this->rightRows.refill(this->right) )
+         {
+            typename Right::ElementType& rightRow = this->rightRows.current();
+            const RightKey rightKey = this->keyExtract(rightRow);
+
+            if(rightKey < key)
+            {
+               this->rightRows.advance();
+               continue;
+            }
+
+            if(!(key == rightKey) )
+               break;
+
+            // the group may outlive the right batch it was read from
+            this->storedRows.push_back(StoredRow() );
+            this->storedRows.back().row = rightRow;
+            this->storedRows.back().keep =
+               db::RowDetach<typename Right::ElementType>::detach(this->storedRows.back().row);
+
+            this->groupEnd++;
+            this->rightRows.advance();
+         }
+      }
+
+      void releaseStoredRows()
+      {
+         // only the current group may be referenced by the next batch
+         this->storedRows.erase(this->storedRows.begin(),
+            this->storedRows.begin() + this->groupBegin);
+
+         this->groupEnd -= this->groupBegin;
+         this->groupBegin = 0;
+      }
+
       LeftKey leftKey() { return this->keyExtract(*this->left.get() ); }
       RightKey rightKey() { return this->keyExtract(*this->right.get() ); }
 
@@ -174,6 +262,20 @@ class LeftJoinEq
       bool hasRightMark;
       RightKey rightKeyAtMark;
       typename Right::MarkerType rightMark;
+
+      struct StoredRow
+      {
+         typename Right::ElementType row;
+         boost::shared_ptr<void> keep;
+      };
+
+      db::BatchBuffer<typename Left::ElementType> leftRows;
+      db::BatchBuffer<typename Right::ElementType> rightRows;
+      bool hasGroupKey;
+      LeftKey groupKey;
+      std::deque<StoredRow> storedRows;
+      size_t groupBegin;
+      size_t groupEnd;
 };
 
 namespace db {
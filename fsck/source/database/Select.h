@@ -1,6 +1,10 @@
 #ifndef SELECT_H_
 #define SELECT_H_
 
+#include <database/Batch.h>
+
+#include <vector>
+
 #include <boost/utility/result_of.hpp>
 
 template<typename Source, typename Fn>
@@ -30,6 +34,21 @@ class Select
          return &current;
       }
 
+      bool nextBatch(std::vector<ElementType>& batch)
+      {
+         batch.clear();
+
+         if(!this->source.nextBatch(this->sourceBatch) )
+            return false;
+
+         batch.reserve(this->sourceBatch.size() );
+
+         for(size_t i = 0; i < this->sourceBatch.size(); i++)
+            batch.push_back(this->fn(this->sourceBatch[i]) );
+
+         return true;
+      }
+
       MarkerType mark() const
       {
          return this->source.mark();
@@ -45,6 +64,9 @@ class Select
       Source source;
       Fn fn;
       ElementType current;
+
+      // kept alive until the next batch, selected rows may point into it
+      std::vector<typename Source::ElementType> sourceBatch;
 };
 
 
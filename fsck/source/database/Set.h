@@ -12,6 +12,7 @@
 #include <map>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include <limits.h>
 
@@ -163,6 +164,18 @@ class Set {
          return cwd + ('/' + path);
       }
 
+      template<typename Source>
+      static void appendAll(Source& source, Fragment* into)
+      {
+         std::vector<Data> batch;
+
+         while(source.nextBatch(batch) )
+         {
+            for(size_t i = 0; i < batch.size(); i++)
+               into->append(batch[i]);
+         }
+      }
+
    public:
       Set(const std::string& basename, bool allowCreate = true)
          : basename(makeAbsolute(basename) ), nextID(0), dropped(false)
@@ -251,8 +264,7 @@ class Set {
             {
             case 2: {
                L1Union u(Cursor(*inputs[0]), (Cursor(*inputs[1]) ), op::key);
-               while(u.step() )
-                  merged->append(*u.get() );
+               appendAll(u, merged);
                break;
             }
 
@@ -261,8 +273,7 @@ class Set {
                   L1Union(Cursor(*inputs[0]), (Cursor(*inputs[1]) ), op::key),
                   Cursor(*inputs[2]),
                   op::key);
-               while(u.step() )
-                  merged->append(*u.get() );
+               appendAll(u, merged);
                break;
             }
 
@@ -271,8 +282,7 @@ class Set {
                   L1Union(Cursor(*inputs[0]), (Cursor(*inputs[1]) ), op::key),
                   L1Union(Cursor(*inputs[2]), (Cursor(*inputs[3]) ), op::key),
                   op::key);
-               while(u.step() )
-                  merged->append(*u.get() );
+               appendAll(u, merged);
                break;
             }
 
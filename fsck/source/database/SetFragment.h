@@ -212,6 +212,43 @@ class SetFragment {
          return buffer[offset - firstBufferedItem];
       }
 
+      /*
+       * appends up to count items starting at offset to into. may copy fewer items than requested
+       * if the range crosses the currently buffered window, returns the number of items copied.
+       *
+       * flushed fragments are read directly from the file without touching the shared read
+       * buffer, so any number of threads may copy from a flushed fragment concurrently.
+       */
+      size_t copyTo(std::vector<Data>& into, size_t offset, size_t count)
+      {
+         if(offset >= itemCount)
+            return 0;
+
+         count = std::min(count, itemCount - offset);
+
+         if(firstDirtyItem < 0)
+         {
+            const size_t oldSize = into.size();
+
+            into.resize(oldSize + count);
+
+            const size_t read = readBlock(into.data() + oldSize, count, offset);
+
+            into.resize(oldSize + read);
+            return read;
+         }
+
+         if(offset < firstBufferedItem || offset >= firstBufferedItem + buffer.size() )
+            bufferFileRange(offset, -1);
+
+         count = std::min(count, firstBufferedItem + buffer.size() - offset);
+
+         const Data* first = buffer.data() + (offset - firstBufferedItem);
+
+         into.insert(into.end(), first, first + count);
+         return count;
+      }
+
       void flush()
       {
          if(firstDirtyItem < 0)
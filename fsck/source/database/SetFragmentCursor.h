@@ -1,6 +1,7 @@
 #ifndef SETFRAGMENTCURSOR_H_
 #define SETFRAGMENTCURSOR_H_
 
+#include <database/Batch.h>
 #include <database/SetFragment.h>
 
 template<typename Data>
@@ -32,6 +33,13 @@ class SetFragmentCursor {
          return &(*fragment)[currentGetIndex];
       }
 
+      bool nextBatch(std::vector<Data>& batch)
+      {
+         batch.clear();
+         currentGetIndex += fragment->copyTo(batch, currentGetIndex + 1, db::BATCH_SIZE);
+         return !batch.empty();
+      }
+
       MarkerType mark() const
       {
          return currentGetIndex;
@@ -0,0 +1,182 @@
+#ifndef SHAREDSET_H_
+#define SHAREDSET_H_
+
+#include <common/threading/Mutex.h>
+#include <database/Cursor.h>
+#include <database/Set.h>
+
+#include <boost/optional.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <mutex>
+#include <stdexcept>
+
+/*
+ * a copy of a sorted query result that is read by several checks. the copy only exists while
+ * consumers are registered: the first consumer that reads it writes the copy, all others read the
+ * copy, and it is dropped when the last consumer has been released.
+ *
+ * without registered consumers, get() returns the query itself, so results are always the same as
+ * those of the query.
+ *
+ * the query must yield its rows ordered by Data::pkey().
+ */
+template<typename Data>
+class SharedSet
+{
+   private:
+      struct Copy
+      {
+         Set<Data> set;
+         SetFragment<Data>* fragment;
+
+         Copy(const std::string& basename)
+            : set(basename), fragment(NULL)
+         {
+         }
+
+         ~Copy()
+         {
+            try
+            {
+               set.drop();
+            }
+            catch (const std::exception&)
+            {
+               // leftovers are removed when the set is built again
+            }
+         }
+      };
+
+      template<typename Source>
+      class LazyCursor
+      {
+         public:
+            typedef Data ElementType;
+
+            LazyCursor(SharedSet& owner, Source source)
+               : owner(&owner), source(source)
+            {
+            }
+
+            bool nextBatch(std::vector<Data>& batch)
+            {
+               // the copy is written when the check starts reading, not while it builds its query
+               if (!copy)
+               {
+                  copy = owner->materialize(source);
+                  cursor = SetFragmentCursor<Data>(*copy->fragment);
+               }
+
+               return cursor->nextBatch(batch);
+            }
+
+         private:
+            SharedSet* owner;
+            Source source;
+            boost::shared_ptr<Copy> copy; // keeps the copy alive while this cursor reads it
+            boost::optional<SetFragmentCursor<Data> > cursor;
+      };
+
+   public:
+      SharedSet(const std::string& basename)
+         : basename(basename), consumers(0)
+      {
+      }
+
+      void addConsumer()
+      {
+         const std::lock_guard<Mutex> lock(mutex);
+
+         if (consumers++ > 0)
+            return;
+
+         // a cursor that was created in a previous round but only started reading after its last
+         // consumer was released may have written a copy, which must not be handed out again
+         const std::lock_guard<Mutex> buildLock(buildMutex);
+
+         copy.reset();
+      }
+
+      void releaseConsumer()
+      {
+         const std::lock_guard<Mutex> lock(mutex);
+
+         if (consumers == 0)
+            throw std::logic_error("shared set released more often than used: " + basename);
+
+         if (--consumers > 0)
+            return;
+
+         // cursors that still read the copy keep it until they are destroyed
+         const std::lock_guard<Mutex> buildLock(buildMutex);
+
+         copy.reset();
+      }
+
+      template<typename Source>
+      Cursor<Data> get(Source source)
+      {
+         {
+            const std::lock_guard<Mutex> lock(mutex);
+
+            if (consumers == 0)
+               return Cursor<Data>(source);
+         }
+
+         return Cursor<Data>(LazyCursor<Source>(*this, source) );
+      }
+
+      bool isMaterialized()
+      {
+         const std::lock_guard<Mutex> lock(buildMutex);
+
+         return !!copy;
+      }
+
+   private:
+      std::string basename;
+
+      Mutex mutex; // protects consumers
+      unsigned consumers;
+
+      // held while the copy is written, so concurrent readers wait for it instead of writing their
+      // own. separate from mutex, so get() does not block while the copy is being written.
+      Mutex buildMutex;
+      boost::shared_ptr<Copy> copy;
+
+      template<typename Source>
+      boost::shared_ptr<Copy> materialize(Source& source)
+      {
+         const std::lock_guard<Mutex> lock(buildMutex);
+
+         if (copy)
+            return copy;
+
+         boost::shared_ptr<Copy> newCopy = boost::make_shared<Copy>(basename);
+
+         // (leftovers of an aborted run)
+         newCopy->set.clear();
+
+         SetFragment<Data>* fragment = newCopy->set.newFragment();
+         std::vector<Data> batch;
+
+         while (source.nextBatch(batch) )
+         {
+            for (size_t i = 0; i < batch.size(); i++)
+               fragment->append(batch[i]);
+         }
+
+         // the rows are already ordered. (not sort(), which would not keep the order of rows with
+         // equal keys, e.g. inodes with duplicate IDs.)
+         fragment->flush();
+
+         newCopy->fragment = fragment;
+         copy = newCopy;
+
+         return copy;
+      }
+};
+
+#endif
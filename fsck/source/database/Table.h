@@ -117,21 +117,27 @@ class Table {
          {
             Set<Data> insertsTemp(basename + ".it");
 
-            LeftJoinEq<
+            typedef LeftJoinEq<
                   SetFragmentCursor<Data>,
                   SetFragmentCursor<Key>,
-                  GetKey>
-               cleanedInserts = db::leftJoinBy(
+                  GetKey> CleanJoin;
+
+            CleanJoin cleanedInserts = db::leftJoinBy(
                   GetKey(),
                   inserts.cursor(),
                   deletesPending.cursor() );
 
             // sequence will always be sorted, no need to fragment and sort again
             SetFragment<Data>* fragment = insertsTemp.newFragment();
-            while(cleanedInserts.step() )
+            std::vector<typename CleanJoin::ElementType> batch;
+
+            while(cleanedInserts.nextBatch(batch) )
             {
-               if (cleanedInserts.get()->second == nullptr)
-                  fragment->append(cleanedInserts.get()->first);
+               for(size_t i = 0; i < batch.size(); i++)
+               {
+                  if (batch[i].second == nullptr)
+                     fragment->append(batch[i].first);
+               }
             }
 
             inserts.clear();
@@ -1,7 +1,10 @@
 #ifndef UNION_H_
 #define UNION_H_
 
+#include <database/Batch.h>
+
 #include <utility>
+#include <vector>
 
 template<typename Left, typename Right, typename KeyExtract>
 class Union
@@ -20,14 +23,20 @@ class Union
 
    public:
       Union(Left left, Right right, KeyExtract keyExtract):
-         left(left), right(right), keyExtract(keyExtract), leftEnded(false), nextStepLeft(true),
-         currentAtLeft(false)
+         left(left), right(right), keyExtract(keyExtract), leftEnded(false), rightEnded(false),
+         nextStepLeft(true), currentAtLeft(false), rightStarted(false)
       {
-         this->rightEnded = !this->right.step();
       }
 
       bool step()
       {
+         // positioned lazily, a union consumed with nextBatch() must not have stepped its inputs
+         if(!this->rightStarted)
+         {
+            this->rightStarted = true;
+            this->rightEnded = !this->right.step();
+         }
+
          if(this->leftEnded && this->rightEnded)
             return false;
 
@@ -59,6 +68,40 @@ class Union
             return this->right.get();
       }
 
+      bool nextBatch(std::vector<ElementType>& batch)
+      {
+         batch.clear();
+
+         while(batch.size() < db::BATCH_SIZE)
+         {
+            if(!fillBatchInput(this->leftRows, this->left, batch) ||
+                  !fillBatchInput(this->rightRows, this->right, batch) )
+               break;
+
+            const bool leftDone = this->leftRows.drained();
+            const bool rightDone = this->rightRows.drained();
+
+            if(leftDone && rightDone)
+               break;
+
+            if(!leftDone &&
+                  (rightDone ||
+                   this->keyExtract(this->leftRows.current() ) <
+                     this->keyExtract(this->rightRows.current() ) ) )
+            {
+               batch.push_back(this->leftRows.current() );
+               this->leftRows.advance();
+            }
+            else
+            {
+               batch.push_back(this->rightRows.current() );
+               this->rightRows.advance();
+            }
+         }
+
+         return !batch.empty();
+      }
+
       MarkerType mark() const
       {
          MarkerType result = { this->left.mark(), this->right.mark(), this->leftEnded,
@@ -68,6 +111,7 @@ class Union
 
       void restore(MarkerType mark)
       {
+         this->rightStarted = true;
          this->leftEnded = mark.leftEnded;
          this->rightEnded = mark.rightEnded;
          this->nextStepLeft = mark.nextStepLeft;
@@ -107,6 +151,23 @@ class Union
          return true;
       }
 
+      /*
+       * refills a drained input unless rows taken from its previous batch are still pending in
+       * batch. returns false if the batch must be handed out first.
+       */
+      template<typename Rows, typename Input>
+      static bool fillBatchInput(Rows& rows, Input& input, std::vector<ElementType>& batch)
+      {
+         if(!rows.drained() || rows.ended() )
+            return true;
+
+         if(!batch.empty() )
+            return false;
+
+         rows.refill(input);
+         return true;
+      }
+
    private:
       Left left;
       Right right;
@@ -115,6 +176,10 @@ class Union
       bool rightEnded;
       bool nextStepLeft;
       bool currentAtLeft;
+      bool rightStarted;
+
+      db::BatchBuffer<typename Left::ElementType> leftRows;
+      db::BatchBuffer<typename Right::ElementType> rightRows;
 };
 
 namespace db {
@@ -1,6 +1,9 @@
 #ifndef VECTORSOURCE_H_
 #define VECTORSOURCE_H_
 
+#include <database/Batch.h>
+
+#include <algorithm>
 #include <vector>
 
 #include <boost/shared_ptr.hpp>
@@ -14,8 +17,8 @@ class VectorSource
       typedef typename std::vector<Obj>::const_iterator MarkerType;
 
    public:
-      explicit VectorSource(std::vector<Obj>& data)
-         : content(boost::make_shared<std::vector<Obj> >() ), index(-1)
+      explicit VectorSource(std::vector<Obj>& data, size_t batchSize = db::BATCH_SIZE)
+         : content(boost::make_shared<std::vector<Obj> >() ), index(-1), batchSize(batchSize)
       {
          data.swap(*content);
       }
@@ -34,6 +37,16 @@ class VectorSource
          return &(*this->content)[this->index];
       }
 
+      bool nextBatch(std::vector<Obj>& batch)
+      {
+         const size_t first = this->index + 1;
+         const size_t count = std::min(this->batchSize, this->content->size() - first);
+
+         batch.assign(this->content->begin() + first, this->content->begin() + first + count);
+         this->index += count;
+         return count > 0;
+      }
+
       MarkerType mark() const
       {
          return this->content->begin() + this->index;
@@ -47,6 +60,7 @@ class VectorSource
    private:
       boost::shared_ptr<std::vector<Obj> > content;
       size_t index;
+      size_t batchSize;
 };
 
 #endif
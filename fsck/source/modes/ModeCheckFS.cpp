@@ -5,6 +5,7 @@
 #include <common/toolkit/UnitTk.h>
 #include <common/toolkit/UiTk.h>
 #include <common/toolkit/ZipIterator.h>
+#include <components/CheckScheduler.h>
 #include <components/DataFetcher.h>
 #include <components/worker/RetrieveChunksWork.h>
 #include <net/msghelpers/MsgHelperRepair.h>
@@ -508,28 +509,46 @@ FhgfsOpsErr ModeCheckFS::gatherData(bool forceRestart)
    return retVal;
 }
 
-template<typename Obj, typename State>
-FsckErrCount ModeCheckFS::checkAndRepairGeneric(Cursor<Obj> cursor,
+void ModeCheckFS::commitDatabaseChanges()
+{
+   database->getDentryTable()->commitChanges();
+   database->getFileInodesTable()->commitChanges();
+   database->getDirInodesTable()->commitChanges();
+   database->getChunksTable()->commitChanges();
+   database->getContDirsTable()->commitChanges();
+   database->getFsIDsTable()->commitChanges();
+}
+
+/*
+ * @param query callable that builds the cursor of the check. it is called with dbMutex held, the
+ *    cursor itself is evaluated without it.
+ */
+template<typename Query, typename Obj, typename State>
+FsckErrCount ModeCheckFS::checkAndRepairGeneric(Query query,
    void (ModeCheckFS::*repair)(Obj&, FsckErrCount&, State&), State& state)
 {
    FsckErrCount errorCount;
 
+   Cursor<Obj> cursor = [&] () {
+      const std::lock_guard<Mutex> lock(dbMutex);
+      return Cursor<Obj>(query() );
+   }();
+
    while(cursor.step() )
    {
       Obj* entry = cursor.get();
 
+      const std::lock_guard<Mutex> lock(dbMutex);
       (this->*repair)(*entry, errorCount, state);
    }
 
 
    if (errorCount.getTotalErrors())
    {
-      database->getDentryTable()->commitChanges();
-      database->getFileInodesTable()->commitChanges();
-      database->getDirInodesTable()->commitChanges();
-      database->getChunksTable()->commitChanges();
-      database->getContDirsTable()->commitChanges();
-      database->getFsIDsTable()->commitChanges();
+      {
+         const std::lock_guard<Mutex> lock(dbMutex);
+         commitDatabaseChanges();
+      }
 
       FsckTkEx::fsckOutput(">>> Found " + StringTk::int64ToStr(errorCount.getTotalErrors())
          + " errors. Detailed information can also be found in "
@@ -566,7 +585,7 @@ FsckErrCount ModeCheckFS::checkAndRepairDanglingDentry()
    FsckTkEx::fsckOutput("* Checking: Dangling directory entry (dentry) ...",
       OutputOptions_FLUSH |OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findDanglingDirEntries(),
+   return checkAndRepairGeneric([this] { return this->database->findDanglingDirEntries(); },
       &ModeCheckFS::repairDanglingDirEntry, prompt);
 }
 
@@ -582,7 +601,7 @@ FsckErrCount ModeCheckFS::checkAndRepairWrongInodeOwner()
    FsckTkEx::fsckOutput("* Checking: Wrong owner node saved in inode ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findInodesWithWrongOwner(),
+   return checkAndRepairGeneric([this] { return this->database->findInodesWithWrongOwner(); },
       &ModeCheckFS::repairWrongInodeOwner, prompt);
 }
 
@@ -598,7 +617,7 @@ FsckErrCount ModeCheckFS::checkAndRepairWrongOwnerInDentry()
    FsckTkEx::fsckOutput("* Checking: Dentry points to inode on wrong node ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findDirEntriesWithWrongOwner(),
+   return checkAndRepairGeneric([this] { return this->database->findDirEntriesWithWrongOwner(); },
       &ModeCheckFS::repairWrongInodeOwnerInDentry, prompt);
 }
 
@@ -614,7 +633,7 @@ FsckErrCount ModeCheckFS::checkAndRepairOrphanedContDir()
    FsckTkEx::fsckOutput("* Checking: Content directory without an inode ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findOrphanedContDirs(),
+   return checkAndRepairGeneric([this] { return this->database->findOrphanedContDirs(); },
       &ModeCheckFS::repairOrphanedContDir, prompt);
 }
 
@@ -630,7 +649,7 @@ FsckErrCount ModeCheckFS::checkAndRepairOrphanedDirInode()
    FsckTkEx::fsckOutput("* Checking: Dir inode without a dentry pointing to it (orphaned inode) ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   auto result = checkAndRepairGeneric(this->database->findOrphanedDirInodes(),
+   auto result = checkAndRepairGeneric([this] { return this->database->findOrphanedDirInodes(); },
       &ModeCheckFS::repairOrphanedDirInode, prompt);
 
    releaseLostAndFound();
@@ -650,7 +669,7 @@ FsckErrCount ModeCheckFS::checkAndRepairOrphanedFileInode()
    FsckTkEx::fsckOutput("* Checking: File inode without a dentry pointing to it (orphaned inode) ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findOrphanedFileInodes(),
+   return checkAndRepairGeneric([this] { return this->database->findOrphanedFileInodes(); },
       &ModeCheckFS::repairOrphanedFileInode, prompt);
 }
 
@@ -665,7 +684,7 @@ FsckErrCount ModeCheckFS::checkAndRepairDuplicateInodes()
 
    FsckTkEx::fsckOutput("* Checking: Duplicate inodes ...", OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findDuplicateInodeIDs(),
+   return checkAndRepairGeneric([this] { return this->database->findDuplicateInodeIDs(); },
       &ModeCheckFS::repairDuplicateInode, prompt);
 }
 
@@ -682,7 +701,7 @@ FsckErrCount ModeCheckFS::checkAndRepairOrphanedChunk()
    FsckTkEx::fsckOutput("* Checking: Chunk without an inode pointing to it (orphaned chunk) ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findOrphanedChunks(),
+   return checkAndRepairGeneric([this] { return this->database->findOrphanedChunks(); },
       &ModeCheckFS::repairOrphanedChunk, state);
 }
 
@@ -698,7 +717,7 @@ FsckErrCount ModeCheckFS::checkAndRepairMissingContDir()
    FsckTkEx::fsckOutput("* Checking: Directory inode without a content directory ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findInodesWithoutContDir(),
+   return checkAndRepairGeneric([this] { return this->database->findInodesWithoutContDir(); },
       &ModeCheckFS::repairMissingContDir, prompt);
 }
 
@@ -714,7 +733,7 @@ FsckErrCount ModeCheckFS::checkAndRepairWrongFileAttribs()
    FsckTkEx::fsckOutput("* Checking: Attributes of file inode are wrong ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findWrongInodeFileAttribs(),
+   return checkAndRepairGeneric([this] { return this->database->findWrongInodeFileAttribs(); },
       &ModeCheckFS::repairWrongFileAttribs, prompt);
 }
 
@@ -730,7 +749,7 @@ FsckErrCount ModeCheckFS::checkAndRepairWrongDirAttribs()
    FsckTkEx::fsckOutput("* Checking: Attributes of dir inode are wrong ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findWrongInodeDirAttribs(),
+   return checkAndRepairGeneric([this] { return this->database->findWrongInodeDirAttribs(); },
       &ModeCheckFS::repairWrongDirAttribs, prompt);
 }
 
@@ -747,8 +766,11 @@ FsckErrCount ModeCheckFS::checkAndRepairFilesWithMissingTargets()
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
    return checkAndRepairGeneric(
-      this->database->findFilesWithMissingStripeTargets(
-         Program::getApp()->getTargetMapper(), Program::getApp()->getMirrorBuddyGroupMapper() ),
+      [this] {
+         return this->database->findFilesWithMissingStripeTargets(
+            Program::getApp()->getTargetMapper(),
+            Program::getApp()->getMirrorBuddyGroupMapper() );
+      },
       &ModeCheckFS::repairFileWithMissingTargets, prompt);
 }
 
@@ -764,7 +786,7 @@ FsckErrCount ModeCheckFS::checkAndRepairDirEntriesWithBrokeByIDFile()
    FsckTkEx::fsckOutput("* Checking: Dentry-by-ID file is broken or missing ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findDirEntriesWithBrokenByIDFile(),
+   return checkAndRepairGeneric([this] { return this->database->findDirEntriesWithBrokenByIDFile(); },
       &ModeCheckFS::repairDirEntryWithBrokenByIDFile, prompt);
 }
 
@@ -780,7 +802,7 @@ FsckErrCount ModeCheckFS::checkAndRepairOrphanedDentryByIDFiles()
    FsckTkEx::fsckOutput("* Checking: Dentry-by-ID file is present, but no corresponding dentry ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findOrphanedFsIDFiles(),
+   return checkAndRepairGeneric([this] { return this->database->findOrphanedFsIDFiles(); },
       &ModeCheckFS::repairOrphanedDentryByIDFile, prompt);
 }
 
@@ -796,7 +818,7 @@ FsckErrCount ModeCheckFS::checkAndRepairChunksWithWrongPermissions()
    FsckTkEx::fsckOutput("* Checking: Chunk has wrong permissions ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findChunksWithWrongPermissions(),
+   return checkAndRepairGeneric([this] { return this->database->findChunksWithWrongPermissions(); },
       &ModeCheckFS::repairChunkWithWrongPermissions, prompt);
 }
 
@@ -813,7 +835,7 @@ FsckErrCount ModeCheckFS::checkAndRepairChunksInWrongPath()
    FsckTkEx::fsckOutput("* Checking: Chunk is saved in wrong path ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findChunksInWrongPath(),
+   return checkAndRepairGeneric([this] { return this->database->findChunksInWrongPath(); },
       &ModeCheckFS::repairWrongChunkPath, prompt);
 }
 
@@ -829,7 +851,7 @@ FsckErrCount ModeCheckFS::checkAndUpdateOldStyledHardlinks()
    FsckTkEx::fsckOutput("* Checking: Files having an inlined inode with multiple hardlinks ...",
       OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(this->database->findFilesWithMultipleHardlinks(),
+   return checkAndRepairGeneric([this] { return this->database->findFilesWithMultipleHardlinks(); },
       &ModeCheckFS::updateOldStyledHardlinks, prompt);
 }
 
@@ -879,7 +901,7 @@ FsckErrCount ModeCheckFS::checkDuplicateChunks()
    FsckTkEx::fsckOutput("* Checking: Duplicated chunks ...", OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
    int dummy = 0;
-   return checkAndRepairGeneric(this->database->findDuplicateChunks(),
+   return checkAndRepairGeneric([this] { return this->database->findDuplicateChunks(); },
       &ModeCheckFS::logDuplicateChunk, dummy);
 }
 
@@ -908,7 +930,7 @@ FsckErrCount ModeCheckFS::checkDuplicateContDirs()
          OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
    int dummy = 0;
-   return checkAndRepairGeneric(this->database->findDuplicateContDirs(),
+   return checkAndRepairGeneric([this] { return this->database->findDuplicateContDirs(); },
       &ModeCheckFS::logDuplicateContDir, dummy);
 }
 
@@ -933,7 +955,7 @@ FsckErrCount ModeCheckFS::checkMismirroredDentries()
          OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
    int dummy = 0;
-   return checkAndRepairGeneric(this->database->findMismirroredDentries(),
+   return checkAndRepairGeneric([this] { return this->database->findMismirroredDentries(); },
       &ModeCheckFS::logMismirroredDentry, dummy);
 }
 
@@ -953,7 +975,7 @@ FsckErrCount ModeCheckFS::checkMismirroredDirectories()
          OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
    int dummy = 0;
-   return checkAndRepairGeneric(this->database->findMismirroredDirectories(),
+   return checkAndRepairGeneric([this] { return this->database->findMismirroredDirectories(); },
       &ModeCheckFS::logMismirroredDirectory, dummy);
 }
 
@@ -973,7 +995,7 @@ FsckErrCount ModeCheckFS::checkMismirroredFiles()
          OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
    int dummy = 0;
-   return checkAndRepairGeneric(this->database->findMismirroredFiles(),
+   return checkAndRepairGeneric([this] { return this->database->findMismirroredFiles(); },
       &ModeCheckFS::logMismirroredFile, dummy);
 }
 
@@ -997,7 +1019,8 @@ FsckErrCount ModeCheckFS::checkAndRepairMalformedChunk()
 
    FsckTkEx::fsckOutput("* Checking: Malformed chunk ...", OutputOptions_FLUSH | OutputOptions_LINEBREAK);
 
-   return checkAndRepairGeneric(Cursor<FsckChunk>(database->getMalformedChunksList()->cursor()),
+   return checkAndRepairGeneric(
+      [this] { return Cursor<FsckChunk>(database->getMalformedChunksList()->cursor()); },
       &ModeCheckFS::repairMalformedChunk, prompt);
 }
 
@@ -1042,20 +1065,144 @@ void ModeCheckFS::repairMalformedChunk(FsckChunk& chunk, FsckErrCount& errCount,
    }
 }
 
+/*
+ * @return the tables the query of a check reads through FsckDB's shared tables
+ */
+std::vector<FsckDB::SharedTable> ModeCheckFS::getSharedTables(FsckErrCount (ModeCheckFS::*check)())
+{
+   typedef FsckErrCount (ModeCheckFS::*CheckFn)();
+
+   static const std::vector<std::pair<CheckFn, std::vector<FsckDB::SharedTable>>> sharedTables = {
+      { &ModeCheckFS::checkAndRepairDuplicateInodes,
+         { FsckDB::SharedTable_FILEINODES, FsckDB::SharedTable_DIRINODES } },
+      { &ModeCheckFS::checkDuplicateChunks, { FsckDB::SharedTable_CHUNKS } },
+      { &ModeCheckFS::checkMismirroredDentries, { FsckDB::SharedTable_DENTRIES } },
+      { &ModeCheckFS::checkMismirroredDirectories, { FsckDB::SharedTable_DIRINODES } },
+      { &ModeCheckFS::checkMismirroredFiles, { FsckDB::SharedTable_FILEINODES } },
+      { &ModeCheckFS::checkAndRepairDirEntriesWithBrokeByIDFile, { FsckDB::SharedTable_DENTRIES } },
+      { &ModeCheckFS::checkAndRepairOrphanedChunk, { FsckDB::SharedTable_CHUNKS } },
+      { &ModeCheckFS::checkAndRepairChunksInWrongPath, { FsckDB::SharedTable_CHUNKS } },
+      { &ModeCheckFS::checkAndRepairWrongInodeOwner, { FsckDB::SharedTable_DIRINODES } },
+      { &ModeCheckFS::checkAndRepairWrongOwnerInDentry, { FsckDB::SharedTable_DENTRIES } },
+      { &ModeCheckFS::checkAndRepairOrphanedDirInode, { FsckDB::SharedTable_DIRINODES } },
+      { &ModeCheckFS::checkAndRepairOrphanedFileInode, { FsckDB::SharedTable_FILEINODES } },
+      { &ModeCheckFS::checkAndRepairDanglingDentry, { FsckDB::SharedTable_DENTRIES } },
+      { &ModeCheckFS::checkAndRepairMissingContDir, { FsckDB::SharedTable_DIRINODES } },
+      { &ModeCheckFS::checkAndRepairWrongFileAttribs, { FsckDB::SharedTable_FILEINODES } },
+      { &ModeCheckFS::checkAndRepairWrongDirAttribs, { FsckDB::SharedTable_DIRINODES } },
+      { &ModeCheckFS::checkAndUpdateOldStyledHardlinks, { FsckDB::SharedTable_FILEINODES } },
+      { &ModeCheckFS::checkAndRepairChunksWithWrongPermissions, { FsckDB::SharedTable_CHUNKS } },
+   };
+
+   for (auto it = sharedTables.begin(); it != sharedTables.end(); ++it)
+   {
+      if (it->first == check)
+         return it->second;
+   }
+
+   return {};
+}
+
+/*
+ * runs a list of checks and returns the sum of their error counts.
+ *
+ * checks of a read-only run neither modify the database nor ask the user for anything, so they do
+ * not depend on each other and run concurrently. the tables that several of them read are copied
+ * once for all of them (see FsckDB::SharedTable) and removed after the last check that reads them.
+ * when repairing, every check may change what the following ones find, so each of them depends on
+ * its predecessor (and runs in this thread, since repairs may prompt the user) and reads the
+ * current tables.
+ */
+FsckErrCount ModeCheckFS::runChecks(const std::vector<FsckErrCount (ModeCheckFS::*)()>& checks)
+{
+   Config* cfg = Program::getApp()->getConfig();
+
+   const bool independent = cfg->getReadOnly();
+
+   CheckScheduler scheduler(Program::getApp()->getWorkQueue(),
+      independent ? cfg->getTuneNumCheckThreads() : 1);
+   std::vector<FsckErrCount> results(checks.size() );
+   std::vector<std::vector<FsckDB::SharedTable>> sharedTables(checks.size() );
+
+   // (a check touches only its own element, all are released by the time run() returns)
+   auto releaseSharedTables = [this, &sharedTables] (size_t i) {
+      for (auto it = sharedTables[i].begin(); it != sharedTables[i].end(); ++it)
+         database->releaseSharedTableConsumer(*it);
+
+      sharedTables[i].clear();
+   };
+
+   for (size_t i = 0; i < checks.size(); i++)
+   {
+      std::vector<unsigned> dependencies;
+
+      if (independent)
+      {
+         sharedTables[i] = getSharedTables(checks[i]);
+
+         for (auto it = sharedTables[i].begin(); it != sharedTables[i].end(); ++it)
+            database->addSharedTableConsumer(*it);
+      }
+      else
+      if (i > 0)
+         dependencies.push_back(i - 1);
+
+      scheduler.add(
+         [this, &checks, &results, &releaseSharedTables, i] {
+            try
+            {
+               results[i] = (this->*checks[i])();
+            }
+            catch (...)
+            {
+               releaseSharedTables(i);
+               throw;
+            }
+
+            releaseSharedTables(i);
+         },
+         dependencies);
+   }
+
+   try
+   {
+      scheduler.run();
+   }
+   catch (...)
+   {
+      // checks that were not started anymore
+      for (size_t i = 0; i < checks.size(); i++)
+         releaseSharedTables(i);
+
+      throw;
+   }
+
+   FsckErrCount errorCount;
+
+   for (auto it = results.begin(); it != results.end(); ++it)
+      errorCount += *it;
+
+   return errorCount;
+}
+
 void ModeCheckFS::checkAndRepair()
 {
    FsckTkEx::fsckOutput("Step 4: Check for errors... ", OutputOptions_DOUBLELINEBREAK);
 
    Config* cfg = Program::getApp()->getConfig();
 
-   FsckErrCount errorCount;
+   // bring all tables into their sorted, committed state once, so that concurrent checks only
+   // read them
+   commitDatabaseChanges();
 
-   errorCount += checkAndRepairDuplicateInodes();
-   errorCount += checkDuplicateChunks();
-   errorCount += checkDuplicateContDirs();
-   errorCount += checkMismirroredDentries();
-   errorCount += checkMismirroredDirectories();
-   errorCount += checkMismirroredFiles();
+   FsckErrCount errorCount = runChecks({
+      &ModeCheckFS::checkAndRepairDuplicateInodes,
+      &ModeCheckFS::checkDuplicateChunks,
+      &ModeCheckFS::checkDuplicateContDirs,
+      &ModeCheckFS::checkMismirroredDentries,
+      &ModeCheckFS::checkMismirroredDirectories,
+      &ModeCheckFS::checkMismirroredFiles,
+   });
 
    if (errorCount.unfixableErrors)
    {
@@ -1071,59 +1218,63 @@ void ModeCheckFS::checkAndRepair()
       checkFsActions.set();
    }
 
+   std::vector<FsckErrCount (ModeCheckFS::*)()> checks;
+
    if (checkFsActions.test(CHECK_MALFORMED_CHUNK))
-      errorCount += checkAndRepairMalformedChunk();
+      checks.push_back(&ModeCheckFS::checkAndRepairMalformedChunk);
 
    if (checkFsActions.test(CHECK_FILES_WITH_MISSING_TARGETS))
-      errorCount += checkAndRepairFilesWithMissingTargets();
+      checks.push_back(&ModeCheckFS::checkAndRepairFilesWithMissingTargets);
 
    if (checkFsActions.test(CHECK_ORPHANED_DENTRY_BYIDFILES))
-      errorCount += checkAndRepairOrphanedDentryByIDFiles();
+      checks.push_back(&ModeCheckFS::checkAndRepairOrphanedDentryByIDFiles);
 
    if (checkFsActions.test(CHECK_DIRENTRIES_WITH_BROKENIDFILE))
-      errorCount += checkAndRepairDirEntriesWithBrokeByIDFile();
+      checks.push_back(&ModeCheckFS::checkAndRepairDirEntriesWithBrokeByIDFile);
 
    if (checkFsActions.test(CHECK_ORPHANED_CHUNK))
-      errorCount += checkAndRepairOrphanedChunk();
+      checks.push_back(&ModeCheckFS::checkAndRepairOrphanedChunk);
 
    if (checkFsActions.test(CHECK_CHUNKS_IN_WRONGPATH))
-      errorCount += checkAndRepairChunksInWrongPath();
+      checks.push_back(&ModeCheckFS::checkAndRepairChunksInWrongPath);
 
    if (checkFsActions.test(CHECK_WRONG_INODE_OWNER))
-      errorCount += checkAndRepairWrongInodeOwner();
+      checks.push_back(&ModeCheckFS::checkAndRepairWrongInodeOwner);
 
    if (checkFsActions.test(CHECK_WRONG_OWNER_IN_DENTRY))
-      errorCount += checkAndRepairWrongOwnerInDentry();
+      checks.push_back(&ModeCheckFS::checkAndRepairWrongOwnerInDentry);
 
    if (checkFsActions.test(CHECK_ORPHANED_CONT_DIR))
-      errorCount += checkAndRepairOrphanedContDir();
+      checks.push_back(&ModeCheckFS::checkAndRepairOrphanedContDir);
 
    if (checkFsActions.test(CHECK_ORPHANED_DIR_INODE))
-      errorCount += checkAndRepairOrphanedDirInode();
+      checks.push_back(&ModeCheckFS::checkAndRepairOrphanedDirInode);
 
    if (checkFsActions.test(CHECK_ORPHANED_FILE_INODE))
-      errorCount += checkAndRepairOrphanedFileInode();
+      checks.push_back(&ModeCheckFS::checkAndRepairOrphanedFileInode);
 
    if (checkFsActions.test(CHECK_DANGLING_DENTRY))
-      errorCount += checkAndRepairDanglingDentry();
+      checks.push_back(&ModeCheckFS::checkAndRepairDanglingDentry);
 
    if (checkFsActions.test(CHECK_MISSING_CONT_DIR))
-      errorCount += checkAndRepairMissingContDir();
+      checks.push_back(&ModeCheckFS::checkAndRepairMissingContDir);
 
    if (checkFsActions.test(CHECK_WRONG_FILE_ATTRIBS))
-      errorCount += checkAndRepairWrongFileAttribs();
+      checks.push_back(&ModeCheckFS::checkAndRepairWrongFileAttribs);
 
    if (checkFsActions.test(CHECK_WRONG_DIR_ATTRIBS))
-      errorCount += checkAndRepairWrongDirAttribs();
+      checks.push_back(&ModeCheckFS::checkAndRepairWrongDirAttribs);
 
    if (checkFsActions.test(CHECK_OLD_STYLED_HARDLINKS))
-      errorCount += checkAndUpdateOldStyledHardlinks();
+      checks.push_back(&ModeCheckFS::checkAndUpdateOldStyledHardlinks);
 
    if ( cfg->getQuotaEnabled())
    {
-      errorCount += checkAndRepairChunksWithWrongPermissions();
+      checks.push_back(&ModeCheckFS::checkAndRepairChunksWithWrongPermissions);
    }
 
+   errorCount += runChecks(checks);
+
    if ( cfg->getReadOnly() )
    {
       FsckTkEx::fsckOutput(
@@ -4,6 +4,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <vector>
 
+#include <common/threading/Mutex.h>
 #include <database/FsckDB.h>
 #include <database/FsckDBException.h>
 #include <modes/Mode.h>
@@ -80,13 +81,20 @@ class ModeCheckFS : public Mode
 
       std::set<NumNodeID> secondariesSetBad;
 
+      // serializes database access of concurrently running checks. held while a check builds its
+      // query (which sorts and commits tables) and while it handles a single result row, but not
+      // while the query is being evaluated.
+      Mutex dbMutex;
+
       int initDatabase();
       void printHeaderInformation();
       void disposeUnusedFiles();
       FhgfsOpsErr gatherData(bool forceRestart);
 
-      template<typename Obj, typename State>
-      FsckErrCount checkAndRepairGeneric(Cursor<Obj> cursor,
+      void commitDatabaseChanges();
+
+      template<typename Query, typename Obj, typename State>
+      FsckErrCount checkAndRepairGeneric(Query query,
          void (ModeCheckFS::*repair)(Obj&, FsckErrCount&, State&), State& state);
 
       FsckErrCount checkAndRepairDanglingDentry();
@@ -130,6 +138,9 @@ class ModeCheckFS : public Mode
       FsckErrCount checkAndRepairMalformedChunk();
       void repairMalformedChunk(FsckChunk& chunk, FsckErrCount& errCount, UserPrompter& prompt);
 
+      static std::vector<FsckDB::SharedTable> getSharedTables(
+         FsckErrCount (ModeCheckFS::*check)());
+      FsckErrCount runChecks(const std::vector<FsckErrCount (ModeCheckFS::*)()>& checks);
       void checkAndRepair();
 
       void repairDanglingDirEntry(db::DirEntry& entry, FsckErrCount& errCount,
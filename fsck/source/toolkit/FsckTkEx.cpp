@@ -13,6 +13,18 @@
 
 char FsckTkEx::progressChar = '-';
 Mutex FsckTkEx::outputMutex;
+thread_local FsckTkEx::CapturedOutput* FsckTkEx::capturedOutput = NULL;
+
+FsckTkEx::OutputCapture::OutputCapture(CapturedOutput& into)
+   : previous(FsckTkEx::capturedOutput)
+{
+   FsckTkEx::capturedOutput = &into;
+}
+
+FsckTkEx::OutputCapture::~OutputCapture()
+{
+   FsckTkEx::capturedOutput = previous;
+}
 
 /*
  * check the reachability of all nodes in the system
@@ -94,6 +106,12 @@ bool FsckTkEx::checkReachability(Node& node, NodeType nodetype)
 
 void FsckTkEx::fsckOutput(std::string text, int optionFlags)
 {
+   if (capturedOutput)
+   {
+      capturedOutput->push_back(std::make_pair(std::move(text), optionFlags));
+      return;
+   }
+
    const std::lock_guard<Mutex> lock(outputMutex);
 
    static bool fileErrLogged = false; // to make sure we print logfile open err only once
@@ -227,6 +245,12 @@ void FsckTkEx::fsckOutput(std::string text, int optionFlags)
    }
 }
 
+void FsckTkEx::replayOutput(const CapturedOutput& output)
+{
+   for (auto it = output.begin(); it != output.end(); ++it)
+      fsckOutput(it->first, it->second);
+}
+
 void FsckTkEx::printVersionHeader(bool toStdErr, bool noLogFile)
 {
    int optionFlags = OutputOptions_LINEBREAK;
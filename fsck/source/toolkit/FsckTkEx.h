@@ -54,6 +54,26 @@
 class FsckTkEx
 {
    public:
+      typedef std::vector<std::pair<std::string, int> > CapturedOutput;
+
+      /*
+       * while an OutputCapture is alive, all fsckOutput() calls of the thread that created it
+       * are appended to the given buffer instead of being printed. used to run checks
+       * concurrently without interleaving their output.
+       */
+      class OutputCapture
+      {
+         public:
+            explicit OutputCapture(CapturedOutput& into);
+            ~OutputCapture();
+
+            OutputCapture(const OutputCapture&) = delete;
+            OutputCapture& operator=(const OutputCapture&) = delete;
+
+         private:
+            CapturedOutput* previous;
+      };
+
       // check the reachability of all nodes
       static bool checkReachability();
       // check the reachability of a given node by sending a heartbeat message
@@ -66,6 +86,8 @@ class FsckTkEx
        * @param optionFlags OutputOptions_... flags (mainly for formatiing)
        */
       static void fsckOutput(std::string text, int optionFlags);
+      // prints output previously collected by an OutputCapture
+      static void replayOutput(const CapturedOutput& output);
       // just print a formatted header with the version to the console
       static void printVersionHeader(bool toStdErr = false, bool noLogFile = false);
       // print the progress meter which goes round and round (-\|/-)
@@ -90,6 +112,8 @@ class FsckTkEx
       // a mutex that is locked by output functions to make sure the output does not get messed up
       // by two threads doing output at the same time
       static Mutex outputMutex;
+      // output buffer of the OutputCapture active in the current thread, if any
+      static thread_local CapturedOutput* capturedOutput;
 
 
    public:
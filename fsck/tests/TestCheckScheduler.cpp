@@ -0,0 +1,213 @@
+#include <common/components/worker/DummyWork.h>
+#include <components/CheckScheduler.h>
+#include <toolkit/FsckTkEx.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+class TestCheckScheduler : public ::testing::Test
+{
+   protected:
+      MultiWorkQueue workQueue;
+      std::vector<std::thread> workers;
+      std::atomic<bool> stopWorkers{false};
+
+      std::mutex eventsMutex;
+      std::vector<std::string> events;
+
+      // like the indirect workers of the app, but without the app
+      void SetUp() override
+      {
+         for (unsigned i = 0; i < 4; i++)
+         {
+            workers.emplace_back([this] () {
+               PersonalWorkQueue personalQueue;
+               HighResolutionStats stats;
+
+               HighResolutionStatsTk::resetStats(&stats);
+
+               while (!stopWorkers)
+               {
+                  Work* work = workQueue.waitForAnyWork(stats, &personalQueue);
+
+                  work->process(NULL, 0, NULL, 0);
+                  delete work;
+               }
+            });
+         }
+      }
+
+      void TearDown() override
+      {
+         stopWorkers = true;
+
+         for (size_t i = 0; i < workers.size(); i++)
+            workQueue.addDirectWork(new DummyWork() );
+
+         for (auto& worker : workers)
+            worker.join();
+      }
+
+      void record(const std::string& event)
+      {
+         const std::lock_guard<std::mutex> lock(eventsMutex);
+         events.push_back(event);
+      }
+
+      size_t indexOf(const std::string& event)
+      {
+         const auto it = std::find(events.begin(), events.end(), event);
+
+         EXPECT_NE(it, events.end() ) << event;
+         return it - events.begin();
+      }
+
+      static void sleepMS(unsigned ms)
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(ms) );
+      }
+};
+
+TEST_F(TestCheckScheduler, dependencyOrder)
+{
+   CheckScheduler scheduler(&workQueue, 4);
+
+   const unsigned a = scheduler.add([this] () { sleepMS(50); record("a"); });
+   const unsigned b = scheduler.add([this] () { record("b"); });
+   const unsigned c = scheduler.add([this] () { record("c"); }, {a, b});
+   scheduler.add([this] () { record("d"); }, {c});
+   scheduler.add([this] () { record("e"); }, {b});
+
+   scheduler.run();
+
+   ASSERT_EQ(events.size(), 5u);
+
+   ASSERT_LT(indexOf("a"), indexOf("c") );
+   ASSERT_LT(indexOf("b"), indexOf("c") );
+   ASSERT_LT(indexOf("c"), indexOf("d") );
+   ASSERT_LT(indexOf("b"), indexOf("e") );
+
+   // independent checks don't wait for each other
+   ASSERT_LT(indexOf("e"), indexOf("a") );
+}
+
+TEST_F(TestCheckScheduler, sequential)
+{
+   CheckScheduler scheduler(&workQueue, 1);
+   const std::thread::id caller = std::this_thread::get_id();
+
+   for (unsigned i = 0; i < 5; i++)
+   {
+      scheduler.add([this, i, caller] () {
+         EXPECT_EQ(std::this_thread::get_id(), caller);
+         sleepMS(5 - i);
+         record(std::to_string(i) );
+      });
+   }
+
+   scheduler.run();
+
+   ASSERT_EQ(events, std::vector<std::string>({"0", "1", "2", "3", "4"}) );
+}
+
+TEST_F(TestCheckScheduler, invalidDependency)
+{
+   CheckScheduler scheduler(&workQueue, 4);
+
+   const unsigned a = scheduler.add([] () {});
+
+   ASSERT_THROW(scheduler.add([] () {}, {a + 1}), std::logic_error);
+}
+
+TEST_F(TestCheckScheduler, outputOrder)
+{
+   const unsigned numChecks = 8;
+   CheckScheduler scheduler(&workQueue, 4);
+
+   // later checks finish first
+   for (unsigned i = 0; i < numChecks; i++)
+   {
+      scheduler.add([i] () {
+         FsckTkEx::fsckOutput("check " + std::to_string(i) + " begin");
+         sleepMS( (numChecks - i) * 10);
+         FsckTkEx::fsckOutput("check " + std::to_string(i) + " end", OutputOptions_FLUSH);
+      });
+   }
+
+   // the scheduler prints in the calling thread, so this collects the final output
+   FsckTkEx::CapturedOutput output;
+
+   {
+      FsckTkEx::OutputCapture capture(output);
+      scheduler.run();
+   }
+
+   ASSERT_EQ(output.size(), 2 * numChecks);
+
+   for (unsigned i = 0; i < numChecks; i++)
+   {
+      ASSERT_EQ(output[2 * i].first, "check " + std::to_string(i) + " begin");
+      ASSERT_EQ(output[2 * i].second, OutputOptions_LINEBREAK);
+      ASSERT_EQ(output[2 * i + 1].first, "check " + std::to_string(i) + " end");
+      ASSERT_EQ(output[2 * i + 1].second, OutputOptions_FLUSH);
+   }
+}
+
+TEST_F(TestCheckScheduler, exceptionPassedToCaller)
+{
+   CheckScheduler scheduler(&workQueue, 4);
+
+   scheduler.add([this] () {
+      sleepMS(20);
+      FsckTkEx::fsckOutput("independent");
+      record("independent");
+   });
+
+   const unsigned failing = scheduler.add([] () {
+      FsckTkEx::fsckOutput("failing");
+      throw std::runtime_error("check failed");
+   });
+
+   scheduler.add([this] () { record("dependent"); }, {failing});
+   scheduler.add([this] () { record("later"); });
+
+   FsckTkEx::CapturedOutput output;
+
+   try
+   {
+      FsckTkEx::OutputCapture capture(output);
+      scheduler.run();
+
+      FAIL() << "no exception";
+   }
+   catch (const std::runtime_error& e)
+   {
+      ASSERT_STREQ(e.what(), "check failed");
+   }
+
+   // the running check was waited for, nothing was started after the failure
+   ASSERT_EQ(std::count(events.begin(), events.end(), "independent"), 1);
+   ASSERT_EQ(std::count(events.begin(), events.end(), "dependent"), 0);
+
+   // output of the failed check and the checks before it is printed
+   ASSERT_EQ(output.size(), 2u);
+   ASSERT_EQ(output[0].first, "independent");
+   ASSERT_EQ(output[1].first, "failing");
+}
+
+TEST_F(TestCheckScheduler, exceptionPassedToCallerSequential)
+{
+   CheckScheduler scheduler(&workQueue, 1);
+
+   scheduler.add([] () { throw std::runtime_error("check failed"); });
+   scheduler.add([this] () { record("later"); });
+
+   ASSERT_THROW(scheduler.run(), std::runtime_error);
+   ASSERT_TRUE(events.empty() );
+}
@@ -1,3 +1,4 @@
+#include <database/Cursor.h>
 #include <database/Distinct.h>
 #include <database/Filter.h>
 #include <database/Group.h>
@@ -11,11 +12,34 @@
 #include <gtest/gtest.h>
 
 template<typename Obj, size_t Size>
-static VectorSource<Obj> vectorSource(const Obj (&data)[Size])
+static VectorSource<Obj> vectorSource(const Obj (&data)[Size], size_t batchSize = db::BATCH_SIZE)
 {
    std::vector<Obj> vector(data, data + Size);
 
-   return VectorSource<Obj>(vector);
+   return VectorSource<Obj>(vector, batchSize);
+}
+
+template<typename Source, typename Data, size_t Size, typename EqFn>
+static void expectBatches(const Source& source, const Data (&data)[Size], EqFn eqFn)
+{
+   Source current = source;
+   std::vector<typename Source::ElementType> batch;
+   size_t seen = 0;
+
+   while(current.nextBatch(batch) )
+   {
+      ASSERT_FALSE(batch.empty());
+
+      for(size_t i = 0; i < batch.size(); i++)
+      {
+         ASSERT_LT(seen, Size);
+         ASSERT_TRUE(eqFn(batch[i], data[seen]));
+         seen++;
+      }
+   }
+
+   ASSERT_TRUE(batch.empty());
+   ASSERT_EQ(seen, Size);
 }
 
 template<typename Source, typename Data, size_t Size, typename EqFn>
@@ -23,6 +47,8 @@ static void expect(const Source& source, const Data (&data)[Size], EqFn eqFn)
 {
    BOOST_STATIC_ASSERT(Size > 2);
 
+   expectBatches(source, data, eqFn);
+
    for(size_t markPos = 0; markPos < Size; markPos++)
    {
       boost::shared_ptr<typename Source::MarkerType> mark;
@@ -252,3 +278,146 @@ TEST(Cursors, distinct)
       | db::distinctBy(Fn::fn),
       expected);
 }
+
+TEST(Cursors, batchBoundaries)
+{
+   const int data1[] = { 1, 2, 2, 3, 4 };
+   const int data2[] = { 1, 2, 3, 3, 5 };
+
+   const std::pair<int, int> joined[] = {
+      std::make_pair(1, 1),
+      std::make_pair(2, 2),
+      std::make_pair(2, 2),
+      std::make_pair(3, 3),
+      std::make_pair(3, 3),
+      std::make_pair(4, 0),
+   };
+
+   const int merged[] = { 1, 1, 2, 2, 2, 3, 3, 3, 4, 5 };
+
+   const std::pair<int, int> grouped[] = {
+      std::make_pair(-1, 1),
+      std::make_pair(-2, 2),
+      std::make_pair(-3, 1),
+      std::make_pair(-4, 1),
+   };
+
+   struct Fn
+   {
+      static bool eq(std::pair<int, int*> left, std::pair<int, int> right)
+      {
+         return left.first == right.first &&
+            ( (right.second == 0 && left.second == NULL) ||
+              (right.second != 0 && left.second != NULL && right.second == *left.second) );
+      }
+
+      static int key(int i)
+      {
+         return i;
+      }
+   };
+
+   for(size_t batchSize = 1; batchSize <= 3; batchSize++)
+   {
+      expectBatches(
+         db::leftJoinBy(
+            Fn::key,
+            vectorSource(data1, batchSize),
+            vectorSource(data2, batchSize) ),
+         joined,
+         Fn::eq);
+
+      expectBatches(
+         db::unionBy(
+            Fn::key,
+            vectorSource(data1, batchSize),
+            vectorSource(data2, batchSize) ),
+         merged,
+         std::equal_to<int>() );
+
+      expectBatches(
+         vectorSource(data1, batchSize)
+         | db::groupBy(TestGroupOps() ),
+         grouped,
+         std::equal_to<std::pair<int, int> >() );
+   }
+}
+
+TEST(Cursors, batchNestedJoin)
+{
+   const int data1[] = { 1, 2, 3 };
+   const int data2[] = { 1, 1, 2 };
+   const int data3[] = { 1, 2, 2 };
+
+   typedef std::pair<int, int*> Inner;
+
+   struct Fn
+   {
+      static int key(int i)
+      {
+         return i;
+      }
+
+      static int innerKey(const Inner& inner)
+      {
+         return inner.first;
+      }
+
+      static bool eq(std::pair<int, Inner*> left, std::pair<int, int> right)
+      {
+         if(left.first != right.first)
+            return false;
+
+         if(right.second == 0)
+            return left.second == NULL || left.second->second == NULL;
+
+         return left.second != NULL && left.second->second != NULL &&
+            *left.second->second == right.second;
+      }
+   };
+
+   struct KeyFn
+   {
+      int operator()(int i) const { return Fn::key(i); }
+      int operator()(const Inner& inner) const { return Fn::innerKey(inner); }
+   };
+
+   // right-hand rows of the outer join point into the inner join, whose batches are replaced
+   // while the outer join still holds its current group
+   const std::pair<int, int> expected[] = {
+      std::make_pair(1, 1),
+      std::make_pair(1, 1),
+      std::make_pair(2, 2),
+      std::make_pair(2, 2),
+      std::make_pair(3, 0),
+   };
+
+   for(size_t batchSize = 1; batchSize <= 2; batchSize++)
+   {
+      expectBatches(
+         db::leftJoinBy(
+            KeyFn(),
+            vectorSource(data1, batchSize),
+            db::leftJoinBy(
+               Fn::key,
+               vectorSource(data3, batchSize),
+               vectorSource(data2, batchSize) ) ),
+         expected,
+         Fn::eq);
+   }
+}
+
+TEST(Cursors, cursor)
+{
+   const int data[] = { 1, 2, 3, 4, 5 };
+
+   Cursor<int> cursor(vectorSource(data, 2) );
+
+   for(size_t i = 0; i < 5; i++)
+   {
+      ASSERT_TRUE(cursor.step());
+      ASSERT_EQ(*cursor.get(), data[i]);
+   }
+
+   ASSERT_FALSE(cursor.step());
+}
@@ -672,6 +672,65 @@ DB_TEST(testCheckForAndInsertDanglingDirEntries)
    ASSERT_EQ(entries.size(), MISSING_EACH*2);
 }
 
+DB_TEST(testSharedTables)
+{
+   const std::string copyFile = this->databasePath + "/shared.dentries.t";
+
+   FsckDirEntryList dentries;
+   DatabaseTk::createDummyFsckDirEntries(0, 10, &dentries);
+
+   // the last two dentries have no inode, the very last one was modified
+   FsckFileInodeList fileInodes;
+   DatabaseTk::createDummyFsckFileInodes(0, 8, &fileInodes);
+
+   this->db->getModificationEventsTable()->insert(
+      FsckModificationEventList(1,
+         FsckModificationEvent(ModificationEvent_FILEMOVED, dentries.rbegin()->getID() ) ),
+      this->db->getModificationEventsTable()->newBulkHandle() );
+
+   this->db->getDentryTable()->insert(dentries);
+   this->db->getFileInodesTable()->insert(fileInodes);
+
+   FsckDirEntryList expected;
+   drainToList(this->db->findDanglingDirEntries(), expected);
+
+   ASSERT_EQ(expected.size(), 1u);
+   ASSERT_FALSE(this->db->sharedDentries.isMaterialized() );
+
+   // both consumers read the same copy, which is written when it is read the first time
+   this->db->addSharedTableConsumer(FsckDB::SharedTable_DENTRIES);
+   this->db->addSharedTableConsumer(FsckDB::SharedTable_DENTRIES);
+
+   Cursor<db::DirEntry> unread = this->db->findDanglingDirEntries();
+   ASSERT_FALSE(this->db->sharedDentries.isMaterialized() );
+
+   FsckDirEntryList entries;
+   drainToList(unread, entries);
+
+   ASSERT_EQ(entries, expected);
+   ASSERT_TRUE(this->db->sharedDentries.isMaterialized() );
+   ASSERT_EQ(::access(copyFile.c_str(), F_OK), 0);
+
+   this->db->releaseSharedTableConsumer(FsckDB::SharedTable_DENTRIES);
+
+   drainToList(this->db->findDanglingDirEntries(), entries);
+   ASSERT_EQ(entries, expected);
+
+   // the copy is removed once the last consumer was released and no cursor reads it anymore
+   this->db->releaseSharedTableConsumer(FsckDB::SharedTable_DENTRIES);
+   ASSERT_FALSE(this->db->sharedDentries.isMaterialized() );
+   ASSERT_EQ(::access(copyFile.c_str(), F_OK), 0);
+
+   unread = this->db->findDanglingDirEntries();
+   ASSERT_NE(::access(copyFile.c_str(), F_OK), 0);
+
+   drainToList(unread, entries);
+   ASSERT_EQ(entries, expected);
+
+   ASSERT_THROW(this->db->releaseSharedTableConsumer(FsckDB::SharedTable_DENTRIES),
+      std::logic_error);
+}
+
 DB_TEST(testCheckForAndInsertInodesWithWrongOwner)
 {
    unsigned NUM_INODES = 10;
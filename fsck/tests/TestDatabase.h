@@ -49,6 +49,7 @@ class TestDatabase: public ::testing::Test
       void testFindMismirroredDirectories();
 
       void testCheckForAndInsertDanglingDirEntries();
+      void testSharedTables();
       void testCheckForAndInsertInodesWithWrongOwner();
       void testCheckForAndInsertDirEntriesWithWrongOwner();
       void testCheckForAndInsertMissingDentryByIDFile();
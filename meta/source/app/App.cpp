@@ -23,6 +23,7 @@
 #include "common/app/config/ICommonConfig.h"
 #include "common/net/sock/IPAddress.h"
 
+#include <algorithm>
 #include <array>
 #include <mntent.h>
 #include <csignal>
@@ -73,6 +74,7 @@ App::App(int argc, char** argv)
    this->sessions = NULL;
    this->mirroredSessions = NULL;
    this->nodeOperationStats = NULL;
+   this->targetLoadStore = NULL;
    this->netMessageFactory = NULL;
    this->inodesPath = NULL;
    this->dentriesPath = NULL;
@@ -87,6 +89,8 @@ App::App(int argc, char** argv)
    this->gcQueue = new TimerQueue(1, 1);
    this->buddyResyncer = NULL;
    this->chunkBalancerJob = NULL;
+   this->chunkRebalancer = NULL;
+   this->metaBench = NULL;
 
    this->nextNumaBindTarget = 0;
 }
@@ -100,6 +104,8 @@ App::~App()
    workersDelete();
 
    SAFE_DELETE(this->buddyResyncer);
+   SAFE_DELETE(this->chunkRebalancer);
+   SAFE_DELETE(this->metaBench);
    SAFE_DELETE(this->timerQueue);
    SAFE_DELETE(this->modificationEventFlusher);
    SAFE_DELETE(this->internodeSyncer);
@@ -115,6 +121,7 @@ App::~App()
    SAFE_DELETE(this->buddyMirrorInodesPath);
    SAFE_DELETE(this->netMessageFactory);
    SAFE_DELETE(this->nodeOperationStats);
+   SAFE_DELETE(this->targetLoadStore);
    SAFE_DELETE(this->sessions);
    SAFE_DELETE(this->mirroredSessions);
    SAFE_DELETE(this->ackStore);
@@ -227,6 +234,7 @@ void App::runNormal()
 
    initStorage();
    initXAttrLimit();
+   DirInode::recoverWriteBehind(); // before any dirs are loaded
    initRootDir(localNodeNumID);
    initDisposalDir();
 
@@ -306,7 +314,8 @@ void App::runNormal()
       // 2. Initializes Unix socket for downstream event listeners (e.g., beegfs-event-listener)
       // 3. Starts a dedicated PThread (EventQ-Sender) that runs continuously to:
       //    a) Read events from the PMQ
-      //    b) Send events to the configured listener socket
+      //    b) Send events to the configured listener sockets (a comma-separated list, each
+      //       listener reads the queue at its own pace)
       //    c) Handle reconnections and periodic queue flushing
       // Note: EventQ-Sender thread will continue to run until the FileEventLogger is destroyed.
 
@@ -323,7 +332,10 @@ void App::runNormal()
       }
 
       FileEventLoggerParams params = {};
-      params.address = cfg->getFileEventLogTarget();
+      StringTk::explodeEx(cfg->getFileEventLogTarget(), ',', true, &params.addresses);
+      params.addresses.erase(
+            std::remove(params.addresses.begin(), params.addresses.end(), std::string()),
+            params.addresses.end());
       params.ids.nodeId = nodeId;
       params.ids.buddyGroupId = buddyGroupId;
 
@@ -372,6 +384,9 @@ void App::runNormal()
 
    joinComponents();
 
+   // no more dir updates after the workers are gone => store what write-behind kept in memory
+   metaStore->flushDirWriteBehind(true);
+
    // clean shutdown (at least no cache loss) => generate a new session file
    if(sessions)
       storeSessions();
@@ -450,6 +465,8 @@ void App::initDataObjects()
 
    this->nodeOperationStats = new MetaNodeOpStats();
 
+   this->targetLoadStore = new TargetLoadStore();
+
    this->isRootBuddyMirrored = false;
 }
 
@@ -636,6 +653,11 @@ void App::initStorage()
    StorageTk::initHashPaths(*buddyMirrorInodesPath,
       META_INODES_LEVEL1_SUBDIR_NUM, META_INODES_LEVEL2_SUBDIR_NUM);
 
+   // markers for dir inodes with unstored updates
+   if (cfg->getTuneDirMetadataWriteBehindMS() &&
+       !StorageTk::createPathOnDisk(Path(META_DIRTYDIRS_SUBDIR_NAME), false) )
+      throw InvalidConfigException("Unable to create directory: " META_DIRTYDIRS_SUBDIR_NAME);
+
    // raise file descriptor limit
    if(cfg->getTuneProcessFDLimit() )
    {
@@ -883,6 +905,11 @@ void App::initComponents(TargetConsistencyState initialConsistencyState)
 
    this->modificationEventFlusher = new ModificationEventFlusher();
 
+   if(cfg->getTuneChunkRebalanceInterval() )
+      this->chunkRebalancer = new ChunkRebalancer();
+
+   this->metaBench = new MetaBench();
+
    workersInit();
    commSlavesInit();
 
@@ -920,6 +947,9 @@ void App::startComponents()
 
    this->modificationEventFlusher->start();
 
+   if(chunkRebalancer)
+      this->chunkRebalancer->start();
+
    if(const auto wait = getConfig()->getTuneDisposalGCPeriod()) {
        this->gcQueue->enqueue(std::chrono::seconds(wait), disposalGarbageCollector);
    }
@@ -952,9 +982,16 @@ void App::stopComponents()
    if(buddyResyncer)
       buddyResyncer->shutdown();
 
+   // the rebalancer feeds the chunk balancer job, so it has to stop first
+   if(chunkRebalancer)
+      chunkRebalancer->selfTerminate();
+
    if(chunkBalancerJob)
       chunkBalancerJob->shutdown();
 
+   if(metaBench)
+      metaBench->shutdownBenchmark();
+
    workersStop();
 
    if(internodeSyncer)
@@ -1029,6 +1066,11 @@ void App::joinComponents()
    workersJoin();
 
    waitForComponentTermination(modificationEventFlusher);
+   waitForComponentTermination(chunkRebalancer);
+
+   if(metaBench)
+      metaBench->waitForShutdownBenchmark();
+
    waitForComponentTermination(dgramListener);
    waitForComponentTermination(connAcceptor);
 
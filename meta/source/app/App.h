@@ -24,10 +24,13 @@
 #include <components/DatagramListener.h>
 #include <components/FileEventLogger.h>
 #include <components/InternodeSyncer.h>
+#include <components/benchmarker/MetaBench.h>
 #include <components/buddyresyncer/BuddyResyncer.h>
 #include <components/chunkbalancer/ChunkBalancerJob.h>
+#include <components/chunkbalancer/ChunkRebalancer.h>
 #include <net/message/NetMessageFactory.h>
 #include <nodes/MetaNodeOpStats.h>
+#include <nodes/TargetLoadStore.h>
 #include <session/SessionStore.h>
 #include <storage/DirInode.h>
 #include <storage/MetaStore.h>
@@ -122,6 +125,7 @@ class App : public AbstractApp
       SessionStore* mirroredSessions;
       AcknowledgmentStore* ackStore;
       MetaNodeOpStats* nodeOperationStats; // file system operation statistics
+      TargetLoadStore* targetLoadStore; // storage node load for the loadaware target chooser
 
       std::string metaPathStr; // the general parent directory for all saved data
       Path* inodesPath; // contains the actualy file/directory metadata
@@ -145,6 +149,8 @@ class App : public AbstractApp
 
       BuddyResyncer* buddyResyncer;
       ChunkBalancerJob* chunkBalancerJob;
+      ChunkRebalancer* chunkRebalancer; // NULL if automatic rebalancing is disabled
+      MetaBench* metaBench;
       
       ExceededQuotaPerTarget exceededQuotaStores;
 
@@ -420,6 +426,11 @@ class App : public AbstractApp
          return nodeOperationStats;
       }
 
+      TargetLoadStore* getTargetLoadStore() const
+      {
+         return targetLoadStore;
+      }
+
       const Path* getInodesPath() const
       {
          return inodesPath;
@@ -495,6 +506,16 @@ class App : public AbstractApp
          chunkBalancerJob=chunkBalancerJobPtr;
       }
 
+      ChunkRebalancer* getChunkRebalancer() const
+      {
+         return chunkRebalancer;
+      }
+
+      MetaBench* getMetaBench() const
+      {
+         return metaBench;
+      }
+
       //should be called ONLY by the ChunkBalancerJob itself using selfShutdown()
       void cleanupChunkBalancerJob()
       {
@@ -11,6 +11,7 @@
 #define TARGETCHOOSERTYPE_RANDOMROBIN_STR       "randomrobin"
 #define TARGETCHOOSERTYPE_RANDOMINTERNODE_STR   "randominternode"
 #define TARGETCHOOSERTYPE_RANDOMINTRANODE_STR   "randomintranode"
+#define TARGETCHOOSERTYPE_LOADAWARE_STR         "loadaware"
 
 
 Config::Config(int argc, char** argv):
@@ -66,6 +67,8 @@ void Config::loadDefaults(bool addDashes)
    configMapRedefine("tuneBindToNumaZone",               "");
    configMapRedefine("tuneListenerPrioShift",            "-1");
    configMapRedefine("tuneDirMetadataCacheLimit",        "1024");
+   configMapRedefine("tuneDirMetadataWriteBehindMS",     "0");
+   configMapRedefine("tuneInlineFileDataMaxSize",        "0");
    configMapRedefine("tuneTargetChooser",                TARGETCHOOSERTYPE_RANDOMIZED_STR);
    configMapRedefine("tuneLockGrantWaitMS",              "333");
    configMapRedefine("tuneLockGrantNumRetries",          "15");
@@ -74,10 +77,17 @@ void Config::loadDefaults(bool addDashes)
    configMapRedefine("tuneUsePerUserMsgQueues",          "false");
    configMapRedefine("tuneUseAggressiveStreamPoll",      "false");
    configMapRedefine("tuneNumResyncSlaves",              "12");
+   configMapRedefine("tuneNumResyncGatherSlaves",        "6");
+   configMapRedefine("tuneResyncJournalMaxEntries",      "0");
    configMapRedefine("tuneMirrorTimestamps",             "true");
    configMapRedefine("tuneDisposalGCPeriod",             "0");
    configMapRedefine("tuneChunkBalanceQueueLimit",       "100000");
    configMapRedefine("tuneChunkBalanceLockingTimeLimit", "300");
+   configMapRedefine("tuneChunkRebalanceInterval",       "0");
+   configMapRedefine("tuneChunkRebalanceFillDiff",       "10");
+   configMapRedefine("tuneChunkRebalanceMaxBytesPerSec", "100m");
+   configMapRedefine("tuneChunkRebalanceMaxFilesPerSec", "100");
+   configMapRedefine("tuneChunkRebalanceMaxQueuedReqs",  "32");
 
 
    configMapRedefine("quotaEarlyChownResponse",    "true");
@@ -173,6 +183,18 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
          tuneListenerPrioShift = StringTk::strToInt(iter->second);
       else if (iter->first == std::string("tuneDirMetadataCacheLimit"))
          tuneDirMetadataCacheLimit = StringTk::strToUInt(iter->second);
+      else if (iter->first == std::string("tuneDirMetadataWriteBehindMS"))
+         tuneDirMetadataWriteBehindMS = StringTk::strToUInt(iter->second);
+      else if (iter->first == std::string("tuneInlineFileDataMaxSize"))
+      {
+         tuneInlineFileDataMaxSize = UnitTk::strHumanToInt64(iter->second);
+
+         if (tuneInlineFileDataMaxSize > 64*1024) // max size of an xattr value
+         {
+            throw InvalidConfigException("Invalid tuneInlineFileDataMaxSize value "
+                  + iter->second + " (must not be larger than 64KiB)");
+         }
+      }
       else if (iter->first == std::string("tuneTargetChooser"))
          tuneTargetChooser = iter->second;
       else if (iter->first == std::string("tuneLockGrantWaitMS"))
@@ -187,6 +209,10 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
          tuneUseAggressiveStreamPoll = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneNumResyncSlaves"))
          this->tuneNumResyncSlaves = StringTk::strToUInt(iter->second);
+      else if (iter->first == std::string("tuneNumResyncGatherSlaves"))
+         this->tuneNumResyncGatherSlaves = StringTk::strToUInt(iter->second);
+      else if (iter->first == std::string("tuneResyncJournalMaxEntries"))
+         this->tuneResyncJournalMaxEntries = StringTk::strToUInt(iter->second);
       else if (iter->first == std::string("quotaEarlyChownResponse"))
          quotaEarlyChownResponse = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("quotaEnableEnforcement"))
@@ -213,6 +239,16 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
          tuneChunkBalanceQueueLimit = StringTk::strToUInt(iter->second);
       else if(iter->first == std::string("tuneChunkBalanceLockingTimeLimit"))
          tuneChunkBalanceLockingTimeLimit = StringTk::strToUInt(iter->second);
+      else if(iter->first == std::string("tuneChunkRebalanceInterval"))
+         tuneChunkRebalanceInterval = StringTk::strToUInt(iter->second);
+      else if(iter->first == std::string("tuneChunkRebalanceFillDiff"))
+         tuneChunkRebalanceFillDiff = StringTk::strToUInt(iter->second);
+      else if(iter->first == std::string("tuneChunkRebalanceMaxBytesPerSec"))
+         tuneChunkRebalanceMaxBytesPerSec = UnitTk::strHumanToInt64(iter->second);
+      else if(iter->first == std::string("tuneChunkRebalanceMaxFilesPerSec"))
+         tuneChunkRebalanceMaxFilesPerSec = StringTk::strToUInt(iter->second);
+      else if(iter->first == std::string("tuneChunkRebalanceMaxQueuedReqs"))
+         tuneChunkRebalanceMaxQueuedReqs = StringTk::strToUInt(iter->second);
       else if (iter->first == std::string("sysFileEventLogTarget"))
          sysFileEventLogTarget = iter->second;
       else if (iter->first == std::string("sysFileEventPersistDirectory"))
@@ -310,6 +346,8 @@ void Config::initTuneTargetChooserNum()
       this->tuneTargetChooserNum = TargetChooserType_RANDOMROBIN;
    else if (this->tuneTargetChooser == TARGETCHOOSERTYPE_RANDOMINTERNODE_STR)
       this->tuneTargetChooserNum = TargetChooserType_RANDOMINTERNODE;
+   else if (this->tuneTargetChooser == TARGETCHOOSERTYPE_LOADAWARE_STR)
+      this->tuneTargetChooserNum = TargetChooserType_LOADAWARE;
    // Don't allow RANDOMINTRANODE Target Chooser
    else
    {
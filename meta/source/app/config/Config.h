@@ -11,6 +11,7 @@ enum TargetChooserType
    TargetChooserType_RANDOMROBIN = 2, // randomized round-robin (round-robin, but shuffle result)
    TargetChooserType_RANDOMINTERNODE = 3, // select random targets from different nodes/domains
    TargetChooserType_RANDOMINTRANODE = 4, // select random targets from the same node/domain
+   TargetChooserType_LOADAWARE = 5, // random, but prefer targets of less busy storage nodes
 };
 
 
@@ -53,6 +54,8 @@ class Config : public AbstractConfig
       int               tuneBindToNumaZone; // bind all threads to this zone, -1 means no binding
       int               tuneListenerPrioShift; // inc/dec thread priority of listener components
       unsigned          tuneDirMetadataCacheLimit;
+      unsigned          tuneDirMetadataWriteBehindMS; // 0 means write-through
+      unsigned          tuneInlineFileDataMaxSize; // 0 means disabled
       std::string       tuneTargetChooser;
       TargetChooserType tuneTargetChooserNum;  // auto-generated based on tuneTargetChooser
       unsigned          tuneLockGrantWaitMS; // time to wait for an ack per retry
@@ -62,10 +65,17 @@ class Config : public AbstractConfig
       bool              tuneUsePerUserMsgQueues; // true to use UserWorkContainer for MultiWorkQueue
       bool              tuneUseAggressiveStreamPoll; // true to not sleep on epoll in streamlisv2
       unsigned          tuneNumResyncSlaves;
+      unsigned          tuneNumResyncGatherSlaves;
+      unsigned          tuneResyncJournalMaxEntries; // 0 = no journal, always resync completely
       bool              tuneMirrorTimestamps;
       unsigned          tuneDisposalGCPeriod; // sleep between disposal garbage collector runs [seconds], 0 = disabled
       unsigned          tuneChunkBalanceQueueLimit;  //maximum number of items in chunk balancing queue
       unsigned          tuneChunkBalanceLockingTimeLimit; // maximum time in seconds that a file can be locked for chunk balancing
+      unsigned          tuneChunkRebalanceInterval; // seconds between automatic rebalance rounds, 0 = disabled
+      unsigned          tuneChunkRebalanceFillDiff; // percent above pool average that makes a target a source
+      int64_t           tuneChunkRebalanceMaxBytesPerSec; // 0 = unlimited
+      unsigned          tuneChunkRebalanceMaxFilesPerSec; // 0 = unlimited
+      unsigned          tuneChunkRebalanceMaxQueuedReqs; // skip busier storage nodes, 0 = no limit
 
       bool              quotaEarlyChownResponse; // true to send response before chunk files chown
       bool              quotaEnableEnforcement;
@@ -209,6 +219,16 @@ class Config : public AbstractConfig
          return tuneDirMetadataCacheLimit;
       }
 
+      unsigned getTuneDirMetadataWriteBehindMS() const
+      {
+         return tuneDirMetadataWriteBehindMS;
+      }
+
+      unsigned getTuneInlineFileDataMaxSize() const
+      {
+         return tuneInlineFileDataMaxSize;
+      }
+
       TargetChooserType getTuneTargetChooserNum() const
       {
          return tuneTargetChooserNum;
@@ -249,6 +269,16 @@ class Config : public AbstractConfig
          return tuneNumResyncSlaves;
       }
 
+      unsigned getTuneNumResyncGatherSlaves() const
+      {
+         return tuneNumResyncGatherSlaves;
+      }
+
+      unsigned getTuneResyncJournalMaxEntries() const
+      {
+         return tuneResyncJournalMaxEntries;
+      }
+
       bool getQuotaEarlyChownResponse() const
       {
          return quotaEarlyChownResponse;
@@ -287,6 +317,16 @@ class Config : public AbstractConfig
 
       unsigned getTuneChunkBalanceLockingTimeLimit() const { return tuneChunkBalanceLockingTimeLimit; }
 
+      unsigned getTuneChunkRebalanceInterval() const { return tuneChunkRebalanceInterval; }
+
+      unsigned getTuneChunkRebalanceFillDiff() const { return tuneChunkRebalanceFillDiff; }
+
+      int64_t getTuneChunkRebalanceMaxBytesPerSec() const { return tuneChunkRebalanceMaxBytesPerSec; }
+
+      unsigned getTuneChunkRebalanceMaxFilesPerSec() const { return tuneChunkRebalanceMaxFilesPerSec; }
+
+      unsigned getTuneChunkRebalanceMaxQueuedReqs() const { return tuneChunkRebalanceMaxQueuedReqs; }
+
       bool getSysAllowUserSetPattern() const { return sysAllowUserSetPattern; }
 
       bool getLimitXAttrListLength() const { return limitXAttrListLength; }
@@ -0,0 +1,105 @@
+#include "FileEventFilter.h"
+
+#include <algorithm>
+
+// Payload of a Request_Message_Filter packet: u32 type mask, u16 count +
+// (u16 length + bytes) path prefixes, u16 count + u32 user IDs.
+// Returns false if the payload is truncated.
+bool FileEventFilter::deserialize(Deserializer& des)
+{
+   uint16_t numPrefixes;
+   uint16_t numUserIds;
+
+   des % typeMask;
+
+   des % numPrefixes;
+   for (unsigned i = 0; i < numPrefixes && des.good(); i++)
+   {
+      uint16_t length;
+      des % length;
+
+      std::string prefix(length, '\0');
+      des.getBlock(&prefix[0], length);
+
+      if (des.good() && ! prefix.empty())
+         pathPrefixes.push_back(std::move(prefix));
+   }
+
+   des % numUserIds;
+   for (unsigned i = 0; i < numUserIds && des.good(); i++)
+   {
+      uint32_t userId;
+      des % userId;
+      userIds.push_back(userId);
+   }
+
+   std::sort(userIds.begin(), userIds.end());
+
+   return des.good();
+}
+
+// A prefix matches whole path components only: "/proj" matches "/proj" and
+// "/proj/a", but not "/project".
+bool FileEventFilter::matchesPath(const char *path, unsigned pathLen) const
+{
+   for (std::string const& prefix : pathPrefixes)
+   {
+      if (pathLen < prefix.size() || memcmp(path, prefix.data(), prefix.size()) != 0)
+         continue;
+
+      if (pathLen == prefix.size() || prefix.back() == '/' || path[prefix.size()] == '/')
+         return true;
+   }
+
+   return false;
+}
+
+bool FileEventFilter::matches(const void *data, size_t size) const
+{
+   if (empty())
+      return true;
+
+   // layout as written by FileEventLogItem::serialize()
+   Deserializer des(data, size);
+
+   uint16_t formatVersion = 0;
+   uint32_t eventFlags = 0;
+   uint64_t numHardlinks = 0;
+   uint32_t type = 0;
+
+   des % formatVersion % eventFlags % numHardlinks % type;
+
+   if (! des.good())
+      return true;  // let the subscriber deal with it
+
+   if (typeMask != 0 && (type >= 32 || ! (typeMask & (1u << type))))
+      return false;
+
+   const char *entryId = nullptr, *parentId = nullptr, *path = nullptr;
+   const char *targetPath = nullptr, *targetParentId = nullptr;
+   unsigned entryIdLen = 0, parentIdLen = 0, pathLen = 0, targetPathLen = 0;
+   unsigned targetParentIdLen = 0;
+   uint32_t msgUserId = 0;
+
+   des
+      % serdes::rawString(entryId, entryIdLen)
+      % serdes::rawString(parentId, parentIdLen)
+      % serdes::rawString(path, pathLen)
+      % serdes::rawString(targetPath, targetPathLen)
+      % serdes::rawString(targetParentId, targetParentIdLen)
+      % msgUserId;
+
+   if (! des.good())
+      return true;
+
+   if (! pathPrefixes.empty()
+         && ! matchesPath(path, pathLen)
+         && ! (targetPathLen > 0 && matchesPath(targetPath, targetPathLen)))
+      return false;
+
+   if (! userIds.empty()
+         && ! std::binary_search(userIds.begin(), userIds.end(), msgUserId))
+      return false;
+
+   return true;
+}
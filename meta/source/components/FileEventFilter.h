@@ -0,0 +1,27 @@
+#pragma once
+
+#include <common/toolkit/serialization/Serialization.h>
+
+#include <string>
+#include <vector>
+
+// Subscriber-supplied filter for the message stream. An event is sent if it
+// matches all criteria that are set. Matching works on the serialized
+// FileEventLogItem, so filtered events cost neither allocations nor packets.
+struct FileEventFilter
+{
+   uint32_t typeMask = 0;  // bit (1 << FileEventType); 0 matches all types
+   std::vector<std::string> pathPrefixes;  // matches path or targetPath; empty matches all
+   std::vector<uint32_t> userIds;  // sorted; empty matches all
+
+   bool empty() const
+   {
+      return typeMask == 0 && pathPrefixes.empty() && userIds.empty();
+   }
+
+   bool deserialize(Deserializer& des);
+   bool matches(const void *data, size_t size) const;
+
+private:
+   bool matchesPath(const char *path, unsigned pathLen) const;
+};
@@ -1,4 +1,5 @@
 #include "FileEventLogger.h"
+#include "FileEventFilter.h"
 
 #include <common/app/config/AbstractConfig.h>
 #include <common/memory/String.h>
@@ -20,6 +21,9 @@
 #include <mutex>
 #include <condition_variable>
 #include <thread>
+#include <algorithm>
+#include <memory>
+#include <vector>
 #include <pthread.h>
 #include <cstdarg>
 
@@ -246,7 +250,7 @@ bool SocketState::tryConnect()
    sockReconnectTimer.clear();
 
    haveConnected = true;
-   LOG(EVENTLOGGER, NOTICE, "Reconnected.");
+   LOG(EVENTLOGGER, NOTICE, "Reconnected.", ("sockPath", unixAddr.getPath()));
    return true;
 }
 
@@ -273,6 +277,10 @@ enum class PacketType : uint8_t
    // This is the last message sent by the server.
    // Includes a ConnTerminateReason
    Send_Close,
+   // Client restricts the message stream to matching events. Can be sent at
+   // any time, applies to all messages read after it was received.
+   // Servers that don't know this packet ignore it and send all events.
+   Request_Message_Filter,
 };
 
 enum class ConnTerminateReason
@@ -306,6 +314,7 @@ static const char *packetTypeString(PacketType packetType)
       PTSTRING(Send_Message);
       PTSTRING(Close_Request);
       PTSTRING(Send_Close);
+      PTSTRING(Request_Message_Filter);
       default: return "(invalid packet type)";
    }
 }
@@ -433,6 +442,16 @@ public:
       return getPacket(rd);
    }
 
+   bool empty() const
+   {
+      return wr == rd;
+   }
+
+   bool full() const
+   {
+      return wr - rd == count;
+   }
+
    void dequeueEnd()
    {
       assert(wr - rd > 0);
@@ -618,12 +637,10 @@ static void read_u16(PacketReader& reader, uint16_t& x)
    reader.deserializer % x;
 }
 
-/* currently unused
 static void read_u32(PacketReader& reader, uint32_t & x)
 {
    reader.deserializer % x;
 }
-*/
 
 static void read_u64(PacketReader& reader, uint64_t& x)
 {
@@ -640,6 +657,7 @@ static void read_slice(PacketReader& reader, WO_Slice slice)
 struct MessageStream
 {
    PMQ_Reader_Handle reader;
+   FileEventFilter filter;
    PMQ_Read_Result lastPmqError = PMQ_Read_Result_Success;
    // Currently buffering 1 message only.
    bool msgIsPresent = false;
@@ -659,6 +677,9 @@ public:
    void seek(uint64_t msn);
    bool checkMsg();
    void clearMsg() { msgIsPresent = false; }
+
+private:
+   bool readMsg();
 };
 
 bool MessageStream::init(PMQ *pmq)
@@ -693,11 +714,30 @@ void MessageStream::seek(uint64_t msn)
 // Lock the queue and read the next message from the queue.
 // While there is no message, we also make sure that the queue gets flushed as scheduled.
 // We try to minimize the time where the queue is locked.
+// Messages that don't match the filter are skipped. To not starve other
+// subscribers, only a limited number of them is skipped per call; the caller
+// sees no message then but the reader is not at EOF, so it gets called again.
 bool MessageStream::checkMsg()
 {
    if (msgIsPresent)
       return true;
 
+   for (unsigned skipped = 0; skipped < 1024; skipped++)
+   {
+      if (! readMsg())
+         return false;
+
+      if (filter.matches(msgBuffer.data(), msgSize))
+         return true;
+
+      msgIsPresent = false;
+   }
+
+   return false;
+}
+
+bool MessageStream::readMsg()
+{
    msgSize = 0;
    msgMsn = pmq_reader_get_current_msn(reader);
 
@@ -929,6 +969,26 @@ static void processPacket(Subscriber *s, PacketBuffer *packet)
          s->closeRequested = true;
       }
       break;
+      case PacketType::Request_Message_Filter:
+      {
+         FileEventFilter filter;
+
+         filter.deserialize(reader.deserializer);
+
+         if (! packetEnd(s, reader))
+         {
+            malformedPacket(s, "Invalid Request_Message_Filter packet");
+            return;
+         }
+
+         LOG(EVENTLOGGER, NOTICE, "Subscriber installed event filter.",
+               ("typeMask", filter.typeMask),
+               ("numPathPrefixes", filter.pathPrefixes.size()),
+               ("numUserIds", filter.userIds.size()));
+
+         s->messageStream.filter = std::move(filter);
+      }
+      break;
       default:
       break;
    }
@@ -1136,19 +1196,30 @@ struct EventLoggerShared
 };
 
 
+// A subscriber and the address it connects to. The Subscriber state gets reset
+// whenever the connection terminates, the address stays.
+struct SubscriberSlot
+{
+   MallocString address;
+   Subscriber subscriber;
+};
+
 // State of the worker thread which has multiple responsibilities:
 //  - flushing/syncing the PMQ so that new messages are safely persisted to disk.
 //  - reading messages from the PMQ and forwarding them to downstream services
+//
+// Each subscriber reads the PMQ through its own PMQ_Reader, so it has its own
+// MSN cursor, and it has its own packet queues. The worker serves the
+// subscribers in turn and never blocks on any of them: a subscriber that can't
+// keep up only falls behind (and eventually loses messages that the PMQ
+// discards), but it does not hold back the others or the enqueuers.
 struct EventLoggerWorker
 {
    PMQ *pmq = nullptr;
    MutexProtected<EventLoggerShared> *shared = nullptr;
    FileEventLoggerIds ids;
 
-   MallocString address;
-
-   // only 1 simultaneous subscriber currently.
-   Subscriber subscriber;
+   std::vector<std::unique_ptr<SubscriberSlot>> subscribers;
 };
 
 struct EventLoggerWorkerParams
@@ -1156,24 +1227,36 @@ struct EventLoggerWorkerParams
    PMQ *pmq;
    MutexProtected<EventLoggerShared> *shared;
    FileEventLoggerIds ids;
-   StringZ address;
+   std::vector<std::string> const *addresses;
 };
 
 [[nodiscard]]
-static bool workerResetSubscriber(EventLoggerWorker *worker)
+static bool workerResetSubscriber(EventLoggerWorker *worker, SubscriberSlot *slot)
 {
-   return resetSubscriber(&worker->subscriber,
-         worker->pmq, worker->address, worker->ids);
+   return resetSubscriber(&slot->subscriber,
+         worker->pmq, slot->address, worker->ids);
 }
 
 static bool initWorker(EventLoggerWorker *worker, EventLoggerWorkerParams const& params)
 {
    worker->pmq = params.pmq;
    worker->shared = params.shared;
-   if (! worker->address.reset(params.address))
-      return false;
    worker->ids = params.ids;
-   return workerResetSubscriber(worker);
+
+   for (std::string const& address : *params.addresses)
+   {
+      auto slot = std::make_unique<SubscriberSlot>();
+
+      if (! slot->address.reset(StringZ::fromZeroTerminated(address.c_str(), address.size())))
+         return false;
+
+      if (! workerResetSubscriber(worker, slot.get()))
+         return false;
+
+      worker->subscribers.push_back(std::move(slot));
+   }
+
+   return true;
 }
 
 // Flush/sync the PMQ
@@ -1203,7 +1286,7 @@ struct Worker_Wait_Result
    bool mustReconnect = false;
 };
 
-static void workerWait(EventLoggerWorker *worker, Subscriber const *subscriber, Worker_Wait_Result *result)
+static void workerWait(EventLoggerWorker *worker, Worker_Wait_Result *result)
 {
    *result = Worker_Wait_Result();
 
@@ -1217,9 +1300,26 @@ static void workerWait(EventLoggerWorker *worker, Subscriber const *subscriber,
       return;
    }
 
-   result->haveMessage = subscriber->streaming && ! pmq_reader_eof(subscriber->messageStream.reader.get());
+   // Subscribers whose socket didn't take all packets (their tx queue is not
+   // empty) are retried soon, but don't keep the worker busy.
+   bool haveBacklog = false;
+
+   for (auto const& slot : worker->subscribers)
+   {
+      Subscriber const *subscriber = &slot->subscriber;
+
+      if (subscriber->streaming && ! subscriber->txQueue.full()
+            && ! pmq_reader_eof(subscriber->messageStream.reader.get()))
+         result->haveMessage = true;
+
+      if (subscriber->socketState.sockReconnectTimer.hasElapsed(now))
+         result->mustReconnect = true;
+
+      if (! subscriber->txQueue.empty())
+         haveBacklog = true;
+   }
+
    result->mustFlush = shared->flushTimer.hasElapsed(now);
-   result->mustReconnect = subscriber->socketState.sockReconnectTimer.hasElapsed(now);
 
    if (result->haveMessage) return;
    if (result->mustFlush) return;
@@ -1233,13 +1333,18 @@ static void workerWait(EventLoggerWorker *worker, Subscriber const *subscriber,
 
    ++ shared->numReadersWaiting;
    {
-      TimePoint waitEndTime = now + Milliseconds(50);
+      TimePoint waitEndTime = now + Milliseconds(haveBacklog ? 5 : 50);
 
       if (shared->flushTimer.isSet())
          waitEndTime = std::min(waitEndTime, shared->flushTimer.getEndTime());
 
-      if (subscriber->socketState.sockReconnectTimer.isSet())
-         waitEndTime = std::min(waitEndTime, subscriber->socketState.sockReconnectTimer.getEndTime());
+      for (auto const& slot : worker->subscribers)
+      {
+         Timer const& reconnectTimer = slot->subscriber.socketState.sockReconnectTimer;
+
+         if (reconnectTimer.isSet())
+            waitEndTime = std::min(waitEndTime, reconnectTimer.getEndTime());
+      }
 
       shared->readerCond.wait_until(shared.get_unique_lock(), waitEndTime);
    }
@@ -1253,7 +1358,7 @@ static void workerThreadRoutine(EventLoggerWorker *worker)
    {
       Worker_Wait_Result waitResult;
 
-      workerWait(worker, &worker->subscriber, &waitResult);
+      workerWait(worker, &waitResult);
 
       if (waitResult.shuttingDown)
       {
@@ -1265,13 +1370,18 @@ static void workerThreadRoutine(EventLoggerWorker *worker)
          workerFlush(worker);
       }
 
-      subscriberDoWork(&worker->subscriber);
-
-      if (worker->subscriber.terminated)
+      for (auto& slot : worker->subscribers)
       {
-         if (! workerResetSubscriber(worker))
+         if (! slot->subscriber.terminated)
+            subscriberDoWork(&slot->subscriber);
+
+         if (slot->subscriber.terminated)
          {
-            // What should we do? Probably this shouldn't even happen so...
+            if (! workerResetSubscriber(worker, slot.get()))
+            {
+               // What should we do? Probably this shouldn't even happen so...
+               // The subscriber stays terminated, we retry on the next round.
+            }
          }
       }
    }
@@ -1379,8 +1489,7 @@ struct FileEventLogger
 
 FileEventLogger *createFileEventLogger(FileEventLoggerParams const& params)
 {
-   assert(! params.address.empty());
-   StringZ address = StringZ::fromZeroTerminated(params.address.c_str(), params.address.size());
+   assert(! params.addresses.empty());
 
    std::unique_ptr<FileEventLogger, decltype(&destroyFileEventLogger)> logger { nullptr, destroyFileEventLogger };
 
@@ -1397,7 +1506,7 @@ FileEventLogger *createFileEventLogger(FileEventLoggerParams const& params)
    EventLoggerWorkerParams workerParams = {};
    workerParams.pmq = logger->pmq.get();
    workerParams.shared = &logger->shared;
-   workerParams.address = address;
+   workerParams.addresses = &params.addresses;
    workerParams.ids = params.ids;
 
    logger->workerThread.startWorkerThread(workerParams);
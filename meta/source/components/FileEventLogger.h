@@ -3,6 +3,7 @@
 #include <common/storage/FileEvent.h>
 #include <common/storage/EntryInfo.h>
 #include <string>
+#include <vector>
 
 struct EventContext
 {
@@ -31,7 +32,8 @@ struct FileEventLoggerIds
 
 struct FileEventLoggerParams
 {
-   std::string address;
+   // one subscriber per address, each receiving the complete event stream
+   std::vector<std::string> addresses;
    FileEventLoggerIds ids;
 };
 
@@ -2,6 +2,8 @@
 #include <common/net/message/nodes/ChangeTargetConsistencyStatesMsg.h>
 #include <common/net/message/nodes/ChangeTargetConsistencyStatesRespMsg.h>
 #include <common/net/message/nodes/RefreshCapacityPoolsMsg.h>
+#include <common/net/message/mon/RequestStorageDataMsg.h>
+#include <common/net/message/mon/RequestStorageDataRespMsg.h>
 #include <common/net/message/storage/SetStorageTargetInfoMsg.h>
 #include <common/net/message/storage/SetStorageTargetInfoRespMsg.h>
 #include <common/net/message/storage/quota/RequestExceededQuotaMsg.h>
@@ -86,6 +88,7 @@ void InternodeSyncer::syncLoop()
    const unsigned downloadNodesIntervalMS = 300000; // 5 min
    const unsigned updateStoragePoolsMS = downloadNodesIntervalMS;
    const unsigned checkNetworkIntervalMS = 60*1000; // 1 minute
+   const unsigned updateTargetLoadsMS = 10*1000; // 10sec
 
    Time lastCapacityUpdateT;
    Time lastMetaCacheSweepT;
@@ -96,6 +99,7 @@ void InternodeSyncer::syncLoop()
    Time lastStoragePoolsUpdateT;
    Time lastCapacityPublishedT;
    Time lastCheckNetworkT;
+   Time lastTargetLoadsUpdateT;
    bool doRegisterLocalNode = false;
 
    unsigned currentCacheSweepMS = metaCacheSweepNormalMS; // (adapted inside the loop below)
@@ -164,6 +168,9 @@ void InternodeSyncer::syncLoop()
          lastMetaCacheSweepT.setToNow();
       }
 
+      if (cfg->getTuneDirMetadataWriteBehindMS() )
+         app->getMetaStore()->flushDirWriteBehind(false);
+
       if(lastIdleDisconnectT.elapsedMS() > idleDisconnectIntervalMS)
       {
          dropIdleConns();
@@ -200,6 +207,13 @@ void InternodeSyncer::syncLoop()
          publishNodeCapacity();
          lastCapacityPublishedT.setToNow();
       }
+
+      if ( (cfg->getTuneTargetChooserNum() == TargetChooserType_LOADAWARE)
+         && (lastTargetLoadsUpdateT.elapsedMS() > updateTargetLoadsMS) )
+      {
+         updateTargetLoads();
+         lastTargetLoadsUpdateT.setToNow();
+      }
    }
 }
 
@@ -791,6 +805,70 @@ bool InternodeSyncer::downloadAndSyncStoragePools()
    return true;
 }
 
+/**
+ * Fetch the recent load of all storage nodes for the loadaware target chooser.
+ *
+ * The load is optional, so nodes without an online target are skipped and requests use the short
+ * messaging timeout to not hold up the other tasks of the sync loop. Nodes that can't be asked keep
+ * their last load until it expires in the TargetLoadStore.
+ */
+void InternodeSyncer::updateTargetLoads()
+{
+   App* app = Program::getApp();
+   NodeStoreServers* storageNodes = app->getStorageNodes();
+   TargetMapper* targetMapper = app->getTargetMapper();
+   TargetStateStore* targetStates = app->getTargetStateStore();
+   TargetLoadStore* targetLoadStore = app->getTargetLoadStore();
+
+   for (const auto& node : storageNodes->referenceAllNodes() )
+   {
+      const NumNodeID nodeID = node->getNumID();
+
+      if (!hasOnlineTarget(nodeID, targetMapper, targetStates) )
+         continue;
+
+      RequestStorageDataMsg msg(targetLoadStore->getLastStatsTimeMS(nodeID) );
+
+      RequestResponseArgs rrArgs(node.get(), &msg, NETMSGTYPE_RequestStorageDataResp);
+      rrArgs.maxTimeoutMS = app->getConfig()->getConnMsgShortTimeout();
+
+      if (!MessagingTk::requestResponse(&rrArgs) )
+      {
+         LOG_DEBUG(__func__, Log_DEBUG,
+            "Unable to fetch storage data from node: " + node->getNodeIDWithTypeStr() );
+         continue;
+      }
+
+      auto* resp = (RequestStorageDataRespMsg*)rrArgs.outRespMsg.get();
+
+      targetLoadStore->updateNodeLoad(nodeID, resp->getStatsList(),
+         resp->getIndirectWorkListSize() + resp->getDirectWorkListSize() );
+   }
+
+   targetLoadStore->updateTargetWeights(targetMapper);
+}
+
+/**
+ * @return true if at least one target of the node is online
+ */
+bool InternodeSyncer::hasOnlineTarget(NumNodeID nodeID, TargetMapper* targetMapper,
+   TargetStateStore* targetStates)
+{
+   UInt16List targetIDs;
+   targetMapper->getTargetsByNode(nodeID, targetIDs);
+
+   for (auto iter = targetIDs.begin(); iter != targetIDs.end(); iter++)
+   {
+      CombinedTargetState state;
+
+      if (targetStates->getState(*iter, state)
+            && state.reachabilityState == TargetReachabilityState_ONLINE)
+         return true;
+   }
+
+   return false;
+}
+
 /**
  * Download and sync storage target states and mirror buddy groups.
  */
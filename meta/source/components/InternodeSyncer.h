@@ -30,6 +30,7 @@ class InternodeSyncer : public PThread
       static bool downloadAndSyncTargetMappings();
       static bool downloadAndSyncStoragePools();
       static bool downloadAndSyncTargetStatesAndBuddyGroups();
+      static void updateTargetLoads();
 
       static void downloadAndSyncClients(bool requeue);
 
@@ -89,6 +90,9 @@ class InternodeSyncer : public PThread
 
       static bool downloadAllExceededQuotaLists(const StoragePoolPtr storagePool);
 
+      static bool hasOnlineTarget(NumNodeID nodeID, TargetMapper* targetMapper,
+         TargetStateStore* targetStates);
+
    public:
       // inliners
       void setForcePoolsUpdate()
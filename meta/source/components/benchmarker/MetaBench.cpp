@@ -0,0 +1,580 @@
+#include <common/storage/striping/Raid0Pattern.h>
+#include <common/toolkit/StringTk.h>
+#include <common/toolkit/TimeAbs.h>
+#include <common/toolkit/TimeFine.h>
+#include <program/Program.h>
+#include <storage/DirInode.h>
+#include <storage/MetaStore.h>
+#include "MetaBench.h"
+
+#include <boost/lexical_cast.hpp>
+
+#define METABENCH_DIR_ID_PREFIX        "metabench."
+#define METABENCH_LIST_BATCH_SIZE      1024
+
+
+/*
+ * one thread of the benchmark, runs the current phase over all files of the thread
+ */
+class MetaBench::BenchThread : public PThread
+{
+   public:
+      BenchThread(unsigned index, DirInode& dir, unsigned numFiles,
+         const std::atomic<bool>& stopRequested)
+       : PThread("MetaBench" + StringTk::uintToStr(index) ),
+         index(index), dir(dir), numFiles(numFiles), stopRequested(stopRequested),
+         files(numFiles), op(MetaBenchOp_CREATE), numErrors(0)
+      {
+      }
+
+      virtual void run()
+      {
+         for (unsigned i = 0; (i < numFiles) && !stopRequested.load(std::memory_order_relaxed); i++)
+         {
+            TimeFine startTime;
+
+            FhgfsOpsErr opRes = runOp(i);
+
+            histogram.add(startTime.elapsedMicro() );
+
+            if (opRes != FhgfsOpsErr_SUCCESS)
+               numErrors++;
+         }
+      }
+
+   private:
+      unsigned index;
+      DirInode& dir;
+      unsigned numFiles;
+      const std::atomic<bool>& stopRequested;
+
+      std::vector<EntryInfo> files; // set by the create phase
+
+      MetaBenchOp op;
+      LatencyHistogram histogram;
+      uint64_t numErrors;
+
+      FhgfsOpsErr runOp(unsigned fileIndex);
+
+      /*
+       * @param renamed true for the name after the rename phase
+       */
+      std::string getFileName(unsigned fileIndex, bool renamed) const
+      {
+         return (renamed ? "r" : "f") + StringTk::uintToStr(index) + "." +
+            StringTk::uintToStr(fileIndex);
+      }
+
+   public:
+      // inliners
+
+      void setOp(MetaBenchOp op)
+      {
+         this->op = op;
+         this->histogram.clear();
+         this->numErrors = 0;
+      }
+
+      const LatencyHistogram& getHistogram() const
+      {
+         return histogram;
+      }
+
+      uint64_t getNumErrors() const
+      {
+         return numErrors;
+      }
+};
+
+FhgfsOpsErr MetaBench::BenchThread::runOp(unsigned fileIndex)
+{
+   MetaStore* metaStore = Program::getApp()->getMetaStore();
+   EntryInfo& entryInfo = files[fileIndex];
+
+   switch (op)
+   {
+      case MetaBenchOp_CREATE:
+      {
+         MkFileDetails mkDetails(getFileName(fileIndex, false), 0, 0, S_IFREG | 0644, 0,
+            TimeAbs().getTimeval()->tv_sec);
+         FileInodeStoreData inodeData;
+
+         // the pattern of the scratch dir has no targets, so no storage server is involved
+         return metaStore->mkNewMetaFile(dir, &mkDetails,
+            std::unique_ptr<StripePattern>(dir.getStripePatternClone() ), NULL, &entryInfo,
+            &inodeData);
+      }
+
+      case MetaBenchOp_STAT:
+      {
+         StatData statData;
+         return metaStore->stat(&entryInfo, true, statData);
+      }
+
+      case MetaBenchOp_OPENCLOSE:
+      {
+         MetaFileHandle inode;
+
+         FhgfsOpsErr openRes = metaStore->openFile(&entryInfo, OPENFILE_ACCESS_READ, true, inode);
+         if (openRes != FhgfsOpsErr_SUCCESS)
+            return openRes;
+
+         unsigned numHardlinks;
+         unsigned numInodeRefs;
+         bool lastWriterClosed;
+
+         metaStore->closeFile(&entryInfo, std::move(inode), OPENFILE_ACCESS_READ, &numHardlinks,
+            &numInodeRefs, lastWriterClosed);
+
+         return FhgfsOpsErr_SUCCESS;
+      }
+
+      case MetaBenchOp_RENAME:
+      {
+         std::unique_ptr<FileInode> unlinkInode;
+         DirEntry* overWrittenEntry = NULL;
+         bool unlinkedWasInlined;
+
+         FhgfsOpsErr renameRes = metaStore->renameInSameDir(dir, getFileName(fileIndex, false),
+            getFileName(fileIndex, true), &unlinkInode, overWrittenEntry, unlinkedWasInlined);
+
+         SAFE_DELETE(overWrittenEntry); // target names are unique, so nothing gets overwritten
+
+         return renameRes;
+      }
+
+      case MetaBenchOp_UNLINK:
+      {
+         EntryInfo unlinkedInfo;
+         std::unique_ptr<FileInode> unlinkedInode; // no chunk files to unlink
+         unsigned numHardlinks;
+
+         return metaStore->unlinkFile(dir, getFileName(fileIndex, true), &unlinkedInfo,
+            &unlinkedInode, numHardlinks);
+      }
+
+      default:
+         return FhgfsOpsErr_INTERNAL;
+   }
+}
+
+
+MetaBench::MetaBench()
+ : PThread("MetaBench"),
+   status(StorageBenchStatus_UNINITIALIZED),
+   lastRunErrorCode(STORAGEBENCH_ERROR_NO_ERROR),
+   numThreads(1),
+   numFiles(1),
+   sharedDir(false),
+   stopRequested(false)
+{
+}
+
+MetaBench::~MetaBench()
+{
+}
+
+/*
+ * initialize and starts the metadata benchmark with the given informations
+ *
+ * @param numThreads the number of threads which work on the MetaStore
+ * @param numFiles the number of files per thread
+ * @param sharedDir true if all threads work in the same directory
+ * @return the error code, 0 if the benchmark was started successfully (STORAGEBENCH_ERROR..)
+ */
+int MetaBench::initAndStartMetaBench(unsigned numThreads, unsigned numFiles, bool sharedDir)
+{
+   const char* logContext = "Meta Benchmark (init)";
+
+   const std::lock_guard<Mutex> lock(statusMutex);
+
+   if (STORAGEBENCHSTATUS_IS_ACTIVE(this->status) )
+   {
+      LogContext(logContext).logErr("Benchmark is already running. It's not possible to start a "
+         "benchmark if a benchmark is running.");
+      return STORAGEBENCH_ERROR_RUNTIME_IS_RUNNING;
+   }
+
+   if (!numThreads || (numThreads > METABENCH_MAX_THREADS) || !numFiles)
+   {
+      LogContext(logContext).logErr("Invalid benchmark parameters. "
+         "Threads: " + StringTk::uintToStr(numThreads) + "; "
+         "files per thread: " + StringTk::uintToStr(numFiles) );
+      return STORAGEBENCH_ERROR_INITIALIZATION_ERROR;
+   }
+
+   this->numThreads = numThreads;
+   this->numFiles = numFiles;
+   this->sharedDir = sharedDir;
+   this->stopRequested = false;
+   this->lastRunErrorCode = STORAGEBENCH_ERROR_NO_ERROR;
+
+   {
+      const std::lock_guard<Mutex> resultsLock(resultsMutex);
+      this->results.clear();
+   }
+
+   this->resetSelfTerminate();
+
+   try
+   {
+      this->start();
+      this->status = StorageBenchStatus_RUNNING;
+   }
+   catch (PThreadCreateException& e)
+   {
+      LogContext(logContext).logErr(std::string("Unable to start thread: ") + e.what() );
+      this->lastRunErrorCode = STORAGEBENCH_ERROR_INITIALIZATION_ERROR;
+      this->status = StorageBenchStatus_ERROR;
+   }
+
+   return this->lastRunErrorCode;
+}
+
+void MetaBench::run()
+{
+   const char* logContext = "Meta Benchmark (run)";
+   LogContext(logContext).log(Log_CRITICAL, "Benchmark started...");
+
+   // leftovers of an interrupted run would use the same directory IDs
+   if (!removeScratchDirs() )
+   {
+      this->lastRunErrorCode = STORAGEBENCH_ERROR_RUNTIME_DELETE_FOLDER;
+      setStatus(StorageBenchStatus_ERROR);
+      return;
+   }
+
+   std::vector<DirInode*> dirs;
+
+   if (!createScratchDirs(&dirs) )
+   {
+      releaseScratchDirs(dirs);
+      removeScratchDirs();
+
+      this->lastRunErrorCode = STORAGEBENCH_ERROR_INIT_CREATE_BENCH_FOLDER;
+      setStatus(StorageBenchStatus_ERROR);
+      return;
+   }
+
+   {
+      std::vector<std::unique_ptr<BenchThread>> threads;
+
+      for (unsigned i = 0; i < numThreads; i++)
+         threads.emplace_back(new BenchThread(i, *dirs[sharedDir ? 0 : i], numFiles,
+            stopRequested) );
+
+      for (int op = 0; op < MetaBenchOp_NUMOPS; op++)
+      {
+         if (stopRequested)
+            break;
+
+         runPhase( (MetaBenchOp)op, threads);
+      }
+   }
+
+   releaseScratchDirs(dirs);
+
+   if (!removeScratchDirs() )
+   {
+      LogContext(logContext).logErr("Unable to remove scratch directories.");
+      this->lastRunErrorCode = STORAGEBENCH_ERROR_RUNTIME_DELETE_FOLDER;
+   }
+
+   if (stopRequested)
+   {
+      setStatus(StorageBenchStatus_STOPPED);
+      LogContext(logContext).log(Log_CRITICAL, "Benchmark stopped.");
+   }
+   else
+   if (this->lastRunErrorCode != STORAGEBENCH_ERROR_NO_ERROR)
+   {
+      setStatus(StorageBenchStatus_ERROR);
+      LogContext(logContext).log(Log_CRITICAL, "Benchmark finished with errors.");
+   }
+   else
+   {
+      setStatus(StorageBenchStatus_FINISHED);
+      LogContext(logContext).log(Log_CRITICAL, "Benchmark finished.");
+   }
+}
+
+/*
+ * runs one phase in all threads and waits for them to finish
+ */
+void MetaBench::runPhase(MetaBenchOp op, std::vector<std::unique_ptr<BenchThread>>& threads)
+{
+   const char* logContext = "Meta Benchmark (run)";
+
+   LOG_DEBUG(logContext, Log_DEBUG, "Starting phase: " + StringTk::intToStr(op) );
+
+   TimeFine startTime;
+   unsigned numStarted = 0;
+
+   for (auto iter = threads.begin(); iter != threads.end(); iter++)
+   {
+      (*iter)->setOp(op);
+
+      try
+      {
+         (*iter)->start();
+         numStarted++;
+      }
+      catch (PThreadCreateException& e)
+      {
+         LogContext(logContext).logErr(std::string("Unable to start thread: ") + e.what() );
+         this->lastRunErrorCode = STORAGEBENCH_ERROR_RUNTIME_ERROR;
+         this->stopRequested = true;
+         break;
+      }
+   }
+
+   for (unsigned i = 0; i < numStarted; i++)
+      threads[i]->join();
+
+   const uint64_t elapsedMS = startTime.elapsedMS();
+
+   MetaBenchOpResult result;
+   LatencyHistogram histogram;
+
+   result.op = op;
+   result.elapsedMS = elapsedMS;
+   result.numErrors = 0;
+
+   for (unsigned i = 0; i < numStarted; i++)
+   {
+      histogram.merge(threads[i]->getHistogram() );
+      result.numErrors += threads[i]->getNumErrors();
+   }
+
+   result.latency = histogram.getStats();
+   result.opsPerSec = elapsedMS ? (result.latency.numOps * 1000 / elapsedMS) :
+      result.latency.numOps * 1000;
+
+   if (result.numErrors)
+      LogContext(logContext).log(Log_WARNING, "Phase " + StringTk::intToStr(op) + " had " +
+         StringTk::uint64ToStr(result.numErrors) + " failed operations.");
+
+   const std::lock_guard<Mutex> lock(resultsMutex);
+   this->results.push_back(result);
+}
+
+/*
+ * creates and references the scratch directories of the run
+ *
+ * @param outDirs referenced directories, must be released by the caller also on error
+ * @return false on error
+ */
+bool MetaBench::createScratchDirs(std::vector<DirInode*>* outDirs)
+{
+   const char* logContext = "Meta Benchmark (mkdir)";
+
+   App* app = Program::getApp();
+   MetaStore* metaStore = app->getMetaStore();
+
+   const unsigned numDirs = sharedDir ? 1 : numThreads;
+
+   // no stripe targets, so that files can be created without asking the target chooser
+   UInt16Vector stripeTargets;
+   Raid0Pattern stripePattern(app->getConfig()->getTuneDefaultChunkSize(), stripeTargets, 1);
+
+   for (unsigned i = 0; i < numDirs; i++)
+   {
+      const std::string dirID = METABENCH_DIR_ID_PREFIX + StringTk::uintToStr(i);
+
+      DirInode newDir(dirID, S_IFDIR | S_IRWXU, 0, 0, app->getLocalNode().getNumID(),
+         stripePattern, false);
+
+      FhgfsOpsErr mkRes = metaStore->makeDirInode(newDir);
+      if (mkRes != FhgfsOpsErr_SUCCESS)
+      {
+         LogContext(logContext).logErr("Unable to create scratch directory: " + dirID + "; "
+            "Error: " + boost::lexical_cast<std::string>(mkRes) );
+         return false;
+      }
+
+      DirInode* dir = metaStore->referenceDir(dirID, false, true);
+      if (!dir)
+      {
+         LogContext(logContext).logErr("Unable to reference scratch directory: " + dirID);
+         return false;
+      }
+
+      outDirs->push_back(dir);
+   }
+
+   return true;
+}
+
+void MetaBench::releaseScratchDirs(std::vector<DirInode*>& dirs)
+{
+   MetaStore* metaStore = Program::getApp()->getMetaStore();
+
+   for (auto iter = dirs.begin(); iter != dirs.end(); iter++)
+      metaStore->releaseDir( (*iter)->getID() );
+
+   dirs.clear();
+}
+
+/*
+ * removes all scratch directories including the files in them
+ *
+ * @return false if a directory could not be removed
+ */
+bool MetaBench::removeScratchDirs()
+{
+   // scratch dirs are always numbered without gaps, starting at 0
+   for (unsigned i = 0; i < METABENCH_MAX_THREADS; i++)
+   {
+      const std::string dirID = METABENCH_DIR_ID_PREFIX + StringTk::uintToStr(i);
+
+      DirInode* dir = Program::getApp()->getMetaStore()->referenceDir(dirID, false, true);
+      if (!dir)
+         break;
+
+      Program::getApp()->getMetaStore()->releaseDir(dirID);
+
+      if (!removeScratchDir(dirID) )
+         return false;
+   }
+
+   return true;
+}
+
+bool MetaBench::removeScratchDir(const std::string& dirID)
+{
+   const char* logContext = "Meta Benchmark (cleanup)";
+
+   MetaStore* metaStore = Program::getApp()->getMetaStore();
+
+   DirInode* dir = metaStore->referenceDir(dirID, false, true);
+   if (!dir)
+      return true;
+
+   StringList names;
+   int64_t serverOffset = 0;
+   bool listOK = true;
+
+   // get all names first, the list offsets would not be stable while we unlink
+   while (true)
+   {
+      StringList batch;
+      int64_t newServerOffset;
+
+      FhgfsOpsErr listRes = dir->listIncremental(serverOffset, METABENCH_LIST_BATCH_SIZE, &batch,
+         &newServerOffset);
+      if (listRes != FhgfsOpsErr_SUCCESS)
+      {
+         LogContext(logContext).logErr("Unable to list scratch directory: " + dirID);
+         listOK = false;
+         break;
+      }
+
+      const bool isLastBatch = batch.size() != METABENCH_LIST_BATCH_SIZE;
+
+      names.splice(names.end(), batch);
+      serverOffset = newServerOffset;
+
+      if (isLastBatch)
+         break;
+   }
+
+   for (auto iter = names.begin(); listOK && iter != names.end(); iter++)
+   {
+      EntryInfo unlinkedInfo;
+      std::unique_ptr<FileInode> unlinkedInode;
+      unsigned numHardlinks;
+
+      FhgfsOpsErr unlinkRes = metaStore->unlinkFile(*dir, *iter, &unlinkedInfo, &unlinkedInode,
+         numHardlinks);
+      if ( (unlinkRes != FhgfsOpsErr_SUCCESS) && (unlinkRes != FhgfsOpsErr_PATHNOTEXISTS) )
+      {
+         LogContext(logContext).logErr("Unable to unlink file in scratch directory: " + dirID +
+            "/" + *iter + "; Error: " + boost::lexical_cast<std::string>(unlinkRes) );
+         listOK = false;
+      }
+   }
+
+   metaStore->releaseDir(dirID);
+
+   if (!listOK)
+      return false;
+
+   FhgfsOpsErr rmRes = metaStore->removeDirInode(dirID, false);
+   if (rmRes != FhgfsOpsErr_SUCCESS)
+   {
+      LogContext(logContext).logErr("Unable to remove scratch directory: " + dirID + "; "
+         "Error: " + boost::lexical_cast<std::string>(rmRes) );
+      return false;
+   }
+
+   return true;
+}
+
+/*
+ * returns the results of all finished phases and the status of the benchmark
+ */
+StorageBenchStatus MetaBench::getStatusWithResults(MetaBenchResultVec* outResults)
+{
+   {
+      const std::lock_guard<Mutex> lock(resultsMutex);
+      *outResults = this->results;
+   }
+
+   return getStatus();
+}
+
+/*
+ * stop the benchmark
+ *
+ * @return the error code, 0 if the benchmark will stop (STORAGEBENCH_ERROR..)
+ */
+int MetaBench::stopBenchmark()
+{
+   const std::lock_guard<Mutex> lock(statusMutex);
+
+   if (this->status == StorageBenchStatus_RUNNING)
+   {
+      this->stopRequested = true;
+      this->status = StorageBenchStatus_STOPPING;
+   }
+
+   return STORAGEBENCH_ERROR_NO_ERROR;
+}
+
+/*
+ * removes the scratch directories of an interrupted run
+ *
+ * @return the error code, 0 if the cleanup was successful (STORAGEBENCH_ERROR..)
+ */
+int MetaBench::cleanup()
+{
+   const std::lock_guard<Mutex> lock(statusMutex);
+
+   if (STORAGEBENCHSTATUS_IS_ACTIVE(this->status) )
+   {
+      LogContext("Meta Benchmark (cleanup)").logErr("Cleanup not possible benchmark is running");
+      return STORAGEBENCH_ERROR_RUNTIME_CLEANUP_JOB_ACTIVE;
+   }
+
+   if (!removeScratchDirs() )
+      return STORAGEBENCH_ERROR_RUNTIME_DELETE_FOLDER;
+
+   return STORAGEBENCH_ERROR_NO_ERROR;
+}
+
+/*
+ * aborts the benchmark, will be used if SIGINT received
+ */
+void MetaBench::shutdownBenchmark()
+{
+   this->stopRequested = true;
+   this->selfTerminate();
+}
+
+void MetaBench::waitForShutdownBenchmark()
+{
+   const std::lock_guard<Mutex> lock(statusMutex);
+
+   while (STORAGEBENCHSTATUS_IS_ACTIVE(this->status) )
+      this->statusChangeCond.wait(&this->statusMutex);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <common/benchmark/MetaBench.h>
+#include <common/threading/Condition.h>
+#include <common/threading/PThread.h>
+#include <common/Common.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+class DirInode;
+
+
+/**
+ * Server-side metadata benchmark. Drives the MetaStore directly, without network, sessions and
+ * client effects, to measure the metadata backend (dentry and inode file I/O, MetaStore locking).
+ *
+ * A run consists of the phases create, stat, open/close, rename and unlink (see MetaBenchOp). Like
+ * in mdtest, every phase runs in all threads over all files of the thread before the next phase
+ * starts. Per phase, throughput and latency percentiles over all threads are reported.
+ *
+ * Files are created in non-mirrored scratch directories (METABENCH_DIR_ID_PREFIX + index) which
+ * are not linked into the namespace and have an empty stripe pattern, so no storage server is
+ * involved. The scratch directories are removed at the end of a run. Leftovers of a run that was
+ * interrupted by a crash are removed by cleanup() or by the next run.
+ */
+class MetaBench : public PThread
+{
+   public:
+      MetaBench();
+      ~MetaBench();
+
+      int initAndStartMetaBench(unsigned numThreads, unsigned numFiles, bool sharedDir);
+      int stopBenchmark();
+      int cleanup();
+      StorageBenchStatus getStatusWithResults(MetaBenchResultVec* outResults);
+      void shutdownBenchmark();
+      void waitForShutdownBenchmark();
+
+   private:
+      class BenchThread;
+
+      Mutex statusMutex;
+      Condition statusChangeCond;
+      StorageBenchStatus status;
+      int lastRunErrorCode; // STORAGEBENCH_ERROR_...
+
+      unsigned numThreads;
+      unsigned numFiles; // per thread
+      bool sharedDir;
+
+      std::atomic<bool> stopRequested; // checked by the bench threads after each operation
+
+      Mutex resultsMutex;
+      MetaBenchResultVec results; // one element per finished phase
+
+      virtual void run();
+
+      void runPhase(MetaBenchOp op, std::vector<std::unique_ptr<BenchThread>>& threads);
+
+      bool createScratchDirs(std::vector<DirInode*>* outDirs);
+      void releaseScratchDirs(std::vector<DirInode*>& dirs);
+      bool removeScratchDirs();
+      static bool removeScratchDir(const std::string& dirID);
+
+      void setStatus(StorageBenchStatus newStatus)
+      {
+         const std::lock_guard<Mutex> lock(statusMutex);
+
+         this->status = newStatus;
+         this->statusChangeCond.broadcast();
+      }
+
+   public:
+      //public inliners
+      int getLastRunErrorCode()
+      {
+         return this->lastRunErrorCode;
+      }
+
+      StorageBenchStatus getStatus()
+      {
+         const std::lock_guard<Mutex> lock(statusMutex);
+
+         return this->status;
+      }
+};
+
@@ -17,6 +17,8 @@
 
 #include "BuddyResyncJob.h"
 
+#include <algorithm>
+
 BuddyResyncJob::BuddyResyncJob() :
    PThread("BuddyResyncJob"),
    state(BuddyResyncJobState_NOTSTARTED),
@@ -52,6 +54,9 @@ void BuddyResyncJob::run()
    const std::string metaBuddyMirPath = app->getMetaPath() + "/" + CONFIG_BUDDYMIRROR_SUBDIR_NAME;
    Barrier workerBarrier(workers->size() + 1);
    bool workersStopped = false;
+   ResyncJournal* journal = app->getBuddyResyncer()->getJournal();
+   std::vector<MetaSyncCandidateFile::Element> journalEntries;
+   bool useJournal = false;
 
    startTime = time(NULL);
 
@@ -108,12 +113,23 @@ void BuddyResyncJob::run()
       }
       internodeSyncer->setResyncInProgress(true);
 
-      const bool startGatherSlaveRes = startGatherSlaves();
-      if (!startGatherSlaveRes)
+      // the journal only knows what the buddy missed if we were the ones who set it to
+      // needs-resync. if it was set by someone else, e.g. because the buddy crashed, it may have
+      // lost more than that.
+      // workers are stopped, so nothing can be recorded between reading the journal and passing
+      // all further changes to the mod sync slave.
+      if (journal && BuddyCommTk::getBuddyNeedsResync())
+         useJournal = journal->getEntries(journalEntries);
+
+      if (!useJournal)
       {
-         setState(BuddyResyncJobState_FAILURE);
-         workerBarrier.wait();
-         goto cleanup;
+         const bool startGatherSlaveRes = startGatherSlaves();
+         if (!startGatherSlaveRes)
+         {
+            setState(BuddyResyncJobState_FAILURE);
+            workerBarrier.wait();
+            goto cleanup;
+         }
       }
 
       const bool startResyncSlaveRes = startSyncSlaves();
@@ -126,9 +142,16 @@ void BuddyResyncJob::run()
    }
    workerBarrier.wait();
 
-   LOG_DEBUG(__func__, Log_DEBUG, "Going to join gather slaves.");
-   joinGatherSlaves();
-   LOG_DEBUG(__func__, Log_DEBUG, "Joined gather slaves.");
+   if (useJournal)
+   {
+      enqueueJournalEntries(journalEntries);
+   }
+   else
+   {
+      LOG_DEBUG(__func__, Log_DEBUG, "Going to join gather slaves.");
+      joinGatherSlaves();
+      LOG_DEBUG(__func__, Log_DEBUG, "Joined gather slaves.");
+   }
 
    LOG_DEBUG(__func__, Log_DEBUG, "Going to join sync slaves.");
 
@@ -217,6 +240,12 @@ cleanup:
       // delete timestamp override file if it exists.
       BuddyCommTk::setBuddyNeedsResync(metaPath, false);
 
+      // changes made during a failed resync were neither recorded nor (reliably) synced
+      if (journal && getState() == BuddyResyncJobState_SUCCESS)
+         journal->reset();
+      else if (journal)
+         journal->invalidate("resync failed");
+
       const TargetConsistencyState buddyState = newBuddyState();
       informBuddy(buddyState);
       informMgmtd(buddyState);
@@ -388,6 +417,36 @@ void BuddyResyncJob::joinGatherSlaves()
    gatherSlave->join();
 }
 
+/**
+ * Pass the entries of the resync journal to the mod sync slave instead of crawling all mirrored
+ * metadata. Inodes are synced before dentries, so that dentries never link to inodes that the
+ * secondary does not have yet.
+ */
+void BuddyResyncJob::enqueueJournalEntries(std::vector<MetaSyncCandidateFile::Element>& entries)
+{
+   const size_t elementsPerCandidate = 1000;
+
+   LOG(MIRRORING, NOTICE, "Resyncing entries recorded in the resync journal.",
+         ("numEntries", entries.size()));
+
+   std::stable_partition(entries.begin(), entries.end(),
+         [] (const MetaSyncCandidateFile::Element& element) {
+            return element.type != MetaSyncFileType::Dentry;
+         });
+
+   for (size_t i = 0; i < entries.size() && isRunning(); i += elementsPerCandidate)
+   {
+      MetaSyncCandidateFile candidate;
+
+      candidate.setFromJournal();
+
+      for (size_t j = i; j < std::min(i + elementsPerCandidate, entries.size()); j++)
+         candidate.addModification(std::move(entries[j].path), entries[j].type);
+
+      syncCandidates.add(std::move(candidate), this);
+   }
+}
+
 MetaBuddyResyncJobStatistics BuddyResyncJob::getJobStats()
 {
    std::lock_guard<Mutex> lock(stateMutex);
@@ -45,6 +45,7 @@ class BuddyResyncJob : public PThread
       bool startGatherSlaves();
       bool startSyncSlaves();
       void joinGatherSlaves();
+      void enqueueJournalEntries(std::vector<MetaSyncCandidateFile::Element>& entries);
 
    public:
       BuddyResyncJobState getState()
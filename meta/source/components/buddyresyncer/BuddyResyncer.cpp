@@ -4,6 +4,16 @@
 
 __thread MetaSyncCandidateFile* BuddyResyncer::currentThreadChangeSet = 0;
 
+BuddyResyncer::BuddyResyncer()
+   : job(NULL), noNewResyncs(false)
+{
+   App* app = Program::getApp();
+   const unsigned journalMaxEntries = app->getConfig()->getTuneResyncJournalMaxEntries();
+
+   if (journalMaxEntries)
+      journal = boost::make_unique<ResyncJournal>(app->getMetaPath(), journalMaxEntries);
+}
+
 BuddyResyncer::~BuddyResyncer()
 {
    if (job)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <components/buddyresyncer/BuddyResyncJob.h>
+#include <components/buddyresyncer/ResyncJournal.h>
 #include <common/storage/StorageErrors.h>
 #include <common/Common.h>
 
@@ -16,10 +17,7 @@
 class BuddyResyncer
 {
    public:
-      BuddyResyncer()
-         : job(NULL), noNewResyncs(false)
-      { }
-
+      BuddyResyncer();
       ~BuddyResyncer();
 
       FhgfsOpsErr startResync();
@@ -32,6 +30,8 @@ class BuddyResyncer
                            // that's set to NULL when no job is present.
       Mutex jobMutex;
 
+      std::unique_ptr<ResyncJournal> journal; // nullptr if disabled
+
    public:
       BuddyResyncJob* getResyncJob()
       {
@@ -39,6 +39,11 @@ class BuddyResyncer
          return job;
       }
 
+      ResyncJournal* getJournal()
+      {
+         return journal.get();
+      }
+
       static void registerSyncChangeset()
       {
          BEEGFS_BUG_ON(currentThreadChangeSet, "current changeset not nullptr");
@@ -1,5 +1,6 @@
 #include <common/storage/Metadata.h>
 #include <common/app/log/LogContext.h>
+#include <common/toolkit/DirTreeWalker.h>
 #include <common/toolkit/StringTk.h>
 #include <toolkit/BuddyCommTk.h>
 #include <program/Program.h>
@@ -39,96 +40,66 @@ void BuddyResyncerGatherSlave::workLoop()
    crawlDir(metaBuddyPath + "/" META_DENTRIES_SUBDIR_NAME, MetaSyncDirType::DentriesHashDir);
 }
 
-void BuddyResyncerGatherSlave::crawlDir(const std::string& path, const MetaSyncDirType type,
-   const unsigned level)
+void BuddyResyncerGatherSlave::crawlDir(const std::string& path, const MetaSyncDirType type)
 {
-   LOG_DBG(MIRRORING, DEBUG, "Entering hash dir.", level, path);
+   LOG_DBG(MIRRORING, DEBUG, "Entering hash dir.", path);
 
-   std::unique_ptr<DIR, StorageTk::CloseDirDeleter> dirHandle(::opendir(path.c_str()));
+   // layout is: (dentries|inodes)/l1/l2/...
+   //  -> depth 0 correlates with type
+   //  -> depth 1 is not very interesting, except for reporting
+   //  -> depth 2 must be synced. if it is a dentry hashdir, its contents must also be crawled.
+   auto handleEntry = [&] (const DirTreeWalker::Entry& entry) {
+      if (getSelfTerminate() )
+         return DirTreeWalker::Action_ABORT;
 
-   if (!dirHandle)
-   {
-      LOG(MIRRORING, ERR, "Unable to open path", path, sysErr);
-      numErrors.increase();
-      return;
-   }
-
-   while (!getSelfTerminate())
-   {
-      struct dirent* entry;
-
-#if USE_READDIR_R
-      struct dirent buffer;
-      const int readRes = ::readdir_r(dirHandle.get(), &buffer, &entry);
-#else
-      errno = 0;
-      entry = ::readdir(dirHandle.get());
-      const int readRes = entry ? 0 : errno;
-#endif
-      if (readRes != 0)
-      {
-         LOG(MIRRORING, ERR, "Could not read dir entry.", path, sysErr(readRes));
-         numErrors.increase();
-         return;
-      }
-
-      if (!entry)
-         break;
-
-      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
-         continue;
-
-      const std::string& candidatePath = path + "/" + entry->d_name;
-
-      struct stat statBuf;
-      const int statRes = ::stat(candidatePath.c_str(), &statBuf);
-      if (statRes)
-      {
-         // in a 2nd level dentry hashdir, content directories may disappear - this is not an error,
-         // it was most likely caused by an rmdir issued by a user.
-         if (!(errno == ENOENT && type == MetaSyncDirType::DentriesHashDir && level == 2))
-         {
-            LOG(MIRRORING, ERR, "Could not stat dir entry.", candidatePath, sysErr);
-            numErrors.increase();
-         }
-
-         continue;
-      }
+      const std::string& candidatePath = path + "/" + entry.getPath();
 
-      if (!S_ISDIR(statBuf.st_mode))
+      if (!entry.isDir)
       {
-         LOG(MIRRORING, ERR, "Found a non-dir where only directories are expected.", candidatePath,
-               oct(statBuf.st_mode));
+         LOG(MIRRORING, ERR, "Found a non-dir where only directories are expected.",
+               candidatePath);
          numErrors.increase();
-         continue;
+         return DirTreeWalker::Action_SKIP;
       }
 
-      // layout is: (dentries|inodes)/l1/l2/...
-      //  -> level 0 correlates with type
-      //  -> level 1 is not very interesting, except for reporting
-      //  -> level 2 must be synced. if it is a dentry hashdir, its contents must also be crawled.
-      if (level == 0)
-      {
-         crawlDir(candidatePath, type, level + 1);
-         continue;
-      }
+      if (entry.depth == 0)
+         return DirTreeWalker::Action_CONTINUE;
 
-      if (level == 1)
+      if (entry.depth == 1)
       {
          LOG_DBG(MIRRORING, DEBUG, "Adding hashdir sync candidate.", candidatePath);
          addCandidate(candidatePath, type);
 
-         if (type == MetaSyncDirType::DentriesHashDir)
-            crawlDir(candidatePath, type, level + 1);
-
-         continue;
+         return type == MetaSyncDirType::DentriesHashDir
+            ? DirTreeWalker::Action_CONTINUE
+            : DirTreeWalker::Action_SKIP;
       }
 
-      // so here we read a 2nd level dentry hashdir. crawl that too, add sync candidates for each
-      // entry we find - non-directories have already been reported, and the bulk resyncer will
-      // take care of the fsids directories.
+      // so here we read a 2nd level dentry hashdir. add sync candidates for each entry we find -
+      // non-directories have already been reported, and the bulk resyncer will take care of the
+      // fsids directories.
       numDirsDiscovered.increase();
       LOG_DBG(MIRRORING, DEBUG, "Adding contdir sync candidate.", candidatePath);
       addCandidate(candidatePath, MetaSyncDirType::ContentDir);
-   }
+
+      return DirTreeWalker::Action_SKIP;
+   };
+
+   auto handleError = [&] (const std::string& relPath, int errCode) {
+      // in a 2nd level dentry hashdir, content directories may disappear - this is not an error,
+      // it was most likely caused by an rmdir issued by a user.
+      const bool isContentDir = std::count(relPath.begin(), relPath.end(), '/') == 2;
+
+      if (!(errCode == ENOENT && type == MetaSyncDirType::DentriesHashDir && isContentDir) )
+      {
+         LOG(MIRRORING, ERR, "Could not read dir entry.", path, relPath, sysErr(errCode));
+         numErrors.increase();
+      }
+
+      return true;
+   };
+
+   DirTreeWalker walker(Program::getApp()->getConfig()->getTuneNumResyncGatherSlaves(), false);
+
+   walker.walk(path, handleEntry, handleError);
 }
@@ -32,7 +32,7 @@ class BuddyResyncerGatherSlave : public PThread
 
       virtual void run();
 
-      void crawlDir(const std::string& path, const MetaSyncDirType type, const unsigned level = 0);
+      void crawlDir(const std::string& path, const MetaSyncDirType type);
 
    public:
       bool getIsRunning()
@@ -11,6 +11,8 @@
 #include <program/Program.h>
 #include <toolkit/XAttrTk.h>
 
+#include <sys/stat.h>
+
 BuddyResyncerModSyncSlave::BuddyResyncerModSyncSlave(BuddyResyncJob& BuddyResyncParentJob,
       MetaSyncCandidateStore* syncCandidates, uint8_t slaveID, const NumNodeID& buddyNodeID) :
    SyncSlaveBase("BuddyResyncerModSyncSlave_" + StringTk::uintToStr(slaveID), BuddyResyncParentJob,
@@ -39,6 +41,16 @@ struct CandidateSignaler
    }
 };
 
+/**
+ * @param path relative to the meta root (which is our working directory)
+ */
+bool existsLocally(const std::string& path)
+{
+   struct stat statBuf;
+
+   return ::lstat(path.c_str(), &statBuf) == 0 || errno != ENOENT;
+}
+
 bool resyncElemCmp(const MetaSyncCandidateFile::Element& a, const MetaSyncCandidateFile::Element& b)
 {
    // we must sync deletions before updates and inodes before everything else:
@@ -79,6 +91,14 @@ FhgfsOpsErr BuddyResyncerModSyncSlave::streamCandidates(Socket& socket)
 
       auto resyncElems = candidate.releaseElements();
 
+      // journal entries are synced in their current state, which may differ from the state they
+      // had when they were recorded.
+      if (candidate.isFromJournal())
+      {
+         for (auto it = resyncElems.begin(); it != resyncElems.end(); ++it)
+            it->isDeletion = !existsLocally(it->path);
+      }
+
       std::sort(resyncElems.begin(), resyncElems.end(), resyncElemCmp);
 
       for (auto it = resyncElems.begin(); it != resyncElems.end(); ++it)
@@ -88,30 +108,17 @@ FhgfsOpsErr BuddyResyncerModSyncSlave::streamCandidates(Socket& socket)
          // element.path is relative to the meta root, so we have to chop off the buddymir/ prefix
          const Path itemPath(element.path.substr(strlen(META_BUDDYMIRROR_SUBDIR_NAME) + 1));
 
-         FhgfsOpsErr resyncRes;
-
          LOG_DBG(MIRRORING, DEBUG, "Syncing one modification.", element.path, element.isDeletion,
                int(element.type));
 
-         switch (element.type)
-         {
-            case MetaSyncFileType::Dentry:
-               resyncRes = element.isDeletion
-                  ? deleteDentry(socket, itemPath.dirname(), itemPath.back())
-                  : streamDentry(socket, itemPath.dirname(), itemPath.back());
-               break;
-
-            case MetaSyncFileType::Directory:
-            case MetaSyncFileType::Inode:
-               resyncRes = element.isDeletion
-                  ? deleteInode(socket, itemPath, element.type == MetaSyncFileType::Directory)
-                  : streamInode(socket, itemPath, element.type == MetaSyncFileType::Directory);
-               break;
-
-            default:
-               LOG(MIRRORING, ERR, "this should never happen");
-               return FhgfsOpsErr_INTERNAL;
-         }
+         FhgfsOpsErr resyncRes = syncElement(socket, itemPath, element.type, element.isDeletion);
+
+         // journal entries are not locked while they are synced, so they may have been deleted
+         // since we looked at them. if they are recreated later, the operation that recreates them
+         // syncs them again.
+         if (resyncRes != FhgfsOpsErr_SUCCESS && candidate.isFromJournal() &&
+               !element.isDeletion && !existsLocally(element.path))
+            resyncRes = syncElement(socket, itemPath, element.type, true);
 
          if (resyncRes != FhgfsOpsErr_SUCCESS || DEBUG_FAIL_MODSYNC)
          {
@@ -140,3 +147,25 @@ FhgfsOpsErr BuddyResyncerModSyncSlave::streamCandidates(Socket& socket)
    sendResyncPacket(socket, std::tuple<>());
    return FhgfsOpsErr_SUCCESS;
 }
+
+FhgfsOpsErr BuddyResyncerModSyncSlave::syncElement(Socket& socket, const Path& itemPath,
+   MetaSyncFileType type, bool isDeletion)
+{
+   switch (type)
+   {
+      case MetaSyncFileType::Dentry:
+         return isDeletion
+            ? deleteDentry(socket, itemPath.dirname(), itemPath.back())
+            : streamDentry(socket, itemPath.dirname(), itemPath.back());
+
+      case MetaSyncFileType::Directory:
+      case MetaSyncFileType::Inode:
+         return isDeletion
+            ? deleteInode(socket, itemPath, type == MetaSyncFileType::Directory)
+            : streamInode(socket, itemPath, type == MetaSyncFileType::Directory);
+
+      default:
+         LOG(MIRRORING, ERR, "this should never happen");
+         return FhgfsOpsErr_INTERNAL;
+   }
+}
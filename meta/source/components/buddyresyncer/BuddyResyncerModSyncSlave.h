@@ -40,6 +40,8 @@ class BuddyResyncerModSyncSlave : public SyncSlaveBase
       void syncLoop();
 
       FhgfsOpsErr streamCandidates(Socket& socket);
+      FhgfsOpsErr syncElement(Socket& socket, const Path& itemPath, MetaSyncFileType type,
+            bool isDeletion);
 
    private:
       static FhgfsOpsErr streamCandidates(Socket* socket, void* context)
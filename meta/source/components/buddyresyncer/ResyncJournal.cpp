@@ -0,0 +1,268 @@
+#include <common/app/log/Logger.h>
+#include "ResyncJournal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RESYNCJOURNAL_FILENAME      ".buddyresyncjournal"
+#define RESYNCJOURNAL_MAGIC         "BGFSRSJ1"
+#define RESYNCJOURNAL_MAGIC_LEN     8
+#define RESYNCJOURNAL_HEADER_LEN    (RESYNCJOURNAL_MAGIC_LEN + 1) // magic, state
+#define RESYNCJOURNAL_RECORD_LEN    4 // type, isDeletion, path length (without path)
+
+
+/**
+ * Opens the journal file in the meta directory, or creates it if it does not exist. An existing
+ * journal is only taken over if it was closed cleanly.
+ *
+ * @param maxEntries the journal is invalidated when it would hold more entries than this
+ */
+ResyncJournal::ResyncJournal(const std::string& metaPath, size_t maxEntries) :
+   filePath(metaPath + "/" RESYNCJOURNAL_FILENAME), maxEntries(maxEntries), isValid(false),
+   fd(-1), fileSize(0)
+{
+   fd = open(filePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+   if (fd == -1)
+   {
+      LOG(MIRRORING, ERR, "Unable to open resync journal. Resyncs will be complete.", filePath,
+            sysErr);
+      return;
+   }
+
+   if (load() && writeState(State_OPEN) )
+   {
+      isValid = true;
+
+      LOG(MIRRORING, NOTICE, "Resync journal loaded.", ("numEntries", entries.size()));
+      return;
+   }
+
+   entries.clear();
+   fileSize = 0;
+
+   if (ftruncate(fd, 0) || !writeState(State_INVALID) )
+      LOG(MIRRORING, ERR, "Unable to reset resync journal.", filePath, sysErr);
+}
+
+/**
+ * Marks the journal as clean, so that it is taken over by the next start. Must only be called
+ * when no more operations are processed.
+ */
+ResyncJournal::~ResyncJournal()
+{
+   if (fd == -1)
+      return;
+
+   if (isValid && (fdatasync(fd) || !writeState(State_CLEAN) ) )
+      LOG(MIRRORING, ERR, "Unable to close resync journal cleanly.", filePath, sysErr);
+
+   close(fd);
+}
+
+/**
+ * Record the elements of a changeset that the secondary has missed.
+ */
+void ResyncJournal::record(const std::vector<MetaSyncCandidateFile::Element>& elements)
+{
+   if (!getIsValid() )
+      return;
+
+   std::string buf;
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   if (!isValid)
+      return;
+
+   for (auto it = elements.begin(); it != elements.end(); ++it)
+   {
+      auto insertRes = entries.insert({EntryKey(it->type, it->path), it->isDeletion});
+      if (!insertRes.second)
+      {
+         if (insertRes.first->second == it->isDeletion)
+            continue;
+
+         insertRes.first->second = it->isDeletion;
+      }
+
+      const uint16_t pathLen = it->path.size();
+
+      buf += char(it->type);
+      buf += char(it->isDeletion);
+      buf.append(reinterpret_cast<const char*>(&pathLen), sizeof(pathLen) );
+      buf.append(it->path, 0, pathLen);
+   }
+
+   if (entries.size() > maxEntries)
+   {
+      invalidateUnlocked("journal full");
+      return;
+   }
+
+   if (buf.empty() )
+      return;
+
+   const ssize_t writeRes = pwrite(fd, buf.data(), buf.size(), fileSize);
+   if (writeRes != ssize_t(buf.size() ) )
+   {
+      LOG(MIRRORING, ERR, "Unable to write resync journal.", filePath, sysErr);
+      invalidateUnlocked("write error");
+      return;
+   }
+
+   fileSize += writeRes;
+}
+
+/**
+ * Drop all entries and make sure that the next resync will be complete.
+ */
+void ResyncJournal::invalidate(const char* reason)
+{
+   if (!getIsValid() )
+      return;
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   invalidateUnlocked(reason);
+}
+
+/**
+ * Start over with an empty, valid journal. Must only be called when the secondary is known to be
+ * in sync, i.e. after a successful resync.
+ */
+void ResyncJournal::reset()
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   if (fd == -1)
+      return;
+
+   entries.clear();
+   fileSize = 0;
+
+   if (ftruncate(fd, 0) || !writeState(State_OPEN) )
+   {
+      LOG(MIRRORING, ERR, "Unable to reset resync journal.", filePath, sysErr);
+      isValid = false;
+      return;
+   }
+
+   isValid = true;
+}
+
+/**
+ * @param outEntries the deduplicated entries; deletions and modifications as they were recorded
+ * last for each path.
+ * @return false if the journal is invalid and a complete resync is required
+ */
+bool ResyncJournal::getEntries(std::vector<MetaSyncCandidateFile::Element>& outEntries)
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   if (!isValid)
+      return false;
+
+   outEntries.reserve(outEntries.size() + entries.size() );
+
+   for (auto it = entries.begin(); it != entries.end(); ++it)
+      outEntries.push_back({it->first.second, it->first.first, it->second});
+
+   return true;
+}
+
+size_t ResyncJournal::getNumEntries()
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   return entries.size();
+}
+
+/**
+ * Read the journal file into entries.
+ *
+ * @return true if the file was closed cleanly and could be read completely
+ */
+bool ResyncJournal::load()
+{
+   struct stat statBuf;
+
+   if (fstat(fd, &statBuf) )
+      return false;
+
+   std::string content(statBuf.st_size, '\0');
+
+   if (pread(fd, &content[0], content.size(), 0) != ssize_t(content.size() ) )
+      return false;
+
+   if (content.size() < RESYNCJOURNAL_HEADER_LEN
+         || content.compare(0, RESYNCJOURNAL_MAGIC_LEN, RESYNCJOURNAL_MAGIC) != 0)
+      return false; // new journal or unknown format
+
+   if (uint8_t(content[RESYNCJOURNAL_MAGIC_LEN]) != State_CLEAN)
+   {
+      LOG(MIRRORING, WARNING,
+            "Resync journal was not closed cleanly, next resync will be complete.");
+      return false;
+   }
+
+   size_t pos = RESYNCJOURNAL_HEADER_LEN;
+
+   while (pos < content.size() )
+   {
+      if (content.size() - pos < RESYNCJOURNAL_RECORD_LEN)
+         return false;
+
+      const uint8_t type = content[pos];
+      const bool isDeletion = content[pos + 1];
+      uint16_t pathLen;
+
+      memcpy(&pathLen, &content[pos + 2], sizeof(pathLen) );
+      pos += RESYNCJOURNAL_RECORD_LEN;
+
+      if (content.size() - pos < pathLen || type > uint8_t(MetaSyncFileType::Directory) )
+         return false;
+
+      entries[EntryKey(MetaSyncFileType(type), content.substr(pos, pathLen) )] = isDeletion;
+      pos += pathLen;
+   }
+
+   fileSize = content.size();
+
+   return entries.size() <= maxEntries;
+}
+
+/**
+ * Write the header with the given state and sync it to disk.
+ */
+bool ResyncJournal::writeState(State state)
+{
+   char header[RESYNCJOURNAL_HEADER_LEN];
+
+   memcpy(header, RESYNCJOURNAL_MAGIC, RESYNCJOURNAL_MAGIC_LEN);
+   header[RESYNCJOURNAL_MAGIC_LEN] = state;
+
+   if (pwrite(fd, header, sizeof(header), 0) != sizeof(header) || fdatasync(fd) )
+      return false;
+
+   fileSize = std::max<off_t>(fileSize, sizeof(header) );
+   return true;
+}
+
+void ResyncJournal::invalidateUnlocked(const char* reason)
+{
+   if (!isValid)
+      return;
+
+   isValid = false;
+   entries.clear();
+
+   LOG(MIRRORING, WARNING, "Resync journal invalidated, next resync will be complete.", reason);
+
+   if (!writeState(State_INVALID) || ftruncate(fd, RESYNCJOURNAL_HEADER_LEN) )
+      LOG(MIRRORING, ERR, "Unable to invalidate resync journal.", filePath, sysErr);
+
+   fileSize = RESYNCJOURNAL_HEADER_LEN;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <common/threading/Mutex.h>
+#include <components/buddyresyncer/SyncCandidate.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Records the inodes and dentries that the secondary of our buddy group has missed, so that a
+ * resync only has to transfer these instead of crawling all mirrored metadata.
+ *
+ * An operation is recorded when the primary did not (successfully) forward it to the secondary.
+ * Only the paths are recorded; a resync syncs the current state of each path from the primary,
+ * or deletes it on the secondary if it does not exist any more.
+ *
+ * The journal is only usable if it covers everything the secondary has missed. It is invalidated
+ * (and a full resync is done) if
+ *   - it overflows,
+ *   - the primary was not shut down cleanly, because records are not synced to disk one by one,
+ *   - this node has acted as secondary, because the former primary may have executed operations
+ *     that never reached us,
+ *   - a resync that has reached the secondary failed, because the operations that were passed to
+ *     the resync instead of being recorded may not have been applied.
+ * A new, empty journal becomes valid after a complete resync, not at startup, because we cannot
+ * know what the secondary missed before.
+ *
+ * On-disk format: header (magic, state), followed by records of type, deletion flag, path length
+ * and path. Records are deduplicated in memory; a later record of the same path replaces an
+ * earlier one when the file is loaded.
+ */
+class ResyncJournal
+{
+   public:
+      ResyncJournal(const std::string& metaPath, size_t maxEntries);
+      ~ResyncJournal();
+
+      ResyncJournal(const ResyncJournal&) = delete;
+      ResyncJournal& operator=(const ResyncJournal&) = delete;
+
+      void record(const std::vector<MetaSyncCandidateFile::Element>& elements);
+      void invalidate(const char* reason);
+      void reset();
+
+      bool getEntries(std::vector<MetaSyncCandidateFile::Element>& outEntries);
+      size_t getNumEntries();
+
+   private:
+      enum State : uint8_t
+      {
+         State_CLEAN = 1, // closed cleanly, entries are complete
+         State_OPEN = 2, // in use, a crash may have lost records
+         State_INVALID = 3,
+      };
+
+      typedef std::pair<MetaSyncFileType, std::string> EntryKey;
+      typedef std::map<EntryKey, bool> EntryMap; // value: isDeletion
+
+      const std::string filePath;
+      const size_t maxEntries;
+
+      Mutex mutex;
+      std::atomic<bool> isValid;
+      int fd;
+      off_t fileSize;
+      EntryMap entries;
+
+      bool load();
+      bool writeState(State state);
+      void invalidateUnlocked(const char* reason);
+
+   public:
+      bool getIsValid() const
+      {
+         return isValid.load(std::memory_order_relaxed);
+      }
+};
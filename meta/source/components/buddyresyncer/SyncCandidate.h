@@ -55,10 +55,10 @@ class MetaSyncCandidateFile
          bool isDeletion;
       };
 
-      MetaSyncCandidateFile(): barrier(nullptr) {}
+      MetaSyncCandidateFile(): barrier(nullptr), fromJournal(false) {}
 
       MetaSyncCandidateFile(MetaSyncCandidateFile&& src):
-         barrier(nullptr)
+         barrier(nullptr), fromJournal(false)
       {
          swap(src);
       }
@@ -73,11 +73,14 @@ class MetaSyncCandidateFile
       {
          paths.swap(other.paths);
          std::swap(barrier, other.barrier);
+         std::swap(fromJournal, other.fromJournal);
       }
 
       void signal()
       {
-         barrier->wait();
+         // candidates replayed from the resync journal have nobody waiting for them
+         if (barrier)
+            barrier->wait();
       }
 
       friend void swap(MetaSyncCandidateFile& a, MetaSyncCandidateFile& b)
@@ -88,6 +91,7 @@ class MetaSyncCandidateFile
    private:
       std::vector<Element> paths;
       Barrier* barrier;
+      bool fromJournal;
 
    public:
       const std::vector<Element>& getElements() const { return paths; }
@@ -107,6 +111,20 @@ class MetaSyncCandidateFile
       {
          this->barrier = &barrier;
       }
+
+      /**
+       * Elements of journal candidates were recorded some time ago, so whether they are synced as
+       * modifications or deletions is decided by their current state when they are synced.
+       */
+      void setFromJournal()
+      {
+         fromJournal = true;
+      }
+
+      bool isFromJournal() const
+      {
+         return fromJournal;
+      }
 };
 
 typedef SyncCandidateStore<MetaSyncCandidateDir, MetaSyncCandidateFile> MetaSyncCandidateStore;
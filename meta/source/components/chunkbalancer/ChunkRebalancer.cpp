@@ -0,0 +1,775 @@
+#include <common/net/message/mon/RequestStorageDataMsg.h>
+#include <common/net/message/mon/RequestStorageDataRespMsg.h>
+#include <common/storage/striping/StripePattern.h>
+#include <common/toolkit/MessagingTk.h>
+#include <common/toolkit/StorageTk.h>
+#include <common/toolkit/UnitTk.h>
+#include <net/message/storage/chunkbalancing/StartChunkBalanceMsgEx.h>
+#include <program/Program.h>
+#include <toolkit/StorageTkEx.h>
+
+#include "ChunkRebalancer.h"
+
+#include <mutex>
+
+#define CHUNKREBALANCER_WALK_BATCH           100  // dentries per listing call
+#define CHUNKREBALANCER_MIN_CHUNK_BYTES      (1024*1024) // smaller chunks are not worth moving
+#define CHUNKREBALANCER_HOT_FACTOR           2.0  // node is hot above this multiple of mean traffic
+#define CHUNKREBALANCER_MOVE_TIMEOUT_FACTOR  4    // multiple of tuneChunkBalanceLockingTimeLimit
+#define CHUNKREBALANCER_INFLIGHT_WAIT_MS     1000
+
+
+ChunkRebalancer::ChunkRebalancer() :
+   ChunkRebalancer(getTuningFromConfig() )
+{
+}
+
+/**
+ * @param tuning config values used by the rebalancer (tests have no App to read them from)
+ */
+ChunkRebalancer::ChunkRebalancer(const Tuning& tuning) :
+   PThread("ChunkRebalancer"),
+   tuning(tuning),
+   meanDiskBytesPerSec(0),
+   numActiveSources(0),
+   remainingAcceptBytes(0),
+   cursor{false, 0, 0, 0, "", 0},
+   stats()
+{
+   const auto now = std::chrono::steady_clock::now();
+
+   byteBudget = {double(tuning.maxBytesPerSec), 0, now};
+   fileBudget = {double(tuning.maxFilesPerSec), 0, now};
+}
+
+ChunkRebalancer::Tuning ChunkRebalancer::getTuningFromConfig()
+{
+   Config* cfg = Program::getApp()->getConfig();
+
+   return {cfg->getTuneChunkRebalanceFillDiff() / 100.0, cfg->getTuneChunkRebalanceMaxQueuedReqs(),
+      cfg->getTuneChunkRebalanceMaxBytesPerSec(), cfg->getTuneChunkRebalanceMaxFilesPerSec()};
+}
+
+void ChunkRebalancer::run()
+{
+   try
+   {
+      registerSignalHandler();
+
+      const unsigned intervalMS = Program::getApp()->getConfig()->getTuneChunkRebalanceInterval()
+         * 1000;
+
+      while (!waitForSelfTerminateOrder(intervalMS) )
+         runRound();
+
+      LogContext(__func__).log(Log_DEBUG, "Component stopped.");
+   }
+   catch (std::exception& e)
+   {
+      PThread::getCurrentThreadApp()->handleComponentException(e);
+   }
+}
+
+void ChunkRebalancer::runRound()
+{
+   Config* cfg = Program::getApp()->getConfig();
+
+   const auto roundEnd = std::chrono::steady_clock::now()
+      + std::chrono::seconds(cfg->getTuneChunkRebalanceInterval() );
+   const size_t maxInFlight = std::max(cfg->getTuneChunkBalanceQueueLimit() / 2, 1u);
+
+   expireInFlightMoves();
+
+   unsigned numSources = updateTargetInfo() ? planRound() : 0;
+
+   {
+      const std::lock_guard<Mutex> lock(statsMutex);
+      stats.numRounds++;
+      stats.numSourceTargets = numSources;
+   }
+
+   if (!numSources)
+      return;
+
+   LogContext(__func__).log(LogTopic_CHUNKBALANCING, Log_NOTICE,
+      "Rebalancing chunks away from " + std::to_string(numSources) + " over-full targets.");
+
+   while (!getSelfTerminate() && std::chrono::steady_clock::now() < roundEnd)
+   {
+      if (getNumInFlight() >= maxInFlight)
+      {
+         if (waitForSelfTerminateOrder(CHUNKREBALANCER_INFLIGHT_WAIT_MS) )
+            break;
+
+         continue;
+      }
+
+      bool passCompleted = false;
+      const bool moreWork = walkNextBatch(&passCompleted);
+
+      if (passCompleted)
+      {
+         const std::lock_guard<Mutex> lock(statsMutex);
+         stats.numWalkPasses++;
+      }
+
+      // a completed pass has seen every file once, so there is nothing left for this round
+      if (!moreWork || passCompleted)
+         break;
+   }
+
+   LogContext(__func__).log(LogTopic_CHUNKBALANCING, Log_NOTICE,
+      "Chunk rebalance round finished. " + getStatsAsStr() );
+}
+
+/**
+ * Fetches fill levels of all storage targets and load stats of their nodes.
+ *
+ * @return false if no usable target was found
+ */
+bool ChunkRebalancer::updateTargetInfo()
+{
+   App* app = Program::getApp();
+   NodeStoreServers* storageNodes = app->getStorageNodes();
+   TargetMapper* targetMapper = app->getTargetMapper();
+   TargetStateStore* targetStates = app->getTargetStateStore();
+   StoragePoolStore* storagePools = app->getStoragePoolStore();
+
+   targets.clear();
+   nodeLoads.clear();
+
+   double diskBytesPerSecSum = 0;
+
+   for (const auto& node : storageNodes->referenceAllNodes() )
+   {
+      const NumNodeID nodeID = node->getNumID();
+
+      RequestStorageDataMsg msg(lastStatsTimeMS[nodeID]);
+
+      const auto respMsg = MessagingTk::requestResponse(*node, msg,
+         NETMSGTYPE_RequestStorageDataResp);
+      if (!respMsg)
+      {
+         LogContext(__func__).log(LogTopic_CHUNKBALANCING, Log_DEBUG,
+            "Unable to fetch storage data from node: " + node->getNodeIDWithTypeStr() );
+         continue;
+      }
+
+      auto* resp = (RequestStorageDataRespMsg*)respMsg.get();
+
+      NodeLoad load = {0, 0};
+      HighResStatsList& statsList = resp->getStatsList();
+
+      if (!statsList.empty() )
+      {
+         uint64_t queuedRequests = 0;
+         uint64_t diskBytes = 0;
+         uint64_t firstTimeMS = statsList.front().rawVals.statsTimeMS;
+         uint64_t lastTimeMS = firstTimeMS;
+
+         for (const auto& entry : statsList)
+         {
+            queuedRequests += entry.rawVals.queuedRequests;
+            diskBytes += entry.incVals.diskReadBytes + entry.incVals.diskWriteBytes;
+            firstTimeMS = std::min(firstTimeMS, entry.rawVals.statsTimeMS);
+            lastTimeMS = std::max(lastTimeMS, entry.rawVals.statsTimeMS);
+         }
+
+         // each entry covers one stats collector interval (one second on storage servers)
+         const double spanSecs = (lastTimeMS - firstTimeMS) / 1000.0 + 1;
+
+         load.avgQueuedRequests = double(queuedRequests) / statsList.size();
+         load.diskBytesPerSec = diskBytes / spanSecs;
+
+         lastStatsTimeMS[nodeID] = lastTimeMS;
+      }
+
+      nodeLoads[nodeID] = load;
+      diskBytesPerSecSum += load.diskBytesPerSec;
+
+      for (const auto& targetInfo : resp->getStorageTargets() )
+      {
+         const uint16_t targetID = targetInfo.getTargetID();
+
+         if (targetInfo.getDiskSpaceTotal() <= 0)
+            continue; // statfs() failed on this target
+
+         if (targetMapper->getNodeID(targetID) != nodeID)
+            continue; // mapping changed while we were asking
+
+         CombinedTargetState state;
+         if (!targetStates->getState(targetID, state)
+               || state.reachabilityState != TargetReachabilityState_ONLINE
+               || state.consistencyState != TargetConsistencyState_GOOD)
+            continue;
+
+         StoragePoolPtr pool = storagePools->getPool(targetID);
+         if (!pool)
+            continue;
+
+         CapacityPoolType capacityPool = CapacityPool_NORMAL;
+         pool->getTargetCapacityPools()->getPoolAssignment(targetID, &capacityPool);
+
+         targets[targetID] = {targetID, nodeID, pool->getId(), capacityPool,
+            targetInfo.getDiskSpaceTotal(), targetInfo.getDiskSpaceFree(), 0, 0};
+      }
+   }
+
+   meanDiskBytesPerSec = nodeLoads.empty() ? 0 : diskBytesPerSecSum / nodeLoads.size();
+
+   return !targets.empty();
+}
+
+/**
+ * Decides which targets chunks are moved away from (targets in a LOW or EMERGENCY capacity pool
+ * that are above the pool average, and targets that are more than tuneChunkRebalanceFillDiff
+ * percent above the pool average) and how much data each target shall give or take, so that all
+ * targets of a pool end up close to the pool average.
+ *
+ * @return number of source targets
+ */
+unsigned ChunkRebalancer::planRound()
+{
+   const double fillDiff = tuning.fillDiff;
+
+   std::map<StoragePoolId, std::vector<TargetInfo*>> pools;
+
+   for (auto& target : targets)
+      pools[target.second.poolID].push_back(&target.second);
+
+   numActiveSources = 0;
+   remainingAcceptBytes = 0;
+
+   for (auto& pool : pools)
+   {
+      int64_t spaceTotal = 0;
+      int64_t spaceUsed = 0;
+
+      for (const TargetInfo* target : pool.second)
+      {
+         spaceTotal += target->spaceTotal;
+         spaceUsed += target->spaceTotal - target->spaceFree;
+      }
+
+      const double avgFill = double(spaceUsed) / spaceTotal;
+
+      unsigned numSources = 0;
+      int64_t acceptBytes = 0;
+
+      for (TargetInfo* target : pool.second)
+      {
+         const int64_t used = target->spaceTotal - target->spaceFree;
+         const int64_t avgUsed = int64_t(avgFill * target->spaceTotal);
+         const double fill = double(used) / target->spaceTotal;
+
+         if (fill > avgFill + fillDiff
+               || (target->capacityPool != CapacityPool_NORMAL && fill > avgFill) )
+         {
+            target->excessBytes = used - avgUsed;
+            numSources++;
+         }
+         else
+         if (target->capacityPool == CapacityPool_NORMAL && used < avgUsed)
+         {
+            target->acceptBytes = avgUsed - used;
+            acceptBytes += target->acceptBytes;
+         }
+      }
+
+      if (!numSources || !acceptBytes)
+      {
+         for (TargetInfo* target : pool.second)
+            target->excessBytes = 0;
+
+         continue;
+      }
+
+      numActiveSources += numSources;
+      remainingAcceptBytes += acceptBytes;
+   }
+
+   return numActiveSources;
+}
+
+/**
+ * Processes the next batch of dentries from the walk cursor.
+ *
+ * @param outPassCompleted set to true if the cursor wrapped around after the last dentry
+ * @return false if this round needs no further moves
+ */
+bool ChunkRebalancer::walkNextBatch(bool* outPassCompleted)
+{
+   MetaStore* metaStore = Program::getApp()->getMetaStore();
+
+   *outPassCompleted = false;
+
+   if (cursor.contDirID.empty() )
+   {
+      const unsigned hashDirNum = StorageTk::mergeHashDirs(cursor.hashDirLevel1,
+         cursor.hashDirLevel2);
+      int64_t newHashDirOffset = 0;
+
+      if (!StorageTkEx::getNextContDirID(hashDirNum, cursor.buddyMirrored, cursor.hashDirOffset,
+            &cursor.contDirID, &newHashDirOffset) )
+      {
+         *outPassCompleted = advanceCursor();
+         return true;
+      }
+
+      cursor.hashDirOffset = newHashDirOffset;
+      cursor.contDirOffset = 0;
+   }
+
+   DirInode* dir = metaStore->referenceDir(cursor.contDirID, cursor.buddyMirrored, true);
+   if (!dir)
+   {
+      cursor.contDirID.clear();
+      return true;
+   }
+
+   StringList names;
+   Int64List offsets;
+   ListIncExOutArgs listArgs(&names, NULL, NULL, &offsets, NULL);
+
+   FhgfsOpsErr listRes = dir->listIncrementalEx(cursor.contDirOffset, CHUNKREBALANCER_WALK_BATCH,
+      true, listArgs);
+
+   if (listRes != FhgfsOpsErr_SUCCESS || names.empty() )
+   {
+      metaStore->releaseDir(cursor.contDirID);
+      cursor.contDirID.clear();
+      return true;
+   }
+
+   uint64_t numScanned = 0;
+   auto offsetIter = offsets.begin();
+
+   // the cursor is only moved past entries that were visited, so an interrupted batch continues
+   // with the first entry that was not handled
+   for (auto nameIter = names.begin(); nameIter != names.end(); nameIter++, offsetIter++)
+   {
+      if (!numActiveSources || remainingAcceptBytes <= 0)
+         break;
+
+      EntryInfo entryInfo;
+      FileInodeStoreData inodeData;
+
+      if (loadEntry(dir, *nameIter, &entryInfo, &inodeData) )
+      {
+         numScanned++;
+
+         // (the entry was not handled, the walk continues with it)
+         if (!processEntry(entryInfo, inodeData) )
+            break;
+      }
+
+      cursor.contDirOffset = *offsetIter;
+   }
+
+   metaStore->releaseDir(cursor.contDirID);
+
+   {
+      const std::lock_guard<Mutex> lock(statsMutex);
+      stats.numFilesScanned += numScanned;
+   }
+
+   return numActiveSources && remainingAcceptBytes > 0 && !getSelfTerminate();
+}
+
+/**
+ * Loads the metadata of a dentry of the walk.
+ *
+ * @return false if the entry is not a file whose chunks can be moved
+ */
+bool ChunkRebalancer::loadEntry(DirInode* dir, const std::string& name, EntryInfo* outEntryInfo,
+   FileInodeStoreData* outInodeData)
+{
+   MetaStore* metaStore = Program::getApp()->getMetaStore();
+
+   auto [getRes, isFileOpen] = metaStore->getEntryData(dir, name, outEntryInfo, outInodeData);
+
+   if (getRes != FhgfsOpsErr_SUCCESS && getRes != FhgfsOpsErr_DYNAMICATTRIBSOUTDATED)
+      return false;
+
+   // open files are in use by applications, moving their chunks would compete with them
+   if (!DirEntryType_ISREGULARFILE(outEntryInfo->getEntryType() ) || isFileOpen)
+      return false;
+
+   if (!outEntryInfo->getIsInlined()
+         && metaStore->getEntryData(outEntryInfo, outInodeData) != FhgfsOpsErr_SUCCESS)
+      return false;
+
+   return true;
+}
+
+/**
+ * Moves the cursor to the next hash dir, and from the last hash dir of the unmirrored dentries to
+ * the mirrored ones (if this node is the primary of its buddy group).
+ *
+ * @return true if the cursor wrapped around to the beginning
+ */
+bool ChunkRebalancer::advanceCursor()
+{
+   cursor.hashDirOffset = 0;
+   cursor.contDirID.clear();
+
+   if (++cursor.hashDirLevel2 < META_DENTRIES_LEVEL2_SUBDIR_NUM)
+      return false;
+
+   cursor.hashDirLevel2 = 0;
+
+   if (++cursor.hashDirLevel1 < META_DENTRIES_LEVEL1_SUBDIR_NUM)
+      return false;
+
+   cursor.hashDirLevel1 = 0;
+
+   if (!cursor.buddyMirrored && mirroredDentriesAreLocal() )
+   {
+      cursor.buddyMirrored = true;
+      return false;
+   }
+
+   cursor.buddyMirrored = false;
+   return true;
+}
+
+/**
+ * Mirrored files are only rebalanced by the primary of the buddy group.
+ */
+bool ChunkRebalancer::mirroredDentriesAreLocal()
+{
+   App* app = Program::getApp();
+   MirrorBuddyGroupMapper* bgm = app->getMetaBuddyGroupMapper();
+
+   return bgm->getLocalGroupID() != 0
+      && bgm->getLocalBuddyGroup().firstTargetID == app->getLocalNode().getNumID().val();
+}
+
+/**
+ * Queues a move for the first chunk of the file that is on a source target. At most one chunk per
+ * file is moved per round, because moves change the stripe pattern asynchronously.
+ *
+ * @return false if the walk shall be interrupted
+ */
+bool ChunkRebalancer::processEntry(EntryInfo& entryInfo, FileInodeStoreData& inodeData)
+{
+   StripePattern* pattern = inodeData.getStripePattern();
+
+   if (!pattern || pattern->getPatternType() != StripePatternType_Raid0)
+      return true;
+
+   {
+      const std::lock_guard<Mutex> lock(inFlightMutex);
+
+      if (inFlightMoves.count(entryInfo.getEntryID() ) )
+         return true;
+   }
+
+   const UInt16Vector& stripeTargets = *pattern->getStripeTargetIDs();
+   const int64_t fileSize = inodeData.getInodeStatData()->getFileSize();
+
+   for (unsigned i = 0; i < stripeTargets.size(); i++)
+   {
+      auto sourceIter = targets.find(stripeTargets[i]);
+      if (sourceIter == targets.end() || sourceIter->second.excessBytes <= 0)
+         continue;
+
+      TargetInfo& source = sourceIter->second;
+
+      if (nodeIsBusy(source.nodeID) )
+         continue;
+
+      const uint64_t bytes = getChunkFileLength(fileSize, pattern->getChunkSize(),
+         stripeTargets.size(), i);
+      if (bytes < CHUNKREBALANCER_MIN_CHUNK_BYTES)
+         continue;
+
+      TargetInfo* destination = chooseDestination(source.poolID, stripeTargets, bytes);
+      if (!destination)
+         continue;
+
+      if (!waitForBudget(bytes) )
+         return false;
+
+      PathInfo pathInfo;
+      inodeData.getPathInfo(&pathInfo);
+
+      const std::string chunkPath = StorageTk::getFileChunkPath(&pathInfo,
+         entryInfo.getEntryID() );
+
+      FhgfsOpsErr queueRes = queueMove(entryInfo, chunkPath, source.targetID,
+         destination->targetID, bytes);
+      if (queueRes == FhgfsOpsErr_AGAIN)
+         return false; // balancer queue is full, continue in the next round
+
+      if (queueRes != FhgfsOpsErr_SUCCESS)
+         return true;
+
+      source.excessBytes -= bytes;
+      if (source.excessBytes <= 0)
+         numActiveSources--;
+
+      destination->acceptBytes -= bytes;
+      remainingAcceptBytes -= bytes;
+
+      return true;
+   }
+
+   return true;
+}
+
+/**
+ * Picks the target of the pool that is furthest below the pool average. Targets on hot nodes are
+ * only used if there is no other choice.
+ */
+ChunkRebalancer::TargetInfo* ChunkRebalancer::chooseDestination(StoragePoolId poolID,
+   const UInt16Vector& stripeTargets, uint64_t bytes)
+{
+   TargetInfo* best = NULL;
+   bool bestIsHot = true;
+
+   for (auto& entry : targets)
+   {
+      TargetInfo& target = entry.second;
+
+      if (target.poolID != poolID || target.acceptBytes < int64_t(bytes) )
+         continue;
+
+      if (std::find(stripeTargets.begin(), stripeTargets.end(), target.targetID)
+            != stripeTargets.end() )
+         continue;
+
+      if (nodeIsBusy(target.nodeID) )
+         continue;
+
+      const bool isHot = meanDiskBytesPerSec > 0
+         && nodeLoads[target.nodeID].diskBytesPerSec
+            > CHUNKREBALANCER_HOT_FACTOR * meanDiskBytesPerSec;
+
+      if (!best
+            || (bestIsHot && !isHot)
+            || (bestIsHot == isHot && target.acceptBytes > best->acceptBytes) )
+      {
+         best = &target;
+         bestIsHot = isHot;
+      }
+   }
+
+   return best;
+}
+
+bool ChunkRebalancer::nodeIsBusy(NumNodeID nodeID) const
+{
+   if (!tuning.maxQueuedReqs)
+      return false;
+
+   auto iter = nodeLoads.find(nodeID);
+
+   return iter != nodeLoads.end() && iter->second.avgQueuedRequests > tuning.maxQueuedReqs;
+}
+
+FhgfsOpsErr ChunkRebalancer::queueMove(EntryInfo& entryInfo, const std::string& chunkPath,
+   uint16_t sourceTargetID, uint16_t destinationTargetID, uint64_t bytes)
+{
+   ChunkBalancerJob* chunkBalanceJob = StartChunkBalanceMsgEx::addChunkBalanceJob();
+   if (unlikely(!chunkBalanceJob) )
+      return FhgfsOpsErr_INTERNAL;
+
+   FileEvent fileEvent;
+   fileEvent.type = FileEventType::STRIPE_PATTERN_CHANGED;
+   fileEvent.path = entryInfo.getFileName();
+   fileEvent.targetValid = false;
+
+   ChunkSyncCandidateFile candidate(idType_TARGET, chunkPath, sourceTargetID,
+      destinationTargetID, &entryInfo, &fileEvent);
+
+   FhgfsOpsErr addRes = chunkBalanceJob->addChunkSyncCandidate(&candidate);
+   if (addRes != FhgfsOpsErr_SUCCESS)
+      return addRes;
+
+   {
+      const std::lock_guard<Mutex> lock(inFlightMutex);
+      inFlightMoves[entryInfo.getEntryID()] =
+         {sourceTargetID, bytes, std::chrono::steady_clock::now()};
+   }
+
+   LOG_DEBUG(__func__, Log_DEBUG, "Queued chunk move. chunkPath: " + chunkPath
+      + "; sourceTargetID: " + std::to_string(sourceTargetID)
+      + "; destinationTargetID: " + std::to_string(destinationTargetID) );
+
+   const std::lock_guard<Mutex> lock(statsMutex);
+   stats.numMovesQueued++;
+   stats.bytesQueued += bytes;
+
+   return FhgfsOpsErr_SUCCESS;
+}
+
+/**
+ * Called when the stripe pattern update for a chunk move arrives from the storage server.
+ */
+void ChunkRebalancer::chunkMoveFinished(const std::string& entryID, uint16_t targetID,
+   bool success)
+{
+   uint64_t bytes;
+
+   {
+      const std::lock_guard<Mutex> lock(inFlightMutex);
+
+      auto iter = inFlightMoves.find(entryID);
+      if (iter == inFlightMoves.end() || iter->second.sourceTargetID != targetID)
+         return; // not queued by us
+
+      bytes = iter->second.bytes;
+      inFlightMoves.erase(iter);
+   }
+
+   const std::lock_guard<Mutex> lock(statsMutex);
+
+   if (success)
+   {
+      stats.numMovesDone++;
+      stats.bytesMoved += bytes;
+   }
+   else
+      stats.numMovesFailed++;
+}
+
+/**
+ * Moves that fail before the storage server has started the copy never report back, so they are
+ * counted as failed after a while.
+ */
+void ChunkRebalancer::expireInFlightMoves()
+{
+   const auto timeout = std::chrono::seconds(CHUNKREBALANCER_MOVE_TIMEOUT_FACTOR
+      * Program::getApp()->getConfig()->getTuneChunkBalanceLockingTimeLimit() );
+   const auto now = std::chrono::steady_clock::now();
+
+   uint64_t numExpired = 0;
+
+   {
+      const std::lock_guard<Mutex> lock(inFlightMutex);
+
+      for (auto iter = inFlightMoves.begin(); iter != inFlightMoves.end(); )
+      {
+         if (now - iter->second.startTime > timeout)
+         {
+            iter = inFlightMoves.erase(iter);
+            numExpired++;
+         }
+         else
+            iter++;
+      }
+   }
+
+   const std::lock_guard<Mutex> lock(statsMutex);
+   stats.numMovesFailed += numExpired;
+}
+
+size_t ChunkRebalancer::getNumInFlight()
+{
+   const std::lock_guard<Mutex> lock(inFlightMutex);
+   return inFlightMoves.size();
+}
+
+/**
+ * Blocks until the byte and file budgets allow another move. A move may overdraw the byte budget,
+ * the next move then waits until the debt is paid back.
+ *
+ * @return false if the component shall terminate
+ */
+bool ChunkRebalancer::waitForBudget(uint64_t bytes)
+{
+   while (true)
+   {
+      refillBudget(byteBudget);
+      refillBudget(fileBudget);
+
+      double waitSecs = 0;
+
+      if (byteBudget.rate && byteBudget.tokens <= 0)
+         waitSecs = std::max(waitSecs, (1 - byteBudget.tokens) / byteBudget.rate);
+
+      if (fileBudget.rate && fileBudget.tokens < 1)
+         waitSecs = std::max(waitSecs, (1 - fileBudget.tokens) / fileBudget.rate);
+
+      if (!waitSecs)
+         break;
+
+      const int waitMS = std::min(std::max(int(waitSecs * 1000), 1), 1000);
+
+      if (waitForSelfTerminateOrder(waitMS) )
+         return false;
+   }
+
+   byteBudget.tokens -= bytes;
+   fileBudget.tokens -= 1;
+
+   return true;
+}
+
+/**
+ * Adds the tokens earned since the last refill. Unused budget is capped at one second worth of
+ * tokens to keep bursts short.
+ */
+void ChunkRebalancer::refillBudget(Budget& budget)
+{
+   const auto now = std::chrono::steady_clock::now();
+   const double elapsedSecs = std::chrono::duration<double>(now - budget.lastRefill).count();
+
+   budget.lastRefill = now;
+
+   if (budget.rate)
+      budget.tokens = std::min(budget.tokens + elapsedSecs * budget.rate, budget.rate);
+}
+
+/**
+ * @return length of the chunk file of a RAID0 file on the target with the given stripe index
+ */
+uint64_t ChunkRebalancer::getChunkFileLength(int64_t fileSize, unsigned chunkSize,
+   unsigned numTargets, unsigned targetIndex)
+{
+   if (fileSize <= 0 || !chunkSize || !numTargets)
+      return 0;
+
+   const uint64_t stripeSetSize = uint64_t(chunkSize) * numTargets;
+   const uint64_t numFullStripeSets = fileSize / stripeSetSize;
+   const uint64_t remainder = fileSize % stripeSetSize;
+   const uint64_t targetStart = uint64_t(targetIndex) * chunkSize;
+
+   uint64_t length = numFullStripeSets * chunkSize;
+
+   if (remainder > targetStart)
+      length += std::min(remainder - targetStart, uint64_t(chunkSize) );
+
+   return length;
+}
+
+ChunkRebalancer::Stats ChunkRebalancer::getStats()
+{
+   Stats result;
+
+   {
+      const std::lock_guard<Mutex> lock(statsMutex);
+      result = stats;
+   }
+
+   result.numMovesInFlight = getNumInFlight();
+
+   return result;
+}
+
+std::string ChunkRebalancer::getStatsAsStr()
+{
+   const Stats current = getStats();
+
+   return "Rounds: " + std::to_string(current.numRounds) +
+      "; Walk passes: " + std::to_string(current.numWalkPasses) +
+      "; Files scanned: " + std::to_string(current.numFilesScanned) +
+      "; Source targets: " + std::to_string(current.numSourceTargets) +
+      "; Moves queued: " + std::to_string(current.numMovesQueued) +
+      "; done: " + std::to_string(current.numMovesDone) +
+      "; failed: " + std::to_string(current.numMovesFailed) +
+      "; in flight: " + std::to_string(current.numMovesInFlight) +
+      "; Bytes queued: " + UnitTk::int64ToHumanStr(current.bytesQueued) +
+      "; moved: " + UnitTk::int64ToHumanStr(current.bytesMoved);
+}
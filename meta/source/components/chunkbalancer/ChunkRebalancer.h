@@ -0,0 +1,165 @@
+#pragma once
+
+#include <common/nodes/CapacityPoolType.h>
+#include <common/nodes/NumNodeID.h>
+#include <common/storage/StoragePoolId.h>
+#include <common/threading/Mutex.h>
+#include <common/threading/PThread.h>
+#include <common/Common.h>
+
+#include <chrono>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class DirInode;
+class EntryInfo;
+class FileInodeStoreData;
+
+/**
+ * Background policy that keeps the storage targets of each storage pool evenly filled by moving
+ * chunks of existing files from over-full targets to the emptiest targets of the same pool.
+ *
+ * Every round (tuneChunkRebalanceInterval) the rebalancer collects fill levels and load stats of
+ * all storage targets, marks targets as sources if they are in a LOW or EMERGENCY capacity pool or
+ * more than tuneChunkRebalanceFillDiff percent above the pool average, and then walks the local
+ * dentries to pick files with chunks on those targets. The chosen moves are handed to the regular
+ * ChunkBalancerJob, exactly like moves requested through StartChunkBalanceMsg.
+ *
+ * To keep production I/O unaffected, moves are rate-limited by a byte and a file budget, files
+ * that are currently open are skipped, and storage nodes whose work queues are longer than
+ * tuneChunkRebalanceMaxQueuedReqs are left alone for the rest of the round. Among equally filled
+ * destinations, the one with the least disk traffic is preferred.
+ *
+ * Only files with a RAID0 stripe pattern are rebalanced.
+ */
+class ChunkRebalancer : public PThread
+{
+   friend class TestChunkRebalancer;
+
+   public:
+      struct Stats
+      {
+         uint64_t numRounds;
+         uint64_t numWalkPasses; // completed walks over all local dentries
+         uint64_t numFilesScanned;
+         uint64_t numMovesQueued;
+         uint64_t numMovesDone;
+         uint64_t numMovesFailed; // failed or timed out
+         uint64_t bytesQueued;
+         uint64_t bytesMoved;
+         unsigned numSourceTargets; // over-full targets in the current round
+         unsigned numMovesInFlight;
+      };
+
+      ChunkRebalancer();
+
+      virtual void run();
+
+      void chunkMoveFinished(const std::string& entryID, uint16_t targetID, bool success);
+
+      Stats getStats();
+      std::string getStatsAsStr();
+
+   private:
+      struct Tuning
+      {
+         double fillDiff; // tuneChunkRebalanceFillDiff as a fraction
+         unsigned maxQueuedReqs;
+         int64_t maxBytesPerSec;
+         unsigned maxFilesPerSec;
+      };
+
+      struct NodeLoad
+      {
+         double avgQueuedRequests;
+         double diskBytesPerSec;
+      };
+
+      struct TargetInfo
+      {
+         uint16_t targetID;
+         NumNodeID nodeID;
+         StoragePoolId poolID;
+         CapacityPoolType capacityPool;
+         int64_t spaceTotal;
+         int64_t spaceFree;
+
+         int64_t excessBytes; // sources: bytes to move away in this round
+         int64_t acceptBytes; // destinations: bytes that may still be moved here in this round
+      };
+
+      struct Budget
+      {
+         double rate; // per second, 0 means unlimited
+         double tokens;
+         std::chrono::steady_clock::time_point lastRefill;
+      };
+
+      struct InFlightMove
+      {
+         uint16_t sourceTargetID;
+         uint64_t bytes;
+         std::chrono::steady_clock::time_point startTime;
+      };
+
+      struct WalkCursor
+      {
+         bool buddyMirrored;
+         unsigned hashDirLevel1;
+         unsigned hashDirLevel2;
+         int64_t hashDirOffset;
+         std::string contDirID;
+         int64_t contDirOffset;
+      };
+
+      const Tuning tuning;
+
+      std::map<uint16_t, TargetInfo> targets;
+      std::map<NumNodeID, NodeLoad> nodeLoads;
+      std::map<NumNodeID, uint64_t> lastStatsTimeMS;
+      double meanDiskBytesPerSec;
+
+      unsigned numActiveSources; // sources with excessBytes left in this round
+      int64_t remainingAcceptBytes; // sum of acceptBytes of all destinations
+
+      Budget byteBudget;
+      Budget fileBudget;
+
+      WalkCursor cursor;
+
+      Mutex inFlightMutex;
+      std::unordered_map<std::string, InFlightMove> inFlightMoves; // key: entryID
+
+      Mutex statsMutex;
+      Stats stats;
+
+      explicit ChunkRebalancer(const Tuning& tuning);
+
+      static Tuning getTuningFromConfig();
+
+      bool updateTargetInfo();
+      unsigned planRound();
+      void runRound();
+
+      bool walkNextBatch(bool* outPassCompleted);
+      static bool loadEntry(DirInode* dir, const std::string& name, EntryInfo* outEntryInfo,
+         FileInodeStoreData* outInodeData);
+      bool advanceCursor();
+      static bool mirroredDentriesAreLocal();
+      bool processEntry(EntryInfo& entryInfo, FileInodeStoreData& inodeData);
+
+      TargetInfo* chooseDestination(StoragePoolId poolID, const UInt16Vector& stripeTargets,
+         uint64_t bytes);
+      bool nodeIsBusy(NumNodeID nodeID) const;
+      FhgfsOpsErr queueMove(EntryInfo& entryInfo, const std::string& chunkPath,
+         uint16_t sourceTargetID, uint16_t destinationTargetID, uint64_t bytes);
+
+      bool waitForBudget(uint64_t bytes);
+      void expireInFlightMoves();
+      size_t getNumInFlight();
+
+      static uint64_t getChunkFileLength(int64_t fileSize, unsigned chunkSize,
+         unsigned numTargets, unsigned targetIndex);
+      static void refillBudget(Budget& budget);
+};
@@ -23,7 +23,7 @@ class MirroredMessage : public BaseT
       LockStateT lockState;
 
       MirroredMessage():
-         resyncJob(nullptr)
+         resyncJob(nullptr), journalChangeSet(false), secondaryMissedUpdate(false)
       {}
 
       virtual FhgfsOpsErr processSecondaryResponse(NetMessage& resp) = 0;
@@ -65,6 +65,14 @@ class MirroredMessage : public BaseT
             lockState = lock(*Program::getApp()->getMirroredSessions()->getEntryLockStore());
          }
 
+         // if we take over as primary later, our buddy may have executed operations that never
+         // reached us. our journal would not know about these.
+         if (isMirrored() && this->hasFlag(NetMessageHeader::Flag_BuddyMirrorSecond))
+         {
+            if (auto* journal = Program::getApp()->getBuddyResyncer()->getJournal())
+               journal->invalidate("acting as secondary");
+         }
+
          // make sure that the thread change set is *always* cleared when we leave this method.
          struct _ClearChangeSet {
             ~_ClearChangeSet()
@@ -134,6 +142,17 @@ class MirroredMessage : public BaseT
                BuddyResyncer::registerSyncChangeset();
 	       resyncJob->registerOps();
 	    }
+            else if (isMirrored() && !this->hasFlag(NetMessageHeader::Flag_BuddyMirrorSecond))
+            {
+               // collect the changes of this operation in case the secondary misses it
+               auto* journal = Program::getApp()->getBuddyResyncer()->getJournal();
+
+               if (journal && journal->getIsValid())
+               {
+                  BuddyResyncer::registerSyncChangeset();
+                  journalChangeSet = true;
+               }
+            }
 
             auto responseState = executeLocally(ctx,
                isMirrored() && this->hasFlag(NetMessageHeader::Flag_BuddyMirrorSecond));
@@ -165,7 +184,7 @@ class MirroredMessage : public BaseT
          // pairs with the memory barrier before acquireMirrorStateSlot
          __sync_synchronize();
 
-         if (BuddyResyncer::getSyncChangeset())
+         if (BuddyResyncer::getSyncChangeset() && !journalChangeSet)
          {
             if (isMirrored() &&
                   !this->hasFlag(NetMessageHeader::Flag_BuddyMirrorSecond) &&
@@ -197,7 +216,15 @@ class MirroredMessage : public BaseT
          // pairs with the memory barrier before acquireMirrorStateSlot
          __sync_synchronize();
 
-         if (BuddyResyncer::getSyncChangeset())
+         if (BuddyResyncer::getSyncChangeset() && journalChangeSet)
+         {
+            if (secondaryMissedUpdate && responsePtr && responsePtr->changesObservableState())
+               Program::getApp()->getBuddyResyncer()->getJournal()->record(
+                     BuddyResyncer::getSyncChangeset()->getElements());
+
+            BuddyResyncer::abandonSyncChangeset();
+         }
+         else if (BuddyResyncer::getSyncChangeset())
          {
 	    resyncJob = Program::getApp()->getBuddyResyncer()->getResyncJob();
             if (isMirrored() &&
@@ -246,7 +273,10 @@ class MirroredMessage : public BaseT
          // if a resync is currently running, abort right here, immediatly. we do not need to know
          // the exact state of the buddy: a resync is running. it's bad.
          if (app->getInternodeSyncer()->getResyncInProgress())
+         {
+            secondaryMissedUpdate = true;
             return;
+         }
 
          // check whether the secondary is viable at all: if it is not online and good,
          // communicating will not do any good. even online/needs-resync must be skipped, because
@@ -280,6 +310,7 @@ class MirroredMessage : public BaseT
                      (!job->isRunning() && job->getState() != BuddyResyncJobState_SUCCESS))
                {
                   setBuddyNeedsResync();
+                  secondaryMissedUpdate = true;
                   return;
                }
             }
@@ -342,6 +373,7 @@ class MirroredMessage : public BaseT
                   "Resync will be required when secondary comes back", buddyNodeID, commRes);
 #endif
             setBuddyNeedsResync();
+            secondaryMissedUpdate = true;
 
             return;
          }
@@ -366,6 +398,7 @@ class MirroredMessage : public BaseT
                   ("Expected response", expectedResult),
                   ("Received response", respMsgRes));
             setBuddyNeedsResync();
+            secondaryMissedUpdate = true;
          }
       }
 
@@ -437,6 +470,9 @@ class MirroredMessage : public BaseT
    private:
       std::shared_ptr<MirrorStateSlot> mirrorState;
 
+      bool journalChangeSet; // thread changeset was registered for the resync journal
+      bool secondaryMissedUpdate; // set by sendToSecondary if the secondary must be resynced
+
       void setBuddyNeedsResync()
       {
          BuddyCommTk::setBuddyNeedsResync(Program::getApp()->getMetaPath(), true);
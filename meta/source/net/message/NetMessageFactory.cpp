@@ -25,6 +25,7 @@
 #include <net/message/nodes/HeartbeatMsgEx.h>
 #include <net/message/nodes/HeartbeatRequestMsgEx.h>
 #include <net/message/nodes/MapTargetsMsgEx.h>
+#include <net/message/nodes/MetaBenchControlMsgEx.h>
 #include <net/message/nodes/PublishCapacitiesMsgEx.h>
 #include <net/message/nodes/RefreshCapacityPoolsMsgEx.h>
 #include <net/message/nodes/RemoveNodeMsgEx.h>
@@ -134,6 +135,7 @@
 #include <net/message/session/opening/OpenFileMsgEx.h>
 
 // mon message
+#include <common/net/message/mon/RequestStorageDataRespMsg.h>
 #include <net/message/mon/RequestMetaDataMsgEx.h>
 
 // fsck messages
@@ -205,6 +207,7 @@ std::unique_ptr<NetMessage> NetMessageFactory::createFromMsgType(unsigned short
       case NETMSGTYPE_HeartbeatRequest: { msg = new HeartbeatRequestMsgEx(); } break;
       case NETMSGTYPE_Heartbeat: { msg = new HeartbeatMsgEx(); } break;
       case NETMSGTYPE_MapTargets: { msg = new MapTargetsMsgEx(); } break;
+      case NETMSGTYPE_MetaBenchControlMsg: { msg = new MetaBenchControlMsgEx(); } break;
       case NETMSGTYPE_PublishCapacities: { msg = new PublishCapacitiesMsgEx(); } break;
       case NETMSGTYPE_RefreshStoragePools: { msg = new RefreshStoragePoolsMsgEx(); } break;
       case NETMSGTYPE_RegisterNodeResp: { msg = new RegisterNodeRespMsg(); } break;
@@ -324,6 +327,7 @@ std::unique_ptr<NetMessage> NetMessageFactory::createFromMsgType(unsigned short
 
       // mon message
       case NETMSGTYPE_RequestMetaData: { msg = new RequestMetaDataMsgEx(); } break;
+      case NETMSGTYPE_RequestStorageDataResp: { msg = new RequestStorageDataRespMsg(); } break;
 
       // fsck messages
       case NETMSGTYPE_RetrieveDirEntries: { msg = new RetrieveDirEntriesMsgEx(); } break;
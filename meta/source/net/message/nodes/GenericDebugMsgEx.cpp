@@ -19,6 +19,8 @@
 #define GENDBGMSG_OP_DUMPDENTRY           "dumpdentry"
 #define GENDBGMSG_OP_DUMPINODE            "dumpinode"
 #define GENDBGMSG_OP_DUMPINLINEDINODE     "dumpinlinedinode"
+#define GENDBGMSG_OP_CHUNKREBALANCESTATS  "chunkrebalancestats"
+#define GENDBGMSG_OP_TARGETLOADS          "targetloads"
 
 #ifdef BEEGFS_DEBUG
    #define GENDBGMSG_OP_WRITEDIRDENTRY       "writedirdentry"
@@ -105,6 +107,12 @@ std::string GenericDebugMsgEx::processCommand()
    if(operation == GENDBGMSG_OP_SETLOGLEVEL)
       responseStr = MsgHelperGenericDebug::processOpSetLogLevel(commandStream);
    else
+   if(operation == GENDBGMSG_OP_LOCKSTATS)
+      responseStr = MsgHelperGenericDebug::processOpLockStats(commandStream);
+   else
+   if(operation == GENDBGMSG_OP_OBJECTPOOLSTATS)
+      responseStr = MsgHelperGenericDebug::processOpObjectPoolStats(commandStream);
+   else
    if(operation == GENDBGMSG_OP_NETOUT)
       responseStr = MsgHelperGenericDebug::processOpNetOut(commandStream,
          app->getMgmtNodes(), app->getMetaNodes(), app->getStorageNodes() );
@@ -134,6 +142,12 @@ std::string GenericDebugMsgEx::processCommand()
    else if(operation == GENDBGMSG_OP_LISTSTORAGEPOOLS)
       responseStr = MsgHelperGenericDebug::processOpListStoragePools(commandStream,
          app->getStoragePoolStore());
+   else
+   if(operation == GENDBGMSG_OP_CHUNKREBALANCESTATS)
+      responseStr = processOpChunkRebalanceStats(commandStream);
+   else
+   if(operation == GENDBGMSG_OP_TARGETLOADS)
+      responseStr = processOpTargetLoads(commandStream);
 #ifdef BEEGFS_DEBUG
    else
    if(operation == GENDBGMSG_OP_WRITEDIRDENTRY)
@@ -754,6 +768,36 @@ std::string GenericDebugMsgEx::processOpQuotaExceeded(std::istringstream& comman
    return MsgHelperGenericDebug::processOpQuotaExceeded(commandStream, exQuotaStore.get());
 }
 
+/**
+ * Progress of the automatic chunk rebalancer.
+ */
+std::string GenericDebugMsgEx::processOpChunkRebalanceStats(std::istringstream& commandStream)
+{
+   // protocol: no arguments
+
+   ChunkRebalancer* rebalancer = Program::getApp()->getChunkRebalancer();
+
+   if(!rebalancer)
+      return "Automatic chunk rebalancing is disabled (see tuneChunkRebalanceInterval).";
+
+   return rebalancer->getStatsAsStr();
+}
+
+/**
+ * Storage node loads used by the loadaware target chooser.
+ */
+std::string GenericDebugMsgEx::processOpTargetLoads(std::istringstream& commandStream)
+{
+   // protocol: no arguments
+
+   App* app = Program::getApp();
+
+   if(app->getConfig()->getTuneTargetChooserNum() != TargetChooserType_LOADAWARE)
+      return "Storage node loads are only collected for the loadaware target chooser.";
+
+   return app->getTargetLoadStore()->getStateAsStr();
+}
+
 #ifdef BEEGFS_DEBUG
 std::string GenericDebugMsgEx::processOpWriteDirInode(std::istringstream& commandStream)
 {
@@ -25,6 +25,8 @@ class GenericDebugMsgEx : public GenericDebugMsg
       std::string processOpDumpInode(std::istringstream& commandStream);
       std::string processOpDumpInlinedInode(std::istringstream& commandStream);
       std::string processOpQuotaExceeded(std::istringstream& commandStream);
+      std::string processOpChunkRebalanceStats(std::istringstream& commandStream);
+      std::string processOpTargetLoads(std::istringstream& commandStream);
 
    #ifdef BEEGFS_DEBUG
       std::string processOpWriteDirDentry(std::istringstream& commandStream);
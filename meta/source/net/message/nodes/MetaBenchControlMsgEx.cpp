@@ -0,0 +1,54 @@
+#include <app/App.h>
+#include <common/net/message/nodes/MetaBenchControlMsgResp.h>
+#include <components/benchmarker/MetaBench.h>
+#include <program/Program.h>
+#include "MetaBenchControlMsgEx.h"
+
+bool MetaBenchControlMsgEx::processIncoming(ResponseContext& ctx)
+{
+   const char* logContext = "MetaBenchControlMsg incoming";
+
+   MetaBenchResultVec results;
+   int cmdErrorCode = STORAGEBENCH_ERROR_NO_ERROR;
+
+   MetaBench* metaBench = Program::getApp()->getMetaBench();
+
+   switch(getAction())
+   {
+      case StorageBenchAction_START:
+      {
+         cmdErrorCode = metaBench->initAndStartMetaBench(getNumThreads(), getNumFiles(),
+            getSharedDir() );
+      } break;
+
+      case StorageBenchAction_STOP:
+      {
+         cmdErrorCode = metaBench->stopBenchmark();
+      } break;
+
+      case StorageBenchAction_STATUS:
+      {
+         metaBench->getStatusWithResults(&results);
+      } break;
+
+      case StorageBenchAction_CLEANUP:
+      {
+         cmdErrorCode = metaBench->cleanup();
+      } break;
+
+      default:
+      {
+         LogContext(logContext).logErr("unknown action!");
+      } break;
+   }
+
+   // like for the storage benchmark: the error of the command if it failed, otherwise the error
+   // of the last or current run
+   const int errorCode = (cmdErrorCode != STORAGEBENCH_ERROR_NO_ERROR) ?
+      cmdErrorCode : metaBench->getLastRunErrorCode();
+
+   ctx.sendResponse(MetaBenchControlMsgResp(metaBench->getStatus(), getAction(), errorCode,
+      results) );
+
+   return true;
+}
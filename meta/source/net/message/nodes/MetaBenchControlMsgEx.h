@@ -0,0 +1,11 @@
+#pragma once
+
+#include <common/net/message/nodes/MetaBenchControlMsg.h>
+#include <common/Common.h>
+
+class MetaBenchControlMsgEx: public MetaBenchControlMsg
+{
+   public:
+      virtual bool processIncoming(ResponseContext& ctx);
+};
+
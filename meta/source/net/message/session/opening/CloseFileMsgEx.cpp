@@ -5,6 +5,7 @@
 #include <common/toolkit/SessionTk.h>
 #include <components/FileEventLogger.h>
 #include <net/msghelpers/MsgHelperClose.h>
+#include <net/msghelpers/MsgHelperInlineData.h>
 #include <net/msghelpers/MsgHelperLocking.h>
 #include <program/Program.h>
 #include <session/EntryLock.h>
@@ -142,6 +143,10 @@ std::unique_ptr<CloseFileMsgEx::ResponseState> CloseFileMsgEx::closeFilePrimary(
          logEvent(Program::getApp()->getFileEventLogger(), *getFileEvent(), eventCtx);
    }
 
+   // small files get a copy of their contents on the meta server once the last writer is done
+   if( (closeRes == FhgfsOpsErr_SUCCESS) && outLastWriterClosed && !unlinkDisposalFile)
+      MsgHelperInlineData::enqueueCapture(*entryInfo);
+
    // unlink if file marked as disposable
    if( (closeRes == FhgfsOpsErr_SUCCESS) && unlinkDisposalFile)
    { // check whether file has been unlinked (and perform the unlink operation on last close)
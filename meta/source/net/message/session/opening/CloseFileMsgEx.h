@@ -1,13 +1,14 @@
 #pragma once
 
 #include <common/storage/StorageErrors.h>
+#include <common/components/worker/ObjectPool.h>
 #include <common/net/message/session/opening/CloseFileMsg.h>
 #include <common/net/message/session/opening/CloseFileRespMsg.h>
 #include <net/message/MirroredMessage.h>
 #include <session/EntryLock.h>
 #include <storage/FileInode.h>
 
-class CloseFileMsgEx : public MirroredMessage<CloseFileMsg, FileIDLock>
+class CloseFileMsgEx : public MirroredMessage<CloseFileMsg, FileIDLock>, public PooledObject
 {
    public:
       typedef ErrorCodeResponseState<CloseFileRespMsg, NETMSGTYPE_CloseFile> ResponseState;
@@ -3,6 +3,7 @@
 #include <common/toolkit/SessionTk.h>
 #include <common/storage/striping/Raid0Pattern.h>
 #include <components/FileEventLogger.h>
+#include <net/msghelpers/MsgHelperInlineData.h>
 #include <net/msghelpers/MsgHelperOpen.h>
 #include <program/Program.h>
 #include <session/EntryLock.h>
@@ -147,8 +148,17 @@ std::unique_ptr<MirroredMessageResponseState> OpenFileMsgEx::executeLocally(Resp
 
    sessionFile->getInode()->getPathInfo(&pathInfo);
 
-   return boost::make_unique<OpenFileResponseState>(openRes, fileHandleID, *pattern, pathInfo,
-         sessionFile->getInode()->getFileVersion());
+   auto responseState = boost::make_unique<OpenFileResponseState>(openRes, fileHandleID, *pattern,
+         pathInfo, sessionFile->getInode()->getFileVersion());
+
+   std::string inlineData;
+
+   if (!isSecondary &&
+         MsgHelperInlineData::getInlineData(entryInfo, *sessionFile->getInode(), getAccessFlags(),
+            getMaxInlineDataSize(), inlineData) )
+      responseState->setInlineData(std::move(inlineData));
+
+   return responseState;
 }
 
 void OpenFileMsgEx::forwardToSecondary(ResponseContext& ctx)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <common/storage/StorageErrors.h>
+#include <common/components/worker/ObjectPool.h>
 #include <common/net/message/session/opening/OpenFileMsg.h>
 #include <common/net/message/session/opening/OpenFileRespMsg.h>
 #include <storage/DirInode.h>
@@ -36,9 +37,24 @@ class OpenFileResponseState : public MirroredMessageResponseState
                      GenericRespMsgCode_INDIRECTCOMMERR,
                      "Communication with storage targets failed"));
          else
-            ctx.sendResponse(
-                  OpenFileRespMsg(
-                     result, fileHandleID, pattern.get(), &pathInfo, fileVersion));
+         {
+            OpenFileRespMsg respMsg(result, fileHandleID, pattern.get(), &pathInfo, fileVersion);
+
+            if (hasInlineData)
+               respMsg.setInlineData(std::move(inlineData));
+
+            ctx.sendResponse(respMsg);
+         }
+      }
+
+      /**
+       * Note: Not serialized, i.e. not sent to the secondary (inline data is never used for mirrored
+       * inodes).
+       */
+      void setInlineData(std::string data)
+      {
+         inlineData = std::move(data);
+         hasInlineData = true;
       }
 
       bool changesObservableState() const override
@@ -76,9 +92,12 @@ class OpenFileResponseState : public MirroredMessageResponseState
       std::unique_ptr<StripePattern> pattern;
       PathInfo pathInfo;
       uint32_t fileVersion;
+
+      bool hasInlineData = false;
+      std::string inlineData;
 };
 
-class OpenFileMsgEx : public MirroredMessage<OpenFileMsg, FileIDLock>
+class OpenFileMsgEx : public MirroredMessage<OpenFileMsg, FileIDLock>, public PooledObject
 {
    public:
       typedef OpenFileResponseState ResponseState;
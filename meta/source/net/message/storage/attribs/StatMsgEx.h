@@ -1,5 +1,6 @@
 #pragma once
 
+#include <common/components/worker/ObjectPool.h>
 #include <storage/DirInode.h>
 #include <common/storage/StorageErrors.h>
 #include <common/net/message/storage/attribs/StatMsg.h>
@@ -92,7 +93,7 @@ class StatMsgResponseState : public MirroredMessageResponseState
       bool hasParentInfo;
 };
 
-class StatMsgEx: public MirroredMessage<StatMsg, FileIDLock>
+class StatMsgEx: public MirroredMessage<StatMsg, FileIDLock>, public PooledObject
 {
    public:
       typedef StatMsgResponseState ResponseState;
@@ -48,10 +48,10 @@ class StartChunkBalanceMsgEx : public MirroredMessage<StartChunkBalanceMsg, File
       FileIDLock lock(EntryLockStore& store) override;
       bool isMirrored() override { return getEntryInfo()->getIsBuddyMirrored(); }
 
+      static ChunkBalancerJob* addChunkBalanceJob();
 
-   private: 
-      ChunkBalancerJob* addChunkBalanceJob();
 
+   private: 
       void forwardToSecondary(ResponseContext& ctx) override {}; 
       FhgfsOpsErr processSecondaryResponse(NetMessage& resp) override
       {
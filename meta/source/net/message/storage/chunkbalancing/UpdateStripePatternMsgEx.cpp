@@ -134,6 +134,7 @@ std::unique_ptr<MirroredMessageResponseState>  UpdateStripePatternMsgEx::execute
       + std::to_string(destinationID));
 
       inodeLockStore->releaseFileInode(entryID); //release access to the file inode on primary without updating stripe pattern
+      notifyChunkRebalancer(entryID, targetID, false);
       stripePatternMsgRes = storageResyncRes; //set the error result from resync operation and notify storage
       return boost::make_unique<ResponseState>(stripePatternMsgRes);
    }
@@ -144,6 +145,7 @@ std::unique_ptr<MirroredMessageResponseState>  UpdateStripePatternMsgEx::execute
       if (!shouldUpdateStripePattern)
       {
          inodeLockStore->releaseFileInode(entryID); //release access to the file inode on primary without updating stripe pattern
+         notifyChunkRebalancer(entryID, targetID, false);
          stripePatternMsgRes = storageResyncRes; //set the error result from resync operation and notify storage
          return boost::make_unique<ResponseState>(stripePatternMsgRes);
       }
@@ -173,6 +175,7 @@ std::unique_ptr<MirroredMessageResponseState>  UpdateStripePatternMsgEx::execute
       logEvent(eventLogger , *fileEvent, eventCtx); //notify event listener of stripe pattern change on primary
    }
    inodeLockStore->releaseFileInode(entryID); //release access to the file inode on primary
+   notifyChunkRebalancer(entryID, targetID, stripePatternMsgRes == FhgfsOpsErr_SUCCESS);
 
    
    LOG_DEBUG(logContext, Log_SPAM,  "Successfully changed stripe pattern of chunk at chunkPath: " + relativePath + "; entryID: "
@@ -210,6 +213,18 @@ bool UpdateStripePatternMsgEx::setStripePattern(EntryInfo* entryInfo, FileInode&
    return setPatternRes;
 }
 
+/**
+ * Lets the automatic chunk rebalancer account for moves it has queued.
+ */
+void UpdateStripePatternMsgEx::notifyChunkRebalancer(const std::string& entryID,
+   uint16_t targetID, bool success)
+{
+   ChunkRebalancer* rebalancer = Program::getApp()->getChunkRebalancer();
+
+   if (rebalancer)
+      rebalancer->chunkMoveFinished(entryID, targetID, success);
+}
+
 void UpdateStripePatternMsgEx::forwardToSecondary(ResponseContext& ctx)
 {
    sendToSecondary(ctx, *this, NETMSGTYPE_UpdateStripePatternResp);
@@ -22,6 +22,7 @@ class  UpdateStripePatternMsgEx : public MirroredMessage<UpdateStripePatternMsg,
    private: 
       bool setStripePattern(EntryInfo* entryInfo, FileInode& inode, std::string& relativePath, uint16_t localTargetID, uint16_t destinationID);
       bool checkChunkOnStorageTarget(FileInode& inode, std::string& relativePath, uint16_t targetID);
+      void notifyChunkRebalancer(const std::string& entryID, uint16_t targetID, bool success);
       void forwardToSecondary(ResponseContext& ctx) override;
       FhgfsOpsErr processSecondaryResponse(NetMessage& resp) override
       {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <common/net/message/storage/lookup/LookupIntentMsg.h>
+#include <common/components/worker/ObjectPool.h>
 #include <common/net/message/storage/lookup/LookupIntentRespMsg.h>
 #include <common/nodes/OpCounterTypes.h>
 #include <common/storage/StorageDefinitions.h>
@@ -164,7 +165,7 @@ class LookupIntentResponseState : public MirroredMessageResponseState
  * Note: The intent options currently work only for files.
  */
 class LookupIntentMsgEx : public MirroredMessage<LookupIntentMsg,
-   std::tuple<FileIDLock, ParentNameLock, FileIDLock>>
+   std::tuple<FileIDLock, ParentNameLock, FileIDLock>>, public PooledObject
 {
    public:
       typedef LookupIntentResponseState ResponseState;
@@ -0,0 +1,217 @@
+#include <common/components/worker/ReadLocalFileV2Work.h>
+#include <common/net/message/session/opening/CloseChunkFileMsg.h>
+#include <common/net/message/session/opening/CloseChunkFileRespMsg.h>
+#include <common/toolkit/MessagingTk.h>
+#include <common/toolkit/SessionTk.h>
+#include <common/toolkit/SynchronizedCounter.h>
+#include <program/Program.h>
+#include <storage/MetaStore.h>
+#include "MsgHelperInlineData.h"
+
+// owner FD for the handle IDs that this node uses to read chunk files; client handles use session
+// file IDs, which are counted up from 1
+#define INLINEDATA_OWNER_FD   (~0u)
+
+Mutex MsgHelperInlineData::pendingCapturesMutex;
+StringSet MsgHelperInlineData::pendingCaptures;
+
+/**
+ * Take a copy of the contents of a file that was just closed by its last writer in the background,
+ * so that the storage round trips stay off the close path.
+ */
+void MsgHelperInlineData::enqueueCapture(const EntryInfo& entryInfo)
+{
+   App* app = Program::getApp();
+   Config* cfg = app->getConfig();
+
+   // mirrored inodes are excluded because the copy is not forwarded to the secondary
+   if (!cfg->getTuneInlineFileDataMaxSize() || !cfg->getStoreUseExtendedAttribs() ||
+         entryInfo.getIsBuddyMirrored() )
+      return;
+
+   {
+      const std::lock_guard<Mutex> lock(pendingCapturesMutex);
+
+      // (a capture that is already queued reads the latest contents anyways)
+      if (pendingCaptures.size() >= MAX_PENDING_CAPTURES ||
+            !pendingCaptures.insert(entryInfo.getEntryID() ).second)
+         return;
+   }
+
+   app->getTimerQueue()->enqueue(std::chrono::milliseconds(0), [info = entryInfo] () mutable {
+      captureInlineData(info);
+
+      const std::lock_guard<Mutex> lock(pendingCapturesMutex);
+      pendingCaptures.erase(info.getEntryID() );
+   });
+}
+
+/**
+ * Take a copy of the contents of a file if it is small enough.
+ *
+ * Note: Runs without the FileIDLock of the entry, so writers may open the file while the chunk is
+ * read. FileInode::setInlineData() rejects the copy in that case.
+ */
+void MsgHelperInlineData::captureInlineData(EntryInfo& entryInfo)
+{
+   App* app = Program::getApp();
+   MetaStore* metaStore = app->getMetaStore();
+
+   const unsigned maxSize = app->getConfig()->getTuneInlineFileDataMaxSize();
+
+   auto [inode, referenceRes] = metaStore->referenceFile(&entryInfo);
+   if (!inode)
+      return; // e.g. unlinked or renamed in the meantime
+
+   const InlineDataCapture capture = inode->startInlineDataCapture();
+
+   if (!isInlinable(*inode->getStripePattern(), capture.fileSize, maxSize,
+         inode->getIsRstAvailable() ) )
+      inode->dropInlineData(&entryInfo);
+   else if (inode->isInlineDataCaptureCurrent(capture) )
+   { // no writers => read the data
+      std::string data;
+
+      if (readChunkData(*inode, &entryInfo, capture.fileSize, data) == FhgfsOpsErr_SUCCESS)
+      {
+         const FhgfsOpsErr setRes = inode->setInlineData(&entryInfo, data, capture);
+
+         if (setRes != FhgfsOpsErr_SUCCESS)
+            LOG(GENERAL, DEBUG, "Inline data not stored.", ("entryID", entryInfo.getEntryID()),
+                  ("result", setRes));
+      }
+   }
+
+   metaStore->releaseFile(entryInfo.getParentEntryID(), inode);
+}
+
+/**
+ * Drop the copy of the file contents before the chunk files are modified.
+ *
+ * Without the feature, there are no captures in progress that would have to be invalidated. Copies
+ * that are left from a time when it was enabled are still dropped, because they would be handed
+ * out again once it is enabled again.
+ */
+void MsgHelperInlineData::dropInlineData(EntryInfo* entryInfo, FileInode& inode)
+{
+   if (!Program::getApp()->getConfig()->getTuneInlineFileDataMaxSize() &&
+         !inode.getHasInlineData() )
+      return;
+
+   inode.dropInlineData(entryInfo);
+}
+
+/**
+ * Get the copy of the file contents for a client that opened the file with the given access flags.
+ *
+ * @param accessFlags OPENFILE_ACCESS_... flags
+ * @param maxSize max size that the client accepts, 0 if it does not accept inline data at all
+ * @return false if the file contents have to be read from the storage targets.
+ */
+bool MsgHelperInlineData::getInlineData(EntryInfo* entryInfo, FileInode& inode,
+   unsigned accessFlags, unsigned maxSize, std::string& outData)
+{
+   if (!maxSize || !Program::getApp()->getConfig()->getTuneInlineFileDataMaxSize() )
+      return false;
+
+   if ( (accessFlags & OPENFILE_ACCESS_MASK_RW) != OPENFILE_ACCESS_READ)
+      return false;
+
+   if (!inode.getHasInlineData() || !inode.getInlineData(entryInfo, outData) )
+      return false;
+
+   StatData statData;
+
+   inode.getStatData(statData);
+
+   return isCopyUsable(outData, statData.getFileSize(), maxSize);
+}
+
+/**
+ * @return true if all data of a file of the given size is in its first chunk file and small enough
+ *    to be copied to the metadata server.
+ */
+bool MsgHelperInlineData::isInlinable(StripePattern& pattern, int64_t fileSize, unsigned maxSize,
+   bool isRstAvailable)
+{
+   return pattern.getPatternType() == StripePatternType_Raid0
+      && !pattern.getStripeTargetIDs()->empty()
+      && fileSize >= 0
+      && fileSize <= maxSize
+      && fileSize <= pattern.getChunkSize()
+      && !isRstAvailable;
+}
+
+/**
+ * @param maxSize max size that the client accepts
+ * @return false if the copy does not have the current size of the file (e.g. because it was
+ *    truncated without dropping the copy), so the data has to be read from the storage targets.
+ */
+bool MsgHelperInlineData::isCopyUsable(const std::string& data, int64_t fileSize,
+   unsigned maxSize)
+{
+   return data.size() <= maxSize && fileSize == (int64_t) data.size();
+}
+
+/**
+ * Read the first chunk of a file through a storage session of this meta server.
+ *
+ * @param fileSize number of bytes to read; parts that are not in the chunk file (e.g. holes) are
+ * returned as zeros
+ */
+FhgfsOpsErr MsgHelperInlineData::readChunkData(FileInode& inode, EntryInfo* entryInfo,
+   int64_t fileSize, std::string& outData)
+{
+   App* app = Program::getApp();
+
+   outData.assign(fileSize, '\0');
+
+   if (!fileSize)
+      return FhgfsOpsErr_SUCCESS;
+
+   const uint16_t targetID = inode.getStripePattern()->getStripeTargetIDs()->front();
+   const std::string fileHandleID = SessionTk::generateFileHandleID(INLINEDATA_OWNER_FD,
+      entryInfo->getEntryID() );
+   PathInfo pathInfo;
+
+   inode.getPathInfo(&pathInfo);
+
+   SynchronizedCounter counter;
+   ReadLocalFileWorkInfo readInfo(app->getLocalNodeNumID(), app->getTargetMapper(),
+      app->getStorageNodes(), &counter);
+   int64_t readRes;
+   std::vector<char> msgBuf(4096);
+
+   ReadLocalFileV2Work readWork(fileHandleID.c_str(), &outData[0], OPENFILE_ACCESS_READ, 0,
+      fileSize, targetID, &pathInfo, &readRes, &readInfo, false);
+
+   readWork.process(NULL, 0, msgBuf.data(), msgBuf.size() );
+
+   // the read opened the chunk file in a storage session of this node => close it again
+   CloseChunkFileMsg closeMsg(app->getLocalNodeNumID(), fileHandleID, targetID, &pathInfo);
+   RequestResponseArgs rrArgs(NULL, &closeMsg, NETMSGTYPE_CloseChunkFileResp);
+   RequestResponseTarget rrTarget(targetID, app->getTargetMapper(), app->getStorageNodes() );
+
+   rrTarget.setTargetStates(app->getTargetStateStore() );
+
+   FhgfsOpsErr closeRes = MessagingTk::requestResponseTarget(&rrTarget, &rrArgs);
+   if (closeRes == FhgfsOpsErr_SUCCESS)
+      closeRes = ( (CloseChunkFileRespMsg*)rrArgs.outRespMsg.get() )->getResult();
+
+   if (readRes < 0)
+   {
+      LOG(GENERAL, DEBUG, "Unable to read chunk file for inline data.",
+            ("entryID", entryInfo->getEntryID()), targetID,
+            ("error", (FhgfsOpsErr) -readRes));
+      return (FhgfsOpsErr) -readRes;
+   }
+
+   if (closeRes != FhgfsOpsErr_SUCCESS)
+   {
+      LOG(GENERAL, DEBUG, "Unable to close chunk file after reading inline data.",
+            ("entryID", entryInfo->getEntryID()), targetID, ("error", closeRes));
+      return closeRes;
+   }
+
+   return FhgfsOpsErr_SUCCESS;
+}
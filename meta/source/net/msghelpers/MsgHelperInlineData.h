@@ -0,0 +1,38 @@
+#pragma once
+
+#include <common/Common.h>
+#include <common/threading/Mutex.h>
+#include <storage/MetaStore.h>
+
+/**
+ * Copies of the contents of small files on the metadata server (see tuneInlineFileDataMaxSize).
+ *
+ * The copy is taken in the background after the last writer closed a file and handed out to
+ * clients that open the file read-only, so they do not need to contact the storage servers at all.
+ * The chunk files stay authoritative; everything that modifies them drops the copy first.
+ */
+class MsgHelperInlineData
+{
+   public:
+      static void enqueueCapture(const EntryInfo& entryInfo);
+      static void dropInlineData(EntryInfo* entryInfo, FileInode& inode);
+      static bool getInlineData(EntryInfo* entryInfo, FileInode& inode, unsigned accessFlags,
+         unsigned maxSize, std::string& outData);
+
+      static bool isInlinable(StripePattern& pattern, int64_t fileSize, unsigned maxSize,
+         bool isRstAvailable);
+      static bool isCopyUsable(const std::string& data, int64_t fileSize, unsigned maxSize);
+
+   private:
+      MsgHelperInlineData() {}
+
+      // max number of captures waiting for the timer queue, further closes don't get a copy
+      static const size_t MAX_PENDING_CAPTURES = 1024;
+
+      static Mutex pendingCapturesMutex;
+      static StringSet pendingCaptures; // entryIDs of queued captures
+
+      static void captureInlineData(EntryInfo& entryInfo);
+      static FhgfsOpsErr readChunkData(FileInode& inode, EntryInfo* entryInfo, int64_t fileSize,
+         std::string& outData);
+};
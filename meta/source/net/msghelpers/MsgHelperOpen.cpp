@@ -2,6 +2,7 @@
 #include <common/toolkit/MessagingTk.h>
 #include <common/toolkit/SessionTk.h>
 #include <common/storage/striping/Raid0Pattern.h>
+#include <net/msghelpers/MsgHelperInlineData.h>
 #include <net/msghelpers/MsgHelperTrunc.h>
 #include <program/Program.h>
 #include <storage/MetaStore.h>
@@ -52,6 +53,10 @@ FhgfsOpsErr MsgHelperOpen::openFile(EntryInfo* entryInfo, unsigned accessFlags,
       return FhgfsOpsErr_INTERNAL;
    }
 
+   // the chunk files might be modified from now on => the copy of the contents becomes invalid
+   if(accessFlags & (OPENFILE_ACCESS_WRITE | OPENFILE_ACCESS_READWRITE) )
+      MsgHelperInlineData::dropInlineData(entryInfo, *outFileInode);
+
    if(truncLocalRequired && !isSecondary)
    { // trunc was specified and is needed => do it
       LOG_DEBUG(logContext, Log_DEBUG, std::string("Opening with trunc local") );
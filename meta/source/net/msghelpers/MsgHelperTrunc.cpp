@@ -1,6 +1,7 @@
 #include <common/net/message/storage/TruncLocalFileMsg.h>
 #include <common/net/message/storage/TruncLocalFileRespMsg.h>
 #include <components/worker/TruncChunkFileWork.h>
+#include <net/msghelpers/MsgHelperInlineData.h>
 #include <program/Program.h>
 #include "MsgHelperTrunc.h"
 
@@ -43,6 +44,8 @@ FhgfsOpsErr MsgHelperTrunc::truncChunkFile(FileInode& inode, EntryInfo* entryInf
 {
    StripePattern* pattern = inode.getStripePattern();
 
+   MsgHelperInlineData::dropInlineData(entryInfo, inode);
+
    if( (pattern->getStripeTargetIDs()->size() > 1) ||
        (pattern->getPatternType() == StripePatternType_BuddyMirror) )
       return truncChunkFileParallel(inode, entryInfo, filesize, useQuota, userIDHint, dynAttribs);
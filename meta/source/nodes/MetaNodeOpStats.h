@@ -1,7 +1,6 @@
 #pragma once
 
 #include <common/nodes/OpCounter.h>
-#include <common/threading/SafeRWLock.h>
 #include <common/nodes/Node.h>
 #include <common/nodes/NodeOpStats.h>
 
@@ -11,6 +10,7 @@
 class MetaNodeOpStats : public NodeOpStats
 {
    public:
+      MetaNodeOpStats() : NodeOpStats(MetaOpCounter_OpCounterLastEnum) {}
 
       /**
        * Update operation counter for the given nodeIP and userID.
@@ -20,37 +20,10 @@ class MetaNodeOpStats : public NodeOpStats
        */
       void updateNodeOp(const IPAddress& nodeIP, MetaOpCounterTypes opType, unsigned userID)
       {
-         SafeRWLock safeLock(&lock, SafeRWLock_READ);
+         Shard* shard = getThreadShard();
 
-         uint128_t cookieIP = nodeIP.toUint128();
-         NodeOpCounterMapIter nodeIter = clientCounterMap.find(cookieIP);
-         NodeOpCounterMapIter userIter = userCounterMap.find(userID);
-
-         if( (nodeIter == clientCounterMap.end() ) ||
-             (userIter == userCounterMap.end() ) )
-         { // nodeIP or userID NOT found in map yet, we need a write lock
-
-            safeLock.unlock(); // possible race, but insert below is a NOOP if key already exists
-            safeLock.lock(SafeRWLock_WRITE);
-
-            if(nodeIter == clientCounterMap.end() )
-            {
-               nodeIter = clientCounterMap.insert(
-                  NodeOpCounterMapVal(cookieIP, MetaOpCounter() ) ).first;
-            }
-
-            if(userIter == userCounterMap.end() )
-            {
-               userIter = userCounterMap.insert(
-                  NodeOpCounterMapVal(userID, MetaOpCounter() ) ).first;
-            }
-         }
-
-         nodeIter->second.increaseOpCounter(opType);
-         userIter->second.increaseOpCounter(opType);
-
-         safeLock.unlock();
+         shard->getClientCounter(nodeIP.toUint128() ).increaseOpCounter(opType);
+         shard->getUserCounter(userID).increaseOpCounter(opType);
       }
 };
 
-
@@ -0,0 +1,165 @@
+#include <common/nodes/TargetMapper.h>
+#include "TargetLoadStore.h"
+
+#include <mutex>
+#include <set>
+#include <sstream>
+
+
+#define TARGETLOADSTORE_SMOOTHING   0.3 // weight of a new sample in the moving averages
+
+
+uint64_t TargetLoadStore::getLastStatsTimeMS(NumNodeID nodeID)
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   auto iter = nodeLoads.find(nodeID);
+
+   return (iter == nodeLoads.end() ) ? 0 : iter->second.lastStatsTimeMS;
+}
+
+/**
+ * @param statsList the high resolution stats of the node since getLastStatsTimeMS()
+ * @param currentQueuedRequests number of queued requests of the node right now, used if there are
+ *    no new stats
+ */
+void TargetLoadStore::updateNodeLoad(NumNodeID nodeID, const HighResStatsList& statsList,
+   unsigned currentQueuedRequests)
+{
+   double queuedRequests = currentQueuedRequests;
+   double diskBytesPerSec = -1; // unknown
+   uint64_t lastTimeMS = 0;
+
+   if(!statsList.empty() )
+   {
+      uint64_t queuedRequestsSum = 0;
+      uint64_t diskBytes = 0;
+      uint64_t firstTimeMS = statsList.front().rawVals.statsTimeMS;
+
+      for(auto iter = statsList.begin(); iter != statsList.end(); iter++)
+      {
+         queuedRequestsSum += iter->rawVals.queuedRequests;
+         diskBytes += iter->incVals.diskReadBytes + iter->incVals.diskWriteBytes;
+         firstTimeMS = std::min(firstTimeMS, iter->rawVals.statsTimeMS);
+         lastTimeMS = std::max(lastTimeMS, iter->rawVals.statsTimeMS);
+      }
+
+      // each entry covers one stats collector interval (one second on storage servers)
+      const double spanSecs = (lastTimeMS - firstTimeMS) / 1000.0 + 1;
+
+      queuedRequests = double(queuedRequestsSum) / statsList.size();
+      diskBytesPerSec = diskBytes / spanSecs;
+   }
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   auto iter = nodeLoads.find(nodeID);
+   if(iter == nodeLoads.end() )
+   {
+      NodeLoad load = { queuedRequests, std::max(diskBytesPerSec, 0.0), lastTimeMS, 1, Time() };
+      nodeLoads.insert(std::make_pair(nodeID, load) );
+      return;
+   }
+
+   NodeLoad& load = iter->second;
+
+   load.lastUpdateT.setToNow();
+   load.queuedRequests += TARGETLOADSTORE_SMOOTHING * (queuedRequests - load.queuedRequests);
+
+   if(diskBytesPerSec >= 0)
+   {
+      load.diskBytesPerSec += TARGETLOADSTORE_SMOOTHING * (diskBytesPerSec - load.diskBytesPerSec);
+      load.lastStatsTimeMS = lastTimeMS;
+   }
+}
+
+void TargetLoadStore::removeNode(NumNodeID nodeID)
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   nodeLoads.erase(nodeID);
+}
+
+/**
+ * Recalculate the target weights from the current node loads. Targets of nodes without known load
+ * or with an expired load don't get a weight (i.e. the chooser treats them as average).
+ */
+void TargetLoadStore::updateTargetWeights(TargetMapper* targetMapper)
+{
+   const TargetMap targets = targetMapper->getMapping();
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   // forget nodes which don't have any targets anymore or were not updated for too long
+   std::set<NumNodeID> mappedNodes;
+
+   for(auto iter = targets.begin(); iter != targets.end(); iter++)
+      mappedNodes.insert(iter->second);
+
+   for(auto iter = nodeLoads.begin(); iter != nodeLoads.end(); )
+   {
+      if(mappedNodes.count(iter->first) && iter->second.lastUpdateT.elapsedMS() <= maxLoadAgeMS)
+         iter++;
+      else
+         iter = nodeLoads.erase(iter);
+   }
+
+   double queuedRequestsSum = 0;
+   double diskBytesPerSecSum = 0;
+
+   for(auto iter = nodeLoads.begin(); iter != nodeLoads.end(); iter++)
+   {
+      queuedRequestsSum += iter->second.queuedRequests;
+      diskBytesPerSecSum += iter->second.diskBytesPerSec;
+   }
+
+   const double numNodes = nodeLoads.size();
+   const double meanQueuedRequests = numNodes ? (queuedRequestsSum / numNodes) : 0;
+   const double meanDiskBytesPerSec = numNodes ? (diskBytesPerSecSum / numNodes) : 0;
+
+   for(auto iter = nodeLoads.begin(); iter != nodeLoads.end(); iter++)
+   {
+      NodeLoad& load = iter->second;
+
+      // if all nodes are idle, there's nothing to balance
+      const double queueLoad = (meanQueuedRequests > 0)
+         ? load.queuedRequests / meanQueuedRequests
+         : 1;
+      const double diskLoad = (meanDiskBytesPerSec > 0)
+         ? load.diskBytesPerSec / meanDiskBytesPerSec
+         : 1;
+
+      const double nodeLoad = (queueLoad + diskLoad) / 2;
+
+      load.weight = 1 / ( (1 + nodeLoad) * (1 + nodeLoad) );
+   }
+
+   auto newWeights = std::make_shared<TargetWeightMap>();
+
+   for(auto iter = targets.begin(); iter != targets.end(); iter++)
+   {
+      auto loadIter = nodeLoads.find(iter->second);
+
+      if(loadIter != nodeLoads.end() )
+         (*newWeights)[iter->first] = loadIter->second.weight;
+   }
+
+   targetWeights = std::move(newWeights);
+}
+
+std::string TargetLoadStore::getStateAsStr()
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   std::ostringstream stateStream;
+
+   stateStream << "node: queued requests, disk bytes/s, weight" << std::endl;
+
+   for(auto iter = nodeLoads.begin(); iter != nodeLoads.end(); iter++)
+   {
+      stateStream << iter->first.str() << ": " << iter->second.queuedRequests << ", "
+         << uint64_t(iter->second.diskBytesPerSec) << ", " << iter->second.weight << std::endl;
+   }
+
+   return stateStream.str();
+}
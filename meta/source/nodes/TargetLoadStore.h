@@ -0,0 +1,69 @@
+#pragma once
+
+#include <common/nodes/NumNodeID.h>
+#include <common/nodes/TargetCapacityPools.h>
+#include <common/threading/Mutex.h>
+#include <common/toolkit/HighResolutionStats.h>
+#include <common/toolkit/Time.h>
+#include <common/Common.h>
+
+#include <memory>
+
+class TargetMapper;
+
+/**
+ * Recent load of the storage nodes, used by the loadaware target chooser to prefer targets of
+ * less busy nodes for new files.
+ *
+ * The load of a node consists of its queued requests and its disk throughput from the high
+ * resolution stats, each smoothed with an exponential moving average and normalized to the mean of
+ * all nodes. A target gets the weight 1 / (1 + load)^2 of its node, so an idle node gets four times
+ * as many new stripes as a node with average load. (Load is only known per node, so all targets of
+ * a node get the same weight.)
+ *
+ * The load of a node that was not updated for maxLoadAgeMS (e.g. because it is offline) is
+ * forgotten, so its targets are treated as average again.
+ */
+class TargetLoadStore
+{
+   public:
+      enum
+      {
+         DEFAULT_MAX_LOAD_AGE_MS = 60*1000,
+      };
+
+      explicit TargetLoadStore(unsigned maxLoadAgeMS = DEFAULT_MAX_LOAD_AGE_MS) :
+         maxLoadAgeMS(maxLoadAgeMS), targetWeights(std::make_shared<TargetWeightMap>() ) {}
+
+      uint64_t getLastStatsTimeMS(NumNodeID nodeID);
+      void updateNodeLoad(NumNodeID nodeID, const HighResStatsList& statsList,
+         unsigned currentQueuedRequests);
+      void removeNode(NumNodeID nodeID);
+      void updateTargetWeights(TargetMapper* targetMapper);
+
+      std::string getStateAsStr();
+
+   private:
+      struct NodeLoad
+      {
+         double queuedRequests; // smoothed
+         double diskBytesPerSec; // smoothed
+         uint64_t lastStatsTimeMS; // time of the latest stats entry that was used
+         double weight; // set by updateTargetWeights()
+         Time lastUpdateT;
+      };
+
+      const unsigned maxLoadAgeMS;
+
+      Mutex mutex;
+      std::map<NumNodeID, NodeLoad> nodeLoads;
+      std::shared_ptr<const TargetWeightMap> targetWeights;
+
+   public:
+      std::shared_ptr<const TargetWeightMap> getTargetWeights()
+      {
+         const std::lock_guard<Mutex> lock(mutex);
+         return targetWeights;
+      }
+};
+
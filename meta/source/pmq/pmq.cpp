@@ -1,6 +1,9 @@
 #include "pmq_common.hpp"
 #include "pmq.hpp"
 
+#include <atomic>
+#include <chrono>
+
 static constexpr uint64_t PMQ_SLOT_SIZE = 128;
 static constexpr uint64_t PMQ_SLOT_HEADER_SIZE = 16;
 static constexpr uint64_t PMQ_SLOT_SPACE = PMQ_SLOT_SIZE - PMQ_SLOT_HEADER_SIZE;
@@ -9,6 +12,11 @@ static constexpr uint64_t PMQ_SLOT_SPACE = PMQ_SLOT_SIZE - PMQ_SLOT_HEADER_SIZE;
 // first slot of a sequence of slots that hold a message.
 static constexpr uint64_t PMQ_SLOT_LEADER_MASK = 1;
 
+// Set in addition to the leader bit if the slots hold no message but fill the
+// range of an abandoned reservation (see pmq_fill_hole()). Such a range gets
+// skipped by the persister and readers and takes no MSN.
+static constexpr uint64_t PMQ_SLOT_PADDING_MASK = 2;
+
 static constexpr uint64_t PMQ_CHUNK_SHIFT = 16;
 static constexpr uint64_t PMQ_CHUNK_SIZE = (uint64_t) 1 << PMQ_CHUNK_SHIFT;
 
@@ -50,7 +58,7 @@ struct PMQ_Slot
  * It consists of a ringbuffer of fixed-size slots.
  * A slot has a header and a payload. The size of each slot is PMQ_SLOT_SIZE,
  * and the payload can be up to up to PMQ_SLOT_SPACE bytes.
- * In the future, we might support even concurrent writes.
+ * Slots are written concurrently by enqueuer threads, see struct Enqueuer.
  * This structure needs no locking; its contents are static except when
  * initialization and destroying.
  * Accessing the cursors though needs a mutex lock.
@@ -269,11 +277,72 @@ struct Commit_Record
 };
 
 
-// Data owned by the enqueuer functionality. There can only be 1 enqueuer
-// thread at a time.
+// Data owned by the enqueuer functionality. Any number of enqueuer threads
+// may run at the same time:
+//
+// 1) A producer reserves the slots for its message by advancing reserve_ssn
+//    with an atomic fetch-add.
+// 2) If the reserved range reaches beyond limit_ssn, room has to be made
+//    first. This is the only part that takes enqueue_mutex (and possibly the
+//    persister context).
+// 3) The payload is copied to the reserved slots, in parallel with other
+//    producers.
+// 4) The producer waits until commit_ssn reaches the start of its range (all
+//    earlier reservations are committed) and then commits its message by
+//    advancing commit_msn and commit_ssn. This is the commit mark the
+//    persister and readers wait for: everything before commit_ssn is
+//    completely written.
+//
+// A producer only ever waits for producers that reserved before it, so there
+// can be no deadlock as long as no message needs more slots than the In_Queue
+// has. It spins for a short while and then sleeps on commit_cond, and gives
+// up after PMQ_COMMIT_WAIT_TIMEOUT: earlier producers only block while making
+// room, so a longer wait means that one of them is stuck.
+//
+// If a producer fails to make room while later producers already reserved
+// slots behind it, it can't roll back its reservation. It registers the range
+// as a hole instead, and the next producer that waits at the commit mark fills
+// the hole with a padding record and commits it.
+//
+// The SSN/MSN values are stored as plain integers since SN does not work with
+// std::atomic.
 struct Enqueuer
 {
-   PMQ_Enqueuer_Stats enqueuer_stats;
+   std::atomic<uint64_t> reserve_ssn {0};
+   std::atomic<uint64_t> commit_ssn {0};
+   std::atomic<uint64_t> commit_msn {0};
+
+   // ssn_disk + slot count: slots before this SSN may be written without
+   // making room first. Only changes together with in_queue_cursors.ssn_disk,
+   // i.e. with enqueue_mutex held.
+   std::atomic<uint64_t> limit_ssn {0};
+
+   // Abandoned reservations that were not filled yet. Protected by
+   // hole_mutex; num_holes lets waiters check for holes without the lock.
+   // There can be at most one hole per concurrent producer.
+   static constexpr unsigned max_holes = 64;
+   struct Hole
+   {
+      SSN start_ssn;
+      SSN end_ssn;
+   };
+   Hole holes[max_holes];
+   std::atomic<unsigned> num_holes {0};
+
+   // Producers that sleep until commit_ssn or num_holes change. Committers
+   // only take commit_mutex to wake them if commit_waiters is nonzero.
+   // commit_mutex is never held while taking other locks.
+   PMQ_PROFILED_MUTEX(commit_mutex);
+   PMQ_PROFILED_CONDVAR(commit_cond);
+   std::atomic<unsigned> commit_waiters {0};
+
+   std::atomic<uint64_t> buffer_full_count {0};
+   std::atomic<uint64_t> padded_reservations {0};
+   std::atomic<uint64_t> total_messages_enqueued {0};
+   std::atomic<uint64_t> total_bytes_enqueued {0};
+
+   // Only the msn_disk and ssn_disk members are maintained here, protected by
+   // enqueue_mutex. Use pmq_load_in_queue_cursors() to get a complete set.
    In_Queue_Cursors in_queue_cursors;
 };
 
@@ -303,8 +372,10 @@ struct PMQ
 
    Chunk_Store chunk_store;
 
-   // Cursors published by enqueuer threads, consumable by persister and reader
-   // threads.
+   // Cursors loaded from disk at startup. At runtime, enqueuer threads publish
+   // their progress through the commit cursors of struct Enqueuer. The mutex
+   // and condvar below are only used to wake up the persister when the
+   // In_Queue has filled up to slots_persist_watermark.
    In_Queue_Cursors pub_in_queue_cursors;
 
    PMQ_PROFILED_MUTEX(pub_in_queue_mutex);
@@ -316,10 +387,15 @@ struct PMQ
    Mutex_Protected<PMQ_Persister_Stats> pub_persister_stats;
 
 
-   // must be held to guarantee only 1 enqueuer at a time (protects only
-   // In_Queue currently).
+   // must be held to make room in the In_Queue and to update the disk cursors
+   // of the enqueuer. Readers hold it to keep slots from being overwritten.
+   // Not taken on the regular enqueue path.
    PMQ_PROFILED_MUTEX(enqueue_mutex);
 
+   // protects the holes of the enqueuer. Never held while waiting for other
+   // locks.
+   PMQ_PROFILED_MUTEX(hole_mutex);
+
    Enqueuer enqueuer;
 
 
@@ -332,20 +408,36 @@ struct PMQ
    Persister persister;
 
    Posix_FD statefile_fd;
+
+   // see pmq_set_persist_hook(). Protected by persist_mutex.
+   PMQ_Persist_Hook *persist_hook = nullptr;
+   void *persist_hook_ctx = nullptr;
 };
 
 void pmq_get_stats(PMQ *q, PMQ_Stats *out_stats)
 {
    PMQ_Stats stats = {};
    stats.persister = q->pub_persister_stats.load();
-   {
-      PMQ_PROFILED_LOCK(lock_, q->enqueue_mutex);
-      stats.enqueuer = q->enqueuer.enqueuer_stats;
-   }
+   stats.enqueuer.buffer_full_count =
+      q->enqueuer.buffer_full_count.load(std::memory_order_relaxed);
+   stats.enqueuer.total_messages_enqueued =
+      q->enqueuer.total_messages_enqueued.load(std::memory_order_relaxed);
+   stats.enqueuer.total_bytes_enqueued =
+      q->enqueuer.total_bytes_enqueued.load(std::memory_order_relaxed);
+   stats.enqueuer.padded_reservations =
+      q->enqueuer.padded_reservations.load(std::memory_order_relaxed);
 
    *out_stats = stats;
 }
 
+void pmq_set_persist_hook(PMQ *q, PMQ_Persist_Hook *hook, void *ctx)
+{
+   PMQ_PROFILED_LOCK(lock_, q->persist_mutex);
+
+   q->persist_hook = hook;
+   q->persist_hook_ctx = ctx;
+}
+
 PMQ_Persist_Info pmq_get_persist_info(PMQ *q)
 {
    Persist_Cursors persist_cursors = q->pub_persist_cursors.load();
@@ -358,6 +450,17 @@ PMQ_Persist_Info pmq_get_persist_info(PMQ *q)
 
 static bool pmq_persist_finished_chunk_buffers(PMQ *q);
 
+// Returns the current In_Queue cursors. msn and ssn_mem are the commit marks
+// of the enqueuers, the slots before ssn_mem are completely written.
+// enqueue_mutex must be locked (it protects msn_disk and ssn_disk).
+static In_Queue_Cursors pmq_load_in_queue_cursors(PMQ *q)
+{
+   In_Queue_Cursors ic = q->enqueuer.in_queue_cursors;
+   ic.msn = MSN(q->enqueuer.commit_msn.load(std::memory_order_acquire));
+   ic.ssn_mem = SSN(q->enqueuer.commit_ssn.load(std::memory_order_acquire));
+   return ic;
+}
+
 // Called only on initialization and then subsequently by pmq_switch_to_next_chunk_buffer()
 // Note: must be called from a persister context (with persist_mutex locked)
 static bool pmq_begin_current_chunk_buffer(PMQ *q)
@@ -498,6 +601,21 @@ static bool pmq_compact(PMQ *q, SSN compact_ssn, SSN max_ssn)
             return false;
          }
          msgsize = slot->msgsize;
+
+         if (slot->flags & PMQ_SLOT_PADDING_MASK)
+         {
+            uint64_t nslots = (msgsize + PMQ_SLOT_SPACE - 1) / PMQ_SLOT_SPACE;
+
+            if (nslots > max_ssn - ssn)
+            {
+               pmq_perr_f("Internal error: padding at slot %" PRIu64
+                     " exceeds the available slots", ssn.value());
+               return false;
+            }
+
+            cq->cq_ssn += nslots;
+            continue;
+         }
       }
 
       // check if there is enough room for the message in current chunk buffer.
@@ -728,7 +846,8 @@ static bool pmq_persist_unpersisted_slots(PMQ *q, SSN persist_ssn)
    for (SSN ssn = ssn_lo; ssn != ssn_hi; ssn ++)
    {
       PMQ_Slot *slot = q->in_queue.slots.get_slot_for(ssn);
-      if ((slot->flags & PMQ_SLOT_LEADER_MASK))
+      if ((slot->flags & (PMQ_SLOT_LEADER_MASK | PMQ_SLOT_PADDING_MASK))
+            == PMQ_SLOT_LEADER_MASK)
       {
          pc->wal_msn ++;
       }
@@ -821,6 +940,9 @@ bool __pmq_profiled pmq_commit(PMQ *q)
 // NOTE: This function tries to fill the current Chunk_Buffer once it reaches compact_ssn.
 static bool pmq_persist(PMQ *q, SSN ssn, SSN max_ssn)
 {
+   if (q->persist_hook && ! q->persist_hook(q->persist_hook_ctx))
+      goto error;
+
    if (! pmq_compact(q, ssn, max_ssn))
       goto error;
 
@@ -851,7 +973,10 @@ static bool _pmq_sync(PMQ *q)
       PMQ_PROFILED_UNIQUE_LOCK(lock_, q->pub_in_queue_mutex);
       for (;;)
       {
-         ic = q->pub_in_queue_cursors;
+         // We are the persister, so our own cursors are the most recent
+         // information about what has hit the disk.
+         ic.ssn_disk = q->persister.persist_cursors.cks_ssn;
+         ic.ssn_mem = SSN(q->enqueuer.commit_ssn.load(std::memory_order_acquire));
          pmq_assert(sn64_le(ic.ssn_disk, ic.ssn_mem));
          uint64_t slots_fill = ic.ssn_mem - ic.ssn_disk;
          if (slots_fill >= q->in_queue.slots_persist_watermark)
@@ -894,22 +1019,123 @@ bool pmq_sync(PMQ *q)
    return ret;
 }
 
+static bool pmq_fill_hole(PMQ *q, SSN commit_ssn);
+
+// Number of times a producer checks the commit mark before it goes to sleep.
+static constexpr unsigned PMQ_COMMIT_SPIN_COUNT = 64;
+
+// How long a producer sleeps for earlier producers before its enqueue fails.
+static constexpr auto PMQ_COMMIT_WAIT_TIMEOUT = std::chrono::seconds(10);
+
+// Wake up the producers that sleep in pmq_sleep_for_commit(). To be called
+// after advancing commit_ssn or registering a hole.
+static void pmq_wake_commit_waiters(PMQ *q)
+{
+   // Pairs with the fence in pmq_sleep_for_commit(): either the sleeper sees
+   // the new value, or we see the sleeper.
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+
+   if (q->enqueuer.commit_waiters.load(std::memory_order_relaxed) == 0)
+      return;
+
+   PMQ_PROFILED_LOCK(lock_, q->enqueuer.commit_mutex);
+   q->enqueuer.commit_cond.notify_all();
+}
+
+// Sleep until commit_ssn or num_holes differ from the given values. Returns
+// false if that did not happen before deadline.
+static bool pmq_sleep_for_commit(PMQ *q, SSN commit_ssn, unsigned num_holes,
+      std::chrono::steady_clock::time_point deadline)
+{
+   PMQ_PROFILED_SCOPE("sleep-commit");
+
+   bool changed = true;
+
+   q->enqueuer.commit_waiters.fetch_add(1, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+
+   {
+      PMQ_PROFILED_UNIQUE_LOCK(lock_, q->enqueuer.commit_mutex);
+
+      while (SSN(q->enqueuer.commit_ssn.load(std::memory_order_acquire)) == commit_ssn &&
+            q->enqueuer.num_holes.load(std::memory_order_acquire) == num_holes)
+      {
+         if (q->enqueuer.commit_cond.wait_until(lock_, deadline) == std::cv_status::timeout)
+         {
+            changed = false;
+            break;
+         }
+      }
+   }
+
+   q->enqueuer.commit_waiters.fetch_sub(1, std::memory_order_relaxed);
+   return changed;
+}
+
 // Helper function for pmq_enqueue_msg
-// Attempts to make enough room in the In_Queue
-// enqueue_mutex must be locked.
+// Wait until all slots before ssn are committed. Holes of abandoned
+// reservations at the commit mark are filled on the way. Returns false if
+// room for such a hole could not be made, or if the earlier producers did not
+// commit within PMQ_COMMIT_WAIT_TIMEOUT.
+static bool pmq_wait_for_commit(PMQ *q, SSN ssn)
+{
+   PMQ_PROFILED_SCOPE("wait-commit");
+
+   std::chrono::steady_clock::time_point deadline;
+   bool timed_out = false;
+
+   // Earlier producers are usually just copying their payload, so spin a
+   // little before going to sleep.
+   for (unsigned spins = 0; ; spins++)
+   {
+      SSN commit_ssn = SSN(q->enqueuer.commit_ssn.load(std::memory_order_acquire));
+
+      if (sn64_ge(commit_ssn, ssn))
+         return true;
+
+      if (timed_out)
+      {
+         pmq_perr_f("Timed out waiting for the commit of slots before %" PRIu64
+               ", commit mark is at %" PRIu64, ssn.value(), commit_ssn.value());
+         return false;
+      }
+
+      unsigned num_holes = q->enqueuer.num_holes.load(std::memory_order_acquire);
 
-static bool __pmq_profiled pmq_prepare_input_slots(PMQ *q, uint64_t nslots_req)
+      if (num_holes > 0)
+      {
+         if (! pmq_fill_hole(q, commit_ssn))
+            return false;
+      }
+
+      if (spins < PMQ_COMMIT_SPIN_COUNT)
+         continue;
+
+      if (spins == PMQ_COMMIT_SPIN_COUNT)
+         deadline = std::chrono::steady_clock::now() + PMQ_COMMIT_WAIT_TIMEOUT;
+
+      timed_out = ! pmq_sleep_for_commit(q, commit_ssn, num_holes, deadline);
+   }
+}
+
+// Helper function for pmq_enqueue_msg
+// Makes sure that all slots before end_ssn can be written, i.e. that the
+// slots of the In_Queue they map to were persisted. Takes enqueue_mutex, and
+// the persister context if the In_Queue is full.
+// All slots before (end_ssn - slot count) must be committed.
+static bool pmq_make_room(PMQ *q, SSN end_ssn)
 {
    PMQ_PROFILED_FUNCTION;
 
-   In_Queue_Cursors *ic = &q->enqueuer.in_queue_cursors;
-
    uint64_t slot_count = q->in_queue.slot_count;
-   SSN next_ssn_mem = ic->ssn_mem + nslots_req;
+   SSN need_ssn = end_ssn - slot_count;
+
+   PMQ_PROFILED_LOCK(lock_, q->enqueue_mutex);
 
-   pmq_assert(ic->ssn_mem - ic->ssn_disk <= slot_count);
+   In_Queue_Cursors *ic = &q->enqueuer.in_queue_cursors;
 
-   if (next_ssn_mem - ic->ssn_disk <= slot_count)
+   // another producer might have made room while we were waiting
+   if (end_ssn - ic->ssn_disk <= slot_count)
       return true;
 
    // Update the ssn_disk cursor from the pub_persist_cursors. Those hold the
@@ -921,70 +1147,196 @@ static bool __pmq_profiled pmq_prepare_input_slots(PMQ *q, uint64_t nslots_req)
       Persist_Cursors pc = q->pub_persist_cursors.load();
       ic->msn_disk = pc.cks_msn;
       ic->ssn_disk = pc.cks_ssn;
+      q->enqueuer.limit_ssn.store((ic->ssn_disk + slot_count).value(),
+            std::memory_order_release);
    }
 
-   if (next_ssn_mem - ic->ssn_disk <= slot_count)
+   if (end_ssn - ic->ssn_disk <= slot_count)
       return true;
 
    // Still not enough room, need to switch to persister context (lock
    // it) and flush some more messages.
 
-   q->enqueuer.enqueuer_stats.buffer_full_count += 1;
+   q->enqueuer.buffer_full_count.fetch_add(1, std::memory_order_relaxed);
 
-   PMQ_PROFILED_LOCK(lock_, q->persist_mutex);
+   PMQ_PROFILED_LOCK(persist_lock_, q->persist_mutex);
+
+   SSN commit_ssn = SSN(q->enqueuer.commit_ssn.load(std::memory_order_acquire));
 
-   if (! pmq_persist(q, next_ssn_mem - slot_count, ic->ssn_mem))
+   if (! pmq_persist(q, need_ssn, commit_ssn))
    {
       return false;
    }
 
-   if (false) // NOLINT
+   // Update the ssn_disk cursor from the (locked) persister context.
    {
-      Chunk_Queue *cq = &q->chunk_queue;
-      Persist_Cursors *pc = &q->persister.persist_cursors;
-      pmq_assert(sn64_ge(cq->cq_ssn, ic->ssn_mem));
-      pmq_debug_f("ic->ssn_mem: %" PRIu64 ", cq_ssn - cks_ssn: %" PRIu64,
-            ic->ssn_mem.value(), cq->cq_ssn.value() - pc->cks_ssn.value());
+      ic->msn_disk = q->persister.persist_cursors.cks_msn;
+      ic->ssn_disk = q->persister.persist_cursors.cks_ssn;
+      q->enqueuer.limit_ssn.store((ic->ssn_disk + slot_count).value(),
+            std::memory_order_release);
    }
 
-   if (false) // NOLINT
+   pmq_assert(end_ssn - ic->ssn_disk <= slot_count);
+   return true;
+}
+
+// Helper function for pmq_enqueue_msg
+// Makes sure that all slots before end_ssn can be written.
+// Called only if end_ssn exceeds limit_ssn.
+static bool __pmq_profiled pmq_prepare_input_slots(PMQ *q, SSN end_ssn)
+{
+   PMQ_PROFILED_FUNCTION;
+
+   // The slots that need to be persisted can only be compacted once they are
+   // committed. Wait for that before taking enqueue_mutex: the producers we
+   // wait for might be waiting for enqueue_mutex themselves.
+   if (! pmq_wait_for_commit(q, end_ssn - q->in_queue.slot_count))
+      return false;
+
+   return pmq_make_room(q, end_ssn);
+}
+
+// Helper function for pmq_enqueue_msg
+// Give up a reservation that could not be prepared or committed. If no other
+// producer reserved slots after it, the reservation is simply rolled back.
+// Otherwise those producers would wait for our commit until they time out, so
+// the range is registered as a hole that gets filled by one of them (see
+// pmq_fill_hole()).
+static void pmq_abandon_reservation(PMQ *q, SSN start_ssn, SSN end_ssn)
+{
+   uint64_t expected = end_ssn.value();
+
+   if (q->enqueuer.reserve_ssn.compare_exchange_strong(expected, start_ssn.value()))
+      return;
+
+   pmq_perr_f("Abandoned In_Queue reservation of slots %" PRIu64 " to %" PRIu64
+         " with later reservations pending. The slots will be skipped.",
+         start_ssn.value(), end_ssn.value());
+
+   std::chrono::steady_clock::time_point deadline;
+
+   for (unsigned spins = 0; ; spins++)
    {
-      SSN old_ssn_disk = ic->ssn_disk;
-      SSN new_ssn_disk = q->persister.persist_cursors.cks_ssn;
+      unsigned num_holes;
 
-      pmq_debug_f("Flushed %" PRIu64 " ssns", ic->ssn_disk - old_ssn_disk);
+      {
+         PMQ_PROFILED_LOCK(lock_, q->hole_mutex);
+
+         num_holes = q->enqueuer.num_holes.load(std::memory_order_relaxed);
 
-      if (sn64_le(new_ssn_disk, old_ssn_disk))
+         if (num_holes < Enqueuer::max_holes)
+         {
+            q->enqueuer.holes[num_holes] = Enqueuer::Hole { start_ssn, end_ssn };
+            q->enqueuer.num_holes.store(num_holes + 1, std::memory_order_release);
+            break;
+         }
+      }
+
+      // more concurrent holes than we have room for. They get filled by the
+      // waiting producers, so this should really never happen.
+      if (spins < PMQ_COMMIT_SPIN_COUNT)
+         continue;
+
+      if (spins == PMQ_COMMIT_SPIN_COUNT)
+         deadline = std::chrono::steady_clock::now() + PMQ_COMMIT_WAIT_TIMEOUT;
+
+      SSN commit_ssn = SSN(q->enqueuer.commit_ssn.load(std::memory_order_acquire));
+
+      if (! pmq_sleep_for_commit(q, commit_ssn, num_holes, deadline))
       {
-         pmq_perr_f("Something is wrong: %" PRIu64 ", %" PRIu64,
-               old_ssn_disk.value(), ic->ssn_disk.value());
+         // the producers waiting for our slots will time out as well
+         pmq_perr_f("Timed out registering the abandoned reservation of slots %" PRIu64
+               " to %" PRIu64, start_ssn.value(), end_ssn.value());
+         return;
       }
-      pmq_assert(slot_count >= (ic->ssn_mem - ic->ssn_disk));
    }
 
-   // Update the ssn_disk cursor from the (locked) persister context.
+   // the producer waiting at the commit mark might be waiting for this hole
+   pmq_wake_commit_waiters(q);
+}
+
+// Helper function for pmq_wait_for_commit()
+// If the range of an abandoned reservation starts at the commit mark, write a
+// padding record to its slots and commit it. Nobody else can commit then,
+// since the owner of the range gave up. Makes room first if the slots of the
+// hole can't be written yet, which only happens while waiting in
+// pmq_prepare_input_slots(): waiters in pmq_commit_msg() have prepared slots
+// behind the hole.
+static bool pmq_fill_hole(PMQ *q, SSN commit_ssn)
+{
+   PMQ_PROFILED_FUNCTION;
+
+   SSN end_ssn;
+
    {
-      ic->msn_disk = q->persister.persist_cursors.cks_msn;
-      ic->ssn_disk = q->persister.persist_cursors.cks_ssn;
+      PMQ_PROFILED_LOCK(lock_, q->hole_mutex);
+
+      unsigned num_holes = q->enqueuer.num_holes.load(std::memory_order_relaxed);
+      unsigned i = 0;
+
+      while (i < num_holes && q->enqueuer.holes[i].start_ssn != commit_ssn)
+         i++;
+
+      if (i == num_holes)
+         return true;  // owner is still busy, or somebody else filled it
+
+      end_ssn = q->enqueuer.holes[i].end_ssn;
+   }
+
+   if (sn64_gt(end_ssn, SSN(q->enqueuer.limit_ssn.load(std::memory_order_acquire))))
+   {
+      // the slots before end_ssn - slot_count are committed, since the hole
+      // isn't larger than the In_Queue.
+      if (! pmq_make_room(q, end_ssn))
+         return false;
+   }
+
+   PMQ_PROFILED_LOCK(lock_, q->hole_mutex);
+
+   unsigned num_holes = q->enqueuer.num_holes.load(std::memory_order_relaxed);
+   unsigned i = 0;
+
+   while (i < num_holes && q->enqueuer.holes[i].start_ssn != commit_ssn)
+      i++;
+
+   if (i == num_holes)
+      return true;  // somebody else filled it in the meantime
+
+   q->enqueuer.holes[i] = q->enqueuer.holes[num_holes - 1];
+   q->enqueuer.num_holes.store(num_holes - 1, std::memory_order_release);
+
+   uint64_t nslots = end_ssn - commit_ssn;
+
+   for (SSN ssn = commit_ssn; ssn != end_ssn; ssn++)
+   {
+      PMQ_Slot *slot = q->in_queue.slots.get_slot_for(ssn);
+      slot->flags = 0;
+      slot->msgsize = 0;
+   }
+
+   {
+      PMQ_Slot *slot = q->in_queue.slots.get_slot_for(commit_ssn);
+      slot->flags = PMQ_SLOT_LEADER_MASK | PMQ_SLOT_PADDING_MASK;
+      slot->msgsize = nslots * PMQ_SLOT_SPACE;
    }
 
-   pmq_assert(next_ssn_mem - ic->ssn_disk <= slot_count);
+   // commit without a message, i.e. commit_msn stays
+   q->enqueuer.commit_ssn.store(end_ssn.value(), std::memory_order_release);
+   q->enqueuer.padded_reservations.fetch_add(1, std::memory_order_relaxed);
+
+   pmq_wake_commit_waiters(q);
+
    return true;
 }
 
 // Helper function for pmq_enqueue_msg().
-// Serialize message to In_Queue's memory buffer.
-// Expects enqueue_mutex to be taken.
-// Expects that there is enough room to serialize the message (pmq_prepare_input_slots())
-static void pmq_serialize_msg(PMQ *q, const void *data, size_t size)
+// Serialize message to the reserved slots of the In_Queue's memory buffer.
+// Expects that the slots were prepared (pmq_prepare_input_slots()).
+// Runs concurrently with other producers, which write to other slots.
+static void pmq_serialize_msg(PMQ *q, SSN ssn_mem, const void *data, size_t size)
 {
    PMQ_PROFILED_FUNCTION;
 
-   In_Queue_Cursors *ic = &q->enqueuer.in_queue_cursors;
-
-   SSN ssn_mem = ic->ssn_mem;
-   SSN old_ssn_mem = ic->ssn_mem;
-
    uint64_t slot_count = q->in_queue.slot_count;
    pmq_assert(pmq_is_power_of_2(slot_count));
    uint32_t slot_flags = PMQ_SLOT_LEADER_MASK;
@@ -1014,32 +1366,53 @@ static void pmq_serialize_msg(PMQ *q, const void *data, size_t size)
 
       ssn_mem += 1;
    }
+}
+
+// Helper function for pmq_enqueue_msg().
+// Publish the message in the slots [start_ssn, end_ssn). Commits happen in
+// reservation order, so this waits for all earlier producers first.
+static bool pmq_commit_msg(PMQ *q, SSN start_ssn, SSN end_ssn, size_t size)
+{
+   PMQ_PROFILED_FUNCTION;
+
+   if (! pmq_wait_for_commit(q, start_ssn))
+      return false;
 
-   // can bump ssn_mem cursor, publish new cursors field, and release lock now
+   // We are the only committer now.
+   uint64_t msn = q->enqueuer.commit_msn.load(std::memory_order_relaxed);
+   q->enqueuer.commit_msn.store(msn + 1, std::memory_order_release);
+   q->enqueuer.commit_ssn.store(end_ssn.value(), std::memory_order_release);
 
-   ic->ssn_mem = ssn_mem;
-   ic->msn += 1;
+   pmq_wake_commit_waiters(q);
 
-   q->enqueuer.enqueuer_stats.total_messages_enqueued += 1;
-   q->enqueuer.enqueuer_stats.total_bytes_enqueued += size;
+   q->enqueuer.total_messages_enqueued.fetch_add(1, std::memory_order_relaxed);
+   q->enqueuer.total_bytes_enqueued.fetch_add(size, std::memory_order_relaxed);
 
+   // number of slots reserved by producers that have not committed yet
+   PMQ_PROFILED_PLOT("pmq-uncommitted-slots",
+         q->enqueuer.reserve_ssn.load(std::memory_order_relaxed) - end_ssn.value());
+
+   // Wake up the persister if this message made the fill level cross the
+   // watermark. limit_ssn may be slightly outdated here; the persister polls
+   // anyway, so an early or missed wakeup costs only a little latency.
    {
-      uint64_t new_slot_count = ic->ssn_mem - ic->ssn_disk;
-      uint64_t old_slot_count = old_ssn_mem - ic->ssn_disk;
+      uint64_t slot_count = q->in_queue.slot_count;
+      SSN ssn_disk = SSN(q->enqueuer.limit_ssn.load(std::memory_order_relaxed)) - slot_count;
+      uint64_t new_slot_count = end_ssn - ssn_disk;
+      uint64_t old_slot_count = start_ssn - ssn_disk;
 
       bool notify =
          old_slot_count < q->in_queue.slots_persist_watermark &&
          new_slot_count >= q->in_queue.slots_persist_watermark;
 
+      if (notify)
       {
          PMQ_PROFILED_UNIQUE_LOCK(lock_, q->pub_in_queue_mutex);
-         q->pub_in_queue_cursors = *ic;
-         if (notify)
-            q->pub_in_queue_cond.notify_one();
+         q->pub_in_queue_cond.notify_one();
       }
    }
 
-   pmq_assert(ic->ssn_mem - ic->ssn_disk <= slot_count);
+   return true;
 }
 
 bool pmq_enqueue_msg(PMQ *q, const void *data, size_t size)
@@ -1048,11 +1421,29 @@ bool pmq_enqueue_msg(PMQ *q, const void *data, size_t size)
 
    pmq_assert(size > 0);
    uint64_t nslots_req = (size + PMQ_SLOT_SPACE - 1) / PMQ_SLOT_SPACE;
+   pmq_assert(nslots_req <= q->in_queue.slot_count);
 
-   PMQ_PROFILED_LOCK(lock_, q->enqueue_mutex);
-   if (! pmq_prepare_input_slots(q, nslots_req))
+   SSN start_ssn = SSN(q->enqueuer.reserve_ssn.fetch_add(nslots_req, std::memory_order_relaxed));
+   SSN end_ssn = start_ssn + nslots_req;
+
+   if (sn64_gt(end_ssn, SSN(q->enqueuer.limit_ssn.load(std::memory_order_acquire))))
+   {
+      if (! pmq_prepare_input_slots(q, end_ssn))
+      {
+         pmq_abandon_reservation(q, start_ssn, end_ssn);
+         return false;
+      }
+   }
+
+   pmq_serialize_msg(q, start_ssn, data, size);
+
+   if (! pmq_commit_msg(q, start_ssn, end_ssn, size))
+   {
+      // (the slots are prepared, so the hole can be filled without making room)
+      pmq_abandon_reservation(q, start_ssn, end_ssn);
       return false;
-   pmq_serialize_msg(q, data, size);
+   }
+
    return true;
 }
 
@@ -1523,6 +1914,11 @@ static bool pmq_init(PMQ *q, const PMQ_Init_Params *params)
 
    // Set up cursors
    q->enqueuer.in_queue_cursors = q->pub_in_queue_cursors;
+   q->enqueuer.reserve_ssn = q->pub_in_queue_cursors.ssn_mem.value();
+   q->enqueuer.commit_ssn = q->pub_in_queue_cursors.ssn_mem.value();
+   q->enqueuer.commit_msn = q->pub_in_queue_cursors.msn.value();
+   q->enqueuer.limit_ssn =
+      (q->pub_in_queue_cursors.ssn_disk + q->in_queue.slot_count).value();
    q->persister.persist_cursors = q->pub_persist_cursors.load();
 
    // Initialize Chunk_Queue
@@ -1573,7 +1969,7 @@ static bool pmq_init(PMQ *q, const PMQ_Init_Params *params)
    }
 
    {
-      In_Queue_Cursors ic = q->enqueuer.in_queue_cursors;
+      In_Queue_Cursors ic = pmq_load_in_queue_cursors(q);
       pmq_debug_f("in_queue_cursors.msn: %" PRIu64, ic.msn.value());
       pmq_debug_f("in_queue_cursors.ssn_mem: %" PRIu64, ic.ssn_mem.value());
       pmq_debug_f("in_queue_cursors.msn_disk: %" PRIu64, ic.msn_disk.value());
@@ -1969,6 +2365,7 @@ static PMQ_Read_Result pmq_reader_seek_to_msg_chunkstore(PMQ_Reader *reader, MSN
 struct PMQ_Slot_Header_Read_Result
 {
    bool is_leader_slot;
+   bool is_padding;  // slots of an abandoned reservation, no message
    uint16_t msgsize;
    uint16_t nslots_req;
 };
@@ -1983,6 +2380,7 @@ static PMQ_Read_Result pmq_read_slot_header(PMQ *q, SSN ssn, PMQ_Slot_Header_Rea
 
    // Extract message size from slot header.
    out->is_leader_slot = (slot->flags & PMQ_SLOT_LEADER_MASK) != 0;
+   out->is_padding = (slot->flags & PMQ_SLOT_PADDING_MASK) != 0;
    out->msgsize = slot->msgsize;
    out->nslots_req = (slot->msgsize + PMQ_SLOT_SPACE - 1) / PMQ_SLOT_SPACE;
 
@@ -2004,7 +2402,8 @@ static PMQ_Read_Result pmq_reader_seek_to_msg_slotsfile(PMQ_Reader *reader, MSN
    // To prevent races, we need to check again using the enqueuer's cursors
    // that the MSN that we're looking for is still in the In_Queue.
 
-   In_Queue_Cursors *ic = &reader->q->enqueuer.in_queue_cursors;
+   In_Queue_Cursors ic_ = pmq_load_in_queue_cursors(reader->q);
+   In_Queue_Cursors *ic = &ic_;
    if (sn64_inrange(msn, ic->msn_disk, ic->msn))
    {
       if (sn64_inrange(pc.wal_msn, msn, ic->msn))
@@ -2053,7 +2452,9 @@ static PMQ_Read_Result pmq_reader_seek_to_msg_slotsfile(PMQ_Reader *reader, MSN
             }
 
             ssn_cur += slot_read_result.nslots_req;
-            msn_cur += 1;
+
+            if (! slot_read_result.is_padding)
+               msn_cur += 1;
          }
 
          reader->read_mode = PMQ_Read_Mode_Slotsfile;
@@ -2327,21 +2728,39 @@ static PMQ_Read_Result pmq_read_msg_slotsfile(PMQ_Reader *reader, PMQ_Msg_Output
 
    PMQ_Slot_Header_Read_Result slot_read_result;
 
+   for (;;)
    {
-      PMQ_Read_Result readres = pmq_read_slot_header(q, ssn, &slot_read_result);
-      if (readres != PMQ_Read_Result_Success)
-         return readres;
-   }
+      {
+         PMQ_Read_Result readres = pmq_read_slot_header(q, ssn, &slot_read_result);
+         if (readres != PMQ_Read_Result_Success)
+            return readres;
+      }
 
-   if (! slot_read_result.is_leader_slot)
-   {
-      // Earlier there was an assert() here instead of an integrity check,
-      // assuming that RAM should never be corrupted. However, the RAM might
-      // be filled from disk, and we currently don't validate the data after
-      // loading. Thus we now consider slot memory just as corruptible as
-      // disk data.
-      pmq_perr_f("slot %" PRIu64 " is not a leader slot.", ssn.value());
-      return PMQ_Read_Result_Integrity_Error;
+      if (! slot_read_result.is_leader_slot)
+      {
+         // Earlier there was an assert() here instead of an integrity check,
+         // assuming that RAM should never be corrupted. However, the RAM might
+         // be filled from disk, and we currently don't validate the data after
+         // loading. Thus we now consider slot memory just as corruptible as
+         // disk data.
+         pmq_perr_f("slot %" PRIu64 " is not a leader slot.", ssn.value());
+         return PMQ_Read_Result_Integrity_Error;
+      }
+
+      if (! slot_read_result.is_padding)
+         break;
+
+      if (reader->persist_cursors.wal_ssn - ssn < slot_read_result.nslots_req)
+      {
+         pmq_perr_f("Integrity error: Read inconsistent padding size from slot");
+         return PMQ_Read_Result_Integrity_Error;
+      }
+
+      ssn += slot_read_result.nslots_req;
+      slread->ssn = ssn;
+
+      if (ssn == reader->persist_cursors.wal_ssn)
+         return PMQ_Read_Result_EOF;
    }
 
    *output.size_out = slot_read_result.msgsize;
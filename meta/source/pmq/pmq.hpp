@@ -9,6 +9,9 @@ struct PMQ_Enqueuer_Stats
    uint64_t buffer_full_count;
    uint64_t total_messages_enqueued;
    uint64_t total_bytes_enqueued;
+   // reservations that were abandoned after a failure to make room, and
+   // skipped with a padding record
+   uint64_t padded_reservations;
 };
 
 struct PMQ_Persister_Stats
@@ -52,6 +55,12 @@ bool pmq_sync(PMQ *q);
 
 void pmq_get_stats(PMQ *q, PMQ_Stats *stats);
 
+/* For testing: @hook is called before each attempt to persist messages. If it
+ * returns false, the attempt fails as if the disk had reported an I/O error.
+ * Pass NULL to remove the hook. */
+typedef bool PMQ_Persist_Hook(void *ctx);
+void pmq_set_persist_hook(PMQ *q, PMQ_Persist_Hook *hook, void *ctx);
+
 /* Information about persisted data */
 struct PMQ_Persist_Info
 {
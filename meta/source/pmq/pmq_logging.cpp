@@ -219,8 +219,11 @@ void pmq_msg_ofv(const PMQ_Msg_Options& opt, const char *fmt, va_list ap)
 
 #if INTEGRATE_WITH_METADATA_SERVER
    // Integration into metadata server
+   // (there is no logger in unit tests, the LOG macros skip the message in that case too)
    Logger *logger = Logger::getLogger();
-   logger->log(LogTopic_EVENTLOGGER, metadata_priority, opt.loc.file, opt.loc.line, log_msg.data);
+   if (logger)
+      logger->log(LogTopic_EVENTLOGGER, metadata_priority, opt.loc.file, opt.loc.line,
+            log_msg.data);
 #else
 
    log_msg_printf(&log_msg, "\n");
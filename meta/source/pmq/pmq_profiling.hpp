@@ -20,6 +20,7 @@
 #  define PMQ_PROFILING_CTX FrameMark
 #  define PMQ_PROFILED_SCOPE(name) ZoneScopedN(name)
 #  define PMQ_PROFILED_FUNCTION ZoneScoped
+#  define PMQ_PROFILED_PLOT(name, value) TracyPlot(name, (int64_t) (value))
 #  define PMQ_PROFILED_MUTEX(name) TracyLockable(std::mutex, name)
 #  define PMQ_PROFILED_CONDVAR(name) std::condition_variable_any name
 #  define PMQ_PROFILED_LOCK(name, themutex) \
@@ -36,6 +37,7 @@
 #  define PMQ_PROFILING_CTX
 #  define PMQ_PROFILED_SCOPE(name)
 #  define PMQ_PROFILED_FUNCTION
+#  define PMQ_PROFILED_PLOT(name, value)
 #  define PMQ_PROFILED_MUTEX(name) std::mutex name
 #  define PMQ_PROFILED_CONDVAR(name) std::condition_variable name
 #  define PMQ_PROFILED_LOCK(name, themutex) \
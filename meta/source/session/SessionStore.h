@@ -59,7 +59,7 @@ class SessionStore
    private:
       SessionMap sessions;
 
-      Mutex mutex;
+      Mutex mutex{"SessionStore::mutex"};
 
       EntryLockStore entryLockStore; // Locks on entryIDs to synchronize with mirror buddy.
 
@@ -9,6 +9,7 @@
 #include <sys/types.h>
 #include <sys/xattr.h>
 #include <dirent.h>
+#include <fcntl.h>
 
 #include "DiskMetaData.h"
 #include "DirEntry.h"
@@ -30,7 +31,8 @@ DirInode::DirInode(const std::string& id, int mode, unsigned userID, unsigned gr
       numSubdirs(0),
       numFiles(0),
       entries(id, isBuddyMirrored),
-      isLoaded(true)
+      isLoaded(true),
+      writeBehindDirty(false)
 {
    this->stripePattern      = stripePattern.clone();
 
@@ -127,9 +129,10 @@ StripePattern* DirInode::createFileStripePatternUnlocked(const UInt16List* prefe
 
       /* (note: chooserType random{inter,intra}node is not supported by buddy mirrors, because we
          can't do the internal node-based grouping for buddy mirrors, so we fallback to random in
-         in this case) */
+         in this case. same for loadaware, which only knows the load of nodes.) */
       if( (chooserType == TargetChooserType_RANDOMIZED) ||
           (chooserType == TargetChooserType_RANDOMINTERNODE) ||
+          (chooserType == TargetChooserType_LOADAWARE) ||
          //  (chooserType == TargetChooserType_RANDOMINTRANODE) ||
           (preferredTargets && !preferredTargets->empty() ) )
       { // randomized chooser, the only chooser that currently supports preferredTargets
@@ -177,6 +180,14 @@ StripePattern* DirInode::createFileStripePatternUnlocked(const UInt16List* prefe
                                                  &stripeTargets);
       }
       else
+      if(chooserType == TargetChooserType_LOADAWARE)
+      { // select random targets weighted by the recent load of their nodes
+         const auto targetWeights = app->getTargetLoadStore()->getTargetWeights();
+
+         capacityPools->chooseStorageTargetsWeighted(desiredNumTargets, minNumRequiredTargets,
+                                                     *targetWeights, &stripeTargets);
+      }
+      else
       { // round robin or randomized round robin chooser
          capacityPools->chooseStorageTargetsRoundRobin(desiredNumTargets, &stripeTargets);
 
@@ -917,6 +928,146 @@ FhgfsOpsErr DirInode::refreshSubentryCountUnlocked()
    return retVal;
 }
 
+/**
+ * Decide whether an update of entry counts and time stamps may stay in memory for now (see
+ * tuneDirMetadataWriteBehindMS) and mark the inode dirty if so.
+ *
+ * Note: Buddy mirrored inodes are always stored right away, because a resync copies them from
+ * disk.
+ *
+ * @return true if the update was deferred, false if the caller must store the inode now
+ */
+bool DirInode::deferMetaDataUpdateUnlocked()
+{
+   Config* cfg = Program::getApp()->getConfig();
+
+   const unsigned writeBehindMS = cfg->getTuneDirMetadataWriteBehindMS();
+
+   if (!writeBehindMS || getIsBuddyMirrored() || !isLoaded)
+      return false;
+
+   if (writeBehindDirty)
+      return writeBehindDirtyT.elapsedMS() < writeBehindMS;
+
+   // the marker tells recoverWriteBehind() that the stored counts may be outdated after a crash
+   const std::string markerPath = std::string(META_DIRTYDIRS_SUBDIR_NAME "/") + id;
+
+   int fd = open(markerPath.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+   if (fd == -1)
+   {
+      LOG(GENERAL, WARNING, "Unable to create write-behind marker file, storing dir inode directly.",
+            markerPath, sysErr);
+      return false;
+   }
+
+   close(fd);
+
+   writeBehindDirty = true;
+   writeBehindDirtyT.setToNow();
+
+   return true;
+}
+
+/**
+ * Note: Call only after the inode was stored successfully.
+ */
+void DirInode::clearWriteBehindDirtyUnlocked()
+{
+   const std::string markerPath = std::string(META_DIRTYDIRS_SUBDIR_NAME "/") + id;
+
+   if (unlink(markerPath.c_str() ) && errno != ENOENT)
+      LOG(GENERAL, WARNING, "Unable to remove write-behind marker file.", markerPath, sysErr);
+
+   writeBehindDirty = false;
+}
+
+/**
+ * Store entry counts and time stamps that were kept in memory by write-behind.
+ *
+ * @param force store even if the write-behind interval has not elapsed yet. If storing fails, the
+ *    updates are dropped and the entry counts are recomputed on next startup.
+ * @return false if storing failed
+ */
+bool DirInode::flushWriteBehind(bool force)
+{
+   if (!writeBehindDirty)
+      return true;
+
+   UniqueRWLock lock(rwlock, SafeRWLock_WRITE);
+
+   if (!writeBehindDirty)
+      return true; // stored by someone else in the meantime
+
+   if (!force && writeBehindDirtyT.elapsedMS() <
+         Program::getApp()->getConfig()->getTuneDirMetadataWriteBehindMS() )
+      return true;
+
+   if (storeUpdatedMetaDataUnlocked() )
+      return true;
+
+   if (force)
+   { // the marker file stays, so recoverWriteBehind() will take care of this dir
+      LOG(GENERAL, ERR, "Unable to store dir inode, dropping its write-behind updates.", id);
+      writeBehindDirty = false;
+   }
+
+   return false;
+}
+
+/**
+ * Recompute and store the entry counts of all dirs that still had unstored updates when the server
+ * stopped, i.e. crashed. The time stamps of these dirs are set to now, as their last updates are
+ * lost.
+ *
+ * Note: Call before any dirs are loaded into the InodeDirStore.
+ */
+void DirInode::recoverWriteBehind()
+{
+   DIR* markerDir = opendir(META_DIRTYDIRS_SUBDIR_NAME);
+   if (!markerDir)
+   {
+      if (errno != ENOENT)
+         LOG(GENERAL, ERR, "Unable to open write-behind marker directory.",
+               ("path", META_DIRTYDIRS_SUBDIR_NAME), sysErr);
+
+      return;
+   }
+
+   while (struct dirent* markerEntry = StorageTk::readdirFiltered(markerDir) )
+   {
+      const std::string dirID = markerEntry->d_name;
+      const std::string markerPath = std::string(META_DIRTYDIRS_SUBDIR_NAME "/") + dirID;
+
+      DirInode dir(dirID, false);
+
+      if (dir.loadIfNotLoaded() )
+      {
+         UniqueRWLock lock(dir.rwlock, SafeRWLock_WRITE);
+
+         if (dir.refreshSubentryCountUnlocked() == FhgfsOpsErr_SUCCESS)
+         {
+            int64_t nowSecs = TimeAbs().getTimeval()->tv_sec;
+            dir.statData.setAttribChangeTimeSecs(nowSecs);
+            dir.statData.setModificationTimeSecs(nowSecs);
+
+            if (dir.storeUpdatedMetaDataUnlocked() )
+               LOG(GENERAL, NOTICE, "Recomputed entry counts of directory with unstored updates.",
+                     dirID, ("numSubdirs", dir.numSubdirs), ("numFiles", dir.numFiles));
+            else
+            { // keep the marker to try again on next startup
+               LOG(GENERAL, ERR, "Unable to store recomputed entry counts of directory.", dirID);
+               continue;
+            }
+         }
+      }
+
+      // (if the dir can't be loaded, it was removed and there's nothing left to recover)
+      unlink(markerPath.c_str() );
+   }
+
+   closedir(markerDir);
+}
+
 
 /*
  * Note: Current object state is used for the serialization.
@@ -1360,7 +1511,13 @@ bool DirInode::storeUpdatedMetaDataUnlocked()
       return false;
    }
 
-   return storeUpdatedMetaDataBuf(buf, ser.size());
+   if (!storeUpdatedMetaDataBuf(buf, ser.size() ) )
+      return false;
+
+   if (writeBehindDirty)
+      clearWriteBehindDirtyUnlocked();
+
+   return true;
 }
 
 bool DirInode::storeRemoteStorageTargetInfoUnlocked()
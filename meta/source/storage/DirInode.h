@@ -6,12 +6,15 @@
 #include <common/storage/StorageDefinitions.h>
 #include <common/storage/StorageErrors.h>
 #include <common/threading/UniqueRWLock.h>
+#include <common/toolkit/Time.h>
 #include <common/storage/StatData.h>
 #include <common/Common.h>
 #include "DirEntryStore.h"
 #include "MetadataEx.h"
 #include "InodeFileStore.h"
 
+#include <atomic>
+
 
 /* Note: Don't forget to update DiskMetaData::getSupportedDirInodeFeatureFlags() if you add new
  *       flags here. */
@@ -55,7 +58,8 @@ class DirInode
          featureFlags(isBuddyMirrored ? DIRINODE_FEATURE_BUDDYMIRRORED : 0),
          exclusive(false),
          entries(id, isBuddyMirrored),
-         isLoaded(false)
+         isLoaded(false),
+         writeBehindDirty(false)
       { }
 
       ~DirInode()
@@ -92,6 +96,9 @@ class DirInode
 
       FhgfsOpsErr refreshMetaInfo();
 
+      bool flushWriteBehind(bool force);
+      static void recoverWriteBehind();
+
       // non-inlined getters & setters
       FhgfsOpsErr setOwnerNodeID(const std::string& entryName, NumNodeID ownerNode);
 
@@ -145,6 +152,11 @@ class DirInode
                                  * InodeFileStore still has entries. Therefore a dir reference
                                  * has to be taken for entry in this InodeFileStore */
 
+      /* set if entry counts or time stamps were updated in memory only (see
+         tuneDirMetadataWriteBehindMS). atomic for unlocked checks, changed with rwlock held. */
+      std::atomic<bool> writeBehindDirty;
+      Time writeBehindDirtyT; // time of the oldest unstored update
+
       StripePattern* createFileStripePatternUnlocked(const UInt16List* preferredTargets,
          unsigned numtargets, unsigned chunksize, StoragePoolId storagePoolId);
 
@@ -157,6 +169,8 @@ class DirInode
       bool storeUpdatedMetaDataBufAsContents(char* buf, unsigned bufLen);
       bool storeUpdatedMetaDataBufAsContentsInPlace(char* buf, unsigned bufLen);
       bool storeUpdatedMetaDataUnlocked();
+      bool deferMetaDataUpdateUnlocked();
+      void clearWriteBehindDirtyUnlocked();
 
       bool storeRemoteStorageTargetInfoUnlocked();
       bool storeRemoteStorageTargetDataBufAsXAttr(char* buf, unsigned bufLen);
@@ -600,6 +614,9 @@ class DirInode
          this->statData.setAttribChangeTimeSecs(nowSecs);
          this->statData.setModificationTimeSecs(nowSecs);
 
+         if (deferMetaDataUpdateUnlocked() )
+            return true;
+
          if(unlikely(!storeUpdatedMetaDataUnlocked() ) )
          {
             LogContext(logContext).logErr(std::string("Failed to update dir-info on disk: "
@@ -211,6 +211,152 @@ FhgfsOpsErr FileInode::clearRemoteStorageTarget(EntryInfo* entryInfo)
    return FhgfsOpsErr_SUCCESS;
 }
 
+/**
+ * Remember the state of the inode before its contents are read from the storage targets to take a
+ * copy of them, so that setInlineData() can detect modifications in the meantime.
+ *
+ * Note: The caller must keep the inode referenced until setInlineData() was called.
+ */
+InlineDataCapture FileInode::startInlineDataCapture()
+{
+   UniqueRWLock lock(rwlock, SafeRWLock_READ);
+
+   return {inlineDataGeneration.read(), inodeDiskData.getInodeStatData()->getFileSize()};
+}
+
+/**
+ * @return false if the file was (or might have been) modified since startInlineDataCapture().
+ */
+bool FileInode::isInlineDataCaptureCurrent(const InlineDataCapture& capture)
+{
+   UniqueRWLock lock(rwlock, SafeRWLock_READ);
+
+   return isInlineDataCaptureCurrentUnlocked(capture);
+}
+
+bool FileInode::isInlineDataCaptureCurrentUnlocked(const InlineDataCapture& capture)
+{
+   return capture.generation == inlineDataGeneration.read()
+      && !numSessionsWrite
+      && capture.fileSize == inodeDiskData.getInodeStatData()->getFileSize();
+}
+
+/**
+ * Store a copy of the file contents next to the inode (see tuneInlineFileDataMaxSize).
+ *
+ * Note: The chunk files remain the authoritative copy. A copy is only stored if the file was not
+ * modified since the capture was started, and it is dropped via dropInlineData() before the chunk
+ * files are modified.
+ *
+ * @param capture state of the inode before data was read from the storage targets
+ * @return FhgfsOpsErr_AGAIN if the file was modified in the meantime.
+ */
+FhgfsOpsErr FileInode::setInlineData(EntryInfo* entryInfo, const std::string& data,
+   const InlineDataCapture& capture)
+{
+   UniqueRWLock lock(rwlock, SafeRWLock_WRITE);
+
+   if (!isInlineDataCaptureCurrentUnlocked(capture) || capture.fileSize != (int64_t) data.size() )
+      return FhgfsOpsErr_AGAIN;
+
+   std::string metafile = getMetaFilePath(entryInfo);
+
+   int setRes = setxattr(metafile.c_str(), INLINE_DATA_XATTR_NAME, data.data(), data.size(), 0);
+   if (setRes == -1 && errno == ENOENT)
+      return FhgfsOpsErr_PATHNOTEXISTS; // unlinked in the meantime
+
+   if (unlikely(setRes == -1))
+   {
+      LOG(GENERAL, WARNING, "Unable to store inline data.", ("entryID", entryInfo->getEntryID()),
+            ("metafile", metafile), ("sysErr", System::getErrString()));
+      return FhgfsOpsErr_INTERNAL;
+   }
+
+   if (!inodeDiskData.getHasInlineData())
+   {
+      inodeDiskData.setHasInlineData(true);
+
+      if (!storeUpdatedInodeUnlocked(entryInfo))
+      {
+         inodeDiskData.setHasInlineData(false);
+         removexattr(metafile.c_str(), INLINE_DATA_XATTR_NAME);
+         return FhgfsOpsErr_INTERNAL;
+      }
+   }
+
+   return FhgfsOpsErr_SUCCESS;
+}
+
+/**
+ * @return false if the file has no inline data or it could not be read (in which case the data
+ * has to be read from the storage targets as usual).
+ */
+bool FileInode::getInlineData(EntryInfo* entryInfo, std::string& outData)
+{
+   UniqueRWLock lock(rwlock, SafeRWLock_READ);
+
+   if (!inodeDiskData.getHasInlineData())
+      return false;
+
+   std::string metafile = getMetaFilePath(entryInfo);
+
+   // the attribute does not move with the inode, e.g. if an inlined inode is moved to another
+   // directory, so a missing attribute is not an error
+   ssize_t size = getxattr(metafile.c_str(), INLINE_DATA_XATTR_NAME, NULL, 0);
+   if (size >= 0)
+   {
+      outData.resize(size);
+      size = getxattr(metafile.c_str(), INLINE_DATA_XATTR_NAME, &outData[0], outData.size());
+   }
+
+   if (size < 0)
+   {
+      LOG_DBG(GENERAL, DEBUG, "Unable to read inline data.", ("entryID", entryInfo->getEntryID()),
+            ("metafile", metafile), ("sysErr", System::getErrString()));
+      return false;
+   }
+
+   outData.resize(size);
+   return true;
+}
+
+/**
+ * Drop the copy of the file contents, e.g. because the file is about to be modified. This also
+ * invalidates captures that are in progress.
+ *
+ * Note: Called for every open for writing and every truncate, so the common case of a file without
+ * a copy only takes the read lock.
+ */
+void FileInode::dropInlineData(EntryInfo* entryInfo)
+{
+   /* (lock-free, but before the check below: a capture that stores its copy after the check sees
+      the new generation and is rejected) */
+   inlineDataGeneration.increase();
+
+   {
+      UniqueRWLock lock(rwlock, SafeRWLock_READ);
+
+      if (!inodeDiskData.getHasInlineData())
+         return;
+   }
+
+   UniqueRWLock lock(rwlock, SafeRWLock_WRITE);
+
+   if (!inodeDiskData.getHasInlineData())
+      return; // dropped in the meantime
+
+   std::string metafile = getMetaFilePath(entryInfo);
+
+   // remove the attribute first, a stale flag without the attribute is harmless
+   int removeRes = removexattr(metafile.c_str(), INLINE_DATA_XATTR_NAME);
+   if (unlikely(removeRes == -1 && errno != ENODATA))
+      LOG(GENERAL, WARNING, "Unable to remove inline data.", ("entryID", entryInfo->getEntryID()),
+            ("metafile", metafile), ("sysErr", System::getErrString()));
+
+   inodeDiskData.setHasInlineData(false);
+   storeUpdatedInodeUnlocked(entryInfo);
+}
+
 /**
  * Decrease number of sessions for read or write (=> file close) and update persistent
  * metadata.
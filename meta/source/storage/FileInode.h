@@ -7,6 +7,7 @@
 #include <common/storage/PathInfo.h>
 #include <common/storage/StatData.h>
 #include <common/storage/striping/ChunkFileInfo.h>
+#include <common/threading/Atomics.h>
 #include <common/threading/UniqueRWLock.h>
 #include <common/threading/SafeRWLock.h>
 #include <common/threading/Condition.h>
@@ -62,6 +63,16 @@ struct DentryCompatData
       bool operator!=(const DentryCompatData& other) const { return !(*this == other); }
 };
 
+/**
+ * State of a file inode at the time a copy of its contents is read from the storage targets (see
+ * FileInode::startInlineDataCapture() ).
+ */
+struct InlineDataCapture
+{
+   uint64_t generation; // FileInode::inlineDataGeneration
+   int64_t fileSize;
+};
+
 
 /**
  * Our inode object, but for files only (so all file types except of directories).
@@ -97,6 +108,13 @@ class FileInode
       FhgfsOpsErr setRemoteStorageTarget(EntryInfo* entryInfo, const RemoteStorageTarget& rst);
       FhgfsOpsErr clearRemoteStorageTarget(EntryInfo* entryInfo);
 
+      InlineDataCapture startInlineDataCapture();
+      bool isInlineDataCaptureCurrent(const InlineDataCapture& capture);
+      FhgfsOpsErr setInlineData(EntryInfo* entryInfo, const std::string& data,
+         const InlineDataCapture& capture);
+      bool getInlineData(EntryInfo* entryInfo, std::string& outData);
+      void dropInlineData(EntryInfo* entryInfo);
+
       void decNumSessionsAndStore(EntryInfo* entryInfo, unsigned accessFlags);
       static FileInode* createFromEntryInfo(EntryInfo* entryInfo);
 
@@ -184,6 +202,9 @@ class FileInode
       uint32_t numSessionsRead; // open read-only
       uint32_t numSessionsWrite; // open for writing or read-write
 
+      AtomicUInt64 inlineDataGeneration; // incremented whenever the chunk files may be modified
+         // (only in memory, the inode stays referenced while a copy of the contents is taken)
+
 
       bool isInlined; // boolean if the inode inlined into the Dentry or a separate file
 
@@ -236,6 +257,7 @@ class FileInode
          StripePattern* updatedStripePattern = NULL);
 
       std::string getMetaFilePath(EntryInfo* entryInfo);
+      bool isInlineDataCaptureCurrentUnlocked(const InlineDataCapture& capture);
       bool storeRemoteStorageTargetUnlocked(EntryInfo* entryInfo);
       bool storeRemoteStorageTargetBufAsXAttr(char* buf, unsigned bufLen, const std::string& metafilename);
 
@@ -733,7 +755,10 @@ class FileInode
          if(accessFlags & OPENFILE_ACCESS_READ)
             this->numSessionsRead++;
          else
+         {
             this->numSessionsWrite++; // (includes read+write)
+            this->inlineDataGeneration.increase(); // (a copy being taken might miss the writes)
+         }
       }
 
       FileInode* clone()
@@ -887,6 +912,12 @@ class FileInode
          return retVal;
       }
 
+      bool getHasInlineData()
+      {
+         UniqueRWLock lock(rwlock, SafeRWLock_READ);
+         return this->inodeDiskData.getHasInlineData();
+      }
+
       /**
        * Sets the file state using a raw state value and persists it to disk.
        * Only updates file state if the access flags transition is allowed based
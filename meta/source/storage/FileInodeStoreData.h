@@ -22,6 +22,7 @@
 #define FILEINODE_FEATURE_HAS_VERSIONS      128 // file has a cto version counter
 #define FILEINODE_FEATURE_HAS_RST           256 // file has remote targets
 #define FILEINODE_FEATURE_HAS_STATE_FLAGS   512 // file has state flags (access state + data state)
+#define FILEINODE_FEATURE_HAS_INLINE_DATA  1024 // copy of file contents in INLINE_DATA_XATTR_NAME
 
 enum FileInodeOrigFeature
 {
@@ -110,6 +111,7 @@ class FileInodeStoreData
    friend class DiskMetaData;
 
    friend class AdjustChunkPermissionsMsgEx;
+   friend class ChunkRebalancer;
 
    friend class TestSerialization; // for testing
 
@@ -279,6 +281,19 @@ class FileInodeStoreData
          return (getInodeFeatureFlags() & FILEINODE_FEATURE_HAS_RST);
       }
 
+      void setHasInlineData(bool hasInlineData)
+      {
+         if (hasInlineData)
+            addInodeFeatureFlag(FILEINODE_FEATURE_HAS_INLINE_DATA);
+         else
+            removeInodeFeatureFlag(FILEINODE_FEATURE_HAS_INLINE_DATA);
+      }
+
+      bool getHasInlineData() const
+      {
+         return (getInodeFeatureFlags() & FILEINODE_FEATURE_HAS_INLINE_DATA);
+      }
+
       void setFileState(uint8_t value)
       {
          this->rawFileState = value;
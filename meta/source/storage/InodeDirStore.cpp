@@ -131,6 +131,8 @@ void InodeDirStore::releaseDirUnlocked(const std::string& dirID)
             }
             else
             { // as expected, fileStore is empty
+               dirNonRef->flushWriteBehind(true);
+
                delete(dirRefer);
                this->dirs.erase(iter);
             }
@@ -326,6 +328,20 @@ FhgfsOpsErr InodeDirStore::setAttr(const std::string& dirID, bool isBuddyMirrore
    return FhgfsOpsErr_PATHNOTEXISTS;
 }
 
+/**
+ * Store dir inode updates that were kept in memory by write-behind (see
+ * tuneDirMetadataWriteBehindMS).
+ *
+ * @param force store all of them, not only those whose write-behind interval has elapsed
+ */
+void InodeDirStore::flushWriteBehind(bool force)
+{
+   RWLockGuard lock(rwlock, SafeRWLock_READ);
+
+   for (auto it = dirs.begin(); it != dirs.end(); ++it)
+      it->second->getReferencedObject()->flushWriteBehind(force);
+}
+
 void InodeDirStore::invalidateMirroredDirInodes()
 {
    UniqueRWLock lock(rwlock, SafeRWLock_WRITE);
@@ -64,6 +64,8 @@ class InodeDirStore
 
       bool cacheSweepAsync();
 
+      void flushWriteBehind(bool force);
+
 
    private:
       DirectoryMap dirs;
@@ -73,7 +75,7 @@ class InodeDirStore
       Random randGen; // for random cache removal
       DirCacheMap refCache;
 
-      RWLock rwlock;
+      RWLock rwlock{"InodeDirStore::rwlock"};
 
       void releaseDirUnlocked(const std::string& dirID);
 
@@ -1922,6 +1922,17 @@ bool MetaStore::cacheSweepAsync()
    return dirStore.cacheSweepAsync();
 }
 
+/**
+ * Store dir inode updates that were kept in memory by write-behind.
+ *
+ * @param force store all of them, e.g. on shutdown
+ */
+void MetaStore::flushDirWriteBehind(bool force)
+{
+   UniqueRWLock lock(rwlock, SafeRWLock_READ);
+   dirStore.flushWriteBehind(force);
+}
+
 /**
  * So we failed to delete chunk files and need to create a new disposal file for later cleanup.
  *
@@ -95,6 +95,7 @@ class MetaStore
       void getCacheStats(size_t* numCachedDirs);
 
       bool cacheSweepAsync();
+      void flushDirWriteBehind(bool force);
 
       FhgfsOpsErr insertDisposableFile(FileInode* inode);
 
@@ -131,7 +132,7 @@ class MetaStore
 
       GlobalInodeLockStore inodeLockStore;
 
-      RWLock rwlock; /* note: this is mostly not used as a read/write-lock but rather a shared/excl
+      RWLock rwlock{"MetaStore::rwlock"}; /* note: this is mostly not used as a read/write-lock but rather a shared/excl
          lock (because we're not really modifying anyting directly) - especially relevant for the
          mutliple dirStore locking dual-move methods */
 
@@ -6,6 +6,7 @@
 #define META_UPDATE_EXT_STR   ".new-fhgfs"
 #define META_XATTR_NAME       "user.fhgfs"  // attribute name for dir-entries, file and dir metadata
 #define RST_XATTR_NAME        "user.beermt" // attribute name for storing remote storage target info
+#define INLINE_DATA_XATTR_NAME "user.beeidata" // attribute name for inlined file contents
 
 // !!!IMPORTANT NOTICE TO MAINTAINER!!!
 // Any new extended attribute (NON user-defined) that will be added
@@ -14,7 +15,8 @@
 // FAILURE TO DO SO WILL CAUSE:
 // Inconsistencies between primary and secondary meta mirrors due to incomplete buddy
 // resyncing, as the missing attribute's data will not be resynced to secondary meta.
-const std::array<std::string, 2> METADATA_XATTR_NAME_LIST = {META_XATTR_NAME, RST_XATTR_NAME};
+const std::array<std::string, 3> METADATA_XATTR_NAME_LIST = {META_XATTR_NAME, RST_XATTR_NAME,
+   INLINE_DATA_XATTR_NAME};
 
 // The size must be sufficient to hold the entire dentry data. In order to simplify various
 // operations, meta data or stored into a buffer and for example for a remote directory rename
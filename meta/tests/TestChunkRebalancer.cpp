@@ -0,0 +1,204 @@
+#include <components/chunkbalancer/ChunkRebalancer.h>
+
+#include <gtest/gtest.h>
+
+#define GIB (int64_t(1024) * 1024 * 1024)
+
+class TestChunkRebalancer : public ::testing::Test
+{
+   protected:
+      // fill diff 10%, nodes with more than 100 queued requests are busy, no budget limits
+      ChunkRebalancer rebalancer{ChunkRebalancer::Tuning{0.1, 100, 0, 0}};
+
+      // every target is on its own node with the same ID
+      void addTarget(uint16_t targetID, uint16_t poolID, int64_t usedGiB,
+         CapacityPoolType capacityPool = CapacityPool_NORMAL)
+      {
+         rebalancer.targets[targetID] = {targetID, NumNodeID(targetID), StoragePoolId(poolID),
+            capacityPool, 100 * GIB, (100 - usedGiB) * GIB, 0, 0};
+         rebalancer.nodeLoads[NumNodeID(targetID)] = {0, 0};
+      }
+
+      void setNodeLoad(uint16_t targetID, double avgQueuedRequests, double diskBytesPerSec)
+      {
+         rebalancer.nodeLoads[NumNodeID(targetID)] = {avgQueuedRequests, diskBytesPerSec};
+
+         double sum = 0;
+
+         for (const auto& load : rebalancer.nodeLoads)
+            sum += load.second.diskBytesPerSec;
+
+         rebalancer.meanDiskBytesPerSec = sum / rebalancer.nodeLoads.size();
+      }
+
+      unsigned planRound()
+      {
+         return rebalancer.planRound();
+      }
+
+      int64_t excessBytes(uint16_t targetID)
+      {
+         return rebalancer.targets.at(targetID).excessBytes;
+      }
+
+      int64_t acceptBytes(uint16_t targetID)
+      {
+         return rebalancer.targets.at(targetID).acceptBytes;
+      }
+
+      // @return 0 if no destination was found
+      uint16_t chooseDestination(uint16_t poolID, const UInt16Vector& stripeTargets,
+         uint64_t bytes)
+      {
+         const auto* target = rebalancer.chooseDestination(StoragePoolId(poolID), stripeTargets,
+            bytes);
+
+         return target ? target->targetID : 0;
+      }
+
+      static uint64_t getChunkFileLength(int64_t fileSize, unsigned chunkSize,
+         unsigned numTargets, unsigned targetIndex)
+      {
+         return ChunkRebalancer::getChunkFileLength(fileSize, chunkSize, numTargets, targetIndex);
+      }
+};
+
+TEST_F(TestChunkRebalancer, chunkFileLength)
+{
+   // 2 full stripe sets of 4 * 100 bytes, then 200 bytes for the first two targets
+   ASSERT_EQ(getChunkFileLength(1000, 100, 4, 0), 300u);
+   ASSERT_EQ(getChunkFileLength(1000, 100, 4, 1), 300u);
+   ASSERT_EQ(getChunkFileLength(1000, 100, 4, 2), 200u);
+   ASSERT_EQ(getChunkFileLength(1000, 100, 4, 3), 200u);
+
+   // partial chunk
+   ASSERT_EQ(getChunkFileLength(1050, 100, 4, 2), 250u);
+
+   // end of a stripe set
+   ASSERT_EQ(getChunkFileLength(800, 100, 4, 3), 200u);
+
+   // smaller than the first chunk
+   ASSERT_EQ(getChunkFileLength(50, 100, 4, 0), 50u);
+   ASSERT_EQ(getChunkFileLength(50, 100, 4, 1), 0u);
+
+   ASSERT_EQ(getChunkFileLength(0, 100, 4, 0), 0u);
+   ASSERT_EQ(getChunkFileLength(-1, 100, 4, 0), 0u);
+   ASSERT_EQ(getChunkFileLength(1000, 0, 4, 0), 0u);
+   ASSERT_EQ(getChunkFileLength(1000, 100, 0, 0), 0u);
+
+   // all chunk files together hold the file
+   const int64_t fileSize = 10 * GIB + 12345;
+   uint64_t sum = 0;
+
+   for (unsigned i = 0; i < 7; i++)
+      sum += getChunkFileLength(fileSize, 512 * 1024, 7, i);
+
+   ASSERT_EQ(sum, uint64_t(fileSize) );
+}
+
+TEST_F(TestChunkRebalancer, planSources)
+{
+   // pool average is 50% used
+   addTarget(1, 1, 80);
+   addTarget(2, 1, 20);
+   addTarget(3, 1, 55, CapacityPool_LOW);
+   addTarget(4, 1, 45);
+   addTarget(5, 1, 50);
+
+   ASSERT_EQ(planRound(), 2u);
+
+   // over the fill diff, or above average in a low capacity pool
+   ASSERT_EQ(excessBytes(1), 30 * GIB);
+   ASSERT_EQ(excessBytes(3), 5 * GIB);
+
+   ASSERT_EQ(acceptBytes(2), 30 * GIB);
+   ASSERT_EQ(acceptBytes(4), 5 * GIB);
+
+   ASSERT_EQ(excessBytes(5), 0);
+   ASSERT_EQ(acceptBytes(5), 0);
+}
+
+TEST_F(TestChunkRebalancer, planNothingEligible)
+{
+   // evenly filled
+   addTarget(1, 1, 50);
+   addTarget(2, 1, 50);
+
+   // within the fill diff
+   addTarget(3, 2, 40);
+   addTarget(4, 2, 50);
+
+   // only one target in the pool
+   addTarget(5, 3, 95);
+
+   ASSERT_EQ(planRound(), 0u);
+
+   for (uint16_t targetID = 1; targetID <= 5; targetID++)
+      ASSERT_EQ(excessBytes(targetID), 0) << targetID;
+}
+
+TEST_F(TestChunkRebalancer, planNoDestination)
+{
+   // the only target below average is in a low capacity pool (e.g. because it ran out of inodes)
+   addTarget(1, 1, 90);
+   addTarget(2, 1, 10, CapacityPool_LOW);
+
+   // emptiest target, but in another storage pool
+   addTarget(3, 2, 0);
+
+   ASSERT_EQ(planRound(), 0u);
+
+   ASSERT_EQ(excessBytes(1), 0);
+   ASSERT_EQ(acceptBytes(2), 0);
+   ASSERT_EQ(chooseDestination(1, {1}, GIB), 0);
+}
+
+TEST_F(TestChunkRebalancer, chooseDestination)
+{
+   addTarget(1, 1, 80);
+   addTarget(2, 1, 20);
+   addTarget(3, 1, 55, CapacityPool_LOW);
+   addTarget(4, 1, 45);
+   addTarget(5, 2, 0);
+   addTarget(6, 2, 100);
+
+   ASSERT_EQ(planRound(), 3u);
+
+   // the target furthest below average
+   ASSERT_EQ(chooseDestination(1, {1, 3}, GIB), 2);
+
+   // never a target that already has a chunk of the file
+   ASSERT_EQ(chooseDestination(1, {1, 2}, GIB), 4);
+   ASSERT_EQ(chooseDestination(1, {1, 2, 4}, GIB), 0);
+
+   // capacity pool limits: low targets take no data, the others only up to the pool average
+   ASSERT_EQ(acceptBytes(3), 0);
+   ASSERT_EQ(chooseDestination(1, {1, 2}, 5 * GIB), 4);
+   ASSERT_EQ(chooseDestination(1, {1, 2}, 6 * GIB), 0);
+   ASSERT_EQ(chooseDestination(1, {1}, 31 * GIB), 0);
+
+   // only targets of the same storage pool
+   ASSERT_EQ(chooseDestination(2, {6}, GIB), 5);
+}
+
+TEST_F(TestChunkRebalancer, chooseDestinationLoad)
+{
+   addTarget(1, 1, 80);
+   addTarget(2, 1, 20);
+   addTarget(4, 1, 40);
+
+   ASSERT_EQ(planRound(), 1u);
+   ASSERT_EQ(chooseDestination(1, {1}, GIB), 2);
+
+   // hot nodes are avoided if possible
+   setNodeLoad(2, 0, 1000);
+
+   ASSERT_EQ(chooseDestination(1, {1}, GIB), 4);
+   ASSERT_EQ(chooseDestination(1, {1, 4}, GIB), 2);
+
+   // busy nodes are not used at all
+   setNodeLoad(2, 101, 0);
+
+   ASSERT_EQ(chooseDestination(1, {1}, GIB), 4);
+   ASSERT_EQ(chooseDestination(1, {1, 4}, GIB), 0);
+}
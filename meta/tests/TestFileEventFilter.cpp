@@ -0,0 +1,183 @@
+#include <components/FileEventFilter.h>
+#include <common/storage/FileEvent.h>
+
+#include <gtest/gtest.h>
+
+class TestFileEventFilter : public ::testing::Test
+{
+   protected:
+      // layout of FileEventLogItem::serialize()
+      static std::vector<char> makeEvent(uint32_t type, const std::string& path,
+         const std::string& targetPath = "", uint32_t userId = 1000)
+      {
+         std::vector<char> buf(16 * 1024);
+         Serializer ser(buf.data(), buf.size());
+
+         ser
+            % uint16_t(2) // format version
+            % uint32_t(0) // event flags
+            % uint64_t(1) // hard links
+            % type
+            % std::string("entryId")
+            % std::string("parentId")
+            % path
+            % targetPath
+            % std::string("targetParentId")
+            % userId
+            % int64_t(0); // time stamp
+
+         EXPECT_TRUE(ser.good());
+         buf.resize(ser.size());
+         return buf;
+      }
+
+      static uint32_t typeOf(FileEventType type)
+      {
+         return uint32_t(type);
+      }
+
+      static bool matches(const FileEventFilter& filter, const std::vector<char>& event)
+      {
+         return filter.matches(event.data(), event.size());
+      }
+};
+
+TEST_F(TestFileEventFilter, emptyFilterMatchesAll)
+{
+   FileEventFilter filter;
+
+   ASSERT_TRUE(filter.empty());
+   ASSERT_TRUE(matches(filter, makeEvent(typeOf(FileEventType::CREATE), "/a")));
+   ASSERT_TRUE(filter.matches(nullptr, 0));
+}
+
+TEST_F(TestFileEventFilter, pathPrefixWholeComponents)
+{
+   FileEventFilter filter;
+   filter.pathPrefixes = {"/proj"};
+
+   const uint32_t create = typeOf(FileEventType::CREATE);
+
+   ASSERT_TRUE(matches(filter, makeEvent(create, "/proj")));
+   ASSERT_TRUE(matches(filter, makeEvent(create, "/proj/a")));
+   ASSERT_TRUE(matches(filter, makeEvent(create, "/proj/a/b")));
+   ASSERT_FALSE(matches(filter, makeEvent(create, "/project")));
+   ASSERT_FALSE(matches(filter, makeEvent(create, "/pro")));
+   ASSERT_FALSE(matches(filter, makeEvent(create, "/other/proj")));
+
+   // a trailing slash only matches below the directory
+   filter.pathPrefixes = {"/proj/"};
+
+   ASSERT_TRUE(matches(filter, makeEvent(create, "/proj/a")));
+   ASSERT_FALSE(matches(filter, makeEvent(create, "/proj")));
+   ASSERT_FALSE(matches(filter, makeEvent(create, "/project")));
+}
+
+TEST_F(TestFileEventFilter, renameTarget)
+{
+   FileEventFilter filter;
+   filter.pathPrefixes = {"/proj"};
+
+   const uint32_t rename = typeOf(FileEventType::RENAME);
+
+   // moved into or out of the filtered tree
+   ASSERT_TRUE(matches(filter, makeEvent(rename, "/tmp/x", "/proj/x")));
+   ASSERT_TRUE(matches(filter, makeEvent(rename, "/proj/x", "/tmp/x")));
+   ASSERT_FALSE(matches(filter, makeEvent(rename, "/tmp/x", "/project/x")));
+   ASSERT_FALSE(matches(filter, makeEvent(rename, "/tmp/x", "")));
+}
+
+TEST_F(TestFileEventFilter, typeMask)
+{
+   FileEventFilter filter;
+   filter.typeMask = (1u << typeOf(FileEventType::CREATE)) | (1u << typeOf(FileEventType::UNLINK));
+
+   ASSERT_TRUE(matches(filter, makeEvent(typeOf(FileEventType::CREATE), "/a")));
+   ASSERT_TRUE(matches(filter, makeEvent(typeOf(FileEventType::UNLINK), "/a")));
+   ASSERT_FALSE(matches(filter, makeEvent(typeOf(FileEventType::MKDIR), "/a")));
+
+   // types that don't fit into the mask never match a set mask
+   filter.typeMask = ~0u;
+
+   ASSERT_TRUE(matches(filter, makeEvent(31, "/a")));
+   ASSERT_FALSE(matches(filter, makeEvent(32, "/a")));
+   ASSERT_FALSE(matches(filter, makeEvent(1000, "/a")));
+}
+
+TEST_F(TestFileEventFilter, userIds)
+{
+   FileEventFilter filter;
+   filter.userIds = {0, 1000, 2000};
+
+   const uint32_t create = typeOf(FileEventType::CREATE);
+
+   ASSERT_TRUE(matches(filter, makeEvent(create, "/a", "", 0)));
+   ASSERT_TRUE(matches(filter, makeEvent(create, "/a", "", 2000)));
+   ASSERT_FALSE(matches(filter, makeEvent(create, "/a", "", 1500)));
+
+   // all criteria must match
+   filter.pathPrefixes = {"/b"};
+
+   ASSERT_FALSE(matches(filter, makeEvent(create, "/a", "", 1000)));
+   ASSERT_TRUE(matches(filter, makeEvent(create, "/b", "", 1000)));
+}
+
+TEST_F(TestFileEventFilter, malformedEvent)
+{
+   FileEventFilter filter;
+   filter.pathPrefixes = {"/proj"};
+
+   const std::vector<char> event = makeEvent(typeOf(FileEventType::CREATE), "/other");
+
+   ASSERT_FALSE(matches(filter, event));
+
+   // truncated events are passed to the subscriber
+   for (size_t size : {size_t(0), size_t(5), size_t(20), event.size() / 2})
+      ASSERT_TRUE(filter.matches(event.data(), size));
+}
+
+TEST_F(TestFileEventFilter, deserialize)
+{
+   std::vector<char> buf(1024);
+   Serializer ser(buf.data(), buf.size());
+
+   ser % uint32_t(1u << 5) % uint16_t(2);
+   ser % uint16_t(5);
+   ser.putBlock("/proj", 5);
+   ser % uint16_t(0); // empty prefixes are ignored
+   ser % uint16_t(3) % uint32_t(30) % uint32_t(10) % uint32_t(20);
+
+   ASSERT_TRUE(ser.good());
+
+   {
+      Deserializer des(buf.data(), ser.size());
+      FileEventFilter filter;
+
+      ASSERT_TRUE(filter.deserialize(des));
+      ASSERT_EQ(filter.typeMask, 1u << 5);
+      ASSERT_EQ(filter.pathPrefixes, std::vector<std::string>({"/proj"}));
+      ASSERT_EQ(filter.userIds, std::vector<uint32_t>({10, 20, 30})); // sorted
+   }
+
+   // truncated payloads are rejected
+   for (size_t size = 0; size < ser.size(); size++)
+   {
+      Deserializer des(buf.data(), size);
+      FileEventFilter filter;
+
+      ASSERT_FALSE(filter.deserialize(des)) << size;
+   }
+
+   // counts beyond the payload
+   {
+      std::vector<char> bad(16);
+      Serializer badSer(bad.data(), bad.size());
+
+      badSer % uint32_t(0) % uint16_t(0xffff) % uint16_t(0xffff);
+
+      Deserializer des(bad.data(), badSer.size());
+      FileEventFilter filter;
+
+      ASSERT_FALSE(filter.deserialize(des));
+   }
+}
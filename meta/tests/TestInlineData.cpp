@@ -0,0 +1,149 @@
+#include <common/storage/striping/BuddyMirrorPattern.h>
+#include <common/storage/striping/Raid0Pattern.h>
+#include <net/msghelpers/MsgHelperInlineData.h>
+#include <storage/FileInode.h>
+
+#include <gtest/gtest.h>
+
+class TestInlineData : public ::testing::Test
+{
+   protected:
+      static const unsigned CHUNK_SIZE = 512 * 1024;
+
+      Raid0Pattern pattern{CHUNK_SIZE, {1, 2, 3, 4}};
+      EntryInfo entryInfo;
+
+      // an inode that was never stored, so there is no copy on disk that would have to be dropped
+      std::unique_ptr<FileInode> makeInode(int64_t fileSize)
+      {
+         StatData statData(S_IFREG | 0644, 0, 0, pattern.getStripeTargetIDs()->size() );
+
+         statData.setFileSize(fileSize);
+
+         FileInodeStoreData storeData("0-1-1", &statData, &pattern, 0, 0, "root",
+            FileInodeOrigFeature_TRUE);
+
+         return std::unique_ptr<FileInode>(
+            new FileInode("0-1-1", &storeData, DirEntryType_REGULARFILE, 0) );
+      }
+
+      static void setFileSize(FileInode& inode, int64_t fileSize)
+      {
+         StatData statData;
+
+         inode.getStatData(statData);
+         statData.setFileSize(fileSize);
+         inode.setStatData(statData);
+      }
+};
+
+TEST_F(TestInlineData, isInlinable)
+{
+   ASSERT_TRUE(MsgHelperInlineData::isInlinable(pattern, 0, 4096, false) );
+   ASSERT_TRUE(MsgHelperInlineData::isInlinable(pattern, 4096, 4096, false) );
+   ASSERT_FALSE(MsgHelperInlineData::isInlinable(pattern, 4097, 4096, false) );
+
+   // all data has to be in the first chunk
+   Raid0Pattern smallChunks(64 * 1024, {1, 2});
+
+   ASSERT_TRUE(MsgHelperInlineData::isInlinable(smallChunks, 64 * 1024, 128 * 1024, false) );
+   ASSERT_FALSE(MsgHelperInlineData::isInlinable(smallChunks, 64 * 1024 + 1, 128 * 1024, false) );
+
+   // data on remote storage targets or in mirrored chunk files is not copied
+   BuddyMirrorPattern mirrored(CHUNK_SIZE, {1});
+
+   ASSERT_FALSE(MsgHelperInlineData::isInlinable(pattern, 100, 4096, true) );
+   ASSERT_FALSE(MsgHelperInlineData::isInlinable(mirrored, 100, 4096, false) );
+
+   Raid0Pattern noTargets(CHUNK_SIZE, UInt16Vector() );
+
+   ASSERT_FALSE(MsgHelperInlineData::isInlinable(noTargets, 100, 4096, false) );
+}
+
+TEST_F(TestInlineData, capture)
+{
+   auto inode = makeInode(100);
+
+   const InlineDataCapture capture = inode->startInlineDataCapture();
+
+   ASSERT_EQ(capture.fileSize, 100);
+   ASSERT_TRUE(inode->isInlineDataCaptureCurrent(capture) );
+
+   // readers don't modify the chunk files
+   inode->incNumSessions(OPENFILE_ACCESS_READ);
+
+   ASSERT_TRUE(inode->isInlineDataCaptureCurrent(capture) );
+
+   // a copy that does not have the size of the file is never stored
+   ASSERT_EQ(inode->setInlineData(&entryInfo, std::string(99, 'x'), capture), FhgfsOpsErr_AGAIN);
+   ASSERT_FALSE(inode->getHasInlineData() );
+}
+
+TEST_F(TestInlineData, invalidateOnWrite)
+{
+   auto inode = makeInode(100);
+
+   const InlineDataCapture capture = inode->startInlineDataCapture();
+
+   inode->incNumSessions(OPENFILE_ACCESS_WRITE);
+
+   ASSERT_FALSE(inode->isInlineDataCaptureCurrent(capture) );
+   ASSERT_EQ(inode->setInlineData(&entryInfo, std::string(100, 'x'), capture),
+      FhgfsOpsErr_AGAIN);
+   ASSERT_FALSE(inode->getHasInlineData() );
+
+   // a capture that starts while a writer has the file open is not valid either
+   const InlineDataCapture captureDuringWrite = inode->startInlineDataCapture();
+
+   ASSERT_FALSE(inode->isInlineDataCaptureCurrent(captureDuringWrite) );
+
+   // read+write counts as write
+   auto rwInode = makeInode(100);
+   const InlineDataCapture rwCapture = rwInode->startInlineDataCapture();
+
+   rwInode->incNumSessions(OPENFILE_ACCESS_READWRITE);
+
+   ASSERT_FALSE(rwInode->isInlineDataCaptureCurrent(rwCapture) );
+}
+
+TEST_F(TestInlineData, invalidateOnTruncate)
+{
+   auto inode = makeInode(100);
+
+   const InlineDataCapture capture = inode->startInlineDataCapture();
+
+   // truncChunkFile() drops the copy before the chunk files are truncated
+   inode->dropInlineData(&entryInfo);
+
+   ASSERT_FALSE(inode->isInlineDataCaptureCurrent(capture) );
+   ASSERT_EQ(inode->setInlineData(&entryInfo, std::string(100, 'x'), capture),
+      FhgfsOpsErr_AGAIN);
+
+   // a size change alone invalidates the capture as well
+   const InlineDataCapture nextCapture = inode->startInlineDataCapture();
+
+   ASSERT_TRUE(inode->isInlineDataCaptureCurrent(nextCapture) );
+
+   setFileSize(*inode, 50);
+
+   ASSERT_FALSE(inode->isInlineDataCaptureCurrent(nextCapture) );
+   ASSERT_EQ(inode->setInlineData(&entryInfo, std::string(100, 'x'), nextCapture),
+      FhgfsOpsErr_AGAIN);
+}
+
+TEST_F(TestInlineData, sizeMismatchFallback)
+{
+   const std::string data(100, 'x');
+
+   ASSERT_TRUE(MsgHelperInlineData::isCopyUsable(data, 100, 4096) );
+   ASSERT_TRUE(MsgHelperInlineData::isCopyUsable(std::string(), 0, 4096) );
+
+   // the file was changed without dropping the copy => read from the storage targets
+   ASSERT_FALSE(MsgHelperInlineData::isCopyUsable(data, 101, 4096) );
+   ASSERT_FALSE(MsgHelperInlineData::isCopyUsable(data, 99, 4096) );
+   ASSERT_FALSE(MsgHelperInlineData::isCopyUsable(data, 0, 4096) );
+
+   // larger than the client accepts
+   ASSERT_FALSE(MsgHelperInlineData::isCopyUsable(data, 100, 99) );
+   ASSERT_FALSE(MsgHelperInlineData::isCopyUsable(data, 100, 0) );
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <pmq/pmq.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/*
+ * persist hook that fails the given number of attempts to persist messages, like a failing disk
+ */
+static bool failPersist(void* ctx)
+{
+   // (called with the persister context locked)
+   unsigned* remainingFailures = static_cast<unsigned*>(ctx);
+
+   if (*remainingFailures == 0)
+      return true;
+
+   (*remainingFailures)--;
+   std::this_thread::sleep_for(std::chrono::milliseconds(1)); // failing disks are slow
+   return false;
+}
+
+class TestPMQ : public ::testing::Test
+{
+   protected:
+      std::string dir;
+      PMQ* q = nullptr;
+
+      void SetUp() override
+      {
+         char dirTemplate[] = "/tmp/beegfs-pmq-XXXXXX";
+
+         ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+         dir = dirTemplate;
+
+         // pmq_create() wants to create the queue directory itself
+         rmdir(dir.c_str());
+
+         const PMQ_Init_Params params = { dir.c_str(), 64 * 1024 * 1024 };
+         q = pmq_create(&params);
+         ASSERT_NE(q, nullptr);
+      }
+
+      void TearDown() override
+      {
+         if (q)
+            pmq_destroy(q);
+
+         for (const char* file : {"/state.dat", "/wal.dat", "/chunks.dat"})
+            unlink((dir + file).c_str());
+
+         rmdir(dir.c_str());
+      }
+};
+
+/*
+ * A failure to make room in the In_Queue while other producers already reserved slots behind the
+ * failing one must only fail that one message. The abandoned slots are skipped, later enqueues
+ * succeed and readers see all committed messages.
+ */
+TEST_F(TestPMQ, persistFailureWithPendingReservations)
+{
+   const unsigned numThreads = 8;
+   const unsigned numMsgs = 40000;
+   const size_t msgSize = 300;
+
+   // no persister thread, so the In_Queue fills up and the producers need to make room themselves
+   unsigned remainingFailures = 4;
+   pmq_set_persist_hook(q, failPersist, &remainingFailures);
+
+   std::vector<std::thread> threads;
+
+   for (unsigned t = 0; t < numThreads; t++)
+   {
+      threads.emplace_back([this, t, msgSize] () {
+         char buf[msgSize];
+
+         for (unsigned i = 0; i < numMsgs; i++)
+         {
+            memset(buf, 'a' + t, sizeof(buf));
+            memcpy(buf, &t, sizeof(t));
+            memcpy(buf + sizeof(t), &i, sizeof(i));
+
+            // (like the file event logger)
+            while (! pmq_enqueue_msg(q, buf, sizeof(buf)))
+               pmq_sync(q);
+         }
+      });
+   }
+
+   for (auto& thread : threads)
+      thread.join();
+
+   ASSERT_TRUE(pmq_sync(q));
+
+   PMQ_Stats stats;
+   pmq_get_stats(q, &stats);
+
+   ASSERT_GT(stats.enqueuer.padded_reservations, 0u);
+   ASSERT_EQ(stats.enqueuer.total_messages_enqueued, uint64_t(numThreads) * numMsgs);
+
+   // read back what is still stored. each producer's messages must be complete and in order.
+   PMQ_Reader* reader = pmq_reader_create(q);
+   ASSERT_NE(reader, nullptr);
+
+   const PMQ_Persist_Info persistInfo = pmq_get_persist_info(q);
+   ASSERT_EQ(persistInfo.wal_msn, uint64_t(numThreads) * numMsgs);
+
+   ASSERT_EQ(pmq_reader_seek_to_msg(reader, persistInfo.wal_msn - 100000),
+      PMQ_Read_Result_Success);
+
+   std::vector<int64_t> lastMsg(numThreads, -1);
+   uint64_t numRead = 0;
+   char buf[1024];
+   size_t size;
+   PMQ_Read_Result readRes;
+
+   for (;;)
+   {
+      readRes = pmq_read_msg(reader, buf, sizeof(buf), &size);
+
+      if (readRes == PMQ_Read_Result_EOF && numRead < 100000)
+      { // end of the chunk store, continue in the slots file
+         ASSERT_EQ(pmq_reader_seek_to_msg(reader, pmq_reader_get_current_msn(reader) ),
+            PMQ_Read_Result_Success);
+         continue;
+      }
+
+      if (readRes != PMQ_Read_Result_Success)
+         break;
+
+      unsigned t;
+      unsigned i;
+
+      ASSERT_EQ(size, msgSize);
+
+      memcpy(&t, buf, sizeof(t));
+      memcpy(&i, buf + sizeof(t), sizeof(i));
+
+      ASSERT_LT(t, numThreads);
+      ASSERT_EQ(buf[size - 1], char('a' + t));
+
+      if (lastMsg[t] >= 0)
+      {
+         ASSERT_EQ(int64_t(i), lastMsg[t] + 1);
+      }
+
+      lastMsg[t] = i;
+      numRead++;
+   }
+
+   ASSERT_EQ(readRes, PMQ_Read_Result_EOF);
+   ASSERT_EQ(numRead, 100000u);
+
+   // (threads that finished early have no messages in the range)
+   for (unsigned t = 0; t < numThreads; t++)
+   {
+      if (lastMsg[t] >= 0)
+      {
+         ASSERT_EQ(lastMsg[t], int64_t(numMsgs) - 1);
+      }
+   }
+
+   pmq_reader_destroy(reader);
+
+   ASSERT_EQ(remainingFailures, 0u);
+   pmq_set_persist_hook(q, nullptr, nullptr);
+
+   // the enqueuer still works
+   ASSERT_TRUE(pmq_enqueue_msg(q, buf, 10));
+}
@@ -0,0 +1,125 @@
+#include <components/buddyresyncer/ResyncJournal.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <fstream>
+
+class TestResyncJournal : public ::testing::Test
+{
+   protected:
+      std::string dir;
+
+      void SetUp() override
+      {
+         char dirTemplate[] = "/tmp/beegfs-resync-journal-XXXXXX";
+
+         ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+         dir = dirTemplate;
+      }
+
+      void TearDown() override
+      {
+         unlink((dir + "/.buddyresyncjournal").c_str());
+         rmdir(dir.c_str());
+      }
+
+      static std::vector<MetaSyncCandidateFile::Element> changeSet(const std::string& inode,
+         const std::string& dentry, bool isDeletion)
+      {
+         return {
+            {inode, MetaSyncFileType::Inode, isDeletion},
+            {dentry, MetaSyncFileType::Dentry, isDeletion},
+         };
+      }
+};
+
+TEST_F(TestResyncJournal, newJournalIsInvalid)
+{
+   ResyncJournal journal(dir, 10);
+   std::vector<MetaSyncCandidateFile::Element> entries;
+
+   // we cannot know what the buddy missed before the journal was created
+   ASSERT_FALSE(journal.getIsValid());
+   ASSERT_FALSE(journal.getEntries(entries));
+
+   journal.record(changeSet("buddymir/inodes/1/2/A", "buddymir/dentries/3/4/B/a", false));
+   ASSERT_EQ(journal.getNumEntries(), 0u);
+}
+
+TEST_F(TestResyncJournal, recordAndReload)
+{
+   {
+      ResyncJournal journal(dir, 10);
+
+      journal.reset();
+      journal.record(changeSet("buddymir/inodes/1/2/A", "buddymir/dentries/3/4/B/a", false));
+      journal.record(changeSet("buddymir/inodes/1/2/A", "buddymir/dentries/3/4/B/a", false));
+      journal.record(changeSet("buddymir/inodes/5/6/C", "buddymir/dentries/3/4/B/c", true));
+
+      ASSERT_EQ(journal.getNumEntries(), 4u);
+   }
+
+   ResyncJournal journal(dir, 10);
+   std::vector<MetaSyncCandidateFile::Element> entries;
+
+   ASSERT_TRUE(journal.getEntries(entries));
+   ASSERT_EQ(entries.size(), 4u);
+
+   unsigned numDeletions = 0;
+   for (auto it = entries.begin(); it != entries.end(); ++it)
+      numDeletions += it->isDeletion;
+
+   ASSERT_EQ(numDeletions, 2u);
+}
+
+TEST_F(TestResyncJournal, uncleanShutdownInvalidates)
+{
+   ResyncJournal journal(dir, 10);
+
+   journal.reset();
+   journal.record(changeSet("buddymir/inodes/1/2/A", "buddymir/dentries/3/4/B/a", false));
+
+   // open a copy of the journal while the original is in use, as if we had crashed
+   char copyTemplate[] = "/tmp/beegfs-resync-journal-XXXXXX";
+   ASSERT_NE(mkdtemp(copyTemplate), nullptr);
+
+   const std::string copyDir = copyTemplate;
+
+   {
+      std::ifstream src(dir + "/.buddyresyncjournal", std::ios::binary);
+      std::ofstream dst(copyDir + "/.buddyresyncjournal", std::ios::binary);
+      dst << src.rdbuf();
+   }
+
+   {
+      ResyncJournal copy(copyDir, 10);
+      ASSERT_FALSE(copy.getIsValid());
+   }
+
+   unlink((copyDir + "/.buddyresyncjournal").c_str());
+   rmdir(copyDir.c_str());
+}
+
+TEST_F(TestResyncJournal, overflowInvalidates)
+{
+   {
+      ResyncJournal journal(dir, 3);
+
+      journal.reset();
+      journal.record(changeSet("buddymir/inodes/1/2/A", "buddymir/dentries/3/4/B/a", false));
+      ASSERT_TRUE(journal.getIsValid());
+
+      journal.record(changeSet("buddymir/inodes/5/6/C", "buddymir/dentries/3/4/B/c", false));
+      ASSERT_FALSE(journal.getIsValid());
+      ASSERT_EQ(journal.getNumEntries(), 0u);
+   }
+
+   // stays invalid across restarts until the next complete resync
+   ResyncJournal journal(dir, 3);
+   ASSERT_FALSE(journal.getIsValid());
+
+   journal.reset();
+   ASSERT_TRUE(journal.getIsValid());
+   ASSERT_EQ(journal.getNumEntries(), 0u);
+}
@@ -0,0 +1,175 @@
+#include <common/nodes/TargetCapacityPools.h>
+#include <common/nodes/TargetMapper.h>
+#include <nodes/TargetLoadStore.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+class TestTargetLoadStore : public ::testing::Test
+{
+   protected:
+      TargetMapper targetMapper;
+
+      // node 1 has targets 1 and 2, node 2 has target 3, node 3 has target 4
+      void SetUp() override
+      {
+         targetMapper.mapTarget(1, NumNodeID(1), StoragePoolId(1) );
+         targetMapper.mapTarget(2, NumNodeID(1), StoragePoolId(1) );
+         targetMapper.mapTarget(3, NumNodeID(2), StoragePoolId(1) );
+         targetMapper.mapTarget(4, NumNodeID(3), StoragePoolId(1) );
+      }
+
+      // one stats entry per second, like the storage servers collect them
+      static HighResStatsList makeStats(uint64_t startTimeMS, unsigned numSecs,
+         unsigned queuedRequests, uint64_t diskBytesPerSec)
+      {
+         HighResStatsList statsList;
+
+         for (unsigned i = 0; i < numSecs; i++)
+         {
+            HighResolutionStats stats;
+            HighResolutionStatsTk::resetStats(&stats);
+
+            stats.rawVals.statsTimeMS = startTimeMS + i * 1000;
+            stats.rawVals.queuedRequests = queuedRequests;
+            stats.incVals.diskReadBytes = diskBytesPerSec / 2;
+            stats.incVals.diskWriteBytes = diskBytesPerSec - diskBytesPerSec / 2;
+
+            statsList.push_back(stats);
+         }
+
+         return statsList;
+      }
+
+      static double weightOf(TargetLoadStore& store, uint16_t targetID)
+      {
+         const auto weights = store.getTargetWeights();
+         const auto iter = weights->find(targetID);
+
+         return iter == weights->end() ? -1 : iter->second;
+      }
+};
+
+TEST_F(TestTargetLoadStore, weights)
+{
+   TargetLoadStore store;
+
+   ASSERT_TRUE(store.getTargetWeights()->empty() );
+
+   // node 1 is idle, node 2 has twice the mean load
+   store.updateNodeLoad(NumNodeID(1), makeStats(1000, 5, 0, 0), 0);
+   store.updateNodeLoad(NumNodeID(2), makeStats(1000, 5, 10, 100 << 20), 10);
+   store.updateTargetWeights(&targetMapper);
+
+   // all targets of a node get the weight of the node
+   ASSERT_DOUBLE_EQ(weightOf(store, 1), 1);
+   ASSERT_DOUBLE_EQ(weightOf(store, 2), 1);
+   ASSERT_DOUBLE_EQ(weightOf(store, 3), 1.0 / 9);
+
+   // node 3 has no known load, so the chooser treats its target as average
+   ASSERT_EQ(weightOf(store, 4), -1);
+
+   // all idle => all average
+   TargetLoadStore idleStore;
+
+   for (unsigned nodeID = 1; nodeID <= 3; nodeID++)
+      idleStore.updateNodeLoad(NumNodeID(nodeID), makeStats(1000, 5, 0, 0), 0);
+
+   idleStore.updateTargetWeights(&targetMapper);
+
+   for (uint16_t targetID = 1; targetID <= 4; targetID++)
+      ASSERT_DOUBLE_EQ(weightOf(idleStore, targetID), 0.25) << targetID;
+}
+
+TEST_F(TestTargetLoadStore, smoothingAndStatsTime)
+{
+   TargetLoadStore store;
+
+   ASSERT_EQ(store.getLastStatsTimeMS(NumNodeID(1) ), 0u);
+
+   store.updateNodeLoad(NumNodeID(1), makeStats(1000, 3, 0, 0), 0);
+   store.updateNodeLoad(NumNodeID(2), makeStats(1000, 3, 10, 1000), 0);
+
+   ASSERT_EQ(store.getLastStatsTimeMS(NumNodeID(1) ), 3000u);
+
+   // a single busy sample only moves the average a bit
+   store.updateNodeLoad(NumNodeID(1), makeStats(4000, 1, 10, 1000), 0);
+   store.updateTargetWeights(&targetMapper);
+
+   ASSERT_EQ(store.getLastStatsTimeMS(NumNodeID(1) ), 4000u);
+   ASSERT_GT(weightOf(store, 1), weightOf(store, 3) );
+
+   // without new stats, the queue length of the reply is used and the disk load is kept
+   store.updateNodeLoad(NumNodeID(1), {}, 1000);
+   store.updateTargetWeights(&targetMapper);
+
+   ASSERT_EQ(store.getLastStatsTimeMS(NumNodeID(1) ), 4000u);
+   ASSERT_LT(weightOf(store, 1), weightOf(store, 3) );
+}
+
+TEST_F(TestTargetLoadStore, expiry)
+{
+   TargetLoadStore store(50);
+
+   store.updateNodeLoad(NumNodeID(1), makeStats(1000, 5, 0, 0), 0);
+   store.updateNodeLoad(NumNodeID(2), makeStats(1000, 5, 10, 100 << 20), 10);
+   store.updateTargetWeights(&targetMapper);
+
+   ASSERT_DOUBLE_EQ(weightOf(store, 3), 1.0 / 9);
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(100) );
+
+   // node 2 could not be asked for its load anymore
+   store.updateNodeLoad(NumNodeID(1), makeStats(6000, 5, 0, 0), 0);
+   store.updateTargetWeights(&targetMapper);
+
+   ASSERT_EQ(weightOf(store, 3), -1);
+   ASSERT_EQ(store.getLastStatsTimeMS(NumNodeID(2) ), 0u);
+
+   // only node 1 is known, so it is average
+   ASSERT_DOUBLE_EQ(weightOf(store, 1), 0.25);
+
+   // nodes without targets are forgotten
+   targetMapper.unmapByNodeID(NumNodeID(1) );
+   store.updateTargetWeights(&targetMapper);
+
+   ASSERT_TRUE(store.getTargetWeights()->empty() );
+   ASSERT_EQ(store.getLastStatsTimeMS(NumNodeID(1) ), 0u);
+}
+
+TEST_F(TestTargetLoadStore, weightedChooser)
+{
+   TargetLoadStore store;
+   TargetCapacityPools pools(false, {0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0});
+
+   pools.addOrUpdate(1, NumNodeID(1), CapacityPool_NORMAL);
+   pools.addOrUpdate(3, NumNodeID(2), CapacityPool_NORMAL);
+
+   store.updateNodeLoad(NumNodeID(1), makeStats(1000, 5, 0, 0), 0);
+   store.updateNodeLoad(NumNodeID(2), makeStats(1000, 5, 10, 100 << 20), 10);
+   store.updateTargetWeights(&targetMapper);
+
+   const auto weights = store.getTargetWeights();
+   unsigned numIdle = 0;
+
+   for (int i = 0; i < 1000; i++)
+   {
+      UInt16Vector chosen;
+      pools.chooseStorageTargetsWeighted(1, 1, *weights, &chosen);
+
+      ASSERT_EQ(chosen.size(), 1u);
+      numIdle += chosen[0] == 1;
+   }
+
+   // expected: 900 (weights 1 and 1/9)
+   ASSERT_GT(numIdle, 800u);
+   ASSERT_LT(numIdle, 980u);
+
+   // both targets are still used for wide stripes
+   UInt16Vector chosen;
+   pools.chooseStorageTargetsWeighted(2, 2, *weights, &chosen);
+
+   ASSERT_EQ(chosen.size(), 2u);
+}
@@ -5,6 +5,7 @@
 #include <common/components/worker/DummyWork.h>
 #include <misc/Cassandra.h>
 #include <misc/InfluxDB.h>
+#include <misc/Prometheus.h>
 
 
 App::App(int argc, char** argv) :
@@ -146,6 +147,10 @@ void App::initDataObjects()
 
       tsdb = boost::make_unique<Cassandra>(std::move(cassandraConfig));
    }
+   else if (cfg->getDbType() == Config::DbTypes::PROMETHEUS)
+   {
+      tsdb = boost::make_unique<Prometheus>();
+   }
    else // Config::DbTypes::INFLUXDB OR Config::DbTypes::INFLUXDB2
    {
       InfluxDB::Config influxdbConfig;
@@ -179,6 +184,11 @@ void App::initComponents()
    nodeListRequestor = boost::make_unique<NodeListRequestor>(this);
    statsCollector = boost::make_unique<StatsCollector>(this);
    cleanUp = boost::make_unique<CleanUp>(this);
+
+   if (cfg->getDbType() == Config::DbTypes::PROMETHEUS)
+      metricsHttpServer = boost::make_unique<MetricsHttpServer>(this,
+            static_cast<Prometheus*>(tsdb.get()), cfg->getPrometheusListenPort(),
+            cfg->getHttpTimeout());
 }
 
 void App::startComponents()
@@ -187,6 +197,8 @@ void App::startComponents()
    nodeListRequestor->start();
    statsCollector->start();
    cleanUp->start();
+   if (metricsHttpServer)
+      metricsHttpServer->start();
    LOG(GENERAL, DEBUG, "Components running.");
 }
 
@@ -198,6 +210,8 @@ void App::stopComponents()
       statsCollector->selfTerminate();
    if (cleanUp)
       cleanUp->selfTerminate();
+   if (metricsHttpServer)
+      metricsHttpServer->selfTerminate();
 
    stopWorkers();
    selfTerminate();
@@ -209,6 +223,8 @@ void App::joinComponents()
    nodeListRequestor->join();
    statsCollector->join();
    cleanUp->join();
+   if (metricsHttpServer)
+      metricsHttpServer->join();
    LOG(GENERAL, CRITICAL, "All components stopped. Exiting now.");
 }
 
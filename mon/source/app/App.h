@@ -14,6 +14,7 @@
 #include <common/toolkit/NodesTk.h>
 #include <misc/TSDatabase.h>
 #include <components/CleanUp.h>
+#include <components/MetricsHttpServer.h>
 #include <components/StatsCollector.h>
 #include <components/NodeListRequestor.h>
 #include <net/message/NetMessageFactory.h>
@@ -67,6 +68,7 @@ class App : public AbstractApp
       std::unique_ptr<NodeListRequestor> nodeListRequestor;
       std::unique_ptr<StatsCollector> statsCollector;
       std::unique_ptr<CleanUp> cleanUp;
+      std::unique_ptr<MetricsHttpServer> metricsHttpServer; // only for the prometheus backend
 
       std::list<std::unique_ptr<Worker>> workerList;
 
@@ -72,6 +72,8 @@ void Config::loadDefaults(bool addDashes)
    configMapRedefine("cassandraMaxInsertsPerBatch","25");
    configMapRedefine("cassandraTTLSecs", "86400");
 
+   configMapRedefine("prometheusListenPort",       "9110");
+
    configMapRedefine("collectClientOpsByNode",     "true");
    configMapRedefine("collectClientOpsByUser",     "true");
 
@@ -127,9 +129,11 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
             dbType = DbTypes::INFLUXDB2;
          else if (iter->second == "cassandra")
             dbType = DbTypes::CASSANDRA;
+         else if (iter->second == "prometheus")
+            dbType = DbTypes::PROMETHEUS;
          else
             throw InvalidConfigException("The value of config argument dbType is invalid:"
-                  " Must be influxdb or cassandra.");
+                  " Must be influxdb, influxdb2, cassandra or prometheus.");
       }
       else
       if (iter->first == std::string("dbHostName"))
@@ -165,6 +169,9 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
       if (iter->first == std::string("cassandraTTLSecs"))
          cassandraTTLSecs = StringTk::strToUInt(iter->second);
       else
+      if (iter->first == std::string("prometheusListenPort"))
+         prometheusListenPort = StringTk::strToUInt(iter->second);
+      else
       if (iter->first == std::string("collectClientOpsByNode"))
          collectClientOpsByNode = StringTk::strToBool(iter->second);
       else
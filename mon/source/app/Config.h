@@ -13,7 +13,8 @@ class Config : public AbstractConfig
       {
          INFLUXDB,
          INFLUXDB2,
-         CASSANDRA
+         CASSANDRA,
+         PROMETHEUS
       };
 
    private:
@@ -35,6 +36,7 @@ class Config : public AbstractConfig
       std::string influxdbRetentionDuration;
       unsigned cassandraMaxInsertsPerBatch;
       unsigned cassandraTTLSecs;
+      unsigned prometheusListenPort;
       bool collectClientOpsByNode;
       bool collectClientOpsByUser;
       std::chrono::milliseconds httpTimeout;
@@ -125,6 +127,11 @@ class Config : public AbstractConfig
          return cassandraTTLSecs;
       }
 
+      unsigned getPrometheusListenPort() const
+      {
+         return prometheusListenPort;
+      }
+
       bool getCollectClientOpsByNode() const
       {
          return collectClientOpsByNode;
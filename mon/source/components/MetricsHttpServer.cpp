@@ -0,0 +1,201 @@
+#include "MetricsHttpServer.h"
+
+#include <app/App.h>
+#include <common/components/ComponentInitException.h>
+#include <misc/Prometheus.h>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+// requests with a longer header are rejected
+#define METRICSHTTPSERVER_MAX_REQUEST_SIZE  8192
+#define METRICSHTTPSERVER_POLL_TIMEOUT_MS   1000
+
+#define METRICSHTTPSERVER_CONTENTTYPE_OPENMETRICS \
+   "application/openmetrics-text; version=1.0.0; charset=utf-8"
+#define METRICSHTTPSERVER_CONTENTTYPE_TEXT \
+   "text/plain; version=0.0.4; charset=utf-8"
+
+
+/**
+ * Opens the listen socket right away, so that an unusable port is reported at startup.
+ *
+ * @throw ComponentInitException if the socket could not be opened
+ */
+MetricsHttpServer::MetricsHttpServer(App* app, Prometheus* prometheus, unsigned short port,
+      std::chrono::milliseconds timeout) :
+   PThread("MetricsHttp"), app(app), prometheus(prometheus), timeout(timeout)
+{
+   const int one = 1;
+   const int zero = 0;
+
+   // prefer a dual stack socket, fall back to IPv4 if IPv6 is unavailable
+   listenFD = socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0);
+   if (listenFD != -1)
+   {
+      struct sockaddr_in6 addr = {};
+      addr.sin6_family = AF_INET6;
+      addr.sin6_addr = in6addr_any;
+      addr.sin6_port = htons(port);
+
+      setsockopt(listenFD, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero) );
+      setsockopt(listenFD, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one) );
+
+      if (bind(listenFD, (struct sockaddr*)&addr, sizeof(addr) ) )
+         throw ComponentInitException("Unable to bind metrics port " +
+               StringTk::uintToStr(port) + ": " + System::getErrString() );
+   }
+   else
+   {
+      listenFD = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      if (listenFD == -1)
+         throw ComponentInitException("Unable to create metrics socket: " +
+               System::getErrString() );
+
+      struct sockaddr_in addr = {};
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_ANY);
+      addr.sin_port = htons(port);
+
+      setsockopt(listenFD, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one) );
+
+      if (bind(listenFD, (struct sockaddr*)&addr, sizeof(addr) ) )
+         throw ComponentInitException("Unable to bind metrics port " +
+               StringTk::uintToStr(port) + ": " + System::getErrString() );
+   }
+
+   if (listen(listenFD, SOMAXCONN) )
+      throw ComponentInitException("Unable to listen on metrics port " +
+            StringTk::uintToStr(port) + ": " + System::getErrString() );
+}
+
+MetricsHttpServer::~MetricsHttpServer()
+{
+   if (listenFD != -1)
+      close(listenFD);
+}
+
+void MetricsHttpServer::run()
+{
+   try
+   {
+      LOG(GENERAL, DEBUG, "Component started.");
+      registerSignalHandler();
+      listenLoop();
+      LOG(GENERAL, DEBUG, "Component stopped.");
+   }
+   catch (std::exception& e)
+   {
+      app->handleComponentException(e);
+   }
+}
+
+void MetricsHttpServer::listenLoop()
+{
+   struct pollfd pollFD = { listenFD, POLLIN, 0 };
+
+   while (!getSelfTerminate() )
+   {
+      const int pollRes = poll(&pollFD, 1, METRICSHTTPSERVER_POLL_TIMEOUT_MS);
+      if (pollRes <= 0)
+         continue; // timeout or interrupted
+
+      const int fd = accept4(listenFD, NULL, NULL, SOCK_CLOEXEC);
+      if (fd == -1)
+         continue;
+
+      // a scraper that stops reading must not stall the server
+      struct timeval tv;
+      tv.tv_sec = timeout.count() / 1000;
+      tv.tv_usec = (timeout.count() % 1000) * 1000;
+
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv) );
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv) );
+
+      try
+      {
+         handleConnection(fd);
+      }
+      catch (const std::runtime_error& e)
+      {
+         LOG(GENERAL, DEBUG, "Metrics request failed.", ("Error", e.what()));
+      }
+
+      close(fd);
+   }
+}
+
+void MetricsHttpServer::handleConnection(int fd)
+{
+   std::string request;
+   char buf[1024];
+
+   while (request.find("\r\n\r\n") == std::string::npos)
+   {
+      if (request.size() > METRICSHTTPSERVER_MAX_REQUEST_SIZE)
+         throw std::runtime_error("Request too large");
+
+      const ssize_t recvRes = recv(fd, buf, sizeof(buf), 0);
+      if (recvRes <= 0)
+         throw std::runtime_error("Connection closed while receiving request");
+
+      request.append(buf, recvRes);
+   }
+
+   // request line: <method> <target> <version>
+   const size_t methodEnd = request.find(' ');
+   const size_t targetEnd = request.find(' ', methodEnd + 1);
+   const std::string method = request.substr(0, methodEnd);
+   std::string target = (methodEnd == std::string::npos || targetEnd == std::string::npos) ?
+         std::string() : request.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+
+   target = target.substr(0, target.find('?') );
+
+   if (method != "GET")
+   {
+      static const char response[] = "HTTP/1.1 405 Method Not Allowed\r\n"
+            "Allow: GET\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+      sendAll(fd, response, sizeof(response) - 1);
+      return;
+   }
+
+   if (target != "/metrics")
+   {
+      static const char response[] = "HTTP/1.1 404 Not Found\r\n"
+            "Content-Length: 0\r\nConnection: close\r\n\r\n";
+      sendAll(fd, response, sizeof(response) - 1);
+      return;
+   }
+
+   // Prometheus asks for OpenMetrics in the Accept header if it supports it
+   const bool openMetrics = request.find("application/openmetrics-text") != std::string::npos;
+
+   const std::string header = std::string("HTTP/1.1 200 OK\r\nContent-Type: ") +
+         (openMetrics ?
+               METRICSHTTPSERVER_CONTENTTYPE_OPENMETRICS : METRICSHTTPSERVER_CONTENTTYPE_TEXT) +
+         "\r\nConnection: close\r\n\r\n";
+
+   sendAll(fd, header.data(), header.size() );
+
+   prometheus->render(
+         [fd] (const char* data, size_t len) { sendAll(fd, data, len); },
+         openMetrics);
+}
+
+/**
+ * @throw std::runtime_error if sending failed or timed out
+ */
+void MetricsHttpServer::sendAll(int fd, const char* data, size_t len)
+{
+   while (len)
+   {
+      const ssize_t sendRes = send(fd, data, len, MSG_NOSIGNAL);
+      if (sendRes <= 0)
+         throw std::runtime_error("Send failed: " + System::getErrString() );
+
+      data += sendRes;
+      len -= sendRes;
+   }
+}
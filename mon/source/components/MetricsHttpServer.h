@@ -0,0 +1,36 @@
+#ifndef METRICSHTTPSERVER_H_
+#define METRICSHTTPSERVER_H_
+
+#include <common/threading/PThread.h>
+
+#include <chrono>
+
+class App;
+class Prometheus;
+
+/**
+ * Minimal HTTP server that answers "GET /metrics" with the samples of the Prometheus TSDB backend.
+ * Requests are served one after another by this thread, which is fine for the few scrapers that
+ * usually poll an exporter. The response is streamed while it is rendered and ends by closing the
+ * connection, so it is never built completely in memory.
+ */
+class MetricsHttpServer : public PThread
+{
+   public:
+      MetricsHttpServer(App* app, Prometheus* prometheus, unsigned short port,
+            std::chrono::milliseconds timeout);
+      ~MetricsHttpServer();
+
+   private:
+      App* const app;
+      Prometheus* const prometheus;
+      const std::chrono::milliseconds timeout;
+      int listenFD;
+
+      virtual void run() override;
+      void listenLoop();
+      void handleConnection(int fd);
+      static void sendAll(int fd, const char* data, size_t len);
+};
+
+#endif /* METRICSHTTPSERVER_H_ */
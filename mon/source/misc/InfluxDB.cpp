@@ -166,6 +166,20 @@ void InfluxDB::insertStorageTargetsData(std::shared_ptr<Node> node,
 
    point << ",targetConsistencyState=\"" << t << "\"";
 
+   if (data.getHasWritebackStats() )
+   {
+      const StorageTargetInfo::WritebackStats& writeback = data.getWritebackStats();
+
+      point << ",writebackSyncWindow=" << writeback.syncWindow;
+      point << ",writebackStartThreshold=" << writeback.startThreshold;
+      point << ",writebackDecision=\"" <<
+         StorageTargetInfo::WritebackStats::decisionToStr(writeback.lastDecision) << "\"";
+      point << ",writebackWrites=" << writeback.numWrites;
+      point << ",writebackStalls=" << writeback.numStalls;
+      point << ",writebackSubmits=" << writeback.numSubmits;
+      point << ",writebackSubmittedBytes=" << writeback.submittedBytes;
+   }
+
    appendPoint(point.str());
 }
 
@@ -0,0 +1,445 @@
+#include "Prometheus.h"
+
+#include <common/storage/StorageTargetInfo.h>
+#include <common/toolkit/StringTk.h>
+#include <exception/DatabaseException.h>
+
+#include <charconv>
+#include <cstring>
+
+// output is handed to the OutputFunc in parts of this size
+#define PROMETHEUS_RENDER_BUF_SIZE  (64*1024)
+
+
+const Prometheus::FamilyDesc Prometheus::familyDescs[Family_NUMFAMILIES] =
+{
+   { "beegfs_meta_responding", "Whether the meta node answered the last stats request.", false },
+   { "beegfs_meta_indirect_work_list_size", "Queued requests for indirect workers.", false },
+   { "beegfs_meta_direct_work_list_size", "Queued requests for direct workers.", false },
+   { "beegfs_meta_sessions", "Number of client sessions.", false },
+   { "beegfs_meta_host", "Host of the meta node, value is always 1.", false },
+   { "beegfs_meta_work_requests", "Finished work requests.", true },
+   { "beegfs_meta_queued_requests", "Queued requests at the time of the last sample.", false },
+   { "beegfs_meta_net_send_bytes", "Bytes sent over the network.", true },
+   { "beegfs_meta_net_recv_bytes", "Bytes received over the network.", true },
+
+   { "beegfs_storage_responding", "Whether the storage node answered the last stats request.",
+      false },
+   { "beegfs_storage_indirect_work_list_size", "Queued requests for indirect workers.", false },
+   { "beegfs_storage_direct_work_list_size", "Queued requests for direct workers.", false },
+   { "beegfs_storage_sessions", "Number of client sessions.", false },
+   { "beegfs_storage_disk_space_total_bytes", "Total disk space of all targets.", false },
+   { "beegfs_storage_disk_space_free_bytes", "Free disk space of all targets.", false },
+   { "beegfs_storage_host", "Host of the storage node, value is always 1.", false },
+   { "beegfs_storage_work_requests", "Finished work requests.", true },
+   { "beegfs_storage_queued_requests", "Queued requests at the time of the last sample.", false },
+   { "beegfs_storage_disk_write_bytes", "Bytes written to disk.", true },
+   { "beegfs_storage_disk_read_bytes", "Bytes read from disk.", true },
+   { "beegfs_storage_net_send_bytes", "Bytes sent over the network.", true },
+   { "beegfs_storage_net_recv_bytes", "Bytes received over the network.", true },
+
+   { "beegfs_storage_target_space_total_bytes", "Total disk space of the target.", false },
+   { "beegfs_storage_target_space_free_bytes", "Free disk space of the target.", false },
+   { "beegfs_storage_target_inodes_total", "Total number of inodes of the target.", false },
+   { "beegfs_storage_target_inodes_free", "Free inodes of the target.", false },
+   { "beegfs_storage_target_consistency_state", "Consistency state of the target, value is "
+      "always 1.", false },
+   { "beegfs_storage_target_writeback_sync_window_bytes", "Amount of sequentially written data "
+      "that is submitted for writeback at once.", false },
+   { "beegfs_storage_target_writeback_start_threshold_bytes", "Amount of unsubmitted written "
+      "data from which on writes are submitted for writeback.", false },
+   { "beegfs_storage_target_writeback_decision", "Last adaption of the writeback, value is "
+      "always 1.", false },
+   { "beegfs_storage_target_writeback_writes", "Writes seen by the writeback controller.", true },
+   { "beegfs_storage_target_writeback_stalls", "Writes that were throttled by the page cache.",
+      true },
+   { "beegfs_storage_target_writeback_submits", "Submissions for writeback.", true },
+   { "beegfs_storage_target_writeback_submitted_bytes", "Bytes submitted for writeback.", true },
+
+   { "beegfs_meta_client_ops_by_node", "Meta operations by client node.", true },
+   { "beegfs_meta_client_ops_by_user", "Meta operations by user.", true },
+   { "beegfs_storage_client_ops_by_node", "Storage operations by client node.", true },
+   { "beegfs_storage_client_ops_by_user", "Storage operations by user.", true },
+};
+
+Prometheus::Prometheus() :
+   pending(new Snapshot() ),
+   snapshot(std::make_shared<Snapshot>() )
+{
+}
+
+void Prometheus::insertMetaNodeData(std::shared_ptr<Node> node, const MetaNodeDataContent& data)
+{
+   const std::string labels = makeNodeLabels(*node);
+
+   const std::lock_guard<Mutex> mutexLock(pendingMutex);
+
+   pendingMetaNodes.insert(labels);
+
+   setGauge(Family_META_RESPONDING, labels, data.isResponding);
+
+   if (!data.isResponding)
+      return;
+
+   setGauge(Family_META_INDIRECT_WORK_LIST_SIZE, labels, data.indirectWorkListSize);
+   setGauge(Family_META_DIRECT_WORK_LIST_SIZE, labels, data.directWorkListSize);
+   setGauge(Family_META_SESSIONS, labels, data.sessionCount);
+   setGauge(Family_META_HOST,
+         labels + ",hostnameid=\"" + escapeLabelValue(data.hostnameid) + "\"", 1);
+}
+
+void Prometheus::insertStorageNodeData(std::shared_ptr<Node> node,
+      const StorageNodeDataContent& data)
+{
+   const std::string labels = makeNodeLabels(*node);
+
+   const std::lock_guard<Mutex> mutexLock(pendingMutex);
+
+   pendingStorageNodes.insert(labels);
+
+   setGauge(Family_STORAGE_RESPONDING, labels, data.isResponding);
+
+   if (!data.isResponding)
+      return;
+
+   setGauge(Family_STORAGE_INDIRECT_WORK_LIST_SIZE, labels, data.indirectWorkListSize);
+   setGauge(Family_STORAGE_DIRECT_WORK_LIST_SIZE, labels, data.directWorkListSize);
+   setGauge(Family_STORAGE_SESSIONS, labels, data.sessionCount);
+   setGauge(Family_STORAGE_DISK_SPACE_TOTAL, labels, data.diskSpaceTotal);
+   setGauge(Family_STORAGE_DISK_SPACE_FREE, labels, data.diskSpaceFree);
+   setGauge(Family_STORAGE_HOST,
+         labels + ",hostnameid=\"" + escapeLabelValue(data.hostnameid) + "\"", 1);
+}
+
+void Prometheus::insertHighResMetaNodeData(std::shared_ptr<Node> node,
+      const HighResolutionStats& data)
+{
+   const std::string labels = makeNodeLabels(*node);
+
+   const std::lock_guard<Mutex> mutexLock(pendingMutex);
+
+   // samples of a node come in chronological order, so the last one wins for gauges
+   setGauge(Family_META_QUEUED_REQUESTS, labels, data.rawVals.queuedRequests);
+
+   addToCounter(Family_META_WORK_REQUESTS, labels, data.incVals.workRequests);
+   addToCounter(Family_META_NET_SEND_BYTES, labels, data.incVals.netSendBytes);
+   addToCounter(Family_META_NET_RECV_BYTES, labels, data.incVals.netRecvBytes);
+}
+
+void Prometheus::insertHighResStorageNodeData(std::shared_ptr<Node> node,
+      const HighResolutionStats& data)
+{
+   const std::string labels = makeNodeLabels(*node);
+
+   const std::lock_guard<Mutex> mutexLock(pendingMutex);
+
+   setGauge(Family_STORAGE_QUEUED_REQUESTS, labels, data.rawVals.queuedRequests);
+
+   addToCounter(Family_STORAGE_WORK_REQUESTS, labels, data.incVals.workRequests);
+   addToCounter(Family_STORAGE_DISK_WRITE_BYTES, labels, data.incVals.diskWriteBytes);
+   addToCounter(Family_STORAGE_DISK_READ_BYTES, labels, data.incVals.diskReadBytes);
+   addToCounter(Family_STORAGE_NET_SEND_BYTES, labels, data.incVals.netSendBytes);
+   addToCounter(Family_STORAGE_NET_RECV_BYTES, labels, data.incVals.netRecvBytes);
+}
+
+void Prometheus::insertStorageTargetsData(std::shared_ptr<Node> node,
+      const StorageTargetInfo& data)
+{
+   const std::string labels = makeNodeLabels(*node) +
+         ",storageTargetID=\"" + StringTk::uintToStr(data.getTargetID() ) + "\"";
+
+   std::string state;
+   if (data.getState() == TargetConsistencyState::TargetConsistencyState_GOOD)
+      state = "GOOD";
+   else if (data.getState() == TargetConsistencyState::TargetConsistencyState_NEEDS_RESYNC)
+      state = "NEEDS_RESYNC";
+   else
+      state = "BAD";
+
+   const std::lock_guard<Mutex> mutexLock(pendingMutex);
+
+   setGauge(Family_TARGET_SPACE_TOTAL, labels, data.getDiskSpaceTotal() );
+   setGauge(Family_TARGET_SPACE_FREE, labels, data.getDiskSpaceFree() );
+   setGauge(Family_TARGET_INODES_TOTAL, labels, data.getInodesTotal() );
+   setGauge(Family_TARGET_INODES_FREE, labels, data.getInodesFree() );
+   setGauge(Family_TARGET_CONSISTENCY_STATE, labels + ",state=\"" + state + "\"", 1);
+
+   if (!data.getHasWritebackStats() )
+      return;
+
+   const StorageTargetInfo::WritebackStats& writeback = data.getWritebackStats();
+
+   setGauge(Family_TARGET_WRITEBACK_SYNC_WINDOW, labels, writeback.syncWindow);
+   setGauge(Family_TARGET_WRITEBACK_START_THRESHOLD, labels, writeback.startThreshold);
+   setGauge(Family_TARGET_WRITEBACK_DECISION, labels + ",decision=\"" +
+      StorageTargetInfo::WritebackStats::decisionToStr(writeback.lastDecision) + "\"", 1);
+
+   setCounter(Family_TARGET_WRITEBACK_WRITES, labels, writeback.numWrites);
+   setCounter(Family_TARGET_WRITEBACK_STALLS, labels, writeback.numStalls);
+   setCounter(Family_TARGET_WRITEBACK_SUBMITS, labels, writeback.numSubmits);
+   setCounter(Family_TARGET_WRITEBACK_SUBMITTED_BYTES, labels, writeback.submittedBytes);
+}
+
+void Prometheus::insertClientNodeData(const std::string& id, const NodeType nodeType,
+      const std::map<std::string, uint64_t>& opMap, bool perUser)
+{
+   FamilyIndex family;
+
+   if (nodeType == NODETYPE_Meta)
+      family = perUser ? Family_META_CLIENT_OPS_BY_USER : Family_META_CLIENT_OPS_BY_NODE;
+   else if (nodeType == NODETYPE_Storage)
+      family = perUser ? Family_STORAGE_CLIENT_OPS_BY_USER : Family_STORAGE_CLIENT_OPS_BY_NODE;
+   else
+      throw DatabaseException("Invalid Nodetype given.");
+
+   const std::string idLabel =
+         std::string(perUser ? "user=\"" : "node=\"") + escapeLabelValue(id) + "\"";
+
+   const std::lock_guard<Mutex> mutexLock(pendingMutex);
+
+   pendingClients[family].insert(idLabel);
+
+   for (auto iter = opMap.begin(); iter != opMap.end(); iter++)
+   {
+      if (iter->second == 0)
+         continue;
+
+      addToCounter(family, idLabel + ",op=\"" + escapeLabelValue(iter->first) + "\"",
+            iter->second);
+   }
+}
+
+/**
+ * Publishes the samples of the current round for the next scrapes.
+ */
+void Prometheus::write()
+{
+   std::shared_ptr<const Snapshot> newSnapshot;
+
+   {
+      const std::lock_guard<Mutex> mutexLock(pendingMutex);
+
+      // nodes that are gone from the node lists would otherwise be reported forever
+      pruneCounters(Family_META_WORK_REQUESTS, pendingMetaNodes);
+      pruneCounters(Family_META_NET_SEND_BYTES, pendingMetaNodes);
+      pruneCounters(Family_META_NET_RECV_BYTES, pendingMetaNodes);
+      pruneCounters(Family_STORAGE_WORK_REQUESTS, pendingStorageNodes);
+      pruneCounters(Family_STORAGE_DISK_WRITE_BYTES, pendingStorageNodes);
+      pruneCounters(Family_STORAGE_DISK_READ_BYTES, pendingStorageNodes);
+      pruneCounters(Family_STORAGE_NET_SEND_BYTES, pendingStorageNodes);
+      pruneCounters(Family_STORAGE_NET_RECV_BYTES, pendingStorageNodes);
+      pruneClientCounters(Family_META_CLIENT_OPS_BY_NODE);
+      pruneClientCounters(Family_META_CLIENT_OPS_BY_USER);
+      pruneClientCounters(Family_STORAGE_CLIENT_OPS_BY_NODE);
+      pruneClientCounters(Family_STORAGE_CLIENT_OPS_BY_USER);
+
+      // (next to the counters that were set in this round)
+      for (int i = 0; i < Family_NUMFAMILIES; i++)
+      {
+         if (familyDescs[i].isCounter)
+            pending->families[i].insert(counters[i].begin(), counters[i].end() );
+      }
+
+      newSnapshot = std::move(pending);
+      pending.reset(new Snapshot() );
+      pendingMetaNodes.clear();
+      pendingStorageNodes.clear();
+   }
+
+   const std::lock_guard<Mutex> mutexLock(snapshotMutex);
+   snapshot = std::move(newSnapshot);
+
+   LOG(DATABASE, DEBUG, "Published new samples for scraping.");
+}
+
+/**
+ * Renders the last published snapshot in the Prometheus text format (version 0.0.4) or in the
+ * OpenMetrics text format.
+ *
+ * @param output called for every PROMETHEUS_RENDER_BUF_SIZE bytes of output (and the remainder),
+ *    may throw to abort rendering
+ * @param openMetrics true for OpenMetrics, false for the Prometheus text format
+ */
+void Prometheus::render(const OutputFunc& output, bool openMetrics) const
+{
+   std::shared_ptr<const Snapshot> currentSnapshot;
+
+   {
+      const std::lock_guard<Mutex> mutexLock(snapshotMutex);
+      currentSnapshot = snapshot;
+   }
+
+   std::unique_ptr<char[]> buf(new char[PROMETHEUS_RENDER_BUF_SIZE]);
+   size_t bufLen = 0;
+
+   auto append = [&] (const char* data, size_t len)
+   {
+      while (len)
+      {
+         const size_t copyLen = std::min(len, size_t(PROMETHEUS_RENDER_BUF_SIZE) - bufLen);
+
+         memcpy(buf.get() + bufLen, data, copyLen);
+         bufLen += copyLen;
+         data += copyLen;
+         len -= copyLen;
+
+         if (bufLen == PROMETHEUS_RENDER_BUF_SIZE)
+         {
+            output(buf.get(), bufLen);
+            bufLen = 0;
+         }
+      }
+   };
+
+   auto appendStr = [&] (const char* str)
+   {
+      append(str, strlen(str) );
+   };
+
+   for (int i = 0; i < Family_NUMFAMILIES; i++)
+   {
+      const FamilyDesc& desc = familyDescs[i];
+      const SeriesMap& series = currentSnapshot->families[i];
+
+      if (series.empty() )
+         continue;
+
+      const size_t nameLen = strlen(desc.name);
+
+      // OpenMetrics names the family without the suffix, the text format names it by the samples
+      const char* familySuffix = (desc.isCounter && !openMetrics) ? "_total" : "";
+
+      appendStr("# HELP ");
+      append(desc.name, nameLen);
+      appendStr(familySuffix);
+      appendStr(" ");
+      appendStr(desc.help);
+      appendStr("\n# TYPE ");
+      append(desc.name, nameLen);
+      appendStr(familySuffix);
+      appendStr(desc.isCounter ? " counter\n" : " gauge\n");
+
+      for (auto iter = series.begin(); iter != series.end(); iter++)
+      {
+         char valueBuf[24];
+         const auto convRes = std::to_chars(valueBuf, valueBuf + sizeof(valueBuf), iter->second);
+
+         append(desc.name, nameLen);
+
+         if (desc.isCounter)
+            appendStr("_total");
+
+         appendStr("{");
+         append(iter->first.data(), iter->first.size() );
+         appendStr("} ");
+         append(valueBuf, convRes.ptr - valueBuf);
+         appendStr("\n");
+      }
+   }
+
+   if (openMetrics)
+      appendStr("# EOF\n");
+
+   if (bufLen)
+      output(buf.get(), bufLen);
+}
+
+/**
+ * According to the OpenMetrics specification, backslash, double-quote and line feed need to be
+ * escaped in label values.
+ */
+std::string Prometheus::escapeLabelValue(const std::string& str)
+{
+   std::string result;
+   result.reserve(str.size() );
+
+   for (auto iter = str.begin(); iter != str.end(); iter++)
+   {
+      if (*iter == '\\')
+         result += "\\\\";
+      else if (*iter == '"')
+         result += "\\\"";
+      else if (*iter == '\n')
+         result += "\\n";
+      else
+         result += *iter;
+   }
+
+   return result;
+}
+
+/**
+ * Note: pendingMutex must be held by the caller.
+ */
+void Prometheus::setGauge(FamilyIndex family, const std::string& labels, uint64_t value)
+{
+   pending->families[family][labels] = value;
+}
+
+/**
+ * Note: pendingMutex must be held by the caller.
+ */
+void Prometheus::addToCounter(FamilyIndex family, const std::string& labels, uint64_t value)
+{
+   counters[family][labels] += value;
+}
+
+/**
+ * For counters that are reported as totals by the nodes. They are only reported as long as they
+ * are set in every round, like gauges.
+ *
+ * Note: pendingMutex must be held by the caller.
+ */
+void Prometheus::setCounter(FamilyIndex family, const std::string& labels, uint64_t value)
+{
+   pending->families[family][labels] = value;
+}
+
+/**
+ * Removes the counters of nodes that were not reported in the current round.
+ *
+ * Note: pendingMutex must be held by the caller.
+ */
+void Prometheus::pruneCounters(FamilyIndex family, const std::set<std::string>& nodes)
+{
+   SeriesMap& series = counters[family];
+
+   for (auto iter = series.begin(); iter != series.end(); )
+   {
+      if (nodes.count(iter->first) )
+         iter++;
+      else
+         iter = series.erase(iter);
+   }
+}
+
+/**
+ * Removes the client ops counters of clients (or users) that were not reported in the current
+ * round and starts a new round for the family.
+ *
+ * Note: pendingMutex must be held by the caller.
+ */
+void Prometheus::pruneClientCounters(FamilyIndex family)
+{
+   SeriesMap& series = counters[family];
+   std::set<std::string>& clients = pendingClients[family];
+
+   for (auto iter = series.begin(); iter != series.end(); )
+   {
+      // (an escaped label value can't contain ",op=\"", quotes in it are preceded by a backslash)
+      const std::string idLabel = iter->first.substr(0, iter->first.find(",op=\"") );
+
+      if (clients.count(idLabel) )
+         iter++;
+      else
+         iter = series.erase(iter);
+   }
+
+   clients.clear();
+}
+
+std::string Prometheus::makeNodeLabels(const Node& node)
+{
+   return "nodeID=\"" + escapeLabelValue(node.getAlias() ) + "\",nodeNumID=\"" +
+         node.getNumID().str() + "\"";
+}
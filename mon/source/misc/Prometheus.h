@@ -0,0 +1,143 @@
+#ifndef PROMETHEUS_H_
+#define PROMETHEUS_H_
+
+#include <common/nodes/NodeType.h>
+#include <common/threading/Mutex.h>
+#include <nodes/MetaNodeEx.h>
+#include <nodes/StorageNodeEx.h>
+#include <misc/TSDatabase.h>
+
+#include <functional>
+#include <map>
+#include <set>
+
+
+/**
+ * TSDatabase backend that doesn't push anywhere, but keeps the samples of the last collection
+ * round in memory for a Prometheus server (or any other OpenMetrics scraper) to pull them from the
+ * MetricsHttpServer component.
+ *
+ * The inserts of a round go into a pending sample set, write() then publishes it as an immutable
+ * snapshot. Scrapes only take a reference to the current snapshot, so they never block the
+ * StatsCollector and vice versa.
+ *
+ * High resolution stats and client ops are reported by the nodes as increments, they are summed up
+ * to counters here. Other counters (e.g. of the writeback of storage targets) are reported as
+ * totals. Everything else is a gauge with the value of the last round. Label sets are
+ * escaped once on insert, so rendering a scrape is only copying strings and formatting integers.
+ */
+class Prometheus : public TSDatabase
+{
+   public:
+      /**
+       * Called by render() with consecutive parts of the output.
+       */
+      typedef std::function<void(const char* data, size_t len)> OutputFunc;
+
+      Prometheus();
+      virtual ~Prometheus() {};
+
+      virtual void insertMetaNodeData(
+            std::shared_ptr<Node> node, const MetaNodeDataContent& data) override;
+      virtual void insertStorageNodeData(
+            std::shared_ptr<Node> node, const StorageNodeDataContent& data) override;
+      virtual void insertHighResMetaNodeData(
+            std::shared_ptr<Node> node, const HighResolutionStats& data) override;
+      virtual void insertHighResStorageNodeData(
+            std::shared_ptr<Node> node, const HighResolutionStats& data) override;
+      virtual void insertStorageTargetsData(
+            std::shared_ptr<Node> node, const StorageTargetInfo& data) override;
+      virtual void insertClientNodeData(
+            const std::string& id, const NodeType nodeType,
+            const std::map<std::string, uint64_t>& opMap, bool perUser) override;
+      virtual void write() override;
+
+      void render(const OutputFunc& output, bool openMetrics) const;
+
+      static std::string escapeLabelValue(const std::string& str);
+
+   private:
+      enum FamilyIndex
+      {
+         Family_META_RESPONDING,
+         Family_META_INDIRECT_WORK_LIST_SIZE,
+         Family_META_DIRECT_WORK_LIST_SIZE,
+         Family_META_SESSIONS,
+         Family_META_HOST,
+         Family_META_WORK_REQUESTS,
+         Family_META_QUEUED_REQUESTS,
+         Family_META_NET_SEND_BYTES,
+         Family_META_NET_RECV_BYTES,
+
+         Family_STORAGE_RESPONDING,
+         Family_STORAGE_INDIRECT_WORK_LIST_SIZE,
+         Family_STORAGE_DIRECT_WORK_LIST_SIZE,
+         Family_STORAGE_SESSIONS,
+         Family_STORAGE_DISK_SPACE_TOTAL,
+         Family_STORAGE_DISK_SPACE_FREE,
+         Family_STORAGE_HOST,
+         Family_STORAGE_WORK_REQUESTS,
+         Family_STORAGE_QUEUED_REQUESTS,
+         Family_STORAGE_DISK_WRITE_BYTES,
+         Family_STORAGE_DISK_READ_BYTES,
+         Family_STORAGE_NET_SEND_BYTES,
+         Family_STORAGE_NET_RECV_BYTES,
+
+         Family_TARGET_SPACE_TOTAL,
+         Family_TARGET_SPACE_FREE,
+         Family_TARGET_INODES_TOTAL,
+         Family_TARGET_INODES_FREE,
+         Family_TARGET_CONSISTENCY_STATE,
+         Family_TARGET_WRITEBACK_SYNC_WINDOW,
+         Family_TARGET_WRITEBACK_START_THRESHOLD,
+         Family_TARGET_WRITEBACK_DECISION,
+         Family_TARGET_WRITEBACK_WRITES,
+         Family_TARGET_WRITEBACK_STALLS,
+         Family_TARGET_WRITEBACK_SUBMITS,
+         Family_TARGET_WRITEBACK_SUBMITTED_BYTES,
+
+         Family_META_CLIENT_OPS_BY_NODE,
+         Family_META_CLIENT_OPS_BY_USER,
+         Family_STORAGE_CLIENT_OPS_BY_NODE,
+         Family_STORAGE_CLIENT_OPS_BY_USER,
+
+         Family_NUMFAMILIES
+      };
+
+      struct FamilyDesc
+      {
+         const char* name; // without the _total suffix of counters
+         const char* help;
+         bool isCounter;
+      };
+
+      typedef std::map<std::string, uint64_t> SeriesMap; // key: escaped label set
+
+      struct Snapshot
+      {
+         SeriesMap families[Family_NUMFAMILIES];
+      };
+
+      static const FamilyDesc familyDescs[Family_NUMFAMILIES];
+
+      mutable Mutex pendingMutex;
+      std::unique_ptr<Snapshot> pending; // filled by the inserts of the current round
+      std::set<std::string> pendingMetaNodes; // label sets of the nodes seen in this round
+      std::set<std::string> pendingStorageNodes;
+      // id labels of the clients (or users) seen in this round, only for client ops families
+      std::set<std::string> pendingClients[Family_NUMFAMILIES];
+      SeriesMap counters[Family_NUMFAMILIES]; // sums over all rounds, only for counter families
+
+      mutable Mutex snapshotMutex;
+      std::shared_ptr<const Snapshot> snapshot; // published by write()
+
+      void setGauge(FamilyIndex family, const std::string& labels, uint64_t value);
+      void addToCounter(FamilyIndex family, const std::string& labels, uint64_t value);
+      void setCounter(FamilyIndex family, const std::string& labels, uint64_t value);
+      void pruneCounters(FamilyIndex family, const std::set<std::string>& nodes);
+      void pruneClientCounters(FamilyIndex family);
+
+      static std::string makeNodeLabels(const Node& node);
+};
+
+#endif
@@ -0,0 +1,290 @@
+#include <common/storage/StorageTargetInfo.h>
+#include <common/toolkit/HighResolutionStats.h>
+#include <misc/Prometheus.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+class TestPrometheus : public ::testing::Test
+{
+   protected:
+      // a node without connection pool, which would need an App
+      class TestNode : public Node
+      {
+         public:
+            TestNode(NodeType nodeType, const std::string& alias, unsigned numID) :
+               Node(nodeType, alias, NumNodeID(numID), 0)
+            {
+               setConnPool(NULL);
+            }
+      };
+
+      Prometheus prometheus;
+
+      std::string render(bool openMetrics, std::vector<size_t>* outPartSizes = NULL)
+      {
+         std::string result;
+
+         prometheus.render([&] (const char* data, size_t len) {
+               result.append(data, len);
+
+               if (outPartSizes)
+                  outPartSizes->push_back(len);
+            }, openMetrics);
+
+         return result;
+      }
+
+      static std::shared_ptr<Node> makeNode(NodeType nodeType, const std::string& alias,
+         unsigned numID)
+      {
+         return std::make_shared<TestNode>(nodeType, alias, numID);
+      }
+
+      void insertMetaNode(const std::string& alias, unsigned numID, uint64_t workRequests)
+      {
+         auto node = makeNode(NODETYPE_Meta, alias, numID);
+
+         prometheus.insertMetaNodeData(node, {true, 2, 3, 4, alias + "-host"});
+
+         HighResolutionStats stats;
+         HighResolutionStatsTk::resetStats(&stats);
+
+         stats.rawVals.queuedRequests = 5;
+         stats.incVals.workRequests = workRequests;
+
+         prometheus.insertHighResMetaNodeData(node, stats);
+      }
+
+      void insertClientOps(const std::string& id, uint64_t numOpens, bool perUser = false)
+      {
+         prometheus.insertClientNodeData(id, NODETYPE_Meta, {{"open", numOpens}, {"stat", 0}},
+            perUser);
+      }
+
+      static bool contains(const std::string& output, const std::string& line)
+      {
+         return output.find(line + "\n") != std::string::npos;
+      }
+};
+
+TEST_F(TestPrometheus, escapeLabelValue)
+{
+   ASSERT_EQ(Prometheus::escapeLabelValue(""), "");
+   ASSERT_EQ(Prometheus::escapeLabelValue("node-1.example.com"), "node-1.example.com");
+   ASSERT_EQ(Prometheus::escapeLabelValue("a\"b"), "a\\\"b");
+   ASSERT_EQ(Prometheus::escapeLabelValue("a\\b"), "a\\\\b");
+   ASSERT_EQ(Prometheus::escapeLabelValue("a\nb"), "a\\nb");
+   ASSERT_EQ(Prometheus::escapeLabelValue("\\\"\n"), "\\\\\\\"\\n");
+
+   // everything else is passed through, including UTF-8
+   ASSERT_EQ(Prometheus::escapeLabelValue("n\xc3\xa4me\t{}=,"), "n\xc3\xa4me\t{}=,");
+}
+
+TEST_F(TestPrometheus, renderEmpty)
+{
+   ASSERT_EQ(render(false), "");
+   ASSERT_EQ(render(true), "# EOF\n");
+
+   // nothing is visible before the first write()
+   insertClientOps("10.0.0.1", 1);
+   ASSERT_EQ(render(false), "");
+}
+
+TEST_F(TestPrometheus, renderFormat)
+{
+   insertClientOps("10.0.0.1", 3);
+   prometheus.write();
+
+   ASSERT_EQ(render(false),
+      "# HELP beegfs_meta_client_ops_by_node_total Meta operations by client node.\n"
+      "# TYPE beegfs_meta_client_ops_by_node_total counter\n"
+      "beegfs_meta_client_ops_by_node_total{node=\"10.0.0.1\",op=\"open\"} 3\n");
+
+   // OpenMetrics names counter families without the suffix and needs an EOF marker
+   ASSERT_EQ(render(true),
+      "# HELP beegfs_meta_client_ops_by_node Meta operations by client node.\n"
+      "# TYPE beegfs_meta_client_ops_by_node counter\n"
+      "beegfs_meta_client_ops_by_node_total{node=\"10.0.0.1\",op=\"open\"} 3\n"
+      "# EOF\n");
+}
+
+TEST_F(TestPrometheus, renderNodes)
+{
+   insertMetaNode("meta\"1", 1, 6);
+   prometheus.write();
+
+   const std::string output = render(false);
+   const std::string labels = "{nodeID=\"meta\\\"1\",nodeNumID=\"1\"";
+
+   ASSERT_TRUE(contains(output, "# TYPE beegfs_meta_responding gauge") );
+   ASSERT_TRUE(contains(output, "beegfs_meta_responding" + labels + "} 1") );
+   ASSERT_TRUE(contains(output, "beegfs_meta_indirect_work_list_size" + labels + "} 2") );
+   ASSERT_TRUE(contains(output, "beegfs_meta_direct_work_list_size" + labels + "} 3") );
+   ASSERT_TRUE(contains(output, "beegfs_meta_sessions" + labels + "} 4") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_meta_host" + labels + ",hostnameid=\"meta\\\"1-host\"} 1") );
+   ASSERT_TRUE(contains(output, "beegfs_meta_queued_requests" + labels + "} 5") );
+   ASSERT_TRUE(contains(output, "# TYPE beegfs_meta_work_requests_total counter") );
+   ASSERT_TRUE(contains(output, "beegfs_meta_work_requests_total" + labels + "} 6") );
+
+   // every line is a comment or a sample
+   size_t lineStart = 0;
+
+   while (lineStart < output.size() )
+   {
+      const size_t lineEnd = output.find('\n', lineStart);
+      ASSERT_NE(lineEnd, std::string::npos);
+
+      const std::string line = output.substr(lineStart, lineEnd - lineStart);
+
+      ASSERT_TRUE(line.compare(0, 7, "# HELP ") == 0 || line.compare(0, 7, "# TYPE ") == 0
+         || line.compare(0, 7, "beegfs_") == 0) << line;
+
+      lineStart = lineEnd + 1;
+   }
+}
+
+TEST_F(TestPrometheus, labelEscaping)
+{
+   insertClientOps("a\"b\\c\nd", 1, true);
+   prometheus.write();
+
+   ASSERT_TRUE(contains(render(false),
+      "beegfs_meta_client_ops_by_user_total{user=\"a\\\"b\\\\c\\nd\",op=\"open\"} 1") );
+}
+
+TEST_F(TestPrometheus, countersAndGauges)
+{
+   insertMetaNode("meta1", 1, 6);
+   insertClientOps("10.0.0.1", 3);
+   prometheus.write();
+
+   insertMetaNode("meta1", 1, 4);
+   insertClientOps("10.0.0.1", 2);
+   prometheus.write();
+
+   const std::string output = render(false);
+
+   // counters are summed up, gauges have the value of the last round
+   ASSERT_TRUE(contains(output,
+      "beegfs_meta_work_requests_total{nodeID=\"meta1\",nodeNumID=\"1\"} 10") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_meta_client_ops_by_node_total{node=\"10.0.0.1\",op=\"open\"} 5") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_meta_sessions{nodeID=\"meta1\",nodeNumID=\"1\"} 4") );
+}
+
+TEST_F(TestPrometheus, pruneUnreportedSeries)
+{
+   insertMetaNode("meta1", 1, 1);
+   insertMetaNode("meta2", 2, 1);
+   insertClientOps("10.0.0.1", 1);
+   insertClientOps("10.0.0.2", 1);
+   insertClientOps("1000", 1, true);
+   prometheus.write();
+
+   std::string output = render(false);
+
+   ASSERT_NE(output.find("nodeID=\"meta2\""), std::string::npos);
+   ASSERT_NE(output.find("node=\"10.0.0.2\""), std::string::npos);
+   ASSERT_NE(output.find("user=\"1000\""), std::string::npos);
+
+   // meta2, client 10.0.0.2 and user 1000 are gone. a reported client without new ops is kept.
+   insertMetaNode("meta1", 1, 1);
+   insertClientOps("10.0.0.1", 0);
+   prometheus.write();
+
+   output = render(false);
+
+   ASSERT_EQ(output.find("nodeID=\"meta2\""), std::string::npos);
+   ASSERT_EQ(output.find("node=\"10.0.0.2\""), std::string::npos);
+   ASSERT_EQ(output.find("user=\"1000\""), std::string::npos);
+   ASSERT_EQ(output.find("beegfs_meta_client_ops_by_user"), std::string::npos);
+
+   ASSERT_TRUE(contains(output,
+      "beegfs_meta_work_requests_total{nodeID=\"meta1\",nodeNumID=\"1\"} 2") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_meta_client_ops_by_node_total{node=\"10.0.0.1\",op=\"open\"} 1") );
+
+   // a client that comes back starts from zero
+   insertClientOps("10.0.0.2", 7);
+   prometheus.write();
+
+   ASSERT_TRUE(contains(render(false),
+      "beegfs_meta_client_ops_by_node_total{node=\"10.0.0.2\",op=\"open\"} 7") );
+}
+
+TEST_F(TestPrometheus, targetWriteback)
+{
+   auto node = makeNode(NODETYPE_Storage, "storage1", 1);
+
+   StorageTargetInfo withoutWriteback(1, "/data/t1", 100, 50, 10, 5,
+      TargetConsistencyState_GOOD);
+   StorageTargetInfo withWriteback(2, "/data/t2", 100, 50, 10, 5, TargetConsistencyState_GOOD);
+
+   withWriteback.setWritebackStats(true, {4 << 20, 8 << 20, 100, 3, 20, 80 << 20, 2});
+
+   prometheus.insertStorageTargetsData(node, withoutWriteback);
+   prometheus.insertStorageTargetsData(node, withWriteback);
+   prometheus.write();
+
+   std::string output = render(false);
+   const std::string labels = "{nodeID=\"storage1\",nodeNumID=\"1\",storageTargetID=\"2\"";
+
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_sync_window_bytes" + labels + "} 4194304") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_start_threshold_bytes" + labels + "} 8388608") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_decision" + labels + ",decision=\"shrink\"} 1") );
+   ASSERT_TRUE(contains(output,
+      "# TYPE beegfs_storage_target_writeback_stalls_total counter") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_writes_total" + labels + "} 100") );
+   ASSERT_TRUE(contains(output, "beegfs_storage_target_writeback_stalls_total" + labels + "} 3") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_submits_total" + labels + "} 20") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_submitted_bytes_total" + labels + "} 83886080") );
+
+   // only for targets that reported it
+   ASSERT_EQ(output.find("writeback_sync_window_bytes{nodeID=\"storage1\",nodeNumID=\"1\","
+      "storageTargetID=\"1\""), std::string::npos);
+
+   // the storage server reports totals, they are not summed up again
+   withWriteback.setWritebackStats(true, {4 << 20, 8 << 20, 150, 3, 30, 120 << 20, 1});
+
+   prometheus.insertStorageTargetsData(node, withWriteback);
+   prometheus.write();
+
+   output = render(false);
+
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_writes_total" + labels + "} 150") );
+   ASSERT_TRUE(contains(output,
+      "beegfs_storage_target_writeback_decision" + labels + ",decision=\"grow\"} 1") );
+   ASSERT_EQ(output.find("decision=\"shrink\""), std::string::npos);
+}
+
+TEST_F(TestPrometheus, renderInParts)
+{
+   // a few hundred KiB of output
+   for (unsigned i = 0; i < 5000; i++)
+      insertClientOps("10.0." + std::to_string(i / 256) + "." + std::to_string(i % 256), i + 1);
+
+   prometheus.write();
+
+   std::vector<size_t> partSizes;
+   const std::string output = render(true, &partSizes);
+
+   ASSERT_GT(partSizes.size(), 2u);
+
+   for (size_t i = 0; i + 1 < partSizes.size(); i++)
+      ASSERT_EQ(partSizes[i], 64u * 1024);
+
+   ASSERT_GT(partSizes.back(), 0u);
+   ASSERT_EQ(std::count(output.begin(), output.end(), '\n'), 5000 + 3);
+   ASSERT_EQ(output.compare(output.size() - 6, 6, "# EOF\n"), 0);
+}
@@ -35,6 +35,7 @@
 
 
 #define APP_WORKERS_DIRECT_NUM   1
+#define APP_WORKERS_BUFPOOL_MINBUFSIZE   (4*1024) // smallest buffer class of the worker buf pool
 #define APP_SYSLOG_IDENTIFIER    "beegfs-storage"
 
 #define APP_STORAGE_UMASK (0) // allow any creat() / mkdir() mode without masking anything
@@ -357,6 +358,9 @@ void App::initDataObjects()
 
    this->chunkDirStore = new ChunkStore();
 
+   if(cfg->getTuneChunkFDCacheSize() )
+      chunkFDCache.reset(new ChunkFDCache(cfg->getTuneChunkFDCacheSize() ) );
+
    this->chunkLockStore = new ChunkLockStore();
 }
 
@@ -741,6 +745,32 @@ void App::streamListenersInit()
    }
 }
 
+/**
+ * @return NUMA node of the block device of the given target or -1 if unknown (in which case the
+ * workers of the target are distributed as configured by tuneWorkerNumaAffinity).
+ */
+int App::getTargetNumaNode(uint16_t targetID)
+{
+   auto* const target = storageTargets->getTarget(targetID);
+   if(!target)
+      return -1;
+
+   int numaNode = System::getNumaNodeByPath(target->getPath().str() );
+   if(numaNode < 0 || numaNode >= System::getNumNumaNodes() )
+   {
+      log->log(Log_WARNING, "Unable to determine NUMA area of target device. "
+         "targetID: " + StringTk::uintToStr(targetID) + "; "
+         "path: " + target->getPath().str() );
+      return -1;
+   }
+
+   log->log(Log_NOTICE, "Binding workers of target to NUMA area. "
+      "targetID: " + StringTk::uintToStr(targetID) + "; "
+      "NUMA area: " + StringTk::intToStr(numaNode) );
+
+   return numaNode;
+}
+
 void App::workersInit()
 {
    unsigned numWorkers = cfg->getTuneNumWorkers();
@@ -748,8 +778,17 @@ void App::workersInit()
    unsigned currentTargetNum= 1; /* targetNum is only added to worker name if there are multiple
       target queues (i.e. workQueueMap.size > 1) */
 
+   const bool useTargetNumaNodes =
+      cfg->getTuneTargetNumaAffinity() && cfg->getTuneUsePerTargetWorkers();
+
+   if(cfg->getTuneUseWorkerBufPool() )
+      workerBufPool.reset(new BufferPool(APP_WORKERS_BUFPOOL_MINBUFSIZE,
+         cfg->getTuneWorkerBufSize(), cfg->getTuneWorkerBufPoolHugePages() ) );
+
    for(MultiWorkQueueMapIter iter = workQueueMap.begin(); iter != workQueueMap.end(); iter++)
    {
+      int numaNode = useTargetNumaNodes ? getTargetNumaNode(iter->first) : -1;
+
       for(unsigned i=0; i < numWorkers; i++)
       {
          Worker* worker = new Worker(
@@ -758,8 +797,12 @@ void App::workersInit()
             iter->second, QueueWorkType_INDIRECT);
 
          worker->setBufLens(cfg->getTuneWorkerBufSize(), cfg->getTuneWorkerBufSize() );
+         worker->setBufferPool(workerBufPool.get() );
 
          workerList.push_back(worker);
+
+         if(numaNode >= 0)
+            workerNumaNodes[worker] = numaNode;
       }
 
       for(unsigned i=0; i < APP_WORKERS_DIRECT_NUM; i++)
@@ -770,8 +813,12 @@ void App::workersInit()
             iter->second, QueueWorkType_DIRECT);
 
          worker->setBufLens(cfg->getTuneWorkerBufSize(), cfg->getTuneWorkerBufSize() );
+         worker->setBufferPool(workerBufPool.get() );
 
          workerList.push_back(worker);
+
+         if(numaNode >= 0)
+            workerNumaNodes[worker] = numaNode;
       }
 
       currentTargetNum++;
@@ -797,7 +844,13 @@ void App::workersStart()
 
    for(WorkerListIter iter = workerList.begin(); iter != workerList.end(); iter++)
    {
-      if(cfg->getTuneWorkerNumaAffinity() )
+      std::map<const Worker*, int>::const_iterator numaIter = workerNumaNodes.find(*iter);
+
+      /* note: workers allocate their buffers on their own thread (see Worker::initBuffers), so
+         binding the thread also places the buffers on the bound node. */
+      if(numaIter != workerNumaNodes.end() )
+         (*iter)->startOnNumaNode(numaIter->second);
+      else if(cfg->getTuneWorkerNumaAffinity() )
          (*iter)->startOnNumaNode( (++nextNumaBindTarget) % numNumaNodes);
       else
          (*iter)->start();
@@ -27,8 +27,10 @@
 #include <net/message/NetMessageFactory.h>
 #include <nodes/StorageNodeOpStats.h>
 #include <session/SessionStore.h>
+#include <storage/ChunkFDCache.h>
 #include <storage/ChunkLockStore.h>
 #include <storage/ChunkStore.h>
+#include <storage/QuotaUsageCache.h>
 #include <storage/SyncedStoragePaths.h>
 #include <storage/StorageTargets.h>
 #include <toolkit/QuotaTk.h>
@@ -119,14 +121,17 @@ class App : public AbstractApp
       StreamLisVec streamLisVec;
 
       WorkerList workerList;
+      std::unique_ptr<BufferPool> workerBufPool; // set if tuneUseWorkerBufPool
+      std::map<const Worker*, int> workerNumaNodes; // fixed NUMA node (tuneTargetNumaAffinity)
       bool workersRunning;
       Mutex mutexWorkersRunning;
-
       ChunkStore* chunkDirStore;
+      std::unique_ptr<ChunkFDCache> chunkFDCache; // set if tuneChunkFDCacheSize
 
       unsigned nextNumaBindTarget; // the numa node to which we will bind the next component thread
 
       ExceededQuotaPerTarget exceededQuotaStores;
+      QuotaUsageCache quotaUsageCache; // last reported usage for GETQUOTAINFOMSG_FLAG_CHANGED_ONLY
 
       BuddyResyncer* buddyResyncer;
       ChunkLockStore* chunkLockStore;
@@ -148,6 +153,7 @@ class App : public AbstractApp
       void streamListenersJoin();
 
       void workersInit();
+      int getTargetNumaNode(uint16_t targetID);
       void workersStart();
       void workersStop();
       void workersDelete();
@@ -325,6 +331,14 @@ class App : public AbstractApp
          return this->storageBenchOperator;
       }
 
+      /**
+       * @return NULL if tuneUseWorkerBufPool is not set
+       */
+      const BufferPool* getWorkerBufPool() const
+      {
+         return workerBufPool.get();
+      }
+
       DatagramListener* getDatagramListener() const
       {
          return dgramListener;
@@ -366,6 +380,14 @@ class App : public AbstractApp
          return this->chunkDirStore;
       }
 
+      /**
+       * @return NULL if tuneChunkFDCacheSize is 0
+       */
+      ChunkFDCache* getChunkFDCache() const
+      {
+         return chunkFDCache.get();
+      }
+
       ChunkFetcher* getChunkFetcher() const
       {
          return this->chunkFetcher;
@@ -376,6 +398,11 @@ class App : public AbstractApp
          return &exceededQuotaStores;
       }
 
+      QuotaUsageCache* getQuotaUsageCache()
+      {
+         return &quotaUsageCache;
+      }
+
       BuddyResyncer* getBuddyResyncer() const
       {
          return this->buddyResyncer;
@@ -36,9 +36,12 @@ void Config::loadDefaults(bool addDashes)
    configMapRedefine("tuneNumStreamListeners",        "1");
    configMapRedefine("tuneNumWorkers",                "8");
    configMapRedefine("tuneWorkerBufSize",             "4m");
+   configMapRedefine("tuneUseWorkerBufPool",          "false");
+   configMapRedefine("tuneWorkerBufPoolHugePages",    "false");
    configMapRedefine("tuneProcessFDLimit",            "50000");
    configMapRedefine("tuneWorkerNumaAffinity",        "false");
    configMapRedefine("tuneListenerNumaAffinity",      "false");
+   configMapRedefine("tuneTargetNumaAffinity",        "false");
    configMapRedefine("tuneListenerPrioShift",         "-1");
    configMapRedefine("tuneBindToNumaZone",            "");
    configMapRedefine("tuneFileReadSize",              "32k");
@@ -46,11 +49,14 @@ void Config::loadDefaults(bool addDashes)
    configMapRedefine("tuneFileReadAheadSize",         "0");
    configMapRedefine("tuneFileWriteSize",             "64k");
    configMapRedefine("tuneFileWriteSyncSize",         "0");
+   configMapRedefine("tuneFileWriteSyncAdaptive",     "false");
    configMapRedefine("tuneUsePerUserMsgQueues",       "false");
    configMapRedefine("tuneDirCacheLimit",             "1024");
+   configMapRedefine("tuneChunkFDCacheSize",          "0");
    configMapRedefine("tuneEarlyStat",                 "false");
    configMapRedefine("tuneNumResyncSlaves",           "12");
    configMapRedefine("tuneNumResyncGatherSlaves",     "6");
+   configMapRedefine("tuneNumChunkFetchThreads",      "4");
    configMapRedefine("tuneUseAggressiveStreamPoll",   "false");
    configMapRedefine("tuneUsePerTargetWorkers",       "true");
    configMapRedefine("tuneChunkBalanceQueueLimit",    "100000");
@@ -136,12 +142,18 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
          tuneNumWorkers = StringTk::strToUInt(iter->second);
       else if (iter->first == std::string("tuneWorkerBufSize"))
          tuneWorkerBufSize = UnitTk::strHumanToInt64(iter->second);
+      else if (iter->first == std::string("tuneUseWorkerBufPool"))
+         tuneUseWorkerBufPool = StringTk::strToBool(iter->second);
+      else if (iter->first == std::string("tuneWorkerBufPoolHugePages"))
+         tuneWorkerBufPoolHugePages = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneProcessFDLimit"))
          tuneProcessFDLimit = StringTk::strToUInt(iter->second);
       else if (iter->first == std::string("tuneWorkerNumaAffinity"))
          tuneWorkerNumaAffinity = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneListenerNumaAffinity"))
          tuneListenerNumaAffinity = StringTk::strToBool(iter->second);
+      else if (iter->first == std::string("tuneTargetNumaAffinity"))
+         tuneTargetNumaAffinity = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneBindToNumaZone"))
       {
          if (iter->second.empty()) // not defined => disable
@@ -161,16 +173,22 @@ void Config::applyConfigMap(bool enableException, bool addDashes)
          tuneFileWriteSize = UnitTk::strHumanToInt64(iter->second);
       else if (iter->first == std::string("tuneFileWriteSyncSize"))
          tuneFileWriteSyncSize = UnitTk::strHumanToInt64(iter->second);
+      else if (iter->first == std::string("tuneFileWriteSyncAdaptive"))
+         tuneFileWriteSyncAdaptive = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneUsePerUserMsgQueues"))
          tuneUsePerUserMsgQueues = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneDirCacheLimit"))
          tuneDirCacheLimit = StringTk::strToUInt(iter->second);
+      else if (iter->first == std::string("tuneChunkFDCacheSize"))
+         tuneChunkFDCacheSize = StringTk::strToUInt(iter->second);
       else if (iter->first == std::string("tuneEarlyStat"))
          this->tuneEarlyStat = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneNumResyncGatherSlaves"))
          this->tuneNumResyncGatherSlaves = StringTk::strToUInt(iter->second);
       else if (iter->first == std::string("tuneNumResyncSlaves"))
          this->tuneNumResyncSlaves = StringTk::strToUInt(iter->second);
+      else if (iter->first == std::string("tuneNumChunkFetchThreads"))
+         this->tuneNumChunkFetchThreads = StringTk::strToUInt(iter->second);
       else if (iter->first == std::string("tuneUseAggressiveStreamPoll"))
          tuneUseAggressiveStreamPoll = StringTk::strToBool(iter->second);
       else if (iter->first == std::string("tuneUsePerTargetWorkers"))
@@ -239,6 +257,12 @@ void Config::initImplicitVals()
          throw InvalidConfigException(
             "Config option is not supported for this distribution: 'tuneFileWriteSyncSize'");
       }
+
+      if(tuneFileWriteSyncAdaptive)
+      {
+         throw InvalidConfigException(
+            "Config option is not supported for this distribution: 'tuneFileWriteSyncAdaptive'");
+      }
    #endif
 
    // connAuthHash
@@ -35,9 +35,12 @@ class Config : public AbstractConfig
       unsigned    tuneNumStreamListeners;
       unsigned    tuneNumWorkers;
       unsigned    tuneWorkerBufSize;
+      bool        tuneUseWorkerBufPool; // borrow worker buffers from a shared BufferPool
+      bool        tuneWorkerBufPoolHugePages;
       unsigned    tuneProcessFDLimit; // 0 means "don't touch limit"
       bool        tuneWorkerNumaAffinity;
       bool        tuneListenerNumaAffinity;
+      bool        tuneTargetNumaAffinity; // bind per-target workers to the target device's node
       int         tuneBindToNumaZone; // bind all threads to this zone, -1 means no binding
       int         tuneListenerPrioShift;
       ssize_t     tuneFileReadSize;
@@ -45,11 +48,14 @@ class Config : public AbstractConfig
       ssize_t     tuneFileReadAheadSize; // read-ahead with posix_fadvise(..., POSIX_FADV_WILLNEED)
       ssize_t     tuneFileWriteSize;
       ssize_t     tuneFileWriteSyncSize; // after how many of per session data to sync_file_range()
+      bool        tuneFileWriteSyncAdaptive; // per target WritebackController instead of fixed size
       bool        tuneUsePerUserMsgQueues; // true to use UserWorkContainer for MultiWorkQueue
       unsigned    tuneDirCacheLimit;
+      unsigned    tuneChunkFDCacheSize; // max number of cached read-only chunk fds, 0 disables
       bool        tuneEarlyStat;          // stat the chunk file before closing it
       unsigned    tuneNumResyncGatherSlaves;
       unsigned    tuneNumResyncSlaves;
+      unsigned    tuneNumChunkFetchThreads; // per target, for fsck
       bool        tuneUseAggressiveStreamPoll; // true to not sleep on epoll in streamlisv2
       bool        tuneUsePerTargetWorkers; // true to have tuneNumWorkers separate for each target
       unsigned    tuneChunkBalanceQueueLimit;  //maximum number of items in chunk balancing queue
@@ -107,6 +113,16 @@ class Config : public AbstractConfig
          return tuneWorkerBufSize;
       }
 
+      bool getTuneUseWorkerBufPool() const
+      {
+         return tuneUseWorkerBufPool;
+      }
+
+      bool getTuneWorkerBufPoolHugePages() const
+      {
+         return tuneWorkerBufPoolHugePages;
+      }
+
       unsigned getTuneProcessFDLimit() const
       {
          return tuneProcessFDLimit;
@@ -122,6 +138,11 @@ class Config : public AbstractConfig
          return tuneListenerNumaAffinity;
       }
 
+      bool getTuneTargetNumaAffinity() const
+      {
+         return tuneTargetNumaAffinity;
+      }
+
       int getTuneBindToNumaZone() const
       {
          return tuneBindToNumaZone;
@@ -157,6 +178,11 @@ class Config : public AbstractConfig
          return this->tuneFileWriteSyncSize;
       }
 
+      bool getTuneFileWriteSyncAdaptive() const
+      {
+         return this->tuneFileWriteSyncAdaptive;
+      }
+
       bool getTuneUsePerUserMsgQueues() const
       {
          return tuneUsePerUserMsgQueues;
@@ -177,6 +203,11 @@ class Config : public AbstractConfig
          return tuneDirCacheLimit;
       }
 
+      unsigned getTuneChunkFDCacheSize() const
+      {
+         return tuneChunkFDCacheSize;
+      }
+
       bool getTuneEarlyStat() const
       {
          return this->tuneEarlyStat;
@@ -207,6 +238,11 @@ class Config : public AbstractConfig
          return tuneNumResyncSlaves;
       }
 
+      unsigned getTuneNumChunkFetchThreads() const
+      {
+         return tuneNumChunkFetchThreads;
+      }
+
       bool getTuneUseAggressiveStreamPoll() const
       {
          return tuneUseAggressiveStreamPoll;
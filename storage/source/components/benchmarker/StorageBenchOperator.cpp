@@ -2,9 +2,10 @@
 
 
 int StorageBenchOperator::initAndStartStorageBench(UInt16List* targetIDs, int64_t blocksize,
-   int64_t size, int threads, bool odirect, StorageBenchType type)
+   int64_t size, int threads, bool odirect, StorageBenchType type, const StorageBenchMode& mode)
 {
-   return this->slave.initAndStartStorageBench(targetIDs, blocksize, size, threads, odirect, type);
+   return this->slave.initAndStartStorageBench(targetIDs, blocksize, size, threads, odirect, type,
+      mode);
 }
 
 int StorageBenchOperator::cleanup(UInt16List* targetIDs)
@@ -23,6 +24,12 @@ StorageBenchStatus StorageBenchOperator::getStatusWithResults(UInt16List* target
    return this->slave.getStatusWithResults(targetIDs, outResults);
 }
 
+void StorageBenchOperator::getLatencyResults(UInt16List* targetIDs,
+   StorageBenchLatencyMap* outResults)
+{
+   this->slave.getLatencyResults(targetIDs, outResults);
+}
+
 void StorageBenchOperator::shutdownBenchmark()
 {
    this->slave.shutdownBenchmark();
@@ -10,12 +10,13 @@ class StorageBenchOperator
       StorageBenchOperator() {}
 
       int initAndStartStorageBench(UInt16List* targetIDs, int64_t blocksize, int64_t size,
-         int threads, bool odirect, StorageBenchType type);
+         int threads, bool odirect, StorageBenchType type, const StorageBenchMode& mode);
 
       int cleanup(UInt16List* targetIDs);
       int stopBenchmark();
       StorageBenchStatus getStatusWithResults(UInt16List* targetIDs,
          StorageBenchResultsMap* outResults);
+      void getLatencyResults(UInt16List* targetIDs, StorageBenchLatencyMap* outResults);
       void shutdownBenchmark();
       void waitForShutdownBenchmark();
 
@@ -19,11 +19,12 @@
  * @param size the size for the benchmark
  * @param threads the number (simulated clients) of threads for the benchmark
  * @param type the type of the benchmark
+ * @param mode the access pattern of the benchmark
  * @return the error code, 0 if the benchmark was initialize successful (STORAGEBENCH_ERROR..)
  *
  */
 int StorageBenchSlave::initAndStartStorageBench(UInt16List* targetIDs, int64_t blocksize,
-   int64_t size, int threads, bool odirect, StorageBenchType type)
+   int64_t size, int threads, bool odirect, StorageBenchType type, const StorageBenchMode& mode)
 {
    const char* logContext = "Storage Benchmark (init)";
 
@@ -44,7 +45,7 @@ int StorageBenchSlave::initAndStartStorageBench(UInt16List* targetIDs, int64_t b
    }
    else
    {
-      retVal = initStorageBench(targetIDs, blocksize, size, threads, odirect, type);
+      retVal = initStorageBench(targetIDs, blocksize, size, threads, odirect, type, mode);
    }
 
    if(retVal == STORAGEBENCH_ERROR_NO_ERROR)
@@ -91,11 +92,12 @@ int StorageBenchSlave::initAndStartStorageBench(UInt16List* targetIDs, int64_t b
  * @param size the size for the benchmark
  * @param threads the number (simulated clients) of threads for the benchmark
  * @param type the type of the benchmark
+ * @param mode the access pattern of the benchmark
  * @return the error code, 0 if the benchmark was initialize successful (STORAGEBENCH_ERROR..)
  *
  */
 int StorageBenchSlave::initStorageBench(UInt16List* targetIDs, int64_t blocksize,
-   int64_t size, int threads, bool odirect, StorageBenchType type)
+   int64_t size, int threads, bool odirect, StorageBenchType type, const StorageBenchMode& mode)
 {
    const char* logContext = "Storage Benchmark (init)";
    LogContext(logContext).log(Log_DEBUG, "Initializing benchmark ...");
@@ -106,7 +108,19 @@ int StorageBenchSlave::initStorageBench(UInt16List* targetIDs, int64_t blocksize
    this->size = size;
    this->numThreads = threads;
    this->odirect = odirect;
-   this->numThreadsDone = 0;
+   this->mode = mode;
+   this->numBlocksInFlight = 0;
+
+   if ( (mode.queueDepth < 1) || (mode.readPercent < 0) || (mode.readPercent > 100) )
+   {
+      LogContext(logContext).logErr("Invalid benchmark mode. "
+         "Queue depth: " + StringTk::intToStr(mode.queueDepth) + "; "
+         "read percentage: " + StringTk::intToStr(mode.readPercent) );
+
+      this->lastRunErrorCode = STORAGEBENCH_ERROR_INIT_INVALID_MODE;
+      this->status = StorageBenchStatus_ERROR;
+      return STORAGEBENCH_ERROR_INIT_INVALID_MODE;
+   }
 
    initThreadData();
 
@@ -117,7 +131,7 @@ int StorageBenchSlave::initStorageBench(UInt16List* targetIDs, int64_t blocksize
       return STORAGEBENCH_ERROR_INIT_TRANSFER_DATA;
    }
 
-   if (this->benchType == StorageBenchType_READ)
+   if ( (this->benchType == StorageBenchType_READ) || (this->benchType == StorageBenchType_MIXED) )
    {
       if (!checkReadData())
       {
@@ -218,13 +232,18 @@ void StorageBenchSlave::initThreadData()
          data.engagedSize = 0;
          data.fileDescriptor = 0;
          data.neededTime = 0;
-
+         data.numInFlight = 0;
 
          this->threadData[allThreadCounter] = data;
          allThreadCounter++;
       }
    }
 
+   {
+      const std::lock_guard<Mutex> lock(latencyMutex);
+      this->latencies.clear();
+   }
+
    LogContext(logContext).log(Log_DEBUG, "Thread data initialized.");
 }
 
@@ -244,7 +263,7 @@ void StorageBenchSlave::run()
    {
       this->startTime.setToNow();
 
-      // add a work package into the worker queue for every thread
+      // fill the worker queue up to the queue depth for every thread
       for(StorageBenchThreadDataMapIter iter = threadData.begin();
           iter != threadData.end();
           iter++)
@@ -256,26 +275,31 @@ void StorageBenchSlave::run()
          LOG_DEBUG(logContext, Log_DEBUG, std::string("- type: ") +
             StringTk::intToStr(this->benchType) );
 
-         StorageBenchWork* work = new StorageBenchWork(iter->second.targetID, iter->first,
-            iter->second.fileDescriptor, this->benchType, getNextPackageSize(iter->first),
-            this->threadCommunication, this->transferData.get());
-
-         app->getWorkQueue(iter->second.targetID)->addIndirectWork(work);
+         for (int depth = 0; depth < this->mode.queueDepth; depth++)
+         {
+            if (!addWork(iter->first) )
+               break;
+         }
       }
 
+      if (!this->numBlocksInFlight)
+         setStatus(StorageBenchStatus_FINISHING); // nothing to do
+
       while(getStatus() == StorageBenchStatus_RUNNING)
       {
-         int threadID = 0;
+         StorageBenchWorkResult result;
 
          if (this->threadCommunication->waitForIncomingData(STORAGEBENCH_READ_PIPE_TIMEOUT_MS))
          {
-            this->threadCommunication->getReadFD()->readExact(&threadID, sizeof(int));
+            this->threadCommunication->getReadFD()->readExact(&result, sizeof(result) );
          }
          else
          {
-            threadID = STORAGEBENCH_ERROR_COM_TIMEOUT;
+            result.threadID = STORAGEBENCH_ERROR_COM_TIMEOUT;
          }
 
+         const int threadID = result.threadID;
+
          if (this->getSelfTerminate())
          {
             LogContext(logContext).logErr(std::string("Abort benchmark."));
@@ -283,10 +307,7 @@ void StorageBenchSlave::run()
             setStatus(StorageBenchStatus_STOPPING);
 
             if (threadID != STORAGEBENCH_ERROR_COM_TIMEOUT)
-            {
-               this->threadData[threadID].neededTime = this->startTime.elapsedMS();
-               this->numThreadsDone++;
-            }
+               workFinished(result);
 
             break;
          }
@@ -297,10 +318,9 @@ void StorageBenchSlave::run()
             this->lastRunErrorCode = STORAGEBENCH_ERROR_WORKER_ERROR;
             setStatus(StorageBenchStatus_STOPPING);
 
-            // increment the thread counter, because the thread which sent this error hasn't a
-            // work package in the queue of the workers but the response from the other threads
-            // must be collected
-            this->numThreadsDone++;
+            // the block which failed isn't in the queue of the workers anymore, but the responses
+            // for the other blocks in flight must be collected
+            workFinished(result);
 
             break;
          }
@@ -310,7 +330,7 @@ void StorageBenchSlave::run()
             continue;
          }
          else
-         if ( (threadID < -1) || ( ( (unsigned)threadID) >= this->threadData.size() ) )
+         if ( (threadID < 0) || ( ( (unsigned)threadID) >= this->threadData.size() ) )
          { // error if the worker reports an unknown threadID
             std::string errorMessage("Unknown thread ID: " + StringTk::intToStr(threadID) + "; "
                "map size: " + StringTk::uintToStr(this->threadData.size() ) );
@@ -319,47 +339,30 @@ void StorageBenchSlave::run()
             this->lastRunErrorCode = STORAGEBENCH_ERROR_RUNTIME_ERROR;
             setStatus(StorageBenchStatus_STOPPING);
 
-            // increment the thread counter, because the thread which sent this error hasn't a
-            // work package in the queue of the workers but the response from the other threads
-            // must be collected
-            this->numThreadsDone++;
+            workFinished(result);
 
             break;
          }
 
-         StorageBenchThreadData* currentData = &this->threadData[threadID];
-         int64_t workSize = getNextPackageSize(threadID);
+         workFinished(result);
 
-         // add a new work package into the workers queue for the reported thread only if the
-         // data size for the thread is bigger then 0
-         if (workSize != 0)
-         {
-            StorageBenchWork* work = new StorageBenchWork(currentData->targetID, threadID,
-               currentData->fileDescriptor, this->benchType, workSize, this->threadCommunication,
-               this->transferData.get());
-            app->getWorkQueue(currentData->targetID)->addIndirectWork(work);
-         }
-         else
-         {
-            // the thread has finished his work
-            currentData->neededTime = this->startTime.elapsedMS();
-            this->numThreadsDone++;
-         }
+         // keep the queue of the thread filled until all data of the thread is submitted
+         addWork(threadID);
 
-         if (this->numThreadsDone >= this->threadData.size())
+         if (!this->numBlocksInFlight)
          {
             setStatus(StorageBenchStatus_FINISHING);
          }
       }
 
       //collect all responses from the worker
-      while ( (this->numThreadsDone < this->threadData.size()) && app->getWorkersRunning() )
+      while (this->numBlocksInFlight && app->getWorkersRunning() )
       {
-         int threadID = 0;
+         StorageBenchWorkResult result;
 
          if (this->threadCommunication->waitForIncomingData(STORAGEBENCH_READ_PIPE_TIMEOUT_MS))
          {
-            this->threadCommunication->getReadFD()->readExact(&threadID, sizeof(int));
+            this->threadCommunication->getReadFD()->readExact(&result, sizeof(result) );
          }
          else
          {
@@ -368,10 +371,7 @@ void StorageBenchSlave::run()
 
          LOG_DEBUG(logContext, Log_DEBUG, std::string("Collect response from worker."));
 
-         if(threadID >= 0)
-            this->threadData[threadID].neededTime = this->startTime.elapsedMS();
-
-         this->numThreadsDone++;
+         workFinished(result);
       }
 
       // all workers finished/stopped ==> close all files
@@ -528,6 +528,12 @@ bool StorageBenchSlave::openFiles()
       int directFlag = this->odirect ? O_DIRECT : 0;
       if(this->benchType == StorageBenchType_READ)
          fileDescriptor = open(path.c_str(), O_RDONLY | directFlag);
+      else
+      if(this->benchType == StorageBenchType_MIXED)
+         fileDescriptor = open(path.c_str(), O_RDWR | directFlag);
+      else
+      if(this->mode.randomOffsets) // overwrite existing data instead of writing into holes
+         fileDescriptor = open(path.c_str(), O_CREAT | O_WRONLY | directFlag, openMode);
       else
          fileDescriptor = open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC | directFlag, openMode);
 
@@ -584,24 +590,112 @@ bool StorageBenchSlave::closeFiles()
    return retVal;
 }
 
+/*
+ * adds a work package for the next block of the given thread into the worker queue
+ *
+ * @param threadID the threadID
+ * @return false if all data of the given thread was already submitted
+ *
+ */
+bool StorageBenchSlave::addWork(int threadID)
+{
+   StorageBenchThreadData* currentData = &this->threadData[threadID];
+
+   int64_t offset;
+   int64_t workSize = getNextPackageSize(threadID, &offset);
+
+   if (!workSize)
+      return false;
+
+   StorageBenchWork* work = new StorageBenchWork(currentData->targetID, threadID,
+      currentData->fileDescriptor, getNextBlockType(), offset, workSize,
+      this->threadCommunication, this->transferData.get());
+
+   Program::getApp()->getWorkQueue(currentData->targetID)->addIndirectWork(work);
+
+   currentData->numInFlight++;
+   this->numBlocksInFlight++;
+
+   return true;
+}
+
+/*
+ * accounts a response of a worker and records the latency of the block
+ *
+ * @param result the response of the worker, may also be an error
+ *
+ */
+void StorageBenchSlave::workFinished(const StorageBenchWorkResult& result)
+{
+   this->numBlocksInFlight--;
+
+   // errors don't tell the thread of the failed block
+   if ( (result.threadID < 0) || ( ( (unsigned)result.threadID) >= this->threadData.size() ) )
+      return;
+
+   StorageBenchThreadData* currentData = &this->threadData[result.threadID];
+
+   currentData->numInFlight--;
+
+   // the thread is done if all of its data was submitted or the benchmark is stopping
+   if (!currentData->numInFlight &&
+       ( (currentData->engagedSize >= this->size) || (getStatus() != StorageBenchStatus_RUNNING) ) )
+      currentData->neededTime = this->startTime.elapsedMS();
+
+   const std::lock_guard<Mutex> lock(latencyMutex);
+
+   StorageBenchTargetLatency& targetLatency = this->latencies[currentData->targetID];
+
+   if (result.type == StorageBenchType_READ)
+      targetLatency.read.add(result.latencyUS);
+   else
+      targetLatency.write.add(result.latencyUS);
+}
+
 /*
  * calculates the size (bytes) of the data which will be written on the disk by the worker with
  * the next work package for the given thread
  *
  * @param threadID the threadID
+ * @param outOffset the file offset of the next work package
  * @return the size of the data for next work package in bytes,
  *         if 0 the given thread has written all data
  *
  */
-int64_t StorageBenchSlave::getNextPackageSize(int threadID)
+int64_t StorageBenchSlave::getNextPackageSize(int threadID, int64_t* outOffset)
 {
-   int64_t retVal = BEEGFS_MIN(this->blocksize,
-      this->size - this->threadData[threadID].engagedSize);
-   this->threadData[threadID].engagedSize += retVal;
+   StorageBenchThreadData* currentData = &this->threadData[threadID];
+
+   int64_t retVal = BEEGFS_MIN(this->blocksize, this->size - currentData->engagedSize);
+
+   if (!this->mode.randomOffsets || (this->size <= this->blocksize) )
+      *outOffset = currentData->engagedSize;
+   else
+   { // random block within the file, the number of blocks stays the same as for sequential I/O
+      uint64_t numBlocks = this->size / this->blocksize;
+      uint64_t randomValue = ( (uint64_t)this->randomizer.getNextInt() << 31) |
+         (uint64_t)this->randomizer.getNextInt();
+
+      *outOffset = (randomValue % numBlocks) * this->blocksize;
+   }
+
+   currentData->engagedSize += retVal;
 
    return retVal;
 }
 
+/*
+ * @return the type of the next block, which is only random for StorageBenchType_MIXED
+ */
+StorageBenchType StorageBenchSlave::getNextBlockType()
+{
+   if (this->benchType != StorageBenchType_MIXED)
+      return this->benchType;
+
+   return (this->randomizer.getNextInRange(0, 99) < this->mode.readPercent) ?
+      StorageBenchType_READ : StorageBenchType_WRITE;
+}
+
 
 /*
  * calculates the throughput (kB/s) of the given target
@@ -691,6 +785,35 @@ StorageBenchStatus StorageBenchSlave::getStatusWithResults(UInt16List* targetIDs
    return getStatus();
 }
 
+/*
+ * calculates the latency percentiles of the given targets
+ *
+ * @param targetIDs the list of targetIDs
+ * @param outResults a initialized map for the results, which contains the results after
+ *        execution of the method
+ *
+ */
+void StorageBenchSlave::getLatencyResults(UInt16List* targetIDs,
+   StorageBenchLatencyMap* outResults)
+{
+   const std::lock_guard<Mutex> lock(latencyMutex);
+
+   for (UInt16ListIter iter = targetIDs->begin(); iter != targetIDs->end(); iter++)
+   {
+      StorageBenchLatencyResult& result = (*outResults)[*iter];
+
+      auto latencyIter = this->latencies.find(*iter);
+      if (latencyIter == this->latencies.end() )
+      {
+         result = StorageBenchLatencyResult();
+         continue;
+      }
+
+      result.read = latencyIter->second.read.getStats();
+      result.write = latencyIter->second.write.getStats();
+   }
+}
+
 /*
  * stop the benchmark
  *
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <common/app/log/LogContext.h>
+#include <common/benchmark/LatencyHistogram.h>
 #include <common/benchmark/StorageBench.h>
 #include <common/threading/Condition.h>
 #include <common/threading/PThread.h>
 #include <common/toolkit/Pipe.h>
+#include <common/toolkit/Random.h>
 #include <common/toolkit/TimeFine.h>
 #include <common/Common.h>
 
@@ -18,8 +20,17 @@ struct StorageBenchThreadData
    int64_t engagedSize; // amount of data which was submitted for write/read
    int fileDescriptor;
    int64_t neededTime;
+   int numInFlight; // blocks in the worker queue, up to StorageBenchMode::queueDepth
 };
 
+struct StorageBenchTargetLatency
+{
+   LatencyHistogram read;
+   LatencyHistogram write;
+};
+
+struct StorageBenchWorkResult;
+
 // deleter functor for transferData
 struct TransferDataDeleter {
    void operator()(char* transferData) { free(transferData); }
@@ -46,7 +57,7 @@ class StorageBenchSlave : public PThread
          blocksize(1),  // useless defaults
          size(1),       // useless defaults
          numThreads(1), // useless defaults
-         numThreadsDone(0),
+         numBlocksInFlight(0),
          targetIDs(NULL),
          transferData(nullptr)
       { }
@@ -58,12 +69,13 @@ class StorageBenchSlave : public PThread
       }
 
       int initAndStartStorageBench(UInt16List* targetIDs, int64_t blocksize, int64_t size,
-         int threads, bool odirect, StorageBenchType type);
+         int threads, bool odirect, StorageBenchType type, const StorageBenchMode& mode);
 
       int cleanup(UInt16List* targetIDs);
       int stopBenchmark();
       StorageBenchStatus getStatusWithResults(UInt16List* targetIDs,
          StorageBenchResultsMap* outResults);
+      void getLatencyResults(UInt16List* targetIDs, StorageBenchLatencyMap* outResults);
       void shutdownBenchmark();
       void waitForShutdownBenchmark();
 
@@ -83,7 +95,9 @@ class StorageBenchSlave : public PThread
       int64_t size;
       int numThreads;
       bool odirect;
-      unsigned int numThreadsDone;
+      StorageBenchMode mode;
+      unsigned int numBlocksInFlight; // over all threads
+      Random randomizer; // for random offsets and mixes
 
       UInt16List* targetIDs;
       StorageBenchThreadDataMap threadData;
@@ -91,11 +105,14 @@ class StorageBenchSlave : public PThread
 
       TimeFine startTime;
 
+      Mutex latencyMutex;
+      std::map<uint16_t, StorageBenchTargetLatency> latencies; // key: targetID
+
 
       virtual void run();
 
       int initStorageBench(UInt16List* targetIDs, int64_t blocksize, int64_t size,
-         int threads, bool odirect, StorageBenchType type);
+         int threads, bool odirect, StorageBenchType type, const StorageBenchMode& mode);
       bool initTransferData(void);
       void initThreadData();
       void freeTransferData();
@@ -105,7 +122,10 @@ class StorageBenchSlave : public PThread
       bool openFiles(void);
       bool closeFiles(void);
 
-      int64_t getNextPackageSize(int threadID);
+      bool addWork(int threadID);
+      void workFinished(const StorageBenchWorkResult& result);
+      int64_t getNextPackageSize(int threadID, int64_t* outOffset);
+      StorageBenchType getNextBlockType();
       int64_t getResult(uint16_t targetID);
       void getResults(UInt16List* targetIDs, StorageBenchResultsMap* outResults);
       void getAllResults(StorageBenchResultsMap* outResults);
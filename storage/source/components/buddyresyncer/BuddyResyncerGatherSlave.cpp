@@ -1,16 +1,12 @@
 #include <app/App.h>
+#include <common/toolkit/DirTreeWalker.h>
 #include <toolkit/StorageTkEx.h>
 #include <storage/StorageTargets.h>
 
 #include <program/Program.h>
 
-#include <mutex>
-
 #include "BuddyResyncerGatherSlave.h"
 
-Mutex BuddyResyncerGatherSlave::staticGatherSlavesMutex;
-std::map<std::string, BuddyResyncerGatherSlave*> BuddyResyncerGatherSlave::staticGatherSlaves;
-
 BuddyResyncerGatherSlave::BuddyResyncerGatherSlave(const StorageTarget& target,
    ChunkSyncCandidateStore* syncCandidates, BuddyResyncerGatherSlaveWorkQueue* workQueue,
    uint8_t slaveID) :
@@ -21,10 +17,6 @@ BuddyResyncerGatherSlave::BuddyResyncerGatherSlave(const StorageTarget& target,
    this->isRunning = false;
    this->syncCandidates = syncCandidates;
    this->workQueue = workQueue;
-
-   const std::lock_guard<Mutex> lock(staticGatherSlavesMutex);
-
-   staticGatherSlaves[this->getName()] = this;
 }
 
 BuddyResyncerGatherSlave::~BuddyResyncerGatherSlave()
@@ -67,7 +59,10 @@ void BuddyResyncerGatherSlave::run()
 
 void BuddyResyncerGatherSlave::workLoop()
 {
-   const unsigned maxOpenFDsNum = 20; // max open FDs => max path sub-depth for efficient traversal
+   const std::string chunksPath = target.getPath().str() + "/" CONFIG_BUDDYMIRROR_SUBDIR_NAME;
+
+   // (the job distributes the subtrees among the gather slaves, so each walk is single-threaded)
+   DirTreeWalker walker(1, true);
 
    while (!getSelfTerminateNotIdle())
    {
@@ -80,41 +75,49 @@ void BuddyResyncerGatherSlave::workLoop()
       if(unlikely(pathStr.empty()))
          continue;
 
-      int nftwRes = nftw(pathStr.c_str(), handleDiscoveredEntry, maxOpenFDsNum, FTW_ACTIONRETVAL);
-      if(nftwRes == -1)
-      { // error occurred
-         LogContext(__func__).logErr("Error during chunks walk. SysErr: " + System::getErrString());
+      if (pathStr.size() <= chunksPath.size() )
+         continue;
+
+      const std::string relPathStr = pathStr.substr(chunksPath.size() + 1);
+      const int64_t lastBuddyCommTimeSecs = getLastBuddyCommTimeSecs();
+
+      struct stat statBuf;
+
+      if (::stat(pathStr.c_str(), &statBuf) )
+      {
+         LOG(MIRRORING, ERR, "Could not stat directory.", pathStr, sysErr);
+         continue;
       }
-   }
-}
 
-int BuddyResyncerGatherSlave::handleDiscoveredEntry(const char* path,
-   const struct stat* statBuf, int ftwEntryType, struct FTW* ftwBuf)
-{
-   std::string chunksPath;
+      handleDiscoveredEntry(relPathStr, statBuf, lastBuddyCommTimeSecs);
 
-   BuddyResyncerGatherSlave* thisStatic = nullptr;
-   {
-      const std::lock_guard<Mutex> lock(staticGatherSlavesMutex);
+      auto handleEntry = [&] (const DirTreeWalker::Entry& entry) {
+         if (getSelfTerminateNotIdle() )
+            return DirTreeWalker::Action_ABORT;
 
-      thisStatic = staticGatherSlaves[PThread::getCurrentThreadName()];
-   }
+         handleDiscoveredEntry(relPathStr + "/" + entry.getPath(), *entry.statBuf,
+            lastBuddyCommTimeSecs);
 
-   App* app = Program::getApp();
-   Config* cfg = app->getConfig();
+         return DirTreeWalker::Action_CONTINUE;
+      };
 
-   const auto& targetPath = thisStatic->target.getPath().str();
-   chunksPath = targetPath + "/" + CONFIG_BUDDYMIRROR_SUBDIR_NAME;
+      auto handleError = [&] (const std::string& path, int errCode) {
+         // entries may be deleted by users while we walk
+         if (errCode != ENOENT)
+            LOG(MIRRORING, ERR, "Error during chunks walk.", pathStr, path, sysErr(errCode));
 
-   if (strlen(path) <= chunksPath.length())
-      return FTW_CONTINUE;
+         return true;
+      };
 
-   std::string relPathStr = path + chunksPath.size() + 1;
+      walker.walk(pathStr, handleEntry, handleError);
+   }
+}
 
-   if ( relPathStr.empty() )
-      return FTW_CONTINUE;
+int64_t BuddyResyncerGatherSlave::getLastBuddyCommTimeSecs()
+{
+   Config* cfg = Program::getApp()->getConfig();
 
-   const auto lastBuddyComm = thisStatic->target.getLastBuddyComm();
+   const auto lastBuddyComm = target.getLastBuddyComm();
 
    const bool buddyCommIsOverride = lastBuddyComm.first;
    int64_t lastBuddyCommTimeSecs = std::chrono::system_clock::to_time_t(lastBuddyComm.second);
@@ -125,38 +128,43 @@ int BuddyResyncerGatherSlave::handleDiscoveredEntry(const char* path,
    if (lastBuddyCommTimeSecs > lastBuddyCommSafetyThresholdSecs)
       lastBuddyCommTimeSecs -= lastBuddyCommSafetyThresholdSecs;
 
-   if(ftwEntryType == FTW_D) // directory
+   return lastBuddyCommTimeSecs;
+}
+
+/**
+ * @param relPath path relative to the buddy mirror chunks dir of the target
+ */
+void BuddyResyncerGatherSlave::handleDiscoveredEntry(const std::string& relPath,
+   const struct stat& statBuf, int64_t lastBuddyCommTimeSecs)
+{
+   if(S_ISDIR(statBuf.st_mode) ) // directory
    {
-      thisStatic->numDirsDiscovered.increase();
+      numDirsDiscovered.increase();
 
-      int64_t dirModificationTime = (int64_t)statBuf->st_mtim.tv_sec;
+      int64_t dirModificationTime = (int64_t)statBuf.st_mtim.tv_sec;
 
       if(dirModificationTime > lastBuddyCommTimeSecs)
       { // sync candidate
-         ChunkSyncCandidateDir candidate(relPathStr, thisStatic->target.getID());
-         thisStatic->syncCandidates->add(candidate, thisStatic);
-         thisStatic->numDirsMatched.increase();
+         ChunkSyncCandidateDir candidate(relPath, target.getID());
+         syncCandidates->add(candidate, this);
+         numDirsMatched.increase();
       }
    }
    else
-   if(ftwEntryType == FTW_F) // file
+   if(S_ISREG(statBuf.st_mode) ) // file
    {
       // we found a chunk
-      thisStatic->numChunksDiscovered.increase();
+      numChunksDiscovered.increase();
 
       // we need to use ctime here, because mtime can be set manually (even to the future)
-      time_t chunkChangeTime = statBuf->st_ctim.tv_sec;
+      time_t chunkChangeTime = statBuf.st_ctim.tv_sec;
 
       if(chunkChangeTime > lastBuddyCommTimeSecs)
       {  // sync candidate
-         std::string relPathStr = path + chunksPath.size() + 1;
-
-         ChunkSyncCandidateFile candidate(relPathStr, thisStatic->target.getID());
-         thisStatic->syncCandidates->add(candidate, thisStatic);
+         ChunkSyncCandidateFile candidate(relPath, target.getID());
+         syncCandidates->add(candidate, this);
 
-         thisStatic->numChunksMatched.increase();
+         numChunksMatched.increase();
       }
    }
-
-   return FTW_CONTINUE;
 }
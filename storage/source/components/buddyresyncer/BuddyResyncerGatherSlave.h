@@ -5,8 +5,6 @@
 #include <common/components/ComponentInitException.h>
 #include <common/threading/PThread.h>
 
-#include <ftw.h>
-
 class StorageTarget;
 
 #define GATHERSLAVEQUEUE_MAXSIZE 5000
@@ -117,14 +115,11 @@ class BuddyResyncerGatherSlave : public PThread
       ChunkSyncCandidateStore* syncCandidates;
       BuddyResyncerGatherSlaveWorkQueue* workQueue;
 
-      // nftw() callback needs access the slave threads
-      static Mutex staticGatherSlavesMutex;
-      static std::map<std::string, BuddyResyncerGatherSlave*> staticGatherSlaves;
-
       virtual void run();
 
-      static int handleDiscoveredEntry(const char* path, const struct stat* statBuf,
-         int ftwEntryType, struct FTW* ftwBuf);
+      void handleDiscoveredEntry(const std::string& relPath, const struct stat& statBuf,
+         int64_t lastBuddyCommTimeSecs);
+      int64_t getLastBuddyCommTimeSecs();
 
    public:
       // getters & setters
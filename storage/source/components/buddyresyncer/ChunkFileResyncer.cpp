@@ -2,6 +2,7 @@
 #include <common/net/message/storage/creating/RmChunkPathsRespMsg.h>
 #include <common/net/message/storage/mirroring/ResyncLocalFileMsg.h>
 #include <common/net/message/storage/mirroring/ResyncLocalFileRespMsg.h> 
+#include <toolkit/SparseFileTk.h>
 #include <toolkit/StorageTkEx.h>
 #include <program/Program.h>
 #include "ChunkFileResyncer.h"
@@ -83,6 +84,7 @@ FhgfsOpsErr ChunkFileResyncer::doResync(std::string& chunkPathStr, uint16_t loca
    int64_t offset = 0;
    ssize_t readRes = 0;
    unsigned resyncMsgFlags = 0;
+   bool holesReported = false; // true if holes can be skipped via SEEK_DATA/SEEK_HOLE
 
    LogContext(__func__).log(Log_DEBUG,
       "Copy chunk operation started. chunkPath: " + chunkPathStr + "; localTargetID: "
@@ -158,6 +160,25 @@ FhgfsOpsErr ChunkFileResyncer::doResync(std::string& chunkPathStr, uint16_t loca
          goto cleanup;
       }
 
+      if (!offset)
+         holesReported = SparseFileTk::getHolesReported(fd);
+
+      /* skip holes (but make sure we always send a msg at offset==0, see below). the extent end is
+         only known if the data extent of the current block was found. */
+      int64_t dataStart = -1;
+      int64_t dataEnd = -1;
+
+      if (holesReported)
+      {
+         dataStart = SparseFileTk::findDataExtent(fd, offset, dataEnd);
+
+         if (dataStart == -1)
+            holesReported = false; // => fall back to zero-scan
+         else
+         if (offset && (dataStart > offset) )
+            offset = dataStart - (dataStart % RESYNCER_SPARSE_BLOCK_SIZE);
+      }
+
       int seekRes = lseek(fd, offset, SEEK_SET);
 
       if (seekRes == -1)
@@ -189,17 +210,21 @@ FhgfsOpsErr ChunkFileResyncer::doResync(std::string& chunkPathStr, uint16_t loca
 
       if (readRes > 0)
       {
-         const char zeroBuf[RESYNCER_SPARSE_BLOCK_SIZE] = { 0 };
-
          // check if sparse blocks are in the buffer
          ssize_t bufPos = 0;
          bool dataFound = false;
+
+         if (holesReported && (dataStart <= offset) && (offset + readRes <= dataEnd) )
+         { // block is within a single data extent => no need to scan for zeros
+            dataFound = true;
+            bufPos = readRes;
+         }
+
          while (bufPos < readRes)
          {
             size_t cmpLen = BEEGFS_MIN(readRes-bufPos, RESYNCER_SPARSE_BLOCK_SIZE);
 
-            int cmpRes = memcmp(data.get() + bufPos, zeroBuf, cmpLen);
-            if (cmpRes != 0)
+            if (!SparseFileTk::isZeroBuf(data.get() + bufPos, cmpLen) )
                dataFound = true;
             else // sparse area detected
             {
@@ -184,6 +184,9 @@ int ChunkBalancerFileSyncSlave::getFD(const std::unique_ptr<StorageTarget> & tar
 
 FhgfsOpsErr ChunkBalancerFileSyncSlave::removeChunk(int& targetFD, std::string& relativePath)
 {
+   if (ChunkFDCache* fdCache = Program::getApp()->getChunkFDCache() )
+      fdCache->invalidate(targetFD, relativePath);
+
    int unlinkRes = unlinkat(targetFD, relativePath.c_str(), 0);
    if ( (unlinkRes != 0)  && (errno != ENOENT) )
    {
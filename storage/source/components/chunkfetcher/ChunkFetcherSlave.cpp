@@ -1,10 +1,8 @@
 #include "ChunkFetcherSlave.h"
 
+#include <common/toolkit/DirTreeWalker.h>
 #include <program/Program.h>
 
-#include <boost/static_assert.hpp>
-#include <libgen.h>
-
 ChunkFetcherSlave::ChunkFetcherSlave(uint16_t targetID):
    PThread("ChunkFetcherSlave-" + StringTk::uintToStr(targetID) ),
    log("ChunkFetcherSlave-" + StringTk::uintToStr(targetID) ),
@@ -52,7 +50,7 @@ void ChunkFetcherSlave::walkAllChunks()
 
    // walk over "normal" chunks (i.e. no mirrors)
    std::string walkPath = targetPath + "/" + CONFIG_CHUNK_SUBDIR_NAME;
-   if(!walkChunkPath(walkPath, 0, walkPath.size() ) )
+   if(!walkChunkPath(walkPath, 0) )
       return;
 
    // let's find out if this target is part of a buddy mirror group and if it is the primary
@@ -64,102 +62,52 @@ void ChunkFetcherSlave::walkAllChunks()
    if (isPrimaryTarget)
    {
       walkPath = targetPath + "/" CONFIG_BUDDYMIRROR_SUBDIR_NAME;
-      if(!walkChunkPath(walkPath, buddyGroupID, walkPath.size() ) )
+      if(!walkChunkPath(walkPath, buddyGroupID) )
          return;
    }
 
    log.log(Log_DEBUG, "End of chunks walk.");
 }
 
-bool ChunkFetcherSlave::walkChunkPath(const std::string& path, uint16_t buddyGroupID,
-   unsigned basePathLen)
+/**
+ * Walk over all chunks below the given path with tuneNumChunkFetchThreads threads.
+ */
+bool ChunkFetcherSlave::walkChunkPath(const std::string& path, uint16_t buddyGroupID)
 {
-   DIR* dir = ::opendir(path.c_str() );
-   if(!dir)
-   {
-      LOG(GENERAL, WARNING, "Could not open directory.", path, targetID, sysErr);
-      Program::getApp()->getChunkFetcher()->setBad();
-      return false;
-   }
+   App* app = Program::getApp();
+   ChunkFetcher* chunkFetcher = app->getChunkFetcher();
 
-   int readRes;
-   bool result = true;
+   auto handleEntry = [&] (const DirTreeWalker::Entry& entry) {
+      if (getSelfTerminate() )
+         return DirTreeWalker::Action_ABORT;
 
-   std::string pathBuf = path;
-   pathBuf.push_back('/');
+      if (entry.isDir)
+         return DirTreeWalker::Action_CONTINUE;
 
-   while(!getSelfTerminate())
-   {
-      ::dirent* item;
-
-      // we really want struct struct dirent to contain a reasonably sized array for the filename
-      BOOST_STATIC_ASSERT(sizeof(item->d_name) >= NAME_MAX + 1);
-
-#if USE_READDIR_R
-      ::dirent entry;
-      readRes = ::readdir_r(dir, &entry, &item);
-#else
-      errno = 0;
-      item = readdir(dir);
-      readRes = item ? 0 : errno;
-#endif
-      if(readRes != 0)
-      {
-         LOG(GENERAL, WARNING, "readdir failed.", path, targetID, sysErr(readRes));
-         result = false;
-         break;
-      }
-
-      if(!item)
-         break;
-
-      if(::strcmp(item->d_name, ".") == 0 || ::strcmp(item->d_name, "..") == 0)
-         continue;
-
-      pathBuf.resize(path.size() + 1);
-      pathBuf += item->d_name;
-
-      struct stat statBuf;
-
-      int statRes = ::stat(pathBuf.c_str(), &statBuf);
-      if(statRes)
-      {
-         LOG(GENERAL, WARNING, "Could not stat directory.", ("path", pathBuf), targetID, sysErr);
-         result = false;
-         break;
-      }
-
-      if(S_ISDIR(statBuf.st_mode) )
-      {
-         result = walkChunkPath(pathBuf, buddyGroupID, basePathLen);
-         if(!result)
-            break;
-      }
-      else
-      {
-         const char* relativeChunkPath = pathBuf.c_str() + basePathLen + 1;
-
-         // get only the dirname part of the path
-         char* tmpPathCopy = strdup(relativeChunkPath);
-         Path savedPath(dirname(tmpPathCopy) );
-
-         free(tmpPathCopy);
-
-         FsckChunk fsckChunk(item->d_name, targetID, savedPath, statBuf.st_size, statBuf.st_blocks,
-            statBuf.st_ctime, statBuf.st_mtime, statBuf.st_atime, statBuf.st_uid, statBuf.st_gid,
-            buddyGroupID);
-
-         Program::getApp()->getChunkFetcher()->addChunk(fsckChunk);
-      }
-   }
+      const struct stat& statBuf = *entry.statBuf;
+
+      // (chunks in the top level dir have "." as their saved path, like dirname() returns it)
+      FsckChunk fsckChunk(entry.name, targetID, Path(entry.dirPath.empty() ? "." : entry.dirPath),
+         statBuf.st_size, statBuf.st_blocks, statBuf.st_ctime, statBuf.st_mtime, statBuf.st_atime,
+         statBuf.st_uid, statBuf.st_gid, buddyGroupID);
+
+      chunkFetcher->addChunk(fsckChunk);
+
+      return DirTreeWalker::Action_CONTINUE;
+   };
+
+   auto handleError = [&] (const std::string& relPath, int errCode) {
+      LOG(GENERAL, WARNING, "Could not read chunks directory.", path, relPath, targetID,
+            sysErr(errCode));
+      return false;
+   };
 
-   ::closedir(dir);
+   DirTreeWalker walker(app->getConfig()->getTuneNumChunkFetchThreads(), true);
 
-   if (getSelfTerminate())
-      result = false;
+   const bool result = walker.walk(path, handleEntry, handleError);
 
    if(!result)
-      Program::getApp()->getChunkFetcher()->setBad();
+      chunkFetcher->setBad();
 
    return result;
 }
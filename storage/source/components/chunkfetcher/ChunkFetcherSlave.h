@@ -47,7 +47,7 @@ class ChunkFetcherSlave : public PThread
    private:
       void walkAllChunks();
 
-      bool walkChunkPath(const std::string& path, uint16_t buddyGroupID, unsigned basePathLen);
+      bool walkChunkPath(const std::string& path, uint16_t buddyGroupID);
 
       // getters & setters
 
@@ -1,6 +1,7 @@
 #include <common/app/log/LogContext.h>
 #include <common/benchmark/StorageBench.h>
 #include <common/toolkit/StringTk.h>
+#include <common/toolkit/TimeFine.h>
 #include <program/Program.h>
 #include "StorageBenchWork.h"
 
@@ -15,6 +16,11 @@ void StorageBenchWork::process(char* bufIn, unsigned bufInLen, char* bufOut,
    int workRes = 0; // return value for benchmark operator
    ssize_t ioRes = 0; // read/write result
 
+   TimeFine startTime;
+
+   // note: several blocks of a thread may be in flight concurrently (queue depth), so the file
+   // position of the shared file descriptor must not be used
+
    if (this->type == StorageBenchType_READ)
    {
       size_t readSize = cfg->getTuneFileReadSize();
@@ -25,7 +31,8 @@ void StorageBenchWork::process(char* bufIn, unsigned bufInLen, char* bufOut,
       {
          size_t currentReadSize = BEEGFS_MIN(readSize, toBeRead);
 
-         ioRes = read(this->fileDescriptor, &this->buf[bufOffset], currentReadSize);
+         ioRes = pread(this->fileDescriptor, &this->buf[bufOffset], currentReadSize,
+            this->offset + bufOffset);
          if (ioRes <= 0)
             break;
 
@@ -47,7 +54,8 @@ void StorageBenchWork::process(char* bufIn, unsigned bufInLen, char* bufOut,
       {
          size_t currentWriteSize = BEEGFS_MIN(writeSize, toBeWritten);
 
-         ioRes = write(this->fileDescriptor, &this->buf[bufOffset], currentWriteSize);
+         ioRes = pwrite(this->fileDescriptor, &this->buf[bufOffset], currentWriteSize,
+            this->offset + bufOffset);
          if (ioRes <= 0)
             break;
 
@@ -64,6 +72,11 @@ void StorageBenchWork::process(char* bufIn, unsigned bufInLen, char* bufOut,
       LogContext(logContext).logErr("Error: unknown benchmark type");
    }
 
+   StorageBenchWorkResult result;
+   result.threadID = this->threadID;
+   result.type = this->type;
+   result.latencyUS = startTime.elapsedMicro();
+
    if(unlikely(workRes < 0) || unlikely(ioRes == -1) )
    { // error occurred
       if (ioRes == -1)
@@ -72,13 +85,9 @@ void StorageBenchWork::process(char* bufIn, unsigned bufInLen, char* bufOut,
             System::getErrString() );
       }
 
-      workRes = STORAGEBENCH_ERROR_WORKER_ERROR;
-
-      this->operatorCommunication->getWriteFD()->write(&workRes, sizeof(int) );
-   }
-   else
-   { // success
-      this->operatorCommunication->getWriteFD()->write(&this->threadID, sizeof(int) );
+      result.threadID = STORAGEBENCH_ERROR_WORKER_ERROR;
    }
+
+   this->operatorCommunication->getWriteFD()->write(&result, sizeof(result) );
 }
 
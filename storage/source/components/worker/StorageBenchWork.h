@@ -6,18 +6,37 @@
 #include <common/Common.h>
 
 
+/*
+ * the report of a StorageBenchWork to the benchmark slave, small enough to be written to the pipe
+ * atomically
+ */
+struct StorageBenchWorkResult
+{
+   int32_t threadID; // virtual threadID or STORAGEBENCH_ERROR_WORKER_ERROR
+   int32_t type; // StorageBenchType_READ or StorageBenchType_WRITE
+   uint64_t latencyUS;
+};
 
+
+/*
+ * reads or writes one block of a benchmark file at the given offset
+ */
 class StorageBenchWork: public Work
 {
    public:
+      /*
+       * @param type StorageBenchType_READ or StorageBenchType_WRITE
+       */
       StorageBenchWork(uint16_t targetID, int threadID, int fileDescriptor,
-         StorageBenchType type, int64_t bufLen, Pipe* operatorCommunication, char* buf)
+         StorageBenchType type, int64_t offset, int64_t bufLen, Pipe* operatorCommunication,
+         char* buf)
       {
          this->targetID = targetID;
          this->threadID = threadID;
          this->fileDescriptor = fileDescriptor;
 
          this->type = type;
+         this->offset = offset;
          this->bufLen = bufLen;
          this->operatorCommunication = operatorCommunication;
          this->buf = buf;
@@ -36,8 +55,8 @@ class StorageBenchWork: public Work
       int threadID; // virtual threadID
       int fileDescriptor;
       StorageBenchType type;
+      int64_t offset;
       int64_t bufLen;
       char* buf;
       Pipe* operatorCommunication;
 };
-
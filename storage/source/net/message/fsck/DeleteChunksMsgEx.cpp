@@ -34,6 +34,10 @@ bool DeleteChunksMsgEx::processIncoming(ResponseContext& ctx)
       else
       { // valid targetID
          int targetFD = isMirrorFD ? *target->getMirrorFD() : *target->getChunkFD();
+
+         if (ChunkFDCache* fdCache = app->getChunkFDCache() )
+            fdCache->invalidate(targetFD, delPathStrRelative);
+
          int unlinkRes = unlinkat(targetFD, delPathStrRelative.c_str(), 0);
          if ( (unlinkRes == -1) && (errno != ENOENT) )
          { // error
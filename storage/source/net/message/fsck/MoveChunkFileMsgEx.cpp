@@ -81,7 +81,16 @@ unsigned MoveChunkFileMsgEx::moveChunk()
             + newPath + "; SysErr: " + System::getErrString());
       return 1;
    }
-   else if (getIsMirrored())
+
+   /* invalidate only after the rename, so that an open between invalidation and rename can't
+      cache an fd of the moved chunk under the old path again */
+   if (ChunkFDCache* fdCache = app->getChunkFDCache() )
+   {
+      fdCache->invalidate(targetFD, moveFrom);
+      fdCache->invalidate(targetFD, moveTo);
+   }
+
+   if (getIsMirrored())
       target->setBuddyNeedsResync(true);
 
    return 0;
@@ -4,6 +4,7 @@
 #include <common/storage/StoragePoolId.h>
 #include <common/toolkit/MessagingTk.h>
 #include <program/Program.h>
+#include <session/ReadAheadDetector.h>
 #include <session/ZfsSession.h>
 #include <toolkit/QuotaTk.h>
 #include "GenericDebugMsgEx.h"
@@ -17,6 +18,10 @@
 #define GENDBGMSG_OP_CHUNKLOCKSTORESIZE     "chunklockstoresize"
 #define GENDBGMSG_OP_CHUNKLOCKSTORECONTENTS "chunklockstore"
 #define GENDBGMSG_OP_SETREJECTIONRATE       "setrejectionrate"
+#define GENDBGMSG_OP_BUFFERPOOLSTATS        "bufferpoolstats"
+#define GENDBGMSG_OP_CHUNKFDCACHESTATS      "chunkfdcachestats"
+#define GENDBGMSG_OP_READAHEADSTATS         "readaheadstats"
+#define GENDBGMSG_OP_WRITEBACKSTATS         "writebackstats"
 
 
 bool GenericDebugMsgEx::processIncoming(ResponseContext& ctx)
@@ -86,6 +91,12 @@ std::string GenericDebugMsgEx::processCommand()
    if(operation == GENDBGMSG_OP_SETLOGLEVEL)
       responseStr = MsgHelperGenericDebug::processOpSetLogLevel(commandStream);
    else
+   if(operation == GENDBGMSG_OP_LOCKSTATS)
+      responseStr = MsgHelperGenericDebug::processOpLockStats(commandStream);
+   else
+   if(operation == GENDBGMSG_OP_OBJECTPOOLSTATS)
+      responseStr = MsgHelperGenericDebug::processOpObjectPoolStats(commandStream);
+   else
    if(operation == GENDBGMSG_OP_NETOUT)
       responseStr = MsgHelperGenericDebug::processOpNetOut(commandStream,
          app->getMgmtNodes(), app->getMetaNodes(), app->getStorageNodes() );
@@ -111,6 +122,18 @@ std::string GenericDebugMsgEx::processCommand()
    else
    if(operation == GENDBGMSG_OP_SETREJECTIONRATE)
       responseStr = processOpSetRejectionRate(commandStream);
+   else
+   if(operation == GENDBGMSG_OP_BUFFERPOOLSTATS)
+      responseStr = processOpBufferPoolStats(commandStream);
+   else
+   if(operation == GENDBGMSG_OP_CHUNKFDCACHESTATS)
+      responseStr = processOpChunkFDCacheStats(commandStream);
+   else
+   if(operation == GENDBGMSG_OP_READAHEADSTATS)
+      responseStr = processOpReadAheadStats(commandStream);
+   else
+   if(operation == GENDBGMSG_OP_WRITEBACKSTATS)
+      responseStr = processOpWritebackStats(commandStream);
    else
       responseStr = "Unknown/invalid operation";
 
@@ -205,6 +228,63 @@ std::string GenericDebugMsgEx::processOpMsgQueueStats(std::istringstream& comman
    return responseStream.str();
 }
 
+std::string GenericDebugMsgEx::processOpBufferPoolStats(std::istringstream& commandStream)
+{
+   // protocol: no arguments
+
+   const BufferPool* bufPool = Program::getApp()->getWorkerBufPool();
+
+   if(!bufPool)
+      return "Worker buffer pool is disabled (tuneUseWorkerBufPool).";
+
+   return bufPool->getStatsAsStr();
+}
+
+std::string GenericDebugMsgEx::processOpChunkFDCacheStats(std::istringstream& commandStream)
+{
+   // protocol: no arguments
+
+   const ChunkFDCache* fdCache = Program::getApp()->getChunkFDCache();
+
+   if(!fdCache)
+      return "Chunk fd cache is disabled (tuneChunkFDCacheSize).";
+
+   return fdCache->getStatsAsStr();
+}
+
+std::string GenericDebugMsgEx::processOpReadAheadStats(std::istringstream& commandStream)
+{
+   // protocol: no arguments
+
+   if(!Program::getApp()->getConfig()->getTuneFileReadAheadSize() )
+      return "Read-ahead is disabled (tuneFileReadAheadSize).";
+
+   return ReadAheadDetector::getGlobalStatsAsStr();
+}
+
+std::string GenericDebugMsgEx::processOpWritebackStats(std::istringstream& commandStream)
+{
+   // protocol: no arguments
+
+   if(!Program::getApp()->getConfig()->getTuneFileWriteSyncAdaptive() )
+      return "Adaptive writeback is disabled (tuneFileWriteSyncAdaptive).";
+
+   std::ostringstream responseStream;
+
+   for(const auto& mapping : Program::getApp()->getStorageTargets()->getTargets() )
+   {
+      const WritebackController* controller = mapping.second->getWritebackController();
+
+      if(!controller)
+         continue;
+
+      responseStream << "target " << mapping.first << ":" << std::endl;
+      responseStream << controller->getStatsAsStr() << std::endl;
+   }
+
+   return responseStream.str();
+}
+
 std::string GenericDebugMsgEx::processOpQuotaExceeded(std::istringstream& commandStream)
 {
    App* app = Program::getApp();
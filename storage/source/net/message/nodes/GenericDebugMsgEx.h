@@ -14,6 +14,10 @@ class GenericDebugMsgEx : public GenericDebugMsg
       std::string processOpListOpenFiles(std::istringstream& commandStream);
       std::string processOpVersion(std::istringstream& commandStream);
       std::string processOpMsgQueueStats(std::istringstream& commandStream);
+      std::string processOpBufferPoolStats(std::istringstream& commandStream);
+      std::string processOpChunkFDCacheStats(std::istringstream& commandStream);
+      std::string processOpReadAheadStats(std::istringstream& commandStream);
+      std::string processOpWritebackStats(std::istringstream& commandStream);
       std::string processOpQuotaExceeded(std::istringstream& commandStream);
       std::string processOpUsedQuota(std::istringstream& commandStream);
       std::string processOpResyncQueueLen(std::istringstream& commandStream);
@@ -9,6 +9,7 @@ bool StorageBenchControlMsgEx::processIncoming(ResponseContext& ctx)
    const char* logContext = "StorageBenchControlMsg incoming";
 
    StorageBenchResultsMap results;
+   StorageBenchLatencyMap latencyResults;
    int cmdErrorCode = STORAGEBENCH_ERROR_NO_ERROR;
 
    App* app = Program::getApp();
@@ -19,7 +20,7 @@ bool StorageBenchControlMsgEx::processIncoming(ResponseContext& ctx)
       case StorageBenchAction_START:
       {
          cmdErrorCode = storageBench->initAndStartStorageBench(&getTargetIDs(), getBlocksize(),
-            getSize(), getThreads(), getODirect(), getType() );
+            getSize(), getThreads(), getODirect(), getType(), getMode() );
       } break;
 
       case StorageBenchAction_STOP:
@@ -30,6 +31,7 @@ bool StorageBenchControlMsgEx::processIncoming(ResponseContext& ctx)
       case StorageBenchAction_STATUS:
       {
          storageBench->getStatusWithResults(&getTargetIDs(), &results);
+         storageBench->getLatencyResults(&getTargetIDs(), &latencyResults);
          cmdErrorCode = STORAGEBENCH_ERROR_NO_ERROR;
       } break;
 
@@ -58,9 +60,15 @@ bool StorageBenchControlMsgEx::processIncoming(ResponseContext& ctx)
       errorCode = storageBench->getLastRunErrorCode();
    }
 
-   ctx.sendResponse(
-         StorageBenchControlMsgResp(storageBench->getStatus(), getAction(),
-            storageBench->getType(), errorCode, results) );
+   StorageBenchControlMsgResp respMsg(storageBench->getStatus(), getAction(),
+      storageBench->getType(), errorCode, results);
+
+   // only requesters which know about modes also know about latency results
+   if (isMsgHeaderFeatureFlagSet(STORAGEBENCHCONTROLMSG_FLAG_HAS_MODE) &&
+       (getAction() == StorageBenchAction_STATUS) )
+      respMsg.setLatencyResults(latencyResults);
+
+   ctx.sendResponse(respMsg);
 
    return true;
 }
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <common/net/message/session/opening/CloseChunkFileMsg.h>
+#include <common/components/worker/ObjectPool.h>
 
-class CloseChunkFileMsgEx : public CloseChunkFileMsg
+class CloseChunkFileMsgEx : public CloseChunkFileMsg, public PooledObject
 {
    private:
       struct DynamicAttribs
@@ -250,7 +250,6 @@ int64_t ReadLocalFileMsgExBase<Msg, ReadState>::incrementalReadStatefulAndSendV2
    if( (oldOffset < 0) || (oldOffset != newOffset) )
    {
       sessionLocalFile->resetReadCounter(); // reset sequential read counter
-      sessionLocalFile->resetLastReadAheadTrigger();
    }
    else
    { // read continues at previous offset
@@ -279,6 +278,9 @@ int64_t ReadLocalFileMsgExBase<Msg, ReadState>::incrementalReadStatefulAndSendV2
       return -1;
    }
 
+   if(readAheadSize)
+      startReadAhead(sessionLocalFile, readAheadTriggerSize, readAheadSize);
+
    for( ; ; )
    {
       ssize_t readLength = getReadLength(readState, BEEGFS_MIN(maxReadAtOnceLen, readState.toBeRead));
@@ -314,8 +316,6 @@ int64_t ReadLocalFileMsgExBase<Msg, ReadState>::incrementalReadStatefulAndSendV2
             return -1;
          }
 
-         checkAndStartReadAhead(sessionLocalFile, readAheadTriggerSize, newOffset, readAheadSize);
-
          if(isFinal)
          { // we reached the end of the requested data
             return getCount();
@@ -385,44 +385,37 @@ int64_t ReadLocalFileMsgExBase<Msg, ReadState>::incrementalReadStatefulAndSendV2
 }
 
 /**
- * Starts read-ahead if enough sequential data has been read.
+ * Passes the requested range to the read-ahead detector of the session and reads ahead the ranges
+ * that it returns (sequential, strided or backward patterns).
  *
- * Note: if getDisableIO() is true, we assume the caller sets readAheadSize==0, so getDisableIO()
+ * Note: if getDisableIO() is true, we assume the caller does not call this, so getDisableIO()
  * is not checked explicitly within this function.
  *
- * @sessionLocalFile lastReadAheadOffset will be updated if read-head was triggered
- * @param readAheadTriggerSize the length of sequential IO that triggers read-ahead
- * @param currentOffset current file offset (where read-ahead would start)
+ * @param readAheadTriggerSize the length of sequential IO that triggers sequential read-ahead
+ * @param readAheadSize max size of the read-ahead window
  */
 template <class Msg, typename ReadState>
-void ReadLocalFileMsgExBase<Msg, ReadState>::checkAndStartReadAhead(SessionLocalFile* sessionLocalFile,
-   ssize_t readAheadTriggerSize, off_t currentOffset, off_t readAheadSize)
+void ReadLocalFileMsgExBase<Msg, ReadState>::startReadAhead(SessionLocalFile* sessionLocalFile,
+   ssize_t readAheadTriggerSize, off_t readAheadSize)
 {
    std::string logContext = Msg::logContextPref + " (read-ahead)";
 
-   if(!readAheadSize)
-      return;
-
-   int64_t readCounter = sessionLocalFile->getReadCounter();
-   int64_t nextReadAheadTrigger = sessionLocalFile->getLastReadAheadTrigger() ?
-      sessionLocalFile->getLastReadAheadTrigger() + readAheadSize : readAheadTriggerSize;
-
-   if(readCounter < nextReadAheadTrigger)
-      return; // we're not at the trigger point yet
+   ReadAheadDetector::RangeVec readAheadRanges;
 
-   /* start read-head...
-      (read-ahead is supposed to be non-blocking if there are free slots in the device IO queue) */
+   sessionLocalFile->getReadAheadDetector().recordRead(getOffset(), getCount(), readAheadSize,
+      readAheadTriggerSize, readAheadRanges);
 
-   LOG_DEBUG(logContext, Log_SPAM,
-      std::string("Starting read-ahead... ") +
-      "offset: " + StringTk::int64ToStr(currentOffset) + "; "
-      "size: " + StringTk::int64ToStr(readAheadSize) );
+   /* (read-ahead is supposed to be non-blocking if there are free slots in the device IO queue) */
 
-   MsgHelperIO::readAhead(*sessionLocalFile->getFD(), currentOffset, readAheadSize);
-
-   // update trigger
+   for (const ReadAheadDetector::Range& range : readAheadRanges)
+   {
+      LOG_DEBUG(logContext, Log_SPAM,
+         std::string("Starting read-ahead... ") +
+         "offset: " + StringTk::int64ToStr(range.offset) + "; "
+         "size: " + StringTk::int64ToStr(range.length) );
 
-   sessionLocalFile->setLastReadAheadTrigger(readCounter);
+      MsgHelperIO::readAhead(*sessionLocalFile->getFD(), range.offset, range.length);
+   }
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <common/net/message/session/rw/ReadLocalFileV2Msg.h>
+#include <common/components/worker/ObjectPool.h>
 #include <common/storage/StorageErrors.h>
 #include <session/SessionLocalFileStore.h>
 
@@ -27,7 +28,7 @@ struct ReadStateBase
 };
 
 template <class Msg, typename ReadState>
-class ReadLocalFileMsgExBase : public Msg
+class ReadLocalFileMsgExBase : public Msg, public PooledObject
 {
    public:
       bool processIncoming(NetMessage::ResponseContext& ctx);
@@ -37,8 +38,8 @@ class ReadLocalFileMsgExBase : public Msg
 
       FhgfsOpsErr openFile(const StorageTarget& target, SessionLocalFile* sessionLocalFile);
 
-      void checkAndStartReadAhead(SessionLocalFile* sessionLocalFile, ssize_t readAheadTriggerSize,
-         off_t currentOffset, off_t readAheadSize);
+      void startReadAhead(SessionLocalFile* sessionLocalFile, ssize_t readAheadTriggerSize,
+         off_t readAheadSize);
 
       int64_t incrementalReadStatefulAndSendV2(NetMessage::ResponseContext& ctx,
          SessionLocalFile* sessionLocalFile);
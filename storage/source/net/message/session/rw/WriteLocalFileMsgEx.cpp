@@ -202,7 +202,8 @@ std::pair<bool, int64_t> WriteLocalFileMsgExBase<Msg, WriteState>::write(NetMess
 
       // the actual write workhorse
 
-      int64_t writeLocalRes = incrementalRecvAndWriteStateful(ctx, sessionLocalFile.get());
+      int64_t writeLocalRes = incrementalRecvAndWriteStateful(ctx, sessionLocalFile.get(),
+         target->getWritebackController() );
 
       // update client result, offset etc.
 
@@ -294,11 +295,14 @@ ssize_t WriteLocalFileRDMAMsgSender::recvPadding(ResponseContext& ctx, int64_t t
 
 /**
  * Note: New offset is saved in the session by the caller afterwards (to make life easier).
+ *
+ * @param writebackController decides about sync_file_range() instead of tuneFileWriteSyncSize if
+ * set (i.e. if tuneFileWriteSyncAdaptive)
  * @return number of written bytes or negative fhgfs error code
  */
 template <class Msg, typename WriteState>
 int64_t WriteLocalFileMsgExBase<Msg, WriteState>::incrementalRecvAndWriteStateful(NetMessage::ResponseContext& ctx,
-   SessionLocalFile* sessionLocalFile)
+   SessionLocalFile* sessionLocalFile, WritebackController* writebackController)
 {
    std::string logContext = Msg::logContextPref + " (write incremental)";
    Config* cfg = Program::getApp()->getConfig();
@@ -323,10 +327,17 @@ int64_t WriteLocalFileMsgExBase<Msg, WriteState>::incrementalRecvAndWriteStatefu
 
       sessionLocalFile->incWriteCounter(getCount() );
 
-      ssize_t syncSize = unlikely(isMsgHeaderFeatureFlagSet(WRITELOCALFILEMSG_FLAG_DISABLE_IO) ) ?
-         0 : cfg->getTuneFileWriteSyncSize();
-      if (syncSize && (sessionLocalFile->getWriteCounter() >= syncSize) )
-         useSyncRange = true;
+      if (unlikely(isMsgHeaderFeatureFlagSet(WRITELOCALFILEMSG_FLAG_DISABLE_IO) ) )
+         useSyncRange = false;
+      else
+      if (writebackController)
+         useSyncRange = writebackController->getSyncNeeded(sessionLocalFile->getWriteCounter() );
+      else
+      {
+         ssize_t syncSize = cfg->getTuneFileWriteSyncSize();
+         if (syncSize && (sessionLocalFile->getWriteCounter() >= syncSize) )
+            useSyncRange = true;
+      }
    }
 
    // incrementally receive file contents...
@@ -364,10 +375,15 @@ int64_t WriteLocalFileMsgExBase<Msg, WriteState>::incrementalRecvAndWriteStatefu
       // write to underlying file system...
 
       int errCode = 0;
+      Time writeT;
       ssize_t writeRes = unlikely(isMsgHeaderFeatureFlagSet(WRITELOCALFILEMSG_FLAG_DISABLE_IO) )
          ? recvRes
          : doWrite(*fd, ctx.getBuffer(), recvRes, writeState.writeOffset, errCode);
 
+      if (writebackController && (writeRes > 0) &&
+          likely(!isMsgHeaderFeatureFlagSet(WRITELOCALFILEMSG_FLAG_DISABLE_IO) ) )
+         writebackController->recordWrite(writeRes, writeT.elapsedMicro() );
+
       writeState.toBeReceived -= recvRes;
 
       // handle write errors...
@@ -428,8 +444,13 @@ int64_t WriteLocalFileMsgExBase<Msg, WriteState>::incrementalRecvAndWriteStatefu
       off64_t syncSize = sessionLocalFile->getWriteCounter();
       off64_t syncOffset = getOffset() + getCount() - syncSize;
 
+      Time syncT;
+
       MsgHelperIO::syncFileRange(*fd, syncOffset, syncSize);
       sessionLocalFile->resetWriteCounter();
+
+      if (writebackController)
+         writebackController->recordWriteback(syncSize, syncT.elapsedMicro() );
    }
 
    return getCount();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <common/net/message/session/rw/WriteLocalFileMsg.h>
+#include <common/components/worker/ObjectPool.h>
 #include <common/net/message/session/rw/WriteLocalFileRespMsg.h>
 #include <session/SessionLocalFile.h>
 #include <common/storage/StorageErrors.h>
@@ -9,6 +10,7 @@
 #define WRITEMSG_MIRROR_RETRIES_NUM    1
 
 class StorageTarget;
+class WritebackController;
 
 /**
  * Contains common data needed by implementations of the network protocol
@@ -38,7 +40,7 @@ struct WriteStateBase
 
 
 template <class Msg, typename WriteState>
-class WriteLocalFileMsgExBase : public Msg
+class WriteLocalFileMsgExBase : public Msg, public PooledObject
 {
 
    private:
@@ -70,7 +72,7 @@ class WriteLocalFileMsgExBase : public Msg
       bool doSessionCheck();
 
       int64_t incrementalRecvAndWriteStateful(NetMessage::ResponseContext& ctx,
-         SessionLocalFile* sessionLocalFile);
+         SessionLocalFile* sessionLocalFile, WritebackController* writebackController);
 
       void incrementalRecvPadding(NetMessage::ResponseContext& ctx, int64_t padLen,
          SessionLocalFile* sessionLocalFile);
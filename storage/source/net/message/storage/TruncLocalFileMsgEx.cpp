@@ -195,6 +195,9 @@ FhgfsOpsErr TruncLocalFileMsgEx::truncFile(uint16_t targetId, int targetFD,
 
    FhgfsOpsErr clientErrRes = FhgfsOpsErr_SUCCESS;
 
+   if (ChunkFDCache* fdCache = app->getChunkFDCache() )
+      fdCache->invalidate(targetFD, chunkFilePathStr);
+
    int truncRes = MsgHelperIO::truncateAt(targetFD, chunkFilePathStr.c_str(), getFilesize() );
    if(!truncRes)
       return FhgfsOpsErr_SUCCESS; // truncate succeeded
@@ -32,6 +32,9 @@ bool RmChunkPathsMsgEx::processIncoming(ResponseContext& ctx)
       for(StringListIter iter = relativePaths.begin(); iter != relativePaths.end(); iter++)
       {
          // remove chunk
+         if (ChunkFDCache* fdCache = app->getChunkFDCache() )
+            fdCache->invalidate(targetFD, *iter);
+
          int unlinkRes = unlinkat(targetFD, (*iter).c_str(), 0);
 
          if ( (unlinkRes != 0)  && (errno != ENOENT) )
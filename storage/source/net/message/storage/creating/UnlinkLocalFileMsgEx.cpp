@@ -94,6 +94,9 @@ bool UnlinkLocalFileMsgEx::processIncoming(ResponseContext& ctx)
       StorageTk::getChunkDirChunkFilePath(pathInfo, getEntryID(), hasOrigFeature, chunkDirPath,
          chunkFilePathStr);
 
+      if (ChunkFDCache* fdCache = app->getChunkFDCache() )
+         fdCache->invalidate(targetFD, chunkFilePathStr);
+
       unlinkRes = unlinkat(targetFD, chunkFilePathStr.c_str(), 0);
 
       if( (unlinkRes == -1) && (errno != ENOENT) )
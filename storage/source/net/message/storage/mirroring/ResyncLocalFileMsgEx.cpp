@@ -2,6 +2,7 @@
 #include <common/net/message/storage/mirroring/ResyncLocalFileRespMsg.h>
 #include <common/toolkit/MessagingTk.h>
 #include <net/msghelpers/MsgHelperIO.h>
+#include <toolkit/SparseFileTk.h>
 #include <toolkit/StorageTkEx.h>
 
 #include <program/Program.h>
@@ -79,6 +80,10 @@ bool ResyncLocalFileMsgEx::processIncoming(ResponseContext& ctx)
    if (!offset && !isMsgHeaderFeatureFlagSet (RESYNCLOCALFILEMSG_FLAG_NODATA) )
       openFlags |= O_TRUNC;
 
+   // the chunk gets overwritten or truncated
+   if (ChunkFDCache* fdCache = app->getChunkFDCache() )
+      fdCache->invalidate(targetFD, relativeChunkPathStr);
+
    openRes = chunkStore->openChunkFile(targetFD, NULL, relativeChunkPathStr, true,
       openFlags, &fd, &quotaInfo, {});
 
@@ -213,14 +218,12 @@ bool ResyncLocalFileMsgEx::doWriteSparse(int fd, const char* buf, size_t count,
    int& outErrno)
 {
    size_t sumWriteRes = 0;
-   const char zeroBuf[ RESYNCER_SPARSE_BLOCK_SIZE ] = { 0 };
 
    do
    {
       size_t cmpLen = BEEGFS_MIN(count - sumWriteRes, RESYNCER_SPARSE_BLOCK_SIZE);
-      int cmpRes = memcmp(buf + sumWriteRes, zeroBuf, cmpLen);
 
-      if (!cmpRes)
+      if (SparseFileTk::isZeroBuf(buf + sumWriteRes, cmpLen) )
       { // sparse area
          sumWriteRes += cmpLen;
 
@@ -53,6 +53,8 @@ bool GetQuotaInfoMsgEx::processIncoming(ResponseContext& ctx)
          break;
    }
 
+   bool requestSucceeded = false;
+
    if(quotaBlockDevices.empty() )
       /* no quota data available but do not return an error during message processing, it's not
       the correct place for error handling in this case */
@@ -60,22 +62,73 @@ bool GetQuotaInfoMsgEx::processIncoming(ResponseContext& ctx)
    else
    {
       if(getQueryType() == QUERY_TYPE_SINGLE_ID)
-         QuotaTk::appendQuotaForID(getIDRangeStart(), getType(), &quotaBlockDevices,
-            &outQuotaDataList, &session);
+         requestSucceeded = QuotaTk::appendQuotaForID(getIDRangeStart(), getType(),
+            &quotaBlockDevices, &outQuotaDataList, &session);
       else
       if(getQueryType() == QUERY_TYPE_ID_RANGE)
-         QuotaTk::requestQuotaForRange(&quotaBlockDevices, getIDRangeStart(),
+         requestSucceeded = QuotaTk::requestQuotaForRange(&quotaBlockDevices, getIDRangeStart(),
             getIDRangeEnd(), getType(), &outQuotaDataList, &session);
       else
       if(getQueryType() == QUERY_TYPE_ID_LIST)
       {
-         QuotaTk::requestQuotaForList(&quotaBlockDevices, getIDList(), getType(),
-            &outQuotaDataList, &session);
+         requestSucceeded = QuotaTk::requestQuotaForList(&quotaBlockDevices, getIDList(),
+            getType(), &outQuotaDataList, &session);
       }
    }
 
+   GetQuotaInfoRespMsg respMsg(&outQuotaDataList, quotaInodeSupport);
+
+   if(isMsgHeaderFeatureFlagSet(GETQUOTAINFOMSG_FLAG_CHANGED_ONLY) )
+   {
+      if(reduceToChangedUsage(requestSucceeded, &outQuotaDataList) )
+         respMsg.addMsgHeaderFeatureFlag(GETQUOTAINFORESPMSG_FLAG_CHANGES_ONLY);
+   }
+
    // send response
-   ctx.sendResponse(GetQuotaInfoRespMsg(&outQuotaDataList, quotaInodeSupport) );
+   ctx.sendResponse(respMsg);
 
    return true;
 }
+
+/**
+ * Reduce the quota data of this request to the IDs whose usage changed since the previous request
+ * with GETQUOTAINFOMSG_FLAG_CHANGED_ONLY for the same targets.
+ *
+ * @param requestSucceeded false if the usage could not be determined completely, in which case the
+ *        complete usage is reported and the next request starts over with a complete report
+ * @param inOutQuotaDataList the usage of all requested IDs, reduced to the changes on return true
+ * @return true if the list was reduced to the changes
+ */
+bool GetQuotaInfoMsgEx::reduceToChangedUsage(bool requestSucceeded,
+   QuotaDataList* inOutQuotaDataList)
+{
+   QuotaUsageCache* usageCache = Program::getApp()->getQuotaUsageCache();
+
+   const uint16_t targetKey = (getTargetSelection() == GETQUOTACONFIG_ALL_TARGETS_ONE_REQUEST)
+      ? QUOTADATAMAPFORTARGET_ALL_TARGETS_ID
+      : getTargetNumID();
+
+   if(!requestSucceeded)
+   {
+      usageCache->invalidate(getType(), targetKey);
+      return false;
+   }
+
+   if(getQueryType() == QUERY_TYPE_ID_LIST)
+   {
+      if(getIDList()->empty() )
+         return false;
+
+      UIntSet idSet(getIDList()->begin(), getIDList()->end() );
+
+      return usageCache->reduceToChanges(getType(), targetKey, *idSet.begin(), *idSet.rbegin(),
+         &idSet, inOutQuotaDataList);
+   }
+
+   const unsigned rangeEnd = (getQueryType() == QUERY_TYPE_ID_RANGE)
+      ? getIDRangeEnd()
+      : getIDRangeStart();
+
+   return usageCache->reduceToChanges(getType(), targetKey, getIDRangeStart(), rangeEnd, NULL,
+      inOutQuotaDataList);
+}
@@ -10,5 +10,8 @@ class GetQuotaInfoMsgEx : public GetQuotaInfoMsg
 {
    public:
       virtual bool processIncoming(ResponseContext& ctx);
+
+   private:
+      bool reduceToChangedUsage(bool requestSucceeded, QuotaDataList* inOutQuotaDataList);
 };
 
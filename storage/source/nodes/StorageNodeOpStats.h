@@ -2,7 +2,7 @@
 
 
 #include <common/nodes/OpCounter.h>
-#include <common/nodes/OpCounter.h>
+#include <common/threading/Atomics.h>
 #include <common/nodes/Node.h>
 #include <common/nodes/NodeOpStats.h>
 
@@ -23,48 +23,20 @@ struct UserStorageOpStats
 class StorageNodeOpStats : public NodeOpStats
 {
    public:
+      StorageNodeOpStats() : NodeOpStats(StorageOpCounter_OpCounterLastEnum) {}
 
       /**
        * Update operation counter for the given nodeIP and userID.
        *
        * @param node IP of the node
        * @param operation the filesystem operation to count
-       *
-       * NOTE: If you need to change something here, don't forget to update the similar method
-       *       below.
        */
       void updateNodeOp(const IPAddress& nodeIP, StorageOpCounterTypes opType, unsigned userID)
       {
-         SafeRWLock safeLock(&lock, SafeRWLock_READ);
-         uint128_t cookieIP = nodeIP.toUint128();
-
-         NodeOpCounterMapIter nodeIter = clientCounterMap.find(cookieIP);
-         NodeOpCounterMapIter userIter = userCounterMap.find(userID);
-
-         if( (nodeIter == clientCounterMap.end() ) ||
-             (userIter == userCounterMap.end() ) )
-         { // nodeIP or userID NOT found in map yet, we need a write lock
-
-            safeLock.unlock(); // possible race, but insert below is a NOOP if key already exists
-            safeLock.lock(SafeRWLock_WRITE);
-
-            if(nodeIter == clientCounterMap.end() )
-            {
-               nodeIter = clientCounterMap.insert(
-                  NodeOpCounterMapVal(cookieIP, StorageOpCounter() ) ).first;
-            }
-
-            if(userIter == userCounterMap.end() )
-            {
-               userIter = userCounterMap.insert(
-                  NodeOpCounterMapVal(userID, StorageOpCounter() ) ).first;
-            }
-         }
-
-         nodeIter->second.increaseOpCounter(opType);
-         userIter->second.increaseOpCounter(opType);
+         Shard* shard = getThreadShard();
 
-         safeLock.unlock();
+         shard->getClientCounter(nodeIP.toUint128() ).increaseOpCounter(opType);
+         shard->getUserCounter(userID).increaseOpCounter(opType);
       }
 
       /**
@@ -72,45 +44,16 @@ class StorageNodeOpStats : public NodeOpStats
        * Almost similar as above, it just takes the additional bytes parameter and calls
        * increaseOpBytes().
        *
-       * NOTE: If you need to change something here, don't forget to update the similar method
-       *       above.
-       *
        * @param opType only StorageOpCounter_WRITEOPS and _READOPS allowed as value, they will be
        * internally converted to the corresponding PerUserStorageOpCounter types.
        */
       void updateNodeOp(const IPAddress& nodeIP, StorageOpCounterTypes operation, uint64_t bytes,
          unsigned userID)
       {
-         SafeRWLock safeLock(&lock, SafeRWLock_READ);
-
-         uint128_t cookieIP = nodeIP.toUint128();
-         NodeOpCounterMapIter nodeIter = clientCounterMap.find(cookieIP);
-         NodeOpCounterMapIter userIter = userCounterMap.find(userID);
-
-         if( (nodeIter == clientCounterMap.end() ) ||
-             (userIter == userCounterMap.end() ) )
-         { // nodeID or userID NOT found in map yet, we need a write lock
-
-            safeLock.unlock(); // possible race, but insert below is a NOOP if key already exists
-            safeLock.lock(SafeRWLock_WRITE);
-
-            if(nodeIter == clientCounterMap.end() )
-            {
-               nodeIter = clientCounterMap.insert(
-                  NodeOpCounterMapVal(cookieIP, StorageOpCounter() ) ).first;
-            }
-
-            if(userIter == userCounterMap.end() )
-            {
-               userIter = userCounterMap.insert(
-                  NodeOpCounterMapVal(userID, StorageOpCounter() ) ).first;
-            }
-         }
-
-         nodeIter->second.increaseStorageOpBytes(operation, bytes);
-         userIter->second.increaseStorageOpBytes(operation, bytes);
+         Shard* shard = getThreadShard();
 
-         safeLock.unlock();
+         shard->getClientCounter(nodeIP.toUint128() ).increaseStorageOpBytes(operation, bytes);
+         shard->getUserCounter(userID).increaseStorageOpBytes(operation, bytes);
       }
 
 };
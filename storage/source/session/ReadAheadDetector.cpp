@@ -0,0 +1,244 @@
+#include "ReadAheadDetector.h"
+
+#include <sstream>
+
+AtomicUInt64 ReadAheadDetector::globalNumReadAheads;
+AtomicUInt64 ReadAheadDetector::globalReadAheadBytes;
+AtomicUInt64 ReadAheadDetector::globalHitBytes;
+AtomicUInt64 ReadAheadDetector::globalWastedBytes;
+
+
+ReadAheadDetector::ReadAheadDetector() :
+   lastOffset(-1), lastLength(0), lastDistance(0), pattern(Pattern_NONE), confidence(0),
+   sequentialBytes(0), windowSize(0), hasReadAheadFrontier(false), readAheadFrontier(0),
+   trackedRanges(), nextTrackedRange(0), stats()
+{
+}
+
+/**
+ * Record a read of the client and get the ranges that should be read ahead now.
+ *
+ * @param maxWindowSize max number of bytes to read ahead (tuneFileReadAheadSize)
+ * @param sequentialTriggerSize length of sequential reads before sequential read-ahead starts
+ * (tuneFileReadAheadTriggerSize)
+ * @param outReadAheadRanges ranges to read ahead are appended
+ */
+void ReadAheadDetector::recordRead(int64_t offset, int64_t length, int64_t maxWindowSize,
+   int64_t sequentialTriggerSize, RangeVec& outReadAheadRanges)
+{
+   if (length <= 0 || maxWindowSize <= 0)
+      return;
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   const bool completedRange = accountHits(offset, length);
+
+   classify(offset, length);
+
+   if (!windowSize)
+      windowSize = std::max(std::min<int64_t>(MIN_WINDOW_SIZE, maxWindowSize), maxWindowSize / 4);
+   else
+   if (completedRange)
+      adaptWindow(true, maxWindowSize);
+
+   switch (pattern)
+   {
+      case Pattern_SEQUENTIAL:
+         addSequentialRanges(offset, length, maxWindowSize, sequentialTriggerSize,
+            outReadAheadRanges);
+         break;
+
+      case Pattern_STRIDED:
+      case Pattern_BACKWARD:
+         if (confidence >= STRIDE_CONFIDENCE)
+            addStridedRanges(offset, length, maxWindowSize, outReadAheadRanges);
+         break;
+
+      default:
+         break;
+   }
+}
+
+/**
+ * Count the bytes of the given read that were read ahead before.
+ *
+ * @return true if the read completed a read-ahead range
+ */
+bool ReadAheadDetector::accountHits(int64_t offset, int64_t length)
+{
+   bool completedRange = false;
+
+   for (TrackedRange& range : trackedRanges)
+   {
+      if (range.hitBytes == range.length)
+         continue; // (also skips unused slots)
+
+      const int64_t overlapStart = std::max(offset, range.offset);
+      const int64_t overlapEnd = std::min(offset + length, range.offset + range.length);
+
+      if (overlapEnd <= overlapStart)
+         continue;
+
+      const int64_t hitBytes = std::min(overlapEnd - overlapStart, range.length - range.hitBytes);
+
+      range.hitBytes += hitBytes;
+
+      stats.hitBytes += hitBytes;
+      globalHitBytes.increase(hitBytes);
+
+      if (range.hitBytes == range.length)
+         completedRange = true;
+   }
+
+   return completedRange;
+}
+
+void ReadAheadDetector::classify(int64_t offset, int64_t length)
+{
+   Pattern newPattern = Pattern_NONE;
+   int64_t distance = 0;
+
+   if (lastOffset >= 0)
+   {
+      distance = offset - lastOffset;
+
+      if (offset == lastOffset + lastLength)
+         newPattern = Pattern_SEQUENTIAL;
+      else
+      if (distance && distance == lastDistance)
+         newPattern = distance > 0 ? Pattern_STRIDED : Pattern_BACKWARD;
+   }
+
+   if (newPattern != Pattern_NONE && newPattern == pattern)
+      confidence++;
+   else
+   { // pattern changed => start over
+      pattern = newPattern;
+      confidence = 1;
+      sequentialBytes = (newPattern == Pattern_SEQUENTIAL) ? lastLength : 0;
+      windowSize = 0;
+      hasReadAheadFrontier = false;
+   }
+
+   if (pattern == Pattern_SEQUENTIAL)
+      sequentialBytes += length;
+
+   lastOffset = offset;
+   lastLength = length;
+   lastDistance = distance;
+}
+
+void ReadAheadDetector::addSequentialRanges(int64_t offset, int64_t length,
+   int64_t maxWindowSize, int64_t sequentialTriggerSize, RangeVec& outReadAheadRanges)
+{
+   if (sequentialBytes < sequentialTriggerSize)
+      return;
+
+   const int64_t readEnd = offset + length;
+   const int64_t windowEnd = readEnd + windowSize;
+   const int64_t rangeStart = hasReadAheadFrontier
+      ? std::max(readEnd, readAheadFrontier)
+      : readEnd;
+
+   // wait until at least half of the window is uncovered to avoid lots of small read-aheads
+   if (windowEnd - rangeStart < windowSize / 2)
+      return;
+
+   addRange(rangeStart, windowEnd - rangeStart, maxWindowSize, outReadAheadRanges);
+
+   hasReadAheadFrontier = true;
+   readAheadFrontier = windowEnd;
+}
+
+void ReadAheadDetector::addStridedRanges(int64_t offset, int64_t length, int64_t maxWindowSize,
+   RangeVec& outReadAheadRanges)
+{
+   const int64_t distance = lastDistance;
+   const int64_t numStrides = std::min<int64_t>(std::max<int64_t>(windowSize / length, 1),
+      MAX_STRIDES_PER_WINDOW);
+
+   for (int64_t i = 1; i <= numStrides; i++)
+   {
+      const int64_t rangeOffset = offset + i * distance;
+
+      if (rangeOffset < 0)
+         break; // backward read reached the beginning of the file
+
+      if (hasReadAheadFrontier &&
+          (distance > 0 ? rangeOffset < readAheadFrontier : rangeOffset > readAheadFrontier) )
+         continue; // read ahead before
+
+      addRange(rangeOffset, length, maxWindowSize, outReadAheadRanges);
+
+      hasReadAheadFrontier = true;
+      readAheadFrontier = rangeOffset + distance;
+   }
+}
+
+/**
+ * Add a range to the output and track it for hits. The range that it replaces in the tracking list
+ * is accounted as waste if it was not read completely.
+ */
+void ReadAheadDetector::addRange(int64_t offset, int64_t length, int64_t maxWindowSize,
+   RangeVec& outReadAheadRanges)
+{
+   TrackedRange& slot = trackedRanges[nextTrackedRange];
+
+   nextTrackedRange = (nextTrackedRange + 1) % NUM_TRACKED_RANGES;
+
+   const int64_t wastedBytes = slot.length - slot.hitBytes;
+   if (wastedBytes > 0)
+   {
+      stats.wastedBytes += wastedBytes;
+      globalWastedBytes.increase(wastedBytes);
+
+      adaptWindow(false, maxWindowSize);
+   }
+
+   slot = TrackedRange{offset, length, 0};
+
+   stats.numReadAheads++;
+   stats.readAheadBytes += length;
+   globalNumReadAheads.increase();
+   globalReadAheadBytes.increase(length);
+
+   outReadAheadRanges.push_back(Range{offset, length});
+}
+
+/**
+ * Double or halve the read-ahead window.
+ */
+void ReadAheadDetector::adaptWindow(bool grow, int64_t maxWindowSize)
+{
+   const int64_t minWindowSize = std::min<int64_t>(MIN_WINDOW_SIZE, maxWindowSize);
+
+   if (grow)
+      windowSize = std::min(windowSize * 2, maxWindowSize);
+   else
+      windowSize = std::max(windowSize / 2, minWindowSize);
+}
+
+/**
+ * @return read-ahead statistics of all session files since the server was started
+ */
+ReadAheadDetector::Stats ReadAheadDetector::getGlobalStats()
+{
+   return Stats{globalNumReadAheads.read(), globalReadAheadBytes.read(), globalHitBytes.read(),
+      globalWastedBytes.read()};
+}
+
+std::string ReadAheadDetector::getGlobalStatsAsStr()
+{
+   const Stats currentStats = getGlobalStats();
+
+   std::ostringstream statsStream;
+
+   statsStream << "read-aheads: " << currentStats.numReadAheads << std::endl;
+   statsStream << "read-ahead bytes: " << currentStats.readAheadBytes << std::endl;
+   statsStream << "hit bytes: " << currentStats.hitBytes << std::endl;
+   statsStream << "wasted bytes: " << currentStats.wastedBytes << std::endl;
+   statsStream << "hit ratio: " << (currentStats.readAheadBytes ?
+      (currentStats.hitBytes * 100 / currentStats.readAheadBytes) : 0) << "%" << std::endl;
+
+   return statsStream.str();
+}
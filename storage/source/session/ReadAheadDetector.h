@@ -0,0 +1,123 @@
+#pragma once
+
+#include <common/Common.h>
+#include <common/threading/Atomics.h>
+#include <common/threading/Mutex.h>
+
+#include <array>
+#include <mutex>
+
+
+/**
+ * Detects the access pattern of the reads of a session file and decides which file ranges should
+ * be read ahead.
+ *
+ * Recognized patterns are sequential reads, strided reads (same distance between the start offsets
+ * of consecutive reads, e.g. HDF5 hyperslabs or MPI-IO collective buffering) and backward reads
+ * (strided with a negative distance, e.g. reverse scans).
+ *
+ * The read-ahead window adapts to how useful the previous read-ahead was: it grows when read-ahead
+ * ranges are read by the client ("hits") and shrinks when ranges are dropped from the tracking list
+ * without having been read completely ("waste").
+ */
+class ReadAheadDetector
+{
+   public:
+      enum Pattern
+      {
+         Pattern_NONE = 0,
+         Pattern_SEQUENTIAL,
+         Pattern_STRIDED,
+         Pattern_BACKWARD,
+      };
+
+      enum
+      {
+         MIN_WINDOW_SIZE = 64*1024,
+         MAX_STRIDES_PER_WINDOW = 16, // max number of strided ranges read ahead at once
+         NUM_TRACKED_RANGES = 16, // read-ahead ranges that are checked for hits
+         STRIDE_CONFIDENCE = 2, // number of equal distances before strides are read ahead
+      };
+
+      struct Range
+      {
+         int64_t offset;
+         int64_t length;
+      };
+
+      typedef std::vector<Range> RangeVec;
+
+      struct Stats
+      {
+         uint64_t numReadAheads; // number of read-ahead ranges
+         uint64_t readAheadBytes;
+         uint64_t hitBytes; // read-ahead bytes that were read by the client afterwards
+         uint64_t wastedBytes; // read-ahead bytes that were not read while they were tracked
+      };
+
+      ReadAheadDetector();
+
+      void recordRead(int64_t offset, int64_t length, int64_t maxWindowSize,
+         int64_t sequentialTriggerSize, RangeVec& outReadAheadRanges);
+
+      static Stats getGlobalStats();
+      static std::string getGlobalStatsAsStr();
+
+   private:
+      struct TrackedRange
+      {
+         int64_t offset;
+         int64_t length;
+         int64_t hitBytes;
+      };
+
+      Mutex mutex;
+
+      int64_t lastOffset; // negative if there was no read yet
+      int64_t lastLength;
+      int64_t lastDistance; // distance between the start offsets of the last two reads
+
+      Pattern pattern;
+      unsigned confidence; // number of consecutive reads that matched the pattern
+      int64_t sequentialBytes; // length of the current sequential run
+
+      int64_t windowSize; // 0 means not initialized for the current pattern
+      bool hasReadAheadFrontier; // false if nothing was read ahead for the current pattern yet
+      int64_t readAheadFrontier; // next offset (in pattern direction) that was not read ahead yet
+
+      std::array<TrackedRange, NUM_TRACKED_RANGES> trackedRanges;
+      unsigned nextTrackedRange; // ring buffer index
+
+      Stats stats;
+
+      static AtomicUInt64 globalNumReadAheads;
+      static AtomicUInt64 globalReadAheadBytes;
+      static AtomicUInt64 globalHitBytes;
+      static AtomicUInt64 globalWastedBytes;
+
+      bool accountHits(int64_t offset, int64_t length);
+      void classify(int64_t offset, int64_t length);
+      void addSequentialRanges(int64_t offset, int64_t length, int64_t maxWindowSize,
+         int64_t sequentialTriggerSize, RangeVec& outReadAheadRanges);
+      void addStridedRanges(int64_t offset, int64_t length, int64_t maxWindowSize,
+         RangeVec& outReadAheadRanges);
+      void addRange(int64_t offset, int64_t length, int64_t maxWindowSize,
+         RangeVec& outReadAheadRanges);
+      void adaptWindow(bool grow, int64_t maxWindowSize);
+
+   public:
+      // getters & setters
+
+      Pattern getPattern()
+      {
+         const std::lock_guard<Mutex> lock(mutex);
+         return pattern;
+      }
+
+      Stats getStats()
+      {
+         const std::lock_guard<Mutex> lock(mutex);
+         return stats;
+      }
+};
+
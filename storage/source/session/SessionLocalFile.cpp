@@ -2,6 +2,7 @@
 #include <common/storage/quota/ExceededQuotaStore.h>
 #include <net/msghelpers/MsgHelperIO.h>
 #include <program/Program.h>
+#include <storage/ChunkFDCache.h>
 #include <storage/ChunkStore.h>
 
 #include "SessionLocalFile.h"
@@ -11,6 +12,18 @@ bool SessionLocalFile::Handle::close()
    if (!fd.valid())
       return true;
 
+   if (cacheTargetFD != -1)
+   {
+      ChunkFDCache* fdCache = Program::getApp()->getChunkFDCache();
+      if (fdCache)
+      {
+         fdCache->put(cacheTargetFD, cacheChunkPath, cacheOpenFlags, cacheGeneration,
+            std::move(fd) );
+         LOG(GENERAL, DEBUG, "Local file parked in fd cache.", id);
+         return true;
+      }
+   }
+
    if (const int err = fd.close())
    {
       LOG(GENERAL, ERR, "Unable to close local file.", sysErr(err), id);
@@ -119,8 +132,24 @@ FhgfsOpsErr SessionLocalFile::openFile(int targetFD, const PathInfo* pathInfo,
       {  // just reading the file, no create
          mode_t openMode = S_IRWXU|S_IRWXG|S_IRWXO;
 
-         fd = MsgHelperIO::openat(targetFD, chunkFilePathStr.c_str(), this->openFlags,
-            openMode);
+         ChunkFDCache* fdCache = app->getChunkFDCache();
+         const bool useFDCache = fdCache && ChunkFDCache::isCacheable(this->openFlags);
+
+         if (useFDCache)
+         {
+            // (before the open, so that an invalidation in between keeps close() from parking it)
+            handle->cacheGeneration = fdCache->getGeneration(targetFD, chunkFilePathStr);
+
+            fd = fdCache->take(targetFD, chunkFilePathStr, this->openFlags).release();
+
+            handle->cacheTargetFD = targetFD;
+            handle->cacheChunkPath = chunkFilePathStr;
+            handle->cacheOpenFlags = this->openFlags;
+         }
+
+         if (fd == -1)
+            fd = MsgHelperIO::openat(targetFD, chunkFilePathStr.c_str(), this->openFlags,
+               openMode);
 
          if(fd == -1)
          { // not exists or error
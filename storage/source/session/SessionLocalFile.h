@@ -7,6 +7,7 @@
 #include <common/storage/quota/QuotaData.h>
 #include <common/threading/Mutex.h>
 #include <common/toolkit/FDHandle.h>
+#include "ReadAheadDetector.h"
 
 #include <atomic>
 
@@ -36,6 +37,11 @@ class SessionLocalFile
          private:
             std::string id;
             FDHandle fd;
+            // set if close() may hand the fd over to the ChunkFDCache
+            int cacheTargetFD = -1;
+            std::string cacheChunkPath;
+            int cacheOpenFlags = 0;
+            uint64_t cacheGeneration = 0; // see ChunkFDCache::getGeneration()
             // for use by SessionLocalFile::releaseLastReference. only one caller may receive the
             // handle if multiple threads try to release the last reference concurrently. we could
             // also do this under a lock in SessionLocalFileStore but don't since we don't expect
@@ -135,7 +141,9 @@ class SessionLocalFile
 
       AtomicInt64 writeCounter; // how much sequential data we have written after open/sync_file_range
       AtomicInt64 readCounter; // how much sequential data we have read since open / last seek
-      AtomicInt64 lastReadAheadTrigger; // last readCounter value at which read-ahead was triggered
+      AtomicInt64 lastReadAheadTrigger; // unused, kept for the format of the sessions file
+
+      ReadAheadDetector readAheadDetector; // (not serialized, starts over after restart)
 
       Mutex sessionMutex;
 
@@ -261,19 +269,9 @@ class SessionLocalFile
          this->readCounter.increase(size);
       }
 
-      int64_t getLastReadAheadTrigger()
-      {
-         return this->lastReadAheadTrigger.read();
-      }
-
-      void resetLastReadAheadTrigger()
-      {
-         this->lastReadAheadTrigger.setZero();
-      }
-
-      void setLastReadAheadTrigger(int64_t lastReadAheadTrigger)
+      ReadAheadDetector& getReadAheadDetector()
       {
-         this->lastReadAheadTrigger.set(lastReadAheadTrigger);
+         return readAheadDetector;
       }
 
       bool isServerCrashed()
@@ -31,6 +31,6 @@ class SessionStore
    private:
       std::map<NumNodeID, std::shared_ptr<Session>> sessions;
 
-      mutable Mutex mutex;
+      mutable Mutex mutex{"SessionStore::mutex"};
 };
 
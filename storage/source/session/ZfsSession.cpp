@@ -19,6 +19,7 @@ ZfsSession::ZfsSession()
    this->zfs_prop_get_userquota_int = NULL;
    this->libzfs_error_description = NULL;
    this->libzfs_error_action = NULL;
+   this->zfs_userspace = NULL;
 
    this->isValid = false;
 }
@@ -108,6 +109,16 @@ bool ZfsSession::initZfsSession(void* dlOpenHandleLib)
       return false;
    }
 
+
+   // optional, quota requests fall back to one request per ID if it's not available
+   this->zfs_userspace = (int (*)(void*, int, ZfsUserspaceCallback, void*))dlsym(
+      this->dlOpenHandleLibZfs, "zfs_userspace");
+   if ( (dlErrorString = dlerror() ) != NULL)
+   {
+      LOG(QUOTA, DEBUG, "Function zfs_userspace not available in libzfs.", dlErrorString);
+      this->zfs_userspace = NULL;
+   }
+
    return this->isValid;
 }
 
@@ -11,6 +11,9 @@ typedef std::map<uint16_t, void*> ZfsPoolHandleMap; // targetNumID => zfs_handle
 typedef ZfsPoolHandleMap::iterator ZfsPoolHandleMapIter;
 typedef ZfsPoolHandleMap::value_type ZfsPoolHandleMapMapVal;
 
+// zfs_userspace_cb_t; newer libzfs versions pass additional arguments, which are ignored
+typedef int (*ZfsUserspaceCallback)(void* arg, const char* domain, uid_t rid, uint64_t space);
+
 
 class ZfsSession
 {
@@ -25,6 +28,9 @@ class ZfsSession
       char* (*libzfs_error_description)(void*); // fp to get error description
       char* (*libzfs_error_action)(void*); // fp to get action during the error occurs
 
+      // fp to enumerate the used space of all users/groups, optional (NULL if not available)
+      int (*zfs_userspace)(void*, int, ZfsUserspaceCallback, void*);
+
 
    private:
       void* dlOpenHandleLibZfs;     // handle of dlOpen from the libzfs
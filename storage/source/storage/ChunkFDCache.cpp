@@ -0,0 +1,222 @@
+#include <common/toolkit/StringTk.h>
+#include "ChunkFDCache.h"
+
+#include <climits>
+#include <functional>
+#include <sys/stat.h>
+
+
+ChunkFDCache::ChunkFDCache(size_t maxSize) :
+   maxSize(maxSize), generations(NUM_GENERATION_BUCKETS, 0), stats()
+{
+   stats.maxSize = maxSize;
+}
+
+/**
+ * @return the invalidation generation of the chunk, to be noted before the chunk is opened (or
+ *    taken) and passed to put() later
+ */
+uint64_t ChunkFDCache::getGeneration(int targetFD, const std::string& chunkPath) const
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   return generations[getBucket(targetFD, chunkPath)];
+}
+
+/**
+ * Take over a cached fd of the given chunk. The fd is removed from the cache, so the caller owns
+ * it exclusively.
+ *
+ * @param openFlags the flags the caller would use to open the chunk
+ * @return an invalid handle if no usable fd was cached
+ */
+FDHandle ChunkFDCache::take(int targetFD, const std::string& chunkPath, int openFlags)
+{
+   FDHandle fd;
+
+   {
+      const std::lock_guard<Mutex> lock(mutex);
+
+      auto iter = entries.find(Key{targetFD, chunkPath, getFlagsClass(openFlags)});
+      if (iter == entries.end() )
+      {
+         stats.numMisses++;
+         return FDHandle();
+      }
+
+      fd = removeEntryUnlocked(iter);
+   }
+
+   // safety net for unlinks that didn't go through invalidate()
+   struct stat statBuf;
+
+   if (fstat(fd.get(), &statBuf) || !statBuf.st_nlink)
+   {
+      const std::lock_guard<Mutex> lock(mutex);
+
+      stats.numStale++;
+      stats.numMisses++;
+      return FDHandle();
+   }
+
+   const std::lock_guard<Mutex> lock(mutex);
+   stats.numHits++;
+
+   return fd;
+}
+
+/**
+ * Park an fd that would be closed otherwise. Evicts the least recently used entry if the cache is
+ * full. If an fd of the same chunk and flags class is cached already, or if the chunk was
+ * invalidated since the fd was opened, the given fd is closed.
+ *
+ * @param openFlags the flags the fd was opened with, must be cacheable (see isCacheable())
+ * @param generation the result of getGeneration() from before the fd was opened
+ */
+void ChunkFDCache::put(int targetFD, const std::string& chunkPath, int openFlags,
+   uint64_t generation, FDHandle fd)
+{
+   FDHandle evictedFD; // closed after the mutex is released
+
+   if (!maxSize || !fd.valid() )
+      return;
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   if (generations[getBucket(targetFD, chunkPath)] != generation)
+   {
+      evictedFD = std::move(fd);
+      stats.numRefused++;
+      return;
+   }
+
+   auto insertRes = entries.insert({Key{targetFD, chunkPath, getFlagsClass(openFlags)},
+      lru.end()});
+   if (!insertRes.second)
+   {
+      // keep the cached one, it's as good as ours, but refresh its position
+      lru.splice(lru.begin(), lru, insertRes.first->second);
+      evictedFD = std::move(fd);
+      return;
+   }
+
+   lru.push_front(Entry{std::move(fd), insertRes.first});
+   insertRes.first->second = lru.begin();
+
+   if (lru.size() > maxSize)
+   {
+      evictedFD = removeEntryUnlocked(lru.back().mapIter);
+      stats.numEvictions++;
+   }
+}
+
+/**
+ * Drop all cached fds of a chunk. Must be called before a chunk file is unlinked, replaced or
+ * truncated, and after it was renamed (an open of the old path in between could cache it again).
+ */
+void ChunkFDCache::invalidate(int targetFD, const std::string& chunkPath)
+{
+   std::vector<FDHandle> droppedFDs; // closed after the mutex is released
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   // fds that sessions still use must not be parked after this
+   generations[getBucket(targetFD, chunkPath)]++;
+
+   auto iter = entries.lower_bound(Key{targetFD, chunkPath, INT_MIN});
+
+   while (iter != entries.end() && iter->first.targetFD == targetFD &&
+      iter->first.chunkPath == chunkPath)
+   {
+      droppedFDs.push_back(removeEntryUnlocked(iter++) );
+      stats.numInvalidations++;
+   }
+}
+
+/**
+ * Drop all cached fds, e.g. before a target is resynced as a whole.
+ */
+void ChunkFDCache::invalidateAll()
+{
+   EntryList droppedEntries; // closed after the mutex is released
+
+   const std::lock_guard<Mutex> lock(mutex);
+
+   for (auto& generation : generations)
+      generation++;
+
+   stats.numInvalidations += lru.size();
+   entries.clear();
+   droppedEntries.swap(lru);
+}
+
+ChunkFDCache::Stats ChunkFDCache::getStats() const
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   Stats result = stats;
+   result.numCached = lru.size();
+
+   return result;
+}
+
+std::string ChunkFDCache::getStatsAsStr() const
+{
+   const Stats currentStats = getStats();
+
+   const uint64_t numLookups = currentStats.numHits + currentStats.numMisses;
+
+   std::ostringstream statsStream;
+
+   statsStream << "cached: " << currentStats.numCached << "/" << currentStats.maxSize << std::endl;
+   statsStream << "hits: " << currentStats.numHits << std::endl;
+   statsStream << "misses: " << currentStats.numMisses << std::endl;
+   statsStream << "hit ratio: " <<
+      (numLookups ? (currentStats.numHits * 100 / numLookups) : 0) << "%" << std::endl;
+   statsStream << "stale: " << currentStats.numStale << std::endl;
+   statsStream << "evictions: " << currentStats.numEvictions << std::endl;
+   statsStream << "invalidations: " << currentStats.numInvalidations << std::endl;
+   statsStream << "refused: " << currentStats.numRefused << std::endl;
+
+   return statsStream.str();
+}
+
+/**
+ * @return true if fds opened with these flags may be cached
+ */
+bool ChunkFDCache::isCacheable(int openFlags)
+{
+   return (openFlags & O_ACCMODE) == O_RDONLY && !(openFlags & O_TRUNC);
+}
+
+/**
+ * The flags that make a difference for an fd that is already open.
+ */
+int ChunkFDCache::getFlagsClass(int openFlags)
+{
+   return openFlags & ~(O_CREAT | O_EXCL | O_TRUNC | O_NOCTTY | O_CLOEXEC);
+}
+
+/**
+ * @return index of the invalidation generation of the chunk
+ */
+size_t ChunkFDCache::getBucket(int targetFD, const std::string& chunkPath)
+{
+   return (std::hash<std::string>()(chunkPath) ^ std::hash<int>()(targetFD) ) %
+      NUM_GENERATION_BUCKETS;
+}
+
+/**
+ * @return the fd of the removed entry
+ */
+FDHandle ChunkFDCache::removeEntryUnlocked(EntryMap::iterator iter)
+{
+   auto lruIter = iter->second;
+
+   FDHandle fd = std::move(lruIter->fd);
+
+   lru.erase(lruIter);
+   entries.erase(iter);
+
+   return fd;
+}
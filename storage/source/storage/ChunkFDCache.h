@@ -0,0 +1,114 @@
+#pragma once
+
+#include <common/threading/Mutex.h>
+#include <common/toolkit/FDHandle.h>
+#include <common/Common.h>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * Bounded LRU cache of open chunk file descriptors, shared by all sessions. When a client closes a
+ * chunk file that was opened read-only, the fd is parked here instead of being closed, and the next
+ * open of the same chunk with the same flags (by any session) takes it over instead of resolving
+ * the chunk path and opening the file again.
+ *
+ * Only read-only fds are cached. Closing write fds has side effects that callers rely on, e.g. the
+ * release of preallocated blocks before the dynamic attribs are reported by CloseChunkFileMsg.
+ *
+ * Entries are keyed by the fd of the target (or buddy mirror) directory, the chunk path relative
+ * to it and the relevant open flags. An fd is always owned by exactly one session or by the cache,
+ * never shared, so file offsets of sessions don't interfere.
+ *
+ * Everything that unlinks, renames or truncates chunk files must call invalidate(). As a safety net
+ * against missed invalidations, take() also drops fds whose file has no links left.
+ *
+ * An fd that was opened (or taken) before an invalidation must not be parked afterwards, it may
+ * refer to a chunk file that was moved away meanwhile. So sessions note the invalidation generation
+ * of the chunk before they open it and hand it to put(), which refuses fds of an older generation.
+ * Generations are tracked per hash bucket of chunk paths, so an invalidation may also refuse fds of
+ * some unrelated chunks.
+ */
+class ChunkFDCache
+{
+   public:
+      struct Stats
+      {
+         uint64_t numHits;
+         uint64_t numMisses;
+         uint64_t numStale; // cached fds that were dropped on take() because the file was unlinked
+         uint64_t numEvictions;
+         uint64_t numInvalidations;
+         uint64_t numRefused; // fds not parked by put() because their chunk was invalidated
+         size_t numCached;
+         size_t maxSize;
+      };
+
+      ChunkFDCache(size_t maxSize);
+
+      ChunkFDCache(const ChunkFDCache&) = delete;
+      ChunkFDCache& operator=(const ChunkFDCache&) = delete;
+
+      uint64_t getGeneration(int targetFD, const std::string& chunkPath) const;
+      FDHandle take(int targetFD, const std::string& chunkPath, int openFlags);
+      void put(int targetFD, const std::string& chunkPath, int openFlags, uint64_t generation,
+         FDHandle fd);
+      void invalidate(int targetFD, const std::string& chunkPath);
+      void invalidateAll();
+
+      Stats getStats() const;
+      std::string getStatsAsStr() const;
+
+      static bool isCacheable(int openFlags);
+
+   private:
+      struct Key
+      {
+         int targetFD;
+         std::string chunkPath;
+         int flagsClass;
+
+         bool operator<(const Key& other) const
+         {
+            if (targetFD != other.targetFD)
+               return targetFD < other.targetFD;
+
+            // path before flags, so that all entries of a chunk are adjacent for invalidate()
+            const int pathCmp = chunkPath.compare(other.chunkPath);
+            if (pathCmp)
+               return pathCmp < 0;
+
+            return flagsClass < other.flagsClass;
+         }
+      };
+
+      struct Entry;
+
+      typedef std::list<Entry> EntryList; // front: most recently used
+      typedef std::map<Key, EntryList::iterator> EntryMap;
+
+      struct Entry
+      {
+         FDHandle fd;
+         EntryMap::iterator mapIter;
+      };
+
+      static const size_t NUM_GENERATION_BUCKETS = 1024;
+
+      const size_t maxSize;
+
+      mutable Mutex mutex{"ChunkFDCache::mutex"};
+      EntryList lru;
+      EntryMap entries;
+      std::vector<uint64_t> generations; // invalidation generation per bucket, see getBucket()
+
+      Stats stats;
+
+      static int getFlagsClass(int openFlags);
+      static size_t getBucket(int targetFD, const std::string& chunkPath);
+
+      FDHandle removeEntryUnlocked(EntryMap::iterator iter);
+};
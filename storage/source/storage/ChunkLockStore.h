@@ -11,7 +11,7 @@
 struct ChunkLockStoreContents
 {
    StringSet lockedChunks;
-   Mutex lockedChunksMutex;
+   Mutex lockedChunksMutex{"ChunkLockStore::lockedChunksMutex"};
    Condition chunkUnlockedCondition;
 };
 
@@ -31,7 +31,7 @@ class ChunkLockStore
 
    private:
       std::map<uint16_t, std::shared_ptr<ChunkLockStoreContents>> targetsMap;
-      RWLock targetsLock; // synchronizes insertion into targetsMap
+      RWLock targetsLock{"ChunkLockStore::targetsLock"}; // synchronizes insertion into targetsMap
 
       ChunkLockStoreContents* getOrInsertTargetLockStore(uint16_t targetID)
       {
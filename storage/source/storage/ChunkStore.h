@@ -68,7 +68,7 @@ class ChunkStore
       Random randGen; // for random cache removal
       DirCacheMap refCache;
 
-      RWLock rwlock;
+      RWLock rwlock{"ChunkStore::rwlock"};
 
       void InsertChunkDirUnlocked(std::string dirID, DirectoryMapIter& newElemIter);
 
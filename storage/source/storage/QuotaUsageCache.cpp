@@ -0,0 +1,84 @@
+#include "QuotaUsageCache.h"
+
+#include <mutex>
+
+
+/**
+ * Replaces the current usage of the requested IDs by the IDs whose usage changed since the last
+ * call for the same type and target, and remembers the current usage for the next call.
+ *
+ * @param rangeStart the first requested ID
+ * @param rangeEnd the last requested ID
+ * @param idFilter if not NULL, only these IDs of the range were requested
+ * @param inOutQuotaDataList in: the current usage of all requested IDs which use something;
+ *        out: the changed IDs, IDs which don't use anything anymore are contained with usage 0
+ * @return false if there was no previous call for the type and target, in which case the list is
+ *         left unchanged (i.e. it must be reported as complete usage)
+ */
+bool QuotaUsageCache::reduceToChanges(QuotaDataType type, uint16_t targetKey,
+   unsigned rangeStart, unsigned rangeEnd, const UIntSet* idFilter,
+   QuotaDataList* inOutQuotaDataList)
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   auto lastUsageIter = lastUsage.find(std::make_pair(type, targetKey) );
+   const bool hasBaseline = lastUsageIter != lastUsage.end();
+
+   QuotaDataMap& usage = hasBaseline
+      ? lastUsageIter->second
+      : lastUsage[std::make_pair(type, targetKey)];
+
+   QuotaDataMap currentUsage;
+
+   for(QuotaDataListIter iter = inOutQuotaDataList->begin(); iter != inOutQuotaDataList->end();
+       iter++)
+      currentUsage.emplace(iter->getID(), *iter);
+
+   QuotaDataList changes;
+
+   // IDs which used something before, but don't anymore
+   QuotaDataMapIter iter = usage.lower_bound(rangeStart);
+   while(iter != usage.end() && iter->first <= rangeEnd)
+   {
+      if( (idFilter && !idFilter->count(iter->first) ) || currentUsage.count(iter->first) )
+      {
+         iter++;
+         continue;
+      }
+
+      changes.push_back(QuotaData(iter->first, type) );
+      iter = usage.erase(iter);
+   }
+
+   // new or changed IDs
+   for(QuotaDataMapIter currentIter = currentUsage.begin(); currentIter != currentUsage.end();
+       currentIter++)
+   {
+      QuotaData& current = currentIter->second;
+      QuotaDataMapIter lastIter = usage.find(currentIter->first);
+
+      if(lastIter != usage.end() &&
+         lastIter->second.getSize() == current.getSize() &&
+         lastIter->second.getInodes() == current.getInodes() )
+         continue;
+
+      changes.push_back(current);
+      usage[currentIter->first] = current;
+   }
+
+   if(hasBaseline)
+      inOutQuotaDataList->swap(changes);
+
+   return hasBaseline;
+}
+
+/**
+ * Forget the usage for the given type and target, e.g. because the current usage could not be
+ * determined completely. The next request reports the complete usage again.
+ */
+void QuotaUsageCache::invalidate(QuotaDataType type, uint16_t targetKey)
+{
+   const std::lock_guard<Mutex> lock(mutex);
+
+   lastUsage.erase(std::make_pair(type, targetKey) );
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <common/storage/quota/QuotaData.h>
+#include <common/threading/Mutex.h>
+#include <common/Common.h>
+
+
+/**
+ * The usage that was last reported for GetQuotaInfoMsg requests with
+ * GETQUOTAINFOMSG_FLAG_CHANGED_ONLY, used to reduce the response to the IDs whose usage changed.
+ *
+ * The usage is kept per ID type and per target (QUOTADATAMAPFORTARGET_ALL_TARGETS_ID for the sum
+ * of all targets of this server). Only IDs with a usage are stored, so the memory used is bounded
+ * by the number of IDs that own something on the targets.
+ */
+class QuotaUsageCache
+{
+   public:
+      bool reduceToChanges(QuotaDataType type, uint16_t targetKey, unsigned rangeStart,
+         unsigned rangeEnd, const UIntSet* idFilter, QuotaDataList* inOutQuotaDataList);
+      void invalidate(QuotaDataType type, uint16_t targetKey);
+
+   private:
+      Mutex mutex;
+      std::map<std::pair<QuotaDataType, uint16_t>, QuotaDataMap> lastUsage;
+};
+
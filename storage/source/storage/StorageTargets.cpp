@@ -19,6 +19,8 @@
 #define BUDDY_NEEDS_RESYNC_FILENAME        ".buddyneedsresync"
 #define LAST_BUDDY_COMM_TIMESTAMP_FILENAME ".lastbuddycomm"
 
+#define STORAGETARGETS_DEFAULT_SYNC_WINDOW (8*1024*1024) // if tuneFileWriteSyncSize is not set
+
 
 StorageTarget::StorageTarget(Path path, uint16_t targetID, TimerQueue& timerQueue,
       NodeStoreServers& mgmtNodes, MirrorBuddyGroupMapper& buddyGroupMapper):
@@ -43,6 +45,16 @@ StorageTarget::StorageTarget(Path path, uint16_t targetID, TimerQueue& timerQueu
 
    quotaBlockDevice = QuotaBlockDevice::getBlockDeviceOfTarget(this->path.str(), targetID);
 
+   const Config* cfg = Program::getApp()->getConfig();
+   if (cfg->getTuneFileWriteSyncAdaptive() )
+   {
+      const int64_t initialSyncWindow = cfg->getTuneFileWriteSyncSize()
+         ? cfg->getTuneFileWriteSyncSize()
+         : STORAGETARGETS_DEFAULT_SYNC_WINDOW;
+
+      writebackController.reset(new WritebackController(initialSyncWindow) );
+   }
+
    if (buddyNeedsResyncFile.read().get_value_or(0) & BUDDY_RESYNC_UNACKED_FLAG)
    {
       setBuddyNeedsResyncEntry = timerQueue.enqueue(std::chrono::seconds(0), [this] {
@@ -507,6 +519,23 @@ void StorageTargets::generateTargetInfoList(StorageTargetInfoList& outTargetInfo
 
       StorageTargetInfo targetInfo(targetID, targetPathStr, sizeTotal, sizeFree, inodesTotal,
          inodesFree, targetState);
+
+      if (const WritebackController* controller = target->getWritebackController() )
+      {
+         const WritebackController::Stats controllerStats = controller->getStats();
+         StorageTargetInfo::WritebackStats writebackStats;
+
+         writebackStats.syncWindow = controllerStats.syncWindow;
+         writebackStats.startThreshold = controllerStats.startThreshold;
+         writebackStats.numWrites = controllerStats.numWrites;
+         writebackStats.numStalls = controllerStats.numStalls;
+         writebackStats.numSubmits = controllerStats.numSubmits;
+         writebackStats.submittedBytes = controllerStats.submittedBytes;
+         writebackStats.lastDecision = controllerStats.lastDecision;
+
+         targetInfo.setWritebackStats(true, writebackStats);
+      }
+
       outTargetInfoList.push_back(targetInfo);
    }
 
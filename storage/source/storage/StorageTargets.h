@@ -12,6 +12,7 @@
 #include <common/components/TimerQueue.h>
 #include <app/config/Config.h>
 #include <storage/QuotaBlockDevice.h>
+#include <storage/WritebackController.h>
 
 #include <boost/optional.hpp>
 #include <atomic>
@@ -42,6 +43,11 @@ class StorageTarget
       const FDHandle& getMirrorFD() const { return mirrorFD; }
       const QuotaBlockDevice& getQuotaBlockDevice() const { return quotaBlockDevice; }
 
+      /**
+       * @return NULL if tuneFileWriteSyncAdaptive is disabled
+       */
+      WritebackController* getWritebackController() const { return writebackController.get(); }
+
       TargetConsistencyState getConsistencyState() const
       {
          RWLockGuard const lock(rwlock, SafeRWLock_READ);
@@ -172,6 +178,7 @@ class StorageTarget
       PreallocatedFile<uint8_t> buddyNeedsResyncFile;
       PreallocatedFile<LastBuddyComm> lastBuddyCommFile;
       QuotaBlockDevice quotaBlockDevice; // quota related information about the block device
+      std::unique_ptr<WritebackController> writebackController; // set if tuneFileWriteSyncAdaptive
       TimerQueue& timerQueue;
       NodeStoreServers& mgmtNodes;
       MirrorBuddyGroupMapper& buddyGroupMapper;
@@ -23,7 +23,7 @@ class SyncedStoragePaths
 
 
    private:
-      Mutex mutex;
+      Mutex mutex{"SyncedStoragePaths::mutex"};
       Condition eraseCond; // broadcasted when path erased from map
       uint64_t storageVersion; // zero is the invalid version!
       StoragePathsSet paths; // for currently locked paths
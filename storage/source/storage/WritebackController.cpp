@@ -0,0 +1,196 @@
+#include <common/storage/StorageTargetInfo.h>
+#include "WritebackController.h"
+
+#include <chrono>
+#include <mutex>
+#include <sstream>
+
+
+WritebackController::WritebackController(int64_t initialSyncWindow) :
+   syncWindow(std::min<int64_t>(std::max<int64_t>(initialSyncWindow, MIN_SYNC_WINDOW),
+      MAX_SYNC_WINDOW) ),
+   startThreshold(0), dirtyBytes(0), nextAdaptMS(nowMS() + ADAPT_INTERVAL_MS),
+   submitLatencyUSecsPerMiB(0), baselineUSecsPerMiB(0), lastDecision(Decision_NONE)
+{
+}
+
+/**
+ * Record a write (to the page cache) of a session.
+ *
+ * @param latencyUSecs duration of the write syscall
+ */
+void WritebackController::recordWrite(int64_t length, uint64_t latencyUSecs)
+{
+   dirtyBytes.increase(length);
+
+   intervalWrites.increase();
+   numWrites.increase();
+
+   if (latencyUSecs > WRITE_STALL_USECS)
+   {
+      intervalStalls.increase();
+      numStalls.increase();
+   }
+
+   checkAdapt();
+}
+
+/**
+ * Record a submission of written data to the device queue via sync_file_range().
+ *
+ * @param latencyUSecs duration of the submission, which blocks when the device queue is full
+ */
+void WritebackController::recordWriteback(int64_t length, uint64_t latencyUSecs)
+{
+   dirtyBytes.decrease(length);
+
+   intervalSubmitBytes.increase(length);
+   intervalSubmitUSecs.increase(latencyUSecs);
+
+   numSubmits.increase();
+   submittedBytes.increase(length);
+}
+
+/**
+ * @param sequentialBytes number of bytes that the session wrote sequentially and did not submit
+ * @return true if the session should submit its sequential range for writeback now
+ */
+bool WritebackController::getSyncNeeded(int64_t sequentialBytes) const
+{
+   return (sequentialBytes >= syncWindow.read() ) && (dirtyBytes.read() >= startThreshold.read() );
+}
+
+/**
+ * Adapt the window and start threshold to the last interval if the interval is over. Only one of
+ * the concurrent callers does the adaption.
+ */
+void WritebackController::checkAdapt()
+{
+   const int64_t currentMS = nowMS();
+   const int64_t adaptMS = nextAdaptMS.read();
+
+   if (currentMS < adaptMS)
+      return;
+
+   if (!nextAdaptMS.compareAndSet(currentMS + ADAPT_INTERVAL_MS, adaptMS) )
+      return; // another thread does the adaption
+
+   adapt(currentMS - adaptMS + ADAPT_INTERVAL_MS);
+}
+
+/**
+ * Adapt the window and start threshold to the counters of the last interval and start a new
+ * interval.
+ *
+ * Note: Normally called by the writers; public for tests.
+ *
+ * @param elapsedMS length of the last interval
+ */
+void WritebackController::adapt(uint64_t elapsedMS)
+{
+   const std::lock_guard<Mutex> lock(adaptMutex);
+
+   const uint64_t writes = intervalWrites.read();
+   const uint64_t stalls = intervalStalls.read();
+   const uint64_t submitBytes = intervalSubmitBytes.read();
+   const uint64_t submitUSecs = intervalSubmitUSecs.read();
+
+   // (decrease instead of reset to not lose the updates of concurrent writers)
+   intervalWrites.decrease(writes);
+   intervalStalls.decrease(stalls);
+   intervalSubmitBytes.decrease(submitBytes);
+   intervalSubmitUSecs.decrease(submitUSecs);
+
+   /* the kernel flusher writes back what we don't submit (e.g. non-sequential writes or the rest
+      of closed sessions) after the dirty expire time */
+   const int64_t currentDirtyBytes = dirtyBytes.read();
+   if (currentDirtyBytes > 0)
+      dirtyBytes.decrease(std::min<int64_t>(currentDirtyBytes,
+         currentDirtyBytes * int64_t(elapsedMS) / DIRTY_EXPIRE_MS) );
+   else
+   if (currentDirtyBytes < 0)
+      dirtyBytes.decrease(currentDirtyBytes); // (after decay of data that was submitted later)
+
+   bool deviceBusy = false;
+
+   if (submitBytes)
+   {
+      const uint64_t latency = std::max<uint64_t>(submitUSecs * (1024*1024) / submitBytes, 1);
+
+      submitLatencyUSecsPerMiB = submitLatencyUSecsPerMiB
+         ? (submitLatencyUSecsPerMiB * 3 + latency) / 4
+         : latency;
+
+      // baseline is the lowest latency, but follows slowly if the device gets slower in general
+      baselineUSecsPerMiB = baselineUSecsPerMiB
+         ? std::min(baselineUSecsPerMiB + baselineUSecsPerMiB / 64 + 1, submitLatencyUSecsPerMiB)
+         : submitLatencyUSecsPerMiB;
+
+      deviceBusy = submitLatencyUSecsPerMiB > DEVICE_BUSY_FACTOR * baselineUSecsPerMiB;
+   }
+
+   const int64_t window = syncWindow.read();
+   const int64_t threshold = startThreshold.read();
+
+   if (stalls)
+   { // writers were throttled => start writeback earlier and in smaller pieces
+      syncWindow.set(std::max<int64_t>(window / 2, MIN_SYNC_WINDOW) );
+      startThreshold.set(threshold / 2);
+      lastDecision = Decision_SHRINK;
+   }
+   else
+   if (deviceBusy)
+   { // device is saturated with writes => let more data stay in the page cache for now
+      startThreshold.set(std::min<int64_t>(threshold + window, MAX_START_THRESHOLD) );
+      lastDecision = Decision_DEFER;
+   }
+   else
+   if (writes)
+   { // healthy => larger submissions, and no more need to hold back writeback
+      syncWindow.set(std::min<int64_t>(window + MIN_SYNC_WINDOW, MAX_SYNC_WINDOW) );
+      startThreshold.set(threshold / 2);
+      lastDecision = Decision_GROW;
+   }
+   else
+      lastDecision = Decision_NONE;
+}
+
+WritebackController::Stats WritebackController::getStats() const
+{
+   const std::lock_guard<Mutex> lock(adaptMutex);
+
+   return Stats{syncWindow.read(), startThreshold.read(), dirtyBytes.read(),
+      submitLatencyUSecsPerMiB, baselineUSecsPerMiB, lastDecision, numWrites.read(),
+      numStalls.read(), numSubmits.read(), submittedBytes.read()};
+}
+
+std::string WritebackController::getStatsAsStr() const
+{
+   const Stats stats = getStats();
+
+   std::ostringstream statsStream;
+
+   statsStream << "sync window: " << stats.syncWindow << std::endl;
+   statsStream << "start threshold: " << stats.startThreshold << std::endl;
+   statsStream << "dirty bytes: " << stats.dirtyBytes << std::endl;
+   statsStream << "submit latency (us/MiB): " << stats.submitLatencyUSecsPerMiB << std::endl;
+   statsStream << "baseline latency (us/MiB): " << stats.baselineUSecsPerMiB << std::endl;
+   statsStream << "last decision: " << decisionToStr(stats.lastDecision) << std::endl;
+   statsStream << "writes: " << stats.numWrites << std::endl;
+   statsStream << "stalls: " << stats.numStalls << std::endl;
+   statsStream << "submits: " << stats.numSubmits << std::endl;
+   statsStream << "submitted bytes: " << stats.submittedBytes << std::endl;
+
+   return statsStream.str();
+}
+
+const char* WritebackController::decisionToStr(Decision decision)
+{
+   return StorageTargetInfo::WritebackStats::decisionToStr(decision);
+}
+
+int64_t WritebackController::nowMS()
+{
+   return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
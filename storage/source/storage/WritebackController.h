@@ -0,0 +1,104 @@
+#pragma once
+
+#include <common/Common.h>
+#include <common/threading/Atomics.h>
+#include <common/threading/Mutex.h>
+
+
+/**
+ * Decides when sequential writes of the sessions of a storage target are committed to the device
+ * queue with sync_file_range(), instead of a fixed tuneFileWriteSyncSize for all targets.
+ *
+ * Sessions submit the range that they wrote sequentially once it reaches the current sync window,
+ * but only while the target has at least startThreshold bytes of dirty data that were not submitted
+ * yet (smaller amounts are left to the kernel flusher).
+ *
+ * Both values are adapted once per interval (AIMD):
+ * - write stalls (writes blocked by page cache throttling) => writeback is too late, so the window
+ *   and the start threshold are halved
+ * - submission latency far above the target's baseline => device is saturated with writes, so
+ *   the start threshold is raised to leave device capacity to reads
+ * - otherwise the window grows by MIN_SYNC_WINDOW for larger, better mergeable submissions, and
+ *   the start threshold is lowered again
+ */
+class WritebackController
+{
+   public:
+      // values are reported to mon, see StorageTargetInfo::WritebackStats::decisionToStr()
+      enum Decision
+      {
+         Decision_NONE = 0, // no writes in the last interval
+         Decision_GROW,
+         Decision_SHRINK,
+         Decision_DEFER,
+      };
+
+      enum
+      {
+         MIN_SYNC_WINDOW = 1024*1024,
+         MAX_SYNC_WINDOW = 64*1024*1024,
+         MAX_START_THRESHOLD = 16 * MAX_SYNC_WINDOW,
+         ADAPT_INTERVAL_MS = 1000,
+         WRITE_STALL_USECS = 10000, // page cache writes taking longer were throttled
+         DEVICE_BUSY_FACTOR = 4, // submission latency above this times baseline means saturation
+         DIRTY_EXPIRE_MS = 30000, // (vm.dirty_expire_centisecs default) for kernel writeback
+      };
+
+      struct Stats
+      {
+         int64_t syncWindow;
+         int64_t startThreshold;
+         int64_t dirtyBytes;
+         uint64_t submitLatencyUSecsPerMiB; // smoothed
+         uint64_t baselineUSecsPerMiB;
+         Decision lastDecision;
+
+         uint64_t numWrites;
+         uint64_t numStalls;
+         uint64_t numSubmits;
+         uint64_t submittedBytes;
+      };
+
+      WritebackController(int64_t initialSyncWindow);
+
+      WritebackController(const WritebackController&) = delete;
+      WritebackController& operator=(const WritebackController&) = delete;
+
+      void recordWrite(int64_t length, uint64_t latencyUSecs);
+      void recordWriteback(int64_t length, uint64_t latencyUSecs);
+      bool getSyncNeeded(int64_t sequentialBytes) const;
+
+      void adapt(uint64_t elapsedMS);
+
+      Stats getStats() const;
+      std::string getStatsAsStr() const;
+
+      static const char* decisionToStr(Decision decision);
+
+   private:
+      AtomicInt64 syncWindow;
+      AtomicInt64 startThreshold;
+      AtomicInt64 dirtyBytes; // written, but not submitted for writeback yet (estimate)
+
+      // counters of the current interval
+      AtomicUInt64 intervalWrites;
+      AtomicUInt64 intervalStalls;
+      AtomicUInt64 intervalSubmitBytes;
+      AtomicUInt64 intervalSubmitUSecs;
+
+      AtomicUInt64 numWrites;
+      AtomicUInt64 numStalls;
+      AtomicUInt64 numSubmits;
+      AtomicUInt64 submittedBytes;
+
+      AtomicInt64 nextAdaptMS; // steady clock time of the next adaption
+
+      mutable Mutex adaptMutex; // protects the values below and serializes adaption
+      uint64_t submitLatencyUSecsPerMiB; // 0 until the first submission
+      uint64_t baselineUSecsPerMiB; // lowest recent submission latency
+      Decision lastDecision;
+
+      void checkAdapt();
+      static int64_t nowMS();
+};
+
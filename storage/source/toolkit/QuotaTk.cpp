@@ -18,6 +18,51 @@
 #define QUOTATK_ZFS_USER_INODE_QUOTA    "userobjused@"
 #define QUOTATK_ZFS_GROUP_INODE_QUOTA   "groupobjused@"
 
+// zfs_userquota_prop_t values from libzfs
+#define QUOTATK_ZFS_PROP_USERUSED       0
+#define QUOTATK_ZFS_PROP_GROUPUSED      2
+#define QUOTATK_ZFS_PROP_USEROBJUSED    4
+#define QUOTATK_ZFS_PROP_GROUPOBJUSED   6
+
+// get usage of the next ID >= the given ID which has a quota record, not defined in glibc headers
+#ifndef Q_GETNEXTQUOTA
+#define Q_GETNEXTQUOTA                  0x800009
+#endif
+
+#ifndef Q_XGETNEXTQUOTA
+#define Q_XGETNEXTQUOTA                 XQM_CMD(9)
+#endif
+
+/**
+ * result of Q_GETNEXTQUOTA, same layout as struct if_nextdqblk from linux/quota.h (which can't be
+ * included together with sys/quota.h)
+ */
+struct QuotaTkNextDqblk
+{
+   uint64_t dqb_bhardlimit;
+   uint64_t dqb_bsoftlimit;
+   uint64_t dqb_curspace;
+   uint64_t dqb_ihardlimit;
+   uint64_t dqb_isoftlimit;
+   uint64_t dqb_curinodes;
+   uint64_t dqb_btime;
+   uint64_t dqb_itime;
+   uint32_t dqb_valid;
+   uint32_t dqb_id;
+};
+
+/**
+ * argument of the zfs_userspace() callback
+ */
+struct QuotaTkZfsUserspaceArg
+{
+   unsigned rangeStart;
+   unsigned rangeEnd;
+   const UIntSet* idFilter; // may be NULL
+   QuotaDataMap usage;
+   bool countInodes; // false: size, true: inodes
+};
+
 /**
  * Get quota data for a single ID and append it to the outQuotaDataList.
  *
@@ -45,6 +90,10 @@ bool QuotaTk::appendQuotaForID(unsigned id, QuotaDataType type, QuotaBlockDevice
 /**
  * get quota for the a range of IDs
  *
+ * Only IDs which have a quota record on the block devices are requested: ext4 and XFS are
+ * enumerated with Q_GETNEXTQUOTA/Q_XGETNEXTQUOTA, ZFS with zfs_userspace(). Block devices which don't
+ * support this (old kernels or libzfs versions) fall back to one request per ID.
+ *
  * @param blockDevices the QuotaBlockDevice to check
  * @param rangeStart the first ID of the ID range
  * @param rangeEnd the last ID of the ID range
@@ -58,15 +107,12 @@ bool QuotaTk::appendQuotaForID(unsigned id, QuotaDataType type, QuotaBlockDevice
 bool QuotaTk::requestQuotaForRange(QuotaBlockDeviceMap* blockDevices, unsigned rangeStart,
    unsigned rangeEnd, QuotaDataType type, QuotaDataList* outQuotaDataList, ZfsSession* session)
 {
-   bool retVal = true;
+   QuotaDataMap usage;
 
-   for(unsigned id = rangeStart; id <= rangeEnd; id++)
-   {
-      bool errorVal = appendQuotaForID(id, type, blockDevices, outQuotaDataList, session);
+   bool retVal = collectQuotaForRange(blockDevices, rangeStart, rangeEnd, NULL, type, &usage,
+      session);
 
-      if(!errorVal)
-         retVal = false;
-   }
+   appendUsedQuota(usage, outQuotaDataList);
 
    return retVal;
 }
@@ -74,6 +120,9 @@ bool QuotaTk::requestQuotaForRange(QuotaBlockDeviceMap* blockDevices, unsigned r
 /**
  * get quota for the a range of IDs
  *
+ * Uses the same enumeration as requestQuotaForRange(), restricted to the IDs of the list, so it
+ * never needs more requests than IDs in the list.
+ *
  * @param blockDevices the QuotaBlockDevice to check
  * @param idList the list with the IDs to check
  * @param type the quota data ID type user/group, QuotaDataType_...
@@ -85,20 +134,252 @@ bool QuotaTk::requestQuotaForRange(QuotaBlockDeviceMap* blockDevices, unsigned r
  */
 bool QuotaTk::requestQuotaForList(QuotaBlockDeviceMap* blockDevices, UIntList* idList,
    QuotaDataType type, QuotaDataList* outQuotaDataList, ZfsSession* session)
+{
+   if(idList->empty() )
+      return true;
+
+   UIntSet idSet(idList->begin(), idList->end() );
+   QuotaDataMap usage;
+
+   bool retVal = collectQuotaForRange(blockDevices, *idSet.begin(), *idSet.rbegin(), &idSet, type,
+      &usage, session);
+
+   appendUsedQuota(usage, outQuotaDataList);
+
+   return retVal;
+}
+
+/**
+ * get the summed up usage of all block devices for the IDs of a range which have a quota record
+ *
+ * @param blockDevices the QuotaBlockDevice to check
+ * @param rangeStart the first ID of the ID range
+ * @param rangeEnd the last ID of the ID range
+ * @param idFilter if not NULL, only these IDs of the range are requested
+ * @param type the quota data ID type user/group, QuotaDataType_...
+ * @param inOutUsage the usage of each device is added to the entries of this map
+ * @param session a session for all required lib handles if zfs is used
+ *
+ * @return false on error (the usage of the other block devices is still added)
+ */
+bool QuotaTk::collectQuotaForRange(QuotaBlockDeviceMap* blockDevices, unsigned rangeStart,
+   unsigned rangeEnd, const UIntSet* idFilter, QuotaDataType type, QuotaDataMap* inOutUsage,
+   ZfsSession* session)
 {
    bool retVal = true;
 
-   for(UIntListIter iter = idList->begin(); iter != idList->end(); iter++)
+   if( (type != QuotaDataType_USER) && (type != QuotaDataType_GROUP) )
    {
-      bool errorVal = appendQuotaForID(*iter, type, blockDevices, outQuotaDataList, session);
+      LOG(QUOTA, ERR, "Quota request - useless quota type.",
+            ("Type", QuotaData::QuotaDataTypeToString(type)));
 
-      if(!errorVal)
+      return false;
+   }
+
+   for(QuotaBlockDeviceMapIter iter = blockDevices->begin(); iter != blockDevices->end(); iter++)
+   {
+      QuotaBlockDeviceFsType fstype = iter->second.getFsType();
+      bool supported = true;
+      bool enumerated;
+
+      if( (fstype == QuotaBlockDeviceFsType_ZFS) || (fstype == QuotaBlockDeviceFsType_ZFSOLD) )
+         enumerated = enumerateQuotaFromZFS(&iter->second, iter->first, rangeStart, rangeEnd,
+            idFilter, type, inOutUsage, session, &supported);
+      else
+         enumerated = enumerateQuotaFromDevice(iter->second, rangeStart, rangeEnd, idFilter, type,
+            inOutUsage, &supported);
+
+      if(!enumerated)
          retVal = false;
+
+      if(supported)
+         continue;
+
+      // fall back to one request per ID
+      QuotaBlockDeviceMap singleBlockDevice = { *iter };
+
+      auto requestID = [&] (unsigned id) {
+         QuotaData data(id, type);
+
+         if(!checkQuota(&singleBlockDevice, &data, session) )
+            retVal = false;
+         else
+         if(data.getSize() != 0 || data.getInodes() != 0)
+            mergeUsage(id, type, data.getSize(), data.getInodes(), inOutUsage);
+      };
+
+      if(idFilter)
+      {
+         for(UIntSetCIter idIter = idFilter->lower_bound(rangeStart);
+             idIter != idFilter->end() && *idIter <= rangeEnd; idIter++)
+            requestID(*idIter);
+      }
+      else
+      {
+         for(uint64_t id = rangeStart; id <= rangeEnd; id++)
+            requestID(id);
+      }
+   }
+
+   return retVal;
+}
+
+/**
+ * enumerate the usage of all IDs of a range which have a quota record on an ext4 or XFS block
+ * device
+ *
+ * @param blockDevice the QuotaBlockDevice to check
+ * @param rangeStart the first ID of the ID range
+ * @param rangeEnd the last ID of the ID range
+ * @param idFilter if not NULL, only these IDs of the range are added
+ * @param type the quota data ID type user/group, QuotaDataType_...
+ * @param inOutUsage the usage of the device is added to the entries of this map
+ * @param outSupported false if the kernel doesn't support Q_GETNEXTQUOTA for this block device, in
+ *        which case nothing was added
+ *
+ * @return false on error
+ */
+bool QuotaTk::enumerateQuotaFromDevice(const QuotaBlockDevice& blockDevice, unsigned rangeStart,
+   unsigned rangeEnd, const UIntSet* idFilter, QuotaDataType type, QuotaDataMap* inOutUsage,
+   bool* outSupported)
+{
+   const QuotaBlockDeviceFsType fstype = blockDevice.getFsType();
+   const std::string devicePath = blockDevice.getBlockDevicePath();
+   const int quotaType = (type == QuotaDataType_USER) ? USRQUOTA : GRPQUOTA;
+
+   bool retVal = true;
+   bool isFirstRequest = true;
+   uint64_t nextID = rangeStart;
+
+   *outSupported = true;
+
+   if(idFilter)
+   {
+      UIntSetCIter idIter = idFilter->lower_bound(rangeStart);
+      if(idIter == idFilter->end() )
+         return true;
+
+      nextID = *idIter;
+   }
+
+   while(nextID <= rangeEnd)
+   {
+      QuotaTkNextDqblk quotaData;                                    // required for extX
+      fs_disk_quota xfsQuotaData;                                    // required for XFS
+
+      unsigned id;
+      bool isValid;
+      uint64_t blocks;
+      uint64_t inodes;
+      int errorCode;
+
+      if(fstype == QuotaBlockDeviceFsType_XFS)
+      {
+         errorCode = quotactl(QCMD(Q_XGETNEXTQUOTA, quotaType), devicePath.c_str(), nextID,
+            (caddr_t)&xfsQuotaData);
+
+         id = xfsQuotaData.d_id;
+         isValid = true;
+         blocks = UnitTk::quotaBlockCountToByte(xfsQuotaData.d_bcount, fstype);
+         inodes = xfsQuotaData.d_icount;
+      }
+      else
+      {
+         errorCode = quotactl(QCMD(Q_GETNEXTQUOTA, quotaType), devicePath.c_str(), nextID,
+            (caddr_t)&quotaData);
+
+         id = quotaData.dqb_id;
+         isValid = (quotaData.dqb_valid & QIF_USAGE) != 0;
+         blocks = UnitTk::quotaBlockCountToByte(quotaData.dqb_curspace, fstype);
+         inodes = quotaData.dqb_curinodes;
+      }
+
+      if(errorCode != 0)
+      {
+         errorCode = errno;
+
+         // no further ID with a quota record (ESRCH), especially for XFS (ENOENT)
+         if( (errorCode == ESRCH) || (errorCode == ENOENT) )
+            break;
+
+         if(isFirstRequest &&
+            ( (errorCode == EINVAL) || (errorCode == ENOSYS) || (errorCode == EOPNOTSUPP) ) )
+         {
+            *outSupported = false;
+            return true;
+         }
+
+         LOG(QUOTA, ERR, "Quota request - quotactl failed.",
+            ("Type", QuotaData::QuotaDataTypeToString(type)),
+            ("ID", nextID),
+            ("sysErr", System::getErrString(errorCode)),
+            ("fstype", boost::lexical_cast<std::string>(fstype)));
+
+         return false;
+      }
+
+      isFirstRequest = false;
+
+      if( (id < nextID) || (id > rangeEnd) )
+         break;
+
+      if(!idFilter || idFilter->count(id) )
+      {
+         if(!isValid)
+         {
+            // set return value to false, but do not abort, the other IDs may have valid values
+            LOG(QUOTA, ERR, "Quota request - values not valid.",
+                  ("Type", QuotaData::QuotaDataTypeToString(type)),
+                  ("ID", id));
+
+            retVal = false;
+         }
+         else
+         if(blocks != 0 || inodes != 0)
+            mergeUsage(id, type, blocks, inodes, inOutUsage);
+      }
+
+      nextID = (uint64_t)id + 1;
+
+      // skip IDs which are not requested anyway
+      if(idFilter)
+      {
+         if(nextID > UINT_MAX)
+            break;
+
+         UIntSetCIter idIter = idFilter->lower_bound(nextID);
+         if(idIter == idFilter->end() )
+            break;
+
+         nextID = *idIter;
+      }
    }
 
    return retVal;
 }
 
+/**
+ * add the given usage to the entry of the ID, creates the entry if it doesn't exist
+ */
+void QuotaTk::mergeUsage(unsigned id, QuotaDataType type, uint64_t size, uint64_t inodes,
+   QuotaDataMap* inOutUsage)
+{
+   QuotaDataMapIter iter = inOutUsage->emplace(id, QuotaData(id, type) ).first;
+   iter->second.forceMergeQuotaDataCounter(size, inodes);
+}
+
+/**
+ * append all entries with a non-zero usage to the list, ordered by ID
+ */
+void QuotaTk::appendUsedQuota(const QuotaDataMap& usage, QuotaDataList* outQuotaDataList)
+{
+   for(QuotaDataMapConstIter iter = usage.begin(); iter != usage.end(); iter++)
+   {
+      if(iter->second.getSize() != 0 || iter->second.getInodes() != 0)
+         outQuotaDataList->push_back(iter->second);
+   }
+}
+
 /**
  * get QuotaData for the given QuotaData which is initialized with type and ID
  *
@@ -428,3 +709,108 @@ bool QuotaTk::requestQuotaFromZFS(QuotaBlockDevice* blockDevice, uint16_t target
 
    return true;
 }
+
+/**
+ * zfs_userspace() callback, collects the value of each ID which is requested
+ */
+static int zfsUserspaceCallback(void* arg, const char* domain, uid_t rid, uint64_t space)
+{
+   QuotaTkZfsUserspaceArg* userspaceArg = (QuotaTkZfsUserspaceArg*)arg;
+
+   // IDs with a domain are SMB SIDs, not POSIX IDs
+   if(domain && domain[0] != '\0')
+      return 0;
+
+   if( (rid < userspaceArg->rangeStart) || (rid > userspaceArg->rangeEnd) )
+      return 0;
+
+   if(userspaceArg->idFilter && !userspaceArg->idFilter->count(rid) )
+      return 0;
+
+   QuotaDataMapIter iter = userspaceArg->usage.emplace(rid,
+      QuotaData(rid, QuotaDataType_NONE) ).first;
+
+   if(userspaceArg->countInodes)
+      iter->second.forceMergeQuotaDataCounter(0, space);
+   else
+      iter->second.forceMergeQuotaDataCounter(space, 0);
+
+   return 0;
+}
+
+/**
+ * enumerate the usage of all IDs of a range which use space on a ZFS pool
+ *
+ * @param blockDevice the QuotaBlockDevice to check
+ * @param targetNumID the targetNumID of the storage target
+ * @param rangeStart the first ID of the ID range
+ * @param rangeEnd the last ID of the ID range
+ * @param idFilter if not NULL, only these IDs of the range are added
+ * @param type the quota data ID type user/group, QuotaDataType_...
+ * @param inOutUsage the usage of the pool is added to the entries of this map
+ * @param session a session for all required lib handles, it can be an uninitialized session
+ * @param outSupported false if the libzfs doesn't provide zfs_userspace(), in which case nothing
+ *        was added
+ *
+ * @return false on error
+ */
+bool QuotaTk::enumerateQuotaFromZFS(QuotaBlockDevice* blockDevice, uint16_t targetNumID,
+   unsigned rangeStart, unsigned rangeEnd, const UIntSet* idFilter, QuotaDataType type,
+   QuotaDataMap* inOutUsage, ZfsSession* session, bool* outSupported)
+{
+   *outSupported = true;
+
+   if(!session->isSessionValid() )
+   {
+      if(!session->initZfsSession(Program::getApp()->getDlOpenHandleLibZfs() ) )
+         return false;
+   }
+
+   if(!session->zfs_userspace)
+   {
+      *outSupported = false;
+      return true;
+   }
+
+   void* zfsHandle = session->getZfsDeviceHandle(targetNumID, blockDevice->getBlockDevicePath() );
+   if(!zfsHandle)
+      return false;
+
+   QuotaTkZfsUserspaceArg sizeArg = { rangeStart, rangeEnd, idFilter, QuotaDataMap(), false };
+   QuotaTkZfsUserspaceArg inodeArg = { rangeStart, rangeEnd, idFilter, QuotaDataMap(), true };
+
+   int sizeProp = (type == QuotaDataType_USER) ?
+      QUOTATK_ZFS_PROP_USERUSED : QUOTATK_ZFS_PROP_GROUPUSED;
+   int inodeProp = (type == QuotaDataType_USER) ?
+      QUOTATK_ZFS_PROP_USEROBJUSED : QUOTATK_ZFS_PROP_GROUPOBJUSED;
+
+   if( (*session->zfs_userspace)(zfsHandle, sizeProp, zfsUserspaceCallback, &sizeArg) )
+   {
+      LOG(QUOTA, ERR, "Error during request quota data.",
+            ("ErrorAction", (*session->libzfs_error_action)(session->getlibZfsHandle())),
+            ("ErrorDescription", (*session->libzfs_error_description)(session->getlibZfsHandle()))
+         );
+      return false;
+   }
+
+   if(blockDevice->getFsType() != QuotaBlockDeviceFsType_ZFSOLD) // no inode support on zfs<=0.7.4
+   {
+      if( (*session->zfs_userspace)(zfsHandle, inodeProp, zfsUserspaceCallback, &inodeArg) )
+      {
+         LOG(QUOTA, ERR, "Inode quota could not be requested. Please note that inode quota on"
+               " ZFS is not supported for zfs versions prior to 0.7.4.",
+               ("ZFS Error", (*session->libzfs_error_description)(session->getlibZfsHandle())));
+         return false;
+      }
+   }
+
+   for(QuotaDataMapConstIter iter = sizeArg.usage.begin(); iter != sizeArg.usage.end(); iter++)
+      mergeUsage(iter->first, type,
+         UnitTk::quotaBlockCountToByte(iter->second.getSize(), blockDevice->getFsType() ), 0,
+         inOutUsage);
+
+   for(QuotaDataMapConstIter iter = inodeArg.usage.begin(); iter != inodeArg.usage.end(); iter++)
+      mergeUsage(iter->first, type, 0, iter->second.getInodes(), inOutUsage);
+
+   return true;
+}
@@ -39,5 +39,18 @@ class QuotaTk
    private:
       QuotaTk();
 
+      static bool collectQuotaForRange(QuotaBlockDeviceMap* blockDevices, unsigned rangeStart,
+         unsigned rangeEnd, const UIntSet* idFilter, QuotaDataType type, QuotaDataMap* inOutUsage,
+         ZfsSession* session);
+      static bool enumerateQuotaFromDevice(const QuotaBlockDevice& blockDevice, unsigned rangeStart,
+         unsigned rangeEnd, const UIntSet* idFilter, QuotaDataType type, QuotaDataMap* inOutUsage,
+         bool* outSupported);
+      static bool enumerateQuotaFromZFS(QuotaBlockDevice* blockDevice, uint16_t targetNumID,
+         unsigned rangeStart, unsigned rangeEnd, const UIntSet* idFilter, QuotaDataType type,
+         QuotaDataMap* inOutUsage, ZfsSession* session, bool* outSupported);
+      static void mergeUsage(unsigned id, QuotaDataType type, uint64_t size, uint64_t inodes,
+         QuotaDataMap* inOutUsage);
+      static void appendUsedQuota(const QuotaDataMap& usage, QuotaDataList* outQuotaDataList);
+
 };
 
@@ -0,0 +1,102 @@
+#include "SparseFileTk.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/**
+ * Check whether the underlying file system reports the holes of a file via SEEK_DATA/SEEK_HOLE.
+ *
+ * File systems without real support for it treat the whole file as one data extent, which is
+ * detected here for files that have less blocks allocated than their size.
+ *
+ * Note: Moves the file offset.
+ *
+ * @return false if holes have to be detected by scanning the file contents for zeros
+ */
+bool SparseFileTk::getHolesReported(int fd)
+{
+   struct stat statBuf;
+
+   if (fstat(fd, &statBuf) )
+      return false;
+
+   const off_t firstHole = lseek(fd, 0, SEEK_HOLE);
+   if (firstHole == -1)
+      return errno == ENXIO; // (empty file)
+
+   if ( (firstHole >= statBuf.st_size) && ( (statBuf.st_blocks * 512) < statBuf.st_size) )
+      return false; // sparse file without reported holes
+
+   return true;
+}
+
+/**
+ * Find the next data extent of a file at or after offset via SEEK_DATA/SEEK_HOLE.
+ *
+ * Note: Moves the file offset.
+ *
+ * @param outExtentEnd end of the data extent (i.e. start of the next hole or the file size)
+ * @return start of the data extent (which is offset itself if offset is within a data extent),
+ *    the file size if there is no more data at or after offset (outExtentEnd is the file size as
+ *    well in this case), or -1 if the file system does not support SEEK_DATA/SEEK_HOLE
+ */
+int64_t SparseFileTk::findDataExtent(int fd, int64_t offset, int64_t& outExtentEnd)
+{
+   const off_t dataStart = lseek(fd, offset, SEEK_DATA);
+
+   if (dataStart == -1)
+   {
+      if (errno != ENXIO)
+         return -1;
+
+      // only a hole (or nothing) left after offset
+      const off_t fileSize = lseek(fd, 0, SEEK_END);
+      if (fileSize == -1)
+         return -1;
+
+      outExtentEnd = std::max<int64_t>(fileSize, offset);
+      return outExtentEnd;
+   }
+
+   const off_t dataEnd = lseek(fd, dataStart, SEEK_HOLE);
+   if (dataEnd == -1)
+      return -1;
+
+   outExtentEnd = dataEnd;
+   return dataStart;
+}
+
+/**
+ * Check if a buffer contains only zeros.
+ *
+ * The buffer is processed in blocks of 64 bytes without early exit inside a block, which lets the
+ * compiler vectorize the loop.
+ */
+bool SparseFileTk::isZeroBuf(const char* buf, size_t len)
+{
+   const size_t blockLen = 8 * sizeof(uint64_t);
+   size_t pos = 0;
+
+   for ( ; pos + blockLen <= len; pos += blockLen)
+   {
+      uint64_t words[8];
+      uint64_t accu = 0;
+
+      memcpy(words, buf + pos, blockLen);
+
+      for (unsigned i = 0; i < 8; i++)
+         accu |= words[i];
+
+      if (accu)
+         return false;
+   }
+
+   for ( ; pos < len; pos++)
+   {
+      if (buf[pos])
+         return false;
+   }
+
+   return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <common/Common.h>
+
+
+/**
+ * Helpers to skip the holes of sparse chunk files, e.g. during buddy resync and chunk balancing.
+ */
+class SparseFileTk
+{
+   public:
+      static bool getHolesReported(int fd);
+      static int64_t findDataExtent(int fd, int64_t offset, int64_t& outExtentEnd);
+      static bool isZeroBuf(const char* buf, size_t len);
+
+   private:
+      SparseFileTk() {}
+};
+
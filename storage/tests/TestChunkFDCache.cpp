@@ -0,0 +1,153 @@
+#include <storage/ChunkFDCache.h>
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+class ChunkFDCacheTest : public ::testing::Test
+{
+   protected:
+      void SetUp() override
+      {
+         char dirTemplate[] = "/tmp/ChunkFDCacheTestXXXXXX";
+         ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+
+         dirPath = dirTemplate;
+         dirFD = open(dirPath.c_str(), O_DIRECTORY | O_RDONLY);
+         ASSERT_GE(dirFD, 0);
+
+         for (auto name : {"a", "b", "c"})
+         {
+            const int fd = openat(dirFD, name, O_CREAT | O_WRONLY, 0644);
+            ASSERT_GE(fd, 0);
+            close(fd);
+         }
+      }
+
+      void TearDown() override
+      {
+         for (auto name : {"a", "b", "c"})
+            unlinkat(dirFD, name, 0);
+
+         close(dirFD);
+         rmdir(dirPath.c_str() );
+      }
+
+      FDHandle openChunk(const std::string& name)
+      {
+         return FDHandle(openat(dirFD, name.c_str(), O_RDONLY) );
+      }
+
+      std::string dirPath;
+      int dirFD;
+};
+
+TEST_F(ChunkFDCacheTest, takeReturnsCachedFD)
+{
+   ChunkFDCache cache(4);
+
+   ASSERT_FALSE(cache.take(dirFD, "a", O_RDONLY).valid() );
+
+   FDHandle fd = openChunk("a");
+   const int rawFD = fd.get();
+   cache.put(dirFD, "a", O_RDONLY, cache.getGeneration(dirFD, "a"), std::move(fd) );
+
+   // other flags and other chunks don't match
+   ASSERT_FALSE(cache.take(dirFD, "a", O_RDONLY | O_DIRECT).valid() );
+   ASSERT_FALSE(cache.take(dirFD, "b", O_RDONLY).valid() );
+
+   FDHandle taken = cache.take(dirFD, "a", O_RDONLY);
+   ASSERT_EQ(taken.get(), rawFD);
+
+   // taken over exclusively
+   ASSERT_FALSE(cache.take(dirFD, "a", O_RDONLY).valid() );
+
+   const ChunkFDCache::Stats stats = cache.getStats();
+   ASSERT_EQ(stats.numHits, 1u);
+   ASSERT_EQ(stats.numMisses, 4u);
+   ASSERT_EQ(stats.numCached, 0u);
+}
+
+TEST_F(ChunkFDCacheTest, evictsLeastRecentlyUsed)
+{
+   ChunkFDCache cache(2);
+
+   cache.put(dirFD, "a", O_RDONLY, cache.getGeneration(dirFD, "a"), openChunk("a") );
+   cache.put(dirFD, "b", O_RDONLY, cache.getGeneration(dirFD, "b"), openChunk("b") );
+
+   // refresh a, so that b is the oldest entry
+   cache.put(dirFD, "a", O_RDONLY, cache.getGeneration(dirFD, "a"), openChunk("a") );
+   cache.put(dirFD, "c", O_RDONLY, cache.getGeneration(dirFD, "c"), openChunk("c") );
+
+   ASSERT_FALSE(cache.take(dirFD, "b", O_RDONLY).valid() );
+   ASSERT_TRUE(cache.take(dirFD, "a", O_RDONLY).valid() );
+   ASSERT_TRUE(cache.take(dirFD, "c", O_RDONLY).valid() );
+
+   ASSERT_EQ(cache.getStats().numEvictions, 1u);
+}
+
+TEST_F(ChunkFDCacheTest, invalidateDropsAllFlagClasses)
+{
+   ChunkFDCache cache(4);
+
+   cache.put(dirFD, "a", O_RDONLY, cache.getGeneration(dirFD, "a"), openChunk("a") );
+   cache.put(dirFD, "a", O_RDONLY | O_NOATIME, cache.getGeneration(dirFD, "a"), openChunk("a") );
+   cache.put(dirFD, "b", O_RDONLY, cache.getGeneration(dirFD, "b"), openChunk("b") );
+
+   cache.invalidate(dirFD, "a");
+
+   ASSERT_FALSE(cache.take(dirFD, "a", O_RDONLY).valid() );
+   ASSERT_FALSE(cache.take(dirFD, "a", O_RDONLY | O_NOATIME).valid() );
+   ASSERT_TRUE(cache.take(dirFD, "b", O_RDONLY).valid() );
+
+   ASSERT_EQ(cache.getStats().numInvalidations, 2u);
+}
+
+TEST_F(ChunkFDCacheTest, fdOpenedBeforeInvalidateIsNotParked)
+{
+   ChunkFDCache cache(4);
+
+   // a session opens the chunk, then the chunk is moved away and invalidated
+   const uint64_t generation = cache.getGeneration(dirFD, "a");
+   FDHandle fd = openChunk("a");
+
+   cache.invalidate(dirFD, "a");
+   cache.put(dirFD, "a", O_RDONLY, generation, std::move(fd) );
+
+   ASSERT_FALSE(cache.take(dirFD, "a", O_RDONLY).valid() );
+   ASSERT_EQ(cache.getStats().numRefused, 1u);
+
+   // fds opened after the invalidation are parked again
+   cache.put(dirFD, "a", O_RDONLY, cache.getGeneration(dirFD, "a"), openChunk("a") );
+   ASSERT_TRUE(cache.take(dirFD, "a", O_RDONLY).valid() );
+
+   // same after invalidateAll()
+   const uint64_t generationB = cache.getGeneration(dirFD, "b");
+   cache.invalidateAll();
+   cache.put(dirFD, "b", O_RDONLY, generationB, openChunk("b") );
+
+   ASSERT_FALSE(cache.take(dirFD, "b", O_RDONLY).valid() );
+   ASSERT_EQ(cache.getStats().numRefused, 2u);
+}
+
+TEST_F(ChunkFDCacheTest, unlinkedChunkIsNotReturned)
+{
+   ChunkFDCache cache(4);
+
+   cache.put(dirFD, "a", O_RDONLY, cache.getGeneration(dirFD, "a"), openChunk("a") );
+   ASSERT_EQ(unlinkat(dirFD, "a", 0), 0);
+
+   ASSERT_FALSE(cache.take(dirFD, "a", O_RDONLY).valid() );
+   ASSERT_EQ(cache.getStats().numStale, 1u);
+}
+
+TEST(ChunkFDCache, onlyReadOnlyFlagsAreCacheable)
+{
+   ASSERT_TRUE(ChunkFDCache::isCacheable(O_RDONLY) );
+   ASSERT_TRUE(ChunkFDCache::isCacheable(O_RDONLY | O_DIRECT) );
+   ASSERT_FALSE(ChunkFDCache::isCacheable(O_WRONLY) );
+   ASSERT_FALSE(ChunkFDCache::isCacheable(O_RDWR) );
+   ASSERT_FALSE(ChunkFDCache::isCacheable(O_RDONLY | O_TRUNC) );
+}
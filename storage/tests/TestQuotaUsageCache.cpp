@@ -0,0 +1,98 @@
+#include <storage/QuotaUsageCache.h>
+
+#include <gtest/gtest.h>
+
+static QuotaData makeUsage(unsigned id, uint64_t size, uint64_t inodes)
+{
+   QuotaData data(id, QuotaDataType_USER);
+   data.setQuotaData(size, inodes);
+   return data;
+}
+
+static QuotaDataMap toMap(const QuotaDataList& list)
+{
+   QuotaDataMap map;
+
+   for (auto it = list.begin(); it != list.end(); ++it)
+      map.emplace(it->getID(), *it);
+
+   return map;
+}
+
+TEST(QuotaUsageCache, firstRequestIsComplete)
+{
+   QuotaUsageCache cache;
+
+   QuotaDataList usage = { makeUsage(1, 100, 1), makeUsage(5, 200, 2) };
+   ASSERT_FALSE(cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage) );
+   ASSERT_EQ(usage.size(), 2u);
+
+   // unchanged usage
+   usage = { makeUsage(1, 100, 1), makeUsage(5, 200, 2) };
+   ASSERT_TRUE(cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage) );
+   ASSERT_TRUE(usage.empty() );
+
+   // other targets and types have their own baseline
+   usage = { makeUsage(1, 100, 1) };
+   ASSERT_FALSE(cache.reduceToChanges(QuotaDataType_USER, 3, 0, 10, nullptr, &usage) );
+   ASSERT_FALSE(cache.reduceToChanges(QuotaDataType_GROUP, 0, 0, 10, nullptr, &usage) );
+}
+
+TEST(QuotaUsageCache, changes)
+{
+   QuotaUsageCache cache;
+
+   QuotaDataList usage = { makeUsage(1, 100, 1), makeUsage(5, 200, 2), makeUsage(7, 1, 1) };
+   cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage);
+
+   // 1 changed, 5 is gone, 7 unchanged, 9 is new
+   usage = { makeUsage(1, 150, 1), makeUsage(7, 1, 1), makeUsage(9, 10, 1) };
+   ASSERT_TRUE(cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage) );
+
+   QuotaDataMap changes = toMap(usage);
+   ASSERT_EQ(changes.size(), 3u);
+   ASSERT_EQ(changes.at(1).getSize(), 150u);
+   ASSERT_EQ(changes.at(5).getSize(), 0u);
+   ASSERT_EQ(changes.at(5).getInodes(), 0u);
+   ASSERT_EQ(changes.at(9).getSize(), 10u);
+
+   // IDs that are gone are reported only once
+   usage = { makeUsage(1, 150, 1), makeUsage(7, 1, 1), makeUsage(9, 10, 1) };
+   ASSERT_TRUE(cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage) );
+   ASSERT_TRUE(usage.empty() );
+}
+
+TEST(QuotaUsageCache, onlyRequestedIDs)
+{
+   QuotaUsageCache cache;
+
+   QuotaDataList usage = { makeUsage(1, 100, 1), makeUsage(5, 200, 2), makeUsage(20, 1, 1) };
+   cache.reduceToChanges(QuotaDataType_USER, 0, 0, 100, nullptr, &usage);
+
+   // IDs outside of the range or not in the list weren't requested, so they aren't gone
+   usage = { makeUsage(1, 100, 1) };
+   ASSERT_TRUE(cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage) );
+   ASSERT_EQ(usage.size(), 1u);
+   ASSERT_EQ(usage.front().getID(), 5u);
+   ASSERT_EQ(usage.front().getSize(), 0u);
+
+   UIntSet ids = { 1, 30 };
+   usage = {};
+   ASSERT_TRUE(cache.reduceToChanges(QuotaDataType_USER, 0, 1, 30, &ids, &usage) );
+   ASSERT_EQ(usage.size(), 1u);
+   ASSERT_EQ(usage.front().getID(), 1u);
+}
+
+TEST(QuotaUsageCache, invalidate)
+{
+   QuotaUsageCache cache;
+
+   QuotaDataList usage = { makeUsage(1, 100, 1) };
+   cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage);
+
+   cache.invalidate(QuotaDataType_USER, 0);
+
+   usage = { makeUsage(1, 100, 1) };
+   ASSERT_FALSE(cache.reduceToChanges(QuotaDataType_USER, 0, 0, 10, nullptr, &usage) );
+   ASSERT_EQ(usage.size(), 1u);
+}
@@ -0,0 +1,135 @@
+#include <session/ReadAheadDetector.h>
+
+#include <gtest/gtest.h>
+
+#define MAX_WINDOW_SIZE      (1024*1024)
+#define SEQ_TRIGGER_SIZE     (256*1024)
+
+class ReadAheadDetectorTest : public ::testing::Test
+{
+   protected:
+      ReadAheadDetector detector;
+
+      ReadAheadDetector::RangeVec read(int64_t offset, int64_t length)
+      {
+         ReadAheadDetector::RangeVec ranges;
+
+         detector.recordRead(offset, length, MAX_WINDOW_SIZE, SEQ_TRIGGER_SIZE, ranges);
+         return ranges;
+      }
+};
+
+TEST_F(ReadAheadDetectorTest, sequential)
+{
+   const int64_t readSize = 128*1024;
+   int64_t numRangeBytes = 0;
+
+   // nothing before the trigger size was read sequentially
+   ASSERT_TRUE(read(0, readSize).empty() );
+
+   for (int64_t offset = readSize; offset < 64 * readSize; offset += readSize)
+   {
+      const auto ranges = read(offset, readSize);
+
+      for (const auto& range : ranges)
+      {
+         ASSERT_GE(range.offset, offset + readSize);
+         ASSERT_LE(range.length, MAX_WINDOW_SIZE);
+         numRangeBytes += range.length;
+      }
+
+      if (offset + readSize < SEQ_TRIGGER_SIZE)
+      {
+         ASSERT_TRUE(ranges.empty() );
+      }
+   }
+
+   ASSERT_EQ(detector.getPattern(), ReadAheadDetector::Pattern_SEQUENTIAL);
+
+   const auto stats = detector.getStats();
+   ASSERT_EQ(stats.readAheadBytes, uint64_t(numRangeBytes) );
+   ASSERT_GT(stats.hitBytes, 0u);
+   ASSERT_EQ(stats.wastedBytes, 0u);
+}
+
+TEST_F(ReadAheadDetectorTest, strided)
+{
+   const int64_t readSize = 4096;
+   const int64_t stride = 64*1024;
+
+   // pattern needs a few equal distances to be trusted
+   for (int i = 0; i < 3; i++)
+      ASSERT_TRUE(read(i * stride, readSize).empty() );
+
+   auto ranges = read(3 * stride, readSize);
+
+   ASSERT_EQ(detector.getPattern(), ReadAheadDetector::Pattern_STRIDED);
+   ASSERT_EQ(ranges.size(), size_t(ReadAheadDetector::MAX_STRIDES_PER_WINDOW) );
+
+   for (size_t i = 0; i < ranges.size(); i++)
+   {
+      ASSERT_EQ(ranges[i].offset, int64_t(4 + i) * stride);
+      ASSERT_EQ(ranges[i].length, readSize);
+   }
+
+   // next strides were read ahead before => only new strides at the end
+   ranges = read(4 * stride, readSize);
+   ASSERT_EQ(ranges.size(), 1u);
+   ASSERT_EQ(ranges[0].offset, (4 + ReadAheadDetector::MAX_STRIDES_PER_WINDOW) * stride);
+
+   ASSERT_EQ(detector.getStats().hitBytes, uint64_t(readSize) );
+}
+
+TEST_F(ReadAheadDetectorTest, backward)
+{
+   const int64_t readSize = 4096;
+   const int64_t fileSize = 8*1024*1024;
+   const int64_t stride = 512*1024;
+
+   for (int i = 1; i <= 3; i++)
+      ASSERT_TRUE(read(fileSize - i * stride, readSize).empty() );
+
+   const auto ranges = read(fileSize - 4 * stride, readSize);
+
+   ASSERT_EQ(detector.getPattern(), ReadAheadDetector::Pattern_BACKWARD);
+
+   // stops at the beginning of the file
+   ASSERT_EQ(ranges.size(), size_t(fileSize / stride - 4) );
+
+   for (size_t i = 0; i < ranges.size(); i++)
+      ASSERT_EQ(ranges[i].offset, fileSize - int64_t(5 + i) * stride);
+}
+
+TEST_F(ReadAheadDetectorTest, random)
+{
+   const int64_t offsets[] = { 7, 3, 12, 1, 9, 30, 2, 22, 5, 17 };
+
+   for (int64_t offset : offsets)
+      ASSERT_TRUE(read(offset * 1024*1024, 4096).empty() );
+
+   ASSERT_EQ(detector.getPattern(), ReadAheadDetector::Pattern_NONE);
+   ASSERT_EQ(detector.getStats().numReadAheads, 0u);
+}
+
+TEST_F(ReadAheadDetectorTest, waste)
+{
+   const int64_t readSize = 4096;
+   const int64_t stride = 64*1024;
+   const int64_t otherStride = 1024*1024;
+   const int64_t otherStart = 100*1024*1024;
+
+   for (int i = 0; i < 4; i++)
+      read(i * stride, readSize);
+
+   // client leaves the pattern => strided ranges of the old pattern are never read
+   for (int i = 0; i < 4; i++)
+      read(otherStart + i * otherStride, readSize);
+
+   const auto stats = detector.getStats();
+   ASSERT_EQ(stats.hitBytes, 0u);
+   ASSERT_GT(stats.wastedBytes, 0u);
+
+   const auto globalStats = ReadAheadDetector::getGlobalStats();
+   ASSERT_GE(globalStats.wastedBytes, stats.wastedBytes);
+   ASSERT_GE(globalStats.readAheadBytes, stats.readAheadBytes);
+}
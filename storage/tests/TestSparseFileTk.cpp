@@ -0,0 +1,82 @@
+#include <toolkit/SparseFileTk.h>
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+class SparseFileTkTest : public ::testing::Test
+{
+   protected:
+      void SetUp() override
+      {
+         char fileTemplate[] = "/tmp/SparseFileTkTestXXXXXX";
+
+         fd = mkstemp(fileTemplate);
+         ASSERT_GE(fd, 0);
+
+         filePath = fileTemplate;
+      }
+
+      void TearDown() override
+      {
+         close(fd);
+         unlink(filePath.c_str() );
+      }
+
+      std::string filePath;
+      int fd;
+};
+
+TEST_F(SparseFileTkTest, isZeroBuf)
+{
+   std::vector<char> buf(4096 + 13, 0);
+
+   ASSERT_TRUE(SparseFileTk::isZeroBuf(buf.data(), buf.size() ) );
+   ASSERT_TRUE(SparseFileTk::isZeroBuf(buf.data(), 0) );
+
+   // non-zero byte in each position of the vectorized part and the tail
+   for (size_t pos : {size_t(0), size_t(63), size_t(64), size_t(4095), buf.size() - 1})
+   {
+      buf[pos] = 1;
+      ASSERT_FALSE(SparseFileTk::isZeroBuf(buf.data(), buf.size() ) );
+      ASSERT_TRUE(SparseFileTk::isZeroBuf(buf.data(), pos) );
+      buf[pos] = 0;
+   }
+}
+
+TEST_F(SparseFileTkTest, findDataExtent)
+{
+   const int64_t blockSize = 1024*1024;
+   std::vector<char> data(blockSize, 'x');
+
+   // hole, data, hole, data, hole
+   ASSERT_EQ(pwrite(fd, data.data(), blockSize, 4 * blockSize), blockSize);
+   ASSERT_EQ(pwrite(fd, data.data(), blockSize, 8 * blockSize), blockSize);
+   ASSERT_EQ(ftruncate(fd, 12 * blockSize), 0);
+
+   if (!SparseFileTk::getHolesReported(fd) )
+   { // e.g. tmpfs of old kernels
+      std::cerr << "Skipping test; holes not reported for " << filePath << std::endl;
+      return;
+   }
+
+   int64_t extentEnd = -1;
+
+   ASSERT_EQ(SparseFileTk::findDataExtent(fd, 0, extentEnd), 4 * blockSize);
+   ASSERT_EQ(extentEnd, 5 * blockSize);
+
+   ASSERT_EQ(SparseFileTk::findDataExtent(fd, 4 * blockSize + 10, extentEnd), 4 * blockSize + 10);
+   ASSERT_EQ(extentEnd, 5 * blockSize);
+
+   ASSERT_EQ(SparseFileTk::findDataExtent(fd, 5 * blockSize, extentEnd), 8 * blockSize);
+   ASSERT_EQ(extentEnd, 9 * blockSize);
+
+   // only a hole left => file size
+   ASSERT_EQ(SparseFileTk::findDataExtent(fd, 9 * blockSize, extentEnd), 12 * blockSize);
+   ASSERT_EQ(extentEnd, 12 * blockSize);
+
+   ASSERT_EQ(SparseFileTk::findDataExtent(fd, 20 * blockSize, extentEnd), 20 * blockSize);
+   ASSERT_EQ(extentEnd, 20 * blockSize);
+}
@@ -0,0 +1,103 @@
+#include <storage/WritebackController.h>
+
+#include <gtest/gtest.h>
+
+#define MIB (1024*1024)
+
+TEST(WritebackController, syncWindow)
+{
+   WritebackController controller(8 * MIB);
+
+   ASSERT_FALSE(controller.getSyncNeeded(8 * MIB - 1) );
+   ASSERT_TRUE(controller.getSyncNeeded(8 * MIB) );
+
+   // initial window is clamped
+   WritebackController smallController(1);
+   ASSERT_EQ(smallController.getStats().syncWindow, WritebackController::MIN_SYNC_WINDOW);
+}
+
+TEST(WritebackController, growWhenHealthy)
+{
+   WritebackController controller(8 * MIB);
+
+   controller.recordWrite(MIB, 100);
+   controller.adapt(WritebackController::ADAPT_INTERVAL_MS);
+
+   const auto stats = controller.getStats();
+   ASSERT_EQ(stats.lastDecision, WritebackController::Decision_GROW);
+   ASSERT_EQ(stats.syncWindow, 9 * MIB);
+
+   // no writes => no change
+   controller.adapt(WritebackController::ADAPT_INTERVAL_MS);
+   ASSERT_EQ(controller.getStats().lastDecision, WritebackController::Decision_NONE);
+   ASSERT_EQ(controller.getStats().syncWindow, 9 * MIB);
+}
+
+TEST(WritebackController, shrinkOnStalls)
+{
+   WritebackController controller(8 * MIB);
+
+   controller.recordWrite(MIB, 100);
+   controller.recordWrite(MIB, WritebackController::WRITE_STALL_USECS + 1);
+   controller.adapt(WritebackController::ADAPT_INTERVAL_MS);
+
+   auto stats = controller.getStats();
+   ASSERT_EQ(stats.lastDecision, WritebackController::Decision_SHRINK);
+   ASSERT_EQ(stats.syncWindow, 4 * MIB);
+   ASSERT_EQ(stats.numStalls, 1u);
+
+   for (int i = 0; i < 10; i++)
+   {
+      controller.recordWrite(MIB, WritebackController::WRITE_STALL_USECS + 1);
+      controller.adapt(WritebackController::ADAPT_INTERVAL_MS);
+   }
+
+   ASSERT_EQ(controller.getStats().syncWindow, WritebackController::MIN_SYNC_WINDOW);
+}
+
+TEST(WritebackController, deferWhenDeviceBusy)
+{
+   WritebackController controller(8 * MIB);
+
+   // establish baseline latency
+   controller.recordWrite(8 * MIB, 100);
+   controller.recordWriteback(8 * MIB, 800);
+   controller.adapt(WritebackController::ADAPT_INTERVAL_MS);
+
+   ASSERT_EQ(controller.getStats().baselineUSecsPerMiB, 100u);
+   ASSERT_EQ(controller.getStats().startThreshold, 0);
+
+   // submissions block on a full device queue
+   for (int i = 0; i < 5; i++)
+   {
+      controller.recordWrite(8 * MIB, 100);
+      controller.recordWriteback(8 * MIB, 100 * 1000);
+      controller.adapt(WritebackController::ADAPT_INTERVAL_MS);
+   }
+
+   const auto stats = controller.getStats();
+   ASSERT_EQ(stats.lastDecision, WritebackController::Decision_DEFER);
+   ASSERT_GT(stats.startThreshold, 0);
+
+   // writeback is held back until the target has enough dirty data
+   ASSERT_LT(stats.dirtyBytes, stats.startThreshold);
+   ASSERT_FALSE(controller.getSyncNeeded(stats.syncWindow) );
+}
+
+TEST(WritebackController, dirtyBytes)
+{
+   WritebackController controller(8 * MIB);
+
+   controller.recordWrite(30 * MIB, 100);
+   ASSERT_EQ(controller.getStats().dirtyBytes, 30 * MIB);
+
+   controller.recordWriteback(10 * MIB, 100);
+   ASSERT_EQ(controller.getStats().dirtyBytes, 20 * MIB);
+
+   // data that we don't submit expires in the kernel
+   controller.adapt(WritebackController::DIRTY_EXPIRE_MS / 2);
+   ASSERT_EQ(controller.getStats().dirtyBytes, 10 * MIB);
+
+   controller.adapt(WritebackController::DIRTY_EXPIRE_MS);
+   ASSERT_EQ(controller.getStats().dirtyBytes, 0);
+}